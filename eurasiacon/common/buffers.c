@@ -444,9 +444,12 @@ IMG_INTERNAL IMG_UINT32 *CBUF_GetBufferSpace(CircularBuffer **apsBuffers,
 											 IMG_BOOL bTerminate)
 {
 	CircularBuffer *psBuffer;
-	IMG_BOOL bEnoughSpace, bFirstTry;
+	IMG_BOOL bEnoughSpace, bFirstTry, bStalled;
 	IMG_UINT32 ui32ReadOffset;
 	IMG_UINT32 ui32BytesRequired = ui32DWordsRequired << 2;
+#if defined(DEBUG) || defined(TIMING)
+	IMG_UINT32 ui32StallStartTime = 0;
+#endif /* defined(DEBUG) || defined(TIMING) */
 
 	/* Get the actual buffer */
 	psBuffer = apsBuffers[ui32BufferType];
@@ -461,6 +464,7 @@ IMG_INTERNAL IMG_UINT32 *CBUF_GetBufferSpace(CircularBuffer **apsBuffers,
 	/* This code assumes that no single request for space is larger than the ui32SingleKickLimitInBytes */
 
 	bFirstTry = IMG_TRUE;
+	bStalled = IMG_FALSE;
 
 	do
 	{
@@ -530,11 +534,32 @@ IMG_INTERNAL IMG_UINT32 *CBUF_GetBufferSpace(CircularBuffer **apsBuffers,
 					PVR_DPF((PVR_DBG_ERROR, "CBUF_GetBufferSpace: Run out of space in the %s buffer, with no outstanding HW ops", asBufferDesc[ui32BufferType])); 
 				}
 
+#if defined(DEBUG) || defined(TIMING)
+				if(bStalled)
+				{
+					psBuffer->ui32StallTimeInUs += PVRSRVClockus() - ui32StallStartTime;
+				}
+#endif /* defined(DEBUG) || defined(TIMING) */
+
 				return IMG_NULL;		
 			}
 
 			if(!bFirstTry)
 			{
+				/* Count each request that has to wait once, however many times it polls */
+				if(!bStalled)
+				{
+					bStalled = IMG_TRUE;
+
+					psBuffer->ui32StallCount++;
+
+#if defined(DEBUG) || defined(TIMING)
+					psBuffer->ui32TotalStallCount++;
+
+					ui32StallStartTime = PVRSRVClockus();
+#endif /* defined(DEBUG) || defined(TIMING) */
+				}
+
 				if(sceGpuSignalWait(sceKernelGetTLSAddr(0x44), 100000) != SCE_OK)
 				{
 					PVR_DPF((PVR_DBG_MESSAGE, "CBUF_GetBufferSpace: sceGpuSignalWait failed"));
@@ -545,6 +570,13 @@ IMG_INTERNAL IMG_UINT32 *CBUF_GetBufferSpace(CircularBuffer **apsBuffers,
 	}
 	while(!bEnoughSpace);
 
+#if defined(DEBUG) || defined(TIMING)
+	if(bStalled)
+	{
+		psBuffer->ui32StallTimeInUs += PVRSRVClockus() - ui32StallStartTime;
+	}
+#endif /* defined(DEBUG) || defined(TIMING) */
+
 	/* Mark buffer is locked and record the lock count */
 	psBuffer->bLocked = IMG_TRUE;
 	psBuffer->ui32LockCount = ui32DWordsRequired;
@@ -578,6 +610,9 @@ IMG_INTERNAL IMG_VOID CBUF_UpdateBufferPos(CircularBuffer **apsBuffers,
 	IMG_UINT32 ui32FreeSpaceInBytes;
 	IMG_BOOL bSpaceHasWrapped;
 #endif
+#if defined(DEBUG) || defined(TIMING)
+	IMG_UINT32 ui32OutstandingInBytes;
+#endif /* defined(DEBUG) || defined(TIMING) */
 	CircularBuffer *psBuffer = apsBuffers[ui32BufferType];
 
 	if(!psBuffer->bLocked)
@@ -618,6 +653,23 @@ IMG_INTERNAL IMG_VOID CBUF_UpdateBufferPos(CircularBuffer **apsBuffers,
 		*pui32WriteOffset = 0;
 	}
 
+#if defined(DEBUG) || defined(TIMING)
+	/* Space not yet known to be consumed by the HW, as of the last read offset we looked at */
+	if(psBuffer->ui32ReadOffsetCopy <= *pui32WriteOffset)
+	{
+		ui32OutstandingInBytes = *pui32WriteOffset - psBuffer->ui32ReadOffsetCopy;
+	}
+	else
+	{
+		ui32OutstandingInBytes = ui32Limit - (psBuffer->ui32ReadOffsetCopy - *pui32WriteOffset);
+	}
+
+	if(ui32OutstandingInBytes > psBuffer->ui32HighWaterMarkInBytes)
+	{
+		psBuffer->ui32HighWaterMarkInBytes = ui32OutstandingInBytes;
+	}
+#endif /* defined(DEBUG) || defined(TIMING) */
+
 	/* Unlock the buffer */
 	psBuffer->bLocked = IMG_FALSE;
 }
@@ -975,12 +1027,17 @@ IMG_INTERNAL CircularBuffer *CBUF_CreateBuffer(PVRSRV_DEV_DATA *ps3DDevData,
 
 	psBuffer->psDevData							= ps3DDevData;
 
+	psBuffer->ui32StallCount					= 0;
+
 #if defined(PDUMP)
 	psBuffer->bSyncDumped						= IMG_FALSE;
 #endif /* defined(PDUMP) */
 
 #if defined(DEBUG) || defined(TIMING)
 	psBuffer->ui32KickCount						= 0;
+	psBuffer->ui32TotalStallCount				= 0;
+	psBuffer->ui32StallTimeInUs					= 0;
+	psBuffer->ui32HighWaterMarkInBytes			= 0;
 #endif /* defined(DEBUG) || defined(TIMING) */
 
 	/* Allocate device memory for status update */
@@ -993,6 +1050,8 @@ IMG_INTERNAL CircularBuffer *CBUF_CreateBuffer(PVRSRV_DEV_DATA *ps3DDevData,
 							&psBuffer->psStatusUpdateMemInfo) != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_ERROR,"CBUF_CreateBuffer: Failed to alloc sync update dev mem for buffer %u",ui32BufferType));
+		PVRSRVFreeSyncInfo(ps3DDevData, psMemInfo->psClientSyncInfo);
+		PVRSRVFreeDeviceMem(ps3DDevData, psMemInfo);
 		PVRSRVFreeUserModeMem(psBuffer);
 		return IMG_NULL;
 	}
@@ -90,8 +90,14 @@ typedef struct CircularBuffer_TAG
 	IMG_BOOL					bSyncDumped;
 #endif /* defined(PDUMP) */
 
+	IMG_UINT32					ui32StallCount;	/* Waits for the HW to free space, reset by the owner */
+
 #if defined(DEBUG) || defined(TIMING)
 	IMG_UINT32					ui32KickCount;	/* How many times this buffer has caused a kick */
+
+	IMG_UINT32					ui32TotalStallCount;		/* Waits for the HW to free space */
+	IMG_UINT32					ui32StallTimeInUs;			/* Time spent in those waits */
+	IMG_UINT32					ui32HighWaterMarkInBytes;	/* Most space ever outstanding */
 #endif /* defined(DEBUG) || defined(TIMING) */
 
 } CircularBuffer;
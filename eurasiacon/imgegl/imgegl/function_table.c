@@ -1378,6 +1378,10 @@ static IMG_BOOL IMGSearchGLES2Extension(const char *procname)
 	EGL_COMPARE_AND_RETURN(glFramebufferTexture2DMultisampleIMG)
 #endif /* defined(GLES2_EXTENSION_MULTISAMPLED_RENDER_TO_TEXTURE) */
 
+#if defined(GLES2_EXTENSION_SHADER_PREWARM)
+	EGL_COMPARE_AND_RETURN(glPrewarmProgramIMG)
+#endif /* defined(GLES2_EXTENSION_SHADER_PREWARM) */
+
 	return IMG_FALSE;
 }
 #endif /* defined(SUPPORT_OPENGLES2) || defined(API_MODULES_RUNTIME_CHECKED) */
@@ -281,6 +281,8 @@ IMG_INTERNAL IMG_BOOL _TlsInit(TLS psTls)
 		psTls->apsCurrentContext[i]     = EGL_NO_CONTEXT;
 	}
 
+	psTls->eglCachedDisplay = EGL_NO_DISPLAY;
+
 	psTls->ui32ThreadID = IMGEGL_GetTLSID();
 
 	psGlobalData = ENV_GetGlobalData();
@@ -1656,6 +1658,23 @@ IMG_EXPORT EGLDisplay IMGeglGetDisplay(NativeDisplayType nativeDisplay)
 	}
 #endif
 
+	/*
+		If this thread has already been given a display for this native display
+		and the slot scan below would still find it with its window system
+		module loaded, the answer is unchanged: return it without taking the
+		global lock.
+	*/
+	eglDpy = GetCachedEGLDisplay(psTls, nativeDisplay);
+
+	if (eglDpy != EGL_NO_DISPLAY)
+	{
+		psTls->lastError = EGL_SUCCESS;
+
+		IMGEGL_TIME_STOP(IMGEGL_TIMER_IMGeglGetDisplay);
+
+		return eglDpy;
+	}
+
 	EGLThreadLock(psTls);
 
 	psTls->lastError = EGL_SUCCESS;
@@ -1736,6 +1755,9 @@ FoundSlot:
 
 	EGLThreadUnlock(psTls);
 
+	psTls->hCachedNativeDisplay = nativeDisplay;
+	psTls->eglCachedDisplay     = eglDpy;
+
 	IMGEGL_TIME_STOP(IMGEGL_TIMER_IMGeglGetDisplay);
 
 	return (eglDpy);
@@ -4659,7 +4681,7 @@ IMG_EXPORT EGLBoolean IMGeglQuerySurface(EGLDisplay eglDpy,
 		return EGL_FALSE;
 	}
 
-	if(!IsEGLSurface(psDpy, psSurface))
+	if(!IsCurrentEGLSurface(psTls, psDpy, psSurface) && !IsEGLSurface(psDpy, psSurface))
 	{
 		psTls->lastError = EGL_BAD_SURFACE;
 
@@ -6670,7 +6692,7 @@ IMG_EXPORT EGLBoolean IMGeglQueryContext(EGLDisplay eglDpy,
 		return EGL_FALSE;
 	}
 
-	if(!IsEGLContext(psDpy, psContext))
+	if(!IsCurrentEGLContext(psTls, psDpy, psContext) && !IsEGLContext(psDpy, psContext))
 	{
 		psTls->lastError = EGL_BAD_CONTEXT;
 
@@ -7145,7 +7167,7 @@ IMG_EXPORT EGLBoolean IMGeglSwapBuffers(EGLDisplay eglDpy, EGLSurface draw)
 		return EGL_FALSE;
 	}
 
-	if(!IsEGLSurface(psDpy, psDrawSurface))
+	if(!IsCurrentEGLSurface(psTls, psDpy, psDrawSurface) && !IsEGLSurface(psDpy, psDrawSurface))
 	{
 		psTls->lastError = EGL_BAD_SURFACE;
 
@@ -7312,9 +7334,12 @@ IMG_EXPORT EGLBoolean IMGeglSwapBuffers(EGLDisplay eglDpy, EGLSurface draw)
 
 				EGLThreadUnlockWSEGL(psDpy, psTls);
 
-				EGLThreadLock(psTls);
+				/*
+					The surface is current to this thread, and a surface can only
+					be current to one thread, so no other thread can be updating
+					the swap count: the global lock isn't needed.
+				*/
 				psDrawSurface->u.window.ui32SwapCount++;
-				EGLThreadUnlock(psTls);
 			}
 
 			break;
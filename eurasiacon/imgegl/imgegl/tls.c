@@ -29,42 +29,37 @@
 
 /***************************************************************************
  *
- *  FUNCTION   : TLS_Open ()
- *  PURPOSE    : Create and initialise our thread local storage if it
- *				 doesn't already exist, otherwise returns the current tls
+ *  FUNCTION   : TLS_Create ()
+ *  PURPOSE    : Create and initialise our thread local storage. Called by
+ *				 TLS_Open when the calling thread has none yet.
  *  PARAMETERS : None.
  *  RETURNS    : Pointer to this threads local storage structure.
  *
  ***************************************************************************/
-IMG_INTERNAL TLS TLS_Open(IMG_BOOL (*init)(TLS tls))
+IMG_INTERNAL TLS TLS_Create(IMG_BOOL (*init)(TLS tls))
 {
     TLS tls;
 
-    PVR_DPF((PVR_DBG_VERBOSE, "TLS_Open()"));
+    PVR_DPF((PVR_DBG_VERBOSE, "TLS_Create()"));
 
-    tls = (TLS)IMGEGLGetTLSValue();
+	tls = EGLCalloc(sizeof(struct tls_tag));
 
-    if (tls == IMG_NULL)
-    {
-		tls = EGLCalloc(sizeof(struct tls_tag));
-
-		if (tls!=IMG_NULL)
-		{
-			if (!init(tls))
-			{
-				EGLFree(tls);
-
-				return IMG_NULL;
-			}
-		}
-
-		if (!IMGEGLSetTLSValue(tls))
+	if (tls!=IMG_NULL)
+	{
+		if (!init(tls))
 		{
 			EGLFree(tls);
 
 			return IMG_NULL;
 		}
-    }
+	}
+
+	if (!IMGEGLSetTLSValue(tls))
+	{
+		EGLFree(tls);
+
+		return IMG_NULL;
+	}
 
     return tls;
 }
@@ -95,6 +90,117 @@ IMG_INTERNAL IMG_VOID TLS_Close(IMG_VOID (*deinit)(TLS tls))
     }
 }
 
+/***********************************************************************
+ *
+ *  FUNCTION   : IsCurrentEGLSurface()
+ *  PURPOSE    : Check whether a surface on a specified display is bound to
+ *               the calling thread for the current API. A bound surface
+ *               stays on its display's list until it is unbound, even if
+ *               it is destroyed, so this is a lock-free substitute for
+ *               IsEGLSurface in the common case.
+ *  PARAMETERS : In:  psTls - Calling thread's TLS.
+ *               In:  psDpy - Display.
+ *               In:  psInputSurface - EGL surface.
+ *  RETURNS    : TRUE/FALSE.
+ *
+ ***********************************************************************/
+IMG_INTERNAL IMG_BOOL IsCurrentEGLSurface(TLS psTls, KEGL_DISPLAY *psDpy, KEGL_SURFACE *psInputSurface)
+{
+	/* With no API bound there is nothing current to index */
+	if ((psInputSurface == EGL_NO_SURFACE) || (psTls->ui32API == IMGEGL_API_NONE))
+	{
+		return IMG_FALSE;
+	}
+
+	if ((psTls->apsCurrentDrawSurface[psTls->ui32API] != psInputSurface) &&
+		(psTls->apsCurrentReadSurface[psTls->ui32API] != psInputSurface))
+	{
+		return IMG_FALSE;
+	}
+
+	return (psInputSurface->psDpy == psDpy) ? IMG_TRUE : IMG_FALSE;
+}
+
+
+/***********************************************************************
+ *
+ *  FUNCTION   : IsCurrentEGLContext()
+ *  PURPOSE    : Check whether a context on a specified display is current
+ *               to the calling thread for the current API. Destruction of
+ *               a current context is deferred, so this is a lock-free
+ *               substitute for IsEGLContext in the common case.
+ *  PARAMETERS : In:  psTls - Calling thread's TLS.
+ *               In:  psDpy - Display.
+ *               In:  psInputContext - EGL context.
+ *  RETURNS    : TRUE/FALSE.
+ *
+ ***********************************************************************/
+IMG_INTERNAL IMG_BOOL IsCurrentEGLContext(TLS psTls, KEGL_DISPLAY *psDpy, KEGL_CONTEXT *psInputContext)
+{
+	if ((psInputContext == EGL_NO_CONTEXT) || (psTls->ui32API == IMGEGL_API_NONE) ||
+		(psTls->apsCurrentContext[psTls->ui32API] != psInputContext))
+	{
+		return IMG_FALSE;
+	}
+
+	return (psInputContext->psDpy == psDpy) ? IMG_TRUE : IMG_FALSE;
+}
+
+
+/***********************************************************************
+ *
+ *  FUNCTION   : GetCachedEGLDisplay()
+ *  PURPOSE    : Return the EGLDisplay that eglGetDisplay last gave the
+ *               calling thread for a native display, provided its slot
+ *               still holds that native display with its window system
+ *               module loaded and the locked slot scan would still find
+ *               it. Slots are never reassigned while in use, so this needs
+ *               no lock.
+ *  PARAMETERS : In:  psTls - Calling thread's TLS.
+ *               In:  nativeDisplay - Native display.
+ *  RETURNS    : EGLDisplay, or EGL_NO_DISPLAY if the lookup must be done
+ *               under the global lock.
+ *
+ ***********************************************************************/
+IMG_INTERNAL EGLDisplay GetCachedEGLDisplay(TLS psTls, NativeDisplayType nativeDisplay)
+{
+	KEGL_DISPLAY *psDisplay;
+	IMG_UINT32 ui32Slot, i;
+
+	if ((psTls->eglCachedDisplay == EGL_NO_DISPLAY) || (psTls->hCachedNativeDisplay != nativeDisplay))
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	/* EGLDisplays are slot indices biased upwards by one, as EGL_NO_DISPLAY is zero */
+	ui32Slot = (IMG_UINT32)((IMG_UINTPTR_T)psTls->eglCachedDisplay - 1);
+
+	PVR_ASSERT(ui32Slot < EGL_MAX_NUM_DISPLAYS);
+
+	psDisplay = psTls->psGlobalData->asDisplay;
+
+	if ((psDisplay[ui32Slot].nativeDisplay != nativeDisplay) || !psDisplay[ui32Slot].hWSDrv)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	/*
+		The slot scan stops at the first free slot, and a slot is freed when
+		reloading its window system module fails. If one ahead of the cached
+		slot has been freed, the scan would claim it instead.
+	*/
+	for (i = 0; i < ui32Slot; i++)
+	{
+		if ((psDisplay[i].nativeDisplay == nativeDisplay) || (psDisplay[i].pWSEGL_FT == IMG_NULL))
+		{
+			return EGL_NO_DISPLAY;
+		}
+	}
+
+	return psTls->eglCachedDisplay;
+}
+
+
 /*****************************************************************************
  End of file (tls.c)
 *****************************************************************************/
@@ -28,6 +28,7 @@
 #include "metrics.h"
 #include "pvr_metrics.h"
 #include "srv.h"
+#include "common_tls.h"
 
 #define EGL_MAX_NUM_DISPLAYS 10
 
@@ -198,6 +199,14 @@ struct tls_tag
 
     IMG_UINT32 ui32ThreadID;
 
+    /*
+    ** The native display and EGLDisplay most recently returned to this
+    ** thread by eglGetDisplay, so that repeated lookups of the same native
+    ** display need not take the global lock
+    */
+    NativeDisplayType hCachedNativeDisplay;
+    EGLDisplay eglCachedDisplay;
+
     EGLGlobal *psGlobalData;
 
 #if defined(TIMING) || defined(DEBUG)
@@ -208,9 +217,30 @@ struct tls_tag
 };
 
 
-TLS TLS_Open(IMG_BOOL (*init)(TLS tls));
+TLS TLS_Create(IMG_BOOL (*init)(TLS tls));
 IMG_VOID TLS_Close(IMG_VOID (*deinit)(TLS tls));
 
+/*
+** Returns this thread's local storage, creating it on the thread's first
+** EGL call. Every entry point starts here, so the common case of an
+** existing TLS is inline and costs only the TLS lookup itself.
+*/
+static INLINE TLS TLS_Open(IMG_BOOL (*init)(TLS tls))
+{
+    TLS tls = (TLS)IMGEGLGetTLSValue();
+
+    if (tls == IMG_NULL)
+    {
+        tls = TLS_Create(init);
+    }
+
+    return tls;
+}
+
 IMG_BOOL _TlsInit(TLS psTls);
 
+IMG_BOOL IsCurrentEGLSurface(TLS psTls, KEGL_DISPLAY *psDpy, KEGL_SURFACE *psInputSurface);
+IMG_BOOL IsCurrentEGLContext(TLS psTls, KEGL_DISPLAY *psDpy, KEGL_CONTEXT *psInputContext);
+EGLDisplay GetCachedEGLDisplay(TLS psTls, NativeDisplayType nativeDisplay);
+
 #endif
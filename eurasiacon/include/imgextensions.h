@@ -71,6 +71,8 @@
 #define GLES2_EXTENSION_TEXTURE_STREAM
 #endif
 #define GLES2_EXTENSION_MULTISAMPLED_RENDER_TO_TEXTURE
+#define GLES2_EXTENSION_SHADER_PREWARM
+#define GLES2_EXTENSION_PIXEL_PACK_BUFFER
 
 /* VG extensions */
 #define VG_EXTENSION_EGL_IMAGE						
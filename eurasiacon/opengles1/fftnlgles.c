@@ -1743,26 +1743,17 @@ IMG_INTERNAL IMG_VOID SetupBuildFFTNLShaderConstants(GLES1Context *gc)
 			case FFGEN_STATE_MODELVIEWMATRIXPALETTE:
 			{
 				IMG_FLOAT *pfConstant;
-				IMG_FLOAT afTemp[GLES1_MAX_PALETTE_MATRICES * FFTNL_SIZE_MATRIX_4X4];
+				const IMG_FLOAT *pfPalette;
 
 				GLES1_ASSERT((psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4) <= GLES1_MAX_PALETTE_MATRICES);
 
-				pfConstant = &afTemp[0];
-
-				for(i=0; i<(psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4); i++)
-				{
-					TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sMatrix);
-
-					COPY_MATRIX(pfConstant, pfTempMatrix, FFTNL_SIZE_MATRIX_4X4);
-
-					pfConstant += FFTNL_SIZE_MATRIX_4X4;
-				}
+				pfPalette = GetPaletteMatrixConstants(gc, psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4);
 
 				for(i = 0; i < psReg->ui32ConstantCount; i++)
 				{
 					pfConstant = pfConstantBase + psReg->pui32DstOffset[i];
 
-					COPY_FLOAT(pfConstant, afTemp[psReg->pui32SrcOffset[i]]);
+					COPY_FLOAT(pfConstant, pfPalette[psReg->pui32SrcOffset[i]]);
 				}
 
 				break;
@@ -1770,31 +1761,17 @@ IMG_INTERNAL IMG_VOID SetupBuildFFTNLShaderConstants(GLES1Context *gc)
 			case FFGEN_STATE_MODELVIEWMATRIXINVERSETRANSPOSEPALETTE:
 			{
 				IMG_FLOAT *pfConstant;
-				IMG_FLOAT afTemp[GLES1_MAX_PALETTE_MATRICES * FFTNL_SIZE_MATRIX_4X4];
+				const IMG_FLOAT *pfPalette;
 
 				GLES1_ASSERT((psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4) <= GLES1_MAX_PALETTE_MATRICES);
 
-				pfConstant = &afTemp[0];
-
-				for(i=0; i<(psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4); i++)
-				{
-					if(gc->sTransform.psMatrixPalette[i].bUpdateInverse)
-					{
-						(*gc->sProcs.pfnComputeInverseTranspose)(gc, &gc->sTransform.psMatrixPalette[i]);
-					}
-
-					TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sInverseTranspose);
-
-					COPY_MATRIX(pfConstant, pfTempMatrix, FFTNL_SIZE_MATRIX_4X4);
-
-					pfConstant += FFTNL_SIZE_MATRIX_4X4;
-				}
+				pfPalette = GetPaletteInverseTransposeConstants(gc, psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4);
 
 				for(i = 0; i < psReg->ui32ConstantCount; i++)
 				{
 					pfConstant = pfConstantBase + psReg->pui32DstOffset[i];
 
-					COPY_FLOAT(pfConstant, afTemp[psReg->pui32SrcOffset[i]]);
+					COPY_FLOAT(pfConstant, pfPalette[psReg->pui32SrcOffset[i]]);
 				}
 
 				break;
@@ -2627,36 +2604,31 @@ IMG_INTERNAL IMG_VOID SetupBuildFFTNLShaderConstants(GLES1Context *gc)
 			}
 			case FFGEN_STATE_MODELVIEWMATRIXPALETTE:
 			{
-				GLES1_ASSERT((psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4) <= GLES1_MAX_PALETTE_MATRICES);
+				IMG_UINT32 ui32NumMatrices = psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4;
+				const IMG_FLOAT *pfPalette;
 
-				for(i=0; i<(psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4); i++)
-				{
-					TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sMatrix);
+				GLES1_ASSERT(ui32NumMatrices <= GLES1_MAX_PALETTE_MATRICES);
 
-					COPY_MATRIX(pfConstant, pfTempMatrix, FFTNL_SIZE_MATRIX_4X4);
+				pfPalette = GetPaletteMatrixConstants(gc, ui32NumMatrices);
 
-					pfConstant += FFTNL_SIZE_MATRIX_4X4;
-				}
+				COPY_MATRIX(pfConstant, pfPalette, ui32NumMatrices * FFTNL_SIZE_MATRIX_4X4);
+
+				pfConstant += ui32NumMatrices * FFTNL_SIZE_MATRIX_4X4;
 
 				break;
 			}
 			case FFGEN_STATE_MODELVIEWMATRIXINVERSETRANSPOSEPALETTE:
 			{
-				GLES1_ASSERT((psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4) <= GLES1_MAX_PALETTE_MATRICES);
+				IMG_UINT32 ui32NumMatrices = psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4;
+				const IMG_FLOAT *pfPalette;
 
-				for(i=0; i<(psReg->uSizeInDWords / FFTNL_SIZE_MATRIX_4X4); i++)
-				{
-					if(gc->sTransform.psMatrixPalette[i].bUpdateInverse)
-					{
-						(*gc->sProcs.pfnComputeInverseTranspose)(gc, &gc->sTransform.psMatrixPalette[i]);
-					}
+				GLES1_ASSERT(ui32NumMatrices <= GLES1_MAX_PALETTE_MATRICES);
 
-					TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sInverseTranspose);
+				pfPalette = GetPaletteInverseTransposeConstants(gc, ui32NumMatrices);
 
-					COPY_MATRIX(pfConstant, pfTempMatrix, FFTNL_SIZE_MATRIX_4X4);
+				COPY_MATRIX(pfConstant, pfPalette, ui32NumMatrices * FFTNL_SIZE_MATRIX_4X4);
 
-					pfConstant += FFTNL_SIZE_MATRIX_4X4;
-				}
+				pfConstant += ui32NumMatrices * FFTNL_SIZE_MATRIX_4X4;
 
 				break;
 			}
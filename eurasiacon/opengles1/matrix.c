@@ -597,18 +597,15 @@ IMG_INTERNAL IMG_VOID TransposeMatrix(GLESMatrix *psTranspose, const GLESMatrix
 
 
 /***********************************************************************************
- Function Name      : ComputeInverseTranspose
+ Function Name      : ComputeRescaleFactor
  Inputs             : gc, psTransform
  Outputs            : -
  Returns            : -
- Description        : Puts the inverse transpose of a matrix in the 
-					  transform->inverseTranspose slot, and computes the rescale 
-					  factor value if applicable.
+ Description        : Computes the rescale factor value from an up to date inverse
+					  transpose, if GL_RESCALE_NORMAL is enabled.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID ComputeInverseTranspose(GLES1Context *gc, GLES1Transform *psTransform)
+static IMG_VOID ComputeRescaleFactor(GLES1Context *gc, GLES1Transform *psTransform)
 {
-	(*gc->sProcs.sMatrixProcs.pfnInvertTranspose)(&psTransform->sInverseTranspose, &psTransform->sMatrix);
-
 	if (gc->ui32TnLEnables & GLES1_TL_RESCALE_ENABLE) 
 	{
 		IMG_FLOAT  fFactor;
@@ -628,6 +625,23 @@ IMG_INTERNAL IMG_VOID ComputeInverseTranspose(GLES1Context *gc, GLES1Transform *
 			psTransform->fRescaleFactor = GLES1_One / fFactor;
 		}
 	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ComputeInverseTranspose
+ Inputs             : gc, psTransform
+ Outputs            : -
+ Returns            : -
+ Description        : Puts the inverse transpose of a matrix in the 
+					  transform->inverseTranspose slot, and computes the rescale 
+					  factor value if applicable.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ComputeInverseTranspose(GLES1Context *gc, GLES1Transform *psTransform)
+{
+	(*gc->sProcs.sMatrixProcs.pfnInvertTranspose)(&psTransform->sInverseTranspose, &psTransform->sMatrix);
+
+	ComputeRescaleFactor(gc, psTransform);
 
 	psTransform->bUpdateInverse = IMG_FALSE;
 }
@@ -883,6 +897,107 @@ IMG_INTERNAL IMG_VOID InvertTransposeMatrix(GLESMatrix *psInverse, const GLESMat
 #endif
 }
 
+
+/***********************************************************************************
+ Function Name      : TransposeMatrices
+ Inputs             : apsSrc, ui32Count
+ Outputs            : pfDest
+ Returns            : -
+ Description        : UTILITY: Computes the transposes of several matrices, writing
+					  them to pfDest as consecutive packed 4x4 float arrays.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID TransposeMatrices(IMG_FLOAT *pfDest, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count)
+{
+#if defined(__psp2__)
+	IMG_FLOAT afSrc[GLES1_MAX_PALETTE_MATRICES][4][4];
+
+	while (ui32Count)
+	{
+		IMG_UINT32 ui32Batch = MIN(ui32Count, GLES1_MAX_PALETTE_MATRICES);
+		IMG_UINT32 i;
+
+		/* Gather the source matrices so they can be handed to NE10 in one call */
+		for (i = 0; i < ui32Batch; i++)
+		{
+			GLES1MemCopy(afSrc[i], apsSrc[i]->afMatrix, sizeof(afSrc[i]));
+		}
+
+		ne10_transmat_4x4f_neon((GLESMatrix *)pfDest, (GLESMatrix *)afSrc, ui32Batch);
+
+		pfDest    += ui32Batch * 16;
+		apsSrc    += ui32Batch;
+		ui32Count -= ui32Batch;
+	}
+#else
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		const GLESMatrix *psSrc = apsSrc[i];
+		IMG_UINT32 j;
+
+		for (j = 0; j < 4; j++)
+		{
+			pfDest[0]  = psSrc->afMatrix[0][j];
+			pfDest[1]  = psSrc->afMatrix[1][j];
+			pfDest[2]  = psSrc->afMatrix[2][j];
+			pfDest[3]  = psSrc->afMatrix[3][j];
+
+			pfDest += 4;
+		}
+	}
+#endif
+}
+
+
+/***********************************************************************************
+ Function Name      : InvertTransposeMatrices
+ Inputs             : apsSrc, ui32Count
+ Outputs            : apsInverse
+ Returns            : -
+ Description        : UTILITY: Computes the inverse transposes of several matrices.
+					  Results match InvertTransposeMatrix applied to each in turn.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID InvertTransposeMatrices(GLESMatrix * const *apsInverse, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count)
+{
+#if defined(__psp2__)
+	IMG_FLOAT afSrc[GLES1_MAX_PALETTE_MATRICES][4][4];
+	IMG_FLOAT afTemp[GLES1_MAX_PALETTE_MATRICES][4][4];
+
+	while (ui32Count)
+	{
+		IMG_UINT32 ui32Batch = MIN(ui32Count, GLES1_MAX_PALETTE_MATRICES);
+		IMG_UINT32 i;
+
+		for (i = 0; i < ui32Batch; i++)
+		{
+			GLES1MemCopy(afSrc[i], apsSrc[i]->afMatrix, sizeof(afSrc[i]));
+		}
+
+		ne10_transmat_4x4f_neon((GLESMatrix *)afTemp, (GLESMatrix *)afSrc, ui32Batch);
+		ne10_invmat_4x4f_neon((GLESMatrix *)afSrc, (GLESMatrix *)afTemp, ui32Batch);
+
+		for (i = 0; i < ui32Batch; i++)
+		{
+			apsInverse[i]->eMatrixType = apsSrc[i]->eMatrixType;
+
+			GLES1MemCopy(apsInverse[i]->afMatrix, afSrc[i], sizeof(afSrc[i]));
+		}
+
+		apsInverse += ui32Batch;
+		apsSrc     += ui32Batch;
+		ui32Count  -= ui32Batch;
+	}
+#else
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		InvertTransposeMatrix(apsInverse[i], apsSrc[i]);
+	}
+#endif
+}
+
 /***********************************************************************************
  Function Name      : CopyMatrix
  Inputs             : psSrc
@@ -979,6 +1094,25 @@ IMG_INTERNAL IMG_VOID MultMatrix(GLESMatrix *psRes, const GLESMatrix *psSrcA, co
 }
 
 
+#if defined(GLES1_EXTENSION_MATRIX_PALETTE)
+/***********************************************************************************
+ Function Name      : DirtyPaletteMatrix
+ Inputs             : gc, ui32Index
+ Outputs            : -
+ Returns            : -
+ Description        : Marks a palette matrix as changed, so that its cached
+					  constants are regenerated when next loaded.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DirtyPaletteMatrix(GLES1Context *gc, IMG_UINT32 ui32Index)
+{
+	gc->sTransform.ui32PaletteDirtyMask        |= (1U << ui32Index);
+	gc->sTransform.ui32PaletteInverseDirtyMask |= (1U << ui32Index);
+
+	gc->ui32DirtyMask |= GLES1_DIRTYFLAG_VERTPROG_CONSTANTS;
+}
+
+#endif /* defined(GLES1_EXTENSION_MATRIX_PALETTE) */
+
 /***********************************************************************************
  Function Name      : DoMultMatrix
  Inputs             : gc, pvData, pfnMultiply
@@ -1045,7 +1179,7 @@ IMG_INTERNAL IMG_VOID DoMultMatrix(GLES1Context *gc, IMG_VOID *pvData,
 
 			psTransform->bUpdateInverse = IMG_TRUE;
 
-			gc->ui32DirtyMask |= GLES1_DIRTYFLAG_VERTPROG_CONSTANTS;
+			DirtyPaletteMatrix(gc, gc->sState.sCurrent.ui32MatrixPaletteIndex);
 
 			break;
 		}
@@ -1112,7 +1246,7 @@ IMG_INTERNAL IMG_VOID DoLoadMatrix(GLES1Context *gc, const GLESMatrix *psMatrix)
 
 			psTransform->bUpdateInverse = IMG_TRUE;
 
-			gc->ui32DirtyMask |= GLES1_DIRTYFLAG_VERTPROG_CONSTANTS;
+			DirtyPaletteMatrix(gc, gc->sState.sCurrent.ui32MatrixPaletteIndex);
 
 			break;
 		}
@@ -1504,7 +1638,129 @@ IMG_INTERNAL IMG_VOID LoadIdentityMatrixPaletteMatrix(GLES1Context *gc)
 
 	psTransform->bUpdateInverse = IMG_FALSE;
 
-	gc->ui32DirtyMask |= GLES1_DIRTYFLAG_VERTPROG_CONSTANTS;
+	DirtyPaletteMatrix(gc, gc->sState.sCurrent.ui32MatrixPaletteIndex);
+}
+
+
+/***********************************************************************************
+ Function Name      : UpdatePaletteConstants
+ Inputs             : gc, pui32DirtyMask, ui32NumMatrices, bInverse
+ Outputs            : pfConstants, pui32DirtyMask
+ Returns            : -
+ Description        : Regenerates the packed transposes of the dirty entries among
+					  the first ui32NumMatrices palette matrices (or their inverse
+					  transposes), transposing each run of consecutive dirty
+					  entries with a single call.
+************************************************************************************/
+static IMG_VOID UpdatePaletteConstants(GLES1Context *gc, IMG_FLOAT *pfConstants, IMG_UINT32 *pui32DirtyMask,
+									   IMG_UINT32 ui32NumMatrices, IMG_BOOL bInverse)
+{
+	const GLESMatrix *apsSrc[GLES1_MAX_PALETTE_MATRICES];
+	IMG_UINT32 ui32First, ui32Count, i;
+
+	i = 0;
+
+	while (i < ui32NumMatrices)
+	{
+		if ((*pui32DirtyMask & (1U << i)) == 0)
+		{
+			i++;
+
+			continue;
+		}
+
+		ui32First = i;
+		ui32Count = 0;
+
+		while ((i < ui32NumMatrices) && ((*pui32DirtyMask & (1U << i)) != 0))
+		{
+			GLES1Transform *psPalette = &gc->sTransform.psMatrixPalette[i];
+
+			apsSrc[ui32Count++] = bInverse ? &psPalette->sInverseTranspose : &psPalette->sMatrix;
+
+			*pui32DirtyMask &= ~(1U << i);
+
+			i++;
+		}
+
+		(*gc->sProcs.sMatrixProcs.pfnTransposeMany)(&pfConstants[ui32First * 16], apsSrc, ui32Count);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetPaletteMatrixConstants
+ Inputs             : gc, ui32NumMatrices
+ Outputs            : -
+ Returns            : Transposed palette matrices, packed as vertex program constants
+ Description        : Brings the cached transposes of the first ui32NumMatrices
+					  palette matrices up to date and returns them.
+************************************************************************************/
+IMG_INTERNAL const IMG_FLOAT *GetPaletteMatrixConstants(GLES1Context *gc, IMG_UINT32 ui32NumMatrices)
+{
+	GLES1_ASSERT(ui32NumMatrices <= GLES1_MAX_PALETTE_MATRICES);
+
+	UpdatePaletteConstants(gc, gc->sTransform.afPaletteConstants, &gc->sTransform.ui32PaletteDirtyMask,
+						   ui32NumMatrices, IMG_FALSE);
+
+	return gc->sTransform.afPaletteConstants;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetPaletteInverseTransposeConstants
+ Inputs             : gc, ui32NumMatrices
+ Outputs            : -
+ Returns            : Transposed palette inverse transposes, packed as vertex
+					  program constants
+ Description        : Computes any stale inverse transposes among the first
+					  ui32NumMatrices palette matrices in one batch, then brings
+					  their cached transposes up to date and returns them.
+************************************************************************************/
+IMG_INTERNAL const IMG_FLOAT *GetPaletteInverseTransposeConstants(GLES1Context *gc, IMG_UINT32 ui32NumMatrices)
+{
+	GLESMatrix *apsInverse[GLES1_MAX_PALETTE_MATRICES];
+	const GLESMatrix *apsSrc[GLES1_MAX_PALETTE_MATRICES];
+	IMG_UINT32 ui32Count, i;
+
+	GLES1_ASSERT(ui32NumMatrices <= GLES1_MAX_PALETTE_MATRICES);
+
+	ui32Count = 0;
+
+	for (i = 0; i < ui32NumMatrices; i++)
+	{
+		GLES1Transform *psPalette = &gc->sTransform.psMatrixPalette[i];
+
+		if (psPalette->bUpdateInverse)
+		{
+			apsInverse[ui32Count] = &psPalette->sInverseTranspose;
+			apsSrc[ui32Count]     = &psPalette->sMatrix;
+
+			ui32Count++;
+		}
+	}
+
+	if (ui32Count)
+	{
+		(*gc->sProcs.sMatrixProcs.pfnInvertTransposeMany)(apsInverse, apsSrc, ui32Count);
+
+		for (i = 0; i < ui32NumMatrices; i++)
+		{
+			GLES1Transform *psPalette = &gc->sTransform.psMatrixPalette[i];
+
+			if (psPalette->bUpdateInverse)
+			{
+				ComputeRescaleFactor(gc, psPalette);
+
+				psPalette->bUpdateInverse = IMG_FALSE;
+			}
+		}
+	}
+
+	UpdatePaletteConstants(gc, gc->sTransform.afPaletteInverseConstants, &gc->sTransform.ui32PaletteInverseDirtyMask,
+						   ui32NumMatrices, IMG_TRUE);
+
+	return gc->sTransform.afPaletteInverseConstants;
 }
 
 #endif /* defined(GLES1_EXTENSION_MATRIX_PALETTE) */
@@ -1763,6 +2019,10 @@ IMG_INTERNAL IMG_BOOL InitTransformState(GLES1Context *gc)
 		(*gc->sProcs.pfnPickInvTransposeProcs)(gc, &psTransform->sInverseTranspose);
 		psTransform->bUpdateInverse = IMG_FALSE;
 	}
+
+	/* Cached palette constants are generated on first use */
+	gc->sTransform.ui32PaletteDirtyMask        = 0xFFFFFFFFU;
+	gc->sTransform.ui32PaletteInverseDirtyMask = 0xFFFFFFFFU;
 #endif /* defined(GLES1_EXTENSION_MATRIX_PALETTE) */
 
 	gc->sTransform.psProjection = psTransform = &gc->sTransform.psProjectionStack[0];
@@ -1889,7 +2149,7 @@ GL_API_EXT void GL_APIENTRY glLoadPaletteFromModelViewMatrixOES(void)
 
 	gc->sTransform.psMatrixPalette[gc->sState.sCurrent.ui32MatrixPaletteIndex] = *gc->sTransform.psModelView;
 
-	gc->ui32DirtyMask |= GLES1_DIRTYFLAG_VERTPROG_CONSTANTS;
+	DirtyPaletteMatrix(gc, gc->sState.sCurrent.ui32MatrixPaletteIndex);
 
 	GLES1_TIME_STOP(GLES1_TIMES_glLoadPaletteFromModelViewMatrixOES);
 }
@@ -1286,646 +1286,6 @@ IMG_INTERNAL IMG_VOID CopyTextureBGRA8888to4444(IMG_UINT16 *pui16Dest, IMG_UINT8
 
 
 
-#if defined(NO_UNALIGNED_ACCESS)
-/***********************************************************************************
- Function Name      : READ_UNALIGNED_32
- Inputs             : pui32Val
- Returns            : 32bit value pointed to by pui32Val
- Description        : If pui32Val isn't DWORD aligned, reads bytes, otherwise reads DWORD
-************************************************************************************/
-static IMG_UINT32 READ_UNALIGNED_32(const IMG_UINT32 *pui32Val)
-{	// Cast pointer to INT32 and see if it's already DWORD aligned
-	if ((((IMG_UINT32)pui32Val)&3)==0)
-	{	// If so then it's safe to just read and return the DWORD
-		return *pui32Val;
-	}
-	else
-	{	// Otherwise, build it up from the individual bytes
-		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui32Val;
-		return	(((IMG_UINT32)pui8Val[3])<<24)|
-				(((IMG_UINT32)pui8Val[2])<<16)|
-				(((IMG_UINT32)pui8Val[1])<<8)|
-				 ((IMG_UINT32)pui8Val[0]);
-	}	
-}
-
-
-/***********************************************************************************
- Function Name      : READ_UNALIGNED_16
- Inputs             : pui16Val
- Returns            : 16bit value pointed to by pui16Val
- Description        : If pui16Val isn't WORD aligned, reads bytes, otherwise reads WORD
-************************************************************************************/
-static IMG_UINT16 READ_UNALIGNED_16(const IMG_UINT16 *pui16Val)
-{	// Cast pointer to INT32 and see if it's already WORD aligned
-	if ((((IMG_UINT32)pui16Val)&1)==0)
-	{	// If so then it's safe to just read and return the WORD
-		return *pui16Val;
-	}
-	else
-	{	// Otherwise, build it up from the individual bytes
-		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui16Val;
-		return (((IMG_UINT16)pui8Val[1])<<8)|pui8Val[0];
-	}
-}
-#else
-#define READ_UNALIGNED_32(pui32Val) ((IMG_UINT32)(*(const IMG_UINT32 *)(pui32Val)))
-#define READ_UNALIGNED_16(pui16Val) ((IMG_UINT16)(*(const IMG_UINT16 *)(pui16Val)))
-#endif
-
-
-/***********************************************************************************
- Function Name      : Copy888Palette4Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 888 format
-					  to RGBA8888 HW format
-************************************************************************************/
-static IMG_VOID Copy888Palette4Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT32 ui32Temp;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
-	IMG_UINT8 aui8PalTemp[3];
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue0 = *pui8Src++;
-		ui8Invalue1 = ui8Invalue0 & 0xF;
-		ui8Invalue0 >>= 4;
-
-		aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
-		aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
-		aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
-
-		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-		*pui32Dest++ = ui32Temp;
-
-		aui8PalTemp[0] = pui8Palette[ui8Invalue1*3];
-		aui8PalTemp[1] = pui8Palette[ui8Invalue1*3+1];
-		aui8PalTemp[2] = pui8Palette[ui8Invalue1*3+2];
-
-		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-		*pui32Dest++ = ui32Temp;
-
-		i -= 2;
-	}
-	while(i);
-
-}
-
-
-/***********************************************************************************
- Function Name      : Copy888Palette4Level1xN
- Inputs             : pui8Src, ui32Height, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 888 format
-					  to RGBA8888 HW format, whole level 1xN
-************************************************************************************/
-static IMG_VOID Copy888Palette4Level1xN(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT32 ui32Temp;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
-	IMG_UINT8 aui8PalTemp[3];
-
-	if(ui32Height == 1)
-	{
-		ui8Invalue0 = *pui8Src;
-		ui8Invalue0 >>= 4;
-
-		aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
-		aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
-		aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
-
-		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-		*pui32Dest = ui32Temp;
-
-	}
-	else
-	{
-		i = ui32Height;
-
-		do
-		{
-			ui8Invalue0 = *pui8Src++;
-			ui8Invalue1 = ui8Invalue0 & 0xF;
-			ui8Invalue0 >>= 4;
-
-			aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
-			aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
-			aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
-
-			ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-			*pui32Dest++ = ui32Temp;
-
-			aui8PalTemp[0] = pui8Palette[ui8Invalue1*3];
-			aui8PalTemp[1] = pui8Palette[ui8Invalue1*3+1];
-			aui8PalTemp[2] = pui8Palette[ui8Invalue1*3+2];
-
-			ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-			*pui32Dest++ = ui32Temp;
-
-			i -= 2;
-		}
-		while(i);
-	}
-}
-
-
-/***********************************************************************************
- Function Name      : Copy888Palette8Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 8bit Palette with 888 format
-					  to RGBA8888 HW format
-************************************************************************************/
-static IMG_VOID Copy888Palette8Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width, 
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT32 ui32Temp;
-	IMG_UINT8 ui8Invalue;
-	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
-	IMG_UINT8 aui8PalTemp[3];
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue = *pui8Src++;
-
-		aui8PalTemp[0] = pui8Palette[ui8Invalue*3];
-		aui8PalTemp[1] = pui8Palette[ui8Invalue*3+1];
-		aui8PalTemp[2] = pui8Palette[ui8Invalue*3+2];
-
-		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
-
-		*pui32Dest++ = ui32Temp;
-	}
-	while(--i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy8888Palette4Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 8888 format
-					  to RGBA8888 HW format
-************************************************************************************/
-static IMG_VOID Copy8888Palette4Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
-	IMG_UINT32 ui32PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue0 = *pui8Src++;
-		ui8Invalue1 = ui8Invalue0 & 0xF;
-		ui8Invalue0 >>= 4;
-
-		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
-
-		*pui32Dest++ = ui32PalTemp; 
-
-		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue1] );
-
-		*pui32Dest++ = ui32PalTemp; 
-
-		i -= 2;
-	}
-	while(i);
-
-}
-
-
-/***********************************************************************************
- Function Name      : Copy8888Palette4Level1xN
- Inputs             : pui8Src, ui32Height, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 8888 format
-					  to RGBA8888 HW format, whole level 1xN
-************************************************************************************/
-static IMG_VOID Copy8888Palette4Level1xN(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
-	IMG_UINT32 ui32PalTemp;
-
-	if(ui32Height == 1)
-	{
-		ui8Invalue0 = *pui8Src;
-		ui8Invalue0 >>= 4;
-
-		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
-
-		*pui32Dest = ui32PalTemp; 
-	}
-	else
-	{
-		i = ui32Height;
-
-		do 
-		{
-			ui8Invalue0 = *pui8Src++;
-			ui8Invalue1 = ui8Invalue0 & 0xF;
-			ui8Invalue0 >>= 4;
-
-			ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
-
-			*pui32Dest++ = ui32PalTemp; 
-
-			ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue1] );
-
-			*pui32Dest++ = ui32PalTemp; 
-
-			i -= 2;
-		}
-		while(i);
-	}
-}
-
-
-/***********************************************************************************
- Function Name      : Copy8888Palette8Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 8bit Palette with 8888 format
-					  to RGBA8888 HW format
-************************************************************************************/
-static IMG_VOID Copy8888Palette8Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue;
-	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
-	IMG_UINT32 ui32PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue = *pui8Src++;
-
-		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue] );
-
-		*pui32Dest++ = ui32PalTemp; 
-	}
-	while(--i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy565Palette4Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 565 format
-					  to RGB565 HW format
-************************************************************************************/
-static IMG_VOID Copy565Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue0 = *pui8Src++;
-		ui8Invalue1 = ui8Invalue0 & 0xF;
-		ui8Invalue0 >>= 4;
-
-		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
-		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
-
-		i -= 2;
-	}
-	while(i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy565Palette4Level1xN
- Inputs             : pui8Src, ui32Height, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 565 format
-					  to RGBA565 HW format, whole level 1xN
-************************************************************************************/
-static IMG_VOID Copy565Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-
-	if(ui32Height == 1)
-	{
-		ui8Invalue0 = *pui8Src;
-		ui8Invalue0 >>= 4;
-
-		*pui16Dest = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
-	}
-	else
-	{
-		i = ui32Height;
-
-		do
-		{
-			ui8Invalue0 = *pui8Src++;
-			ui8Invalue1 = ui8Invalue0 & 0xF;
-			ui8Invalue0 >>= 4;
-
-			*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
-			*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
-
-			i -= 2;
-		}
-		while(i);
-	}
-}
-
-
-/***********************************************************************************
- Function Name      : Copy565Palette8Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 8bit Palette with 565 format
-					  to RGB565 HW format
-************************************************************************************/
-static IMG_VOID Copy565Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue = *pui8Src++;
-
-		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
-	}
-	while(--i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy4444Palette4Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 4444 format
-					  to RGBA4444 HW format
-************************************************************************************/
-static IMG_VOID Copy4444Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pu16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue0 = *pui8Src++;
-		ui8Invalue1 = ui8Invalue0 & 0xF;
-		ui8Invalue0 >>= 4;
-
-		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0] );
-		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-
-		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue1] );
-		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-
-		i -= 2;
-	}
-	while(i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy4444Palette4Level1xN
- Inputs             : pui8Src, ui32Height, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 4444 format
-					  to RGBA4444 HW format, whole level 1xN
-************************************************************************************/
-static IMG_VOID Copy4444Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pu16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	if(ui32Height == 1)
-	{
-		ui8Invalue0 = *pui8Src;
-
-		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0 >> 4]);
-
-		*pui16Dest = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-	}
-	else
-	{
-		i = ui32Height;
-
-		do
-		{
-			ui8Invalue0 = *pui8Src++;
-			ui8Invalue1 = ui8Invalue0 & 0xF;
-			ui8Invalue0 >>= 4;
-
-			ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0] );
-			*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-
-			ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue1] );
-			*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-
-			i -= 2;
-		}
-		while(i);
-	}
-}
-
-
-/***********************************************************************************
- Function Name      : Copy4444Palette8Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 8bit Palette with 4444 format
-					  to RGBA4444 HW format
-************************************************************************************/
-static IMG_VOID Copy4444Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue = *pui8Src++;
-		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
-
-		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
-	}
-	while(--i);
-}
-
-
-/***********************************************************************************
- Function Name      : Copy5551Palette4Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 5551 format
-					  to RGBA1555 HW format
-************************************************************************************/
-static IMG_VOID Copy5551Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue0 = *pui8Src++;
-		ui8Invalue1 = ui8Invalue0 & 0xF;
-		ui8Invalue0 >>= 4;
-
-		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
-		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-
-		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
-		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-
-		i -= 2;
-	}
-	while(i);
-
-}
-
-
-/***********************************************************************************
- Function Name      : Copy5551Palette4Level1xN
- Inputs             : pui8Src, ui32Height, pvPalette
- Outputs            : pui32Dest
- Returns            : -
- Description        : Copies texture data from 4bit Palette with 5551 format
-					  to RGBA5551 HW format, whole level 1xN
-************************************************************************************/
-static IMG_VOID Copy5551Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue0, ui8Invalue1;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	if(ui32Height == 1)
-	{
-		ui8Invalue0 = *pui8Src;
-
-		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0 >> 4] );
-
-		*pui16Dest = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-	}
-	else
-	{
-		i = ui32Height;
-
-		do
-		{
-			ui8Invalue0 = *pui8Src++;
-			ui8Invalue1 = ui8Invalue0 & 0xF;
-			ui8Invalue0 >>= 4;
-
-			ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
-			*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-
-			ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
-			*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-
-			i -= 2;
-		}
-		while(i);
-	}
-}
-
-
-/***********************************************************************************
- Function Name      : Copy5551Palette8Span
- Inputs             : pui8Src, ui32Width, pvPalette
- Outputs            : pui16Dest
- Returns            : -
- Description        : Copies texture data from 8bit Palette with 5551 format
-					  to RGBA1555 HW format
-************************************************************************************/
-static IMG_VOID Copy5551Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
-									 const IMG_VOID *pvPalette)
-{
-	IMG_UINT32 i;
-	IMG_UINT8 ui8Invalue;
-	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
-	IMG_UINT16 ui16PalTemp;
-
-	i = ui32Width;
-
-	do
-	{
-		ui8Invalue = *pui8Src++;
-		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
-
-		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
-	}
-	while(--i);
-}
-
-
 #if defined(GLES1_EXTENSION_TEXTURE_STREAM)
 /***********************************************************************************
  Function Name      : SetTextureFormat
@@ -3950,8 +3310,8 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 	IMG_UINT32 ui32Level, ui32Face;	
 	IMG_UINT8 *pui8Dest;
 	IMG_UINT32 i;
-	PFNCopyPaletteSpan pfnCopySpan = IMG_NULL;
-	PFNCopyPaletteSpan pfnCopyLevel1xN = IMG_NULL;
+	PFNExpandPaletteLevel pfnExpandLevel;
+	IMG_UINT32 *pui32PaletteLUT;
 	IMG_UINT32 ui32SrcBitsPerPixel;
 	const GLESTextureFormat *psTexFormat;
 	IMG_UINT32 ui32NumLevels, ui32PaletteSize, ui32Size;
@@ -3977,8 +3337,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 3 * (1 << 4);
 			ui32SrcBitsPerPixel = 4;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy888Palette4Span;
-			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy888Palette4Level1xN;
 			psTexFormat = &TexFormatXBGR8888;
 			break;
 		}
@@ -3986,8 +3344,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 4 * (1 << 4);
 			ui32SrcBitsPerPixel = 4;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy8888Palette4Span;
-			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy8888Palette4Level1xN;
 			psTexFormat = &TexFormatABGR8888;
 			break;
 		}
@@ -3995,8 +3351,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 4);
 			ui32SrcBitsPerPixel = 4;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy565Palette4Span;
-			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy565Palette4Level1xN;
 			psTexFormat = &TexFormatRGB565;
 			break;
 		}
@@ -4004,8 +3358,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 4);
 			ui32SrcBitsPerPixel = 4;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy4444Palette4Span;
-			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy4444Palette4Level1xN;
 			psTexFormat = &TexFormatARGB4444;
 			break;
 		}
@@ -4013,8 +3365,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 4);
 			ui32SrcBitsPerPixel = 4;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy5551Palette4Span;
-			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy5551Palette4Level1xN;
 			psTexFormat = &TexFormatARGB1555;
 			break;
 		}
@@ -4022,7 +3372,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 3 * (1 << 8);
 			ui32SrcBitsPerPixel = 8;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy888Palette8Span;
 			psTexFormat = &TexFormatXBGR8888;
 			break;
 		}
@@ -4030,7 +3379,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 4 * (1 << 8);
 			ui32SrcBitsPerPixel = 8;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy8888Palette8Span;
 			psTexFormat = &TexFormatABGR8888;
 			break;
 		}
@@ -4038,7 +3386,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 8);
 			ui32SrcBitsPerPixel = 8;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy565Palette8Span;
 			psTexFormat = &TexFormatRGB565;
 			break;
 		}
@@ -4046,7 +3393,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 8);
 			ui32SrcBitsPerPixel = 8;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy4444Palette8Span;
 			psTexFormat = &TexFormatARGB4444;
 			break;
 		}
@@ -4054,7 +3400,6 @@ GL_API void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenu
 		{
 			ui32PaletteSize = 2 * (1 << 8);
 			ui32SrcBitsPerPixel = 8;
-			pfnCopySpan = (PFNCopyPaletteSpan) Copy5551Palette8Span;
 			psTexFormat = &TexFormatARGB1555;
 			break;
 		}
@@ -4203,6 +3548,41 @@ bad_value:
 
 		pvPixels = (const IMG_UINT8 *)pvPixels + ui32PaletteSize;
 
+		pui32PaletteLUT = IMG_NULL;
+
+		if(ui32SrcBitsPerPixel == 8)
+		{
+			pfnExpandLevel = (psTexFormat->ui32TotalBytesPerTexel == 4) ? ExpandPalette8Level32bpp : ExpandPalette8Level16bpp;
+		}
+		else
+		{
+			pfnExpandLevel = (psTexFormat->ui32TotalBytesPerTexel == 4) ? ExpandPalette4Level32bpp : ExpandPalette4Level16bpp;
+		}
+
+		if(data)
+		{
+			/* Convert the palette once for all levels. 4bit 32bpp tables hold two DWORDs per entry */
+			ui32Size = 256 * sizeof(IMG_UINT32);
+
+			if(ui32SrcBitsPerPixel == 4 && psTexFormat->ui32TotalBytesPerTexel == 4)
+			{
+				ui32Size <<= 1;
+			}
+
+			pui32PaletteLUT = GLES1Malloc(gc, ui32Size);
+
+			if(!pui32PaletteLUT)
+			{
+				SetError(gc, GL_OUT_OF_MEMORY);
+
+				GLES1_TIME_STOP(GLES1_TIMES_glCompressedTexImage2D);
+
+				return;
+			}
+
+			BuildPaletteLUT(pui32PaletteLUT, internalformat, data, ui32SrcBitsPerPixel, psTexFormat->ui32TotalBytesPerTexel);
+		}
+
 		/* Allocate memory for the level data */
 		for(i=0; i< ui32NumLevels; i++)
 		{
@@ -4230,42 +3610,19 @@ bad_value:
 
 			if(data && pui8Dest)
 			{
-				IMG_VOID *pvDest = psMipLevel->pui8Buffer;
-				const IMG_UINT8 *pui8Src = (const IMG_UINT8 *)pvPixels;
-				IMG_UINT32 ui32SrcRowSize = (ui32Width * ui32SrcBitsPerPixel) >> 3;
-				IMG_UINT32 ui32DstRowSize = ui32Width * psTex->psFormat->ui32TotalBytesPerTexel;
-				IMG_UINT32 j;
-				
 				if ((ui32Height) && (ui32Width))
-				{ 
-					if((ui32SrcBitsPerPixel == 8 || ui32Width != 1) && (pfnCopySpan != IMG_NULL))
-					{
-						j = ui32Height;
-
-						do
-						{
-							(*pfnCopySpan)(pvDest, pui8Src, ui32Width, data);
-
-							pvDest = (IMG_UINT8 *)pvDest + ui32DstRowSize;
-							pui8Src += ui32SrcRowSize;
-						}
-						while(--j);
-					}
-					else if((ui32SrcBitsPerPixel != 8 && ui32Width == 1) && (pfnCopyLevel1xN != IMG_NULL)) 
-					{
-						(*pfnCopyLevel1xN)(pvDest, pui8Src, ui32Height, data);
-					}
-					else
-					{
-						PVR_DPF((PVR_DBG_ERROR,"glCompressedTexImage2D: Wrong internalformat, palette or width combination"));
-						TextureRemoveResident(gc, psTex);
-						GLES1_TIME_STOP(GLES1_TIMES_glCompressedTexImage2D);
-						return;
-					}
+				{
+					/* Rows are contiguous in both source and destination, so expand the whole level */
+					(*pfnExpandLevel)(psMipLevel->pui8Buffer, (const IMG_UINT8 *)pvPixels, ui32Width * ui32Height, pui32PaletteLUT);
 				}
 			}
 			else
 			{
+				if(pui32PaletteLUT)
+				{
+					GLES1Free(gc, pui32PaletteLUT);
+				}
+
 				/*
 				* remove texture from active list.  If needed, validation will reload 
 				*/
@@ -4289,6 +3646,11 @@ bad_value:
 				ui32Height = 1;
 			}
 		}
+
+		if(pui32PaletteLUT)
+		{
+			GLES1Free(gc, pui32PaletteLUT);
+		}
 	
 		/* 
   		 * remove texture from active list.  If needed, validation will reload 
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * Name         : texpalette.c
+ *
+ * Copyright    : 2003-2009 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Expansion of GL_OES_compressed_paletted_texture levels to
+ *                the HW texel formats
+ *
+ * Platform     : ANSI
+ *
+ * $Log: texpalette.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+#if defined(NO_UNALIGNED_ACCESS)
+/***********************************************************************************
+ Function Name      : READ_UNALIGNED_32
+ Inputs             : pui32Val
+ Returns            : 32bit value pointed to by pui32Val
+ Description        : If pui32Val isn't DWORD aligned, reads bytes, otherwise reads DWORD
+************************************************************************************/
+static IMG_UINT32 READ_UNALIGNED_32(const IMG_UINT32 *pui32Val)
+{	// Cast pointer to INT32 and see if it's already DWORD aligned
+	if ((((IMG_UINT32)pui32Val)&3)==0)
+	{	// If so then it's safe to just read and return the DWORD
+		return *pui32Val;
+	}
+	else
+	{	// Otherwise, build it up from the individual bytes
+		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui32Val;
+		return	(((IMG_UINT32)pui8Val[3])<<24)|
+				(((IMG_UINT32)pui8Val[2])<<16)|
+				(((IMG_UINT32)pui8Val[1])<<8)|
+				 ((IMG_UINT32)pui8Val[0]);
+	}	
+}
+
+
+/***********************************************************************************
+ Function Name      : READ_UNALIGNED_16
+ Inputs             : pui16Val
+ Returns            : 16bit value pointed to by pui16Val
+ Description        : If pui16Val isn't WORD aligned, reads bytes, otherwise reads WORD
+************************************************************************************/
+static IMG_UINT16 READ_UNALIGNED_16(const IMG_UINT16 *pui16Val)
+{	// Cast pointer to INT32 and see if it's already WORD aligned
+	if ((((IMG_UINT32)pui16Val)&1)==0)
+	{	// If so then it's safe to just read and return the WORD
+		return *pui16Val;
+	}
+	else
+	{	// Otherwise, build it up from the individual bytes
+		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui16Val;
+		return (((IMG_UINT16)pui8Val[1])<<8)|pui8Val[0];
+	}
+}
+#else
+#define READ_UNALIGNED_32(pui32Val) ((IMG_UINT32)(*(const IMG_UINT32 *)(pui32Val)))
+#define READ_UNALIGNED_16(pui16Val) ((IMG_UINT16)(*(const IMG_UINT16 *)(pui16Val)))
+#endif
+
+
+/***********************************************************************************
+ Function Name      : ConvertPaletteEntry
+ Inputs             : eInternalFormat, pvPalette, ui32Index
+ Outputs            : -
+ Returns            : Palette entry converted to the HW texel format
+ Description        : Converts a single palette entry to the HW format used for the
+					  paletted internal format. 16bit formats are returned in the
+					  low half of the result.
+************************************************************************************/
+static IMG_UINT32 ConvertPaletteEntry(GLenum eInternalFormat, const IMG_VOID *pvPalette, IMG_UINT32 ui32Index)
+{
+	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
+	IMG_UINT32 ui32PalTemp;
+
+	switch(eInternalFormat)
+	{
+		case GL_PALETTE4_RGB8_OES:
+		case GL_PALETTE8_RGB8_OES:
+		{
+			pui8Palette += ui32Index * 3;
+
+			return 0xFF000000 | ((IMG_UINT32)pui8Palette[2] << 16) | ((IMG_UINT32)pui8Palette[1] << 8) | pui8Palette[0];
+		}
+		case GL_PALETTE4_RGBA8_OES:
+		case GL_PALETTE8_RGBA8_OES:
+		{
+			return READ_UNALIGNED_32( &((const IMG_UINT32 *)pvPalette)[ui32Index] );
+		}
+		case GL_PALETTE4_R5_G6_B5_OES:
+		case GL_PALETTE8_R5_G6_B5_OES:
+		{
+			return READ_UNALIGNED_16( &((const IMG_UINT16 *)pvPalette)[ui32Index] );
+		}
+		case GL_PALETTE4_RGBA4_OES:
+		case GL_PALETTE8_RGBA4_OES:
+		{
+			ui32PalTemp = READ_UNALIGNED_16( &((const IMG_UINT16 *)pvPalette)[ui32Index] );
+
+			return ((ui32PalTemp << 12) | (ui32PalTemp >> 4)) & 0xFFFF;
+		}
+		case GL_PALETTE4_RGB5_A1_OES:
+		case GL_PALETTE8_RGB5_A1_OES:
+		default:
+		{
+			ui32PalTemp = READ_UNALIGNED_16( &((const IMG_UINT16 *)pvPalette)[ui32Index] );
+
+			return ((ui32PalTemp << 15) | (ui32PalTemp >> 1)) & 0xFFFF;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : BuildPaletteLUT
+ Inputs             : eInternalFormat, pvPalette, ui32SrcBitsPerPixel, 
+					  ui32DstBytesPerTexel
+ Outputs            : pui32LUT
+ Returns            : -
+ Description        : Converts the palette to the HW format once per upload.
+					  8bit palettes produce one texel per index. 4bit palettes produce
+					  a 256 entry table indexed by a whole source byte, each entry
+					  holding the two texels that byte encodes (high nibble first).
+					  16bit pairs are packed into one DWORD, 32bit pairs use two.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID BuildPaletteLUT(IMG_UINT32 *pui32LUT, GLenum eInternalFormat, const IMG_VOID *pvPalette,
+									  IMG_UINT32 ui32SrcBitsPerPixel, IMG_UINT32 ui32DstBytesPerTexel)
+{
+	IMG_UINT32 aui32Palette[16];
+	IMG_UINT32 i;
+
+	if(ui32SrcBitsPerPixel == 8)
+	{
+		for(i=0; i < 256; i++)
+		{
+			pui32LUT[i] = ConvertPaletteEntry(eInternalFormat, pvPalette, i);
+		}
+
+		return;
+	}
+
+	for(i=0; i < 16; i++)
+	{
+		aui32Palette[i] = ConvertPaletteEntry(eInternalFormat, pvPalette, i);
+	}
+
+	if(ui32DstBytesPerTexel == 2)
+	{
+		for(i=0; i < 256; i++)
+		{
+			/* First texel at the lower address */
+			pui32LUT[i] = aui32Palette[i >> 4] | (aui32Palette[i & 0xF] << 16);
+		}
+	}
+	else
+	{
+		for(i=0; i < 256; i++)
+		{
+			pui32LUT[(i << 1)]     = aui32Palette[i >> 4];
+			pui32LUT[(i << 1) + 1] = aui32Palette[i & 0xF];
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpandPalette4Level16bpp
+ Inputs             : pui8Src, ui32NumTexels, pui32LUT
+ Outputs            : pvDest
+ Returns            : -
+ Description        : Expands a whole 4bit paletted level to a 16bit HW format, 
+					  writing both texels of each source byte with a single store.
+					  Rows are contiguous in both source and destination, so this 
+					  covers 1xN levels too.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ExpandPalette4Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+											   const IMG_UINT32 *pui32LUT)
+{
+	IMG_UINT32 *pui32Dest = (IMG_UINT32 *)pvDest;
+	IMG_UINT32 i = ui32NumTexels >> 1;
+
+	while(i--)
+	{
+		*pui32Dest++ = pui32LUT[*pui8Src++];
+	}
+
+	if(ui32NumTexels & 1)
+	{
+		*(IMG_UINT16 *)pui32Dest = (IMG_UINT16)pui32LUT[*pui8Src];
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpandPalette4Level32bpp
+ Inputs             : pui8Src, ui32NumTexels, pui32LUT
+ Outputs            : pvDest
+ Returns            : -
+ Description        : Expands a whole 4bit paletted level to a 32bit HW format, 
+					  one table lookup per source byte.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ExpandPalette4Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+											   const IMG_UINT32 *pui32LUT)
+{
+	IMG_UINT32 *pui32Dest = (IMG_UINT32 *)pvDest;
+	const IMG_UINT32 *pui32Pair;
+	IMG_UINT32 i = ui32NumTexels >> 1;
+
+	while(i--)
+	{
+		pui32Pair = &pui32LUT[(IMG_UINT32)(*pui8Src++) << 1];
+
+		pui32Dest[0] = pui32Pair[0];
+		pui32Dest[1] = pui32Pair[1];
+
+		pui32Dest += 2;
+	}
+
+	if(ui32NumTexels & 1)
+	{
+		*pui32Dest = pui32LUT[(IMG_UINT32)(*pui8Src) << 1];
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpandPalette8Level16bpp
+ Inputs             : pui8Src, ui32NumTexels, pui32LUT
+ Outputs            : pvDest
+ Returns            : -
+ Description        : Expands a whole 8bit paletted level to a 16bit HW format
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ExpandPalette8Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+											   const IMG_UINT32 *pui32LUT)
+{
+	IMG_UINT16 *pui16Dest = (IMG_UINT16 *)pvDest;
+
+	while(ui32NumTexels--)
+	{
+		*pui16Dest++ = (IMG_UINT16)pui32LUT[*pui8Src++];
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpandPalette8Level32bpp
+ Inputs             : pui8Src, ui32NumTexels, pui32LUT
+ Outputs            : pvDest
+ Returns            : -
+ Description        : Expands a whole 8bit paletted level to a 32bit HW format
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ExpandPalette8Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+											   const IMG_UINT32 *pui32LUT)
+{
+	IMG_UINT32 *pui32Dest = (IMG_UINT32 *)pvDest;
+
+	while(ui32NumTexels--)
+	{
+		*pui32Dest++ = pui32LUT[*pui8Src++];
+	}
+}
@@ -499,7 +499,7 @@ typedef struct GLESTextureManagerRec
 } GLES1TextureManager;
 
 typedef IMG_VOID (*PFNReadSpan)(const GLESPixelSpanInfo *);
-typedef IMG_VOID (*PFNCopyPaletteSpan)(IMG_VOID *, const IMG_VOID *, IMG_UINT32, const IMG_VOID *);
+typedef IMG_VOID (*PFNExpandPaletteLevel)(IMG_VOID *, const IMG_UINT8 *, IMG_UINT32, const IMG_UINT32 *);
 
 typedef IMG_VOID (*PFNCopyTextureData)(IMG_VOID *, const IMG_VOID *, IMG_UINT32, 
 				       IMG_UINT32, IMG_UINT32, GLESMipMapLevel *, 
@@ -742,6 +742,18 @@ IMG_VOID CopyTextureBGRA8888to4444(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src,
 				   IMG_BOOL bCopySubTex);
 #endif /* defined(GLES1_EXTENSION_TEXTURE_FORMAT_BGRA8888) */
 
+IMG_VOID BuildPaletteLUT(IMG_UINT32 *pui32LUT, GLenum eInternalFormat, const IMG_VOID *pvPalette,
+			 IMG_UINT32 ui32SrcBitsPerPixel, IMG_UINT32 ui32DstBytesPerTexel);
+
+IMG_VOID ExpandPalette4Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette4Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette8Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette8Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+
 
 
 
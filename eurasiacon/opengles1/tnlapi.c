@@ -161,6 +161,8 @@ IMG_INTERNAL IMG_VOID SetupTransformLightingProcs(GLES1Context *gc)
 	gc->sProcs.sMatrixProcs.pfnInvertTranspose = InvertTransposeMatrix;
 	gc->sProcs.sMatrixProcs.pfnMakeIdentity    = MakeIdentity;
 	gc->sProcs.sMatrixProcs.pfnMult			   = MultMatrix;
+	gc->sProcs.sMatrixProcs.pfnTransposeMany       = TransposeMatrices;
+	gc->sProcs.sMatrixProcs.pfnInvertTransposeMany = InvertTransposeMatrices;
 
 	gc->sProcs.pfnPushMatrix 				= PushModelViewMatrix;
 	gc->sProcs.pfnPopMatrix 				= PopModelViewMatrix;
@@ -192,6 +192,11 @@ typedef struct GLESMatrixProcsRec
 
 	IMG_VOID (*pfnMult)(GLESMatrix *psDest, const GLESMatrix *psSrcA, const GLESMatrix *psSrcB);
 
+	/* Batched forms: transpose into packed 4x4 float arrays, and invert-transpose in place */
+	IMG_VOID (*pfnTransposeMany)(IMG_FLOAT *pfDest, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count);
+
+	IMG_VOID (*pfnInvertTransposeMany)(GLESMatrix * const *apsDest, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count);
+
 } GLESMatrixProcs;
 
 
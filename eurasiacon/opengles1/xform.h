@@ -142,6 +142,16 @@ typedef struct GLES1TransformMachineRec
     */
 #if defined(GLES1_EXTENSION_MATRIX_PALETTE)
 	GLES1Transform *psMatrixPalette;
+
+	/*
+	** Transposed palette matrices and inverse transposes, packed as they are
+	** loaded into vertex program constants. A set bit in the dirty masks
+	** means the corresponding entry must be regenerated before use.
+	*/
+	IMG_UINT32 ui32PaletteDirtyMask;
+	IMG_UINT32 ui32PaletteInverseDirtyMask;
+	IMG_FLOAT afPaletteConstants[GLES1_MAX_PALETTE_MATRICES * 16];
+	IMG_FLOAT afPaletteInverseConstants[GLES1_MAX_PALETTE_MATRICES * 16];
 #endif /* defined(GLES1_EXTENSION_MATRIX_PALETTE) */
 
     /*
@@ -193,6 +203,8 @@ IMG_VOID MakeIdentity(GLESMatrix *psMatrix);
 IMG_VOID MultMatrix(GLESMatrix *psRes, const GLESMatrix *psSrcA, const GLESMatrix *psSrcB);
 
 IMG_VOID InvertTransposeMatrix(GLESMatrix *psInverse, const GLESMatrix *psSrc);
+IMG_VOID TransposeMatrices(IMG_FLOAT *pfDest, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count);
+IMG_VOID InvertTransposeMatrices(GLESMatrix * const *apsInverse, const GLESMatrix * const *apsSrc, IMG_UINT32 ui32Count);
 
 IMG_VOID PushModelViewMatrix(GLES1Context *gc);
 IMG_VOID PopModelViewMatrix(GLES1Context *gc);
@@ -201,6 +213,9 @@ IMG_VOID LoadIdentityModelViewMatrix(GLES1Context *gc);
 IMG_VOID PushMatrixPaletteMatrix(GLES1Context *gc);
 IMG_VOID PopMatrixPaletteMatrix(GLES1Context *gc);
 IMG_VOID LoadIdentityMatrixPaletteMatrix(GLES1Context *gc);
+IMG_VOID DirtyPaletteMatrix(GLES1Context *gc, IMG_UINT32 ui32Index);
+const IMG_FLOAT *GetPaletteMatrixConstants(GLES1Context *gc, IMG_UINT32 ui32NumMatrices);
+const IMG_FLOAT *GetPaletteInverseTransposeConstants(GLES1Context *gc, IMG_UINT32 ui32NumMatrices);
 
 IMG_VOID PushProjectionMatrix(GLES1Context *gc);
 IMG_VOID PopProjectionMatrix(GLES1Context *gc);
@@ -26,19 +26,25 @@ opengles2_src = \
  accum.c \
  binshader.c \
  bufobj.c \
+ bufobjrename.c \
  clear.c \
+ drawdefer.c \
  drawvarray.c \
  eglglue.c \
  eglimage.c \
+ etc1codec.c \
  fbo.c \
  get.c \
  gles2errata.c \
+ indexopt.c \
  makemips.c \
  metrics.c \
  misc.c \
  names.c \
  pdump.c \
  pixelop.c \
+ pixelpack.c \
+ prewarm.c \
  profile.c \
  shader.c \
  scissor.c \
@@ -46,10 +52,13 @@ opengles2_src = \
  spanpack.c \
  state.c \
  statehash.c \
+ tabuffer.c \
  tex.c \
  texdata.c \
+ texetc1.c \
  texformat.c \
  texmgmt.c \
+ texstaging.c \
  texstream.c \
  texyuv.c \
  uniform.c \
@@ -57,6 +66,7 @@ opengles2_src = \
  validate.c \
  vertex.c \
  vertexarrobj.c \
+ vertexcopy.c \
  $(TOP)/common/tls/linux_tls.c \
  $(TOP)/common/tls/nothreads_tls.c
 
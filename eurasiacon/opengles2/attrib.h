@@ -64,6 +64,7 @@ typedef struct GLES2AttribArrayPointerStateRec
 
 extern IMG_VOID (* const CopyData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count);
 extern IMG_VOID (* const MemCopyData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count);
+extern IMG_VOID (* const GatherData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count);
 
 #if defined(NO_UNALIGNED_ACCESS)
 extern IMG_VOID (* const CopyDataShortAligned[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count);
@@ -91,6 +92,9 @@ typedef struct GLES2AttribArrayPointerMachineRec
 	IMG_VOID	(*pfnCopyData)(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count);
 #endif
 
+	/* Fused deindex-and-copy of this attribute, used by DrawElements on client arrays */
+	IMG_VOID	(*pfnGatherData)(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count);
+
 	IMG_VOID	*pvPDSSrcAddress;
 	GLES2AttribArrayPointerState *psState;
 
@@ -62,9 +62,9 @@ IMG_INTERNAL IMG_VOID FreeBufObjState(GLES2Context *gc)
 	{
 		if(gc->sBufferObject.psActiveBuffer[i])
 		{
-		    /* Only decrease VBO's refCount by 1, 
-			   since only VBO can be bound to the context, while IBO can only be bound to VAO */
-		    if (i == ARRAY_BUFFER_INDEX)
+		    /* Only decrease VBO's (and pixel pack buffer's) refCount by 1, 
+			   since only they can be bound to the context, while IBO can only be bound to VAO */
+		    if (i != ELEMENT_ARRAY_BUFFER_INDEX)
 			{
 				NamedItemDelRef(gc, gc->psSharedState->apsNamesArray[GLES2_NAMETYPE_BUFOBJ], (GLES2NamedItem*)gc->sBufferObject.psActiveBuffer[i]);
 			}
@@ -101,6 +101,7 @@ static GLES2BufferObject * CreateBufferObject(GLES2Context *gc, IMG_UINT32 ui32N
 		psBufObj->eAccess			  = GL_WRITE_ONLY_OES;
 
 		psBufObj->psMemInfo	= IMG_NULL;
+		psBufObj->psOptimisedIndexMemInfo = IMG_NULL;
 	}
 
 	return psBufObj;
@@ -123,22 +124,6 @@ IMG_INTERNAL IMG_VOID ReclaimBufferObjectMemKRM(IMG_VOID *pvContext, KRMResource
 }	
 
 
-/***********************************************************************************
- Function Name      : DestroyBufferObjectGhostKRM
- Inputs             : pvContext, psResource
- Outputs            : -
- Returns            : -
- Description        : 
-************************************************************************************/
-IMG_INTERNAL IMG_VOID DestroyBufferObjectGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
-{
-	PVR_UNREFERENCED_PARAMETER(pvContext);
-	PVR_UNREFERENCED_PARAMETER(psResource);
-
-	PVR_DPF((PVR_DBG_WARNING, "DestroyBufferObjectGhostKRM: Called"));
-}	
-
-
 /***********************************************************************************
  Function Name      : WaitUntilBufObjNotUsed
  Inputs             : gc, psBufObj
@@ -146,7 +131,7 @@ IMG_INTERNAL IMG_VOID DestroyBufferObjectGhostKRM(IMG_VOID *pvContext, KRMResour
  Returns            : Success/Failure
  Description        : Waits until a buffer object is no longer needed by the TA
 ************************************************************************************/
-static IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj)
+IMG_INTERNAL IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj)
 {
 	/*
 	** 1 - never used - RETURN TRUE
@@ -238,6 +223,97 @@ static IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBu
 }
 
 
+/***********************************************************************************
+ Function Name      : FreeOptimisedIndices
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : -
+ Description        : Frees the vertex cache optimised copy of an index buffer. The
+					  caller must ensure the buffer object is no longer used by the TA.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID FreeOptimisedIndices(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	if(psBufObj->psOptimisedIndexMemInfo)
+	{
+#if defined(DEBUG) || defined(TIMING)
+		gc->ui32VBOMemCurrent -= psBufObj->psOptimisedIndexMemInfo->uAllocSize;
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+		GLES2FREEDEVICEMEM_HEAP(gc, psBufObj->psOptimisedIndexMemInfo);
+
+		psBufObj->psOptimisedIndexMemInfo = IMG_NULL;
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : OptimiseStaticIndices
+ Inputs             : gc, psBufObj, pui16Indices, ui32Size
+ Outputs            : -
+ Returns            : -
+ Description        : Builds a vertex cache optimised copy of a static element buffer,
+					  treating its contents as a 16-bit triangle list. Failure is not
+					  an error; draws simply keep using the application's ordering.
+************************************************************************************/
+static IMG_VOID OptimiseStaticIndices(GLES2Context *gc, GLES2BufferObject *psBufObj,
+									  const IMG_UINT16 *pui16Indices, IMG_UINT32 ui32Size)
+{
+	PVRSRV_ERROR eError;
+
+	GLES_ASSERT(!psBufObj->psOptimisedIndexMemInfo);
+
+	eError = GLES2ALLOCDEVICEMEM_HEAP(gc,
+		PVRSRV_MEM_READ | PVRSRV_MAP_GC_MMU,
+		psBufObj->psMemInfo->uAllocSize,
+		psBufObj->ui32AllocAlign,
+		&psBufObj->psOptimisedIndexMemInfo);
+
+	if(eError != PVRSRV_OK)
+	{
+		psBufObj->psOptimisedIndexMemInfo = IMG_NULL;
+
+		return;
+	}
+
+#if defined(DEBUG) || defined(TIMING)
+	gc->ui32VBOMemCurrent += psBufObj->psOptimisedIndexMemInfo->uAllocSize;
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+	if(!ReorderIndicesForVertexCache(gc, pui16Indices, (IMG_UINT16 *)psBufObj->psOptimisedIndexMemInfo->pvLinAddr,
+									 ui32Size / sizeof(IMG_UINT16)))
+	{
+		PVR_DPF((PVR_DBG_WARNING, "OptimiseStaticIndices: Out of memory, using unoptimised indices"));
+
+		FreeOptimisedIndices(gc, psBufObj);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetIndexBufferMemInfo
+ Inputs             : psBufObj, eMode, eType, ui32Offset, ui32NumIndices
+ Outputs            : -
+ Returns            : Meminfo to fetch indices from
+ Description        : Returns the vertex cache optimised copy of an element buffer
+					  if the draw consumes the whole buffer as one 16-bit triangle
+					  list, otherwise the buffer's own memory.
+************************************************************************************/
+IMG_INTERNAL PVRSRV_CLIENT_MEM_INFO *GetIndexBufferMemInfo(GLES2BufferObject *psBufObj, GLenum eMode, GLenum eType,
+															IMG_UINT32 ui32Offset, IMG_UINT32 ui32NumIndices)
+{
+	if(psBufObj->psOptimisedIndexMemInfo &&
+	   (eMode == GL_TRIANGLES) &&
+	   (eType == GL_UNSIGNED_SHORT) &&
+	   (ui32Offset == 0) &&
+	   (ui32NumIndices * sizeof(IMG_UINT16) == psBufObj->ui32BufferSize))
+	{
+		return psBufObj->psOptimisedIndexMemInfo;
+	}
+
+	return psBufObj->psMemInfo;
+}
+
+
 /***********************************************************************************
  Function Name      : FreeBufferObject
  Inputs             : gc, psBufObj
@@ -254,6 +330,34 @@ static IMG_VOID FreeBufferObject(GLES2Context *gc, GLES2BufferObject *psBufObj,
 	   if a draw call refers to any deleted bufobj, 
 	   then the result is undefined, mostly crashed. And this is expected */
 
+#if defined(DEBUG) || defined(TIMING)
+	if(psBufObj->ui32NumRenames || psBufObj->ui32NumStalls)
+	{
+		PVR_DPF((PVR_DBG_MESSAGE,"FreeBufferObject: Buffer %u was renamed %u times and stalled %u times",
+				 psBufObj->sNamedItem.ui32Name, psBufObj->ui32NumRenames, psBufObj->ui32NumStalls));
+	}
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+	/* Ghosts still in flight free their own memory when they retire */
+	if(psBufObj->psGhosts)
+	{
+		GLES2BufferObjectGhost *psGhost;
+
+		PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+		for(psGhost = psBufObj->psGhosts; psGhost; psGhost = psGhost->psNextOwned)
+		{
+			psGhost->psOwner = IMG_NULL;
+		}
+
+		psBufObj->psGhosts = IMG_NULL;
+		psBufObj->ui32NumGhosts = 0;
+
+		PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+	}
+
+	FreeBufObjSpareMemory(gc, psBufObj);
+
 	/* Free its device memory */
 	if (psBufObj->psMemInfo)
 	{
@@ -262,6 +366,12 @@ static IMG_VOID FreeBufferObject(GLES2Context *gc, GLES2BufferObject *psBufObj,
 			PVR_DPF((PVR_DBG_ERROR,"FreeBufferObject: Problem freeing buffer object"));
 		}
 
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		DiscardPackBufferReadbacks(gc, psBufObj);
+#endif
+
+		FreeOptimisedIndices(gc, psBufObj);
+
 		GLES2FREEDEVICEMEM_HEAP(gc, psBufObj->psMemInfo);
 
 #if defined(DEBUG) || defined(TIMING)
@@ -341,6 +451,14 @@ GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -414,6 +532,9 @@ GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
 	switch(ui32TargetIndex)
 	{
 	    case ARRAY_BUFFER_INDEX:
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	    case PIXEL_PACK_BUFFER_INDEX:
+#endif
 		{
 			/* Decrease RefCount by 1 when unbinding the previously bufobj from the context. */
 			psBoundBuffer = gc->sBufferObject.psActiveBuffer[ui32TargetIndex];
@@ -459,6 +580,14 @@ GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
 				break;
 			}
 		}
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		/* Vertex fetch reads the memory directly, so land any readbacks now */
+		if((target != GL_PIXEL_PACK_BUFFER_IMG) && !ResolvePackBufferReadbacks(gc, psBufObj))
+		{
+			PVR_DPF((PVR_DBG_ERROR,"glBindBuffer: Couldn't resolve pixel pack readbacks"));
+		}
+#endif
 	}
 	else
 	{
@@ -566,9 +695,9 @@ GL_APICALL void GL_APIENTRY glDeleteBuffers(GLsizei n, const GLuint *buffers)
 				/* Is the buffer object currently bound to the context? Unbind it */
 				if (psBufObj && psBufObj->sNamedItem.ui32Name == buffers[i]) 
 				{
-					/* Only decrease VBO's refCount by 1, 
-					since only VBO can be bound to the context, while IBO can only be bound to VAO */
-					if (j == ARRAY_BUFFER_INDEX)
+					/* Only decrease VBO's (and pixel pack buffer's) refCount by 1, 
+					since only they can be bound to the context, while IBO can only be bound to VAO */
+					if (j != ELEMENT_ARRAY_BUFFER_INDEX)
 					{
 						NamedItemDelRef(gc, psNamesArray, (GLES2NamedItem*)gc->sBufferObject.psActiveBuffer[j]);
 					}
@@ -653,6 +782,14 @@ GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const v
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -701,7 +838,7 @@ GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const v
 		return;
 	}
 
-	if(target == GL_ARRAY_BUFFER)
+	if(target != GL_ELEMENT_ARRAY_BUFFER)
 	{
 		/* Align vertices to the cache line size + overallocate by a Dword, in case PDS fetches vertex
 		 * data at the end of the allocation and pulls in an extra cache line.
@@ -719,10 +856,46 @@ GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const v
 	/* if it already holds some data, free it first (unless it is the same size as the new request) */
 	if (psBufObj->psMemInfo)
 	{
-		if(WaitUntilBufObjNotUsed(gc, psBufObj))
+		IMG_BOOL bReuseMemory = ((psBufObj->psMemInfo->uAllocSize == uAllocSize) &&
+								 (psBufObj->ui32AllocAlign == ui32AllocAlign)) ? IMG_TRUE : IMG_FALSE;
+		IMG_BOOL bWritable;
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		/* The old contents are being replaced, so pending readbacks are dropped */
+		DiscardPackBufferReadbacks(gc, psBufObj);
+#endif
+
+		if(bReuseMemory)
+		{
+			/* The whole buffer is respecified, so a renamed copy needn't keep the old contents */
+			bWritable = MakeBufObjWritable(gc, psBufObj, IMG_FALSE);
+		}
+		else
+		{
+			FreeBufObjSpareMemory(gc, psBufObj);
+
+			/* Orphan the old memory to the TA rather than waiting to free it */
+			if(KRM_IsResourceNeeded(&gc->psSharedState->sBufferObjectKRM, &psBufObj->sResource) &&
+			   GhostBufObjMemory(gc, psBufObj, IMG_NULL))
+			{
+#if defined(DEBUG) || defined(TIMING)
+				psBufObj->ui32NumRenames++;
+#endif
+				GLES2_INC_COUNT(GLES2_TIMER_BUFOBJ_RENAME_COUNT, 1);
+
+				bWritable = IMG_TRUE;
+			}
+			else
+			{
+				bWritable = WaitUntilBufObjNotUsed(gc, psBufObj);
+			}
+		}
+
+		if(bWritable)
 		{
-			if((psBufObj->psMemInfo->uAllocSize != uAllocSize) ||
-			   (psBufObj->ui32AllocAlign != ui32AllocAlign))
+			FreeOptimisedIndices(gc, psBufObj);
+
+			if(psBufObj->psMemInfo && !bReuseMemory)
 			{
 #if defined(DEBUG) || defined(TIMING)
 				gc->ui32VBOMemCurrent -= psBufObj->psMemInfo->uAllocSize;
@@ -783,6 +956,9 @@ GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const v
 			}
 
 			psBufObj->ui32AllocAlign = ui32AllocAlign;
+
+			/* VAOs other than this one may stream from the buffer too */
+			MarkBufObjMemoryMoved(gc);
 		}
 
 		/* Setup dirty states for the attribute */
@@ -812,6 +988,15 @@ GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const v
 		GLES2MemCopy(psBufObj->psMemInfo->pvLinAddr, (const IMG_VOID *)data, (IMG_UINT32)size);
 	}
 
+	/* Reorder static triangle lists for the vertex cache if the app opted in */
+	if(gc->sAppHints.bOptimiseStaticIndexBuffers &&
+	   (target == GL_ELEMENT_ARRAY_BUFFER) &&
+	   (usage == GL_STATIC_DRAW) &&
+	   data && size && (((IMG_UINT32)size % (3 * sizeof(IMG_UINT16))) == 0))
+	{
+		OptimiseStaticIndices(gc, psBufObj, (const IMG_UINT16 *)data, (IMG_UINT32)size);
+	}
+
 	/* store the state */
 	psBufObj->ui32BufferSize = (IMG_UINT32)size;
 	psBufObj->eUsage = usage;
@@ -853,6 +1038,14 @@ GL_APICALL void GL_APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsi
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -905,10 +1098,28 @@ GL_APICALL void GL_APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsi
 
 	if (data)
 	{
-		if(WaitUntilBufObjNotUsed(gc, psBufObj))
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		/* Readbacks issued before this update must not overwrite it */
+		if(!ResolvePackBufferReadbacks(gc, psBufObj))
+		{
+			PVR_DPF((PVR_DBG_ERROR,"glBufferSubData: Couldn't resolve pixel pack readbacks"));
+
+			SetError(gc, GL_OUT_OF_MEMORY);
+
+			GLES2_TIME_STOP(GLES2_TIMES_glBufferSubData);
+
+			return;
+		}
+#endif
+
+		/* Only a partial update needs the rest of the contents carried over by a rename */
+		if(MakeBufObjWritable(gc, psBufObj, ((offset != 0) || ((IMG_UINT32)size != psBufObj->ui32BufferSize)) ? IMG_TRUE : IMG_FALSE))
 		{
 			IMG_VOID *pvDst;
 
+			/* Any reordered copy no longer matches the contents */
+			FreeOptimisedIndices(gc, psBufObj);
+
 			pvDst = (IMG_VOID *)((IMG_UINT8 *)psBufObj->psMemInfo->pvLinAddr + offset);
 
 			GLES2MemCopy(pvDst, (const IMG_VOID *)data, (IMG_UINT32)size);
@@ -962,6 +1173,14 @@ GL_API_EXT void * GL_APIENTRY glMapBufferOES(GLenum target, GLenum access)
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -1001,7 +1220,8 @@ GL_API_EXT void * GL_APIENTRY glMapBufferOES(GLenum target, GLenum access)
 
 	if(psBufObj->psMemInfo->pvLinAddr)
 	{
-		if(!WaitUntilBufObjNotUsed(gc, psBufObj))
+		/* The mapping is write-only, but the app may update only part of it */
+		if(!MakeBufObjWritable(gc, psBufObj, IMG_TRUE))
 		{
 			PVR_DPF((PVR_DBG_ERROR,"glMapBuffer: Buffer didn't become free"));
 
@@ -1015,6 +1235,19 @@ SetOutOfMemErrorAndReturnNULL:
 			return IMG_NULL;
 		}
 
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		/* Wait for the readback blits and convert their pixels into the buffer */
+		if(!ResolvePackBufferReadbacks(gc, psBufObj))
+		{
+			PVR_DPF((PVR_DBG_ERROR,"glMapBuffer: Couldn't resolve pixel pack readbacks"));
+
+			goto SetOutOfMemErrorAndReturnNULL;
+		}
+#endif
+
+		/* The app may rewrite the contents through the mapping */
+		FreeOptimisedIndices(gc, psBufObj);
+
 		psBufObj->eAccess = access;
 		psBufObj->bMapped = IMG_TRUE;
 
@@ -1057,6 +1290,14 @@ GL_API_EXT GLboolean GL_APIENTRY glUnmapBufferOES(GLenum target)
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -33,17 +33,52 @@
 /* num of buffer object bindings */
 #define ARRAY_BUFFER_INDEX			0
 #define ELEMENT_ARRAY_BUFFER_INDEX	1
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+#define PIXEL_PACK_BUFFER_INDEX		2
+#define GLES2_NUM_BUFOBJ_BINDINGS	3
+#else
 #define GLES2_NUM_BUFOBJ_BINDINGS	2
+#endif
 
 #define INDEX_BUFFER_OBJECT(gc)	(gc->sBufferObject.psActiveBuffer[ELEMENT_ARRAY_BUFFER_INDEX]!=IMG_NULL)
 
 #define ARRAY_BUFFER_OBJECT(gc)	(gc->sBufferObject.psActiveBuffer[ARRAY_BUFFER_INDEX]!=IMG_NULL)
 
 
+/* Post-transform vertex cache size targeted when reordering static index buffers */
+#define GLES2_INDEX_OPTIMISER_CACHE_SIZE	16
+
+
+/* Retired allocations a buffer object may have in flight before an update waits for the TA instead */
+#define GLES2_BUFOBJ_MAX_RENAMES			3
+
+/* Largest buffer whose contents are copied to a new allocation, rather than waited for, on a partial update */
+#define GLES2_BUFOBJ_MAX_RENAME_COPY		(256 * 1024)
+
+
 /* type casting for using pointers as offsets */
 #define GLES2_BUFFER_OFFSET(pointer) ((GLintptr)pointer)
 
 
+/*
+ * Device memory a buffer object was renamed away from while the TA still used it
+ */
+typedef struct GLES2BufferObjectGhostRec
+{
+	/* Ghosts are TA-kick resources */
+	KRMResource sResource;
+
+	PVRSRV_CLIENT_MEM_INFO *psMemInfo;
+	PVRSRV_CLIENT_MEM_INFO *psOptimisedIndexMemInfo;
+
+	/* Buffer to return the memory to once retired, or NULL if it has been deleted.
+	   Protected by the shared state's primary lock */
+	struct GLES2BufferObjectRec *psOwner;
+	struct GLES2BufferObjectGhostRec *psNextOwned;
+
+} GLES2BufferObjectGhost;
+
+
 typedef struct GLES2BufferObjectRec
 {
  	/* This struct must be the first variable */
@@ -63,12 +98,33 @@ typedef struct GLES2BufferObjectRec
 	/* Meminfo for any uploaded version of the buffer */
 	PVRSRV_CLIENT_MEM_INFO *psMemInfo;
 
+	/* Vertex cache optimised copy of a static 16-bit triangle list, if one was built */
+	PVRSRV_CLIENT_MEM_INFO *psOptimisedIndexMemInfo;
+
 	/* Buffer objects are TA-kick resources */
 	KRMResource sResource;
 
 	/* Is the buffer mapped */
 	IMG_BOOL bMapped;
 
+	/* Ring of allocations for renaming: ghosts still needed by the TA, and retired
+	   allocations ready for reuse. Protected by the shared state's primary lock */
+	GLES2BufferObjectGhost *psGhosts;
+	IMG_UINT32 ui32NumGhosts;
+	PVRSRV_CLIENT_MEM_INFO *apsSpareMemInfo[GLES2_BUFOBJ_MAX_RENAMES];
+	IMG_UINT32 ui32NumSpareMemInfos;
+
+#if defined(DEBUG) || defined(TIMING)
+	/* Updates made without waiting by renaming, and updates that waited for the TA */
+	IMG_UINT32 ui32NumRenames;
+	IMG_UINT32 ui32NumStalls;
+#endif
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	/* glReadPixels blits still to be converted into the buffer, oldest first */
+	struct GLES2PackReadbackRec *psPackReadbacks;
+#endif
+
 #if defined(PDUMP)
 	/* Has this object been pdumped since it was last changed. */
 	IMG_BOOL bDumped;
@@ -91,4 +147,18 @@ IMG_VOID SetupBufObjNameArray(GLES2NamesArray *psNamesArray);
 IMG_VOID ReclaimBufferObjectMemKRM(IMG_VOID *pvContext, KRMResource *psResource);
 IMG_VOID DestroyBufferObjectGhostKRM(IMG_VOID *pvContext, KRMResource *psResource);
 
+IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj);
+
+IMG_VOID FreeOptimisedIndices(GLES2Context *gc, GLES2BufferObject *psBufObj);
+IMG_BOOL MakeBufObjWritable(GLES2Context *gc, GLES2BufferObject *psBufObj, IMG_BOOL bPreserveContents);
+IMG_BOOL GhostBufObjMemory(GLES2Context *gc, GLES2BufferObject *psBufObj, PVRSRV_CLIENT_MEM_INFO *psNewMemInfo);
+IMG_VOID FreeBufObjSpareMemory(GLES2Context *gc, GLES2BufferObject *psBufObj);
+IMG_VOID MarkBufObjMemoryMoved(GLES2Context *gc);
+
+IMG_BOOL ReorderIndicesForVertexCache(GLES2Context *gc, const IMG_UINT16 *pui16Src,
+									 IMG_UINT16 *pui16Dst, IMG_UINT32 ui32NumIndices);
+
+PVRSRV_CLIENT_MEM_INFO *GetIndexBufferMemInfo(GLES2BufferObject *psBufObj, GLenum eMode, GLenum eType,
+											   IMG_UINT32 ui32Offset, IMG_UINT32 ui32NumIndices);
+
 #endif /* _BUFOBJ_ */
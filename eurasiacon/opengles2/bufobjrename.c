@@ -0,0 +1,313 @@
+/******************************************************************************
+ * Name         : bufobjrename.c
+ *
+ * Copyright    : 2005-2006 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Renaming of buffer objects the TA still needs onto spare
+ *                device memory, and retirement of the ghosts left behind
+ *
+ * Platform     : ANSI
+ *
+ * $Log: bufobjrename.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+/***********************************************************************************
+ Function Name      : DestroyBufferObjectGhostKRM
+ Inputs             : pvContext, psResource
+ Outputs            : -
+ Returns            : -
+ Description        : Retires a buffer object ghost once the TA no longer needs it.
+					  Its memory goes back to the owning buffer's spare ring if
+					  there is room, otherwise it is freed.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyBufferObjectGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	/* Note the tricky pointer arithmetic. It is necessary */
+	GLES2BufferObjectGhost *psGhost = (GLES2BufferObjectGhost*)((IMG_UINTPTR_T)psResource -offsetof(GLES2BufferObjectGhost, sResource));
+	GLES2Context *gc = (GLES2Context *)pvContext;
+	PVRSRV_CLIENT_MEM_INFO *psMemInfo = psGhost->psMemInfo;
+	GLES2BufferObject *psOwner;
+	GLES2BufferObjectGhost **ppsGhost;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	psOwner = psGhost->psOwner;
+
+	if(psOwner)
+	{
+		for(ppsGhost = &psOwner->psGhosts; *ppsGhost; ppsGhost = &(*ppsGhost)->psNextOwned)
+		{
+			if(*ppsGhost == psGhost)
+			{
+				*ppsGhost = psGhost->psNextOwned;
+
+				break;
+			}
+		}
+
+		psOwner->ui32NumGhosts--;
+
+		/* The owner checks the size when it takes a spare */
+		if(psOwner->ui32NumSpareMemInfos < GLES2_BUFOBJ_MAX_RENAMES)
+		{
+			psOwner->apsSpareMemInfo[psOwner->ui32NumSpareMemInfos++] = psMemInfo;
+
+			psMemInfo = IMG_NULL;
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(psMemInfo)
+	{
+		GLES2FREEDEVICEMEM_HEAP(gc, psMemInfo);
+	}
+
+	if(psGhost->psOptimisedIndexMemInfo)
+	{
+		GLES2FREEDEVICEMEM_HEAP(gc, psGhost->psOptimisedIndexMemInfo);
+	}
+
+	GLES2Free(IMG_NULL, psGhost);
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeBufObjSpareMemory
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : -
+ Description        : Frees the retired allocations a buffer object keeps for renaming
+************************************************************************************/
+IMG_INTERNAL IMG_VOID FreeBufObjSpareMemory(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	PVRSRV_CLIENT_MEM_INFO *apsSpareMemInfo[GLES2_BUFOBJ_MAX_RENAMES];
+	IMG_UINT32 i, ui32NumSpareMemInfos;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	ui32NumSpareMemInfos = psBufObj->ui32NumSpareMemInfos;
+
+	for(i = 0; i < ui32NumSpareMemInfos; i++)
+	{
+		apsSpareMemInfo[i] = psBufObj->apsSpareMemInfo[i];
+	}
+
+	psBufObj->ui32NumSpareMemInfos = 0;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	for(i = 0; i < ui32NumSpareMemInfos; i++)
+	{
+		GLES2FREEDEVICEMEM_HEAP(gc, apsSpareMemInfo[i]);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : MarkBufObjMemoryMoved
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Called whenever a buffer object moves to different device
+					  memory. Vertex stream addresses are baked into each VAO's PDS
+					  program, and draws in every context sharing the buffer test
+					  the stamp (VAO_IS_DIRTY) before skipping validation, so they
+					  repatch before the old memory is freed or retired.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID MarkBufObjMemoryMoved(GLES2Context *gc)
+{
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	gc->psSharedState->ui32BufObjRenameStamp++;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	/* This context's next draw must validate even if nothing else changed */
+	gc->ui32DirtyState |= GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER;
+}
+
+
+/***********************************************************************************
+ Function Name      : GhostBufObjMemory
+ Inputs             : gc, psBufObj, psNewMemInfo
+ Outputs            : -
+ Returns            : Success
+ Description        : Moves a buffer object's device memory into a ghost, which keeps
+					  it alive until the TA kicks that use it complete, and replaces
+					  it with psNewMemInfo (which may be NULL). Fails if the buffer
+					  already has its maximum number of ghosts.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL GhostBufObjMemory(GLES2Context *gc, GLES2BufferObject *psBufObj, PVRSRV_CLIENT_MEM_INFO *psNewMemInfo)
+{
+	GLES2BufferObjectGhost *psGhost;
+
+	if(psBufObj->ui32NumGhosts >= GLES2_BUFOBJ_MAX_RENAMES)
+	{
+		return IMG_FALSE;
+	}
+
+	psGhost = (GLES2BufferObjectGhost *)GLES2Calloc(gc, sizeof(GLES2BufferObjectGhost));
+
+	if(!psGhost)
+	{
+		return IMG_FALSE;
+	}
+
+	psGhost->psMemInfo				 = psBufObj->psMemInfo;
+	psGhost->psOptimisedIndexMemInfo = psBufObj->psOptimisedIndexMemInfo;
+	psGhost->psOwner				 = psBufObj;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	psGhost->psNextOwned = psBufObj->psGhosts;
+	psBufObj->psGhosts = psGhost;
+	psBufObj->ui32NumGhosts++;
+
+	psBufObj->psMemInfo = psNewMemInfo;
+	psBufObj->psOptimisedIndexMemInfo = IMG_NULL;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	KRM_GhostResource(&gc->psSharedState->sBufferObjectKRM, &psBufObj->sResource, &psGhost->sResource);
+
+	MarkBufObjMemoryMoved(gc);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : RenameBufObjMemory
+ Inputs             : gc, psBufObj, bPreserveContents
+ Outputs            : -
+ Returns            : Success
+ Description        : Moves a buffer object that the TA still needs onto a spare or
+					  newly allocated block of the same size, so the CPU can write
+					  it straight away. The old contents are copied across if
+					  bPreserveContents is set.
+************************************************************************************/
+static IMG_BOOL RenameBufObjMemory(GLES2Context *gc, GLES2BufferObject *psBufObj, IMG_BOOL bPreserveContents)
+{
+	PVRSRV_CLIENT_MEM_INFO *psNewMemInfo = IMG_NULL;
+	IMG_UINT32 uAllocSize = psBufObj->psMemInfo->uAllocSize;
+	PVRSRV_ERROR eError;
+
+	if(bPreserveContents && (psBufObj->ui32BufferSize > GLES2_BUFOBJ_MAX_RENAME_COPY))
+	{
+		return IMG_FALSE;
+	}
+
+	/* Retire ghosts whose kicks have completed, so their memory can be reused */
+	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->sBufferObjectKRM);
+
+	if(psBufObj->ui32NumGhosts >= GLES2_BUFOBJ_MAX_RENAMES)
+	{
+		return IMG_FALSE;
+	}
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	while(psBufObj->ui32NumSpareMemInfos && !psNewMemInfo)
+	{
+		psNewMemInfo = psBufObj->apsSpareMemInfo[--psBufObj->ui32NumSpareMemInfos];
+
+		/* Spares left over from before the buffer was respecified are discarded */
+		if(psNewMemInfo->uAllocSize != uAllocSize)
+		{
+			PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+			GLES2FREEDEVICEMEM_HEAP(gc, psNewMemInfo);
+
+			psNewMemInfo = IMG_NULL;
+
+			PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(!psNewMemInfo)
+	{
+		eError = GLES2ALLOCDEVICEMEM_HEAP(gc,
+			PVRSRV_MEM_READ | PVRSRV_MAP_GC_MMU,		/* Read only (by device) */
+			uAllocSize,
+			psBufObj->ui32AllocAlign,
+			&psNewMemInfo);
+
+		if (eError != PVRSRV_OK)
+		{
+			eError = GLES2ALLOCDEVICEMEM_HEAP(gc,
+				PVRSRV_MEM_READ,							/* Read only (by device) */
+				uAllocSize,
+				psBufObj->ui32AllocAlign,
+				&psNewMemInfo);
+		}
+
+		if (eError != PVRSRV_OK)
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	if(bPreserveContents && psBufObj->ui32BufferSize)
+	{
+		/* The TA only reads buffer objects, so the old contents are stable */
+		GLES2MemCopy(psNewMemInfo->pvLinAddr, psBufObj->psMemInfo->pvLinAddr, psBufObj->ui32BufferSize);
+	}
+
+	if(!GhostBufObjMemory(gc, psBufObj, psNewMemInfo))
+	{
+		GLES2FREEDEVICEMEM_HEAP(gc, psNewMemInfo);
+
+		return IMG_FALSE;
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : MakeBufObjWritable
+ Inputs             : gc, psBufObj, bPreserveContents
+ Outputs            : -
+ Returns            : Success/Failure
+ Description        : Makes a buffer object's memory safe for the CPU to write. If the
+					  TA still needs it the buffer is renamed onto other memory, and
+					  only if that isn't possible does this wait for the TA.
+					  bPreserveContents is clear when the whole buffer is about to be
+					  overwritten.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL MakeBufObjWritable(GLES2Context *gc, GLES2BufferObject *psBufObj, IMG_BOOL bPreserveContents)
+{
+	if(KRM_IsResourceNeeded(&gc->psSharedState->sBufferObjectKRM, &psBufObj->sResource))
+	{
+		if(RenameBufObjMemory(gc, psBufObj, bPreserveContents))
+		{
+#if defined(DEBUG) || defined(TIMING)
+			psBufObj->ui32NumRenames++;
+#endif
+			GLES2_INC_COUNT(GLES2_TIMER_BUFOBJ_RENAME_COUNT, 1);
+
+			return IMG_TRUE;
+		}
+
+#if defined(DEBUG) || defined(TIMING)
+		psBufObj->ui32NumStalls++;
+#endif
+	}
+
+	return WaitUntilBufObjNotUsed(gc, psBufObj);
+}
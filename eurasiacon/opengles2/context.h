@@ -58,6 +58,8 @@
 #include "pds.h"
 #include "texyuv.h"
 #include "texstream.h"
+#include "texstaging.h"
+#include "drawdefer.h"
 #include "texture.h"
 #include "state.h"
 #include "glsl2uf.h"
@@ -65,6 +67,7 @@
 #include "codeheap.h"
 #include "statehash.h"
 #include "esbinshader.h"
+#include "digest.h"
 #include "shader.h"
 #include "usegles2.h"
 #include "validate.h"
@@ -79,6 +82,7 @@
 #include "usecodegen.h"
 #include "usegen.h"
 #include "vertexarrobj.h"
+#include "pixelpack.h"
 
 
 
@@ -118,6 +122,14 @@ typedef struct GLES2ContextSharedStateTAG
 	/* Keeps track of which buffer objects are attached to any given context */
 	KRMKickResourceManager sBufferObjectKRM;
 
+	/* Bumped whenever a buffer object moves to new device memory, so VAOs repatch their stream addresses */
+	IMG_UINT32 ui32BufObjRenameStamp;
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	/* Bumped whenever a glReadPixels is queued into a buffer object, so VAOs resolve it before drawing */
+	IMG_UINT32 ui32PackReadbackStamp;
+#endif
+
 	/* Dictionaries of GL objects addressed by name. */
 	GLES2NamesArray      *apsNamesArray[GLES2_MAX_SHAREABLE_NAMETYPE]; 
 
@@ -125,6 +137,7 @@ typedef struct GLES2ContextSharedStateTAG
 	UCH_UseCodeHeap     *psUSEVertexCodeHeap;
 	UCH_UseCodeHeap     *psUSEFragmentCodeHeap;
 	UCH_UseCodeHeap     *psPDSFragmentCodeHeap;
+	UCH_UseCodeHeap     *psPDSVertexCodeHeap;
 
 	/* Locks shared between all contexts.
 	 * The refcount, memory heaps and name arrays use the primary lock while the
@@ -142,6 +155,29 @@ typedef struct GLES2ContextSharedStateTAG
 	GLES2SurfaceFlushList *psFlushList;
 	PVRSRV_MUTEX_HANDLE hFlushListLock;
 
+	/* Serialises UniPatch finalisation of shared shaders (which modifies the input shader)
+	 * and all use of pvPrewarmUniPatchContext. Taken before hUniPatchLock when both are needed.
+	 */
+	PVRSRV_MUTEX_HANDLE hUniPatchFinaliseLock;
+
+	/* Protects the prewarmed variant caches, recorded keys and prewarm job lists.
+	 * Never held while taking any of the other shared locks.
+	 */
+	PVRSRV_MUTEX_HANDLE hUniPatchLock;
+
+	/* UniPatch context every prewarmed HW shader is finalised on. Owned by the share group
+	 * so it outlives the shaders, which can be freed by any context.
+	 */
+	IMG_VOID *pvPrewarmUniPatchContext;
+
+#if defined(SUPPORT_SOURCE_SHADER)
+	/* Compiled shader states by preprocessed tokens and compile parameters, so identical
+	 * shaders share one. The table holds no references; states leave it when freed.
+	 * Protected by the primary lock.
+	 */
+	HashTable sShaderInternTable;
+#endif
+
 #ifdef PDUMP
 	IMG_BOOL bMustDumpSequentialStaticIndices;
 	IMG_BOOL bMustDumpLineStripStaticIndices;
@@ -177,10 +213,18 @@ struct GLES2Context_TAG
   
 	GLES2PrimitiveMachine sPrim;
 
+	GLES2DeferredDraw sDeferredDraw;
+
     GLES2VertexArrayObjectMachine sVAOMachine;
 	/* Keeps track of which VAOs are attached to any given context */
 	KRMKickResourceManager sVAOKRM;
 
+	/* Keeps track of which cached PDS vertex programs are attached to any given context */
+	KRMKickResourceManager sPDSVertexVariantKRM;
+
+	/* Keeps track of which cached MTE state blocks are attached to any given context */
+	KRMKickResourceManager sMTEStateBlockKRM;
+
 #if defined(GLES2_EXTENSION_VERTEX_ARRAY_OBJECT)
 	/* Dictionaries of GL objects addressed by name. */
 	GLES2NamesArray *apsNamesArray[GLES2_MAX_UNSHAREABLE_NAMETYPE]; 
@@ -285,6 +329,7 @@ struct GLES2Context_TAG
 	IMG_UINT32 ui32AsyncTexOpNum;
 	IMG_BOOL bSwTexOpFin;
 	SceUID hSwTexOpThrd;
+	GLES2StagingPool sStagingPool;
 
 }; /* The typedef is in ogles2_types.h */
 
@@ -301,19 +346,27 @@ struct GLES2Context_TAG
 #define __GLES2_SET_CONTEXT(gc) \
 	OGLES2_SetTLSValue((IMG_VOID *)(gc));
 
+/* Every entrypoint except the draw calls emits any deferred draw first */
 #define __GLES2_GET_CONTEXT() \
 	GLES2Context *gc = (GLES2Context *)OGLES2_GetTLSValue(); \
-	if(!gc) return;
+	if(!gc) return; \
+	if(gc->sDeferredDraw.bPending) FlushDeferredDraw(gc);
 
 #define __GLES2_GET_CONTEXT_RETURN(RetVal) \
 	GLES2Context *gc = (GLES2Context *)OGLES2_GetTLSValue(); \
-	if(!gc) return RetVal;
+	if(!gc) return RetVal; \
+	if(gc->sDeferredDraw.bPending) FlushDeferredDraw(gc);
+
+#define __GLES2_GET_CONTEXT_FOR_DRAW() \
+	GLES2Context *gc = (GLES2Context *)OGLES2_GetTLSValue(); \
+	if(!gc) return;
 
 GLES2_MEMERROR SetupBGObject(GLES2Context *gc, IMG_BOOL bIsAccumulate, IMG_UINT32 *pui32PDSState);
 IMG_BOOL PrepareToDraw(GLES2Context *gc, IMG_UINT32 *pui32ClearFlags, IMG_BOOL bTakeLock);
 IMG_EGLERROR ScheduleTA(GLES2Context *gc, EGLRenderSurface *psRenderSurface, IMG_UINT32 ui32KickFlags);
 IMG_VOID KickLimit_ScheduleTA(IMG_VOID *pvContext, IMG_BOOL bLastInScene);
 IMG_VOID KickUnFlushed_ScheduleTA(IMG_VOID *pvContext, IMG_VOID *pvRenderSurface);
+IMG_VOID FlushDeferredDraw(GLES2Context *gc);
 
 IMG_VOID CalcRegionClip(GLES2Context *gc, EGLRect *psRegion, IMG_UINT32 *pui32RegionClip);
 GLES2_MEMERROR SendDrawMaskForClear(GLES2Context *gc);
@@ -321,6 +374,8 @@ GLES2_MEMERROR SendDrawMaskForPrimitive(GLES2Context *gc);
 GLES2_MEMERROR SendDrawMaskRect(GLES2Context *gc, EGLRect *psRect, IMG_BOOL bIsEnable);
 
 IMG_VOID WaitForTA(GLES2Context *gc);
+IMG_BOOL ResizeTABuffer(GLES2Context *gc, IMG_UINT32 ui32BufferType, IMG_UINT32 ui32SizeInBytes);
+IMG_VOID GrowStalledTABuffers(GLES2Context *gc);
 
 #if defined(EGL_EXTENSION_KHR_IMAGE)
 extern IMG_EGLERROR GLESGetImageSource(EGLContextHandle hContext, IMG_UINT32 ui32Source, IMG_UINT32 ui32Name, IMG_UINT32 ui32Level, EGLImage *psEGLImage);
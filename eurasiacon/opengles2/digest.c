@@ -34,3 +34,15 @@ void DigestTextToHashString(const IMG_CHAR *szString,
 
 	SHA256HashString(aucHash, szHashStr);
 }
+
+IMG_INTERNAL
+void DigestDataToHashString(const IMG_VOID *pvData,
+							IMG_UINT32 ui32Size,
+							IMG_CHAR szHashStr[DIGEST_STRING_LENGTH])
+{
+	IMG_BYTE aucHash[SHA256_DIGEST_LENGTH];
+
+	sceSha256Digest(pvData, ui32Size, aucHash);
+
+	SHA256HashString(aucHash, szHashStr);
+}
@@ -16,4 +16,8 @@
 void DigestTextToHashString(const IMG_CHAR *szString,
 							IMG_CHAR szHashStr[DIGEST_STRING_LENGTH]);
 
+void DigestDataToHashString(const IMG_VOID *pvData,
+							IMG_UINT32 ui32Size,
+							IMG_CHAR szHashStr[DIGEST_STRING_LENGTH]);
+
 #endif /* _DIGEST_H_ */
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Name         : drawdefer.c
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Merging of back-to-back compatible draws into one primitive
+ *                block
+ *
+ * Platform     : ANSI
+ *
+ * $Log: drawdefer.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+/***********************************************************************************
+ Function Name      : FlushDeferredDraw
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Sends the draw held back by DeferDraw to HW as one primitive
+					  block. Called before any entrypoint which is not itself a
+					  draw that can extend it.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID FlushDeferredDraw(GLES2Context *gc)
+{
+	GLES2DeferredDraw *psDeferredDraw = &gc->sDeferredDraw;
+
+	/* Cleared first, so nothing reached from the draw path flushes it again */
+	psDeferredDraw->bPending = IMG_FALSE;
+
+	if(psDeferredDraw->eType == 0)
+	{
+		DrawArrays(gc, psDeferredDraw->eMode, psDeferredDraw->ui32First, psDeferredDraw->ui32Count, psDeferredDraw->ui32Count);
+	}
+	else
+	{
+		IMG_UINT32 ui32IndexSize = (psDeferredDraw->eType == GL_UNSIGNED_INT) ? 4 : 2;
+
+		DrawElements(gc, psDeferredDraw->eMode, psDeferredDraw->ui32Count, psDeferredDraw->ui32Count, psDeferredDraw->eType,
+					 (const IMG_VOID *)((IMG_UINTPTR_T)(psDeferredDraw->ui32First * ui32IndexSize)));
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : DeferDraw
+ Inputs             : gc, eMode, eType, ui32First, ui32Count, ui32NumIndices
+ Outputs            : -
+ Returns            : Whether the draw was deferred
+ Description        : Appends a draw to the deferred one when it continues the same
+					  range with the same primitive type, otherwise flushes the
+					  deferred draw and holds this one back if it could be extended.
+					  Only list primitives sourced wholly from buffer objects are
+					  held, as client arrays may change without a GL call. eType
+					  is 0 for glDrawArrays, ui32First an index into the element
+					  buffer otherwise.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL DeferDraw(GLES2Context *gc, GLenum eMode, GLenum eType, IMG_UINT32 ui32First, IMG_UINT32 ui32Count,
+								IMG_UINT32 ui32NumIndices)
+{
+	GLES2DeferredDraw *psDeferredDraw = &gc->sDeferredDraw;
+
+	if(psDeferredDraw->bPending)
+	{
+		/* No GL call since the deferred draw, so program, state and buffers all still match */
+		if((psDeferredDraw->eMode == eMode) && (psDeferredDraw->eType == eType) &&
+		   (psDeferredDraw->ui32First + psDeferredDraw->ui32Count == ui32First) &&
+		   (ui32NumIndices == ui32Count))
+		{
+			psDeferredDraw->ui32Count += ui32Count;
+
+			return IMG_TRUE;
+		}
+
+		FlushDeferredDraw(gc);
+	}
+
+	switch(eMode)
+	{
+		case GL_POINTS:
+		case GL_LINES:
+		case GL_TRIANGLES:
+		{
+			break;
+		}
+		default:
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	/* A partial primitive at the end would join up with the next draw's vertices */
+	if(ui32NumIndices != ui32Count)
+	{
+		return IMG_FALSE;
+	}
+
+	/* Only once validated is the control word known to be current */
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
+	{
+		return IMG_FALSE;
+	}
+
+	if(gc->sVAOMachine.ui32ControlWord & (ATTRIBARRAY_SOURCE_VARRAY | ATTRIBARRAY_BAD_BUFOBJ | ATTRIBARRAY_MAP_BUFOBJ))
+	{
+		return IMG_FALSE;
+	}
+
+	psDeferredDraw->bPending	= IMG_TRUE;
+	psDeferredDraw->eMode		= eMode;
+	psDeferredDraw->eType		= eType;
+	psDeferredDraw->ui32First	= ui32First;
+	psDeferredDraw->ui32Count	= ui32Count;
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ End of file (drawdefer.c)
+******************************************************************************/
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Name         : drawdefer.h
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * $Log: drawdefer.h $
+ *****************************************************************************/
+
+#ifndef _DRAWDEFER_
+#define _DRAWDEFER_
+
+/*
+ * A list-primitive draw held back so that an immediately following compatible
+ * draw can extend it. Any other GL entrypoint flushes it first, so the state
+ * it is emitted with is the state it was issued under.
+ */
+typedef struct GLES2DeferredDrawTAG
+{
+	IMG_BOOL bPending;
+
+	GLenum eMode;
+
+	/* 0 for glDrawArrays, otherwise the index type */
+	GLenum eType;
+
+	/* First vertex, or first index in the bound element buffer */
+	IMG_UINT32 ui32First;
+	IMG_UINT32 ui32Count;
+
+} GLES2DeferredDraw;
+
+
+IMG_BOOL DeferDraw(GLES2Context *gc, GLenum eMode, GLenum eType, IMG_UINT32 ui32First, IMG_UINT32 ui32Count,
+				   IMG_UINT32 ui32NumIndices);
+
+/* drawvarray.c: the draw paths a deferred draw is emitted through */
+IMG_VOID DrawArrays(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32First, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices);
+
+IMG_VOID DrawElements(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices,
+					  GLenum eType, const IMG_VOID *indices);
+
+#endif /* _DRAWDEFER_ */
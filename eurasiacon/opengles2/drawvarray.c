@@ -729,6 +729,7 @@ static IMG_VOID CopyVArrayData(GLES2Context *gc, IMG_UINT32 ui32First,
 	CBUF_UpdateBufferPos(gc->apsBuffers, ui32DWordsWritten, CBUF_TYPE_VERTEX_DATA_BUFFER);
 
 	GLES2_INC_COUNT(GLES2_TIMER_VERTEX_DATA_COUNT, ui32DWordsWritten);
+	GLES2_INC_COUNT(GLES2_TIMER_VERTEX_DATA_VERTEX_COUNT, ui32Count);
 }
 
 
@@ -779,51 +780,55 @@ static IMG_VOID CopyVArrayDataDeindex(GLES2Context *gc, IMG_UINT32 ui32First,
 		}
 		else
 		{
-			IMG_UINT8 *pui8DstPointer;
-			IMG_UINT8 *pui8SrcPointer, *pui8SrcBasePointer;
-			IMG_UINT32 j;
+			IMG_UINT8 *pui8SrcBasePointer;
+			const IMG_VOID *pvFirstElement;
 
 			/* pui8SrcBasePointer points to the base of the vertex data */
 			pui8SrcBasePointer = psAPMachine->pui8SrcPointer - ui32First * psAPMachine->ui32Stride;
-			pui8DstPointer =  psAPMachine->pui8DstPointer;
 
-			/* The two branches only differ in the type of the elements: 16-bit or 32-bit unsigned ints */
 			if(bAreElements32Bit)
 			{
-				const IMG_UINT32 *pui32Elements = (const IMG_UINT32*)pvElements;
+				pvFirstElement = (const IMG_VOID *)((const IMG_UINT32 *)pvElements + ui32First);
+			}
+			else
+			{
+				pvFirstElement = (const IMG_VOID *)((const IMG_UINT16 *)pvElements + ui32First);
+			}
 
-				for(j=0; j < ui32Count; j++)
-				{
-					pui8SrcPointer = pui8SrcBasePointer + pui32Elements[ui32First+j] * psAPMachine->ui32Stride;
+			GLES_ASSERT(psAPMachine->pfnGatherData);
 
 #if defined(NO_UNALIGNED_ACCESS)
-					alignment = (((IMG_UINT32) pui8SrcPointer) & 3) | (((IMG_UINT32) psAPMachine->ui32CopyStride) & 3);
-					psAPMachine->pfnCopyData[alignment](pui8SrcPointer, pui8DstPointer, psAPMachine->ui32CopyStride, 1);
-#else
-					psAPMachine->pfnCopyData(pui8SrcPointer, pui8DstPointer, psAPMachine->ui32CopyStride, 1);
-#endif
+			/* Every gathered source shares the alignment of the base and stride combined */
+			alignment = (((IMG_UINT32) pui8SrcBasePointer) & 3) | (((IMG_UINT32) psAPMachine->ui32Stride) & 3);
 
-					pui8DstPointer += psAPMachine->ui32DstSize;
-				}
-			}
-			else
+			if(alignment)
 			{
-				const IMG_UINT16 *pui16Elements = (const IMG_UINT16*)pvElements;
+				IMG_UINT8 *pui8DstPointer = psAPMachine->pui8DstPointer;
+				IMG_UINT8 *pui8SrcPointer;
+				IMG_UINT32 j;
 
 				for(j=0; j < ui32Count; j++)
 				{
-					pui8SrcPointer = pui8SrcBasePointer + pui16Elements[ui32First+j] * psAPMachine->ui32Stride;
+					if(bAreElements32Bit)
+					{
+						pui8SrcPointer = pui8SrcBasePointer + ((const IMG_UINT32 *)pvFirstElement)[j] * psAPMachine->ui32Stride;
+					}
+					else
+					{
+						pui8SrcPointer = pui8SrcBasePointer + ((const IMG_UINT16 *)pvFirstElement)[j] * psAPMachine->ui32Stride;
+					}
 
-#if defined(NO_UNALIGNED_ACCESS)
-					alignment = (((IMG_UINT32) pui8SrcPointer) & 3) | (((IMG_UINT32) psAPMachine->ui32CopyStride) & 3);
 					psAPMachine->pfnCopyData[alignment](pui8SrcPointer, pui8DstPointer, psAPMachine->ui32CopyStride, 1);
-#else
-					psAPMachine->pfnCopyData(pui8SrcPointer, pui8DstPointer, psAPMachine->ui32CopyStride, 1);
-#endif
 
 					pui8DstPointer += psAPMachine->ui32DstSize;
 				}
 			}
+			else
+#endif
+			{
+				psAPMachine->pfnGatherData(pui8SrcBasePointer, psAPMachine->pui8DstPointer, psAPMachine->ui32Stride,
+										   pvFirstElement, bAreElements32Bit, ui32Count);
+			}
 		}
 	}
 	
@@ -832,6 +837,7 @@ static IMG_VOID CopyVArrayDataDeindex(GLES2Context *gc, IMG_UINT32 ui32First,
 	CBUF_UpdateBufferPos(gc->apsBuffers, ui32DWordsWritten, CBUF_TYPE_VERTEX_DATA_BUFFER);
 
 	GLES2_INC_COUNT(GLES2_TIMER_VERTEX_DATA_COUNT, ui32DWordsWritten);
+	GLES2_INC_COUNT(GLES2_TIMER_VERTEX_DATA_VERTEX_COUNT, ui32Count);
 }
 
 
@@ -1342,10 +1348,10 @@ static IMG_VOID DrawElementsIndexBO(GLES2Context *gc, GLenum eMode, IMG_UINT32 u
 	PVR_UNREFERENCED_PARAMETER(ui32UnusedCount);
 
 
-	/* Setup psMemInfo using VAOMachine's bound element bufobj */
+	/* Setup psMemInfo using VAOMachine's bound element bufobj, preferring its vertex cache optimised copy */
 	GLES_ASSERT(psIndexBO);
 
-	psMemInfo = psIndexBO->psMemInfo;
+	psMemInfo = GetIndexBufferMemInfo(psIndexBO, eMode, eType, ui32Offset, ui32NumIndices);
 
 	GLES_ASSERT(psMemInfo);
 
@@ -1809,41 +1815,8 @@ static PFNDrawVArray PickDrawElementsProc(GLES2Context *gc, GLenum eMode, GLenum
 	{
 		if(gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->ui32BufferLimitInBytes < gc->sAppHints.ui32MaxVertexBufferSize)
 		{
-			CircularBuffer *psBuffer;
-			
-			if(ScheduleTA(gc, gc->psRenderSurface, GLES2_SCHEDULE_HW_WAIT_FOR_TA) != IMG_EGL_NO_ERROR)
-			{
-				PVR_DPF((PVR_DBG_ERROR,"PickDrawElementsProc: ScheduleTA did not work properly"));
-			}
-			
-			psBuffer = CBUF_CreateBuffer(gc->ps3DDevData, 
-										CBUF_TYPE_VERTEX_DATA_BUFFER, 
-										gc->psSysContext->hGeneralHeap, 
-										gc->psSysContext->hSyncInfoHeap, 
-										gc->psSysContext->sHWInfo.sMiscInfo.hOSGlobalEvent, 
-										MIN(gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->ui32BufferLimitInBytes * 2, gc->sAppHints.ui32MaxVertexBufferSize),
-										gc->psSysContext->hPerProcRef);
-
-			if(psBuffer)
-			{
-				PVR_DPF((PVR_DBG_WARNING,"PickDrawElementsProc: Resized dynamic vertex buffer. Was %u bytes, now %u bytes", 
-					gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->ui32BufferLimitInBytes, psBuffer->ui32BufferLimitInBytes));
-				
-				CBUF_DestroyBuffer(gc->ps3DDevData, gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]);
-
-				gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER] = psBuffer;	
-	
-				/* Point the TA Kick status update to the device memory reserved for status updates in the buffer */
-				gc->sKickTA.asTAStatusUpdate[CBUF_TYPE_VERTEX_DATA_BUFFER].hKernelMemInfo = gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->psStatusUpdateMemInfo->hKernelMemInfo;
-				gc->sKickTA.asTAStatusUpdate[CBUF_TYPE_VERTEX_DATA_BUFFER].sCtlStatus.sStatusDevAddr.uiAddr = gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->psStatusUpdateMemInfo->sDevVAddr.uiAddr;
-
-				/* set the read offset pointer in the buffer */
-				gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->pui32ReadOffset = (IMG_UINT32*)gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->psStatusUpdateMemInfo->pvLinAddr;
-			}
-			else
-			{
-				PVR_DPF((PVR_DBG_ERROR,"PickDrawElementsProc: Failed to create larger dynamic vertex buffer"));
-			}
+			ResizeTABuffer(gc, CBUF_TYPE_VERTEX_DATA_BUFFER, 
+						   MIN(gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER]->ui32BufferLimitInBytes * 2, gc->sAppHints.ui32MaxVertexBufferSize));
 		}
 
 		if(ui32VertexCount * gc->ui32VertexSize + gc->ui32VertexRCSize  + gc->ui32VertexAlignSize> MAX_VBUFFER)
@@ -2229,8 +2202,8 @@ static IMG_VOID AttachAllUsedResourcesToCurrentSurface(GLES2Context *gc)
  Inputs             : gc
  Outputs            : -
  Returns            : -
- Description        : Sets up status writebacks for all Buffer Objects 
-                      and the VAO used in current kick.
+ Description        : Sets up status writebacks for all Buffer Objects, 
+                      the VAO and the cached PDS vertex program used in current kick.
 ************************************************************************************/
 IMG_INTERNAL IMG_VOID AttachAllUsedBOsAndVAOToCurrentKick(GLES2Context *gc)
 {
@@ -2246,6 +2219,12 @@ IMG_INTERNAL IMG_VOID AttachAllUsedBOsAndVAOToCurrentKick(GLES2Context *gc)
 		KRM_Attach(&gc->sVAOKRM, gc, &gc->sKRMTAStatusUpdate, &psVAO->sResource);
 	}
 
+	/* Add in the cached PDS vertex program, if any */
+	if (gc->sPrim.psPDSVertexVariant)
+	{
+		KRM_Attach(&gc->sPDSVertexVariantKRM, gc, &gc->sKRMTAStatusUpdate, &gc->sPrim.psPDSVertexVariant->sResource);
+	}
+
 	/* Add in any vertex buffer objects */
 	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_SOURCE_BUFOBJ)
 	{
@@ -2329,6 +2308,243 @@ static IMG_VOID HandlePrimitiveTypeChange(GLES2Context *gc, GLenum mode)
 }	
 #endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
 
+/***********************************************************************************
+ Function Name      : DrawArrays
+ Inputs             : gc, eMode, ui32First, ui32Count, ui32NumIndices
+ Outputs            : -
+ Returns            : -
+ Description        : Draws primitives of type eMode using attrib arrays. Will
+					  validate as necessary, then send control, state and attrib
+					  data to HW. Arguments have already been checked.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DrawArrays(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32First, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices)
+{
+	PFNDrawVArray pfnDrawArrays;
+	IMG_UINT32 ui32NoClears = 0;
+	GLES2VertexArrayObjectMachine *psVAOMachine;
+
+	if(!PrepareToDraw(gc, &ui32NoClears, IMG_TRUE))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"DrawArrays: Can't prepare to draw"));
+
+		return;
+	}
+
+#if defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728)
+	HandlePrimitiveTypeChange(gc, eMode);
+#endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
+
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
+	{
+		if(ValidateState(gc)!=GLES2_NO_ERROR)
+		{
+			PVR_DPF((PVR_DBG_ERROR,"DrawArrays: ValidateState() failed"));
+
+			PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+
+			return;
+		}
+	}
+
+	/* Setup VAOMachine */
+	psVAOMachine = &(gc->sVAOMachine);
+
+
+	/* Check whether any buffer object has undefined memory.
+	   This could cause visual corruption or lockup, so return without drawing.
+	   An OUT_OF_MEMORY error will have been raised at the point of allocation failure.
+	 */
+	if (psVAOMachine->ui32ControlWord & ATTRIBARRAY_BAD_BUFOBJ)
+	{
+		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+
+		return;
+	}
+
+	/* Check whether any buffer object is mapped */
+	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_MAP_BUFOBJ)
+	{
+		SetError(gc, GL_INVALID_OPERATION);
+		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+
+		return;
+	}
+
+	/* Attach all used resources to the current surface */
+	AttachAllUsedResourcesToCurrentSurface(gc);
+
+	pfnDrawArrays = PickDrawArraysProc(gc, eMode, ui32Count);
+
+	GLES_ASSERT(pfnDrawArrays != IMG_NULL);
+
+	(*pfnDrawArrays)(gc, eMode, ui32First, ui32Count, ui32NumIndices, 0, IMG_NULL, ui32First, ui32Count);
+
+	/*
+		Update vertex and index buffers committed primitive offset
+	*/
+	CBUF_UpdateVIBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA, (IMG_VOID *)gc, KickLimit_ScheduleTA);
+
+	PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+}
+
+
+/***********************************************************************************
+ Function Name      : DrawElements
+ Inputs             : gc, eMode, ui32Count, ui32NumIndices, eType, indices
+ Outputs            : -
+ Returns            : -
+ Description        : Draws indexed primitives of type eMode using attrib arrays and
+					  an index list. Will validate as necessary, then send control,
+					  state and attrib data to HW. Arguments have already been checked.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DrawElements(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices,
+								   GLenum eType, const IMG_VOID *indices)
+{
+	IMG_UINT32 ui32MinIndex=0xFFFFFFFF, ui32MaxIndex=0;
+	IMG_UINT32 ui32VertexStart, ui32VertexCount;
+	PFNDrawVArray pfnDrawElements;
+	const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)indices;
+	IMG_BOOL bIndicesWerePromoted = IMG_FALSE;
+	IMG_UINT32 ui32NoClears = 0;
+	GLES2VertexArrayObjectMachine *psVAOMachine;
+
+	if(!PrepareToDraw(gc, &ui32NoClears, IMG_TRUE))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"DrawElements: Can't prepare to draw"));
+
+		return;
+	}
+
+#if defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728)
+	HandlePrimitiveTypeChange(gc, eMode);
+#endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
+
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
+	{
+		if(ValidateState(gc)!=GLES2_NO_ERROR)
+		{
+			PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+			PVR_DPF((PVR_DBG_ERROR,"DrawElements: ValidateState() failed"));
+
+			return;
+		}
+	}
+
+	/* Attach all used resources to the current surface */
+	AttachAllUsedResourcesToCurrentSurface(gc);
+
+
+	/* Setup VAOMachine */
+	psVAOMachine = &(gc->sVAOMachine);
+
+	/*  Check whether any buffer object has undefined memory.
+		This could cause visual corruption or lockup, so return without drawing.
+		An OUT_OF_MEMORY error will have been raised at the point of allocation failure.
+	*/
+	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_BAD_BUFOBJ)
+	{
+		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+
+		return;
+	}
+
+	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_MAP_BUFOBJ)
+	{
+		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+		SetError(gc, GL_INVALID_OPERATION);
+
+		return;
+	}
+
+	if (VAO_IS_ZERO(gc)) /* This setup is only for the DEFAULT VAO */
+	{
+		if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_SOURCE_VARRAY)
+		{
+			DetermineMinAndMaxIndices(gc, ui32Count, eType, indices, &ui32MinIndex, &ui32MaxIndex);
+
+			ui32VertexStart = ui32MinIndex;
+			ui32VertexCount = ui32MaxIndex - ui32MinIndex + 1;
+
+			if(INDEX_BUFFER_OBJECT(gc) && (GL_UNSIGNED_BYTE != eType))
+			{
+				ui32VertexCount += ui32VertexStart;
+				ui32VertexStart = 0;
+			}
+		}
+		else
+		{
+			/* Because all the vertex data comes from buffer objects (or is copied from current state), there is
+			 * no need to know the vertex range. */
+			ui32VertexStart = 0;
+			ui32VertexCount = 0;
+		}
+	}
+	else /* The following setup is for the NON-ZERO VAO, which does not contain client arrays */
+	{
+		/* Because all the vertex data comes from buffer objects (or is copied from current state), there is
+		 * no need to know the vertex range. */
+		ui32VertexStart = 0;
+		ui32VertexCount = 0;
+	}
+
+	/* Pick draw functions */
+	pfnDrawElements = PickDrawElementsProc(gc, eMode, eType, ui32Count, ui32VertexCount, ui32MaxIndex);
+
+	GLES_ASSERT(pfnDrawElements != IMG_NULL);
+
+	/* All 8-bit indices must be promoted to 16-bit */
+	if(GL_UNSIGNED_BYTE == eType)
+	{
+		pui16Elements = TransformIndicesTo16Bits(gc, ui32Count, eType, indices);
+
+		if(!pui16Elements)
+		{
+			goto UnlockAndReturn;
+		}
+
+		bIndicesWerePromoted = IMG_TRUE;
+		eType = GL_UNSIGNED_SHORT;
+	}
+	else if (pfnDrawElements != DrawElementsIndexBO) /* To see whether can use sVAOMachine or sBufObjMachine 's element bufobj */
+	{
+		PVRSRV_CLIENT_MEM_INFO *psMemInfo = IMG_NULL;
+		GLES2BufferObject *psIndexBO = psVAOMachine->psBoundElementBuffer;
+
+		if (psIndexBO)
+		{
+			psMemInfo = GetIndexBufferMemInfo(psIndexBO, eMode, eType, (IMG_UINT32)GLES2_BUFFER_OFFSET(indices), ui32Count);
+		}
+
+		if (psMemInfo)
+		{
+			if(GLES2_BUFFER_OFFSET(indices) > (GLintptr)psMemInfo->uAllocSize)
+			{
+				PVR_DPF((PVR_DBG_ERROR,"Index offset %ld is larger than index buffer size %u",GLES2_BUFFER_OFFSET(indices), psMemInfo->uAllocSize));
+			}
+
+			/* The given 'indices' pointer is actually an offset when an index buffer object is bound */
+			pui16Elements = (const IMG_UINT16*)((IMG_UINTPTR_T)((const IMG_UINT8 *)psMemInfo->pvLinAddr + GLES2_BUFFER_OFFSET(indices)));
+		}
+	}
+
+	/* Call the actual draw element function */
+	(*pfnDrawElements)(gc, eMode, 0, ui32Count, ui32NumIndices, eType, pui16Elements, ui32VertexStart, ui32VertexCount);
+
+	if(bIndicesWerePromoted)
+	{
+		GLES2Free(IMG_NULL, (IMG_VOID *)((IMG_UINTPTR_T)pui16Elements));
+	}
+
+	/*
+		Update vertex and index buffers committed primitive offset
+	*/
+	CBUF_UpdateVIBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA, (IMG_VOID *)gc, KickLimit_ScheduleTA);
+
+UnlockAndReturn:
+	PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
+}
+
+
 /***********************************************************************************
  Function Name      : glDrawArrays
  Inputs             : eMode, first, count
@@ -2340,12 +2556,9 @@ static IMG_VOID HandlePrimitiveTypeChange(GLES2Context *gc, GLenum mode)
 ************************************************************************************/
 GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
-	PFNDrawVArray pfnDrawArrays;
 	IMG_UINT32 ui32NumIndices;
-	IMG_UINT32 ui32NoClears = 0;
-	GLES2VertexArrayObjectMachine *psVAOMachine;
-	
-	__GLES2_GET_CONTEXT();
+
+	__GLES2_GET_CONTEXT_FOR_DRAW();
 
 	PVR_DPF((PVR_DBG_CALLTRACE,"glDrawArrays"));
 
@@ -2422,81 +2635,11 @@ GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count
 		return;
 	}
 
-	if(!PrepareToDraw(gc, &ui32NoClears, IMG_TRUE))
-	{
-		PVR_DPF((PVR_DBG_ERROR,"glDrawArrays: Can't prepare to draw"));
-
-		GLES2_TIME_STOP(GLES2_TIMER_ARRAY_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawArrays);
-
-		return;
-	}
-
-#if defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728)
-	HandlePrimitiveTypeChange(gc, mode);
-#endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
-
-	if(gc->ui32DirtyState || gc->sVAOMachine.psActiveVAO->ui32DirtyState)
-	{
-		if(ValidateState(gc)!=GLES2_NO_ERROR)
-		{
-			PVR_DPF((PVR_DBG_ERROR,"glDrawArrays: ValidateState() failed"));
-			
-			PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-			
-			GLES2_TIME_STOP(GLES2_TIMER_ARRAY_POINTS_TIME+mode);
-			GLES2_TIME_STOP(GLES2_TIMES_glDrawArrays);
-
-			return;
-		}
-	}
-
-	/* Setup VAOMachine */
-	psVAOMachine = &(gc->sVAOMachine);
-
-	
-	/* Check whether any buffer object has undefined memory. 
-	   This could cause visual corruption or lockup, so return without drawing. 
-	   An OUT_OF_MEMORY error will have been raised at the point of allocation failure.
-	 */
-	if (psVAOMachine->ui32ControlWord & ATTRIBARRAY_BAD_BUFOBJ)
-	{
-		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-
-		GLES2_TIME_STOP(GLES2_TIMER_ARRAY_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawArrays);
-
-		return;
-	}
-
-	/* Check whether any buffer object is mapped */
-	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_MAP_BUFOBJ)
+	if(!DeferDraw(gc, mode, 0, (IMG_UINT32)first, (IMG_UINT32)count, ui32NumIndices))
 	{
-		SetError(gc, GL_INVALID_OPERATION);
-		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-
-		GLES2_TIME_STOP(GLES2_TIMER_ARRAY_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawArrays);
-		
-		return;
+		DrawArrays(gc, mode, (IMG_UINT32)first, (IMG_UINT32)count, ui32NumIndices);
 	}
 
-	/* Attach all used resources to the current surface */
-	AttachAllUsedResourcesToCurrentSurface(gc);
-
-	pfnDrawArrays = PickDrawArraysProc(gc, mode, (IMG_UINT32)count);
-
-	GLES_ASSERT(pfnDrawArrays != IMG_NULL);
-
-	(*pfnDrawArrays)(gc, mode, (IMG_UINT32)first, (IMG_UINT32)count, ui32NumIndices, 0, IMG_NULL, (IMG_UINT32)first, (IMG_UINT32)count);
-
-	/*
-		Update vertex and index buffers committed primitive offset
-	*/
-	CBUF_UpdateVIBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA, (IMG_VOID *)gc, KickLimit_ScheduleTA);
-
-	PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-
 	GLES2_TIME_STOP(GLES2_TIMER_ARRAY_POINTS_TIME+mode);
 	GLES2_TIME_STOP(GLES2_TIMES_glDrawArrays);
 
@@ -2518,15 +2661,9 @@ GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count
 ************************************************************************************/
 GL_APICALL void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
 {
-	IMG_UINT32 ui32MinIndex=0xFFFFFFFF, ui32MaxIndex=0,ui32NumIndices;
-	IMG_UINT32 ui32VertexStart, ui32VertexCount;
-	PFNDrawVArray pfnDrawElements;
-	const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)indices;
-	IMG_BOOL bIndicesWerePromoted = IMG_FALSE;
-	IMG_UINT32 ui32NoClears = 0;
-	GLES2VertexArrayObjectMachine *psVAOMachine;
+	IMG_UINT32 ui32NumIndices, ui32IndexSize = 0;
 
-	__GLES2_GET_CONTEXT();
+	__GLES2_GET_CONTEXT_FOR_DRAW();
 
 	PVR_DPF((PVR_DBG_CALLTRACE,"glDrawElements"));
 
@@ -2558,9 +2695,19 @@ bad_enum:
 	switch(type) 
 	{
 		case GL_UNSIGNED_BYTE:
+		{
+			break;
+		}
 		case GL_UNSIGNED_SHORT:
+		{
+			ui32IndexSize = 2;
+
+			break;
+		}
 		case GL_UNSIGNED_INT:
 		{
+			ui32IndexSize = 4;
+
 			break;
 		}
 		default:
@@ -2618,152 +2765,27 @@ bad_enum:
 		return;
 	}
 
-	if(!PrepareToDraw(gc, &ui32NoClears, IMG_TRUE))
-	{
-		PVR_DPF((PVR_DBG_ERROR,"glDrawElements: Can't prepare to draw"));
-
-		GLES2_TIME_STOP(GLES2_TIMER_ELEMENT_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawElements);
-
-		return;
-	}
-
-#if defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728)
-	HandlePrimitiveTypeChange(gc, mode);
-#endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
-
-	if(gc->ui32DirtyState || gc->sVAOMachine.psActiveVAO->ui32DirtyState)
-	{
-		if(ValidateState(gc)!=GLES2_NO_ERROR)
-		{
-			PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-			PVR_DPF((PVR_DBG_ERROR,"glDrawElements: ValidateState() failed"));
-			
-			GLES2_TIME_STOP(GLES2_TIMER_ELEMENT_POINTS_TIME+mode);
-			GLES2_TIME_STOP(GLES2_TIMES_glDrawElements);
-
-			return;
-		}
-	}
-
-	/* Attach all used resources to the current surface */
-	AttachAllUsedResourcesToCurrentSurface(gc);
-
-
-	/* Setup VAOMachine */
-	psVAOMachine = &(gc->sVAOMachine);
-
-	/*  Check whether any buffer object has undefined memory. 
-		This could cause visual corruption or lockup, so return without drawing. 
-		An OUT_OF_MEMORY error will have been raised at the point of allocation failure.
-	*/
-	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_BAD_BUFOBJ)
-	{
-		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-		GLES2_TIME_STOP(GLES2_TIMER_ELEMENT_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawElements);
-
-		return;
-	}
-
-	if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_MAP_BUFOBJ)
-	{
-		PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-		SetError(gc, GL_INVALID_OPERATION);
-
-		GLES2_TIME_STOP(GLES2_TIMER_ELEMENT_POINTS_TIME+mode);
-		GLES2_TIME_STOP(GLES2_TIMES_glDrawElements);
-		
-		return;
-	}
-
-	if (VAO_IS_ZERO(gc)) /* This setup is only for the DEFAULT VAO */
-	{
-		if(psVAOMachine->ui32ControlWord & ATTRIBARRAY_SOURCE_VARRAY)
-		{
-			DetermineMinAndMaxIndices(gc, (IMG_UINT32)count, type, indices, &ui32MinIndex, &ui32MaxIndex);
-
-			ui32VertexStart = ui32MinIndex;
-			ui32VertexCount = ui32MaxIndex - ui32MinIndex + 1;
-
-			if(INDEX_BUFFER_OBJECT(gc) && (GL_UNSIGNED_BYTE != type)) 
-			{
-				ui32VertexCount += ui32VertexStart;
-				ui32VertexStart = 0;
-			}
-		}
-		else
-		{
-			/* Because all the vertex data comes from buffer objects (or is copied from current state), there is 
-			 * no need to know the vertex range. */
-			ui32VertexStart = 0;
-			ui32VertexCount = 0;
-		}
-	}
-	else /* The following setup is for the NON-ZERO VAO, which does not contain client arrays */
-	{
-		/* Because all the vertex data comes from buffer objects (or is copied from current state), there is 
-		 * no need to know the vertex range. */
-		ui32VertexStart = 0;
-		ui32VertexCount = 0;
-	}
-
-	/* Pick draw functions */
-	pfnDrawElements = PickDrawElementsProc(gc, mode, type, (IMG_UINT32)count, ui32VertexCount, ui32MaxIndex);
-
-	GLES_ASSERT(pfnDrawElements != IMG_NULL);
-
-	/* All 8-bit indices must be promoted to 16-bit */
-	if(GL_UNSIGNED_BYTE == type)
+	/* Indices can only be appended to while they are at whole-index offsets in an element buffer
+	 * (8-bit indices are promoted to a temporary copy on every draw)
+	 */
+	if(ui32IndexSize && gc->sVAOMachine.psBoundElementBuffer &&
+	   ((GLES2_BUFFER_OFFSET(indices) % (GLintptr)ui32IndexSize) == 0))
 	{
-		pui16Elements = TransformIndicesTo16Bits(gc, (IMG_UINT32)count, type, indices);
-
-		if(!pui16Elements)
+		if(!DeferDraw(gc, mode, type, (IMG_UINT32)(GLES2_BUFFER_OFFSET(indices) / (GLintptr)ui32IndexSize), (IMG_UINT32)count, ui32NumIndices))
 		{
-			goto StopTimerAndReturn;
+			DrawElements(gc, mode, (IMG_UINT32)count, ui32NumIndices, type, indices);
 		}
-
-		bIndicesWerePromoted = IMG_TRUE;
-		type = GL_UNSIGNED_SHORT;
 	}
-	else if (pfnDrawElements != DrawElementsIndexBO) /* To see whether can use sVAOMachine or sBufObjMachine 's element bufobj */
+	else
 	{
-		PVRSRV_CLIENT_MEM_INFO *psMemInfo = IMG_NULL;
-		GLES2BufferObject *psIndexBO = psVAOMachine->psBoundElementBuffer;
-
-		if (psIndexBO)
-		{
-			psMemInfo = psIndexBO->psMemInfo;
-		}
-		
-		if (psMemInfo)
+		if(gc->sDeferredDraw.bPending)
 		{
-			if(GLES2_BUFFER_OFFSET(indices) > (GLintptr)psMemInfo->uAllocSize)
-			{
-				PVR_DPF((PVR_DBG_ERROR,"Index offset %ld is larger than index buffer size %u",GLES2_BUFFER_OFFSET(indices), psMemInfo->uAllocSize));
-			}
-
-			/* The given 'indices' pointer is actually an offset when an index buffer object is bound */
-			pui16Elements = (const IMG_UINT16*)((IMG_UINTPTR_T)((const IMG_UINT8 *)psMemInfo->pvLinAddr + GLES2_BUFFER_OFFSET(indices)));
+			FlushDeferredDraw(gc);
 		}
-	}
-
-	/* Call the actual draw element function */
-	(*pfnDrawElements)(gc, mode, 0, (IMG_UINT32)count, ui32NumIndices, type, pui16Elements, ui32VertexStart, ui32VertexCount); 
 
-	if(bIndicesWerePromoted) 
-	{
-		GLES2Free(IMG_NULL, (IMG_VOID *)((IMG_UINTPTR_T)pui16Elements));
+		DrawElements(gc, mode, (IMG_UINT32)count, ui32NumIndices, type, indices);
 	}
 
-	/*
-		Update vertex and index buffers committed primitive offset
-	*/
-	CBUF_UpdateVIBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA, (IMG_VOID *)gc, KickLimit_ScheduleTA);
-
-StopTimerAndReturn:
-	PVRSRVUnlockMutex(gc->psRenderSurface->hMutex);
-
 	GLES2_TIME_STOP(GLES2_TIMER_ELEMENT_POINTS_TIME+mode);
 	GLES2_TIME_STOP(GLES2_TIMES_glDrawElements);
 
@@ -3719,7 +3741,7 @@ bad_value:
 	HandlePrimitiveTypeChange(gc, mode);
 #endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
 
-	if(gc->ui32DirtyState || gc->sVAOMachine.psActiveVAO->ui32DirtyState)
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
 	{
 		if(ValidateState(gc)!=GLES2_NO_ERROR)
 		{
@@ -3932,7 +3954,7 @@ bad_value:
 	HandlePrimitiveTypeChange(gc, mode);
 #endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
 
-	if(gc->ui32DirtyState || gc->sVAOMachine.psActiveVAO->ui32DirtyState)
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
 	{
 		if(ValidateState(gc)!=GLES2_NO_ERROR)
 		{
@@ -376,6 +376,12 @@ typedef void* GLeglImageOES;
 #define GL_TEXTURE_SAMPLES_IMG                                  0x9136
 #endif
 
+/* GL_IMG_pixel_pack_buffer */
+#ifndef GL_IMG_pixel_pack_buffer
+#define GL_PIXEL_PACK_BUFFER_IMG                                0x88EB
+#define GL_PIXEL_PACK_BUFFER_BINDING_IMG                        0x88ED
+#endif
+
 /* GL_IMG_texture_stream */
 #ifndef GL_IMG_texture_stream
 #define GL_TEXTURE_STREAM_IMG 									0x8C0D 	
@@ -901,6 +907,20 @@ typedef void (GL_APIENTRYP PFNGLRENDERBUFFERSTORAGEMULTISAMPLEIMGPROC) (GLenum t
 typedef void (GL_APIENTRYP PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC) (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLsizei samples);
 #endif
 
+/* GL_IMG_pixel_pack_buffer */
+#ifndef GL_IMG_pixel_pack_buffer
+#define GL_IMG_pixel_pack_buffer 1
+#endif
+
+/* GL_IMG_shader_prewarm */
+#ifndef GL_IMG_shader_prewarm
+#define GL_IMG_shader_prewarm 1
+#ifdef GL_GLEXT_PROTOTYPES
+GL_API_EXT void GL_APIENTRY glPrewarmProgramIMG (GLuint program, GLsizei count, const GLenum *formats, const GLenum *types);
+#endif
+typedef void (GL_APIENTRYP PFNGLPREWARMPROGRAMIMGPROC) (GLuint program, GLsizei count, const GLenum *formats, const GLenum *types);
+#endif
+
 /* GL_IMG_texture_stream */
 #ifndef GL_IMG_texture_stream2
 #define GL_IMG_texture_stream2 1
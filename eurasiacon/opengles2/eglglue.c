@@ -130,6 +130,14 @@ static IMG_VOID FreeContextSharedState(GLES2Context *gc)
 		}
 
 
+#if defined(SUPPORT_SOURCE_SHADER)
+		/* Shaders still alive, e.g. held by a context's re-optimisation jobs, just forget their keys */
+		if(psSharedState->sShaderInternTable.psTable)
+		{
+			HashTableDestroy(gc, &psSharedState->sShaderInternTable);
+		}
+#endif
+
 		/* Free the texture manager _after_ destroying the textures so the active list is empty */
 		/* XXX: Does the above comment still apply? --DavidG Oct2006 */
 		if(psSharedState->psTextureManager)
@@ -161,6 +169,11 @@ static IMG_VOID FreeContextSharedState(GLES2Context *gc)
 			UCH_CodeHeapDestroy(psSharedState->psPDSFragmentCodeHeap);
 		}
 
+		if(psSharedState->psPDSVertexCodeHeap)
+		{
+			UCH_CodeHeapDestroy(psSharedState->psPDSVertexCodeHeap);
+		}
+
 
 		if(psSharedState->psSequentialStaticIndicesMemInfo)
 		{
@@ -172,6 +185,32 @@ static IMG_VOID FreeContextSharedState(GLES2Context *gc)
 			GLES2FREEDEVICEMEM(gc->ps3DDevData, psSharedState->psLineStripStaticIndicesMemInfo);
 		}
 
+		/* Every shader prewarmed on it went with the shaders and programs above */
+		if(psSharedState->pvPrewarmUniPatchContext)
+		{
+			PVRUniPatchDestroyContext(psSharedState->pvPrewarmUniPatchContext);
+		}
+
+		if (psSharedState->hUniPatchFinaliseLock)
+		{
+			eError = PVRSRVDestroyMutex(psSharedState->hUniPatchFinaliseLock);
+
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_ERROR, "FreeContextSharedState: PVRSRVDestroyMutex failed on hUniPatchFinaliseLock (%d)", eError));
+			}
+		}
+
+		if (psSharedState->hUniPatchLock)
+		{
+			eError = PVRSRVDestroyMutex(psSharedState->hUniPatchLock);
+
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_ERROR, "FreeContextSharedState: PVRSRVDestroyMutex failed on hUniPatchLock (%d)", eError));
+			}
+		}
+
 		if (psSharedState->hFlushListLock)
 		{
 			eError = PVRSRVDestroyMutex(psSharedState->hFlushListLock);
@@ -365,6 +404,93 @@ static IMG_BOOL CreateSharedState(GLES2Context *gc, GLES2Context *psShareContext
 			}
 
 
+			eError = PVRSRVCreateMutex(&psSharedState->hUniPatchLock);
+
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_ERROR,"CreateSharedState: PVRSRVCreateMutex failed on hUniPatchLock (%d)", eError));
+
+				eError = PVRSRVDestroyMutex(psSharedState->hFlushListLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hFlushListLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hTertiaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hTertiaryLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hSecondaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hSecondaryLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hPrimaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hPrimaryLock (%d)", eError));
+				}
+
+				GLES2Free(IMG_NULL, psSharedState);
+
+				return IMG_FALSE;
+			}
+
+
+			eError = PVRSRVCreateMutex(&psSharedState->hUniPatchFinaliseLock);
+
+			if (eError != PVRSRV_OK)
+			{
+				PVR_DPF((PVR_DBG_ERROR,"CreateSharedState: PVRSRVCreateMutex failed on hUniPatchFinaliseLock (%d)", eError));
+
+				eError = PVRSRVDestroyMutex(psSharedState->hUniPatchLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hUniPatchLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hFlushListLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hFlushListLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hTertiaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hTertiaryLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hSecondaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hSecondaryLock (%d)", eError));
+				}
+
+				eError = PVRSRVDestroyMutex(psSharedState->hPrimaryLock);
+
+				if (eError != PVRSRV_OK)
+				{
+					PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: PVRSRVDestroyMutex failed on hPrimaryLock (%d)", eError));
+				}
+
+				GLES2Free(IMG_NULL, psSharedState);
+
+				return IMG_FALSE;
+			}
+
+
 			/* Initialize the texture manager.
 			 * Make sure that gc->psSharedState points to the right place before calling this
 			 */
@@ -461,6 +587,21 @@ static IMG_BOOL CreateSharedState(GLES2Context *gc, GLES2Context *psShareContext
 				return IMG_FALSE;
 			}
 
+			psSharedState->psPDSVertexCodeHeap = UCH_CodeHeapCreate(gc->ps3DDevData, 
+																	UCH_PDS_CODE_HEAP_TYPE, 
+																	gc->psSysContext->hPDSVertexHeap,
+																	psSharedState->hSecondaryLock,
+																	gc->psSysContext->hPerProcRef);
+
+			if(!psSharedState->psPDSVertexCodeHeap)
+			{
+				PVR_DPF((PVR_DBG_ERROR, "CreateSharedState: Failed to create PDS vertex code heap!\n"));
+
+				FreeContextSharedState(gc);
+
+				return IMG_FALSE;
+			}
+
 			/* Initialize the shareable names arrays */
 			for(i = 0; i < GLES2_MAX_SHAREABLE_NAMETYPE; ++i)
 			{
@@ -475,6 +616,18 @@ static IMG_BOOL CreateSharedState(GLES2Context *gc, GLES2Context *psShareContext
 					return IMG_FALSE;
 				}
 			}
+
+#if defined(SUPPORT_SOURCE_SHADER)
+			if(!HashTableCreate(gc, &psSharedState->sShaderInternTable, GLES2_SHADER_INTERN_LOG2TABLESIZE,
+								GLES2_SHADER_INTERN_MAXNUMENTRIES, ForgetInternedShader))
+			{
+				PVR_DPF((PVR_DBG_ERROR,"CreateSharedState: Couldn't create the shader intern table"));
+
+				FreeContextSharedState(gc);
+
+				return IMG_FALSE;
+			}
+#endif
 		}
 	}
 
@@ -663,6 +816,8 @@ static IMG_BOOL InitContext(GLES2Context *gc, GLES2Context *psShareContext, EGLc
 		goto FAILED_sceUltUlthreadRuntimeCreate;
 	}
 
+	texOpStagingPoolInit(gc);
+
 	gc->bSwTexOpFin = IMG_FALSE;
 	gc->hSwTexOpThrd = sceKernelCreateThread("OGLES2AsyncTexOpCl", texOpAsyncCleanupThread, SCE_KERNEL_LOWEST_PRIORITY_USER, SCE_KERNEL_4KiB, 0, 0, SCE_NULL);
 	sceKernelStartThread(gc->hSwTexOpThrd, 4, &gc);
@@ -708,6 +863,52 @@ static IMG_BOOL InitContext(GLES2Context *gc, GLES2Context *psShareContext, EGLc
 
 	}
 
+	/* Initialise the TA kick PDS vertex variant manager before the hash table that uses it */
+	if(!KRM_Initialize(&gc->sPDSVertexVariantKRM,
+					    KRM_TYPE_TA,
+					    IMG_FALSE,
+					    0,  /* PVRSRV_MUTEX_HANDLE */
+					    gc->ps3DDevData,
+					    gc->psSysContext->sHWInfo.sMiscInfo.hOSGlobalEvent,
+					    ReclaimPDSVertexVariantMemKRM,
+					    IMG_TRUE,
+					    DestroyPDSVertexVariantGhostKRM))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"InitContext: Couldn't initialise the TA kick PDS vertex variant manager"));
+
+		goto FAILED_PDSVertexVariantKRM;
+	}
+
+	if(!HashTableCreate(gc, &gc->sProgram.sPDSVertexVariantHashTable, STATEHASH_LOG2TABLESIZE, STATEHASH_MAXNUMENTRIES, DestroyHashedPDSVertexVariant))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"InitContext: HashTableCreate failed"));
+
+		goto FAILED_CreateVertexHashTable;
+	}
+
+	/* Initialise the TA kick MTE state block manager before the hash table that uses it */
+	if(!KRM_Initialize(&gc->sMTEStateBlockKRM,
+					    KRM_TYPE_TA,
+					    IMG_FALSE,
+					    0,  /* PVRSRV_MUTEX_HANDLE */
+					    gc->ps3DDevData,
+					    gc->psSysContext->sHWInfo.sMiscInfo.hOSGlobalEvent,
+					    ReclaimMTEStateBlockMemKRM,
+					    IMG_TRUE,
+					    DestroyMTEStateBlockGhostKRM))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"InitContext: Couldn't initialise the TA kick MTE state block manager"));
+
+		goto FAILED_MTEStateBlockKRM;
+	}
+
+	if(!HashTableCreate(gc, &gc->sPrim.sMTEStateBlockHashTable, GLES2_MTE_STATE_BLOCK_LOG2TABLESIZE, GLES2_MTE_STATE_BLOCK_MAXNUMENTRIES, DestroyHashedMTEStateBlock))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"InitContext: HashTableCreate failed"));
+
+		goto FAILED_CreateMTEStateBlockHashTable;
+	}
+
 	if(!CreateTextureState(gc))
 	{
 		PVR_DPF((PVR_DBG_ERROR,"InitContext: CreateTextureState failed"));
@@ -1039,6 +1240,22 @@ FAILED_CreateProgramState:
 
 FAILED_CreateTextureState:
 
+	HashTableDestroy(gc, &gc->sPrim.sMTEStateBlockHashTable);
+
+FAILED_CreateMTEStateBlockHashTable:
+
+	KRM_Destroy(gc, &gc->sMTEStateBlockKRM);
+
+FAILED_MTEStateBlockKRM:
+
+	HashTableDestroy(gc, &gc->sProgram.sPDSVertexVariantHashTable);
+
+FAILED_CreateVertexHashTable:
+
+	KRM_Destroy(gc, &gc->sPDSVertexVariantKRM);
+
+FAILED_PDSVertexVariantKRM:
+
 	HashTableDestroy(gc, &gc->sProgram.sPDSFragmentVariantHashTable);
 
 FAILED_CreateHashTable:
@@ -1123,6 +1340,20 @@ static IMG_BOOL DeInitContext(GLES2Context *gc)
 	   this must be after Destroy unshareable name arrays (vao name array in this case) */
 	KRM_Destroy(gc, &gc->sVAOKRM);
 
+	/* Wait for the cached PDS vertex programs, then free them _before_ destroying their manager */
+	KRM_WaitForAllResources(&gc->sPDSVertexVariantKRM, GLES2_DEFAULT_WAIT_RETRIES);
+
+	HashTableDestroy(gc, &gc->sProgram.sPDSVertexVariantHashTable);
+
+	KRM_Destroy(gc, &gc->sPDSVertexVariantKRM);
+
+	/* Likewise for the cached MTE state blocks */
+	KRM_WaitForAllResources(&gc->sMTEStateBlockKRM, GLES2_DEFAULT_WAIT_RETRIES);
+
+	HashTableDestroy(gc, &gc->sPrim.sMTEStateBlockHashTable);
+
+	KRM_Destroy(gc, &gc->sMTEStateBlockKRM);
+
 	HashTableDestroy(gc, &gc->sProgram.sPDSFragmentVariantHashTable);
 
 	if(!FreeTextureState(gc))
@@ -1178,6 +1409,8 @@ static IMG_BOOL DeInitContext(GLES2Context *gc)
 	gc->bSwTexOpFin = IMG_TRUE;
 	sceKernelWaitThreadEnd(gc->hSwTexOpThrd, SCE_NULL, SCE_NULL);
 
+	texOpStagingPoolDeinit(gc);
+
 	if (gc->pvUNCHeap)
 	{
 		sceHeapDeleteHeap(gc->pvUNCHeap);
@@ -1285,6 +1518,12 @@ static IMG_BOOL GLES2DestroyGC(EGLContextHandle hContext)
 	GLES2Context *gc = (GLES2Context *)hContext;
 	IMG_BOOL bReturnValue = IMG_TRUE;
 
+	/* Only a context current on this thread can still hold a deferred draw */
+	if(gc->sDeferredDraw.bPending && (gc == (GLES2Context *)OGLES2_GetTLSValue()))
+	{
+		FlushDeferredDraw(gc);
+	}
+
 	if (!DeInitContext(gc))
 	{
 		PVR_DPF((PVR_DBG_ERROR,"GLES2DestroyGC: Failed to deinit the gc"));
@@ -1312,6 +1551,13 @@ static IMG_EGLERROR GLES2MakeCurrentGC(EGLRenderSurface *psWriteDrawable,
 										EGLContextHandle hContext)
 {
 	GLES2Context *gc = (GLES2Context *)hContext;
+	GLES2Context *psOldGC = (GLES2Context *)OGLES2_GetTLSValue();
+
+	/* Emit any deferred draw to the drawable it was issued against */
+	if(psOldGC && psOldGC->sDeferredDraw.bPending)
+	{
+		FlushDeferredDraw(psOldGC);
+	}
 
 	__GLES2_SET_CONTEXT(gc);
 
@@ -1433,9 +1679,10 @@ static IMG_VOID GLES2MakeUnCurrentGC(void)
 	KRM_RemoveAttachmentPointReferences(&gc->psSharedState->psTextureManager->sKRM, psSurface);
 	KRM_RemoveAttachmentPointReferences(&gc->psSharedState->sUSEShaderVariantKRM, psSurface);
 
-	/* Get rid of texture and shader ghosts */
+	/* Get rid of texture, shader and buffer object ghosts */
 	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->psTextureManager->sKRM);
 	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->sUSEShaderVariantKRM);
+	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->sBufferObjectKRM);
 
 	KRM_RemoveAttachmentPointReferences(&gc->psSharedState->sBufferObjectKRM, gc);
 
@@ -1465,6 +1712,11 @@ static IMG_EGLERROR GLES2FlushBuffersGC(EGLContextHandle hContext,
 	GLES2Context *gc = (GLES2Context *)hContext;
 	IMG_EGLERROR eError = IMG_EGL_NO_ERROR;
 	EGLRenderSurface *psRenderSurface;
+
+	if(gc->sDeferredDraw.bPending && (gc == (GLES2Context *)OGLES2_GetTLSValue()))
+	{
+		FlushDeferredDraw(gc);
+	}
 	
 	if(psSurface)
 	{
@@ -1510,6 +1762,17 @@ static IMG_EGLERROR GLES2FlushBuffersGC(EGLContextHandle hContext,
 		if((eError == IMG_EGL_NO_ERROR) && bNewExternalFrame)
 		{
 			psRenderSurface->bInExternalFrame = IMG_FALSE;
+
+			/* Resize any buffers that kept stalling during the frame just kicked */
+			GrowStalledTABuffers(gc);
+
+#if defined(SUPPORT_SOURCE_SHADER)
+			/* Swap in shaders that finished re-optimising in the background */
+			ServiceShaderReoptimisations(gc);
+#endif
+
+			/* Release prewarm jobs the background worker has finished with */
+			ServiceShaderPrewarm(gc);
 		}
 	}
 
@@ -1542,6 +1805,9 @@ static IMG_VOID GLES2MarkRenderSurfaceAsInvalid(EGLContextHandle hContext)
 	if(gc->psRenderSurface == psSurface)
 	{
 		gc->psRenderSurface = IMG_NULL;
+
+		/* A deferred draw would have gone to the discarded scene */
+		gc->sDeferredDraw.bPending = IMG_FALSE;
 	}
 }
 
@@ -1765,6 +2031,10 @@ static GetProcAddressReturnFunc GLES2GetProcAddress(const char *procname)
 	COMPARE_AND_RETURN(glFramebufferTexture2DMultisampleIMG)
 #endif /* defined(GLES2_EXTENSION_MULTISAMPLED_RENDER_TO_TEXTURE) */
 
+#if defined(GLES2_EXTENSION_SHADER_PREWARM)
+	COMPARE_AND_RETURN(glPrewarmProgramIMG)
+#endif /* defined(GLES2_EXTENSION_SHADER_PREWARM) */
+
 #undef COMPARE_AND_RETURN
 
 	return IMG_NULL;
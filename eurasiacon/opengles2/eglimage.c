@@ -563,6 +563,12 @@ IMG_INTERNAL IMG_EGLERROR GLESGetImageSource(EGLContextHandle hContext, IMG_UINT
 	GLES2Context *gc = (GLES2Context *)hContext;
 	IMG_UINT32 ui32Stride;
 
+	/* The source may be a render target of a deferred draw */
+	if(gc->sDeferredDraw.bPending && (gc == (GLES2Context *)OGLES2_GetTLSValue()))
+	{
+		FlushDeferredDraw(gc);
+	}
+
 	switch(ui32Source)
 	{
 		case EGL_GL_TEXTURE_2D_KHR:
@@ -612,6 +618,14 @@ IMG_INTERNAL IMG_EGLERROR GLESGetImageSource(EGLContextHandle hContext, IMG_UINT
 				return IMG_EGL_BAD_ACCESS;
 			}
 
+			/* Image siblings share the texels, undo driver ETC1 compression */
+			if(!TextureAutoETC1Demote(gc, psTex))
+			{
+				PVR_DPF((PVR_DBG_ERROR,"GLESGetImageSource: Can't decode compressed texture"));
+
+				return IMG_EGL_OUT_OF_MEMORY;
+			}
+
 			/* Make sure the texture isn't tiled */
 			if((psTex->ui32LevelsConsistent==GLES2_TEX_CONSISTENT) && ((psTex->sState.aui32StateWord1[0] & EURASIA_PDS_DOUTT1_TEXTYPE_TILED) != 0))
 			{
@@ -0,0 +1,484 @@
+/******************************************************************************
+ * Name         : etc1codec.c
+ *
+ * Copyright    : 2005-2011 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * Description	: ETC1 block encoder and decoder used by the driver side
+ *				  compression of RGB textures in texetc1.c.
+ *
+ * Modifications:-
+ * $Log: etc1codec.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+
+/* Modifier tables, in pixel index order: +a, +b, -a, -b */
+static const IMG_INT32 ai32ETC1Modifier[8][4] =
+{
+	{  2,   8,  -2,   -8},
+	{  5,  17,  -5,  -17},
+	{  9,  29,  -9,  -29},
+	{ 13,  42, -13,  -42},
+	{ 18,  60, -18,  -60},
+	{ 24,  80, -24,  -80},
+	{ 33, 106, -33, -106},
+	{ 47, 183, -47, -183}
+};
+
+/*
+ * Pixels of each sub-block for both flip modes. Pixel i of a block is at
+ * x = i / 4, y = i % 4, so flip 0 (two 2x4 halves) takes contiguous runs.
+ */
+static const IMG_UINT8 aui8ETC1SubBlockPixel[2][2][8] =
+{
+	{
+		{0, 1, 2, 3, 4, 5, 6, 7},
+		{8, 9, 10, 11, 12, 13, 14, 15}
+	},
+	{
+		{0, 1, 4, 5, 8, 9, 12, 13},
+		{2, 3, 6, 7, 10, 11, 14, 15}
+	}
+};
+
+#define ETC1_CLAMP(i)		(((i) < 0) ? 0 : (((i) > 255) ? 255 : (i)))
+#define ETC1_EXPAND4(i)		((i) * 17)
+#define ETC1_EXPAND5(i)		(((i) << 3) | ((i) >> 2))
+
+
+/***********************************************************************************
+ Function Name      : FitETC1SubBlock
+ Inputs             : pi16Red, pi16Green, pi16Blue, ai32Base
+ Outputs            : pui32Table, pui8Index
+ Returns            : Sum of squared errors of the best fit
+ Description        : UTILITY: Picks the modifier table and per pixel modifiers
+					  which best approximate 8 pixels around a base colour.
+************************************************************************************/
+static IMG_UINT32 FitETC1SubBlock(const IMG_INT16 *pi16Red, const IMG_INT16 *pi16Green, const IMG_INT16 *pi16Blue,
+								  const IMG_INT32 ai32Base[3], IMG_UINT32 *pui32Table, IMG_UINT8 *pui8Index)
+{
+	IMG_UINT32 ui32BestError = 0xFFFFFFFF;
+	IMG_UINT32 ui32Table, k, i;
+	IMG_INT16 ai16Candidate[3][4];
+#if defined(__ARM_NEON__)
+	int16x8_t vi16Red   = vld1q_s16(pi16Red);
+	int16x8_t vi16Green = vld1q_s16(pi16Green);
+	int16x8_t vi16Blue  = vld1q_s16(pi16Blue);
+	IMG_UINT32 aui32Index[8];
+#else
+	IMG_UINT8 aui8Index[8];
+#endif
+
+	for(ui32Table = 0; ui32Table < 8; ui32Table++)
+	{
+		IMG_UINT32 ui32Error;
+
+		/* The candidate colours are the same for every pixel of the sub-block */
+		for(k = 0; k < 4; k++)
+		{
+			ai16Candidate[0][k] = (IMG_INT16)ETC1_CLAMP(ai32Base[0] + ai32ETC1Modifier[ui32Table][k]);
+			ai16Candidate[1][k] = (IMG_INT16)ETC1_CLAMP(ai32Base[1] + ai32ETC1Modifier[ui32Table][k]);
+			ai16Candidate[2][k] = (IMG_INT16)ETC1_CLAMP(ai32Base[2] + ai32ETC1Modifier[ui32Table][k]);
+		}
+
+#if defined(__ARM_NEON__)
+		{
+			int32x4_t vi32BestLo = vdupq_n_s32(0x7FFFFFFF);
+			int32x4_t vi32BestHi = vdupq_n_s32(0x7FFFFFFF);
+			uint32x4_t vui32IndexLo = vdupq_n_u32(0);
+			uint32x4_t vui32IndexHi = vdupq_n_u32(0);
+			int32x2_t vi32Sum;
+
+			for(k = 0; k < 4; k++)
+			{
+				int16x8_t vi16DR = vsubq_s16(vi16Red,   vdupq_n_s16(ai16Candidate[0][k]));
+				int16x8_t vi16DG = vsubq_s16(vi16Green, vdupq_n_s16(ai16Candidate[1][k]));
+				int16x8_t vi16DB = vsubq_s16(vi16Blue,  vdupq_n_s16(ai16Candidate[2][k]));
+				int32x4_t vi32ErrLo, vi32ErrHi;
+				uint32x4_t vui32Less;
+
+				vi32ErrLo = vmull_s16(vget_low_s16(vi16DR), vget_low_s16(vi16DR));
+				vi32ErrLo = vmlal_s16(vi32ErrLo, vget_low_s16(vi16DG), vget_low_s16(vi16DG));
+				vi32ErrLo = vmlal_s16(vi32ErrLo, vget_low_s16(vi16DB), vget_low_s16(vi16DB));
+
+				vi32ErrHi = vmull_s16(vget_high_s16(vi16DR), vget_high_s16(vi16DR));
+				vi32ErrHi = vmlal_s16(vi32ErrHi, vget_high_s16(vi16DG), vget_high_s16(vi16DG));
+				vi32ErrHi = vmlal_s16(vi32ErrHi, vget_high_s16(vi16DB), vget_high_s16(vi16DB));
+
+				/* Strictly smaller, so ties keep the lower index like the scalar path */
+				vui32Less    = vcltq_s32(vi32ErrLo, vi32BestLo);
+				vi32BestLo   = vminq_s32(vi32ErrLo, vi32BestLo);
+				vui32IndexLo = vbslq_u32(vui32Less, vdupq_n_u32(k), vui32IndexLo);
+
+				vui32Less    = vcltq_s32(vi32ErrHi, vi32BestHi);
+				vi32BestHi   = vminq_s32(vi32ErrHi, vi32BestHi);
+				vui32IndexHi = vbslq_u32(vui32Less, vdupq_n_u32(k), vui32IndexHi);
+			}
+
+			vi32BestLo = vaddq_s32(vi32BestLo, vi32BestHi);
+			vi32Sum = vadd_s32(vget_low_s32(vi32BestLo), vget_high_s32(vi32BestLo));
+			vi32Sum = vpadd_s32(vi32Sum, vi32Sum);
+
+			ui32Error = (IMG_UINT32)vget_lane_s32(vi32Sum, 0);
+
+			if(ui32Error < ui32BestError)
+			{
+				ui32BestError = ui32Error;
+				*pui32Table = ui32Table;
+
+				vst1q_u32(&aui32Index[0], vui32IndexLo);
+				vst1q_u32(&aui32Index[4], vui32IndexHi);
+
+				for(i = 0; i < 8; i++)
+				{
+					pui8Index[i] = (IMG_UINT8)aui32Index[i];
+				}
+			}
+		}
+#else /* defined(__ARM_NEON__) */
+		ui32Error = 0;
+
+		for(i = 0; i < 8; i++)
+		{
+			IMG_UINT32 ui32PixelError = 0xFFFFFFFF;
+
+			for(k = 0; k < 4; k++)
+			{
+				IMG_INT32 i32DR = pi16Red[i]   - ai16Candidate[0][k];
+				IMG_INT32 i32DG = pi16Green[i] - ai16Candidate[1][k];
+				IMG_INT32 i32DB = pi16Blue[i]  - ai16Candidate[2][k];
+				IMG_UINT32 ui32Err = (IMG_UINT32)(i32DR * i32DR + i32DG * i32DG + i32DB * i32DB);
+
+				if(ui32Err < ui32PixelError)
+				{
+					ui32PixelError = ui32Err;
+					aui8Index[i] = (IMG_UINT8)k;
+				}
+			}
+
+			ui32Error += ui32PixelError;
+
+			if(ui32Error >= ui32BestError)
+			{
+				break;
+			}
+		}
+
+		if(ui32Error < ui32BestError)
+		{
+			ui32BestError = ui32Error;
+			*pui32Table = ui32Table;
+
+			for(i = 0; i < 8; i++)
+			{
+				pui8Index[i] = aui8Index[i];
+			}
+		}
+#endif /* defined(__ARM_NEON__) */
+	}
+
+	return ui32BestError;
+}
+
+
+/***********************************************************************************
+ Function Name      : EncodeETC1Block
+ Inputs             : ai16Block - 16 pixels per channel, pixel i at x = i/4, y = i%4
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : UTILITY: Encodes one 4x4 block. Both flip modes are tried,
+					  each sub-block uses its average colour as the base colour,
+					  in differential mode whenever the two bases are close enough.
+					  The block is written in HW word order (the high 32 bits of
+					  the big-endian block first).
+************************************************************************************/
+static IMG_VOID EncodeETC1Block(IMG_INT16 ai16Block[3][16], IMG_UINT32 *pui32Dest)
+{
+	IMG_UINT32 ui32BestError = 0xFFFFFFFF;
+	IMG_UINT32 ui32BestHigh = 0, ui32BestLow = 0;
+	IMG_UINT32 ui32Flip, ui32Sub, c, i;
+
+	for(ui32Flip = 0; ui32Flip < 2; ui32Flip++)
+	{
+		IMG_INT16 ai16Sub[2][3][8];
+		IMG_INT32 ai32Average[2][3], ai32Base[2][3], ai32Quant[2][3];
+		IMG_UINT32 aui32Table[2], ui32Error, ui32High, ui32Low;
+		IMG_UINT8 aui8Index[2][8];
+		IMG_BOOL bDifferential = IMG_TRUE;
+
+		for(ui32Sub = 0; ui32Sub < 2; ui32Sub++)
+		{
+			for(c = 0; c < 3; c++)
+			{
+				IMG_INT32 i32Sum = 0;
+
+				for(i = 0; i < 8; i++)
+				{
+					ai16Sub[ui32Sub][c][i] = ai16Block[c][aui8ETC1SubBlockPixel[ui32Flip][ui32Sub][i]];
+
+					i32Sum += ai16Sub[ui32Sub][c][i];
+				}
+
+				ai32Average[ui32Sub][c] = (i32Sum + 4) >> 3;
+
+				ai32Quant[ui32Sub][c] = (ai32Average[ui32Sub][c] * 31 + 127) / 255;
+			}
+		}
+
+		for(c = 0; c < 3; c++)
+		{
+			IMG_INT32 i32Delta = ai32Quant[1][c] - ai32Quant[0][c];
+
+			if(i32Delta < -4 || i32Delta > 3)
+			{
+				bDifferential = IMG_FALSE;
+			}
+		}
+
+		for(ui32Sub = 0; ui32Sub < 2; ui32Sub++)
+		{
+			for(c = 0; c < 3; c++)
+			{
+				if(!bDifferential)
+				{
+					ai32Quant[ui32Sub][c] = (ai32Average[ui32Sub][c] * 15 + 127) / 255;
+
+					ai32Base[ui32Sub][c] = ETC1_EXPAND4(ai32Quant[ui32Sub][c]);
+				}
+				else
+				{
+					ai32Base[ui32Sub][c] = ETC1_EXPAND5(ai32Quant[ui32Sub][c]);
+				}
+			}
+		}
+
+		ui32Error = FitETC1SubBlock(ai16Sub[0][0], ai16Sub[0][1], ai16Sub[0][2], ai32Base[0], &aui32Table[0], aui8Index[0]);
+
+		if(ui32Error >= ui32BestError)
+		{
+			continue;
+		}
+
+		ui32Error += FitETC1SubBlock(ai16Sub[1][0], ai16Sub[1][1], ai16Sub[1][2], ai32Base[1], &aui32Table[1], aui8Index[1]);
+
+		if(ui32Error >= ui32BestError)
+		{
+			continue;
+		}
+
+		if(bDifferential)
+		{
+			ui32High = ((IMG_UINT32)ai32Quant[0][0] << 27) | (((IMG_UINT32)(ai32Quant[1][0] - ai32Quant[0][0]) & 7) << 24) |
+					   ((IMG_UINT32)ai32Quant[0][1] << 19) | (((IMG_UINT32)(ai32Quant[1][1] - ai32Quant[0][1]) & 7) << 16) |
+					   ((IMG_UINT32)ai32Quant[0][2] << 11) | (((IMG_UINT32)(ai32Quant[1][2] - ai32Quant[0][2]) & 7) << 8) |
+					   (1 << 1);
+		}
+		else
+		{
+			ui32High = ((IMG_UINT32)ai32Quant[0][0] << 28) | ((IMG_UINT32)ai32Quant[1][0] << 24) |
+					   ((IMG_UINT32)ai32Quant[0][1] << 20) | ((IMG_UINT32)ai32Quant[1][1] << 16) |
+					   ((IMG_UINT32)ai32Quant[0][2] << 12) | ((IMG_UINT32)ai32Quant[1][2] << 8);
+		}
+
+		ui32High |= (aui32Table[0] << 5) | (aui32Table[1] << 2) | ui32Flip;
+
+		/* Pixel index MSBs live in bits 31-16 and LSBs in bits 15-0 */
+		ui32Low = 0;
+
+		for(ui32Sub = 0; ui32Sub < 2; ui32Sub++)
+		{
+			for(i = 0; i < 8; i++)
+			{
+				IMG_UINT32 ui32Pixel = aui8ETC1SubBlockPixel[ui32Flip][ui32Sub][i];
+				IMG_UINT32 ui32Index = aui8Index[ui32Sub][i];
+
+				ui32Low |= ((ui32Index >> 1) << (16 + ui32Pixel)) | ((ui32Index & 1) << ui32Pixel);
+			}
+		}
+
+		ui32BestError = ui32Error;
+		ui32BestHigh = ui32High;
+		ui32BestLow = ui32Low;
+	}
+
+	pui32Dest[0] = ui32BestHigh;
+	pui32Dest[1] = ui32BestLow;
+}
+
+
+/***********************************************************************************
+ Function Name      : EncodeETC1Blocks
+ Inputs             : pui8Src, ui32SrcBytesPerPixel, ui32Width, ui32Height,
+					  ui32SrcStrideInBytes, ui32FirstBlockRow, ui32NumBlockRows
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : UTILITY: Encodes a band of block rows of an RGB image to ETC1.
+					  Sources are RGB565 (2 bytes per pixel), RGB888 (3) or
+					  RGBX8888 (4). Blocks overlapping the right or bottom edge
+					  repeat the last column/row. Bands touch disjoint output so
+					  several may be encoded concurrently.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID EncodeETC1Blocks(IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+									   IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes,
+									   IMG_UINT32 ui32FirstBlockRow, IMG_UINT32 ui32NumBlockRows)
+{
+	IMG_UINT32 ui32WidthInBlocks = ALIGNCOUNTINBLOCKS(ui32Width, 2);
+	IMG_UINT32 ui32BlockX, ui32BlockY, x, y;
+	IMG_INT16 ai16Block[3][16];
+
+	pui32Dest += ui32FirstBlockRow * ui32WidthInBlocks * 2;
+
+	for(ui32BlockY = ui32FirstBlockRow; ui32BlockY < ui32FirstBlockRow + ui32NumBlockRows; ui32BlockY++)
+	{
+		for(ui32BlockX = 0; ui32BlockX < ui32WidthInBlocks; ui32BlockX++)
+		{
+			for(y = 0; y < 4; y++)
+			{
+				IMG_UINT32 ui32Y = MIN(ui32BlockY * 4 + y, ui32Height - 1);
+				const IMG_UINT8 *pui8Row = pui8Src + ui32Y * ui32SrcStrideInBytes;
+
+				for(x = 0; x < 4; x++)
+				{
+					IMG_UINT32 ui32X = MIN(ui32BlockX * 4 + x, ui32Width - 1);
+					const IMG_UINT8 *pui8Pixel = pui8Row + ui32X * ui32SrcBytesPerPixel;
+
+					if(ui32SrcBytesPerPixel == 2)
+					{
+						IMG_UINT32 ui32Texel = *(const IMG_UINT16 *)pui8Pixel;
+						IMG_UINT32 ui32R = ui32Texel >> 11, ui32G = (ui32Texel >> 5) & 0x3F, ui32B = ui32Texel & 0x1F;
+
+						ai16Block[0][x * 4 + y] = (IMG_INT16)((ui32R << 3) | (ui32R >> 2));
+						ai16Block[1][x * 4 + y] = (IMG_INT16)((ui32G << 2) | (ui32G >> 4));
+						ai16Block[2][x * 4 + y] = (IMG_INT16)((ui32B << 3) | (ui32B >> 2));
+					}
+					else
+					{
+						ai16Block[0][x * 4 + y] = pui8Pixel[0];
+						ai16Block[1][x * 4 + y] = pui8Pixel[1];
+						ai16Block[2][x * 4 + y] = pui8Pixel[2];
+					}
+				}
+			}
+
+			EncodeETC1Block(ai16Block, pui32Dest);
+
+			pui32Dest += 2;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : DecodeETC1Blocks
+ Inputs             : pui32Src, ui32DstBytesPerPixel, ui32Width, ui32Height
+ Outputs            : pui8Dest
+ Returns            : -
+ Description        : UTILITY: Decodes ETC1 blocks in HW word order to a tightly
+					  packed RGB565 (2 bytes per pixel) or RGBX8888 (4) image.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DecodeETC1Blocks(const IMG_UINT32 *pui32Src, IMG_UINT8 *pui8Dest, IMG_UINT32 ui32DstBytesPerPixel,
+									   IMG_UINT32 ui32Width, IMG_UINT32 ui32Height)
+{
+	IMG_UINT32 ui32WidthInBlocks = ALIGNCOUNTINBLOCKS(ui32Width, 2);
+	IMG_UINT32 ui32HeightInBlocks = ALIGNCOUNTINBLOCKS(ui32Height, 2);
+	IMG_UINT32 ui32BlockX, ui32BlockY, i;
+
+	for(ui32BlockY = 0; ui32BlockY < ui32HeightInBlocks; ui32BlockY++)
+	{
+		for(ui32BlockX = 0; ui32BlockX < ui32WidthInBlocks; ui32BlockX++)
+		{
+			IMG_UINT32 ui32High = pui32Src[0];
+			IMG_UINT32 ui32Low = pui32Src[1];
+			IMG_INT32 ai32Base[2][3];
+			IMG_UINT32 aui32Table[2];
+
+			if(ui32High & 2)
+			{
+				IMG_UINT32 c;
+
+				for(c = 0; c < 3; c++)
+				{
+					IMG_INT32 i32Base = (IMG_INT32)((ui32High >> (27 - c * 8)) & 0x1F);
+					IMG_INT32 i32Delta = (IMG_INT32)((ui32High >> (24 - c * 8)) & 0x7);
+
+					if(i32Delta > 3)
+					{
+						i32Delta -= 8;
+					}
+
+					ai32Base[0][c] = ETC1_EXPAND5(i32Base);
+					ai32Base[1][c] = ETC1_EXPAND5((i32Base + i32Delta) & 0x1F);
+				}
+			}
+			else
+			{
+				IMG_UINT32 c;
+
+				for(c = 0; c < 3; c++)
+				{
+					ai32Base[0][c] = ETC1_EXPAND4((IMG_INT32)((ui32High >> (28 - c * 8)) & 0xF));
+					ai32Base[1][c] = ETC1_EXPAND4((IMG_INT32)((ui32High >> (24 - c * 8)) & 0xF));
+				}
+			}
+
+			aui32Table[0] = (ui32High >> 5) & 7;
+			aui32Table[1] = (ui32High >> 2) & 7;
+
+			for(i = 0; i < 16; i++)
+			{
+				IMG_UINT32 x = ui32BlockX * 4 + (i >> 2);
+				IMG_UINT32 y = ui32BlockY * 4 + (i & 3);
+				IMG_UINT32 ui32Sub = (ui32High & 1) ? ((i & 3) >> 1) : (i >> 3);
+				IMG_UINT32 ui32Index = (((ui32Low >> (16 + i)) & 1) << 1) | ((ui32Low >> i) & 1);
+				IMG_INT32 i32Modifier = ai32ETC1Modifier[aui32Table[ui32Sub]][ui32Index];
+				IMG_UINT32 ui32R, ui32G, ui32B;
+				IMG_UINT8 *pui8Pixel;
+
+				if(x >= ui32Width || y >= ui32Height)
+				{
+					continue;
+				}
+
+				ui32R = (IMG_UINT32)ETC1_CLAMP(ai32Base[ui32Sub][0] + i32Modifier);
+				ui32G = (IMG_UINT32)ETC1_CLAMP(ai32Base[ui32Sub][1] + i32Modifier);
+				ui32B = (IMG_UINT32)ETC1_CLAMP(ai32Base[ui32Sub][2] + i32Modifier);
+
+				pui8Pixel = pui8Dest + (y * ui32Width + x) * ui32DstBytesPerPixel;
+
+				if(ui32DstBytesPerPixel == 2)
+				{
+					*(IMG_UINT16 *)pui8Pixel = (IMG_UINT16)(((ui32R >> 3) << 11) | ((ui32G >> 2) << 5) | (ui32B >> 3));
+				}
+				else
+				{
+					pui8Pixel[0] = (IMG_UINT8)ui32R;
+					pui8Pixel[1] = (IMG_UINT8)ui32G;
+					pui8Pixel[2] = (IMG_UINT8)ui32B;
+					pui8Pixel[3] = 0xFF;
+				}
+			}
+
+			pui32Src += 2;
+		}
+	}
+}
+
+/******************************************************************************
+ End of file (etc1codec.c)
+******************************************************************************/
@@ -3750,6 +3750,20 @@ bad_op:
 			goto bad_op;
 		}
 
+		/* Render targets are never driver compressed */
+		if(!TextureAutoETC1Demote(gc, psTex))
+		{
+			NamedItemDelRef(gc, psNamesArray, (GLES2NamedItem*)psTex);
+
+			psFrameBuffer->apsAttachment[ui32Attachment] = IMG_NULL;
+
+			FrameBufferHasBeenModified(psFrameBuffer);
+
+			GLES2_TIME_STOP(GLES2_TIMES_glFramebufferTexture2D);
+
+			return;
+		}
+
 		psFrameBuffer->apsAttachment[ui32Attachment] = (GLES2FrameBufferAttachable*)
 			&psTex->psMipLevel[ui32Face*GLES2_MAX_TEXTURE_MIPMAP_LEVELS + (IMG_UINT32)level];
 
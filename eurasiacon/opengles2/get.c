@@ -587,6 +587,16 @@ static IMG_VOID DoGet(GLES2Context *gc, GLenum eQuery, IMG_VOID *pvResult, IMG_U
 				*ip++ = 0;
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_BINDING_IMG:
+		{
+			if(gc->sBufferObject.psActiveBuffer[PIXEL_PACK_BUFFER_INDEX])
+				*ip++ = (IMG_INT32)gc->sBufferObject.psActiveBuffer[PIXEL_PACK_BUFFER_INDEX]->sNamedItem.ui32Name;
+			else
+				*ip++ = 0;
+			break;
+		}
+#endif
 		case GL_CURRENT_PROGRAM:
 		{
 			GLES2Program *psProgram = gc->sProgram.psCurrentProgram;
@@ -1053,6 +1063,11 @@ GL_APICALL void GL_APIENTRY glGetBufferParameteriv(GLenum target, GLenum pname,
 		case GL_ELEMENT_ARRAY_BUFFER:
 			ui32TargetIndex = target - GL_ARRAY_BUFFER;
 			break;
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+			break;
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 			SetError(gc, GL_INVALID_ENUM);
 			GLES2_TIME_STOP(GLES2_TIMES_glGetBufferParameteriv);
@@ -1134,6 +1149,14 @@ GL_API_EXT void APIENTRY glGetBufferPointervOES(GLenum target, GLenum pname, voi
 
 			break;
 		}
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+		case GL_PIXEL_PACK_BUFFER_IMG:
+		{
+			ui32TargetIndex = PIXEL_PACK_BUFFER_INDEX;
+
+			break;
+		}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
 		default:
 		{
 			SetError(gc, GL_INVALID_ENUM);
@@ -1447,8 +1470,12 @@ GL_APICALL void GL_APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint *
 						then call CreateBinaryProgram() passing in the false flag, the function will calculate the program size
 						without actually creating it 
 					***********************************************************************************************************/
+					LockGLSLCompiler(gc);
+
 					gc->sProgram.sGLSLFuncTable.pfnCreateBinaryProgram(&sUniflexProgramVertex, &sUniflexProgramFragment, psProgram->psUserBinding, 1, &length, (IMG_VOID *) &length, IMG_FALSE);
 
+					UnlockGLSLCompiler(gc);
+
 					/* clean up precompiled shaders */
 					PVRUniPatchDestroyPCShader(gc->sProgram.pvUniPatchContext, sUniflexProgramVertex.psUniFlexCode->psUniPatchInput);
 					PVRUniPatchDestroyPCShader(gc->sProgram.pvUniPatchContext, sUniflexProgramFragment.psUniFlexCode->psUniPatchInput);
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * Name         : indexopt.c
+ *
+ * Copyright    : 2005-2006 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Reordering of static triangle lists for post-transform
+ *                vertex cache reuse
+ *
+ * Platform     : ANSI
+ *
+ * $Log: indexopt.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+#if defined(DEBUG) || defined(TIMING)
+/***********************************************************************************
+ Function Name      : ComputeACMR
+ Inputs             : pui16Indices, ui32NumIndices, ui32NumVertices, pui32Timestamps
+ Outputs            : -
+ Returns            : Average cache miss ratio
+ Description        : Simulates a FIFO post-transform cache of GLES2_INDEX_OPTIMISER_CACHE_SIZE
+					  entries over a triangle list and returns the number of vertex
+					  transforms per triangle. pui32Timestamps is ui32NumVertices of scratch.
+************************************************************************************/
+static IMG_FLOAT ComputeACMR(const IMG_UINT16 *pui16Indices, IMG_UINT32 ui32NumIndices,
+							 IMG_UINT32 ui32NumVertices, IMG_UINT32 *pui32Timestamps)
+{
+	IMG_UINT32 ui32Misses = GLES2_INDEX_OPTIMISER_CACHE_SIZE + 1;
+	IMG_UINT32 i;
+
+	for(i = 0; i < ui32NumVertices; i++)
+	{
+		pui32Timestamps[i] = 0;
+	}
+
+	for(i = 0; i < ui32NumIndices; i++)
+	{
+		IMG_UINT32 ui32Vertex = pui16Indices[i];
+
+		if((ui32Misses - pui32Timestamps[ui32Vertex]) > GLES2_INDEX_OPTIMISER_CACHE_SIZE)
+		{
+			pui32Timestamps[ui32Vertex] = ui32Misses++;
+		}
+	}
+
+	ui32Misses -= GLES2_INDEX_OPTIMISER_CACHE_SIZE + 1;
+
+	return (IMG_FLOAT)ui32Misses / (IMG_FLOAT)(ui32NumIndices / 3);
+}
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+
+/***********************************************************************************
+ Function Name      : ReorderIndicesForVertexCache
+ Inputs             : gc, pui16Src, ui32NumIndices
+ Outputs            : pui16Dst
+ Returns            : Success
+ Description        : Reorders the triangles of a 16-bit triangle list to improve
+					  post-transform vertex cache reuse, using the Tipsify algorithm
+					  (Sander, Nehab, Barczak 2007). Triangles keep their winding;
+					  only the order in which they are drawn changes.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL ReorderIndicesForVertexCache(GLES2Context *gc, const IMG_UINT16 *pui16Src,
+												   IMG_UINT16 *pui16Dst, IMG_UINT32 ui32NumIndices)
+{
+	IMG_UINT32 ui32NumTriangles = ui32NumIndices / 3;
+	IMG_UINT32 ui32NumVertices = 0;
+	IMG_UINT32 *pui32Scratch, *pui32AdjOffsets, *pui32AdjTriangles, *pui32LiveCount, *pui32Timestamps, *pui32DeadEnd;
+	IMG_UINT8 *pui8Emitted;
+	IMG_UINT32 ui32DeadEndTop = 0, ui32Cursor = 0, ui32Time, ui32Out = 0;
+	IMG_INT32 i32Fanning;
+	IMG_UINT32 i, j;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	for(i = 0; i < ui32NumIndices; i++)
+	{
+		if(pui16Src[i] >= ui32NumVertices)
+		{
+			ui32NumVertices = pui16Src[i] + 1U;
+		}
+	}
+
+	/* Adjacency offsets and lists, live counts, timestamps, dead-end stack and emitted flags */
+	pui32Scratch = GLES2Malloc(gc, (((ui32NumVertices + 1) + ui32NumIndices + 2 * ui32NumVertices + ui32NumIndices) * sizeof(IMG_UINT32)) +
+							   ui32NumTriangles);
+
+	if(!pui32Scratch)
+	{
+		return IMG_FALSE;
+	}
+
+	pui32AdjOffsets   = pui32Scratch;
+	pui32AdjTriangles = pui32AdjOffsets + ui32NumVertices + 1;
+	pui32LiveCount    = pui32AdjTriangles + ui32NumIndices;
+	pui32Timestamps   = pui32LiveCount + ui32NumVertices;
+	pui32DeadEnd      = pui32Timestamps + ui32NumVertices;
+	pui8Emitted       = (IMG_UINT8 *)(pui32DeadEnd + ui32NumIndices);
+
+	/* Build the vertex to triangle adjacency */
+	for(i = 0; i < ui32NumVertices; i++)
+	{
+		pui32LiveCount[i] = 0;
+		pui32Timestamps[i] = 0;
+	}
+
+	for(i = 0; i < ui32NumIndices; i++)
+	{
+		pui32LiveCount[pui16Src[i]]++;
+	}
+
+	pui32AdjOffsets[0] = 0;
+
+	for(i = 0; i < ui32NumVertices; i++)
+	{
+		pui32AdjOffsets[i + 1] = pui32AdjOffsets[i] + pui32LiveCount[i];
+	}
+
+	/* Use the timestamps as fill cursors while building the lists */
+	for(i = 0; i < ui32NumIndices; i++)
+	{
+		IMG_UINT32 ui32Vertex = pui16Src[i];
+
+		pui32AdjTriangles[pui32AdjOffsets[ui32Vertex] + pui32Timestamps[ui32Vertex]++] = i / 3;
+	}
+
+	for(i = 0; i < ui32NumVertices; i++)
+	{
+		pui32Timestamps[i] = 0;
+	}
+
+	for(i = 0; i < ui32NumTriangles; i++)
+	{
+		pui8Emitted[i] = 0;
+	}
+
+	ui32Time = GLES2_INDEX_OPTIMISER_CACHE_SIZE + 1;
+	i32Fanning = 0;
+
+	while(i32Fanning >= 0)
+	{
+		IMG_UINT32 ui32CandidateStart = ui32DeadEndTop;
+		IMG_INT32 i32BestPriority = -1;
+
+		/* Emit every remaining triangle around the fanning vertex */
+		for(j = pui32AdjOffsets[i32Fanning]; j < pui32AdjOffsets[i32Fanning + 1]; j++)
+		{
+			IMG_UINT32 ui32Triangle = pui32AdjTriangles[j];
+			IMG_UINT32 k;
+
+			if(pui8Emitted[ui32Triangle])
+			{
+				continue;
+			}
+
+			for(k = 0; k < 3; k++)
+			{
+				IMG_UINT32 ui32Vertex = pui16Src[ui32Triangle * 3 + k];
+
+				pui16Dst[ui32Out++] = (IMG_UINT16)ui32Vertex;
+				pui32DeadEnd[ui32DeadEndTop++] = ui32Vertex;
+				pui32LiveCount[ui32Vertex]--;
+
+				if((ui32Time - pui32Timestamps[ui32Vertex]) > GLES2_INDEX_OPTIMISER_CACHE_SIZE)
+				{
+					pui32Timestamps[ui32Vertex] = ui32Time++;
+				}
+			}
+
+			pui8Emitted[ui32Triangle] = 1;
+		}
+
+		/* The candidates are the vertices just pushed: prefer one still in cache with live triangles */
+		i32Fanning = -1;
+
+		for(j = ui32CandidateStart; j < ui32DeadEndTop; j++)
+		{
+			IMG_UINT32 ui32Vertex = pui32DeadEnd[j];
+
+			if(pui32LiveCount[ui32Vertex])
+			{
+				IMG_INT32 i32Priority = 0;
+
+				if((ui32Time - pui32Timestamps[ui32Vertex] + 2 * pui32LiveCount[ui32Vertex]) <= GLES2_INDEX_OPTIMISER_CACHE_SIZE)
+				{
+					i32Priority = (IMG_INT32)(ui32Time - pui32Timestamps[ui32Vertex]);
+				}
+
+				if(i32Priority > i32BestPriority)
+				{
+					i32BestPriority = i32Priority;
+					i32Fanning = (IMG_INT32)ui32Vertex;
+				}
+			}
+		}
+
+		if(i32Fanning < 0)
+		{
+			/* Dead end: back up through recently used vertices, then scan forward */
+			while(ui32DeadEndTop)
+			{
+				IMG_UINT32 ui32Vertex = pui32DeadEnd[--ui32DeadEndTop];
+
+				if(pui32LiveCount[ui32Vertex])
+				{
+					i32Fanning = (IMG_INT32)ui32Vertex;
+					break;
+				}
+			}
+
+			while((i32Fanning < 0) && (ui32Cursor < ui32NumVertices))
+			{
+				if(pui32LiveCount[ui32Cursor])
+				{
+					i32Fanning = (IMG_INT32)ui32Cursor;
+				}
+
+				ui32Cursor++;
+			}
+		}
+	}
+
+	GLES_ASSERT(ui32Out == ui32NumTriangles * 3);
+
+#if defined(DEBUG) || defined(TIMING)
+	PVR_DPF((PVR_DBG_MESSAGE, "ReorderIndicesForVertexCache: %u triangles, ACMR %f -> %f", ui32NumTriangles,
+			 ComputeACMR(pui16Src, ui32NumIndices, ui32NumVertices, pui32Timestamps),
+			 ComputeACMR(pui16Dst, ui32NumIndices, ui32NumVertices, pui32Timestamps)));
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+	GLES2Free(IMG_NULL, pui32Scratch);
+
+	return IMG_TRUE;
+}
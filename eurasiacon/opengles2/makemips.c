@@ -995,7 +995,7 @@ static IMG_BOOL HardwareMakeTextureMipmapLevels(GLES2Context *gc, GLES2Texture *
 				{
 					bHWTexUploaded = IMG_TRUE;
 					
-					GLES2FreeAsync(gc, psLevel->pui8Buffer);
+					TextureReleaseLevelBuffer(gc, psLevel);
 					
 					psLevel->pui8Buffer = GLES2_LOADED_LEVEL;
 				}
@@ -1095,7 +1095,7 @@ failed_hwmipgen:
 				/* The local data copy of the texture level is being freed */
 				if ((psLevel->pui8Buffer != IMG_NULL) && (psLevel->pui8Buffer != GLES2_LOADED_LEVEL)) 
 				{
-					GLES2FreeAsync(gc, psLevel->pui8Buffer);
+					TextureReleaseLevelBuffer(gc, psLevel);
 				}
 				
 				if (i == 0)
@@ -1247,7 +1247,7 @@ IMG_VOID MakeTextureMipmapLevelsSoftware(GLES2Context *gc, GLES2Texture *psTex,
 #if (defined(DEBUG) || defined(TIMING))
 					ui32TextureMemCurrent -= psDstLevel->ui32ImageSize;
 #endif
-					GLES2FreeAsync(gc, psDstLevel->pui8Buffer);
+					TextureReleaseLevelBuffer(gc, psDstLevel);
 				}
 				psDstLevel->pui8Buffer = IMG_NULL;
 			}
@@ -1362,7 +1362,7 @@ IMG_VOID MakeTextureMipmapLevelsSoftware(GLES2Context *gc, GLES2Texture *psTex,
 				/* Free memory if we read back the source level */
 				if (bWasSrcLevelReadBack)
 				{
-					GLES2FreeAsync(gc, psSrcLevel->pui8Buffer);
+					TextureReleaseLevelBuffer(gc, psSrcLevel);
 
 					psSrcLevel->pui8Buffer = GLES2_LOADED_LEVEL;
 				}
@@ -1458,6 +1458,7 @@ IMG_BOOL IMG_INTERNAL MakeTextureMipmapLevels(GLES2Context *gc, GLES2Texture *ps
 	/* HW mipmap gen is implemented */
 
 	if (!gc->sAppHints.bDisableHWTQMipGen &&
+		!psTex->psAutoETC1Format &&
 #if defined(GLES2_EXTENSION_NPOT)
 		!bIsNonPow2 &&
 #endif
@@ -1505,6 +1506,12 @@ IMG_BOOL IMG_INTERNAL MakeTextureMipmapLevels(GLES2Context *gc, GLES2Texture *ps
 	}
 		
 
+	/* Driver compressed ETC1 levels are filtered uncompressed and encoded again */
+	if (psTex->psAutoETC1Format)
+	{
+		return TextureAutoETC1MakeMipmaps(gc, psTex, ui32MaxFace);
+	}
+
 	/* SW mipmap gen is implemented, if HW mipmap gen failed. */
 
 	if (!bHWMipGen)
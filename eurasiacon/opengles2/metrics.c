@@ -330,9 +330,17 @@ IMG_INTERNAL IMG_VOID OutputMetrics(GLES2Context *gc)
 				PVR_TRACE(("   %s kick limit:     %10d/       -", pszBufferNames[ui32Loop], gc->apsBuffers[ui32Loop]->ui32KickCount/ui32Frames));
 			}
 		}
+		for(ui32Loop=0; ui32Loop<CBUF_NUM_BUFFERS ;ui32Loop++)
+		{
+			if(gc->apsBuffers[ui32Loop] && gc->apsBuffers[ui32Loop]->ui32TotalStallCount)
+			{
+				PVR_TRACE(("   %s stalls:         %10d/%10.4f", pszBufferNames[ui32Loop], gc->apsBuffers[ui32Loop]->ui32TotalStallCount/ui32Frames, gc->apsBuffers[ui32Loop]->ui32StallTimeInUs/(1000.0f*ui32Frames)));
+			}
+		}
 		PVR_TRACE(("   BindFramebuffer kick :               %10d/       -", gc->asTimes[GLES2_TIMER_SGXKICKTA_BINDFRAMEBUFFER_COUNT].ui32Count / ui32Frames));
 		PVR_TRACE(("   FlushAttachable kick :               %10d/       -", gc->asTimes[GLES2_TIMER_SGXKICKTA_FLUSHFRAMEBUFFER_COUNT].ui32Count / ui32Frames));
 		PVR_TRACE(("   BufferData kick :                    %10d/       -", gc->asTimes[GLES2_TIMER_SGXKICKTA_BUFDATA_COUNT].ui32Count / ui32Frames));
+		PVR_TRACE(("   BufferData rename :                  %10d/       -", gc->asTimes[GLES2_TIMER_BUFOBJ_RENAME_COUNT].ui32Count / ui32Frames));
 		PVR_TRACE((" Total Renders                          %10.4f/       -", (IMG_FLOAT)gc->asTimes[GLES2_TIMER_KICK_3D].ui32Count/ui32Frames));
 		PVR_TRACE((" Total Wait for 3D                      %10d/%10.4f", gc->asTimes[GLES2_TIMER_WAITING_FOR_3D_TIME].ui32Count/ui32Frames, gc->asTimes[GLES2_TIMER_WAITING_FOR_3D_TIME].ui32Total*gc->fCPUSpeed/ui32Frames));
 		PVR_TRACE((" Total Wait for TA                      %10d/%10.4f", gc->asTimes[GLES2_TIMER_WAITING_FOR_TA_TIME].ui32Count/ui32Frames, gc->asTimes[GLES2_TIMER_WAITING_FOR_TA_TIME].ui32Total*gc->fCPUSpeed/ui32Frames));
@@ -371,6 +379,8 @@ IMG_INTERNAL IMG_VOID OutputMetrics(GLES2Context *gc)
 		PVR_TRACE((" Total Code Heap operations             %10d/%10.4f", gc->asTimes[GLES2_TIMER_CODE_HEAP_TIME].ui32Count/ui32Frames, gc->asTimes[GLES2_TIMER_CODE_HEAP_TIME].ui32Total*gc->fCPUSpeed/ui32Frames));
 		PVR_TRACE((" Total Primitive Draw                   %10d/%10.4f", ui32TotalDrawCalls/ui32Frames, fTotalDrawTime/ui32Frames));
 		PVR_TRACE((" Total Vertex Data Copy                 %10d/%10.4f", gc->asTimes[GLES2_TIMER_VERTEX_DATA_COPY].ui32Count/ui32Frames, gc->asTimes[GLES2_TIMER_VERTEX_DATA_COPY].ui32Total*gc->fCPUSpeed/ui32Frames));
+		PVR_TRACE((" Total Vertices Copied                  %10d/%10.4f", gc->asTimes[GLES2_TIMER_VERTEX_DATA_VERTEX_COUNT].ui32Total/ui32Frames,
+			(gc->asTimes[GLES2_TIMER_VERTEX_DATA_COPY].ui32Total) ? (IMG_FLOAT)gc->asTimes[GLES2_TIMER_VERTEX_DATA_VERTEX_COUNT].ui32Total/(gc->asTimes[GLES2_TIMER_VERTEX_DATA_COPY].ui32Total*gc->fCPUSpeed) : 0.0f));
 		PVR_TRACE((" Total Index Data Generate/Copy         %10d/%10.4f", gc->asTimes[GLES2_TIMER_INDEX_DATA_GENERATE_COPY].ui32Count/ui32Frames, gc->asTimes[GLES2_TIMER_INDEX_DATA_GENERATE_COPY].ui32Total*gc->fCPUSpeed/ui32Frames));
 
 
@@ -395,6 +405,27 @@ IMG_INTERNAL IMG_VOID OutputMetrics(GLES2Context *gc)
 		PVR_TRACE((" PDS Variant hit/miss totals"));
 		PVR_TRACE((" PDSPixelShaderProgram - variant hit     %10d", gc->asTimes[GLES2_TIMER_PDSVARIANT_HIT_COUNT].ui32Count));
 		PVR_TRACE((" PDSPixelShaderProgram - variant miss    %10d", gc->asTimes[GLES2_TIMER_PDSVARIANT_MISS_COUNT].ui32Count));
+		PVR_TRACE((" PDSVertexShaderProgram - variant hit    %10d", gc->asTimes[GLES2_TIMER_PDSVERTEXVARIANT_HIT_COUNT].ui32Count));
+		PVR_TRACE((" PDSVertexShaderProgram - variant miss   %10d", gc->asTimes[GLES2_TIMER_PDSVERTEXVARIANT_MISS_COUNT].ui32Count));
+		PVR_TRACE((" MTEStateBlock - cache hit               %10d", gc->asTimes[GLES2_TIMER_MTESTATEBLOCK_HIT_COUNT].ui32Count));
+		PVR_TRACE((" MTEStateBlock - cache miss              %10d", gc->asTimes[GLES2_TIMER_MTESTATEBLOCK_MISS_COUNT].ui32Count));
+		PVR_TRACE((" Shader - fast tier compiles             %10d", gc->asTimes[GLES2_TIMER_SHADER_FAST_TIER_COUNT].ui32Count));
+		PVR_TRACE((" Shader - re-optimised hot swaps         %10d", gc->asTimes[GLES2_TIMER_SHADER_HOTSWAP_COUNT].ui32Count));
+		PVR_TRACE((" Shader - re-optimisations discarded     %10d", gc->asTimes[GLES2_TIMER_SHADER_REOPTIMISE_DISCARD_COUNT].ui32Count));
+		PVR_TRACE((" Shader - uniform specialised draws      %10d", gc->asTimes[GLES2_TIMER_SHADER_SPECIALISE_HIT_COUNT].ui32Count));
+		PVR_TRACE((" Shader - uniform specialisations        %10d", gc->asTimes[GLES2_TIMER_SHADER_SPECIALISE_COUNT].ui32Count));
+		PVR_TRACE((" Shader - specialisation fallbacks       %10d", gc->asTimes[GLES2_TIMER_SHADER_SPECIALISE_FALLBACK_COUNT].ui32Count));
+		PVR_TRACE((" Shader - specialisations discarded      %10d", gc->asTimes[GLES2_TIMER_SHADER_SPECIALISE_DISCARD_COUNT].ui32Count));
+		PVR_TRACE((" Shader - specialisations over budget    %10d", gc->asTimes[GLES2_TIMER_SHADER_SPECIALISE_BUDGET_COUNT].ui32Count));
+		PVR_TRACE((" Shader - link variants compiled         %10d", gc->asTimes[GLES2_TIMER_SHADER_LINK_VARIANT_COUNT].ui32Count));
+		PVR_TRACE((" Shader - link variant cache hits        %10d", gc->asTimes[GLES2_TIMER_SHADER_LINK_VARIANT_HIT_COUNT].ui32Count));
+		PVR_TRACE((" Shader - vertex outputs removed         %10d", gc->asTimes[GLES2_TIMER_SHADER_LINK_OUTPUTS_REMOVED_COUNT].ui32Count));
+		PVR_TRACE((" Shader - constant varyings folded       %10d", gc->asTimes[GLES2_TIMER_SHADER_LINK_VARYINGS_FOLDED_COUNT].ui32Count));
+		PVR_TRACE((" Shader - interned compiles              %10d", gc->asTimes[GLES2_TIMER_SHADER_INTERN_COUNT].ui32Count));
+		PVR_TRACE((" Shader - identical shaders shared       %10d", gc->asTimes[GLES2_TIMER_SHADER_INTERN_HIT_COUNT].ui32Count));
+		PVR_TRACE((" USE variant - prewarmed                 %10d", gc->asTimes[GLES2_TIMER_USEVARIANT_PREWARMED_COUNT].ui32Count));
+		PVR_TRACE((" USE variant - prewarm hit               %10d", gc->asTimes[GLES2_TIMER_USEVARIANT_PREWARM_HIT_COUNT].ui32Count));
+		PVR_TRACE((" USE variant - prewarm miss              %10d", gc->asTimes[GLES2_TIMER_USEVARIANT_PREWARM_MISS_COUNT].ui32Count));
 
 		PVR_TRACE((" "));
 
@@ -459,6 +490,19 @@ IMG_INTERNAL IMG_VOID OutputMetrics(GLES2Context *gc)
 
 		PVR_TRACE((" "));
 
+		PVR_TRACE((" Buffer High-Water Marks                     [  kB used/kB size         ]"));
+
+		for(ui32Loop=0; ui32Loop<CBUF_NUM_TA_BUFFERS ;ui32Loop++)
+		{
+			if(gc->apsBuffers[ui32Loop])
+			{
+				PVR_TRACE(("  %s                  %10.4f/%10.4f", pszBufferNames[ui32Loop], 
+						gc->apsBuffers[ui32Loop]->ui32HighWaterMarkInBytes/1024.0f, gc->apsBuffers[ui32Loop]->ui32BufferLimitInBytes/1024.0f));
+			}
+		}
+
+		PVR_TRACE((" "));
+
 		fkB = (IMG_FLOAT)gc->asTimes[GLES2_TIMER_USECODEHEAP_FRAG_COUNT].ui32Total;
 		fkB /= 256.0f;
 		PVR_TRACE(("  USE Codeheap - Fragment               %10.4f/%10.4f", fkB, fkB/ui32Frames ));
@@ -150,6 +150,38 @@ IMG_VOID GetFrameTime(GLES2Context *gc);
 #define GLES2_TIMER_SGXKICKTA_FLUSHFRAMEBUFFER_COUNT				93
 #define GLES2_TIMER_SGXKICKTA_BUFDATA_COUNT				94
 
+#define GLES2_TIMER_PDSVERTEXVARIANT_HIT_COUNT		95
+#define GLES2_TIMER_PDSVERTEXVARIANT_MISS_COUNT		96
+
+#define GLES2_TIMER_MTESTATEBLOCK_HIT_COUNT			97
+#define GLES2_TIMER_MTESTATEBLOCK_MISS_COUNT		98
+
+#define GLES2_TIMER_VERTEX_DATA_VERTEX_COUNT		99
+
+#define GLES2_TIMER_SHADER_FAST_TIER_COUNT			100
+#define GLES2_TIMER_SHADER_HOTSWAP_COUNT			101
+#define GLES2_TIMER_SHADER_REOPTIMISE_DISCARD_COUNT	102
+
+#define GLES2_TIMER_USEVARIANT_PREWARM_HIT_COUNT	103
+#define GLES2_TIMER_USEVARIANT_PREWARM_MISS_COUNT	104
+#define GLES2_TIMER_USEVARIANT_PREWARMED_COUNT		105
+
+#define GLES2_TIMER_BUFOBJ_RENAME_COUNT				106
+
+#define GLES2_TIMER_SHADER_SPECIALISE_HIT_COUNT			107
+#define GLES2_TIMER_SHADER_SPECIALISE_COUNT				108
+#define GLES2_TIMER_SHADER_SPECIALISE_FALLBACK_COUNT	109
+#define GLES2_TIMER_SHADER_SPECIALISE_DISCARD_COUNT		110
+#define GLES2_TIMER_SHADER_SPECIALISE_BUDGET_COUNT		111
+
+#define GLES2_TIMER_SHADER_LINK_VARIANT_COUNT			112
+#define GLES2_TIMER_SHADER_LINK_VARIANT_HIT_COUNT		113
+#define GLES2_TIMER_SHADER_LINK_OUTPUTS_REMOVED_COUNT	114
+#define GLES2_TIMER_SHADER_LINK_VARYINGS_FOLDED_COUNT	115
+
+#define GLES2_TIMER_SHADER_INTERN_COUNT				116
+#define GLES2_TIMER_SHADER_INTERN_HIT_COUNT			117
+
 /* entry point times */
 #define GLES2_TIMES_glActiveTexture					140
 #define GLES2_TIMES_glAttachShader					141
@@ -320,7 +352,9 @@ IMG_VOID GetFrameTime(GLES2Context *gc);
 
 #define GLES2_TIMES_glDiscardFramebufferEXT					300
 
-#define GLES2_NUM_TIMERS					(GLES2_TIMES_glDiscardFramebufferEXT + 1)
+#define GLES2_TIMES_glPrewarmProgramIMG						301
+
+#define GLES2_NUM_TIMERS					(GLES2_TIMES_glPrewarmProgramIMG + 1)
 
 
 #define GLES2_CALLS(X)				    PVR_MTR_CALLS(gc->asTimes[X])
@@ -82,6 +82,12 @@ static const IMG_UINT32 ui32ExtensionFlag = /*
 #endif
 #if defined(GLES2_EXTENSION_MULTISAMPLED_RENDER_TO_TEXTURE)
 											GLES2_EXTENSION_BIT_MULTISAMPLED_RENDER_TO_TEX |
+#endif
+#if defined(GLES2_EXTENSION_SHADER_PREWARM)
+											GLES2_EXTENSION_BIT_SHADER_PREWARM |
+#endif
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+											GLES2_EXTENSION_BIT_PIXEL_PACK_BUFFER |
 #endif
 											GLES2_EXTENSION_BIT_ELEMENT_INDEX_UINT |
 											GLES2_EXTENSION_BIT_MAPBUFFER |
@@ -134,6 +140,8 @@ static const struct GLES2_Extension_TAG
 	{	"GL_IMG_texture_format_BGRA8888 ",		GLES2_EXTENSION_BIT_TEXTURE_FORMAT_BGRA8888	},
 	{	"GL_IMG_read_format ",					GLES2_EXTENSION_BIT_READ_FORMAT				},
 	{	"GL_IMG_program_binary ",				GLES2_EXTENSION_BIT_GET_PROGRAM_BINARY		},
+	{	"GL_IMG_shader_prewarm ",				GLES2_EXTENSION_BIT_SHADER_PREWARM			},
+	{	"GL_IMG_pixel_pack_buffer ",			GLES2_EXTENSION_BIT_PIXEL_PACK_BUFFER		},
 	{	"GL_IMG_multisampled_render_to_texture",GLES2_EXTENSION_BIT_MULTISAMPLED_RENDER_TO_TEX	},
 };
 
@@ -616,6 +624,49 @@ IMG_INTERNAL IMG_BOOL GetApplicationHints(GLESAppHints *psAppHints, EGLcontextMo
 	ui32Default = 20*1024;
 	PVRSRVGetAppHint(pvHintState, "DefaultVDMBufferSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32DefaultVDMBufferSize);
 
+	ui32Default = 800*1024;
+	PVRSRVGetAppHint(pvHintState, "MaxIndexBufferSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32MaxIndexBufferSize);
+
+	ui32Default = 200*1024;
+	PVRSRVGetAppHint(pvHintState, "MaxPDSVertBufferSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32MaxPDSVertBufferSize);
+
+	ui32Default = 80*1024;
+	PVRSRVGetAppHint(pvHintState, "MaxVDMBufferSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32MaxVDMBufferSize);
+
+	/* Number of stalls per frame on a circular buffer before it is grown at the next swap, 0 to never grow.
+	 * Growth waits for the TA, so it stays off until it has been tuned against real stall patterns.
+	 */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "BufferStallGrowThreshold", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32BufferStallGrowThreshold);
+
+	/* Reorder GL_STATIC_DRAW triangle lists for vertex cache reuse; changes the order triangles are drawn in */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "OptimiseStaticIndexBuffers", IMG_UINT_TYPE, &ui32Default, &psAppHints->bOptimiseStaticIndexBuffers);
+
+	/* 0: full optimisation, 1: fast compile then re-optimise in the background, 2: fast compile only */
+	ui32Default = GLES2_SHADER_TIER_FULL;
+	PVRSRVGetAppHint(pvHintState, "ShaderCompileTier", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32ShaderCompileTier);
+
+	/* Finalise USE variants seen in earlier runs (or declared by the app) on a background thread */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "ShaderPrewarm", IMG_UINT_TYPE, &ui32Default, &psAppHints->bShaderPrewarm);
+
+	/* Draws a program's uniforms must stay unchanged for before a variant with their values folded in is compiled, 0 to disable */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "UniformSpecialisationDraws", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32UniformSpecialisationDraws);
+
+	/* Uniform specialised recompiles allowed per context */
+	ui32Default = 32;
+	PVRSRVGetAppHint(pvHintState, "UniformSpecialisationBudget", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32UniformSpecialisationBudget);
+
+	/* Recompile linked shaders without the varyings the fragment shader ignores, and with constant varyings folded in */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "OptimiseLinkedVaryings", IMG_UINT_TYPE, &ui32Default, &psAppHints->bOptimiseLinkedVaryings);
+
+	/* Shaders which preprocess to the same tokens share one compiled state within a share group */
+	ui32Default = 1;
+	PVRSRVGetAppHint(pvHintState, "ShareIdenticalShaders", IMG_UINT_TYPE, &ui32Default, &psAppHints->bShareIdenticalShaders);
+
 	ui32Default = 50*1024;
 	PVRSRVGetAppHint(pvHintState, "DefaultPregenMTECopyBufferSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32DefaultPregenMTECopyBufferSize);
 
@@ -734,6 +785,22 @@ IMG_INTERNAL IMG_BOOL GetApplicationHints(GLESAppHints *psAppHints, EGLcontextMo
 	ui32Default = 1;
 	PVRSRVGetAppHint(pvHintState, "DisableAsyncTextureOp", IMG_UINT_TYPE, &ui32Default, &psAppHints->bDisableAsyncTextureOp);
 
+	/* Levels at least this wide and high are uploaded on the SW texture op threads */
+	ui32Default = 128;
+	PVRSRVGetAppHint(pvHintState, "SwTexOpMinDimension", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32SwTexOpMinDimension);
+
+	/* Bytes of texture staging memory kept for reuse, 0 disables the pool */
+	ui32Default = 2 * 1024 * 1024;
+	PVRSRVGetAppHint(pvHintState, "TexStagingPoolSize", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32TexStagingPoolSize);
+
+	/* Compress eligible RGB888/RGB565 uploads to ETC1 in the driver */
+	ui32Default = 0;
+	PVRSRVGetAppHint(pvHintState, "TexAutoETC1", IMG_UINT_TYPE, &ui32Default, &psAppHints->bTexAutoETC1);
+
+	/* Smallest base level width and height compressed by TexAutoETC1 */
+	ui32Default = 64;
+	PVRSRVGetAppHint(pvHintState, "TexAutoETC1MinDimension", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32TexAutoETC1MinDimension);
+
 	ui32Default = 1000;
 	PVRSRVGetAppHint(pvHintState, "PrimitiveSplitThreshold", IMG_UINT_TYPE, &ui32Default, &psAppHints->ui32PrimitiveSplitThreshold);
 
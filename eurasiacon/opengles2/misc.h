@@ -50,9 +50,11 @@
 #define GLES2_EXTENSION_BIT_VERTEX_ARRAY_OBJECT         0x00800000
 #define GLES2_EXTENSION_BIT_DISCARD_FRAMEBUFFER         0x01000000
 #define GLES2_EXTENSION_BIT_EGL_SYNC                    0x02000000
+#define GLES2_EXTENSION_BIT_SHADER_PREWARM				0x04000000
 #define GLES2_EXTENSION_BIT_MULTISAMPLED_RENDER_TO_TEX	0x08000000
 #define GLES2_EXTENSION_BIT_SHADER_TEXTURE_LOD			0x10000000
 #define GLES2_EXTENSION_BIT_EGL_IMAGE_EXTERNAL			0x20000000
+#define GLES2_EXTENSION_BIT_PIXEL_PACK_BUFFER			0x40000000
 
 #define GLES2_HINT_OVERLOAD_TEX_LAYOUT_POW2_MASK		0x0000000F
 #define GLES2_HINT_OVERLOAD_TEX_LAYOUT_POW2_SHIFT		0
@@ -102,6 +104,17 @@ typedef struct GLESAppHintsRec
 	IMG_UINT32  ui32DefaultPDSVertBufferSize;
 	IMG_UINT32  ui32DefaultPregenMTECopyBufferSize;
 	IMG_UINT32  ui32DefaultVDMBufferSize;
+	IMG_UINT32  ui32MaxIndexBufferSize;
+	IMG_UINT32  ui32MaxPDSVertBufferSize;
+	IMG_UINT32  ui32MaxVDMBufferSize;
+	IMG_UINT32  ui32BufferStallGrowThreshold;
+	IMG_BOOL    bOptimiseStaticIndexBuffers;
+	IMG_UINT32  ui32ShaderCompileTier;
+	IMG_BOOL    bShaderPrewarm;
+	IMG_UINT32  ui32UniformSpecialisationDraws;
+	IMG_UINT32  ui32UniformSpecialisationBudget;
+	IMG_BOOL    bOptimiseLinkedVaryings;
+	IMG_BOOL    bShareIdenticalShaders;
 	IMG_BOOL    bStrictBinaryVersionComparison;
 	IMG_FLOAT   fPolygonUnitsMultiplier;
 	IMG_FLOAT   fPolygonFactorMultiplier;
@@ -149,6 +162,10 @@ typedef struct GLESAppHintsRec
 	IMG_UINT32 ui32SwTexOpMaxUltNum;
 	IMG_UINT32 ui32SwTexOpCleanupDelay;
 	IMG_BOOL bDisableAsyncTextureOp;
+	IMG_UINT32 ui32SwTexOpMinDimension;
+	IMG_UINT32 ui32TexStagingPoolSize;
+	IMG_BOOL bTexAutoETC1;
+	IMG_UINT32 ui32TexAutoETC1MinDimension;
 	IMG_UINT32 ui32PrimitiveSplitThreshold;
 	IMG_UINT32 ui32MaxDrawCallsPerCore;
 	IMG_UINT32 ui32GLSLEnabledWarnings;
@@ -29,6 +29,7 @@ typedef struct GLES2Context_TAG GLES2Context;
 typedef struct GLES2ProgramRec GLES2Program;
 typedef struct GLES2USEShaderVariant_TAG GLES2USEShaderVariant;
 typedef struct GLES2PDSCodeVariant_TAG GLES2PDSCodeVariant;
+typedef struct GLES2PDSVertexCodeVariant_TAG GLES2PDSVertexCodeVariant;
 typedef struct GLES2ProgramShaderRec GLES2ProgramShader;
 
 typedef enum GLES2_MEMERROR_TAG
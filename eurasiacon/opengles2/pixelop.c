@@ -720,7 +720,7 @@ static IMG_UINT32 BytesPerElement(GLenum type)
  Description        : UTILITY: Return the number of bytes per element, based on the 
 					  element type
 ************************************************************************************/
-static IMG_UINT32 BytesPerPixel(PVRSRV_PIXEL_FORMAT ePixelFormat)
+IMG_INTERNAL IMG_UINT32 BytesPerPixel(PVRSRV_PIXEL_FORMAT ePixelFormat)
 {
 	switch(ePixelFormat) 
 	{
@@ -839,6 +839,38 @@ IMG_INTERNAL IMG_BOOL SetupReadPixelsSpanInfo(GLES2Context *gc, GLES2PixelSpanIn
 	return IMG_TRUE;
 }
 
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+
+/***********************************************************************************
+ Function Name      : GetPackedImageSize
+ Inputs             : gc, ui32Width, ui32Height, format, type
+ Outputs            : -
+ Returns            : Number of bytes glReadPixels writes
+ Description        : UTILITY: Returns the size of a packed image, honouring the pack
+					  alignment for all but the last row.
+************************************************************************************/
+static IMG_UINT32 GetPackedImageSize(GLES2Context *gc, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height,
+									 GLenum format, GLenum type)
+{
+	IMG_UINT32 ui32Alignment, ui32GroupSize, ui32RowSize, ui32Padding;
+
+	ui32Alignment = gc->sState.sClientPixel.ui32PackAlignment;
+	ui32GroupSize = BytesPerElement(type) * ElementsPerGroup(format, type);
+	ui32RowSize = ui32Width * ui32GroupSize;
+
+	ui32Padding = ui32RowSize % ui32Alignment;
+
+	if(ui32Padding)
+	{
+		ui32RowSize += ui32Alignment - ui32Padding;
+	}
+
+	return ((ui32Height - 1) * ui32RowSize) + (ui32Width * ui32GroupSize);
+}
+
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
+
 //#define READPIXELS_OPTIMISATION 1
 
 /***********************************************************************************
@@ -858,6 +890,10 @@ GL_APICALL void GL_APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsize
 	EGLDrawableParams *psReadParams;
 	IMG_VOID *pvSurfacePointer;
 	IMG_UINT32 i;
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	GLES2BufferObject *psPackBuffer;
+	IMG_UINT32 ui32PackOffset = 0;
+#endif
 
 	__GLES2_GET_CONTEXT();
 
@@ -909,6 +945,30 @@ GL_APICALL void GL_APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsize
 		return;
 	}
 
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	psPackBuffer = gc->sBufferObject.psActiveBuffer[PIXEL_PACK_BUFFER_INDEX];
+
+	/* With a pack buffer bound, pixels is an offset into it */
+	if(psPackBuffer)
+	{
+		IMG_UINT32 ui32ImageSize;
+
+		ui32PackOffset = (IMG_UINT32)GLES2_BUFFER_OFFSET(pixels);
+		ui32ImageSize = GetPackedImageSize(gc, (IMG_UINT32)width, (IMG_UINT32)height, format, type);
+
+		if(psPackBuffer->bMapped || !psPackBuffer->psMemInfo ||
+		   (ui32PackOffset > psPackBuffer->ui32BufferSize) ||
+		   (ui32ImageSize > psPackBuffer->ui32BufferSize - ui32PackOffset))
+		{
+			SetError(gc, GL_INVALID_OPERATION);
+
+			GLES2_TIME_STOP(GLES2_TIMES_glReadPixels);
+
+			return;
+		}
+	}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
+
 	if(!SetupReadPixelsSpanInfo(gc, &sSpanInfo, x, y, (IMG_UINT32)width, (IMG_UINT32)height,
 								format, type, IMG_TRUE, psReadParams))
 	{
@@ -917,6 +977,40 @@ GL_APICALL void GL_APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsize
 		return;
 	}
 
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	if(psPackBuffer)
+	{
+		/* Queue a blit and return without waiting for the render */
+		if(QueuePackBufferReadback(gc, psPackBuffer, ui32PackOffset, &sSpanInfo, pfnSpanPack))
+		{
+			GLES2_INC_PIXEL_COUNT(GLES2_TIMES_glReadPixels, sSpanInfo.ui32Width * sSpanInfo.ui32Height);
+
+			GLES2_TIME_STOP(GLES2_TIMES_glReadPixels);
+
+			return;
+		}
+
+		/* Otherwise read synchronously, after any earlier reads into the same buffer */
+		if(!ResolvePackBufferReadbacks(gc, psPackBuffer) || !WaitUntilBufObjNotUsed(gc, psPackBuffer))
+		{
+			SetError(gc, GL_OUT_OF_MEMORY);
+
+			GLES2_TIME_STOP(GLES2_TIMES_glReadPixels);
+
+			return;
+		}
+
+		pixels = (IMG_VOID *)((IMG_UINT8 *)psPackBuffer->psMemInfo->pvLinAddr + ui32PackOffset);
+
+		/* The buffer may also be an index source */
+		FreeOptimisedIndices(gc, psPackBuffer);
+
+#if defined(PDUMP)
+		psPackBuffer->bDumped = IMG_FALSE;
+#endif
+	}
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
+
 #if defined(READPIXELS_OPTIMISATION)
 
 	/* Wait for any possible outstanding renders to complete if we're not in frame */
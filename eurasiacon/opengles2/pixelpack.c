@@ -0,0 +1,514 @@
+/******************************************************************************
+ * Name         : pixelpack.c
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Asynchronous glReadPixels into pixel pack buffer objects
+ *
+ * Platform     : ANSI
+ *
+ * $Log: pixelpack.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+#define ISALIGNED(V, A) (((V) & ((1UL << (A)) - 1)) == 0)
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+
+/* A glReadPixels into a pixel pack buffer whose blit may still be in flight */
+typedef struct GLES2PackReadbackRec
+{
+	struct GLES2PackReadbackRec *psNext;
+
+	/* Linear copy of the read rectangle, in the surface's format and row order */
+	PVRSRV_CLIENT_MEM_INFO *psStagingMemInfo;
+	IMG_UINT32 ui32StagingStride;
+
+	/* The surface isn't Y flipped, so the first staging row is the last GL row */
+	IMG_BOOL bBottomUp;
+
+	/* How the pixels are packed into the buffer once the blit has landed */
+	GLES2PixelSpanInfo sSpanInfo;
+	PFNSpanPack pfnSpanPack;
+	IMG_UINT32 ui32DstOffset;
+
+} GLES2PackReadback;
+
+
+/***********************************************************************************
+ Function Name      : WaitForPackReadback
+ Inputs             : gc, psReadback
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Waits on the staging memory's sync object for the
+					  readback blit to complete.
+************************************************************************************/
+static IMG_VOID WaitForPackReadback(GLES2Context *gc, const GLES2PackReadback *psReadback)
+{
+	PVRSRV_CLIENT_SYNC_INFO *psSyncInfo = psReadback->psStagingMemInfo->psClientSyncInfo;
+
+	if(psSyncInfo)
+	{
+#if defined(PDUMP)
+		PVRSRVPDumpSyncPol(gc->ps3DDevData->psConnection,
+						   psSyncInfo,
+						   IMG_FALSE,
+						   psSyncInfo->psSyncData->ui32WriteOpsPending,
+						   0xFFFFFFFF);
+#endif /* defined(PDUMP) */
+
+		while(SGX2DQueryBlitsComplete(&gc->psSysContext->s3D, psSyncInfo, IMG_TRUE) != PVRSRV_OK)
+		{
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ConvertPackReadback
+ Inputs             : psBufObj, psReadback
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Packs a completed readback from its staging copy into
+					  the buffer, in the format and type glReadPixels was called with.
+************************************************************************************/
+static IMG_VOID ConvertPackReadback(GLES2BufferObject *psBufObj, const GLES2PackReadback *psReadback)
+{
+	GLES2PixelSpanInfo sSpanInfo = psReadback->sSpanInfo;
+	IMG_UINT8 *pui8Staging = (IMG_UINT8 *)psReadback->psStagingMemInfo->pvLinAddr;
+	IMG_UINT32 i;
+
+	sSpanInfo.pvOutData = (IMG_VOID *)((IMG_UINT8 *)psBufObj->psMemInfo->pvLinAddr + psReadback->ui32DstOffset +
+									   sSpanInfo.ui32DstSkipLines * sSpanInfo.ui32DstRowIncrement +
+									   sSpanInfo.ui32DstSkipPixels * sSpanInfo.ui32DstGroupIncrement);
+
+	if(psReadback->bBottomUp)
+	{
+		sSpanInfo.pvInData = (IMG_VOID *)(pui8Staging + (sSpanInfo.ui32Height - 1) * psReadback->ui32StagingStride);
+		sSpanInfo.i32SrcRowIncrement = -(IMG_INT32)psReadback->ui32StagingStride;
+	}
+	else
+	{
+		sSpanInfo.pvInData = (IMG_VOID *)pui8Staging;
+		sSpanInfo.i32SrcRowIncrement = (IMG_INT32)psReadback->ui32StagingStride;
+	}
+
+	for (i=0; i<sSpanInfo.ui32Height; i++)
+	{
+		(*psReadback->pfnSpanPack)(&sSpanInfo);
+
+		sSpanInfo.pvOutData = (IMG_VOID *) ((IMG_UINT8 *)sSpanInfo.pvOutData + sSpanInfo.ui32DstRowIncrement);
+
+		sSpanInfo.pvInData  = (IMG_VOID *) ((IMG_UINT8 *)sSpanInfo.pvInData  + sSpanInfo.i32SrcRowIncrement);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : FreePackReadback
+ Inputs             : gc, psReadback
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Frees a readback whose blit has completed
+************************************************************************************/
+static IMG_VOID FreePackReadback(GLES2Context *gc, GLES2PackReadback *psReadback)
+{
+	GLES2FREEDEVICEMEM_HEAP(gc, psReadback->psStagingMemInfo);
+
+	GLES2Free(IMG_NULL, psReadback);
+}
+
+
+/***********************************************************************************
+ Function Name      : ResolvePackBufferReadbacks
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : Success
+ Description        : Waits for the buffer's outstanding readbacks and converts their
+					  pixels into it, oldest first. Called before the buffer's
+					  contents are read or overwritten by anything else.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL ResolvePackBufferReadbacks(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	GLES2PackReadback *psReadback;
+
+	if(!psBufObj->psPackReadbacks)
+	{
+		return IMG_TRUE;
+	}
+
+	/* The buffer may still be a vertex source for a TA that hasn't run */
+	if(!WaitUntilBufObjNotUsed(gc, psBufObj))
+	{
+		return IMG_FALSE;
+	}
+
+	while(psBufObj->psPackReadbacks)
+	{
+		psReadback = psBufObj->psPackReadbacks;
+		psBufObj->psPackReadbacks = psReadback->psNext;
+
+		WaitForPackReadback(gc, psReadback);
+
+		ConvertPackReadback(psBufObj, psReadback);
+
+		FreePackReadback(gc, psReadback);
+	}
+
+	/* Any vertex cache optimised copy was built from the old indices */
+	FreeOptimisedIndices(gc, psBufObj);
+
+#if defined(PDUMP)
+	psBufObj->bDumped = IMG_FALSE;
+#endif
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : DiscardPackBufferReadbacks
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : -
+ Description        : Drops the buffer's outstanding readbacks without converting
+					  them, once the hardware has finished writing their staging copies.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DiscardPackBufferReadbacks(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	GLES2PackReadback *psReadback;
+
+	while(psBufObj->psPackReadbacks)
+	{
+		psReadback = psBufObj->psPackReadbacks;
+		psBufObj->psPackReadbacks = psReadback->psNext;
+
+		WaitForPackReadback(gc, psReadback);
+
+		FreePackReadback(gc, psReadback);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : QueuePackBufferReadback
+ Inputs             : gc, psBufObj, ui32DstOffset, psSpanInfo, pfnSpanPack
+ Outputs            : -
+ Returns            : IMG_TRUE if the read was queued
+ Description        : UTILITY: Kicks the render and queues a transfer blit of the
+					  read rectangle into linear staging memory, without waiting
+					  for either. Conversion into the buffer is deferred until the
+					  contents are needed. Returns IMG_FALSE if the transfer queue
+					  can't do the copy, in which case nothing has been kicked.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL QueuePackBufferReadback(GLES2Context *gc, GLES2BufferObject *psBufObj, IMG_UINT32 ui32DstOffset,
+											  const GLES2PixelSpanInfo *psSpanInfo, PFNSpanPack pfnSpanPack)
+{
+	EGLDrawableParams *psReadParams = gc->psReadParams;
+	PVRSRV_CLIENT_MEM_INFO *psStagingMemInfo;
+	GLES2PackReadback *psReadback, **ppsTail;
+	SGX_QUEUETRANSFER sQueueTransfer;
+	SGXTQ_MEMLAYOUT eSrcMemLayout;
+	IMG_UINT32 ui32BytesPerPixel, ui32SrcWidth, ui32SrcHeight, ui32StagingStride;
+	IMG_INT32 i32SrcStrideInBytes, i32SrcRectX0, i32SrcRectY0;
+	PVRSRV_ERROR eError;
+
+#if defined(FIX_HW_BRN_27298)
+	return IMG_FALSE;
+#endif
+
+	if(gc->sAppHints.bDisableHWTQNormalBlit)
+	{
+		return IMG_FALSE;
+	}
+
+	/* The blit copies without format conversion; SpanPack does that at map time */
+	switch(psReadParams->ePixelFormat)
+	{
+		case PVRSRV_PIXEL_FORMAT_RGB565:
+		case PVRSRV_PIXEL_FORMAT_ARGB4444:
+		case PVRSRV_PIXEL_FORMAT_ARGB1555:
+		case PVRSRV_PIXEL_FORMAT_ARGB8888:
+		case PVRSRV_PIXEL_FORMAT_ABGR8888:
+		{
+			break;
+		}
+		default:
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	ui32BytesPerPixel = BytesPerPixel(psReadParams->ePixelFormat);
+
+	i32SrcRectX0 = psSpanInfo->i32ReadX;
+
+	switch(psReadParams->eRotationAngle)
+	{
+		case PVRSRV_ROTATE_0:
+		{
+			/* SetupReadPixelsSpanInfo has rebased i32ReadY on the last row in memory */
+			i32SrcRectY0 = 1 - psSpanInfo->i32ReadY - (IMG_INT32)psSpanInfo->ui32Height;
+
+			break;
+		}
+		case PVRSRV_FLIP_Y:
+		{
+			i32SrcRectY0 = psSpanInfo->i32ReadY;
+
+			break;
+		}
+		default:
+		{
+			/* Rotated surfaces are read synchronously */
+			return IMG_FALSE;
+		}
+	}
+
+	ui32SrcWidth  = psReadParams->ui32Width;
+	ui32SrcHeight = psReadParams->ui32Height;
+
+	switch(GetColorAttachmentMemFormat(gc, gc->sFrameBuffer.psActiveFrameBuffer))
+	{
+		case IMG_MEMLAYOUT_STRIDED:
+		{
+			eSrcMemLayout = SGXTQ_MEMLAYOUT_STRIDE;
+
+#if EURASIA_TAG_STRIDE_THRESHOLD
+			if (ui32SrcWidth < EURASIA_TAG_STRIDE_THRESHOLD)
+			{
+			    ui32SrcWidth = ALIGNCOUNT(ui32SrcWidth, EURASIA_TAG_STRIDE_ALIGN0);
+			}
+			else
+#endif
+			{
+				ui32SrcWidth = ALIGNCOUNT(ui32SrcWidth, EURASIA_TAG_STRIDE_ALIGN1);
+			}
+
+			i32SrcStrideInBytes = (IMG_INT32)psReadParams->ui32Stride;
+
+#if defined(SGX_FEATURE_TEXTURESTRIDE_EXTENSION) && !defined(FIX_HW_BRN_26518) && !defined(FIX_HW_BRN_27408)
+			if (psReadParams->ui32Stride & 3)
+			{
+				return IMG_FALSE;
+			}
+#endif
+			break;
+		}
+		case IMG_MEMLAYOUT_TILED:
+		{
+			eSrcMemLayout = SGXTQ_MEMLAYOUT_TILED;
+
+			ui32SrcWidth  = ALIGNCOUNT(ui32SrcWidth, EURASIA_TAG_TILE_SIZEX);
+			ui32SrcHeight = ALIGNCOUNT(ui32SrcHeight, EURASIA_TAG_TILE_SIZEY);
+
+			i32SrcStrideInBytes = (IMG_INT32)psReadParams->ui32Stride;
+
+			break;
+		}
+#if defined(SGX_FEATURE_HYBRID_TWIDDLING)
+		case IMG_MEMLAYOUT_HYBRIDTWIDDLED:
+		{
+			return IMG_FALSE;
+		}
+#else /* defined(SGX_FEATURE_HYBRID_TWIDDLING) */
+		case IMG_MEMLAYOUT_TWIDDLED:
+#endif /* defined(SGX_FEATURE_HYBRID_TWIDDLING) */
+		default:
+		{
+			eSrcMemLayout = SGXTQ_MEMLAYOUT_2D;
+
+			i32SrcStrideInBytes = 0;
+
+			break;
+		}
+	}
+
+	ui32StagingStride = ALIGNCOUNT(psSpanInfo->ui32Width, EURASIA_TAG_STRIDE_ALIGN1) * ui32BytesPerPixel;
+
+	if(!ISALIGNED(ui32StagingStride, EURASIA_PIXELBE_LINESTRIDE_ALIGNSHIFT)
+#if !defined(SGX_FEATURE_UNIFIED_STORE_64BITS) && defined(FIX_HW_BRN_23054)
+	   || (psSpanInfo->ui32Width < 3) || (psSpanInfo->ui32Height < 3)
+#endif
+	  )
+	{
+		return IMG_FALSE;
+	}
+
+	/* Uncached rather than GC mapped, as the CPU reads it back */
+	eError = GLES2ALLOCDEVICEMEM_HEAP(gc,
+		PVRSRV_MEM_READ | PVRSRV_MEM_WRITE,
+		ui32StagingStride * psSpanInfo->ui32Height,
+		EURASIA_CACHE_LINE_SIZE,
+		&psStagingMemInfo);
+
+	if(eError != PVRSRV_OK)
+	{
+		return IMG_FALSE;
+	}
+
+	psReadback = GLES2Calloc(gc, sizeof(GLES2PackReadback));
+
+	if(!psReadback)
+	{
+		GLES2FREEDEVICEMEM_HEAP(gc, psStagingMemInfo);
+
+		return IMG_FALSE;
+	}
+
+	/* Kick the render without waiting; the blit is ordered after it by the surface's sync object */
+	if(ScheduleTA(gc, psReadParams->psRenderSurface, GLES2_SCHEDULE_HW_MIDSCENE_RENDER | GLES2_SCHEDULE_HW_LAST_IN_SCENE) != IMG_EGL_NO_ERROR)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"QueuePackBufferReadback: Couldn't flush HW"));
+
+		goto FAILED_Queue;
+	}
+
+	GLES2MemSet(&sQueueTransfer, 0, sizeof(SGX_QUEUETRANSFER));
+
+	sQueueTransfer.eType = SGXTQ_BLIT;
+
+	sQueueTransfer.Details.sBlit.eFilter             = SGXTQ_FILTERTYPE_POINT;
+	sQueueTransfer.Details.sBlit.eColourKey          = SGXTQ_COLOURKEY_NONE;
+	sQueueTransfer.Details.sBlit.ui32ColourKey       = 0;
+	sQueueTransfer.Details.sBlit.ui32ColourKeyMask   = 0;
+	sQueueTransfer.Details.sBlit.bEnableGamma        = IMG_FALSE;
+	sQueueTransfer.Details.sBlit.eAlpha              = SGXTQ_ALPHA_NONE;
+	sQueueTransfer.Details.sBlit.byGlobalAlpha       = 0;
+	sQueueTransfer.Details.sBlit.byCustomRop3        = 0;
+	sQueueTransfer.Details.sBlit.sUSEExecAddr.uiAddr = 0;
+	sQueueTransfer.Details.sBlit.bEnablePattern      = IMG_FALSE;
+	sQueueTransfer.Details.sBlit.bSingleSource       = IMG_TRUE;
+	sQueueTransfer.Details.sBlit.eRotation           = SGXTQ_ROTATION_NONE;
+
+	/* Rows are copied in memory order; the row direction is sorted out when packing */
+	sQueueTransfer.ui32Flags = SGX_KICKTRANSFER_FLAGS_3DTQ_SYNC;
+
+	sQueueTransfer.ui32NumSources = 1;
+	sQueueTransfer.asSources[0].sDevVAddr.uiAddr = psReadParams->ui32HWSurfaceAddress;
+	sQueueTransfer.asSources[0].ui32Width        = ui32SrcWidth;
+	sQueueTransfer.asSources[0].ui32Height       = ui32SrcHeight;
+	sQueueTransfer.asSources[0].eFormat          = psReadParams->ePixelFormat;
+	sQueueTransfer.asSources[0].i32StrideInBytes = i32SrcStrideInBytes;
+	sQueueTransfer.asSources[0].ui32ChunkStride  = 0;
+	sQueueTransfer.asSources[0].eMemLayout       = eSrcMemLayout;
+	sQueueTransfer.asSources[0].psSyncInfo       = psReadParams->psSyncInfo;
+
+	sQueueTransfer.ui32NumDest = 1;
+	sQueueTransfer.asDests[0].sDevVAddr.uiAddr = psStagingMemInfo->sDevVAddr.uiAddr;
+	sQueueTransfer.asDests[0].ui32Width        = ui32StagingStride / ui32BytesPerPixel;
+	sQueueTransfer.asDests[0].ui32Height       = psSpanInfo->ui32Height;
+	sQueueTransfer.asDests[0].eFormat          = psReadParams->ePixelFormat;
+	sQueueTransfer.asDests[0].i32StrideInBytes = (IMG_INT32)ui32StagingStride;
+	sQueueTransfer.asDests[0].ui32ChunkStride  = 0;
+	sQueueTransfer.asDests[0].eMemLayout       = SGXTQ_MEMLAYOUT_OUT_LINEAR;
+	sQueueTransfer.asDests[0].psSyncInfo       = psStagingMemInfo->psClientSyncInfo;
+
+	sQueueTransfer.ui32NumSrcRects = 1;
+	sQueueTransfer.asSrcRects[0].x0 = i32SrcRectX0;
+	sQueueTransfer.asSrcRects[0].y0 = i32SrcRectY0;
+	sQueueTransfer.asSrcRects[0].x1 = i32SrcRectX0 + (IMG_INT32)psSpanInfo->ui32Width;
+	sQueueTransfer.asSrcRects[0].y1 = i32SrcRectY0 + (IMG_INT32)psSpanInfo->ui32Height;
+
+	sQueueTransfer.ui32NumDestRects = 1;
+	sQueueTransfer.asDestRects[0].x0 = 0;
+	sQueueTransfer.asDestRects[0].y0 = 0;
+	sQueueTransfer.asDestRects[0].x1 = (IMG_INT32)psSpanInfo->ui32Width;
+	sQueueTransfer.asDestRects[0].y1 = (IMG_INT32)psSpanInfo->ui32Height;
+
+	sQueueTransfer.ui32NumStatusValues = 0;
+	sQueueTransfer.bPDumpContinuous = IMG_TRUE;
+
+	eError = SGXQueueTransfer(&gc->psSysContext->s3D, gc->psSysContext->hTransferContext, &sQueueTransfer);
+
+	if(eError != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "QueuePackBufferReadback: Failed to queue readback blit (error=%d). Falling back to SW", eError));
+
+		goto FAILED_Queue;
+	}
+
+	psReadback->psStagingMemInfo  = psStagingMemInfo;
+	psReadback->ui32StagingStride = ui32StagingStride;
+	psReadback->bBottomUp         = (psReadParams->eRotationAngle == PVRSRV_ROTATE_0) ? IMG_TRUE : IMG_FALSE;
+	psReadback->sSpanInfo         = *psSpanInfo;
+	psReadback->pfnSpanPack       = pfnSpanPack;
+	psReadback->ui32DstOffset     = ui32DstOffset;
+
+	/* Append, so overlapping reads land in the order they were issued */
+	ppsTail = &psBufObj->psPackReadbacks;
+
+	while(*ppsTail)
+	{
+		ppsTail = &(*ppsTail)->psNext;
+	}
+
+	*ppsTail = psReadback;
+
+	/* VAOs in every sharing context must resolve before their next draw reads the buffer */
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	gc->psSharedState->ui32PackReadbackStamp++;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	return IMG_TRUE;
+
+FAILED_Queue:
+
+	GLES2Free(IMG_NULL, psReadback);
+
+	GLES2FREEDEVICEMEM_HEAP(gc, psStagingMemInfo);
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : ResolveVAOPackReadbacks
+ Inputs             : gc, psVAO
+ Outputs            : -
+ Returns            : -
+ Description        : Resolves the outstanding readbacks of every buffer object a
+					  VAO sources attributes or indices from. Called from
+					  ValidateState before the TA can fetch from them, as a buffer
+					  may be read into after it was attached to the VAO.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ResolveVAOPackReadbacks(GLES2Context *gc, GLES2VertexArrayObject *psVAO)
+{
+	GLES2BufferObject *psBufObj;
+	IMG_UINT32 i;
+
+	for(i = 0; i < GLES2_MAX_VERTEX_ATTRIBS; i++)
+	{
+		psBufObj = psVAO->asVAOState[i].psBufObj;
+
+		if(psBufObj && psBufObj->psPackReadbacks && !ResolvePackBufferReadbacks(gc, psBufObj))
+		{
+			PVR_DPF((PVR_DBG_ERROR,"ResolveVAOPackReadbacks: Couldn't resolve attribute %u readbacks", i));
+		}
+	}
+
+	psBufObj = psVAO->psBoundElementBuffer;
+
+	if(psBufObj && psBufObj->psPackReadbacks && !ResolvePackBufferReadbacks(gc, psBufObj))
+	{
+		PVR_DPF((PVR_DBG_ERROR,"ResolveVAOPackReadbacks: Couldn't resolve element buffer readbacks"));
+	}
+}
+
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
+
+/******************************************************************************
+ End of file (pixelpack.c)
+******************************************************************************/
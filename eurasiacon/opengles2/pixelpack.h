@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Name         : pixelpack.h
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * $Log: pixelpack.h $
+ *****************************************************************************/
+
+#ifndef _PIXELPACK_
+#define _PIXELPACK_
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+
+#include "spanpack.h"
+
+IMG_BOOL QueuePackBufferReadback(GLES2Context *gc, GLES2BufferObject *psBufObj, IMG_UINT32 ui32DstOffset,
+								 const GLES2PixelSpanInfo *psSpanInfo, PFNSpanPack pfnSpanPack);
+
+IMG_BOOL ResolvePackBufferReadbacks(GLES2Context *gc, GLES2BufferObject *psBufObj);
+
+IMG_VOID DiscardPackBufferReadbacks(GLES2Context *gc, GLES2BufferObject *psBufObj);
+
+IMG_VOID ResolveVAOPackReadbacks(GLES2Context *gc, GLES2VertexArrayObject *psVAO);
+
+#endif /* defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER) */
+
+#endif /* _PIXELPACK_ */
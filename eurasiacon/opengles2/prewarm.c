@@ -0,0 +1,1429 @@
+/******************************************************************************
+ * Name         : prewarm.c
+ *
+ * Copyright    : 2005-2011 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * Description	: Prewarming of USE shader variants (ShaderPrewarm apphint and
+ *				  GL_IMG_shader_prewarm).
+ *
+ *				  Every USE variant starts as a UniPatch finalisation of the
+ *				  shader for the texture formats bound at the first draw that
+ *				  needs it. The keys a shader is drawn with are recorded in the
+ *				  blob cache, and the next time the shader is linked they are
+ *				  finalised on a background thread so the draw only has to
+ *				  pick the result up. Apps can also declare the formats they
+ *				  will use through glPrewarmProgramIMG.
+ *
+ *				  Finalisation of shared shaders is serialised by the share
+ *				  group's hUniPatchFinaliseLock, which also covers the prewarm
+ *				  UniPatch context. The prewarmed shader caches, the recorded
+ *				  keys and the job lists are protected by hUniPatchLock, which
+ *				  is only held for short updates so draws that hit the cache
+ *				  never wait for the worker.
+ *
+ * Modifications:-
+ * $Log: prewarm.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+#define GLES2_PREWARM_RECORD_VERSION	1
+
+#define GLES2_PREWARM_BLOB_KEY_LENGTH	(DIGEST_STRING_LENGTH + 10)
+
+/* Blob cache record of the keys a shader was drawn with */
+typedef struct GLES2PrewarmRecordHeaderRec
+{
+	IMG_UINT32	ui32Version;
+
+	/* Size of the format table the indices below refer to */
+	IMG_UINT32	ui32NumTexFormats;
+
+	IMG_UINT32	ui32NumKeys;
+
+} GLES2PrewarmRecordHeader;
+
+typedef struct GLES2PrewarmRecordKeyRec
+{
+	IMG_UINT32	ui32ImageUnitEnables;
+
+	/* Index into asPrewarmTexFormats for each enabled unit */
+	IMG_UINT8	aui8TexFormat[GLES2_MAX_TEXTURE_UNITS];
+
+	IMG_UINT8	ui8OutputLocation;
+	IMG_UINT8	ui8PreambleCount;
+	IMG_UINT8	ui8Flags;
+	IMG_UINT8	ui8Pad;
+
+} GLES2PrewarmRecordKey;
+
+/* Formats that can be stored in a record. Only append to this table */
+static const GLES2TextureFormat * const apsPrewarmTexFormats[] =
+{
+	&TexFormatABGR8888,
+	&TexFormatARGB1555,
+	&TexFormatARGB4444,
+	&TexFormatXBGR8888,
+	&TexFormatXRGB8888,
+	&TexFormatRGB565,
+	&TexFormatAlpha,
+	&TexFormatLuminance,
+	&TexFormatLuminanceAlpha,
+	&TexFormatPVRTC2RGB,
+	&TexFormatPVRTC4RGB,
+	&TexFormatPVRTC2RGBA,
+	&TexFormatPVRTC4RGBA,
+	&TexFormatPVRTCII2RGB,
+	&TexFormatPVRTCII4RGB,
+	&TexFormatPVRTCII2RGBA,
+	&TexFormatPVRTCII4RGBA,
+	&TexFormatETC1RGB,
+	&TexFormatRGBAFloat,
+	&TexFormatRGBAHalfFloat,
+	&TexFormatRGBFloat,
+	&TexFormatRGBHalfFloat,
+	&TexFormatFloatAlpha,
+	&TexFormatHalfFloatAlpha,
+	&TexFormatFloatLuminance,
+	&TexFormatHalfFloatLuminance,
+	&TexFormatFloatLuminanceAlpha,
+	&TexFormatHalfFloatLuminanceAlpha,
+	&TexFormatARGB8888,
+#if defined(GLES2_EXTENSION_DEPTH_TEXTURE)
+	&TexFormatFloatDepth,
+#else
+	IMG_NULL,
+#endif
+#if defined(GLES2_EXTENSION_PACKED_DEPTH_STENCIL)
+	&TexFormatFloatDepthU8Stencil,
+#else
+	IMG_NULL,
+#endif
+};
+
+#define GLES2_NUM_PREWARM_TEX_FORMATS	(sizeof(apsPrewarmTexFormats) / sizeof(apsPrewarmTexFormats[0]))
+
+
+/***********************************************************************************
+ Function Name      : PrewarmKeysMatch
+ Inputs             : psKeyA, psKeyB
+ Outputs            : -
+ Returns            : IMG_TRUE if both keys finalise to the same HW shader
+ Description        : UTILITY: Compares two prewarm keys
+************************************************************************************/
+static IMG_BOOL PrewarmKeysMatch(const GLES2ShaderPrewarmKey *psKeyA, const GLES2ShaderPrewarmKey *psKeyB)
+{
+	IMG_UINT32 i;
+
+	if((psKeyA->ui32ImageUnitEnables != psKeyB->ui32ImageUnitEnables) ||
+	   (psKeyA->ui8OutputLocation != psKeyB->ui8OutputLocation) ||
+	   (psKeyA->ui8PreambleCount != psKeyB->ui8PreambleCount) ||
+	   (psKeyA->ui8Flags != psKeyB->ui8Flags))
+	{
+		return IMG_FALSE;
+	}
+
+	for(i=0; i < GLES2_MAX_TEXTURE_UNITS; i++)
+	{
+		if((psKeyA->ui32ImageUnitEnables & (1U << i)) && (psKeyA->apsTexFormat[i] != psKeyB->apsTexFormat[i]))
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : IsPrewarmableKey
+ Inputs             : psKey
+ Outputs            : -
+ Returns            : IMG_TRUE if a variant for the key can be finalised ahead of time
+ Description        : UTILITY: Keys that depend on leftover UniPatch context state
+					  cannot be reproduced on another context.
+************************************************************************************/
+static IMG_BOOL IsPrewarmableKey(const GLES2ShaderPrewarmKey *psKey)
+{
+	return (psKey->ui8Flags & GLES2_PREWARM_KEY_FLAG_KEEP_PREAMBLE) ? IMG_FALSE : IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : SetupUniPatchState
+ Inputs             : pvUniPatchContext, psKey
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Sets up a UniPatch context to finalise a variant for
+					  the given key. Used for both foreground and background
+					  finalisation so they always produce the same code.
+************************************************************************************/
+static IMG_VOID SetupUniPatchState(IMG_VOID *pvUniPatchContext, const GLES2ShaderPrewarmKey *psKey)
+{
+	IMG_UINT32 i;
+
+	for(i=0; i < GLES2_MAX_TEXTURE_UNITS; i++)
+	{
+		if(psKey->ui32ImageUnitEnables & (1U << i))
+		{
+			PVRUniPatchSetTextureFormat(pvUniPatchContext,
+										i,
+										(USP_TEX_FORMAT *)((IMG_UINTPTR_T)(&psKey->apsTexFormat[i]->sTexFormat)),
+										IMG_FALSE,
+										IMG_FALSE);
+		}
+	}
+
+	/* Vertex shaders have never set up the output location */
+	if((psKey->ui8Flags & GLES2_PREWARM_KEY_FLAG_VERTEX) == 0)
+	{
+		PVRUniPatchSetOutputLocation(pvUniPatchContext, (USP_OUTPUT_REGTYPE)psKey->ui8OutputLocation);
+	}
+
+	if((psKey->ui8Flags & GLES2_PREWARM_KEY_FLAG_KEEP_PREAMBLE) == 0)
+	{
+		PVRUniPatchSetPreambleInstCount(pvUniPatchContext, psKey->ui8PreambleCount);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetUniPatchShaderForKey
+ Inputs             : psSharedState, psKey
+ Outputs            : -
+ Returns            : UniPatch shader to finalise
+ Description        : UTILITY: Picks the plain or read only PA version of a shader
+************************************************************************************/
+static IMG_VOID *GetUniPatchShaderForKey(GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	if(psKey->ui8Flags & GLES2_PREWARM_KEY_FLAG_MSAATRANS)
+	{
+		return psSharedState->pvUniPatchShaderMSAATrans;
+	}
+
+	return psSharedState->pvUniPatchShader;
+}
+
+
+/***********************************************************************************
+ Function Name      : FindPrewarmedShader
+ Inputs             : psSharedState, psKey
+ Outputs            : -
+ Returns            : Link pointing at the matching cache entry, or IMG_NULL
+ Description        : UTILITY: Looks a key up in the prewarmed shader cache.
+					  hUniPatchLock must be held.
+************************************************************************************/
+static GLES2PrewarmedShader **FindPrewarmedShader(GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	GLES2PrewarmedShader **ppsPrewarmed = &psSharedState->psPrewarmed;
+
+	while(*ppsPrewarmed)
+	{
+		if(PrewarmKeysMatch(&(*ppsPrewarmed)->sKey, psKey))
+		{
+			return ppsPrewarmed;
+		}
+
+		ppsPrewarmed = &(*ppsPrewarmed)->psNext;
+	}
+
+	return IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : ClaimPrewarmedShader
+ Inputs             : psSharedState, psKey
+ Outputs            : -
+ Returns            : Prewarmed HW shader for the key, or IMG_NULL
+ Description        : UTILITY: Takes a HW shader out of the prewarmed shader cache.
+					  hUniPatchLock must be held.
+************************************************************************************/
+static USP_HW_SHADER *ClaimPrewarmedShader(GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	GLES2PrewarmedShader **ppsPrewarmed, *psPrewarmed;
+	USP_HW_SHADER *psPatchedShader;
+
+	ppsPrewarmed = FindPrewarmedShader(psSharedState, psKey);
+
+	if(!ppsPrewarmed)
+	{
+		return IMG_NULL;
+	}
+
+	psPrewarmed = *ppsPrewarmed;
+	*ppsPrewarmed = psPrewarmed->psNext;
+
+	psSharedState->ui32NumPrewarmed--;
+
+	psPatchedShader = psPrewarmed->psPatchedShader;
+
+	GLES2Free(IMG_NULL, psPrewarmed);
+
+	GLES2_INC_COUNT(GLES2_TIMER_USEVARIANT_PREWARM_HIT_COUNT, 1);
+
+	return psPatchedShader;
+}
+
+
+/***********************************************************************************
+ Function Name      : PrewarmShader
+ Inputs             : gc, psSharedState, psKey
+ Outputs            : -
+ Returns            : IMG_TRUE if a new HW shader was added to the cache
+ Description        : UTILITY: Finalises a variant on the share group's prewarm
+					  UniPatch context into the prewarmed shader cache unless it
+					  is already there. hUniPatchFinaliseLock must be held, and
+					  hUniPatchLock must not be.
+************************************************************************************/
+static IMG_BOOL PrewarmShader(GLES2Context *gc, GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	GLES2PrewarmedShader *psPrewarmed;
+	IMG_VOID *pvUniPatchContext = gc->psSharedState->pvPrewarmUniPatchContext;
+	IMG_VOID *pvUniPatchShader = GetUniPatchShaderForKey(psSharedState, psKey);
+	IMG_BOOL bSkip;
+
+	/* Entries are only added under hUniPatchFinaliseLock, so this can't change before the insert below */
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	bSkip = (!pvUniPatchContext || !pvUniPatchShader ||
+			 (psSharedState->ui32NumPrewarmed >= GLES2_MAX_PREWARM_KEYS) ||
+			 FindPrewarmedShader(psSharedState, psKey)) ? IMG_TRUE : IMG_FALSE;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	if(bSkip)
+	{
+		return IMG_FALSE;
+	}
+
+	psPrewarmed = GLES2Malloc(IMG_NULL, sizeof(GLES2PrewarmedShader));
+
+	if(!psPrewarmed)
+	{
+		return IMG_FALSE;
+	}
+
+	SetupUniPatchState(pvUniPatchContext, psKey);
+
+	psPrewarmed->psPatchedShader = PVRUniPatchFinaliseShader(pvUniPatchContext, pvUniPatchShader);
+
+	if(!psPrewarmed->psPatchedShader)
+	{
+		GLES2Free(IMG_NULL, psPrewarmed);
+
+		return IMG_FALSE;
+	}
+
+	psPrewarmed->pvUniPatchContext = pvUniPatchContext;
+	psPrewarmed->sKey = *psKey;
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	psPrewarmed->psNext = psSharedState->psPrewarmed;
+
+	psSharedState->psPrewarmed = psPrewarmed;
+	psSharedState->ui32NumPrewarmed++;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : DiscardPrewarmedShaders
+ Inputs             : gc, psSharedState
+ Outputs            : -
+ Returns            : -
+ Description        : Frees every prewarmed HW shader of a shader. The caller must
+					  hold hUniPatchFinaliseLock and hUniPatchLock unless nothing else
+					  can reach the shader.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DiscardPrewarmedShaders(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
+{
+	GLES2PrewarmedShader *psPrewarmed;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	while(psSharedState->psPrewarmed)
+	{
+		psPrewarmed = psSharedState->psPrewarmed;
+		psSharedState->psPrewarmed = psPrewarmed->psNext;
+
+		PVRUniPatchDestroyHWShader(psPrewarmed->pvUniPatchContext, psPrewarmed->psPatchedShader);
+
+		GLES2Free(IMG_NULL, psPrewarmed);
+	}
+
+	psSharedState->ui32NumPrewarmed = 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeSharedShaderPrewarmState
+ Inputs             : gc, psSharedState
+ Outputs            : -
+ Returns            : -
+ Description        : Frees the prewarm state of a shader whose last reference is
+					  being dropped.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID FreeSharedShaderPrewarmState(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
+{
+	DiscardPrewarmedShaders(gc, psSharedState);
+
+	GLES2Free(IMG_NULL, psSharedState->psPrewarmKeys);
+
+	psSharedState->psPrewarmKeys = IMG_NULL;
+	psSharedState->ui32NumPrewarmKeys = 0;
+}
+
+
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+
+/***********************************************************************************
+ Function Name      : GetPrewarmBlobKey
+ Inputs             : psSharedState, bVertex
+ Outputs            : szBlobKey
+ Returns            : IMG_FALSE if the shader cannot be identified across runs
+ Description        : UTILITY: Builds the blob cache key the recorded keys of a
+					  shader are stored under.
+************************************************************************************/
+static IMG_BOOL GetPrewarmBlobKey(const GLES2SharedShaderState *psSharedState, IMG_BOOL bVertex,
+								  IMG_CHAR szBlobKey[GLES2_PREWARM_BLOB_KEY_LENGTH])
+{
+	if(!psSharedState->szDigest[0])
+	{
+		return IMG_FALSE;
+	}
+
+	sprintf(szBlobKey, "%s.prewarm.%c", psSharedState->szDigest, bVertex ? 'v' : 'f');
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetPrewarmTexFormatIndex
+ Inputs             : psTexFormat
+ Outputs            : -
+ Returns            : Index into apsPrewarmTexFormats, or GLES2_NUM_PREWARM_TEX_FORMATS
+ Description        : UTILITY: Maps a texture format to its record index
+************************************************************************************/
+static IMG_UINT32 GetPrewarmTexFormatIndex(const GLES2TextureFormat *psTexFormat)
+{
+	IMG_UINT32 i;
+
+	for(i=0; i < GLES2_NUM_PREWARM_TEX_FORMATS; i++)
+	{
+		if(psTexFormat && (apsPrewarmTexFormats[i] == psTexFormat))
+		{
+			break;
+		}
+	}
+
+	return i;
+}
+
+
+/***********************************************************************************
+ Function Name      : PackPrewarmRecord
+ Inputs             : psSharedState
+ Outputs            : pui32RecordSize
+ Returns            : Record to store in the blob cache, or IMG_NULL
+ Description        : UTILITY: Serialises the recorded keys of a shader. Keys using
+					  formats that cannot be stored are left out.
+					  hUniPatchLock must be held.
+************************************************************************************/
+static IMG_VOID *PackPrewarmRecord(const GLES2SharedShaderState *psSharedState, IMG_UINT32 *pui32RecordSize)
+{
+	GLES2PrewarmRecordHeader *psHeader;
+	GLES2PrewarmRecordKey *psRecordKeys;
+	IMG_UINT32 i, j, ui32FormatIndex;
+
+	psHeader = GLES2Calloc(IMG_NULL, sizeof(GLES2PrewarmRecordHeader) +
+									 psSharedState->ui32NumPrewarmKeys * sizeof(GLES2PrewarmRecordKey));
+
+	if(!psHeader)
+	{
+		return IMG_NULL;
+	}
+
+	psHeader->ui32Version = GLES2_PREWARM_RECORD_VERSION;
+	psHeader->ui32NumTexFormats = GLES2_NUM_PREWARM_TEX_FORMATS;
+
+	psRecordKeys = (GLES2PrewarmRecordKey *)(psHeader + 1);
+
+	for(i=0; i < psSharedState->ui32NumPrewarmKeys; i++)
+	{
+		const GLES2ShaderPrewarmKey *psKey = &psSharedState->psPrewarmKeys[i];
+		GLES2PrewarmRecordKey *psRecordKey = &psRecordKeys[psHeader->ui32NumKeys];
+
+		for(j=0; j < GLES2_MAX_TEXTURE_UNITS; j++)
+		{
+			if(psKey->ui32ImageUnitEnables & (1U << j))
+			{
+				ui32FormatIndex = GetPrewarmTexFormatIndex(psKey->apsTexFormat[j]);
+
+				if(ui32FormatIndex == GLES2_NUM_PREWARM_TEX_FORMATS)
+				{
+					break;
+				}
+
+				psRecordKey->aui8TexFormat[j] = (IMG_UINT8)ui32FormatIndex;
+			}
+		}
+
+		if(j < GLES2_MAX_TEXTURE_UNITS)
+		{
+			/* Stream or YUV texture */
+			GLES2MemSet(psRecordKey, 0, sizeof(GLES2PrewarmRecordKey));
+			continue;
+		}
+
+		psRecordKey->ui32ImageUnitEnables = psKey->ui32ImageUnitEnables;
+		psRecordKey->ui8OutputLocation = psKey->ui8OutputLocation;
+		psRecordKey->ui8PreambleCount = psKey->ui8PreambleCount;
+		psRecordKey->ui8Flags = psKey->ui8Flags;
+
+		psHeader->ui32NumKeys++;
+	}
+
+	*pui32RecordSize = sizeof(GLES2PrewarmRecordHeader) + psHeader->ui32NumKeys * sizeof(GLES2PrewarmRecordKey);
+
+	return psHeader;
+}
+
+
+/***********************************************************************************
+ Function Name      : UnpackPrewarmRecord
+ Inputs             : pvRecord, ui32RecordSize
+ Outputs            : psKeys
+ Returns            : Number of keys unpacked
+ Description        : UTILITY: Reads the keys back from a blob cache record.
+					  Records written by a different driver are ignored.
+************************************************************************************/
+static IMG_UINT32 UnpackPrewarmRecord(const IMG_VOID *pvRecord, IMG_UINT32 ui32RecordSize,
+									  GLES2ShaderPrewarmKey psKeys[GLES2_MAX_PREWARM_KEYS])
+{
+	const GLES2PrewarmRecordHeader *psHeader = (const GLES2PrewarmRecordHeader *)pvRecord;
+	const GLES2PrewarmRecordKey *psRecordKeys = (const GLES2PrewarmRecordKey *)(psHeader + 1);
+	IMG_UINT32 i, j, ui32NumKeys = 0;
+
+	if((ui32RecordSize < sizeof(GLES2PrewarmRecordHeader)) ||
+	   (psHeader->ui32Version != GLES2_PREWARM_RECORD_VERSION) ||
+	   (psHeader->ui32NumTexFormats != GLES2_NUM_PREWARM_TEX_FORMATS) ||
+	   (psHeader->ui32NumKeys > GLES2_MAX_PREWARM_KEYS) ||
+	   (ui32RecordSize != sizeof(GLES2PrewarmRecordHeader) + psHeader->ui32NumKeys * sizeof(GLES2PrewarmRecordKey)))
+	{
+		return 0;
+	}
+
+	for(i=0; i < psHeader->ui32NumKeys; i++)
+	{
+		const GLES2PrewarmRecordKey *psRecordKey = &psRecordKeys[i];
+		GLES2ShaderPrewarmKey *psKey = &psKeys[ui32NumKeys];
+
+		GLES2MemSet(psKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+		for(j=0; j < GLES2_MAX_TEXTURE_UNITS; j++)
+		{
+			if(psRecordKey->ui32ImageUnitEnables & (1U << j))
+			{
+				if((psRecordKey->aui8TexFormat[j] >= GLES2_NUM_PREWARM_TEX_FORMATS) ||
+				   !apsPrewarmTexFormats[psRecordKey->aui8TexFormat[j]])
+				{
+					break;
+				}
+
+				psKey->apsTexFormat[j] = apsPrewarmTexFormats[psRecordKey->aui8TexFormat[j]];
+			}
+		}
+
+		if(j < GLES2_MAX_TEXTURE_UNITS)
+		{
+			continue;
+		}
+
+		psKey->ui32ImageUnitEnables = psRecordKey->ui32ImageUnitEnables;
+		psKey->ui8OutputLocation = psRecordKey->ui8OutputLocation;
+		psKey->ui8PreambleCount = psRecordKey->ui8PreambleCount;
+		psKey->ui8Flags = psRecordKey->ui8Flags;
+
+		if(IsPrewarmableKey(psKey))
+		{
+			ui32NumKeys++;
+		}
+	}
+
+	return ui32NumKeys;
+}
+
+#endif /* defined(EGL_EXTENSION_ANDROID_BLOB_CACHE) */
+
+
+/***********************************************************************************
+ Function Name      : RecordPrewarmKey
+ Inputs             : psSharedState, psKey
+ Outputs            : -
+ Returns            : IMG_TRUE if the key was not recorded before
+ Description        : UTILITY: Remembers a key the shader was drawn with.
+					  hUniPatchLock must be held.
+************************************************************************************/
+static IMG_BOOL RecordPrewarmKey(GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	IMG_UINT32 i;
+
+	for(i=0; i < psSharedState->ui32NumPrewarmKeys; i++)
+	{
+		if(PrewarmKeysMatch(&psSharedState->psPrewarmKeys[i], psKey))
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	if(psSharedState->ui32NumPrewarmKeys >= GLES2_MAX_PREWARM_KEYS)
+	{
+		return IMG_FALSE;
+	}
+
+	if(!psSharedState->psPrewarmKeys)
+	{
+		psSharedState->psPrewarmKeys = GLES2Malloc(IMG_NULL, GLES2_MAX_PREWARM_KEYS * sizeof(GLES2ShaderPrewarmKey));
+
+		if(!psSharedState->psPrewarmKeys)
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	psSharedState->psPrewarmKeys[psSharedState->ui32NumPrewarmKeys++] = *psKey;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : LoadPrewarmKeys
+ Inputs             : gc, psSharedState, bVertex
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Merges the keys recorded by earlier runs into those
+					  of the shader, once per shader.
+************************************************************************************/
+static IMG_VOID LoadPrewarmKeys(GLES2Context *gc, GLES2SharedShaderState *psSharedState, IMG_BOOL bVertex)
+{
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+	IMG_CHAR szBlobKey[GLES2_PREWARM_BLOB_KEY_LENGTH];
+	GLES2ShaderPrewarmKey asKeys[GLES2_MAX_PREWARM_KEYS];
+	IMG_VOID *pvRecord;
+	IMG_UINT32 ui32RecordSize, ui32NumKeys = 0, i;
+
+	if(psSharedState->bPrewarmKeysLoaded || !GetPrewarmBlobKey(psSharedState, bVertex, szBlobKey))
+	{
+		return;
+	}
+
+	ui32RecordSize = KEGLGetBlob(szBlobKey, strlen(szBlobKey) + 1, IMG_NULL, 0);
+
+	if(ui32RecordSize)
+	{
+		pvRecord = GLES2Malloc(gc, ui32RecordSize);
+
+		if(pvRecord)
+		{
+			if(KEGLGetBlob(szBlobKey, strlen(szBlobKey) + 1, pvRecord, ui32RecordSize) == ui32RecordSize)
+			{
+				ui32NumKeys = UnpackPrewarmRecord(pvRecord, ui32RecordSize, asKeys);
+			}
+
+			GLES2Free(IMG_NULL, pvRecord);
+		}
+	}
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	if(!psSharedState->bPrewarmKeysLoaded)
+	{
+		for(i=0; i < ui32NumKeys; i++)
+		{
+			RecordPrewarmKey(psSharedState, &asKeys[i]);
+		}
+
+		psSharedState->bPrewarmKeysLoaded = IMG_TRUE;
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+#else
+	PVR_UNREFERENCED_PARAMETER(gc);
+	PVR_UNREFERENCED_PARAMETER(psSharedState);
+	PVR_UNREFERENCED_PARAMETER(bVertex);
+#endif
+}
+
+
+/***********************************************************************************
+ Function Name      : QueueShaderPrewarm
+ Inputs             : gc, psSharedState, psKey
+ Outputs            : -
+ Returns            : -
+ Description        : Hands a variant to the prewarm worker, or finalises it straight
+					  away if there is no worker. Keys that are already prewarmed or
+					  queued on this context are ignored.
+************************************************************************************/
+static IMG_VOID QueueShaderPrewarm(GLES2Context *gc, GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey)
+{
+	GLES2ShaderPrewarmJob *psJob, **ppsTail;
+	IMG_BOOL bQueued = IMG_FALSE;
+
+	if(!IsPrewarmableKey(psKey))
+	{
+		return;
+	}
+
+	if(!gc->sProgram.hPrewarmThread)
+	{
+		PVRSRVLockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+
+		PrewarmShader(gc, psSharedState, psKey);
+
+		PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+
+		return;
+	}
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	for(psJob = gc->sProgram.psPrewarmJobs; psJob; psJob = psJob->psNext)
+	{
+		if(!psJob->bDone && (psJob->psSharedState == psSharedState) && PrewarmKeysMatch(&psJob->sKey, psKey))
+		{
+			bQueued = IMG_TRUE;
+			break;
+		}
+	}
+
+	if(bQueued || FindPrewarmedShader(psSharedState, psKey))
+	{
+		PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+		return;
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	psJob = GLES2Calloc(gc, sizeof(GLES2ShaderPrewarmJob));
+
+	if(!psJob)
+	{
+		return;
+	}
+
+	/* Taken outside hUniPatchLock, which is never held while taking the primary lock */
+	SharedShaderStateAddRef(gc, psSharedState);
+
+	psJob->psSharedState = psSharedState;
+	psJob->sKey = *psKey;
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	/* Append, so variants are prewarmed in the order they were requested */
+	ppsTail = &gc->sProgram.psPrewarmJobs;
+
+	while(*ppsTail)
+	{
+		ppsTail = &(*ppsTail)->psNext;
+	}
+
+	*ppsTail = psJob;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	PVRSRVPostSemaphore(gc->sProgram.hPrewarmSemaphore, 1);
+}
+
+
+/***********************************************************************************
+ Function Name      : RequeueShaderPrewarm
+ Inputs             : gc, psSharedState
+ Outputs            : -
+ Returns            : -
+ Description        : Queues every key a shader has been drawn with for prewarming
+************************************************************************************/
+IMG_INTERNAL IMG_VOID RequeueShaderPrewarm(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
+{
+	GLES2ShaderPrewarmKey asKeys[GLES2_MAX_PREWARM_KEYS];
+	IMG_UINT32 ui32NumKeys, i;
+
+	if(!gc->sProgram.hPrewarmThread)
+	{
+		return;
+	}
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	ui32NumKeys = psSharedState->ui32NumPrewarmKeys;
+
+	for(i=0; i < ui32NumKeys; i++)
+	{
+		asKeys[i] = psSharedState->psPrewarmKeys[i];
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	for(i=0; i < ui32NumKeys; i++)
+	{
+		QueueShaderPrewarm(gc, psSharedState, &asKeys[i]);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : PrewarmProgramVariants
+ Inputs             : gc, psProgram
+ Outputs            : -
+ Returns            : -
+ Description        : Called after a successful link. Queues the variants the
+					  program's shaders were drawn with in this or earlier runs.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID PrewarmProgramVariants(GLES2Context *gc, GLES2Program *psProgram)
+{
+	if(!gc->sProgram.hPrewarmThread)
+	{
+		return;
+	}
+
+	LoadPrewarmKeys(gc, psProgram->sVertex.psSharedState, IMG_TRUE);
+	LoadPrewarmKeys(gc, psProgram->sFragment.psSharedState, IMG_FALSE);
+
+	RequeueShaderPrewarm(gc, psProgram->sVertex.psSharedState);
+	RequeueShaderPrewarm(gc, psProgram->sFragment.psSharedState);
+}
+
+
+/***********************************************************************************
+ Function Name      : FinaliseUSEShader
+ Inputs             : gc, psSharedState, psKey
+ Outputs            : pbPrewarmed
+ Returns            : HW shader for a new USE variant, or IMG_NULL
+ Description        : Hands out a prewarmed HW shader for the key if there is one,
+					  otherwise finalises the shader on the foreground context.
+					  The key is recorded for the next run. pbPrewarmed tells which
+					  UniPatch context the shader must be freed through, see
+					  DestroyFinalisedUSEShader.
+************************************************************************************/
+IMG_INTERNAL USP_HW_SHADER *FinaliseUSEShader(GLES2Context *gc, GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey,
+											  IMG_BOOL *pbPrewarmed)
+{
+	GLES2ShaderPrewarmJob *psJob;
+	USP_HW_SHADER *psPatchedShader = IMG_NULL;
+	IMG_BOOL bPrewarmable = IsPrewarmableKey(psKey);
+	IMG_BOOL bFinaliseLocked = IMG_FALSE;
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+	IMG_VOID *pvRecord = IMG_NULL;
+	IMG_UINT32 ui32RecordSize = 0;
+#endif
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	if(bPrewarmable)
+	{
+		psPatchedShader = ClaimPrewarmedShader(psSharedState, psKey);
+	}
+
+	if(!psPatchedShader)
+	{
+		PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+		/* Finalisation modifies the shared UniPatch shader */
+		PVRSRVLockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+		PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+		bFinaliseLocked = IMG_TRUE;
+
+		/* The worker may have finished this key while we waited */
+		if(bPrewarmable)
+		{
+			psPatchedShader = ClaimPrewarmedShader(psSharedState, psKey);
+		}
+	}
+
+	*pbPrewarmed = psPatchedShader ? IMG_TRUE : IMG_FALSE;
+
+	if(!psPatchedShader)
+	{
+		PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+		SetupUniPatchState(gc->sProgram.pvUniPatchContext, psKey);
+
+		psPatchedShader = PVRUniPatchFinaliseShader(gc->sProgram.pvUniPatchContext, GetUniPatchShaderForKey(psSharedState, psKey));
+
+		PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+		if(gc->sProgram.hPrewarmThread)
+		{
+			GLES2_INC_COUNT(GLES2_TIMER_USEVARIANT_PREWARM_MISS_COUNT, 1);
+
+			/* The worker would only be finalising this again. It holds hUniPatchFinaliseLock
+			   while it runs a job, so none of these is in progress. */
+			for(psJob = gc->sProgram.psPrewarmJobs; psJob; psJob = psJob->psNext)
+			{
+				if(!psJob->bDone && (psJob->psSharedState == psSharedState) && PrewarmKeysMatch(&psJob->sKey, psKey))
+				{
+					psJob->bDone = IMG_TRUE;
+				}
+			}
+		}
+	}
+
+	if(psPatchedShader && bPrewarmable && gc->sAppHints.bShaderPrewarm)
+	{
+		if(RecordPrewarmKey(psSharedState, psKey))
+		{
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+			pvRecord = PackPrewarmRecord(psSharedState, &ui32RecordSize);
+#endif
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	if(bFinaliseLocked)
+	{
+		PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+	}
+
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+	if(pvRecord)
+	{
+		IMG_CHAR szBlobKey[GLES2_PREWARM_BLOB_KEY_LENGTH];
+
+		if(GetPrewarmBlobKey(psSharedState, (psKey->ui8Flags & GLES2_PREWARM_KEY_FLAG_VERTEX) ? IMG_TRUE : IMG_FALSE, szBlobKey))
+		{
+			KEGLSetBlob(szBlobKey, strlen(szBlobKey) + 1, pvRecord, ui32RecordSize);
+		}
+
+		GLES2Free(IMG_NULL, pvRecord);
+	}
+#endif
+
+	return psPatchedShader;
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyFinalisedUSEShader
+ Inputs             : gc, psPatchedShader, bPrewarmed
+ Outputs            : -
+ Returns            : -
+ Description        : Frees a HW shader returned by FinaliseUSEShader through the
+					  UniPatch context it was finalised on.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyFinalisedUSEShader(GLES2Context *gc, USP_HW_SHADER *psPatchedShader, IMG_BOOL bPrewarmed)
+{
+	if(bPrewarmed)
+	{
+		PVRUniPatchDestroyHWShader(gc->psSharedState->pvPrewarmUniPatchContext, psPatchedShader);
+	}
+	else
+	{
+		PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ShaderPrewarmThread
+ Inputs             : ui32ArgSize, pvArgBlock
+ Outputs            : -
+ Returns            : -
+ Description        : Background worker. Finalises queued variants into the
+					  prewarmed shader caches on the share group's prewarm
+					  UniPatch context.
+************************************************************************************/
+static IMG_INT32 ShaderPrewarmThread(IMG_UINT32 ui32ArgSize, IMG_VOID *pvArgBlock)
+{
+	GLES2Context *gc = *(GLES2Context **)pvArgBlock;
+	GLES2ShaderPrewarmJob *psJob;
+
+	PVR_UNREFERENCED_PARAMETER(ui32ArgSize);
+
+	/* UniPatch's debug callback looks the context up through TLS */
+	__GLES2_SET_CONTEXT(gc);
+
+	for(;;)
+	{
+		PVRSRVWaitSemaphore(gc->sProgram.hPrewarmSemaphore, IMG_SEMAPHORE_WAIT_INFINITE);
+
+		if(gc->sProgram.bPrewarmThreadExit)
+		{
+			break;
+		}
+
+		for(;;)
+		{
+			IMG_BOOL bPrewarmed;
+
+			/* Held for the whole job, so a draw can't mark it done and have it reaped under us */
+			PVRSRVLockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+			PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+			for(psJob = gc->sProgram.psPrewarmJobs; psJob; psJob = psJob->psNext)
+			{
+				if(!psJob->bDone)
+				{
+					break;
+				}
+			}
+
+			PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+			if(!psJob || gc->sProgram.bPrewarmThreadExit)
+			{
+				PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+				break;
+			}
+
+			bPrewarmed = PrewarmShader(gc, psJob->psSharedState, &psJob->sKey);
+
+			PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+			psJob->bPrewarmed = bPrewarmed;
+			psJob->bDone = IMG_TRUE;
+
+			PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+			PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+		}
+	}
+
+	return sceKernelExitDeleteThread(0);
+}
+
+
+/***********************************************************************************
+ Function Name      : ServiceShaderPrewarm
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Called at frame boundaries. Drops the references held by
+					  finished prewarm jobs.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ServiceShaderPrewarm(GLES2Context *gc)
+{
+	GLES2ShaderPrewarmJob *psJob, **ppsJob, *psDoneJobs = IMG_NULL;
+
+	if(!gc->sProgram.hPrewarmThread)
+	{
+		return;
+	}
+
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	ppsJob = &gc->sProgram.psPrewarmJobs;
+
+	while(*ppsJob)
+	{
+		psJob = *ppsJob;
+
+		if(psJob->bDone)
+		{
+			*ppsJob = psJob->psNext;
+
+			psJob->psNext = psDoneJobs;
+			psDoneJobs = psJob;
+		}
+		else
+		{
+			ppsJob = &psJob->psNext;
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	/* The last reference may free the shader, which takes the primary lock */
+	while(psDoneJobs)
+	{
+		psJob = psDoneJobs;
+		psDoneJobs = psJob->psNext;
+
+		if(psJob->bPrewarmed)
+		{
+			GLES2_INC_COUNT(GLES2_TIMER_USEVARIANT_PREWARMED_COUNT, 1);
+		}
+
+		SharedShaderStateDelRef(gc, psJob->psSharedState);
+
+		GLES2Free(IMG_NULL, psJob);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : StartShaderPrewarmThread
+ Inputs             : gc
+ Outputs            : -
+ Returns            : Success
+ Description        : Starts the prewarm worker. The share group's prewarm UniPatch
+					  context must already exist.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL StartShaderPrewarmThread(GLES2Context *gc)
+{
+	GLES2ProgramMachine *psProgramMachine = &gc->sProgram;
+
+	GLES_ASSERT(gc->psSharedState->pvPrewarmUniPatchContext);
+
+	if(PVRSRVCreateSemaphore(&psProgramMachine->hPrewarmSemaphore, 0) != PVRSRV_OK)
+	{
+		goto FAILED_PrewarmSemaphore;
+	}
+
+	psProgramMachine->psPrewarmJobs = IMG_NULL;
+	psProgramMachine->bPrewarmThreadExit = IMG_FALSE;
+
+	psProgramMachine->hPrewarmThread = sceKernelCreateThread("OGLES2ShaderPrewarm", ShaderPrewarmThread, SCE_KERNEL_LOWEST_PRIORITY_USER, SCE_KERNEL_256KiB, 0, 0, SCE_NULL);
+
+	if(psProgramMachine->hPrewarmThread <= 0)
+	{
+		psProgramMachine->hPrewarmThread = 0;
+
+		goto FAILED_PrewarmThread;
+	}
+
+	sceKernelStartThread(psProgramMachine->hPrewarmThread, sizeof(GLES2Context *), &gc);
+
+	return IMG_TRUE;
+
+FAILED_PrewarmThread:
+
+	PVRSRVDestroySemaphore(psProgramMachine->hPrewarmSemaphore);
+
+FAILED_PrewarmSemaphore:
+
+	psProgramMachine->hPrewarmSemaphore = IMG_NULL;
+
+	PVR_DPF((PVR_DBG_WARNING, "StartShaderPrewarmThread: Couldn't start the worker, variants will be finalised at draw time"));
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : StopShaderPrewarmThread
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Stops the prewarm worker and drops any jobs left. Shaders it
+					  prewarmed stay valid, as the share group owns their UniPatch
+					  context.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID StopShaderPrewarmThread(GLES2Context *gc)
+{
+	GLES2ProgramMachine *psProgramMachine = &gc->sProgram;
+
+	if(!psProgramMachine->hPrewarmThread)
+	{
+		return;
+	}
+
+	psProgramMachine->bPrewarmThreadExit = IMG_TRUE;
+
+	PVRSRVPostSemaphore(psProgramMachine->hPrewarmSemaphore, 1);
+
+	sceKernelWaitThreadEnd(psProgramMachine->hPrewarmThread, SCE_NULL, SCE_NULL);
+
+	/* Everything left can now be reaped as if it had finished */
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	{
+		GLES2ShaderPrewarmJob *psJob;
+
+		for(psJob = psProgramMachine->psPrewarmJobs; psJob; psJob = psJob->psNext)
+		{
+			psJob->bDone = IMG_TRUE;
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+
+	ServiceShaderPrewarm(gc);
+
+	psProgramMachine->hPrewarmThread = 0;
+
+	PVRSRVDestroySemaphore(psProgramMachine->hPrewarmSemaphore);
+
+	psProgramMachine->hPrewarmSemaphore = IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetPrewarmTextureFormat
+ Inputs             : format, type
+ Outputs            : -
+ Returns            : Texture format the driver would use, or IMG_NULL
+ Description        : UTILITY: Maps a format/type pair as passed to glTexImage2D or
+					  glCompressedTexImage2D to the driver's texture format.
+************************************************************************************/
+static const GLES2TextureFormat *GetPrewarmTextureFormat(GLenum format, GLenum type)
+{
+	switch(format)
+	{
+		case GL_RGBA:
+		{
+			switch(type)
+			{
+				case GL_UNSIGNED_BYTE:			return &TexFormatABGR8888;
+				case GL_UNSIGNED_SHORT_5_5_5_1:	return &TexFormatARGB1555;
+				case GL_UNSIGNED_SHORT_4_4_4_4:	return &TexFormatARGB4444;
+#if defined(GLES2_EXTENSION_FLOAT_TEXTURE)
+				case GL_FLOAT:					return &TexFormatRGBAFloat;
+#endif
+#if defined(GLES2_EXTENSION_HALF_FLOAT_TEXTURE)
+				case GL_HALF_FLOAT_OES:			return &TexFormatRGBAHalfFloat;
+#endif
+				default:						return IMG_NULL;
+			}
+		}
+#if defined(GLES2_EXTENSION_TEXTURE_FORMAT_BGRA8888)
+		case GL_BGRA_EXT:
+		{
+			return (type == GL_UNSIGNED_BYTE) ? &TexFormatARGB8888 : IMG_NULL;
+		}
+#endif
+		case GL_RGB:
+		{
+			switch(type)
+			{
+				case GL_UNSIGNED_BYTE:			return &TexFormatXBGR8888;
+				case GL_UNSIGNED_SHORT_5_6_5:	return &TexFormatRGB565;
+#if defined(GLES2_EXTENSION_FLOAT_TEXTURE)
+				case GL_FLOAT:					return &TexFormatRGBFloat;
+#endif
+#if defined(GLES2_EXTENSION_HALF_FLOAT_TEXTURE)
+				case GL_HALF_FLOAT_OES:			return &TexFormatRGBHalfFloat;
+#endif
+				default:						return IMG_NULL;
+			}
+		}
+		case GL_ALPHA:
+		{
+			switch(type)
+			{
+				case GL_UNSIGNED_BYTE:			return &TexFormatAlpha;
+#if defined(GLES2_EXTENSION_FLOAT_TEXTURE)
+				case GL_FLOAT:					return &TexFormatFloatAlpha;
+#endif
+#if defined(GLES2_EXTENSION_HALF_FLOAT_TEXTURE)
+				case GL_HALF_FLOAT_OES:			return &TexFormatHalfFloatAlpha;
+#endif
+				default:						return IMG_NULL;
+			}
+		}
+		case GL_LUMINANCE:
+		{
+			switch(type)
+			{
+				case GL_UNSIGNED_BYTE:			return &TexFormatLuminance;
+#if defined(GLES2_EXTENSION_FLOAT_TEXTURE)
+				case GL_FLOAT:					return &TexFormatFloatLuminance;
+#endif
+#if defined(GLES2_EXTENSION_HALF_FLOAT_TEXTURE)
+				case GL_HALF_FLOAT_OES:			return &TexFormatHalfFloatLuminance;
+#endif
+				default:						return IMG_NULL;
+			}
+		}
+		case GL_LUMINANCE_ALPHA:
+		{
+			switch(type)
+			{
+				case GL_UNSIGNED_BYTE:			return &TexFormatLuminanceAlpha;
+#if defined(GLES2_EXTENSION_FLOAT_TEXTURE)
+				case GL_FLOAT:					return &TexFormatFloatLuminanceAlpha;
+#endif
+#if defined(GLES2_EXTENSION_HALF_FLOAT_TEXTURE)
+				case GL_HALF_FLOAT_OES:			return &TexFormatHalfFloatLuminanceAlpha;
+#endif
+				default:						return IMG_NULL;
+			}
+		}
+#if defined(GLES2_EXTENSION_DEPTH_TEXTURE)
+		case GL_DEPTH_COMPONENT:
+		{
+			return ((type == GL_UNSIGNED_SHORT) || (type == GL_UNSIGNED_INT)) ? &TexFormatFloatDepth : IMG_NULL;
+		}
+#endif
+#if defined(GLES2_EXTENSION_PACKED_DEPTH_STENCIL)
+		case GL_DEPTH_STENCIL_OES:
+		{
+			return (type == GL_UNSIGNED_INT_24_8_OES) ? &TexFormatFloatDepthU8Stencil : IMG_NULL;
+		}
+#endif
+		/* Compressed formats ignore the type */
+		case GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG:	return &TexFormatPVRTC2RGB;
+		case GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG:	return &TexFormatPVRTC4RGB;
+		case GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG:	return &TexFormatPVRTC2RGBA;
+		case GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG:	return &TexFormatPVRTC4RGBA;
+		case GL_ETC1_RGB8_OES:						return &TexFormatETC1RGB;
+		default:
+		{
+			return IMG_NULL;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : SetupPrewarmKeyTextures
+ Inputs             : psShader, apsUnitFormat
+ Outputs            : psKey
+ Returns            : IMG_FALSE if a sampler reads a unit with no declared format
+ Description        : UTILITY: Fills in the texture formats of a key from the
+					  formats declared per texture unit, the same way texture
+					  validation maps samplers to units.
+************************************************************************************/
+static IMG_BOOL SetupPrewarmKeyTextures(const GLES2ProgramShader *psShader,
+										const GLES2TextureFormat * const apsUnitFormat[GLES2_MAX_TEXTURE_UNITS],
+										GLES2ShaderPrewarmKey *psKey)
+{
+	IMG_UINT32 i, ui32ImageUnit;
+
+	for(i=0; i < GLES2_MAX_TEXTURE_UNITS; i++)
+	{
+		if(psShader->ui32SamplersActive & (1U << i))
+		{
+			ui32ImageUnit = psShader->asTextureSamplers[i].ui8ImageUnit;
+
+			if(GLES2_IS_PERM_TEXTURE_UNIT(ui32ImageUnit) || GLES2_IS_GRAD_TEXTURE_UNIT(ui32ImageUnit))
+			{
+				continue;
+			}
+
+			if(!apsUnitFormat[ui32ImageUnit])
+			{
+				return IMG_FALSE;
+			}
+
+			psKey->ui32ImageUnitEnables |= (1U << i);
+			psKey->apsTexFormat[i] = apsUnitFormat[ui32ImageUnit];
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+
+#if defined(GLES2_EXTENSION_SHADER_PREWARM)
+
+/***********************************************************************************
+ Function Name      : glPrewarmProgramIMG
+ Inputs             : program, count, formats, types
+ Outputs            : -
+ Returns            : -
+ Description        : ENTRYPOINT: Declares the formats of the textures that will be
+					  bound to the first count texture units when the program is
+					  drawn with, so the matching variants can be prepared before
+					  the first draw. GL_NONE marks an unused unit. The current
+					  sampler uniforms, blend and colormask state are assumed.
+************************************************************************************/
+GL_API_EXT void GL_APIENTRY glPrewarmProgramIMG(GLuint program, GLsizei count, const GLenum *formats, const GLenum *types)
+{
+	const GLES2TextureFormat *apsUnitFormat[GLES2_MAX_TEXTURE_UNITS];
+	GLES2ShaderPrewarmKey sKey;
+	GLES2Program *psProgram;
+	GLSLProgramFlags eProgramFlags;
+	IMG_INT32 i;
+
+	__GLES2_GET_CONTEXT();
+
+	PVR_DPF((PVR_DBG_CALLTRACE,"glPrewarmProgramIMG"));
+
+	GLES2_TIME_START(GLES2_TIMES_glPrewarmProgramIMG);
+
+	psProgram = GetNamedProgram(gc, program);
+
+	if(!psProgram)
+	{
+		GLES2_TIME_STOP(GLES2_TIMES_glPrewarmProgramIMG);
+		return;
+	}
+
+	if((count < 0) || (count > GLES2_MAX_TEXTURE_UNITS) || (count && (!formats || !types)))
+	{
+		SetError(gc, GL_INVALID_VALUE);
+		GLES2_TIME_STOP(GLES2_TIMES_glPrewarmProgramIMG);
+		return;
+	}
+
+	if(!psProgram->bSuccessfulLink)
+	{
+		SetError(gc, GL_INVALID_OPERATION);
+		GLES2_TIME_STOP(GLES2_TIMES_glPrewarmProgramIMG);
+		return;
+	}
+
+	GLES2MemSet((IMG_VOID *)apsUnitFormat, 0, sizeof(apsUnitFormat));
+
+	for(i=0; i < count; i++)
+	{
+		if(formats[i] != GL_NONE)
+		{
+			apsUnitFormat[i] = GetPrewarmTextureFormat(formats[i], types[i]);
+
+			if(!apsUnitFormat[i])
+			{
+				SetError(gc, GL_INVALID_ENUM);
+				GLES2_TIME_STOP(GLES2_TIMES_glPrewarmProgramIMG);
+				return;
+			}
+		}
+	}
+
+	/* Vertex variant */
+	GLES2MemSet(&sKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+	sKey.ui8Flags = GLES2_PREWARM_KEY_FLAG_VERTEX;
+
+#if defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	sKey.ui8PreambleCount = 1;
+#else
+	sKey.ui8Flags |= GLES2_PREWARM_KEY_FLAG_KEEP_PREAMBLE;
+#endif
+
+	if(SetupPrewarmKeyTextures(&psProgram->sVertex, apsUnitFormat, &sKey))
+	{
+		QueueShaderPrewarm(gc, psProgram->sVertex.psSharedState, &sKey);
+	}
+
+	/* Fragment variant, for opaque objects */
+	GLES2MemSet(&sKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+	eProgramFlags = psProgram->sFragment.psSharedState->eProgramFlags;
+
+	SetupFragmentPrewarmKey(gc, (eProgramFlags & GLSLPF_DISCARD_EXECUTED) ? GLES2_ALPHA_TEST_DISCARD : 0, IMG_FALSE, &sKey);
+
+	if(SetupPrewarmKeyTextures(&psProgram->sFragment, apsUnitFormat, &sKey))
+	{
+		QueueShaderPrewarm(gc, psProgram->sFragment.psSharedState, &sKey);
+	}
+
+	GLES2_TIME_STOP(GLES2_TIMES_glPrewarmProgramIMG);
+}
+
+#endif /* defined(GLES2_EXTENSION_SHADER_PREWARM) */
+
+/******************************************************************************
+ End of file (prewarm.c)
+******************************************************************************/
@@ -193,7 +193,9 @@ static IMG_CHAR* const pszFunctionNames[] =
 	"glGenVertexArraysOES                    ",
 	"glIsVertexArrayOES                      ",
 
-	"glDiscardFramebufferEXT                 "
+	"glDiscardFramebufferEXT                 ",
+
+	"glPrewarmProgramIMG                     "
 };
 
 
@@ -199,6 +199,82 @@ IMG_INTERNAL IMG_BOOL SWMakeTextureMipmapLevels(GLES2Context *gc, GLES2Texture *
 	return IMG_TRUE;
 }
 
+static IMG_INT32 _SWTextureEncodeETC1Entry(IMG_UINT32 arg)
+{
+	SWETC1EncodeArg *psArg = (SWETC1EncodeArg *)arg;
+
+	EncodeETC1Blocks(psArg->pui32Dest, psArg->pui8Src, psArg->ui32SrcBytesPerPixel, psArg->ui32Width, psArg->ui32Height,
+		psArg->ui32SrcStrideInBytes, psArg->ui32FirstBlockRow, psArg->ui32NumBlockRows);
+
+	return sceUltUlthreadExit(0);
+}
+
+IMG_INTERNAL IMG_VOID SWEncodeETC1(GLES2Context *gc, IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+	IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes)
+{
+	SWETC1EncodeArg asArg[SWTEXOP_ETC1_MAX_BANDS];
+	SceUltUlthread asUlthread[SWTEXOP_ETC1_MAX_BANDS];
+	IMG_BOOL abStarted[SWTEXOP_ETC1_MAX_BANDS];
+	IMG_UINT32 ui32NumBlockRows = (ui32Height + 3) >> 2;
+	IMG_UINT32 ui32NumBands, ui32RowsPerBand, ui32Row, i;
+	IMG_INT32 ret;
+
+	/* The calling thread encodes the first band itself */
+	ui32NumBands = MIN(gc->sAppHints.ui32SwTexOpThreadNum + 1, SWTEXOP_ETC1_MAX_BANDS);
+	ui32NumBands = MIN(ui32NumBands, ui32NumBlockRows);
+	ui32RowsPerBand = (ui32NumBlockRows + ui32NumBands - 1) / ui32NumBands;
+
+	for (i = 0, ui32Row = 0; i < ui32NumBands; i++, ui32Row += ui32RowsPerBand)
+	{
+		asArg[i].pui32Dest = pui32Dest;
+		asArg[i].pui8Src = pui8Src;
+		asArg[i].ui32SrcBytesPerPixel = ui32SrcBytesPerPixel;
+		asArg[i].ui32Width = ui32Width;
+		asArg[i].ui32Height = ui32Height;
+		asArg[i].ui32SrcStrideInBytes = ui32SrcStrideInBytes;
+		asArg[i].ui32FirstBlockRow = ui32Row;
+		asArg[i].ui32NumBlockRows = MIN(ui32RowsPerBand, ui32NumBlockRows - ui32Row);
+		abStarted[i] = IMG_FALSE;
+
+		if (i == 0 || asArg[i].ui32NumBlockRows == 0)
+		{
+			continue;
+		}
+
+		ret = sceUltUlthreadCreate(
+			&asUlthread[i],
+			"OGLES2SWTextureEncodeETC1",
+			_SWTextureEncodeETC1Entry,
+			(IMG_UINT32)&asArg[i],
+			SCE_NULL,
+			0,
+			gc->pvUltRuntime,
+			SCE_NULL);
+
+		if (ret == SCE_OK)
+		{
+			abStarted[i] = IMG_TRUE;
+		}
+		else
+		{
+			PVR_DPF((PVR_DBG_WARNING, "SWEncodeETC1: sceUltUlthreadCreate failed with code 0x%X, encoding band inline", ret));
+		}
+	}
+
+	for (i = 0; i < ui32NumBands; i++)
+	{
+		if (abStarted[i])
+		{
+			sceUltUlthreadJoin(&asUlthread[i], SCE_NULL);
+		}
+		else if (asArg[i].ui32NumBlockRows)
+		{
+			EncodeETC1Blocks(asArg[i].pui32Dest, asArg[i].pui8Src, asArg[i].ui32SrcBytesPerPixel, asArg[i].ui32Width,
+				asArg[i].ui32Height, asArg[i].ui32SrcStrideInBytes, asArg[i].ui32FirstBlockRow, asArg[i].ui32NumBlockRows);
+		}
+	}
+}
+
 IMG_VOID texOpAsyncAddForCleanup(GLES2Context *gc, IMG_PVOID pvPtr)
 {
 	IMG_UINT32 i = 0;
@@ -239,6 +315,8 @@ IMG_INT32 texOpAsyncCleanupThread(IMG_UINT32 argSize, IMG_VOID *pArgBlock)
 			}
 		}
 
+		texOpStagingRetirePending(gc);
+
 		for (i = 0; i < gc->sAppHints.ui32SwTexOpMaxUltNum; i++)
 		{
 			if (gc->pvUltThreadStorage[i] != IMG_NULL)
@@ -29,14 +29,41 @@ typedef struct SWTexMipGenArg
 	IMG_SID hOpSyncObj;
 } SWTexMipGenArg;
 
+#define SWTEXOP_ETC1_MAX_BANDS 4
+
+typedef struct SWETC1EncodeArg
+{
+	IMG_UINT32 *pui32Dest;
+	const IMG_UINT8 *pui8Src;
+	IMG_UINT32 ui32SrcBytesPerPixel;
+	IMG_UINT32 ui32Width;
+	IMG_UINT32 ui32Height;
+	IMG_UINT32 ui32SrcStrideInBytes;
+	IMG_UINT32 ui32FirstBlockRow;
+	IMG_UINT32 ui32NumBlockRows;
+} SWETC1EncodeArg;
+
 IMG_INTERNAL IMG_VOID SWTextureUpload(
 	GLES2Context *gc, GLES2Texture *psTex, GLES2MipMapLevel *psMipLevel, IMG_UINT32 ui32OffsetInBytes, GLES2TextureFormat *psTexFmt,
 	IMG_UINT32 ui32Face, IMG_UINT32 ui32Lod, IMG_UINT32 ui32TopUsize, IMG_UINT32 ui32TopVsize);
 
 IMG_INTERNAL IMG_BOOL SWMakeTextureMipmapLevels(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32Face, IMG_UINT32 ui32MaxFace, IMG_BOOL bIsNonPow2);
 
+IMG_INTERNAL IMG_VOID SWEncodeETC1(GLES2Context *gc, IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+	IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes);
+
 IMG_INT32 texOpAsyncCleanupThread(IMG_UINT32 argSize, IMG_VOID *pArgBlock);
 
 IMG_VOID texOpAsyncAddForCleanup(GLES2Context *gc, IMG_PVOID pvPtr);
 
+IMG_VOID texOpStagingPoolInit(GLES2Context *gc);
+
+IMG_VOID texOpStagingPoolDeinit(GLES2Context *gc);
+
+IMG_PVOID texOpStagingAlloc(GLES2Context *gc, IMG_UINT32 ui32Size, IMG_UINT32 *pui32Class);
+
+IMG_VOID texOpStagingRelease(GLES2Context *gc, IMG_PVOID pvPtr, IMG_UINT32 ui32Class);
+
+IMG_VOID texOpStagingRetirePending(GLES2Context *gc);
+
 #endif /* _PSP2_SWTEXOP_ */
@@ -530,9 +530,12 @@ static IMG_BOOL StartFrame(GLES2Context *gc, IMG_UINT32 *pui32ClearFlags, PVRSRV
 	IMG_BOOL bFullScreenObject = IMG_FALSE;
 
 
-	/* Try to get rid of texture and shader ghosts */
+	/* Try to get rid of texture, shader and buffer object ghosts */
 	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->psTextureManager->sKRM);
 	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->sUSEShaderVariantKRM);
+	KRM_DestroyUnneededGhosts(gc, &gc->psSharedState->sBufferObjectKRM);
+	KRM_DestroyUnneededGhosts(gc, &gc->sPDSVertexVariantKRM);
+	KRM_DestroyUnneededGhosts(gc, &gc->sMTEStateBlockKRM);
 	
 	GLES2InitRegs(gc, *pui32ClearFlags);
 
@@ -1031,6 +1034,12 @@ static IMG_VOID PDumpBufferObject(GLES2Context *gc, const IMG_VOID* pvFunctionCo
 
 		PDUMP_MEM(gc, psBufferObject->psMemInfo, 0,
 		          psBufferObject->psMemInfo->uAllocSize);
+
+		if (psBufferObject->psOptimisedIndexMemInfo)
+		{
+			PDUMP_MEM(gc, psBufferObject->psOptimisedIndexMemInfo, 0,
+			          psBufferObject->psOptimisedIndexMemInfo->uAllocSize);
+		}
 		
 		psBufferObject->bDumped = IMG_TRUE;
 	}
@@ -1102,11 +1111,12 @@ static IMG_VOID PDumpShaders(GLES2Context *gc)
 {
 	IMG_UINT32         i, ui32Offset;
 	UCH_UseCodeBlock  *psCodeBlock;
-	UCH_UseCodeHeap   *apsHeap[3];
+	UCH_UseCodeHeap   *apsHeap[4];
 	
 	apsHeap[0] = gc->psSharedState->psUSEVertexCodeHeap;
 	apsHeap[1] = gc->psSharedState->psUSEFragmentCodeHeap;
 	apsHeap[2] = gc->psSharedState->psPDSFragmentCodeHeap;
+	apsHeap[3] = gc->psSharedState->psPDSVertexCodeHeap;
 
 #if defined(FIX_HW_BRN_26922)
 	if(gc->sPrim.sBRN26922State.bDump)
@@ -1126,7 +1136,7 @@ static IMG_VOID PDumpShaders(GLES2Context *gc)
 	/* For every heap, dump all blocks that have been allocated.
 	   Blocks owned by USE variant ghosts are tricky as they have no pointer back to the ghost that owns them.
 	*/
-	for(i=0; i < 3; ++i)
+	for(i=0; i < 4; ++i)
 	{
 		psCodeBlock = apsHeap[i]->psAllocatedBlockList;
 
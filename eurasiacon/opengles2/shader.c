@@ -42,7 +42,7 @@
  Returns            : -
  Description        : UTILITY: Adds a reference to shared shader state
 ************************************************************************************/
-static IMG_VOID SharedShaderStateAddRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
+IMG_INTERNAL IMG_VOID SharedShaderStateAddRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
 {
 	GLES_ASSERT(psSharedState);
 
@@ -56,6 +56,79 @@ static IMG_VOID SharedShaderStateAddRef(GLES2Context *gc, GLES2SharedShaderState
 }
 
 
+#if defined(SUPPORT_SOURCE_SHADER)
+/***********************************************************************************
+ Function Name      : FreeLinkedVaryings
+ Inputs             : psLinkedVaryings, ui32NumLinkedVaryings
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Frees a list of linked varyings and their names.
+************************************************************************************/
+static IMG_VOID FreeLinkedVaryings(GLSLLinkedVarying *psLinkedVaryings, IMG_UINT32 ui32NumLinkedVaryings)
+{
+	IMG_UINT32 i;
+
+	if(!psLinkedVaryings)
+	{
+		return;
+	}
+
+	for(i = 0; i < ui32NumLinkedVaryings; i++)
+	{
+		GLES2Free(IMG_NULL, psLinkedVaryings[i].pszName);
+	}
+
+	GLES2Free(IMG_NULL, psLinkedVaryings);
+}
+
+
+/***********************************************************************************
+ Function Name      : CopyLinkedVaryings
+ Inputs             : gc, psLinkedVaryings, ui32NumLinkedVaryings
+ Outputs            : -
+ Returns            : Copy of the list, or IMG_NULL if empty or out of memory
+ Description        : UTILITY: Makes a private copy of a list of linked varyings.
+************************************************************************************/
+static GLSLLinkedVarying *CopyLinkedVaryings(GLES2Context *gc, const GLSLLinkedVarying *psLinkedVaryings,
+											 IMG_UINT32 ui32NumLinkedVaryings)
+{
+	GLSLLinkedVarying *psCopy;
+	IMG_UINT32 i, ui32NameLength;
+
+	if(!ui32NumLinkedVaryings)
+	{
+		return IMG_NULL;
+	}
+
+	psCopy = GLES2Calloc(gc, ui32NumLinkedVaryings * sizeof(GLSLLinkedVarying));
+
+	if(!psCopy)
+	{
+		return IMG_NULL;
+	}
+
+	for(i = 0; i < ui32NumLinkedVaryings; i++)
+	{
+		psCopy[i] = psLinkedVaryings[i];
+
+		ui32NameLength = strlen(psLinkedVaryings[i].pszName);
+
+		psCopy[i].pszName = GLES2Malloc(gc, ui32NameLength + 1);
+
+		if(!psCopy[i].pszName)
+		{
+			FreeLinkedVaryings(psCopy, i);
+			return IMG_NULL;
+		}
+
+		GLES2MemCopy(psCopy[i].pszName, psLinkedVaryings[i].pszName, ui32NameLength + 1);
+	}
+
+	return psCopy;
+}
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
+
+
 /***********************************************************************************
  Function Name      : SharedShaderStateDelRef
  Inputs             : gc, psSharedState
@@ -64,10 +137,13 @@ static IMG_VOID SharedShaderStateAddRef(GLES2Context *gc, GLES2SharedShaderState
  Description        : UTILITY: Removes a reference to shared shader state.
                       If the reference count reaches zero, the shared state is freed.
 ************************************************************************************/
-static IMG_VOID SharedShaderStateDelRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
+IMG_INTERNAL IMG_VOID SharedShaderStateDelRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState)
 {
 	IMG_UINT32 i, j;
 	GLSLBindingSymbol *psSymbol;
+#if defined(SUPPORT_SOURCE_SHADER)
+	GLES2SharedShaderState *psLinkVariants = IMG_NULL;
+#endif
 
 	/* Ignore NULL argument silently */
 	if(psSharedState)
@@ -107,6 +183,8 @@ static IMG_VOID SharedShaderStateDelRef(GLES2Context *gc, GLES2SharedShaderState
 				GLES2Free(IMG_NULL, psSharedState->sBindingSymbolList.pfConstantData);
 			}
 
+			FreeSharedShaderPrewarmState(gc, psSharedState);
+
 			if(psSharedState->pvUniPatchShader)
 			{
 				PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, psSharedState->pvUniPatchShader);
@@ -119,11 +197,44 @@ static IMG_VOID SharedShaderStateDelRef(GLES2Context *gc, GLES2SharedShaderState
 
 			USESecondaryUploadTaskDelRef(gc, psSharedState->psSecondaryUploadTask);
 
+#if defined(SUPPORT_SOURCE_SHADER)
+			if(psSharedState->pszSpecialisationSource)
+			{
+				GLES2Free(IMG_NULL, psSharedState->pszSpecialisationSource);
+			}
+
+			FreeLinkedVaryings(psSharedState->psConstantVaryings, psSharedState->ui32NumConstantVaryings);
+			FreeLinkedVaryings(psSharedState->psLinkedVaryings, psSharedState->ui32NumLinkedVaryings);
+
+			if(psSharedState->pui32InternKey)
+			{
+				IMG_UINT32 ui32Item;
+
+				/* Frees the key */
+				HashTableDelete(gc, &gc->psSharedState->sShaderInternTable, psSharedState->tInternHash,
+								psSharedState->pui32InternKey, psSharedState->ui32InternKeySizeInDWords, &ui32Item);
+			}
+
+			/* The lock isn't recursive, so the variants are released once it has been dropped */
+			psLinkVariants = psSharedState->psLinkVariants;
+#endif
+
 			GLES2Free(IMG_NULL, psSharedState);
 		}
 
 		/* EXIT CRITICAL SECTION */
 		PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+#if defined(SUPPORT_SOURCE_SHADER)
+		while(psLinkVariants)
+		{
+			GLES2SharedShaderState *psVariant = psLinkVariants;
+
+			psLinkVariants = psVariant->psNextLinkVariant;
+
+			SharedShaderStateDelRef(gc, psVariant);
+		}
+#endif
 	}
 }
 
@@ -549,6 +660,19 @@ static GLES2SharedShaderState * CreateSharedShaderState(GLES2Context *gc,
 	psSharedState->eActiveVaryingMask = psUFCode->eActiveVaryingMask;
 	psSharedState->eProgramFlags = psCompiledProgram->eProgramFlags;
 
+#if defined(DEBUG)
+	psSharedState->sPerfReport = psUFCode->sPerfReport;
+#endif
+
+	/* Without the list constant varyings are simply never folded */
+	psSharedState->psConstantVaryings = CopyLinkedVaryings(gc, psCompiledProgram->psConstantVaryings,
+														   psCompiledProgram->uNumConstantVaryings);
+
+	if(psSharedState->psConstantVaryings)
+	{
+		psSharedState->ui32NumConstantVaryings = psCompiledProgram->uNumConstantVaryings;
+	}
+
 	return psSharedState;
 }
 
@@ -1260,6 +1384,7 @@ static IMG_BOOL LoadCompilerModule(GLES2Context *gc)
 	sFuncTable.pfnCompileToUniflex = GLSLCompileToUniflex;
 	sFuncTable.pfnFreeCompiledUniflexProgram = GLSLFreeCompiledUniflexProgram;
 	sFuncTable.pfnDisplayMetrics = GLSLDisplayMetrics;
+	sFuncTable.pfnGetPreprocessedTokens = GLSLGetPreprocessedTokens;
 	sFuncTable.pfnShutDownCompiler = GLSLShutDownCompiler;
 #if defined(GLES2_EXTENSION_GET_PROGRAM_BINARY)
 	sFuncTable.pfnCreateBinaryProgram = SGXBS_CreateBinaryProgram;
@@ -1268,7 +1393,8 @@ static IMG_BOOL LoadCompilerModule(GLES2Context *gc)
 	sFuncTable.pfnCreateBinaryShader = SGXBS_CreateBinaryShader;
 #endif
 	if(!(sFuncTable.pfnInitCompiler && sFuncTable.pfnCompileToUniflex &&
-	     sFuncTable.pfnFreeCompiledUniflexProgram && sFuncTable.pfnDisplayMetrics && sFuncTable.pfnShutDownCompiler
+	     sFuncTable.pfnFreeCompiledUniflexProgram && sFuncTable.pfnDisplayMetrics && sFuncTable.pfnShutDownCompiler &&
+	     sFuncTable.pfnGetPreprocessedTokens
 #if defined(GLES2_EXTENSION_GET_PROGRAM_BINARY)
 	     && sFuncTable.pfnCreateBinaryProgram
 #endif 
@@ -1389,429 +1515,1769 @@ static IMG_VOID PrintShaders(const IMG_CHAR* pszFmt, ...)
 #endif /* defined(DEBUG) */
 
 /***********************************************************************************
- Function Name      : InitializeGLSLCompiler
- Inputs             : gc, psInitCompilerContext
+ Function Name      : CompileShaderSource
+ Inputs             : gc, eProgramType, ppszSource, bFastTier, ui32NumSpecialisedComps,
+					  pui32SpecialisedCompFlags, pfSpecialisedCompData,
+					  ui32NumLinkedVaryings, psLinkedVaryings
  Outputs            : -
- Returns            : Success
- Description        : Initialises the GLSL compiler.
+ Returns            : Compiled program
+ Description        : Compiles a source shader down to UniPatch input. The fast tier
+					  runs USC at its lowest optimisation level. Flagged constant
+					  components are compiled as the given values, for uniform
+					  specialisation, and the linked varyings describe the other
+					  stage of a program, for link variants. The caller must hold
+					  the compiler lock.
 ************************************************************************************/
-IMG_INTERNAL IMG_BOOL InitializeGLSLCompiler(GLES2Context *gc)
+static GLSLCompiledUniflexProgram *CompileShaderSource(GLES2Context *gc, GLSLProgramType eProgramType,
+													   IMG_CHAR **ppszSource, IMG_BOOL bFastTier,
+													   IMG_UINT32 ui32NumSpecialisedComps,
+													   const IMG_UINT32 *pui32SpecialisedCompFlags,
+													   const IMG_FLOAT *pfSpecialisedCompData,
+													   IMG_UINT32 ui32NumLinkedVaryings,
+													   const GLSLLinkedVarying *psLinkedVaryings)
 {
-	GLSLInitCompilerContext *psInitCompilerContext = &gc->sProgram.sInitCompilerContext;
-	GLSLCompilerResources *psResources;
+	GLSLUniFlexHWCodeInfo sUniFlexInfo;
+	UNIFLEX_PROGRAM_PARAMETERS sUniFlexParams;
+	GLSLCompileProgramContext sCompileContext = {0};
+	GLSLCompileUniflexProgramContext sCompileUniflexContext;
 
-	if(gc->sProgram.hGLSLCompiler)
-	{
-		/* The compiler was already initialized */
-		PVR_DPF((PVR_DBG_WARNING, "InitializeGLSLCompiler: The compiler was already initialized\n"));
-		return IMG_TRUE;
-	}
+	GLES2MemSet(&sUniFlexInfo, 0, sizeof(GLSLUniFlexHWCodeInfo));
+	GLES2MemSet(&sUniFlexParams, 0, sizeof(UNIFLEX_PROGRAM_PARAMETERS));
 
-	/* Load the dynamic library */
-	if(!LoadCompilerModule(gc))
+	/* Must be able to fit a 2x2 block in */
+	sUniFlexParams.uNumAvailableTemporaries = gc->psSysContext->sHWInfo.ui32NumUSETemporaryRegisters >> 2;
+
+	if (eProgramType == GLSLPT_FRAGMENT)
 	{
-		return IMG_FALSE;
-	}
+		sUniFlexParams.uConstantBase		= GLES2_FRAGMENT_SECATTR_CONSTANTBASE;
+		sUniFlexParams.uIndexableTempBase	= GLES2_FRAGMENT_SECATTR_INDEXABLETEMPBASE;
+		sUniFlexParams.uScratchBase			= GLES2_FRAGMENT_SECATTR_SCRATCHBASE;
 
-	/* Reset to zeroes as recommended by the compiler documentation */
-	GLES2MemSet(psInitCompilerContext, (IMG_UINT8)0, sizeof(GLSLInitCompilerContext));
+		sUniFlexParams.uInRegisterConstantOffset = GLES2_FRAGMENT_SECATTR_NUM_RESERVED;
+		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_PS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
 
-	if(gc->sAppHints.bDumpCompilerLogFiles)
-	{
-		psInitCompilerContext->eLogFiles = GLSLLF_LOG_ALL;
+		sUniFlexParams.uPackDestType = USEASM_REGTYPE_PRIMATTR;
+		sUniFlexParams.uPackPrecision = 5; /* Arbitrary choice */
+		sUniFlexParams.uExtraPARegisters = 0;
 	}
 	else
 	{
-		psInitCompilerContext->eLogFiles = GLSLLF_NOT_LOG;
+		sUniFlexParams.uConstantBase		= GLES2_VERTEX_SECATTR_CONSTANTBASE;
+		sUniFlexParams.uIndexableTempBase	= GLES2_VERTEX_SECATTR_INDEXABLETEMPBASE;
+		sUniFlexParams.uScratchBase			= GLES2_VERTEX_SECATTR_SCRATCHBASE;
+	
+		sUniFlexParams.uInRegisterConstantOffset = GLES2_VERTEX_SECATTR_NUM_RESERVED;
+		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_VS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
+
+		sUniFlexParams.uExtraPARegisters = 0;
 	}
 
-#if defined(DEBUG)
-	if(gc->pShaderAnalysisHandle)
+	sUniFlexParams.ePredicationLevel = UF_PREDLVL_AUTO;
+	sUniFlexParams.uMaxALUInstsToFlatten = 0;
+
+	if(bFastTier)
 	{
-		psInitCompilerContext->pfnPrintShaders = PrintShaders;
+		/* Skip USC's expensive optimisation passes */
+		sUniFlexParams.uFlags = UF_RESTRICTOPTIMIZATIONS;
+		sUniFlexParams.uOptimizationLevel = 0;
 	}
 
-	psInitCompilerContext->bEnableUSCMemoryTracking = gc->sAppHints.bTrackUSCMemory;
-#endif
-
-	psResources = &psInitCompilerContext->sCompilerResources;
-	psResources->iGLMaxVertexAttribs = GLES2_MAX_VERTEX_ATTRIBS;
-	psResources->iGLMaxVertexUniformVectors = GLES2_MAX_VERTEX_UNIFORM_VECTORS;
-	psResources->iGLMaxVaryingVectors = GLES2_MAX_VARYING_VECTORS;
-	psResources->iGLMaxVertexTextureImageUnits = GLES2_MAX_VERTEX_TEXTURE_UNITS;
-	psResources->iGLMaxCombinedTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
-	psResources->iGLMaxTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
-	psResources->iGLMaxFragmentUniformVectors = GLES2_MAX_FRAGMENT_UNIFORM_VECTORS;
-	psResources->iGLMaxDrawBuffers = GLES2_MAX_DRAW_BUFFERS;
+	sUniFlexInfo.psUFParams = &sUniFlexParams;
 
-	/* If no apphint is set, default GLSL ES precisions are specified */
-	SetPrecision(&psInitCompilerContext->sRequestedPrecisions, gc->sAppHints.ui32AdjustShaderPrecision);
+	sCompileUniflexContext.eOutputCodeType = GLSLPF_UNIFLEX_OUTPUT;
+	sCompileUniflexContext.psUniflexHWCodeInfo = &sUniFlexInfo;
+	sCompileUniflexContext.psCompileProgramContext = &sCompileContext;
 
-	/* Set inline rules */
-	psInitCompilerContext->sInlineFuncRules.bInlineCalledOnceFunc			= IMG_TRUE;	/* No penalty for setting this */
-	psInitCompilerContext->sInlineFuncRules.bInlineSamplerParamFunc			= IMG_TRUE;	/* Should always be true; */
-	psInitCompilerContext->sInlineFuncRules.uNumICInstrsBodyLessThan		= 10;		/* 10 intermediate instructions */
-	psInitCompilerContext->sInlineFuncRules.uNumParamComponentsGreaterThan	= 32;		/* Up to 8 vec4s */
+	/* Constant components USC should treat as known values */
+	sCompileUniflexContext.uSpecialisedConstCount = ui32NumSpecialisedComps;
+	sCompileUniflexContext.puSpecialisedConstFlags = pui32SpecialisedCompFlags;
+	sCompileUniflexContext.pfSpecialisedConstData = pfSpecialisedCompData;
 
-	/* Set unroll rules */
-	psInitCompilerContext->sUnrollLoopRules.bEnableUnroll					= IMG_TRUE;	/* Enable unrolling */
-	psInitCompilerContext->sUnrollLoopRules.bUnrollRelativeAddressingOnly	= IMG_TRUE; /* Only enable unroll if contain relative addressing */
-	psInitCompilerContext->sUnrollLoopRules.uMaxNumIterations				= 50;		/* The number of iterations has to be less than */
+	/* What the other stage of the program reads or writes */
+	sCompileUniflexContext.uNumLinkedVaryings = ui32NumLinkedVaryings;
+	sCompileUniflexContext.psLinkedVaryings = psLinkedVaryings;
 
-	if(!gc->sProgram.sGLSLFuncTable.pfnInitCompiler(psInitCompilerContext))
+#if !defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	/* Unconditionally create the MSAA trans version of the shader, in case it is used with a MSAA surface 
+	 * after being compiled while a non-MSAA surface is bound.
+	 */
+	if(eProgramType == GLSLPT_FRAGMENT)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "InitializeGLSLCompiler: Failed to initialise the GLSL compiler !\n"));
-		return IMG_FALSE;
+		sCompileUniflexContext.bCompileMSAATrans = IMG_TRUE;
+	}
+	else
+#endif
+	{
+		sCompileUniflexContext.bCompileMSAATrans = IMG_FALSE;
 	}
 
-	return IMG_TRUE;
+	sCompileContext.psInitCompilerContext = &gc->sProgram.sInitCompilerContext;
+	sCompileContext.eProgramType = eProgramType;
+	sCompileContext.ppszSourceCodeStrings = ppszSource;
+	sCompileContext.uNumSourceCodeStrings = 1;
+
+	sCompileContext.bCompleteProgram = IMG_TRUE;
+	sCompileContext.bDisplayMetrics = IMG_FALSE;
+	sCompileContext.bValidateOnly = IMG_FALSE;
+	sCompileContext.eEnabledWarnings = gc->sAppHints.ui32GLSLEnabledWarnings;
+
+	return gc->sProgram.sGLSLFuncTable.pfnCompileToUniflex(&sCompileUniflexContext);
 }
 
+
 /***********************************************************************************
- Function Name      : DestroyGLSLCompiler
+ Function Name      : LockGLSLCompiler
  Inputs             : gc
  Outputs            : -
  Returns            : -
- Description        : Destroys the GLSL compiler. This is called when an app calls
-                      glReleaseShaderCompiler and after the names arrays are destroyed.
+ Description        : Serialises use of the compiler with the background re-optimisation
+					  worker. Does nothing when the worker is not running.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID DestroyGLSLCompiler(GLES2Context *gc)
+IMG_INTERNAL IMG_VOID LockGLSLCompiler(GLES2Context *gc)
 {
-	/* The compiler may have been explicitly destroyed by the app or maybe the app only used binary shaders. */
-	if(gc->sProgram.hGLSLCompiler)
+	if(gc->sProgram.hCompilerLock)
 	{
-#if defined(TIMING)
-		gc->sProgram.sGLSLFuncTable.pfnDisplayMetrics(&gc->sProgram.sInitCompilerContext);
-#endif
-		gc->sProgram.sGLSLFuncTable.pfnShutDownCompiler(&gc->sProgram.sInitCompilerContext);
-		UnloadCompilerModule(gc);
+		PVRSRVLockMutex(gc->sProgram.hCompilerLock);
 	}
 }
 
-#endif /* defined(SUPPORT_SOURCE_SHADER) */
-
-static IMG_VOID * IMG_CALLCONV UniPatchMalloc(IMG_UINT32 ui32Size )
-{
-	/* IMPORTANT: if this call is not kept GL-context independent, then allocating a shader in one context
-	              and freeing it in a different context will not work as we will allocate it in one heap
-	              and deallocate from a different heap (think Symbian).
-	*/
-	return GLES2Malloc(0, ui32Size);
-}
 
-static IMG_VOID IMG_CALLCONV UniPatchFree(IMG_VOID *pvData)
+/***********************************************************************************
+ Function Name      : UnlockGLSLCompiler
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Releases the lock taken by LockGLSLCompiler.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID UnlockGLSLCompiler(GLES2Context *gc)
 {
-	GLES2Free(0, pvData);
+	if(gc->sProgram.hCompilerLock)
+	{
+		PVRSRVUnlockMutex(gc->sProgram.hCompilerLock);
+	}
 }
 
 
-static IMG_VOID IMG_CALLCONV UniPatchDebugPrint(const IMG_CHAR* pszFormat, ...) IMG_FORMAT_PRINTF(1,2);
-
-static IMG_VOID IMG_CALLCONV UniPatchDebugPrint(const IMG_CHAR* pszFormat, ...)
+/***********************************************************************************
+ Function Name      : AppendShaderReoptJob
+ Inputs             : gc, psJob
+ Outputs            : -
+ Returns            : -
+ Description        : Adds a job to the end of the background worker's list, so jobs
+					  are run in the order they were queued.
+************************************************************************************/
+static IMG_VOID AppendShaderReoptJob(GLES2Context *gc, GLES2ShaderReoptJob *psJob)
 {
-#if defined(DEBUG)
-	__GLES2_GET_CONTEXT();
+	GLES2ShaderReoptJob **ppsTail;
 
-	if(gc->sAppHints.bDumpUSPOutput)
-	{
-		SceUID fd = sceIoDopen("ux0:data/gles/usp");
+	PVRSRVLockMutex(gc->sProgram.hReoptLock);
 
-		if (fd <= 0)
-		{
-			sceIoMkdir("ux0:data/gles", 0777);
-			sceIoMkdir("ux0:data/gles/usp", 0777);
-		}
-		else
-		{
-			sceIoDclose(fd);
-		}
+	ppsTail = &gc->sProgram.psReoptJobs;
 
+	while(*ppsTail)
+	{
+		ppsTail = &(*ppsTail)->psNext;
+	}
 
-		FILE    *fstream = fopen("ux0:data/gles/usp/usp_out.txt","a+t");
-		va_list vaList;
+	*ppsTail = psJob;
 
-		if(fstream)
-		{
-			/* Write out the disassembly of the machine code generated by unipatch */
-			va_start(vaList, pszFormat);
-			vfprintf(fstream, pszFormat, vaList);
-			va_end(vaList);
-		}
-		else
-		{
-			PVR_DPF((PVR_DBG_WARNING, "UniPatchDebugPrint: Could not open file. Cannot dump USP output"));
-		}
-	}
-#else
-	PVR_UNREFERENCED_PARAMETER(pszFormat);
-#endif
+	PVRSRVUnlockMutex(gc->sProgram.hReoptLock);
 }
 
 
 /***********************************************************************************
- Function Name      : DestroyHashedPDSVariant
- Inputs             : 
- Outputs            : 
- Returns            : 
- Description        : 
+ Function Name      : QueueShaderReoptimisation
+ Inputs             : gc, psSharedState, eProgramType, pszSource
+ Outputs            : -
+ Returns            : -
+ Description        : Queues a fast tier shader for recompilation at full optimisation.
+					  The worker is only woken at a frame boundary, see
+					  ServiceShaderReoptimisations. On failure the shader simply stays
+					  at the fast tier.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID DestroyHashedPDSVariant(GLES2Context *gc, IMG_UINT32 ui32Item)
+static IMG_VOID QueueShaderReoptimisation(GLES2Context *gc, GLES2SharedShaderState *psSharedState,
+										  GLSLProgramType eProgramType, const IMG_CHAR *pszSource)
 {
-	GLES2PDSCodeVariant **ppsPDSVariantList, *psPDSVariant;
-	GLES2USEShaderVariant *psUSEVariant;
+	GLES2ShaderReoptJob *psJob;
+	IMG_UINT32 ui32SourceLength;
 
-	PVR_UNREFERENCED_PARAMETER(gc);
+	if(!pszSource)
+	{
+		return;
+	}
 
-	psUSEVariant = ((GLES2PDSCodeVariant *)ui32Item)->psUSEVariant;
-	ppsPDSVariantList = &psUSEVariant->psPDSVariant;
+	psJob = GLES2Calloc(gc, sizeof(GLES2ShaderReoptJob));
 
-	while(*ppsPDSVariantList)
+	if(!psJob)
 	{
-		if(*ppsPDSVariantList == (GLES2PDSCodeVariant *)ui32Item)
-		{
-			psPDSVariant = *ppsPDSVariantList;
-			*ppsPDSVariantList = psPDSVariant->psNext;
-			
-			UCH_CodeHeapFree(psPDSVariant->psCodeBlock);
-			GLES2Free(IMG_NULL, psPDSVariant);
-			return;
-		}
-			
-		ppsPDSVariantList = &((*ppsPDSVariantList)->psNext);
+		return;
 	}
+
+	ui32SourceLength = strlen(pszSource);
+
+	psJob->pszSource = GLES2Malloc(gc, ui32SourceLength + 1);
+
+	if(!psJob->pszSource)
+	{
+		GLES2Free(IMG_NULL, psJob);
+
+		return;
+	}
+
+	GLES2MemCopy(psJob->pszSource, pszSource, ui32SourceLength + 1);
+
+	SharedShaderStateAddRef(gc, psSharedState);
+
+	psJob->psSharedState = psSharedState;
+	psJob->eProgramType = eProgramType;
+	psJob->eState = GLES2_SHADER_REOPT_PENDING;
+
+	AppendShaderReoptJob(gc, psJob);
 }
 
 
 /***********************************************************************************
- Function Name      : ReclaimUSEShaderVariantMemKRM
- Inputs             : gc, psResource
+ Function Name      : KeepSourceForSpecialisation
+ Inputs             : gc, psSharedState, pszSource
  Outputs            : -
  Returns            : -
- Description        : Reclaims the device memory of a use shader variant. This function
-					  also destroys the variant itself, as we are not managing a top 
-					  level GL resource and we can easily create a new version of the 
-					  variant.
+ Description        : Keeps a copy of a compiled shader's source when uniform
+					  specialisation or linked varying optimisation is enabled, as
+					  the app may replace it after linking. Without one the shader
+					  is never specialised or recompiled at link time.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID ReclaimUSEShaderVariantMemKRM(IMG_VOID *pvContext, KRMResource *psResource)
+static IMG_VOID KeepSourceForSpecialisation(GLES2Context *gc, GLES2SharedShaderState *psSharedState, const IMG_CHAR *pszSource)
 {
-	/* Note the tricky pointer arithmetic. It is necessary */
-	GLES2USEShaderVariant *psUSEVariant = (GLES2USEShaderVariant*)((IMG_UINTPTR_T)psResource -offsetof(GLES2USEShaderVariant, sResource));
-	GLES2Context	 *gc = (GLES2Context *)pvContext;
+	IMG_UINT32 ui32SourceLength;
 
-	DestroyUSEShaderVariant(gc, psUSEVariant);
+	if(!pszSource)
+	{
+		return;
+	}
+
+	if((!gc->sAppHints.ui32UniformSpecialisationDraws || !gc->sProgram.hReoptThread) &&
+	   !gc->sAppHints.bOptimiseLinkedVaryings)
+	{
+		return;
+	}
+
+	ui32SourceLength = strlen(pszSource);
+
+	psSharedState->pszSpecialisationSource = GLES2Malloc(gc, ui32SourceLength + 1);
+
+	if(psSharedState->pszSpecialisationSource)
+	{
+		GLES2MemCopy(psSharedState->pszSpecialisationSource, pszSource, ui32SourceLength + 1);
+	}
 }
 
 
 /***********************************************************************************
- Function Name      : DestroyUSECodeVariantGhostKRM
- Inputs             : gc, psResource
+ Function Name      : ShaderReoptThread
+ Inputs             : ui32ArgSize, pvArgBlock
  Outputs            : -
  Returns            : -
- Description        : Destroys a ghosted USSE code variant.
+ Description        : Background worker. Recompiles pending jobs at full optimisation
+					  for as long as the app is not compiling shaders itself, and
+					  frees the compiler output of jobs that have been retired.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID DestroyUSECodeVariantGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
+static IMG_INT32 ShaderReoptThread(IMG_UINT32 ui32ArgSize, IMG_VOID *pvArgBlock)
 {
-	/* Note the tricky pointer arithmetic. It is necessary */
-	GLES2USEShaderVariantGhost *psUSEVariantGhost =
-		(GLES2USEShaderVariantGhost*)((IMG_UINTPTR_T)psResource -offsetof(GLES2USEShaderVariantGhost, sResource));
-	GLES2Context	 *gc = (GLES2Context *)pvContext;
+	GLES2Context *gc = *(GLES2Context **)pvArgBlock;
+	GLES2ShaderReoptJob *psJob, **ppsJob;
+	GLSLCompiledUniflexProgram *psCompiledProgram;
 
-	DestroyUSEShaderVariantGhost(gc, psUSEVariantGhost);
+	PVR_UNREFERENCED_PARAMETER(ui32ArgSize);
+
+	/* The compiler's debug callbacks look the context up through TLS */
+	__GLES2_SET_CONTEXT(gc);
+
+	for(;;)
+	{
+		PVRSRVWaitSemaphore(gc->sProgram.hReoptSemaphore, IMG_SEMAPHORE_WAIT_INFINITE);
+
+		if(gc->sProgram.bReoptThreadExit)
+		{
+			break;
+		}
+
+		for(;;)
+		{
+			PVRSRVLockMutex(gc->sProgram.hCompilerLock);
+			PVRSRVLockMutex(gc->sProgram.hReoptLock);
+
+			psJob = IMG_NULL;
+			ppsJob = &gc->sProgram.psReoptJobs;
+
+			while(*ppsJob)
+			{
+				if((*ppsJob)->eState == GLES2_SHADER_REOPT_RETIRED)
+				{
+					GLES2ShaderReoptJob *psRetired = *ppsJob;
+
+					*ppsJob = psRetired->psNext;
+
+					gc->sProgram.sGLSLFuncTable.pfnFreeCompiledUniflexProgram(&gc->sProgram.sInitCompilerContext,
+																				 psRetired->psCompiledProgram);
+					GLES2Free(IMG_NULL, psRetired);
+				}
+				else
+				{
+					if(!psJob && (*ppsJob)->eState == GLES2_SHADER_REOPT_PENDING)
+					{
+						psJob = *ppsJob;
+					}
+
+					ppsJob = &(*ppsJob)->psNext;
+				}
+			}
+
+			/* Back off as soon as the app starts compiling again */
+			if(!psJob || gc->sProgram.ui32CompilesThisFrame || gc->sProgram.bReoptThreadExit)
+			{
+				PVRSRVUnlockMutex(gc->sProgram.hReoptLock);
+				PVRSRVUnlockMutex(gc->sProgram.hCompilerLock);
+				break;
+			}
+
+			psJob->eState = GLES2_SHADER_REOPT_RUNNING;
+
+			PVRSRVUnlockMutex(gc->sProgram.hReoptLock);
+
+			psCompiledProgram = CompileShaderSource(gc, psJob->eProgramType, &psJob->pszSource, IMG_FALSE,
+													psJob->ui32NumSpecialisedComps,
+													psJob->pui32SpecialisedCompFlags,
+													psJob->pfSpecialisedCompData,
+													psJob->psSharedState->ui32NumLinkedVaryings,
+													psJob->psSharedState->psLinkedVaryings);
+
+			PVRSRVLockMutex(gc->sProgram.hReoptLock);
+
+			psJob->psCompiledProgram = psCompiledProgram;
+			psJob->eState = GLES2_SHADER_REOPT_DONE;
+
+			PVRSRVUnlockMutex(gc->sProgram.hReoptLock);
+			PVRSRVUnlockMutex(gc->sProgram.hCompilerLock);
+		}
+	}
+
+	return sceKernelExitDeleteThread(0);
 }
 
 
 /***********************************************************************************
- Function Name      : GhostUSEShaderVariant
- Inputs             : gc, psUSEVariant
+ Function Name      : StartShaderReoptThread
+ Inputs             : gc
  Outputs            : -
- Returns            : -
- Description        : Ghosts a USSE shader variant and destroys the original.
+ Returns            : Success
+ Description        : Creates the locks and the worker used for background
+					  re-optimisation of fast tier shaders.
 ************************************************************************************/
-static IMG_VOID GhostUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVariant *psUSEVariant)
+static IMG_BOOL StartShaderReoptThread(GLES2Context *gc)
 {
-	GLES2USEShaderVariantGhost *psUSEVariantGhost;
-	GLES2PDSCodeVariant        *psPDSVariant;
-	GLES2PDSCodeVariantGhost   *psPDSVariantGhost;
-
-	/* We only ghost fragment shaders. For vertex shaders we kick the TA and wait */
-	GLES_ASSERT(psUSEVariant->psProgramShader && psUSEVariant->psProgramShader->eProgramType == GLSLPT_FRAGMENT);
-
-	psUSEVariantGhost = GLES2Calloc(gc, sizeof(GLES2USEShaderVariantGhost));
+	GLES2ProgramMachine *psProgramMachine = &gc->sProgram;
 
-	if(!psUSEVariantGhost)
+	if(PVRSRVCreateMutex(&psProgramMachine->hCompilerLock) != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "GhostUSEShaderVariant: Out of memory. Could not ghost USE variant at %p\n", psUSEVariant));
-
-		SetError(gc, GL_OUT_OF_MEMORY);
+		goto FAILED_CompilerLock;
+	}
 
-		return;
+	if(PVRSRVCreateMutex(&psProgramMachine->hReoptLock) != PVRSRV_OK)
+	{
+		goto FAILED_ReoptLock;
 	}
 
-	/* Transfer ownership of the USE code block from the variant to the ghost */
-	psUSEVariantGhost->psUSECodeBlock  = psUSEVariant->psCodeBlock;
-	psUSEVariant->psCodeBlock          = IMG_NULL;
+	if(PVRSRVCreateSemaphore(&psProgramMachine->hReoptSemaphore, 0) != PVRSRV_OK)
+	{
+		goto FAILED_ReoptSemaphore;
+	}
 
-	USESecondaryUploadTaskAddRef(gc, psUSEVariant->psSecondaryUploadTask);
-	psUSEVariantGhost->psSecondaryUploadTask = psUSEVariant->psSecondaryUploadTask;
+	psProgramMachine->psReoptJobs = IMG_NULL;
+	psProgramMachine->bReoptThreadExit = IMG_FALSE;
+	psProgramMachine->ui32CompilesThisFrame = 0;
 
+	psProgramMachine->hReoptThread = sceKernelCreateThread("OGLES2ShaderReopt", ShaderReoptThread, SCE_KERNEL_LOWEST_PRIORITY_USER, SCE_KERNEL_256KiB, 0, 0, SCE_NULL);
 
-	psUSEVariantGhost->psScratchMem = psUSEVariant->psScratchMem;
-	ShaderScratchMemAddRef(gc, psUSEVariantGhost->psScratchMem);
+	if(psProgramMachine->hReoptThread <= 0)
+	{
+		psProgramMachine->hReoptThread = 0;
 
-	psUSEVariantGhost->psIndexableTempsMem = psUSEVariant->psIndexableTempsMem;
-	ShaderIndexableTempsMemAddRef(gc, psUSEVariantGhost->psIndexableTempsMem);
+		goto FAILED_ReoptThread;
+	}
 
+	sceKernelStartThread(psProgramMachine->hReoptThread, sizeof(GLES2Context *), &gc);
 
-	psPDSVariant = psUSEVariant->psPDSVariant;
+	return IMG_TRUE;
 
-	/* Transfer ownership of the PDS code blocks from the PDS variants to the PDS ghosts */
-	while(psPDSVariant)
-	{
-		psPDSVariantGhost = GLES2Calloc(gc, sizeof(GLES2PDSCodeVariantGhost));
-		
-		if(!psPDSVariantGhost)
-		{
-			DestroyUSEShaderVariantGhost(gc, psUSEVariantGhost);
+FAILED_ReoptThread:
 
-			PVR_DPF((PVR_DBG_ERROR, "GhostUSEShaderVariant: Out of memory. Could not ghost USE variant at %p\n", psUSEVariant));
+	PVRSRVDestroySemaphore(psProgramMachine->hReoptSemaphore);
 
-			SetError(gc, GL_OUT_OF_MEMORY);
+FAILED_ReoptSemaphore:
 
-			return;
-		}
+	PVRSRVDestroyMutex(psProgramMachine->hReoptLock);
 
-		psPDSVariantGhost->psCodeBlock = psPDSVariant->psCodeBlock;
-		psPDSVariant->psCodeBlock = IMG_NULL;
+FAILED_ReoptLock:
 
-		/* Insert the PDS variant ghost at the front of the list */
-		psPDSVariantGhost->psNext = psUSEVariantGhost->psPDSVariantGhost;
-		psUSEVariantGhost->psPDSVariantGhost = psPDSVariantGhost;
+	PVRSRVDestroyMutex(psProgramMachine->hCompilerLock);
 
-		psPDSVariant = psPDSVariant->psNext;
-	}
+FAILED_CompilerLock:
 
-	/* The creation of the ghost was successfull. Notify the KRM */
-	KRM_GhostResource(&gc->psSharedState->sUSEShaderVariantKRM, 
-							&psUSEVariant->sResource, &psUSEVariantGhost->sResource);
+	psProgramMachine->hCompilerLock = IMG_NULL;
+	psProgramMachine->hReoptLock = IMG_NULL;
+	psProgramMachine->hReoptSemaphore = IMG_NULL;
 
-	/* Finally, destroy the original */
-	DestroyUSEShaderVariant(gc, psUSEVariant);
+	PVR_DPF((PVR_DBG_WARNING, "StartShaderReoptThread: Couldn't start the worker, shaders will be fully optimised up front"));
 
-	return;
+	return IMG_FALSE;
 }
 
 
 /***********************************************************************************
- Function Name      : FreeListOfVertexUSEVariants
+ Function Name      : StopShaderReoptThread
  Inputs             : gc
-                      ppsUSEVariantListHead - The head of the list of variants
- Outputs            : 
- Returns            : 
- Description        : Frees a linked list of vertex USE variants and their attached PDS variants.
+ Outputs            : -
+ Returns            : -
+ Description        : Stops the background worker and drops any jobs that were not
+					  applied yet. Those shaders stay at the fast tier.
 ************************************************************************************/
-static IMG_VOID FreeListOfVertexUSEVariants(GLES2Context *gc, GLES2USEShaderVariant **ppsUSEVariantListHead)
+static IMG_VOID StopShaderReoptThread(GLES2Context *gc)
 {
-	GLES2USEShaderVariant     *psUSEVariant, *psUSEVariantNext;
+	GLES2ProgramMachine *psProgramMachine = &gc->sProgram;
+	GLES2ShaderReoptJob *psJob;
 
-	psUSEVariant = *ppsUSEVariantListHead;
+	if(!psProgramMachine->hReoptThread)
+	{
+		return;
+	}
 
-	if(psUSEVariant)
+	psProgramMachine->bReoptThreadExit = IMG_TRUE;
+
+	PVRSRVPostSemaphore(psProgramMachine->hReoptSemaphore, 1);
+
+	sceKernelWaitThreadEnd(psProgramMachine->hReoptThread, SCE_NULL, SCE_NULL);
+
+	psProgramMachine->hReoptThread = 0;
+
+	while(psProgramMachine->psReoptJobs)
 	{
-		if(gc->psRenderSurface)
+		psJob = psProgramMachine->psReoptJobs;
+		psProgramMachine->psReoptJobs = psJob->psNext;
+
+		if(psJob->psCompiledProgram)
 		{
-			/* Before relinking kick the TA and wait. Then free the vertex variants. */
-			if(ScheduleTA(gc, gc->psRenderSurface, GLES2_SCHEDULE_HW_WAIT_FOR_TA) != IMG_EGL_NO_ERROR)
-			{
-				PVR_DPF((PVR_DBG_ERROR, "FreeListOfVertexUSEVariants: Kicking the TA failed\n"));
-				return;
-			}
+			psProgramMachine->sGLSLFuncTable.pfnFreeCompiledUniflexProgram(&psProgramMachine->sInitCompilerContext,
+																		   psJob->psCompiledProgram);
 		}
 
-		do
+		if(psJob->eState != GLES2_SHADER_REOPT_RETIRED)
 		{
-			psUSEVariantNext = psUSEVariant->psNext;
+			if(psJob->pui32SpecialisedCompFlags)
+			{
+				GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_DISCARD_COUNT, 1);
 
-			DestroyUSEShaderVariant(gc, psUSEVariant);
+				PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
 
-			if(gc->sProgram.psCurrentVertexVariant==psUSEVariant)
+				if(psJob->psSpecialisation)
+				{
+					psJob->psSpecialisation->psJob = IMG_NULL;
+				}
+
+				PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+			}
+			else
 			{
-				gc->sProgram.psCurrentVertexVariant=IMG_NULL;
-			}	
+				GLES2_INC_COUNT(GLES2_TIMER_SHADER_REOPTIMISE_DISCARD_COUNT, 1);
+			}
 
-			/* Keep the list consistent as DestroyUSEShaderVariant requires it */
-			psUSEVariant = psUSEVariantNext;
+			GLES2Free(IMG_NULL, psJob->pszSource);
 
-			*ppsUSEVariantListHead = psUSEVariant;
+			SharedShaderStateDelRef(gc, psJob->psSharedState);
 		}
-		while(psUSEVariant);
+
+		GLES2Free(IMG_NULL, psJob->pui32SpecialisedCompFlags);
+		GLES2Free(IMG_NULL, psJob->pfSpecialisedCompData);
+		GLES2Free(IMG_NULL, psJob);
 	}
+
+	PVRSRVDestroySemaphore(psProgramMachine->hReoptSemaphore);
+	PVRSRVDestroyMutex(psProgramMachine->hReoptLock);
+	PVRSRVDestroyMutex(psProgramMachine->hCompilerLock);
+
+	psProgramMachine->hCompilerLock = IMG_NULL;
+	psProgramMachine->hReoptLock = IMG_NULL;
+	psProgramMachine->hReoptSemaphore = IMG_NULL;
 }
 
 
 /***********************************************************************************
- Function Name      : DestroyVertexVariants
- Inputs             : gc, psNamedItem
+ Function Name      : InitializeGLSLCompiler
+ Inputs             : gc, psInitCompilerContext
  Outputs            : -
- Returns            : -
- Description        : Deletes all vertex variants for a given program.
+ Returns            : Success
+ Description        : Initialises the GLSL compiler.
 ************************************************************************************/
-IMG_INTERNAL IMG_VOID DestroyVertexVariants(GLES2Context *gc, const IMG_VOID* pvAttachment, GLES2NamedItem *psNamedItem)
+IMG_INTERNAL IMG_BOOL InitializeGLSLCompiler(GLES2Context *gc)
 {
-	GLES2Program *psProgram = (GLES2Program*)psNamedItem;
+	GLSLInitCompilerContext *psInitCompilerContext = &gc->sProgram.sInitCompilerContext;
+	GLSLCompilerResources *psResources;
 
-	PVR_UNREFERENCED_PARAMETER(pvAttachment);
+	if(gc->sProgram.hGLSLCompiler)
+	{
+		/* The compiler was already initialized */
+		PVR_DPF((PVR_DBG_WARNING, "InitializeGLSLCompiler: The compiler was already initialized\n"));
+		return IMG_TRUE;
+	}
 
-	GLES_ASSERT(psProgram);
+	/* Load the dynamic library */
+	if(!LoadCompilerModule(gc))
+	{
+		return IMG_FALSE;
+	}
 
-	if(psProgram->ui32Type == GLES2_SHADERTYPE_PROGRAM)
+	/* Reset to zeroes as recommended by the compiler documentation */
+	GLES2MemSet(psInitCompilerContext, (IMG_UINT8)0, sizeof(GLSLInitCompilerContext));
+
+	if(gc->sAppHints.bDumpCompilerLogFiles)
 	{
-		FreeListOfVertexUSEVariants(gc, &psProgram->sVertex.psVariant);
+		psInitCompilerContext->eLogFiles = GLSLLF_LOG_ALL;
+	}
+	else
+	{
+		psInitCompilerContext->eLogFiles = GLSLLF_NOT_LOG;
 	}
-}
 
+#if defined(DEBUG)
+	if(gc->pShaderAnalysisHandle)
+	{
+		psInitCompilerContext->pfnPrintShaders = PrintShaders;
+	}
+
+	psInitCompilerContext->bEnableUSCMemoryTracking = gc->sAppHints.bTrackUSCMemory;
+#endif
+
+	psResources = &psInitCompilerContext->sCompilerResources;
+	psResources->iGLMaxVertexAttribs = GLES2_MAX_VERTEX_ATTRIBS;
+	psResources->iGLMaxVertexUniformVectors = GLES2_MAX_VERTEX_UNIFORM_VECTORS;
+	psResources->iGLMaxVaryingVectors = GLES2_MAX_VARYING_VECTORS;
+	psResources->iGLMaxVertexTextureImageUnits = GLES2_MAX_VERTEX_TEXTURE_UNITS;
+	psResources->iGLMaxCombinedTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxFragmentUniformVectors = GLES2_MAX_FRAGMENT_UNIFORM_VECTORS;
+	psResources->iGLMaxDrawBuffers = GLES2_MAX_DRAW_BUFFERS;
+
+	/* If no apphint is set, default GLSL ES precisions are specified */
+	SetPrecision(&psInitCompilerContext->sRequestedPrecisions, gc->sAppHints.ui32AdjustShaderPrecision);
+
+	/* Set inline rules */
+	psInitCompilerContext->sInlineFuncRules.bInlineCalledOnceFunc			= IMG_TRUE;	/* No penalty for setting this */
+	psInitCompilerContext->sInlineFuncRules.bInlineSamplerParamFunc			= IMG_TRUE;	/* Should always be true; */
+	psInitCompilerContext->sInlineFuncRules.uNumICInstrsBodyLessThan		= 10;		/* 10 intermediate instructions */
+	psInitCompilerContext->sInlineFuncRules.uNumParamComponentsGreaterThan	= 32;		/* Up to 8 vec4s */
+
+	/* Set unroll rules */
+	psInitCompilerContext->sUnrollLoopRules.bEnableUnroll					= IMG_TRUE;	/* Enable unrolling */
+	psInitCompilerContext->sUnrollLoopRules.bUnrollRelativeAddressingOnly	= IMG_TRUE; /* Only enable unroll if contain relative addressing */
+	psInitCompilerContext->sUnrollLoopRules.uMaxNumIterations				= 50;		/* The number of iterations has to be less than */
+
+	if(!gc->sProgram.sGLSLFuncTable.pfnInitCompiler(psInitCompilerContext))
+	{
+		PVR_DPF((PVR_DBG_ERROR, "InitializeGLSLCompiler: Failed to initialise the GLSL compiler !\n"));
+		return IMG_FALSE;
+	}
+
+	if((gc->sAppHints.ui32ShaderCompileTier == GLES2_SHADER_TIER_REOPTIMISE) ||
+	   gc->sAppHints.ui32UniformSpecialisationDraws)
+	{
+		/* On failure glCompileShader falls back to full optimisation, and nothing is specialised */
+		StartShaderReoptThread(gc);
+	}
+
+	return IMG_TRUE;
+}
 
 /***********************************************************************************
- Function Name      : FreeListOfFragmentUSEVariants
+ Function Name      : DestroyGLSLCompiler
  Inputs             : gc
-                      ppsUSEVariantListHead - The head of the list of variants
+ Outputs            : -
+ Returns            : -
+ Description        : Destroys the GLSL compiler. This is called when an app calls
+                      glReleaseShaderCompiler and after the names arrays are destroyed.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyGLSLCompiler(GLES2Context *gc)
+{
+	/* The compiler may have been explicitly destroyed by the app or maybe the app only used binary shaders. */
+	if(gc->sProgram.hGLSLCompiler)
+	{
+		StopShaderReoptThread(gc);
+
+#if defined(TIMING)
+		gc->sProgram.sGLSLFuncTable.pfnDisplayMetrics(&gc->sProgram.sInitCompilerContext);
+#endif
+		gc->sProgram.sGLSLFuncTable.pfnShutDownCompiler(&gc->sProgram.sInitCompilerContext);
+		UnloadCompilerModule(gc);
+	}
+}
+
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
+
+static IMG_VOID * IMG_CALLCONV UniPatchMalloc(IMG_UINT32 ui32Size )
+{
+	/* IMPORTANT: if this call is not kept GL-context independent, then allocating a shader in one context
+	              and freeing it in a different context will not work as we will allocate it in one heap
+	              and deallocate from a different heap (think Symbian).
+	*/
+	return GLES2Malloc(0, ui32Size);
+}
+
+static IMG_VOID IMG_CALLCONV UniPatchFree(IMG_VOID *pvData)
+{
+	GLES2Free(0, pvData);
+}
+
+
+static IMG_VOID IMG_CALLCONV UniPatchDebugPrint(const IMG_CHAR* pszFormat, ...) IMG_FORMAT_PRINTF(1,2);
+
+static IMG_VOID IMG_CALLCONV UniPatchDebugPrint(const IMG_CHAR* pszFormat, ...)
+{
+#if defined(DEBUG)
+	__GLES2_GET_CONTEXT();
+
+	if(gc->sAppHints.bDumpUSPOutput)
+	{
+		SceUID fd = sceIoDopen("ux0:data/gles/usp");
+
+		if (fd <= 0)
+		{
+			sceIoMkdir("ux0:data/gles", 0777);
+			sceIoMkdir("ux0:data/gles/usp", 0777);
+		}
+		else
+		{
+			sceIoDclose(fd);
+		}
+
+
+		FILE    *fstream = fopen("ux0:data/gles/usp/usp_out.txt","a+t");
+		va_list vaList;
+
+		if(fstream)
+		{
+			/* Write out the disassembly of the machine code generated by unipatch */
+			va_start(vaList, pszFormat);
+			vfprintf(fstream, pszFormat, vaList);
+			va_end(vaList);
+		}
+		else
+		{
+			PVR_DPF((PVR_DBG_WARNING, "UniPatchDebugPrint: Could not open file. Cannot dump USP output"));
+		}
+	}
+#else
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+#endif
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyHashedPDSVariant
+ Inputs             : 
  Outputs            : 
+ Returns            : 
+ Description        : 
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyHashedPDSVariant(GLES2Context *gc, IMG_UINT32 ui32Item)
+{
+	GLES2PDSCodeVariant **ppsPDSVariantList, *psPDSVariant;
+	GLES2USEShaderVariant *psUSEVariant;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	psUSEVariant = ((GLES2PDSCodeVariant *)ui32Item)->psUSEVariant;
+	ppsPDSVariantList = &psUSEVariant->psPDSVariant;
+
+	while(*ppsPDSVariantList)
+	{
+		if(*ppsPDSVariantList == (GLES2PDSCodeVariant *)ui32Item)
+		{
+			psPDSVariant = *ppsPDSVariantList;
+			*ppsPDSVariantList = psPDSVariant->psNext;
+			
+			UCH_CodeHeapFree(psPDSVariant->psCodeBlock);
+			GLES2Free(IMG_NULL, psPDSVariant);
+			return;
+		}
+			
+		ppsPDSVariantList = &((*ppsPDSVariantList)->psNext);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyHashedPDSVertexVariant
+ Inputs             : gc, ui32Item
+ Outputs            : -
  Returns            : -
- Description        : Frees a linked list of fragment USE variants and their attached PDS variants.
-                      If the variants are still in use they are ghosted appropriately.
+ Description        : Removes a PDS vertex variant from its USE variant and frees it.
+                      If the code block may still be read by a TA kick it is ghosted
+                      and freed once the kick has completed.
 ************************************************************************************/
-static IMG_VOID FreeListOfFragmentUSEVariants(GLES2Context *gc, GLES2USEShaderVariant **ppsUSEVariantListHead)
+IMG_INTERNAL IMG_VOID DestroyHashedPDSVertexVariant(GLES2Context *gc, IMG_UINT32 ui32Item)
 {
-	KRMKickResourceManager *psKRM = &gc->psSharedState->sUSEShaderVariantKRM;
-	GLES2USEShaderVariant       *psUSEVariant, *psUSEVariantNext;
+	GLES2PDSVertexCodeVariant **ppsPDSVariantList, *psPDSVariant;
+	GLES2PDSVertexCodeVariantGhost *psPDSVariantGhost;
+
+	psPDSVariant = (GLES2PDSVertexCodeVariant *)ui32Item;
+	ppsPDSVariantList = &psPDSVariant->psUSEVariant->psPDSVertexVariant;
+
+	while(*ppsPDSVariantList)
+	{
+		if(*ppsPDSVariantList == psPDSVariant)
+		{
+			*ppsPDSVariantList = psPDSVariant->psNext;
+			break;
+		}
+
+		ppsPDSVariantList = &((*ppsPDSVariantList)->psNext);
+	}
+
+	if(gc->sPrim.psPDSVertexVariant == psPDSVariant)
+	{
+		gc->sPrim.psPDSVertexVariant = IMG_NULL;
+	}
+
+	if(KRM_IsResourceNeeded(&gc->sPDSVertexVariantKRM, &psPDSVariant->sResource))
+	{
+		psPDSVariantGhost = GLES2Calloc(gc, sizeof(GLES2PDSVertexCodeVariantGhost));
+
+		if(psPDSVariantGhost)
+		{
+			/* Transfer ownership of the PDS code block from the variant to the ghost */
+			psPDSVariantGhost->psCodeBlock = psPDSVariant->psCodeBlock;
+			psPDSVariant->psCodeBlock = IMG_NULL;
+
+			KRM_GhostResource(&gc->sPDSVertexVariantKRM, &psPDSVariant->sResource, &psPDSVariantGhost->sResource);
+		}
+		else
+		{
+			PVR_DPF((PVR_DBG_WARNING, "DestroyHashedPDSVertexVariant: Out of memory. Waiting for the TA instead of ghosting"));
+
+			KRM_WaitUntilResourceIsNotNeeded(&gc->sPDSVertexVariantKRM, &psPDSVariant->sResource, GLES2_DEFAULT_WAIT_RETRIES);
+		}
+	}
+
+	KRM_RemoveResourceFromAllLists(&gc->sPDSVertexVariantKRM, &psPDSVariant->sResource);
+
+	UCH_CodeHeapFree(psPDSVariant->psCodeBlock);
+	GLES2Free(IMG_NULL, psPDSVariant);
+}
+
+
+/***********************************************************************************
+ Function Name      : ReclaimPDSVertexVariantMemKRM
+ Inputs             : pvContext, psResource
+ Outputs            : -
+ Returns            : -
+ Description        : PDS vertex variants are freed through the hash table, so the
+                      KRM is never asked to reclaim them.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ReclaimPDSVertexVariantMemKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	PVR_UNREFERENCED_PARAMETER(pvContext);
+	PVR_UNREFERENCED_PARAMETER(psResource);
+
+	PVR_DPF((PVR_DBG_WARNING, "ReclaimPDSVertexVariantMemKRM: Called"));
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyPDSVertexVariantGhostKRM
+ Inputs             : pvContext, psResource
+ Outputs            : -
+ Returns            : -
+ Description        : Destroys a ghosted PDS vertex variant.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyPDSVertexVariantGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	/* Note the tricky pointer arithmetic. It is necessary */
+	GLES2PDSVertexCodeVariantGhost *psPDSVariantGhost =
+		(GLES2PDSVertexCodeVariantGhost*)((IMG_UINTPTR_T)psResource -offsetof(GLES2PDSVertexCodeVariantGhost, sResource));
+
+	PVR_UNREFERENCED_PARAMETER(pvContext);
+
+	UCH_CodeHeapFree(psPDSVariantGhost->psCodeBlock);
+	GLES2Free(IMG_NULL, psPDSVariantGhost);
+}
+
+
+/***********************************************************************************
+ Function Name      : ReclaimUSEShaderVariantMemKRM
+ Inputs             : gc, psResource
+ Outputs            : -
+ Returns            : -
+ Description        : Reclaims the device memory of a use shader variant. This function
+					  also destroys the variant itself, as we are not managing a top 
+					  level GL resource and we can easily create a new version of the 
+					  variant.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ReclaimUSEShaderVariantMemKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	/* Note the tricky pointer arithmetic. It is necessary */
+	GLES2USEShaderVariant *psUSEVariant = (GLES2USEShaderVariant*)((IMG_UINTPTR_T)psResource -offsetof(GLES2USEShaderVariant, sResource));
+	GLES2Context	 *gc = (GLES2Context *)pvContext;
+
+	DestroyUSEShaderVariant(gc, psUSEVariant);
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyUSECodeVariantGhostKRM
+ Inputs             : gc, psResource
+ Outputs            : -
+ Returns            : -
+ Description        : Destroys a ghosted USSE code variant.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyUSECodeVariantGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	/* Note the tricky pointer arithmetic. It is necessary */
+	GLES2USEShaderVariantGhost *psUSEVariantGhost =
+		(GLES2USEShaderVariantGhost*)((IMG_UINTPTR_T)psResource -offsetof(GLES2USEShaderVariantGhost, sResource));
+	GLES2Context	 *gc = (GLES2Context *)pvContext;
+
+	DestroyUSEShaderVariantGhost(gc, psUSEVariantGhost);
+}
+
+
+/***********************************************************************************
+ Function Name      : GhostUSEShaderVariant
+ Inputs             : gc, psUSEVariant
+ Outputs            : -
+ Returns            : -
+ Description        : Ghosts a USSE shader variant and destroys the original.
+************************************************************************************/
+static IMG_VOID GhostUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVariant *psUSEVariant)
+{
+	GLES2USEShaderVariantGhost *psUSEVariantGhost;
+	GLES2PDSCodeVariant        *psPDSVariant;
+	GLES2PDSCodeVariantGhost   *psPDSVariantGhost;
+
+	/* We only ghost fragment shaders. For vertex shaders we kick the TA and wait */
+	GLES_ASSERT(psUSEVariant->psProgramShader && psUSEVariant->psProgramShader->eProgramType == GLSLPT_FRAGMENT);
+
+	psUSEVariantGhost = GLES2Calloc(gc, sizeof(GLES2USEShaderVariantGhost));
+
+	if(!psUSEVariantGhost)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "GhostUSEShaderVariant: Out of memory. Could not ghost USE variant at %p\n", psUSEVariant));
+
+		SetError(gc, GL_OUT_OF_MEMORY);
+
+		return;
+	}
+
+	/* Transfer ownership of the USE code block from the variant to the ghost */
+	psUSEVariantGhost->psUSECodeBlock  = psUSEVariant->psCodeBlock;
+	psUSEVariant->psCodeBlock          = IMG_NULL;
+
+	USESecondaryUploadTaskAddRef(gc, psUSEVariant->psSecondaryUploadTask);
+	psUSEVariantGhost->psSecondaryUploadTask = psUSEVariant->psSecondaryUploadTask;
+
+
+	psUSEVariantGhost->psScratchMem = psUSEVariant->psScratchMem;
+	ShaderScratchMemAddRef(gc, psUSEVariantGhost->psScratchMem);
+
+	psUSEVariantGhost->psIndexableTempsMem = psUSEVariant->psIndexableTempsMem;
+	ShaderIndexableTempsMemAddRef(gc, psUSEVariantGhost->psIndexableTempsMem);
+
+
+	psPDSVariant = psUSEVariant->psPDSVariant;
+
+	/* Transfer ownership of the PDS code blocks from the PDS variants to the PDS ghosts */
+	while(psPDSVariant)
+	{
+		psPDSVariantGhost = GLES2Calloc(gc, sizeof(GLES2PDSCodeVariantGhost));
+		
+		if(!psPDSVariantGhost)
+		{
+			DestroyUSEShaderVariantGhost(gc, psUSEVariantGhost);
+
+			PVR_DPF((PVR_DBG_ERROR, "GhostUSEShaderVariant: Out of memory. Could not ghost USE variant at %p\n", psUSEVariant));
+
+			SetError(gc, GL_OUT_OF_MEMORY);
+
+			return;
+		}
+
+		psPDSVariantGhost->psCodeBlock = psPDSVariant->psCodeBlock;
+		psPDSVariant->psCodeBlock = IMG_NULL;
+
+		/* Insert the PDS variant ghost at the front of the list */
+		psPDSVariantGhost->psNext = psUSEVariantGhost->psPDSVariantGhost;
+		psUSEVariantGhost->psPDSVariantGhost = psPDSVariantGhost;
+
+		psPDSVariant = psPDSVariant->psNext;
+	}
+
+	/* The creation of the ghost was successfull. Notify the KRM */
+	KRM_GhostResource(&gc->psSharedState->sUSEShaderVariantKRM, 
+							&psUSEVariant->sResource, &psUSEVariantGhost->sResource);
+
+	/* Finally, destroy the original */
+	DestroyUSEShaderVariant(gc, psUSEVariant);
+
+	return;
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeListOfVertexUSEVariants
+ Inputs             : gc
+                      ppsUSEVariantListHead - The head of the list of variants
+ Outputs            : 
+ Returns            : 
+ Description        : Frees a linked list of vertex USE variants and their attached PDS variants.
+************************************************************************************/
+static IMG_VOID FreeListOfVertexUSEVariants(GLES2Context *gc, GLES2USEShaderVariant **ppsUSEVariantListHead)
+{
+	GLES2USEShaderVariant     *psUSEVariant, *psUSEVariantNext;
+
+	psUSEVariant = *ppsUSEVariantListHead;
+
+	if(psUSEVariant)
+	{
+		if(gc->psRenderSurface)
+		{
+			/* Before relinking kick the TA and wait. Then free the vertex variants. */
+			if(ScheduleTA(gc, gc->psRenderSurface, GLES2_SCHEDULE_HW_WAIT_FOR_TA) != IMG_EGL_NO_ERROR)
+			{
+				PVR_DPF((PVR_DBG_ERROR, "FreeListOfVertexUSEVariants: Kicking the TA failed\n"));
+				return;
+			}
+		}
+
+		do
+		{
+			psUSEVariantNext = psUSEVariant->psNext;
+
+			DestroyUSEShaderVariant(gc, psUSEVariant);
+
+			if(gc->sProgram.psCurrentVertexVariant==psUSEVariant)
+			{
+				gc->sProgram.psCurrentVertexVariant=IMG_NULL;
+			}	
+
+			/* Keep the list consistent as DestroyUSEShaderVariant requires it */
+			psUSEVariant = psUSEVariantNext;
+
+			*ppsUSEVariantListHead = psUSEVariant;
+		}
+		while(psUSEVariant);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyVertexVariants
+ Inputs             : gc, psNamedItem
+ Outputs            : -
+ Returns            : -
+ Description        : Deletes all vertex variants for a given program.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyVertexVariants(GLES2Context *gc, const IMG_VOID* pvAttachment, GLES2NamedItem *psNamedItem)
+{
+	GLES2Program *psProgram = (GLES2Program*)psNamedItem;
+
+	PVR_UNREFERENCED_PARAMETER(pvAttachment);
+
+	GLES_ASSERT(psProgram);
+
+	if(psProgram->ui32Type == GLES2_SHADERTYPE_PROGRAM)
+	{
+		FreeListOfVertexUSEVariants(gc, &psProgram->sVertex.psVariant);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeListOfFragmentUSEVariants
+ Inputs             : gc
+                      ppsUSEVariantListHead - The head of the list of variants
+ Outputs            : 
+ Returns            : -
+ Description        : Frees a linked list of fragment USE variants and their attached PDS variants.
+                      If the variants are still in use they are ghosted appropriately.
+************************************************************************************/
+static IMG_VOID FreeListOfFragmentUSEVariants(GLES2Context *gc, GLES2USEShaderVariant **ppsUSEVariantListHead)
+{
+	KRMKickResourceManager *psKRM = &gc->psSharedState->sUSEShaderVariantKRM;
+	GLES2USEShaderVariant       *psUSEVariant, *psUSEVariantNext;
+
+	/* Fragment variants. The KRM keeps track of their status. */
+	psUSEVariant = *ppsUSEVariantListHead;
+
+	while(psUSEVariant)
+	{
+		psUSEVariantNext = psUSEVariant->psNext;
+
+		if(KRM_IsResourceNeeded(psKRM, &psUSEVariant->sResource))
+		{
+			GhostUSEShaderVariant(gc, psUSEVariant);
+		}
+		else
+		{
+			DestroyUSEShaderVariant(gc, psUSEVariant);
+		}
+
+		if(gc->sProgram.psCurrentFragmentVariant==psUSEVariant)
+		{
+			gc->sProgram.psCurrentFragmentVariant=IMG_NULL;
+		}	
+
+		/* Keep the list consistent as DestroyUSEShaderVariant requires it */
+		psUSEVariant = psUSEVariantNext;
+
+		*ppsUSEVariantListHead = psUSEVariant;
+	}
+}
+
+
+#if defined(SUPPORT_SOURCE_SHADER)
+
+/***********************************************************************************
+ Function Name      : DropProgramShaderVariants
+ Inputs             : gc, psShader
+ Outputs            : -
+ Returns            : -
+ Description        : Drops the USE variants of a program shader along with its scratch
+					  and indexable temp memory, which were sized from those variants.
+					  They are rebuilt on the next validation.
+************************************************************************************/
+static IMG_VOID DropProgramShaderVariants(GLES2Context *gc, GLES2ProgramShader *psShader)
+{
+	if(psShader->eProgramType == GLSLPT_VERTEX)
+	{
+		FreeListOfVertexUSEVariants(gc, &psShader->psVariant);
+	}
+	else
+	{
+		/* Variants still referenced by a kick are ghosted through the KRM */
+		FreeListOfFragmentUSEVariants(gc, &psShader->psVariant);
+	}
+
+	ShaderScratchMemDelRef(gc, psShader->psScratchMem);
+	psShader->psScratchMem = IMG_NULL;
+
+	ShaderIndexableTempsMemDelRef(gc, psShader->psIndexableTempsMem);
+	psShader->psIndexableTempsMem = IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : DestroyReoptimisedVariants
+ Inputs             : gc, pvSharedState, psNamedItem
+ Outputs            : -
+ Returns            : -
+ Description        : Drops the USE variants of a program that were patched from a shader
+					  which is about to be replaced by its re-optimised version.
+************************************************************************************/
+static IMG_VOID DestroyReoptimisedVariants(GLES2Context *gc, const IMG_VOID *pvSharedState, GLES2NamedItem *psNamedItem)
+{
+	GLES2Program *psProgram = (GLES2Program*)psNamedItem;
+
+	GLES_ASSERT(psProgram);
+
+	if(psProgram->ui32Type != GLES2_SHADERTYPE_PROGRAM)
+	{
+		return;
+	}
+
+	if(psProgram->sVertex.psSharedState == pvSharedState)
+	{
+		DropProgramShaderVariants(gc, &psProgram->sVertex);
+	}
+
+	if(psProgram->sFragment.psSharedState == pvSharedState)
+	{
+		DropProgramShaderVariants(gc, &psProgram->sFragment);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ApplyShaderReoptimisation
+ Inputs             : gc, psJob
+ Outputs            : -
+ Returns            : IMG_TRUE if the shader was swapped
+ Description        : Swaps the UniPatch shaders of a fast tier shader for the fully
+					  optimised ones. The binding symbols do not depend on USC, so
+					  programs stay linked and only their variants are rebuilt on the
+					  next validation.
+************************************************************************************/
+static IMG_BOOL ApplyShaderReoptimisation(GLES2Context *gc, GLES2ShaderReoptJob *psJob)
+{
+	GLES2SharedShaderState *psSharedState = psJob->psSharedState;
+	GLSLCompiledUniflexProgram *psCompiledProgram = psJob->psCompiledProgram;
+	IMG_VOID *pvUniPatchShader, *pvUniPatchShaderMSAATrans = IMG_NULL;
+
+	/* The shader and every program using it were deleted meanwhile */
+	if(psSharedState->ui32RefCount == 1)
+	{
+		return IMG_FALSE;
+	}
+
+	if(!psCompiledProgram || !psCompiledProgram->bSuccessfullyCompiled)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "ApplyShaderReoptimisation: Full compile failed, keeping the fast tier shader"));
+		return IMG_FALSE;
+	}
+
+	pvUniPatchShader = PVRUniPatchCreateShader(gc->sProgram.pvUniPatchContext, psCompiledProgram->psUniFlexCode->psUniPatchInput);
+
+	if(!pvUniPatchShader)
+	{
+		return IMG_FALSE;
+	}
+
+#if !defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	if(psJob->eProgramType == GLSLPT_FRAGMENT)
+	{
+		pvUniPatchShaderMSAATrans = PVRUniPatchCreateShader(gc->sProgram.pvUniPatchContext, psCompiledProgram->psUniFlexCode->psUniPatchInputMSAATrans);
+
+		if(!pvUniPatchShaderMSAATrans)
+		{
+			PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, pvUniPatchShader);
+			return IMG_FALSE;
+		}
+	}
+#endif
+
+	NamesArrayMapFunction(gc, gc->psSharedState->apsNamesArray[GLES2_NAMETYPE_PROGRAM], DestroyReoptimisedVariants, psSharedState);
+
+	/* Other contexts and the prewarm worker may be finalising the old shaders */
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchLock);
+
+	PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, psSharedState->pvUniPatchShader);
+	psSharedState->pvUniPatchShader = pvUniPatchShader;
+
+	if(psSharedState->pvUniPatchShaderMSAATrans)
+	{
+		PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, psSharedState->pvUniPatchShaderMSAATrans);
+	}
+	psSharedState->pvUniPatchShaderMSAATrans = pvUniPatchShaderMSAATrans;
+
+	/* Anything prewarmed so far was patched from the fast tier shader */
+	DiscardPrewarmedShaders(gc, psSharedState);
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchLock);
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+
+	/* Prewarm the new shader with the keys the old one was drawn with */
+	RequeueShaderPrewarm(gc, psSharedState);
+
+	/* The secondary upload program is generated from the USC output too */
+	USESecondaryUploadTaskDelRef(gc, psSharedState->psSecondaryUploadTask);
+	psSharedState->psSecondaryUploadTask = IMG_NULL;
+
+	psSharedState->bFastTier = IMG_FALSE;
+
+#if defined(DEBUG)
+	psSharedState->sPerfReport = psCompiledProgram->psUniFlexCode->sPerfReport;
+#endif
+
+	gc->ui32DirtyState |= GLES2_DIRTYFLAG_VERTEX_PROGRAM | GLES2_DIRTYFLAG_FRAGMENT_PROGRAM;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : ApplyUniformSpecialisation
+ Inputs             : gc, psJob
+ Outputs            : -
+ Returns            : IMG_TRUE if the program shader now runs the specialised code
+ Description        : Gives a program shader the UniPatch shaders compiled with its
+					  stable uniforms folded in, unless one of them changed while the
+					  compile was running. The constant layout is unchanged, so
+					  uniforms are still uploaded as before.
+************************************************************************************/
+static IMG_BOOL ApplyUniformSpecialisation(GLES2Context *gc, GLES2ShaderReoptJob *psJob)
+{
+	GLES2ShaderSpecialisation *psSpecialisation;
+	GLES2SharedShaderState *psSharedState = psJob->psSharedState;
+	GLES2SharedShaderState *psCodeState;
+	GLSLCompiledUniflexProgram *psCompiledProgram = psJob->psCompiledProgram;
+	IMG_VOID *pvUniPatchShader, *pvUniPatchShaderMSAATrans = IMG_NULL;
+	IMG_UINT32 i, ui32NumWords = (psJob->ui32NumSpecialisedComps + 31) >> 5;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	psSpecialisation = psJob->psSpecialisation;
+
+	if(psSpecialisation)
+	{
+		psSpecialisation->psJob = IMG_NULL;
+		psJob->psSpecialisation = IMG_NULL;
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	/* The program was relinked or deleted meanwhile */
+	if(!psSpecialisation)
+	{
+		return IMG_FALSE;
+	}
+
+	if(!psCompiledProgram || !psCompiledProgram->bSuccessfullyCompiled)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "ApplyUniformSpecialisation: Specialised compile failed, keeping the generic shader"));
+		return IMG_FALSE;
+	}
+
+	/* The driver keeps laying out and uploading constants for the generic code */
+	if(psCompiledProgram->psBindingSymbolList->uNumCompsUsed != psSharedState->sBindingSymbolList.uNumCompsUsed)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "ApplyUniformSpecialisation: Constant layout changed, keeping the generic shader"));
+		return IMG_FALSE;
+	}
+
+	/* A folded uniform changed while the variant was compiling */
+	for(i = 0; i < ui32NumWords; i++)
+	{
+		if(psJob->pui32SpecialisedCompFlags[i] & psSpecialisation->pui32VolatileMask[i])
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	pvUniPatchShader = PVRUniPatchCreateShader(gc->sProgram.pvUniPatchContext, psCompiledProgram->psUniFlexCode->psUniPatchInput);
+
+	if(!pvUniPatchShader)
+	{
+		return IMG_FALSE;
+	}
+
+#if !defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	if(psJob->eProgramType == GLSLPT_FRAGMENT)
+	{
+		pvUniPatchShaderMSAATrans = PVRUniPatchCreateShader(gc->sProgram.pvUniPatchContext, psCompiledProgram->psUniFlexCode->psUniPatchInputMSAATrans);
+
+		if(!pvUniPatchShaderMSAATrans)
+		{
+			PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, pvUniPatchShader);
+			return IMG_FALSE;
+		}
+	}
+#endif
+
+	/* Only the code is private; bindings and constants stay with the shader's shared state */
+	psCodeState = GLES2Calloc(gc, sizeof(GLES2SharedShaderState));
+
+	if(!psCodeState)
+	{
+		PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, pvUniPatchShader);
+
+		if(pvUniPatchShaderMSAATrans)
+		{
+			PVRUniPatchDestroyShader(gc->sProgram.pvUniPatchContext, pvUniPatchShaderMSAATrans);
+		}
+
+		return IMG_FALSE;
+	}
+
+	psCodeState->eProgramFlags = psSharedState->eProgramFlags;
+	psCodeState->eActiveVaryingMask = psSharedState->eActiveVaryingMask;
+
+	GLES2MemCopy(psCodeState->aui32TexCoordDims, psSharedState->aui32TexCoordDims, sizeof(psCodeState->aui32TexCoordDims));
+	GLES2MemCopy(psCodeState->aeTexCoordPrecisions, psSharedState->aeTexCoordPrecisions, sizeof(psCodeState->aeTexCoordPrecisions));
+
+	psCodeState->pvUniPatchShader = pvUniPatchShader;
+	psCodeState->pvUniPatchShaderMSAATrans = pvUniPatchShaderMSAATrans;
+	psCodeState->ui32RefCount = 1;
+
+#if defined(DEBUG)
+	psCodeState->sPerfReport = psCompiledProgram->psUniFlexCode->sPerfReport;
+#endif
+
+	/* Variants patched from the generic code are rebuilt from the specialised code */
+	DropProgramShaderVariants(gc, psSpecialisation->psProgramShader);
+
+	psSpecialisation->psCodeState = psCodeState;
+
+	GLES2MemCopy(psSpecialisation->pui32FoldedMask, psJob->pui32SpecialisedCompFlags, ui32NumWords * sizeof(IMG_UINT32));
+
+	gc->ui32DirtyState |= GLES2_DIRTYFLAG_VERTEX_PROGRAM | GLES2_DIRTYFLAG_FRAGMENT_PROGRAM;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : ServiceShaderReoptimisations
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Called at frame boundaries. Hot swaps shaders the worker has
+					  finished re-optimising or specialising, then lets the worker
+					  continue if the app did not compile anything during the frame.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ServiceShaderReoptimisations(GLES2Context *gc)
+{
+	GLES2ShaderReoptJob *psJob;
+	IMG_BOOL bWakeWorker = IMG_FALSE;
+
+	if(!gc->sProgram.hReoptThread)
+	{
+		return;
+	}
+
+	PVRSRVLockMutex(gc->sProgram.hReoptLock);
+
+	for(psJob = gc->sProgram.psReoptJobs; psJob; psJob = psJob->psNext)
+	{
+		switch(psJob->eState)
+		{
+			case GLES2_SHADER_REOPT_DONE:
+			{
+				if(psJob->pui32SpecialisedCompFlags)
+				{
+					if(ApplyUniformSpecialisation(gc, psJob))
+					{
+						GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_COUNT, 1);
+					}
+					else
+					{
+						GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_DISCARD_COUNT, 1);
+					}
+
+					GLES2Free(IMG_NULL, psJob->pui32SpecialisedCompFlags);
+					psJob->pui32SpecialisedCompFlags = IMG_NULL;
+
+					GLES2Free(IMG_NULL, psJob->pfSpecialisedCompData);
+					psJob->pfSpecialisedCompData = IMG_NULL;
+				}
+				else if(ApplyShaderReoptimisation(gc, psJob))
+				{
+					GLES2_INC_COUNT(GLES2_TIMER_SHADER_HOTSWAP_COUNT, 1);
+				}
+				else
+				{
+					GLES2_INC_COUNT(GLES2_TIMER_SHADER_REOPTIMISE_DISCARD_COUNT, 1);
+				}
+
+				GLES2Free(IMG_NULL, psJob->pszSource);
+				psJob->pszSource = IMG_NULL;
+
+				SharedShaderStateDelRef(gc, psJob->psSharedState);
+				psJob->psSharedState = IMG_NULL;
+
+				/* The compiler output is freed by the worker, which owns the compiler */
+				psJob->eState = GLES2_SHADER_REOPT_RETIRED;
+
+				bWakeWorker = IMG_TRUE;
+
+				break;
+			}
+			case GLES2_SHADER_REOPT_PENDING:
+			{
+				/* Keep the compiler free for the app while it is still compiling */
+				if(!gc->sProgram.ui32CompilesThisFrame)
+				{
+					bWakeWorker = IMG_TRUE;
+				}
+
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+	}
+
+	PVRSRVUnlockMutex(gc->sProgram.hReoptLock);
+
+	gc->sProgram.ui32CompilesThisFrame = 0;
+
+	if(bWakeWorker)
+	{
+		PVRSRVPostSemaphore(gc->sProgram.hReoptSemaphore, 1);
+	}
+}
+
+/***********************************************************************************
+ Function Name      : FreeUniformSpecialisation
+ Inputs             : gc, psShader
+ Outputs            : -
+ Returns            : -
+ Description        : Stops tracking a program shader's uniforms. Any USE variants
+					  patched from the specialised code must already have been freed.
+************************************************************************************/
+static IMG_VOID FreeUniformSpecialisation(GLES2Context *gc, GLES2ProgramShader *psShader)
+{
+	GLES2ShaderSpecialisation *psSpecialisation = psShader->psSpecialisation;
+
+	if(!psSpecialisation)
+	{
+		return;
+	}
+
+	SharedShaderStateDelRef(gc, psSpecialisation->psCodeState);
+
+	/* An outstanding compile is discarded when it completes */
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(psSpecialisation->psJob)
+	{
+		psSpecialisation->psJob->psSpecialisation = IMG_NULL;
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	/* The masks live in the same allocation */
+	GLES2Free(IMG_NULL, psSpecialisation);
+
+	psShader->psSpecialisation = IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : CreateUniformSpecialisation
+ Inputs             : gc, psProgram, psShader, bVertex
+ Outputs            : -
+ Returns            : -
+ Description        : Starts tracking the uniforms of a newly linked program shader
+					  which could be folded into a specialised variant: user uniforms
+					  outside arrays, other than samplers.
+************************************************************************************/
+static IMG_VOID CreateUniformSpecialisation(GLES2Context *gc, GLES2Program *psProgram,
+											GLES2ProgramShader *psShader, IMG_BOOL bVertex)
+{
+	GLES2SharedShaderState *psSharedState = psShader->psSharedState;
+	GLES2ShaderSpecialisation *psSpecialisation;
+	GLES2Uniform *psUniform;
+	GLSLBindingSymbol *psSymbol;
+	IMG_UINT32 ui32NumComps, ui32NumWords, ui32Comp, i, j;
+	IMG_BOOL bAnyCandidates = IMG_FALSE;
+
+	ui32NumComps = psSharedState->sBindingSymbolList.uNumCompsUsed;
+
+	/* Binary shaders have no source to recompile */
+	if(!psSharedState->pszSpecialisationSource || !ui32NumComps)
+	{
+		return;
+	}
+
+	ui32NumWords = (ui32NumComps + 31) >> 5;
+
+	psSpecialisation = GLES2Calloc(gc, sizeof(GLES2ShaderSpecialisation) + 3 * ui32NumWords * sizeof(IMG_UINT32));
+
+	if(!psSpecialisation)
+	{
+		return;
+	}
+
+	psSpecialisation->pui32CandidateMask = (IMG_UINT32 *)(psSpecialisation + 1);
+	psSpecialisation->pui32VolatileMask = psSpecialisation->pui32CandidateMask + ui32NumWords;
+	psSpecialisation->pui32FoldedMask = psSpecialisation->pui32VolatileMask + ui32NumWords;
+
+	for(i = 0; i < psProgram->ui32NumActiveUserUniforms; i++)
+	{
+		psUniform = psProgram->ppsActiveUserUniforms[i];
+		psSymbol = bVertex ? psUniform->psSymbolVP : psUniform->psSymbolFP;
+
+		/* Array elements may be indexed dynamically */
+		if(!psSymbol || GLES2_IS_SAMPLER(psSymbol->eTypeSpecifier) || psSymbol->iDeclaredArraySize ||
+		   (psSymbol->sRegisterInfo.eRegType != HWREG_FLOAT))
+		{
+			continue;
+		}
+
+		for(j = 0; j < psSymbol->sRegisterInfo.uCompAllocCount; j++)
+		{
+			ui32Comp = psSymbol->sRegisterInfo.u.uBaseComp + j;
+
+			if((psSymbol->sRegisterInfo.ui32CompUseMask & (1U << j)) && (ui32Comp < ui32NumComps))
+			{
+				psSpecialisation->pui32CandidateMask[ui32Comp >> 5] |= 1U << (ui32Comp & 31);
+
+				bAnyCandidates = IMG_TRUE;
+			}
+		}
+	}
+
+	if(!bAnyCandidates)
+	{
+		GLES2Free(IMG_NULL, psSpecialisation);
+		return;
+	}
+
+	psSpecialisation->psProgramShader = psShader;
+	psSpecialisation->ui32NumComps = ui32NumComps;
+
+	psShader->psSpecialisation = psSpecialisation;
+}
+
+
+/***********************************************************************************
+ Function Name      : SetupUniformSpecialisation
+ Inputs             : gc, psProgram
+ Outputs            : -
+ Returns            : -
+ Description        : Called after a successful link when uniform specialisation is
+					  enabled (UniformSpecialisationDraws apphint).
+************************************************************************************/
+static IMG_VOID SetupUniformSpecialisation(GLES2Context *gc, GLES2Program *psProgram)
+{
+	if(!gc->sAppHints.ui32UniformSpecialisationDraws || !gc->sProgram.hReoptThread)
+	{
+		return;
+	}
+
+	CreateUniformSpecialisation(gc, psProgram, &psProgram->sVertex, IMG_TRUE);
+	CreateUniformSpecialisation(gc, psProgram, &psProgram->sFragment, IMG_FALSE);
+}
+
+
+/***********************************************************************************
+ Function Name      : NoteUniformSpecialisationChange
+ Inputs             : gc, psShader, ui32CompStart, ui32CompCount
+ Outputs            : -
+ Returns            : -
+ Description        : Called when the app changes the value of a uniform. Changes made
+					  before the program is first drawn are taken as initialisation;
+					  later ones mark the uniform as never to be folded, and restore
+					  the generic code before the next draw if it was folded.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID NoteUniformSpecialisationChange(GLES2Context *gc, GLES2ProgramShader *psShader,
+													  IMG_UINT32 ui32CompStart, IMG_UINT32 ui32CompCount)
+{
+	GLES2ShaderSpecialisation *psSpecialisation = psShader->psSpecialisation;
+	IMG_UINT32 ui32CompEnd = ui32CompStart + ui32CompCount;
+	IMG_UINT32 ui32Comp, ui32Word, ui32Bit;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	if(ui32CompEnd > psSpecialisation->ui32NumComps)
+	{
+		ui32CompEnd = psSpecialisation->ui32NumComps;
+	}
+
+	for(ui32Comp = ui32CompStart; ui32Comp < ui32CompEnd; ui32Comp++)
+	{
+		ui32Word = ui32Comp >> 5;
+		ui32Bit = 1U << (ui32Comp & 31);
+
+		if(!(psSpecialisation->pui32CandidateMask[ui32Word] & ui32Bit))
+		{
+			continue;
+		}
+
+		psSpecialisation->ui32StableDraws = 0;
+
+		if(!psSpecialisation->bDrawn)
+		{
+			continue;
+		}
+
+		psSpecialisation->pui32VolatileMask[ui32Word] |= ui32Bit;
+
+		if(psSpecialisation->pui32FoldedMask[ui32Word] & ui32Bit)
+		{
+			psSpecialisation->bFallback = IMG_TRUE;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : QueueUniformSpecialisation
+ Inputs             : gc, psShader
+ Outputs            : -
+ Returns            : -
+ Description        : Queues a recompile of a program shader with the current values
+					  of its stable uniforms folded in. Tracking stops for good once
+					  nothing is left to fold or the recompile budget is spent.
+************************************************************************************/
+static IMG_VOID QueueUniformSpecialisation(GLES2Context *gc, GLES2ProgramShader *psShader)
+{
+	GLES2ShaderSpecialisation *psSpecialisation = psShader->psSpecialisation;
+	GLES2SharedShaderState *psSharedState = psShader->psSharedState;
+	GLES2ShaderReoptJob *psJob;
+	IMG_UINT32 ui32NumWords = (psSpecialisation->ui32NumComps + 31) >> 5;
+	IMG_UINT32 ui32SourceLength, i;
+	IMG_BOOL bAnyStable = IMG_FALSE;
+
+	psSpecialisation->ui32StableDraws = 0;
+
+	/* The compiler was released */
+	if(!gc->sProgram.hReoptThread)
+	{
+		return;
+	}
+
+	for(i = 0; i < ui32NumWords; i++)
+	{
+		if(psSpecialisation->pui32CandidateMask[i] & ~psSpecialisation->pui32VolatileMask[i])
+		{
+			bAnyStable = IMG_TRUE;
+			break;
+		}
+	}
+
+	if(!bAnyStable)
+	{
+		FreeUniformSpecialisation(gc, psShader);
+		return;
+	}
+
+	if(gc->sProgram.ui32NumSpecialisations >= gc->sAppHints.ui32UniformSpecialisationBudget)
+	{
+		GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_BUDGET_COUNT, 1);
+
+		FreeUniformSpecialisation(gc, psShader);
+		return;
+	}
+
+	psJob = GLES2Calloc(gc, sizeof(GLES2ShaderReoptJob));
+
+	if(!psJob)
+	{
+		return;
+	}
+
+	ui32SourceLength = strlen(psSharedState->pszSpecialisationSource);
+
+	psJob->pszSource = GLES2Malloc(gc, ui32SourceLength + 1);
+	psJob->pui32SpecialisedCompFlags = GLES2Malloc(gc, ui32NumWords * sizeof(IMG_UINT32));
+	psJob->pfSpecialisedCompData = GLES2Malloc(gc, psSpecialisation->ui32NumComps * sizeof(IMG_FLOAT));
+
+	if(!psJob->pszSource || !psJob->pui32SpecialisedCompFlags || !psJob->pfSpecialisedCompData)
+	{
+		GLES2Free(IMG_NULL, psJob->pszSource);
+		GLES2Free(IMG_NULL, psJob->pui32SpecialisedCompFlags);
+		GLES2Free(IMG_NULL, psJob->pfSpecialisedCompData);
+		GLES2Free(IMG_NULL, psJob);
+
+		return;
+	}
+
+	GLES2MemCopy(psJob->pszSource, psSharedState->pszSpecialisationSource, ui32SourceLength + 1);
+
+	for(i = 0; i < ui32NumWords; i++)
+	{
+		psJob->pui32SpecialisedCompFlags[i] = psSpecialisation->pui32CandidateMask[i] & ~psSpecialisation->pui32VolatileMask[i];
+	}
+
+	/* Values as they are now; any later change marks them volatile and the result is discarded */
+	GLES2MemCopy(psJob->pfSpecialisedCompData, psShader->pfConstantData, psSpecialisation->ui32NumComps * sizeof(IMG_FLOAT));
+
+	psJob->ui32NumSpecialisedComps = psSpecialisation->ui32NumComps;
+
+	SharedShaderStateAddRef(gc, psSharedState);
+
+	psJob->psSharedState = psSharedState;
+	psJob->eProgramType = psShader->eProgramType;
+	psJob->eState = GLES2_SHADER_REOPT_PENDING;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	psJob->psSpecialisation = psSpecialisation;
+	psSpecialisation->psJob = psJob;
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	gc->sProgram.ui32NumSpecialisations++;
+
+	AppendShaderReoptJob(gc, psJob);
+}
+
+
+/***********************************************************************************
+ Function Name      : FallBackToGenericShader
+ Inputs             : gc, psShader
+ Outputs            : -
+ Returns            : -
+ Description        : Puts a program shader whose folded uniforms changed back on the
+					  generic code.
+************************************************************************************/
+static IMG_VOID FallBackToGenericShader(GLES2Context *gc, GLES2ProgramShader *psShader)
+{
+	GLES2ShaderSpecialisation *psSpecialisation = psShader->psSpecialisation;
+
+	/* Variants go first, as they hold on to the code state's secondary upload task */
+	DropProgramShaderVariants(gc, psShader);
+
+	SharedShaderStateDelRef(gc, psSpecialisation->psCodeState);
+	psSpecialisation->psCodeState = IMG_NULL;
+
+	GLES2MemSet(psSpecialisation->pui32FoldedMask, 0, ((psSpecialisation->ui32NumComps + 31) >> 5) * sizeof(IMG_UINT32));
+
+	psSpecialisation->bFallback = IMG_FALSE;
+
+	gc->ui32DirtyState |= (psShader->eProgramType == GLSLPT_VERTEX) ? GLES2_DIRTYFLAG_VERTEX_PROGRAM : GLES2_DIRTYFLAG_FRAGMENT_PROGRAM;
+}
+
+
+/***********************************************************************************
+ Function Name      : UpdateUniformSpecialisation
+ Inputs             : gc, psProgram
+ Outputs            : -
+ Returns            : -
+ Description        : Called for every draw when uniform specialisation is enabled.
+					  Restores the generic code of shaders whose folded uniforms
+					  changed, and queues a specialised recompile once a shader's
+					  uniforms have stayed unchanged for UniformSpecialisationDraws
+					  draws.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID UpdateUniformSpecialisation(GLES2Context *gc, GLES2Program *psProgram)
+{
+	GLES2ProgramShader *psShader;
+	GLES2ShaderSpecialisation *psSpecialisation;
+	IMG_UINT32 i;
 
-	/* Fragment variants. The KRM keeps track of their status. */
-	psUSEVariant = *ppsUSEVariantListHead;
+	if(!psProgram)
+	{
+		return;
+	}
 
-	while(psUSEVariant)
+	for(i = 0; i < 2; i++)
 	{
-		psUSEVariantNext = psUSEVariant->psNext;
+		psShader = i ? &psProgram->sFragment : &psProgram->sVertex;
+		psSpecialisation = psShader->psSpecialisation;
 
-		if(KRM_IsResourceNeeded(psKRM, &psUSEVariant->sResource))
+		if(!psSpecialisation)
 		{
-			GhostUSEShaderVariant(gc, psUSEVariant);
+			continue;
 		}
-		else
+
+		psSpecialisation->bDrawn = IMG_TRUE;
+
+		if(psSpecialisation->bFallback)
 		{
-			DestroyUSEShaderVariant(gc, psUSEVariant);
+			GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_FALLBACK_COUNT, 1);
+
+			FallBackToGenericShader(gc, psShader);
 		}
 
-		if(gc->sProgram.psCurrentFragmentVariant==psUSEVariant)
+		if(psSpecialisation->psCodeState)
 		{
-			gc->sProgram.psCurrentFragmentVariant=IMG_NULL;
-		}	
+			GLES2_INC_COUNT(GLES2_TIMER_SHADER_SPECIALISE_HIT_COUNT, 1);
+			continue;
+		}
 
-		/* Keep the list consistent as DestroyUSEShaderVariant requires it */
-		psUSEVariant = psUSEVariantNext;
+		if(psSpecialisation->psJob ||
+		   (++psSpecialisation->ui32StableDraws < gc->sAppHints.ui32UniformSpecialisationDraws))
+		{
+			continue;
+		}
 
-		*ppsUSEVariantListHead = psUSEVariant;
+		QueueUniformSpecialisation(gc, psShader);
 	}
 }
 
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
+
 
 /***********************************************************************************
  Function Name      : ResetProgramLinkedState
@@ -1854,6 +3320,11 @@ static IMG_VOID ResetProgramLinkedState(GLES2Context *gc, GLES2Program *psProgra
 	SharedShaderStateDelRef(gc, psProgram->sFragment.psSharedState);
 	psProgram->sFragment.psSharedState = IMG_NULL;
 
+#if defined(SUPPORT_SOURCE_SHADER)
+	FreeUniformSpecialisation(gc, &psProgram->sVertex);
+	FreeUniformSpecialisation(gc, &psProgram->sFragment);
+#endif
+
 	/* Reset every variable for safety */
 	if (psProgram->sVertex.pfConstantData != IMG_NULL)
 	{
@@ -2673,10 +4144,51 @@ static IMG_VOID AppendMessageToProgramInfoLog(GLES2Context *gc, GLES2Program *ps
 	strcat(psProgram->pszInfoLog, pszMessage);
 }
 
+#if defined(DEBUG)
+/***********************************************************************************
+ Function Name      : AppendPerfReportToProgramInfoLog
+ Inputs             : gc, psProgram, pszStage, psSharedState
+ Outputs            : -
+ Returns            : -
+ Description        : Appends USC's static performance report for one stage of the
+					  program to its infolog. Shaders loaded from binaries have no
+					  report.
+************************************************************************************/
+static IMG_VOID AppendPerfReportToProgramInfoLog(GLES2Context *gc, GLES2Program *psProgram, const IMG_CHAR *pszStage,
+												 const GLES2SharedShaderState *psSharedState)
+{
+	const UNIFLEX_PERF_REPORT *psReport;
+	IMG_CHAR szLogMessage[GLES2_MAX_LINK_MESSAGE_LENGTH];
+	IMG_UINT32 ui32DualIssuePercent;
+
+	if(!psSharedState || !psSharedState->sPerfReport.uMainProgInstCount)
+	{
+		return;
+	}
+
+	psReport = &psSharedState->sPerfReport;
+
+	ui32DualIssuePercent = (psReport->uDualIssueCount * 100) / psReport->uMainProgInstCount;
+
+	snprintf(szLogMessage, GLES2_MAX_LINK_MESSAGE_LENGTH,
+		"%s: %u instructions (%u secondary), %u-%u cycles, %u+%u texture reads, %u%% dual-issued, "
+		"%u/%u spill loads/stores, %u PA %u SA %u temps\n",
+		pszStage,
+		psReport->uMainProgInstCount, psReport->uSAProgInstCount,
+		psReport->uMinPathCycles, psReport->uMaxPathCycles,
+		psReport->uTextureSampleCount, psReport->uNonDependentTextureLoadCount,
+		ui32DualIssuePercent,
+		psReport->uSpillLoadCount, psReport->uSpillStoreCount,
+		psReport->uPrimaryAttributeCount, psReport->uConstSecAttrCount, psReport->uTemporaryRegisterCount);
+
+	AppendMessageToProgramInfoLog(gc, psProgram, szLogMessage);
+}
+#endif /* defined(DEBUG) */
+
 
 /***********************************************************************************
  Function Name      : LinkVertexFragmentPrograms
- Inputs             : gc, psProgram
+ Inputs             : gc, psProgram, psVertexState, psFragmentState
  Outputs            : 
  Returns            : 
  Description        : Post process following GLSL compilation
@@ -2689,7 +4201,9 @@ static IMG_VOID AppendMessageToProgramInfoLog(GLES2Context *gc, GLES2Program *ps
 					  6) Setup Vertex Output reg remapping 
 					  7) Link log message if any
 ************************************************************************************/
-static IMG_BOOL LinkVertexFragmentPrograms(GLES2Context *gc, GLES2Program *psProgram)
+static IMG_BOOL LinkVertexFragmentPrograms(GLES2Context *gc, GLES2Program *psProgram,
+										   GLES2SharedShaderState *psVertexState,
+										   GLES2SharedShaderState *psFragmentState)
 {
 	GLES2Attribute			*psAttrib;
 	GLES2Varying			*psVarying = IMG_NULL;
@@ -2707,10 +4221,10 @@ static IMG_BOOL LinkVertexFragmentPrograms(GLES2Context *gc, GLES2Program *psPro
 	GLES2MemSet(szLogMessage, 0, GLES2_MAX_LINK_MESSAGE_LENGTH);
 
 	/* Take reference to shared shader state */
-	psProgram->sVertex.psSharedState = psProgram->psVertexShader->psSharedState;
+	psProgram->sVertex.psSharedState = psVertexState;
 	SharedShaderStateAddRef(gc, psProgram->sVertex.psSharedState);
 	
-	psProgram->sFragment.psSharedState = psProgram->psFragmentShader->psSharedState;
+	psProgram->sFragment.psSharedState = psFragmentState;
 	SharedShaderStateAddRef(gc, psProgram->sFragment.psSharedState);
 
 	/* 
@@ -3108,6 +4622,13 @@ FailedLink:
 	{
 		AppendMessageToProgramInfoLog(gc, psProgram, szLogMessage);
 	}
+#if defined(DEBUG)
+	else
+	{
+		AppendPerfReportToProgramInfoLog(gc, psProgram, "Vertex shader", psProgram->sVertex.psSharedState);
+		AppendPerfReportToProgramInfoLog(gc, psProgram, "Fragment shader", psProgram->sFragment.psSharedState);
+	}
+#endif
 
 #if defined(DEBUG)
 	if(gc->pShaderAnalysisHandle)
@@ -3453,51 +4974,379 @@ static IMG_VOID UseProgram(GLES2Context *gc, GLuint program)
 #if defined(GLES2_EXTENSION_GET_PROGRAM_BINARY)
 		if (psCurrentProgram->bLoadFromBinary)
 		{
-			bOldVP = bOldFP = IMG_TRUE;
+			bOldVP = bOldFP = IMG_TRUE;
+		}
+		else
+#endif
+		{
+			if(gc->sProgram.psCurrentProgram->psVertexShader)
+			{
+				bOldVP = IMG_TRUE;
+			}
+
+			if(gc->sProgram.psCurrentProgram->psFragmentShader)
+			{
+				bOldFP = IMG_TRUE;
+			}
+		}
+
+		GLES_ASSERT((psCurrentProgram->sNamedItem.ui32RefCount > 1) || psCurrentProgram->bDeleting);
+		NamedItemDelRef(gc, psNamesArray, &psCurrentProgram->sNamedItem);
+	}
+
+	gc->sProgram.psCurrentProgram = psProgram;
+	if (gc->sProgram.psCurrentProgram) 
+	{
+#if defined(GLES2_EXTENSION_GET_PROGRAM_BINARY)
+		if (gc->sProgram.psCurrentProgram->bLoadFromBinary)
+		{
+			bCurrentVP = bCurrentFP = IMG_TRUE;
+		}
+		else
+#endif
+		{
+			if(gc->sProgram.psCurrentProgram->psVertexShader)
+			{
+				bCurrentVP = IMG_TRUE;
+			}
+
+			if(gc->sProgram.psCurrentProgram->psFragmentShader)
+			{
+				bCurrentFP = IMG_TRUE;
+			}
+		}
+	}
+
+	SetupDirtyProgramValidationFlags(gc, bOldVP, bOldFP, bCurrentVP, bCurrentFP);
+}
+
+
+#if defined(SUPPORT_SOURCE_SHADER)
+/***********************************************************************************
+ Function Name      : FindUserVarying
+ Inputs             : psSymbolList, eTypeQualifier, pszName
+ Outputs            : -
+ Returns            : Binding symbol of the varying, or IMG_NULL if the shader doesn't use it
+ Description        : UTILITY: Looks up a user declared varying of a shader by name.
+************************************************************************************/
+static GLSLBindingSymbol *FindUserVarying(const GLSLBindingSymbolList *psSymbolList, GLSLTypeQualifier eTypeQualifier,
+										  const IMG_CHAR *pszName)
+{
+	GLSLBindingSymbol *psSymbol;
+	IMG_UINT32 i;
+
+	for(i = 0; i < psSymbolList->uNumBindings; i++)
+	{
+		psSymbol = &psSymbolList->psBindingSymbolEntries[i];
+
+		if(psSymbol->eBIVariableID == GLSLBV_NOT_BTIN &&
+		   psSymbol->eTypeQualifier == eTypeQualifier &&
+		   !strcmp(psSymbol->pszName, pszName))
+		{
+			return psSymbol;
+		}
+	}
+
+	return IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : LinkedVaryingsMatch
+ Inputs             : psLinkedVaryingsA, ui32NumA, psLinkedVaryingsB, ui32NumB
+ Outputs            : -
+ Returns            : IMG_TRUE if the two lists are the same
+ Description        : UTILITY: Compares the varyings two link variants are compiled against.
+************************************************************************************/
+static IMG_BOOL LinkedVaryingsMatch(const GLSLLinkedVarying *psLinkedVaryingsA, IMG_UINT32 ui32NumA,
+									const GLSLLinkedVarying *psLinkedVaryingsB, IMG_UINT32 ui32NumB)
+{
+	IMG_UINT32 i, j;
+
+	if(ui32NumA != ui32NumB)
+	{
+		return IMG_FALSE;
+	}
+
+	for(i = 0; i < ui32NumA; i++)
+	{
+		if(psLinkedVaryingsA[i].uNumComponents != psLinkedVaryingsB[i].uNumComponents ||
+		   strcmp(psLinkedVaryingsA[i].pszName, psLinkedVaryingsB[i].pszName))
+		{
+			return IMG_FALSE;
+		}
+
+		for(j = 0; j < psLinkedVaryingsA[i].uNumComponents; j++)
+		{
+			if(psLinkedVaryingsA[i].afValue[j] != psLinkedVaryingsB[i].afValue[j])
+			{
+				return IMG_FALSE;
+			}
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetLinkVariant
+ Inputs             : gc, psSharedState, eProgramType, ui32NumLinkedVaryings, psLinkedVaryings
+ Outputs            : -
+ Returns            : Referenced link variant, or IMG_NULL if it couldn't be compiled
+ Description        : Finds the variant of a shader compiled against the given varyings
+					  of the other stage, compiling it from the kept source the first
+					  time it is needed. Variants are cached on the shader they were
+					  compiled from, so each unique pairing is only compiled once.
+************************************************************************************/
+static GLES2SharedShaderState *GetLinkVariant(GLES2Context *gc, GLES2SharedShaderState *psSharedState,
+											  GLSLProgramType eProgramType, IMG_UINT32 ui32NumLinkedVaryings,
+											  const GLSLLinkedVarying *psLinkedVaryings)
+{
+	GLES2SharedShaderState *psVariant;
+	GLSLCompiledUniflexProgram *psCompiledProgram;
+
+	/* ENTER CRITICAL SECTION */
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	for(psVariant = psSharedState->psLinkVariants; psVariant; psVariant = psVariant->psNextLinkVariant)
+	{
+		if(LinkedVaryingsMatch(psVariant->psLinkedVaryings, psVariant->ui32NumLinkedVaryings,
+							   psLinkedVaryings, ui32NumLinkedVaryings))
+		{
+			psVariant->ui32RefCount++;
+			break;
+		}
+	}
+
+	/* EXIT CRITICAL SECTION */
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(psVariant)
+	{
+		GLES2_INC_COUNT(GLES2_TIMER_SHADER_LINK_VARIANT_HIT_COUNT, 1);
+
+		return psVariant;
+	}
+
+	if(!gc->sProgram.hGLSLCompiler && !InitializeGLSLCompiler(gc))
+	{
+		return IMG_NULL;
+	}
+
+	gc->sProgram.ui32CompilesThisFrame++;
+
+	LockGLSLCompiler(gc);
+
+	psCompiledProgram = CompileShaderSource(gc, eProgramType, &psSharedState->pszSpecialisationSource, IMG_FALSE,
+											0, IMG_NULL, IMG_NULL, ui32NumLinkedVaryings, psLinkedVaryings);
+
+	UnlockGLSLCompiler(gc);
+
+	if(!psCompiledProgram)
+	{
+		return IMG_NULL;
+	}
+
+	if(psCompiledProgram->bSuccessfullyCompiled)
+	{
+		psVariant = CreateSharedShaderState(gc, psCompiledProgram);
+	}
+
+	gc->sProgram.sGLSLFuncTable.pfnFreeCompiledUniflexProgram(&gc->sProgram.sInitCompilerContext, psCompiledProgram);
+
+	if(!psVariant)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "GetLinkVariant: Couldn't compile a link variant, using the original shader"));
+		return IMG_NULL;
+	}
+
+	psVariant->psLinkedVaryings = CopyLinkedVaryings(gc, psLinkedVaryings, ui32NumLinkedVaryings);
+
+	if(!psVariant->psLinkedVaryings)
+	{
+		SharedShaderStateDelRef(gc, psVariant);
+		return IMG_NULL;
+	}
+
+	psVariant->ui32NumLinkedVaryings = ui32NumLinkedVaryings;
+
+	/* Variants can still be uniform specialised */
+	KeepSourceForSpecialisation(gc, psVariant, psSharedState->pszSpecialisationSource);
+
+	/* ENTER CRITICAL SECTION */
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	/* One reference for the cache and one for the caller */
+	psVariant->ui32RefCount++;
+
+	psVariant->psNextLinkVariant = psSharedState->psLinkVariants;
+	psSharedState->psLinkVariants = psVariant;
+
+	/* EXIT CRITICAL SECTION */
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	GLES2_INC_COUNT(GLES2_TIMER_SHADER_LINK_VARIANT_COUNT, 1);
+
+	return psVariant;
+}
+
+
+/***********************************************************************************
+ Function Name      : OptimiseLinkedVaryings
+ Inputs             : gc, psProgram
+ Outputs            : -
+ Returns            : IMG_TRUE if the program is still linked
+ Description        : Relinks a program which has just been linked from its attached
+					  shaders with variants compiled against each other:
+					  1) Varyings the vertex shader only ever writes with a constant are
+						 replaced by that constant in the fragment shader.
+					  2) Varyings the fragment shader then doesn't read are removed from
+						 the vertex shader, along with the code computing them, and the
+						 remaining varyings are packed into fewer output registers and
+						 iterators.
+					  If anything goes wrong the program is relinked from the originals.
+************************************************************************************/
+static IMG_BOOL OptimiseLinkedVaryings(GLES2Context *gc, GLES2Program *psProgram)
+{
+	GLES2SharedShaderState *psVertexState = psProgram->psVertexShader->psSharedState;
+	GLES2SharedShaderState *psFragmentState = psProgram->psFragmentShader->psSharedState;
+	GLES2SharedShaderState *psVertexVariant = IMG_NULL;
+	GLES2SharedShaderState *psFragmentVariant = IMG_NULL;
+	const GLSLBindingSymbolList *psVertexSymbolList = &psVertexState->sBindingSymbolList;
+	GLSLLinkedVarying *psFragmentKey, *psVertexKey;
+	IMG_UINT32 ui32NumFragmentKey = 0, ui32NumVertexKey = 0, ui32NumFolded = 0, i;
+	IMG_BOOL bLinked;
+
+	/* Binary shaders can't be recompiled, and fast tier shaders are about to be replaced */
+	if(!psVertexState->pszSpecialisationSource || !psFragmentState->pszSpecialisationSource ||
+	   psVertexState->bFastTier || psFragmentState->bFastTier || !psVertexSymbolList->uNumBindings)
+	{
+		return IMG_TRUE;
+	}
+
+	/* Neither list can be longer than the vertex shader's bindings */
+	psFragmentKey = GLES2Malloc(gc, 2 * psVertexSymbolList->uNumBindings * sizeof(GLSLLinkedVarying));
+
+	if(!psFragmentKey)
+	{
+		return IMG_TRUE;
+	}
+
+	psVertexKey = &psFragmentKey[psVertexSymbolList->uNumBindings];
+
+	/* Fold the constant varyings the fragment shader reads into it */
+	for(i = 0; i < psVertexState->ui32NumConstantVaryings; i++)
+	{
+		if(FindUserVarying(&psFragmentState->sBindingSymbolList, GLSLTQ_FRAGMENT_IN, psVertexState->psConstantVaryings[i].pszName))
+		{
+			psFragmentKey[ui32NumFragmentKey++] = psVertexState->psConstantVaryings[i];
+		}
+	}
+
+	if(ui32NumFragmentKey)
+	{
+		psFragmentVariant = GetLinkVariant(gc, psFragmentState, GLSLPT_FRAGMENT, ui32NumFragmentKey, psFragmentKey);
+	}
+
+	/* Then remove the vertex outputs the fragment shader doesn't read */
+	for(i = 0; i < psVertexSymbolList->uNumBindings; i++)
+	{
+		GLSLBindingSymbol *psSymbol = &psVertexSymbolList->psBindingSymbolEntries[i];
+
+		if(psSymbol->eBIVariableID != GLSLBV_NOT_BTIN || psSymbol->eTypeQualifier != GLSLTQ_VERTEX_OUT)
+		{
+			continue;
+		}
+
+		if(!FindUserVarying(psFragmentVariant ? &psFragmentVariant->sBindingSymbolList : &psFragmentState->sBindingSymbolList,
+							GLSLTQ_FRAGMENT_IN, psSymbol->pszName))
+		{
+			psVertexKey[ui32NumVertexKey].pszName = psSymbol->pszName;
+			psVertexKey[ui32NumVertexKey].uNumComponents = 0;
+
+			if(FindUserVarying(&psFragmentState->sBindingSymbolList, GLSLTQ_FRAGMENT_IN, psSymbol->pszName))
+			{
+				ui32NumFolded++;
+			}
+
+			ui32NumVertexKey++;
+		}
+	}
+
+	if(ui32NumVertexKey)
+	{
+		psVertexVariant = GetLinkVariant(gc, psVertexState, GLSLPT_VERTEX, ui32NumVertexKey, psVertexKey);
+	}
+
+	GLES2Free(IMG_NULL, psFragmentKey);
+
+	if(!psVertexVariant && !psFragmentVariant)
+	{
+		return IMG_TRUE;
+	}
+
+	ResetProgramLinkedState(gc, psProgram);
+
+	GLES2Free(IMG_NULL, psProgram->pszInfoLog);
+	psProgram->pszInfoLog = IMG_NULL;
+
+	/* Outputs the fragment shader doesn't read are fine, so either variant may be used alone */
+	bLinked = LinkVertexFragmentPrograms(gc, psProgram,
+										 psVertexVariant ? psVertexVariant : psVertexState,
+										 psFragmentVariant ? psFragmentVariant : psFragmentState);
+
+	if(bLinked)
+	{
+		if(!psVertexVariant)
+		{
+			ui32NumVertexKey = 0;
 		}
-		else
-#endif
-		{
-			if(gc->sProgram.psCurrentProgram->psVertexShader)
-			{
-				bOldVP = IMG_TRUE;
-			}
 
-			if(gc->sProgram.psCurrentProgram->psFragmentShader)
-			{
-				bOldFP = IMG_TRUE;
-			}
+		if(!psFragmentVariant)
+		{
+			ui32NumFolded = 0;
 		}
 
-		GLES_ASSERT((psCurrentProgram->sNamedItem.ui32RefCount > 1) || psCurrentProgram->bDeleting);
-		NamedItemDelRef(gc, psNamesArray, &psCurrentProgram->sNamedItem);
-	}
+		GLES2_INC_COUNT(GLES2_TIMER_SHADER_LINK_OUTPUTS_REMOVED_COUNT, ui32NumVertexKey);
+		GLES2_INC_COUNT(GLES2_TIMER_SHADER_LINK_VARYINGS_FOLDED_COUNT, ui32NumFolded);
 
-	gc->sProgram.psCurrentProgram = psProgram;
-	if (gc->sProgram.psCurrentProgram) 
-	{
-#if defined(GLES2_EXTENSION_GET_PROGRAM_BINARY)
-		if (gc->sProgram.psCurrentProgram->bLoadFromBinary)
+#if defined(DEBUG)
 		{
-			bCurrentVP = bCurrentFP = IMG_TRUE;
+			IMG_CHAR szLogMessage[GLES2_MAX_LINK_MESSAGE_LENGTH];
+
+			snprintf(szLogMessage, GLES2_MAX_LINK_MESSAGE_LENGTH,
+				"Linked varyings: %u vertex outputs removed, %u folded into the fragment shader, "
+				"vertex shader %u -> %u instructions, fragment shader %u -> %u instructions\n",
+				ui32NumVertexKey, ui32NumFolded,
+				psVertexState->sPerfReport.uMainProgInstCount,
+				psProgram->sVertex.psSharedState->sPerfReport.uMainProgInstCount,
+				psFragmentState->sPerfReport.uMainProgInstCount,
+				psProgram->sFragment.psSharedState->sPerfReport.uMainProgInstCount);
+
+			AppendMessageToProgramInfoLog(gc, psProgram, szLogMessage);
 		}
-		else
 #endif
-		{
-			if(gc->sProgram.psCurrentProgram->psVertexShader)
-			{
-				bCurrentVP = IMG_TRUE;
-			}
+	}
+	else
+	{
+		PVR_DPF((PVR_DBG_WARNING, "OptimiseLinkedVaryings: Link variants failed to link, using the original shaders"));
 
-			if(gc->sProgram.psCurrentProgram->psFragmentShader)
-			{
-				bCurrentFP = IMG_TRUE;
-			}
-		}
+		ResetProgramLinkedState(gc, psProgram);
+
+		GLES2Free(IMG_NULL, psProgram->pszInfoLog);
+		psProgram->pszInfoLog = IMG_NULL;
+
+		bLinked = LinkVertexFragmentPrograms(gc, psProgram, psVertexState, psFragmentState);
 	}
 
-	SetupDirtyProgramValidationFlags(gc, bOldVP, bOldFP, bCurrentVP, bCurrentFP);
+	/* The program holds its own references */
+	SharedShaderStateDelRef(gc, psVertexVariant);
+	SharedShaderStateDelRef(gc, psFragmentVariant);
+
+	return bLinked;
 }
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
 
 
 /***********************************************************************************
@@ -3512,6 +5361,7 @@ GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
 	GLES2Program *psProgram;
 	IMG_BOOL bOldVP = IMG_FALSE;
 	IMG_BOOL bOldFP = IMG_FALSE;
+	IMG_BOOL bLinked;
 
 	__GLES2_GET_CONTEXT();
 
@@ -3560,11 +5410,27 @@ GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
 		** Generate uniform list, attribute list and varying list, assign 
 		** each uniform and attribute a location, and more ...
 		*/
-		if(LinkVertexFragmentPrograms(gc, psProgram))
+		bLinked = LinkVertexFragmentPrograms(gc, psProgram, psProgram->psVertexShader->psSharedState,
+											 psProgram->psFragmentShader->psSharedState);
+
+#if defined(SUPPORT_SOURCE_SHADER)
+		if(bLinked && gc->sAppHints.bOptimiseLinkedVaryings)
+		{
+			bLinked = OptimiseLinkedVaryings(gc, psProgram);
+		}
+#endif
+
+		if(bLinked)
 		{
 			psProgram->bSuccessfulLink  = IMG_TRUE;
 			psProgram->sVertex.bValid   = IMG_TRUE;
 			psProgram->sFragment.bValid = IMG_TRUE;
+
+			PrewarmProgramVariants(gc, psProgram);
+
+#if defined(SUPPORT_SOURCE_SHADER)
+			SetupUniformSpecialisation(gc, psProgram);
+#endif
 		}
 	}
 	else
@@ -3775,6 +5641,153 @@ StopTimeAndReturn:
 	GLES2_TIME_STOP(GLES2_TIMES_glValidateProgram);
 }
 
+
+#if defined(SUPPORT_SOURCE_SHADER)
+/***********************************************************************************
+ Function Name      : ForgetInternedShader
+ Inputs             : gc, ui32Item
+ Outputs            : -
+ Returns            : -
+ Description        : UTILITY: Called by the intern table when a shader leaves it. The
+					  table holds no reference, so the shader only forgets its key.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID ForgetInternedShader(GLES2Context *gc, IMG_UINT32 ui32Item)
+{
+	GLES2SharedShaderState *psSharedState = (GLES2SharedShaderState *)ui32Item;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	psSharedState->pui32InternKey = IMG_NULL;
+	psSharedState->ui32InternKeySizeInDWords = 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetShaderInternKey
+ Inputs             : gc, eProgramType, ppszSource, ui32CompileTier
+ Outputs            : ppui32Key, pui32KeySizeInDWords, ptHash
+ Returns            : IMG_TRUE if the shader can be looked up in the intern table
+ Description        : Builds the key identical shaders are shared by: the compile
+					  parameters followed by the preprocessed tokens of the source,
+					  so whitespace, comments and unused macros don't matter. The
+					  caller must hold the compiler lock.
+************************************************************************************/
+static IMG_BOOL GetShaderInternKey(GLES2Context *gc, GLSLProgramType eProgramType, IMG_CHAR **ppszSource,
+								   IMG_UINT32 ui32CompileTier, IMG_UINT32 **ppui32Key,
+								   IMG_UINT32 *pui32KeySizeInDWords, HashValue *ptHash)
+{
+	GLSLCompileProgramContext sCompileContext = {0};
+	IMG_UINT32 *pui32Tokens, ui32NumTokenDWords, *pui32Key;
+
+	if(!gc->sAppHints.bShareIdenticalShaders || !*ppszSource)
+	{
+		return IMG_FALSE;
+	}
+
+	sCompileContext.psInitCompilerContext = &gc->sProgram.sInitCompilerContext;
+	sCompileContext.eProgramType = eProgramType;
+	sCompileContext.ppszSourceCodeStrings = ppszSource;
+	sCompileContext.uNumSourceCodeStrings = 1;
+
+	if(!gc->sProgram.sGLSLFuncTable.pfnGetPreprocessedTokens(&sCompileContext, UniPatchMalloc, &pui32Tokens, &ui32NumTokenDWords))
+	{
+		return IMG_FALSE;
+	}
+
+	pui32Key = GLES2Malloc(gc, (ui32NumTokenDWords + 2) * sizeof(IMG_UINT32));
+
+	if(!pui32Key)
+	{
+		UniPatchFree(pui32Tokens);
+
+		return IMG_FALSE;
+	}
+
+	/* Everything else CompileShaderSource depends on is fixed for the share group */
+	pui32Key[0] = (IMG_UINT32)eProgramType;
+	pui32Key[1] = (ui32CompileTier == GLES2_SHADER_TIER_FULL) ? 0 : 1;
+
+	GLES2MemCopy(&pui32Key[2], pui32Tokens, ui32NumTokenDWords * sizeof(IMG_UINT32));
+
+	UniPatchFree(pui32Tokens);
+
+	*ppui32Key = pui32Key;
+	*pui32KeySizeInDWords = ui32NumTokenDWords + 2;
+	*ptHash = HashFunc(pui32Key, ui32NumTokenDWords + 2, STATEHASH_INIT_VALUE);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : FindInternedShader
+ Inputs             : gc, pui32Key, ui32KeySizeInDWords, tHash
+ Outputs            : -
+ Returns            : Shared state compiled from an identical shader with a reference
+					  added, or IMG_NULL
+ Description        : Looks a shader up in the share group's intern table.
+************************************************************************************/
+static GLES2SharedShaderState *FindInternedShader(GLES2Context *gc, IMG_UINT32 *pui32Key,
+												  IMG_UINT32 ui32KeySizeInDWords, HashValue tHash)
+{
+	GLES2SharedShaderState *psSharedState = IMG_NULL;
+	IMG_UINT32 ui32Item;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(HashTableSearch(gc, &gc->psSharedState->sShaderInternTable, tHash, pui32Key, ui32KeySizeInDWords, &ui32Item))
+	{
+		psSharedState = (GLES2SharedShaderState *)ui32Item;
+
+		psSharedState->ui32RefCount++;
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	return psSharedState;
+}
+
+
+/***********************************************************************************
+ Function Name      : InternShader
+ Inputs             : gc, psSharedState, pui32Key, ui32KeySizeInDWords, tHash
+ Outputs            : -
+ Returns            : -
+ Description        : Enters a newly compiled shader in the share group's intern
+					  table, which takes ownership of the key. Does nothing if
+					  another context entered an identical shader meanwhile.
+************************************************************************************/
+static IMG_VOID InternShader(GLES2Context *gc, GLES2SharedShaderState *psSharedState, IMG_UINT32 *pui32Key,
+							 IMG_UINT32 ui32KeySizeInDWords, HashValue tHash)
+{
+	IMG_UINT32 ui32Item;
+
+	PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+	if(HashTableSearch(gc, &gc->psSharedState->sShaderInternTable, tHash, pui32Key, ui32KeySizeInDWords, &ui32Item))
+	{
+		PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+		GLES2Free(IMG_NULL, pui32Key);
+
+		return;
+	}
+
+	psSharedState->pui32InternKey = pui32Key;
+	psSharedState->ui32InternKeySizeInDWords = ui32KeySizeInDWords;
+	psSharedState->tInternHash = tHash;
+
+	/* May push out the least recently found shader, see ForgetInternedShader */
+	HashTableInsert(gc, &gc->psSharedState->sShaderInternTable, tHash, pui32Key, ui32KeySizeInDWords,
+					(IMG_UINT32)psSharedState);
+
+	PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+
+	GLES2_INC_COUNT(GLES2_TIMER_SHADER_INTERN_COUNT, 1);
+}
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
+
+
 /***********************************************************************************
  Function Name      : glCompileShader
  Inputs             : shader
@@ -3788,20 +5801,17 @@ GL_APICALL void GL_APIENTRY glCompileShader (GLuint shader)
 	IMG_UINT32 ui32InfoLogLength;
 	GLES2Shader *psShader;
 	GLSLProgramType eProgramType;
-	GLSLUniFlexHWCodeInfo sUniFlexInfo;
-	UNIFLEX_PROGRAM_PARAMETERS sUniFlexParams;
-	GLSLCompileProgramContext sCompileContext = {0};
-	GLSLCompileUniflexProgramContext sCompileUniflexContext;
 	GLSLCompiledUniflexProgram *psCompiledProgram;
+	IMG_UINT32 ui32CompileTier;
+	GLES2SharedShaderState *psInternedState = IMG_NULL;
+	IMG_UINT32 *pui32InternKey = IMG_NULL, ui32InternKeySizeInDWords = 0;
+	HashValue tInternHash = 0;
 #if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
 	IMG_CHAR szHashStr[DIGEST_STRING_LENGTH];
 #endif
 
 	__GLES2_GET_CONTEXT();
 
-	GLES2MemSet(&sUniFlexInfo, 0, sizeof(GLSLUniFlexHWCodeInfo));
-	GLES2MemSet(&sUniFlexParams, 0, sizeof(UNIFLEX_PROGRAM_PARAMETERS));
-
 	PVR_DPF((PVR_DBG_CALLTRACE,"glCompileShader"));
 
 	GLES2_TIME_START(GLES2_TIMES_glCompileShader);
@@ -3868,6 +5878,10 @@ GL_APICALL void GL_APIENTRY glCompileShader (GLuint shader)
 			SharedShaderStateDelRef(gc, psShader->psSharedState);
 			psShader->psSharedState = psSharedShaderState;
 
+			GLES2MemCopy(psSharedShaderState->szDigest, szHashStr, DIGEST_STRING_LENGTH);
+
+			KeepSourceForSpecialisation(gc, psSharedShaderState, psShader->pszSource);
+
 			psShader->bSuccessfulCompile = IMG_TRUE;
 
 			GLES2_TIME_STOP(GLES2_TIMES_glCompileShader);
@@ -3878,78 +5892,67 @@ GL_APICALL void GL_APIENTRY glCompileShader (GLuint shader)
 NoBinary:
 #endif
 
-	/* Must be able to fit a 2x2 block in */
-	sUniFlexParams.uNumAvailableTemporaries = gc->psSysContext->sHWInfo.ui32NumUSETemporaryRegisters >> 2;
+	if(!gc->sProgram.hGLSLCompiler && !InitializeGLSLCompiler(gc))
+	{
+		GLES2_TIME_STOP(GLES2_TIMES_glCompileShader);
+		return;
+	}
 
-	if (eProgramType == GLSLPT_FRAGMENT)
+	ui32CompileTier = gc->sAppHints.ui32ShaderCompileTier;
+
+	/* Without the background worker nothing would ever re-optimise the shader */
+	if((ui32CompileTier == GLES2_SHADER_TIER_REOPTIMISE) && !gc->sProgram.hReoptThread)
 	{
-		sUniFlexParams.uConstantBase		= GLES2_FRAGMENT_SECATTR_CONSTANTBASE;
-		sUniFlexParams.uIndexableTempBase	= GLES2_FRAGMENT_SECATTR_INDEXABLETEMPBASE;
-		sUniFlexParams.uScratchBase			= GLES2_FRAGMENT_SECATTR_SCRATCHBASE;
+		ui32CompileTier = GLES2_SHADER_TIER_FULL;
+	}
 
-		sUniFlexParams.uInRegisterConstantOffset = GLES2_FRAGMENT_SECATTR_NUM_RESERVED;
-		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_PS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
+	LockGLSLCompiler(gc);
 
-		sUniFlexParams.uPackDestType = USEASM_REGTYPE_PRIMATTR;
-		sUniFlexParams.uPackPrecision = 5; /* Arbitrary choice */
-		sUniFlexParams.uExtraPARegisters = 0;
+	/* Share the state of an identical shader compiled earlier in the share group */
+	if(GetShaderInternKey(gc, eProgramType, &psShader->pszSource, ui32CompileTier,
+						  &pui32InternKey, &ui32InternKeySizeInDWords, &tInternHash))
+	{
+		psInternedState = FindInternedShader(gc, pui32InternKey, ui32InternKeySizeInDWords, tInternHash);
 	}
-	else
+
+	if(psInternedState)
 	{
-		sUniFlexParams.uConstantBase		= GLES2_VERTEX_SECATTR_CONSTANTBASE;
-		sUniFlexParams.uIndexableTempBase	= GLES2_VERTEX_SECATTR_INDEXABLETEMPBASE;
-		sUniFlexParams.uScratchBase			= GLES2_VERTEX_SECATTR_SCRATCHBASE;
-	
-		sUniFlexParams.uInRegisterConstantOffset = GLES2_VERTEX_SECATTR_NUM_RESERVED;
-		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_VS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
+		UnlockGLSLCompiler(gc);
 
-		sUniFlexParams.uExtraPARegisters = 0;
-	}
+		GLES2Free(IMG_NULL, pui32InternKey);
 
-	sUniFlexParams.ePredicationLevel = UF_PREDLVL_AUTO;
-	sUniFlexParams.uMaxALUInstsToFlatten = 0;
+		SharedShaderStateDelRef(gc, psShader->psSharedState);
+		psShader->psSharedState = psInternedState;
 
-	sUniFlexInfo.psUFParams = &sUniFlexParams;
+		/* Only shaders which compiled without any messages are interned */
+		GLES2Free(IMG_NULL, psShader->pszInfoLog);
+		psShader->pszInfoLog = GLES2Calloc(gc, 1);
 
-	sCompileUniflexContext.eOutputCodeType = GLSLPF_UNIFLEX_OUTPUT;
-	sCompileUniflexContext.psUniflexHWCodeInfo = &sUniFlexInfo;
-	sCompileUniflexContext.psCompileProgramContext = &sCompileContext;
+		if(!psShader->pszInfoLog)
+		{
+			SetError(gc, GL_OUT_OF_MEMORY);
+		}
 
-#if !defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
-	/* Unconditionally create the MSAA trans version of the shader, in case it is used with a MSAA surface 
-	 * after being compiled while a non-MSAA surface is bound.
-	 */
-	if(eProgramType == GLSLPT_FRAGMENT)
-	{
-		sCompileUniflexContext.bCompileMSAATrans = IMG_TRUE;
-	}
-	else
-#endif
-	{
-		sCompileUniflexContext.bCompileMSAATrans = IMG_FALSE;
-	}
+		psShader->bSuccessfulCompile = IMG_TRUE;
+
+		GLES2_INC_COUNT(GLES2_TIMER_SHADER_INTERN_HIT_COUNT, 1);
 
-	if(!gc->sProgram.hGLSLCompiler && !InitializeGLSLCompiler(gc))
-	{
 		GLES2_TIME_STOP(GLES2_TIMES_glCompileShader);
 		return;
 	}
 
-	sCompileContext.psInitCompilerContext = &gc->sProgram.sInitCompilerContext;
-	sCompileContext.eProgramType = eProgramType;
-	sCompileContext.ppszSourceCodeStrings = &psShader->pszSource;
-	sCompileContext.uNumSourceCodeStrings = 1;
+	gc->sProgram.ui32CompilesThisFrame++;
 
-	sCompileContext.bCompleteProgram = IMG_TRUE;
-	sCompileContext.bDisplayMetrics = IMG_FALSE;
-	sCompileContext.bValidateOnly = IMG_FALSE;
-	sCompileContext.eEnabledWarnings = gc->sAppHints.ui32GLSLEnabledWarnings;
+	psCompiledProgram = CompileShaderSource(gc, eProgramType, &psShader->pszSource,
+											(ui32CompileTier != GLES2_SHADER_TIER_FULL) ? IMG_TRUE : IMG_FALSE,
+											0, IMG_NULL, IMG_NULL, 0, IMG_NULL);
 
-	psCompiledProgram = gc->sProgram.sGLSLFuncTable.pfnCompileToUniflex(&sCompileUniflexContext);
+	UnlockGLSLCompiler(gc);
 
 	if (!psCompiledProgram)
 	{
 		PVR_DPF((PVR_DBG_ERROR, "glCompileShader: Failed to compile program\n"));
+		GLES2Free(IMG_NULL, pui32InternKey);
 		GLES2_TIME_STOP(GLES2_TIMES_glCompileShader);
 		return;
 	}
@@ -3974,7 +5977,8 @@ NoBinary:
 	if(psCompiledProgram->bSuccessfullyCompiled)
 	{
 #if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
-		if(psShader->pszSource)
+		/* Only cache fully optimised binaries */
+		if(psShader->pszSource && (ui32CompileTier == GLES2_SHADER_TIER_FULL))
 		{
 			SGXBS_Error eError;
 			IMG_VOID *pvBinary = IMG_NULL;
@@ -4001,12 +6005,46 @@ NoBinary:
 		else
 		{
 			psShader->bSuccessfulCompile = IMG_TRUE;
+
+			KeepSourceForSpecialisation(gc, psShader->psSharedState, psShader->pszSource);
+
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+			if(psShader->pszSource)
+			{
+				GLES2MemCopy(psShader->psSharedState->szDigest, szHashStr, DIGEST_STRING_LENGTH);
+			}
+#endif
+
+			if(ui32CompileTier != GLES2_SHADER_TIER_FULL)
+			{
+				psShader->psSharedState->bFastTier = IMG_TRUE;
+
+				GLES2_INC_COUNT(GLES2_TIMER_SHADER_FAST_TIER_COUNT, 1);
+
+				if(ui32CompileTier == GLES2_SHADER_TIER_REOPTIMISE)
+				{
+					QueueShaderReoptimisation(gc, psShader->psSharedState, eProgramType, psShader->pszSource);
+				}
+			}
+
+			/* The info log of a shader with messages refers to its own source lines */
+			if(pui32InternKey && !ui32InfoLogLength)
+			{
+				InternShader(gc, psShader->psSharedState, pui32InternKey, ui32InternKeySizeInDWords, tInternHash);
+				pui32InternKey = IMG_NULL;
+			}
 		}
 	}
+
+	GLES2Free(IMG_NULL, pui32InternKey);
 	
 	/* We have copied all the information we want out of the compiledprogram - now free it */
+	LockGLSLCompiler(gc);
+
 	gc->sProgram.sGLSLFuncTable.pfnFreeCompiledUniflexProgram(&gc->sProgram.sInitCompilerContext,
 																 psCompiledProgram);
+
+	UnlockGLSLCompiler(gc);
 	
 	GLES2_TIME_STOP(GLES2_TIMES_glCompileShader);
 }
@@ -4375,8 +6413,12 @@ GL_API_EXT void GL_APIENTRY glGetProgramBinaryOES (GLuint program, GLsizei bufSi
 	/*****************************************************
 		 pack program 
 	******************************************************/	
+	LockGLSLCompiler(gc);
+
 	eError = gc->sProgram.sGLSLFuncTable.pfnCreateBinaryProgram(&sUniflexProgramVertex, &sUniflexProgramFragment, psProgram->psUserBinding, (IMG_UINT32)bufSize, (IMG_UINT32 *) length, binary, IMG_TRUE);
 
+	UnlockGLSLCompiler(gc);
+
 	if(eError != SGXBS_NO_ERROR)
 	{
 		if(eError == SGXBS_OUT_OF_MEMORY_ERROR)
@@ -4555,6 +6597,12 @@ GL_API_EXT void GL_APIENTRY glProgramBinaryOES (GLuint program, GLenum binaryFor
 		}
 	}
 
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+	/* Key the variants recorded for these shaders by the binary they were loaded from */
+	DigestDataToHashString(binary, (IMG_UINT32)length, psVertexState->szDigest);
+	GLES2MemCopy(psFragmentState->szDigest, psVertexState->szDigest, DIGEST_STRING_LENGTH);
+#endif
+
 	/******************************************* 
 				link program 
 	********************************************/
@@ -4600,11 +6648,14 @@ GL_API_EXT void GL_APIENTRY glProgramBinaryOES (GLuint program, GLenum binaryFor
 	** Generate uniform list, attribute list and varying list, assign 
 	** each uniform and attribute a location, and more ...
 	*/
-	if(LinkVertexFragmentPrograms(gc, psProgram))
+	if(LinkVertexFragmentPrograms(gc, psProgram, psProgram->psVertexShader->psSharedState,
+								  psProgram->psFragmentShader->psSharedState))
 	{
 		psProgram->bSuccessfulLink  = IMG_TRUE;
 		psProgram->sVertex.bValid   = IMG_TRUE;
 		psProgram->sFragment.bValid = IMG_TRUE;
+
+		PrewarmProgramVariants(gc, psProgram);
 	}
 	
 	if(psProgram->bSuccessfulLink && psProgram == gc->sProgram.psCurrentProgram)
@@ -4729,6 +6780,11 @@ static IMG_VOID FreeProgram(GLES2Context *gc, GLES2Program *psProgram, IMG_BOOL
 	FreeListOfVertexUSEVariants(gc, &psProgram->sVertex.psVariant);
 	FreeListOfFragmentUSEVariants(gc, &psProgram->sFragment.psVariant);
 
+#if defined(SUPPORT_SOURCE_SHADER)
+	FreeUniformSpecialisation(gc, &psProgram->sVertex);
+	FreeUniformSpecialisation(gc, &psProgram->sFragment);
+#endif
+
 	ShaderScratchMemDelRef(gc, psProgram->sVertex.psScratchMem);
 	ShaderIndexableTempsMemDelRef(gc, psProgram->sVertex.psIndexableTempsMem);
 
@@ -4902,6 +6958,24 @@ IMG_INTERNAL IMG_BOOL CreateProgramState(GLES2Context *gc)
 	}
 #endif
 
+	/* Prewarmed shaders are patched on a context of their own so they never disturb the foreground
+	   one. It belongs to the share group, as any context may end up freeing them. Prewarming is
+	   simply skipped if it can't be created.
+	*/
+	PVRSRVLockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+
+	if(!gc->psSharedState->pvPrewarmUniPatchContext)
+	{
+		gc->psSharedState->pvPrewarmUniPatchContext = PVRUniPatchCreateContext(UniPatchMalloc, UniPatchFree, UniPatchDebugPrint);
+	}
+
+	PVRSRVUnlockMutex(gc->psSharedState->hUniPatchFinaliseLock);
+
+	if(gc->sAppHints.bShaderPrewarm && gc->psSharedState->pvPrewarmUniPatchContext)
+	{
+		StartShaderPrewarmThread(gc);
+	}
+
 	return IMG_TRUE;
 }
 
@@ -4929,6 +7003,8 @@ IMG_INTERNAL IMG_VOID FreeProgramState(GLES2Context *gc)
 	DestroyGLSLCompiler(gc);
 #endif
 
+	StopShaderPrewarmThread(gc);
+
 	FreeSpecialUSECodeBlocks(gc);
 
 	/* The current program should already be null thanks to the call to UseProgram(gc, 0) above */
@@ -4949,6 +7025,7 @@ IMG_INTERNAL IMG_VOID DestroyUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVa
 {
 	/* *** FRAGMENT *** */
 	GLES2PDSCodeVariant   *psPDSVariant, *psPDSVariantNext;
+	GLES2PDSVertexCodeVariant *psPDSVertexVariant, *psPDSVertexVariantNext;
 	GLES2USEShaderVariant *psList;
 	IMG_UINT32 ui32DummyItem;
 
@@ -4983,7 +7060,7 @@ IMG_INTERNAL IMG_VOID DestroyUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVa
 	KRM_RemoveResourceFromAllLists(&gc->psSharedState->sUSEShaderVariantKRM, &psUSEVariant->sResource);
 
 	/* Once the lists are OK, destroy the variant */
-	PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psUSEVariant->psPatchedShader);
+	DestroyFinalisedUSEShader(gc, psUSEVariant->psPatchedShader, psUSEVariant->bPrewarmedShader);
 
 	UCH_CodeHeapFree(psUSEVariant->psCodeBlock);
 
@@ -5009,6 +7086,23 @@ IMG_INTERNAL IMG_VOID DestroyUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVa
 		psPDSVariant = psPDSVariantNext;
 	}
 
+	/* Fragment shaders do not have PDS vertex variants */
+	psPDSVertexVariant = psUSEVariant->psPDSVertexVariant;
+
+	while(psPDSVertexVariant)
+	{
+		psPDSVertexVariantNext = psPDSVertexVariant->psNext;
+
+		if(!HashTableDelete(gc, &gc->sProgram.sPDSVertexVariantHashTable, psPDSVertexVariant->tHashValue,  
+									  psPDSVertexVariant->pui32HashCompare, psPDSVertexVariant->ui32HashCompareSizeInDWords,
+									  &ui32DummyItem))
+		{
+			PVR_DPF((PVR_DBG_ERROR,"PDS vertex variant not found in hash table"));
+		}
+
+		psPDSVertexVariant = psPDSVertexVariantNext;
+	}
+
 	GLES2Free(IMG_NULL, psUSEVariant);
 }
 
@@ -49,6 +49,12 @@ typedef enum GLES2SpecialTAG
 
 #define GLES2_MAX_LINK_MESSAGE_LENGTH 256
 
+/* Key used to look up cached PDS vertex programs: the USE task control words, the index size
+   and stream count, followed by the address, stride, shift, size and register of each stream. */
+#define GLES2_PDS_VERTEX_HASH_STREAM_SIZE	5
+#define GLES2_PDS_VERTEX_HASH_COMPARE_SIZE	(PDS_NUM_USE_TASK_CONTROL_WORDS + 2 + \
+											 (GLES2_MAX_VERTEX_ATTRIBS * GLES2_PDS_VERTEX_HASH_STREAM_SIZE))
+
 typedef struct GLES2PDSInfo_TAG
 {
 	/*
@@ -114,6 +120,42 @@ typedef struct GLES2PDSCodeVariantGhost_TAG
 } GLES2PDSCodeVariantGhost;
 
 
+struct GLES2PDSVertexCodeVariant_TAG
+{
+	/* PDS vertex variants are TA-kick resources */
+	KRMResource sResource;
+
+	UCH_UseCodeBlock *psCodeBlock;
+
+	IMG_UINT32 ui32DataSize;
+	IMG_UINT32 ui32ProgramSize;
+
+	/* Patching information returned by PDSGenerateVertexShaderProgram() */
+	PDS_VERTEX_SHADER_PROGRAM_INFO sProgramInfo;
+
+	IMG_UINT32 *pui32HashCompare;
+	IMG_UINT32 ui32HashCompareSizeInDWords;
+
+	HashValue tHashValue;
+
+	/* USE variant whose execution address is embedded in this program */
+	GLES2USEShaderVariant *psUSEVariant;
+
+	/* Next variant in the list. */
+	struct GLES2PDSVertexCodeVariant_TAG *psNext;
+};
+
+
+typedef struct GLES2PDSVertexCodeVariantGhost_TAG
+{
+	/* PDS vertex variant ghosts are TA-kick resources */
+	KRMResource sResource;
+
+	UCH_UseCodeBlock *psCodeBlock;
+
+} GLES2PDSVertexCodeVariantGhost;
+
+
 typedef struct GLES2ConstantRange_TAG
 {
 	IMG_UINT32 ui32Start;
@@ -246,6 +288,9 @@ struct GLES2USEShaderVariant_TAG
 
 	USP_HW_SHADER *psPatchedShader;
 
+	/* psPatchedShader was finalised on the share group's prewarm UniPatch context */
+	IMG_BOOL bPrewarmedShader;
+
 	/* Secondary attributes upload task */
 	GLES2USESecondaryUploadTask *psSecondaryUploadTask;
 
@@ -257,6 +302,9 @@ struct GLES2USEShaderVariant_TAG
 
 	/* Linked list of PDS variants (only for fragment shaders) */
 	GLES2PDSCodeVariant     *psPDSVariant;
+
+	/* Linked list of PDS vertex variants (only for vertex shaders) */
+	GLES2PDSVertexCodeVariant *psPDSVertexVariant;
 	
 	/* Number of elements in the list above. NOTE: it is not a contiguous array! */
 	IMG_UINT32 ui32NumPDSVariants;
@@ -286,6 +334,42 @@ typedef struct GLES2USEShaderVariantGhost_TAG
 } GLES2USEShaderVariantGhost;
 
 
+/* Maximum number of recorded keys and of prewarmed HW shaders kept per shader */
+#define GLES2_MAX_PREWARM_KEYS		16
+
+#define GLES2_PREWARM_KEY_FLAG_VERTEX			0x01
+#define GLES2_PREWARM_KEY_FLAG_MSAATRANS		0x02
+/* Finalised with whatever preamble the UniPatch context last had, so cannot be reproduced */
+#define GLES2_PREWARM_KEY_FLAG_KEEP_PREAMBLE	0x04
+
+/* The UniPatch state a USE variant is finalised with. Texture formats are only
+   meaningful for the enabled units and must be null for the others. */
+typedef struct GLES2ShaderPrewarmKeyRec
+{
+	IMG_UINT32					ui32ImageUnitEnables;
+	const GLES2TextureFormat	*apsTexFormat[GLES2_MAX_TEXTURE_UNITS];
+
+	IMG_UINT8					ui8OutputLocation;
+	IMG_UINT8					ui8PreambleCount;
+	IMG_UINT8					ui8Flags;
+
+} GLES2ShaderPrewarmKey;
+
+/* A HW shader finalised ahead of the first draw that needs it */
+typedef struct GLES2PrewarmedShaderRec
+{
+	struct GLES2PrewarmedShaderRec	*psNext;
+
+	GLES2ShaderPrewarmKey			sKey;
+
+	USP_HW_SHADER					*psPatchedShader;
+
+	/* UniPatch context the shader was finalised on, and must be freed through */
+	IMG_VOID						*pvUniPatchContext;
+
+} GLES2PrewarmedShader;
+
+
 /* GLES2SharedShaderState represents a GL shader after it has been compiled successfully */
 /* It contains data that can be fed to UniPatch to finalise and get hardware machine code */
 typedef struct GLES2SharedShaderStateRec
@@ -308,11 +392,160 @@ typedef struct GLES2SharedShaderStateRec
 	/* Secondary attributes upload task */
 	GLES2USESecondaryUploadTask *psSecondaryUploadTask;
 
+	/* Compiled at the fast tier; may still be replaced by a re-optimised version */
+	IMG_BOOL bFastTier;
+
+#if defined(DEBUG)
+	/* Static performance estimates from USC (all zero for binary shaders) */
+	UNIFLEX_PERF_REPORT sPerfReport;
+#endif
+
+	/* Prewarmed HW shaders not yet claimed by a draw, and the keys the shader has been
+	   drawn with. Protected by the share group's hUniPatchLock. */
+	GLES2PrewarmedShader	*psPrewarmed;
+	IMG_UINT32				ui32NumPrewarmed;
+	GLES2ShaderPrewarmKey	*psPrewarmKeys;
+	IMG_UINT32				ui32NumPrewarmKeys;
+	IMG_BOOL				bPrewarmKeysLoaded;
+
+#if defined(EGL_EXTENSION_ANDROID_BLOB_CACHE)
+	/* Digest of the source or program binary the shader came from, empty if unknown */
+	IMG_CHAR				szDigest[DIGEST_STRING_LENGTH];
+#endif
+
+#if defined(SUPPORT_SOURCE_SHADER)
+	/* Copy of the source, kept to recompile uniform specialised and link variants. IMG_NULL if disabled */
+	IMG_CHAR				*pszSpecialisationSource;
+
+	/* Vertex shader varyings only ever written with one constant value */
+	IMG_UINT32				ui32NumConstantVaryings;
+	GLSLLinkedVarying		*psConstantVaryings;
+
+	/* For a link variant: the varyings it was compiled against, see OptimiseLinkedVaryings */
+	IMG_UINT32				ui32NumLinkedVaryings;
+	GLSLLinkedVarying		*psLinkedVaryings;
+
+	/* Link variants compiled from this shader, each holding a reference from the list.
+	   Protected by the share group's hPrimaryLock */
+	struct GLES2SharedShaderStateRec *psLinkVariants;
+	struct GLES2SharedShaderStateRec *psNextLinkVariant;
+
+	/* Key the shader is entered in the share group's intern table with, or IMG_NULL
+	   if it isn't. Owned by the table. Protected by the share group's hPrimaryLock */
+	IMG_UINT32				*pui32InternKey;
+	IMG_UINT32				ui32InternKeySizeInDWords;
+	HashValue				tInternHash;
+#endif
+
 	IMG_UINT32 ui32RefCount;
 
 } GLES2SharedShaderState;
 
 
+/* Size of the share group table of compiled shaders identical shaders are shared from */
+#define GLES2_SHADER_INTERN_LOG2TABLESIZE	8
+#define GLES2_SHADER_INTERN_MAXNUMENTRIES	1024
+
+/* Shader compile tiers (ShaderCompileTier apphint) */
+#define GLES2_SHADER_TIER_FULL			0
+#define GLES2_SHADER_TIER_REOPTIMISE	1
+#define GLES2_SHADER_TIER_FAST			2
+
+#if defined(SUPPORT_SOURCE_SHADER)
+
+typedef enum GLES2ShaderReoptStateTAG
+{
+	GLES2_SHADER_REOPT_PENDING	= 0,
+	GLES2_SHADER_REOPT_RUNNING	= 1,
+	GLES2_SHADER_REOPT_DONE		= 2,
+	GLES2_SHADER_REOPT_RETIRED	= 3,
+
+} GLES2ShaderReoptState;
+
+/* A fast tier shader waiting to be recompiled at full optimisation by the background worker */
+typedef struct GLES2ShaderReoptJobRec
+{
+	struct GLES2ShaderReoptJobRec *psNext;
+
+	/* Holds a reference until the job is retired */
+	GLES2SharedShaderState	*psSharedState;
+
+	GLSLProgramType			eProgramType;
+
+	/* Private copy of the source, as the app may replace or delete the shader meanwhile */
+	IMG_CHAR				*pszSource;
+
+	/* Result of the full compile. Only valid once the job is DONE, and freed by the worker once RETIRED */
+	GLSLCompiledUniflexProgram *psCompiledProgram;
+
+	GLES2ShaderReoptState	eState;
+
+	/* For uniform specialisation jobs: the program shader to apply the result to (IMG_NULL once
+	   it has been relinked or deleted, protected by the share group's hPrimaryLock), and the
+	   constant components to fold, one bit per component, with their values */
+	struct GLES2ShaderSpecialisationRec *psSpecialisation;
+	IMG_UINT32				ui32NumSpecialisedComps;
+	IMG_UINT32				*pui32SpecialisedCompFlags;
+	IMG_FLOAT				*pfSpecialisedCompData;
+
+} GLES2ShaderReoptJob;
+
+/* Tracks which uniforms of a linked program shader have kept their values, see UpdateUniformSpecialisation */
+typedef struct GLES2ShaderSpecialisationRec
+{
+	GLES2ProgramShader		*psProgramShader;
+
+	/* Bitmasks over the constant components: user uniforms outside arrays, those of them the app
+	   has changed since the program was first drawn (never folded again), and those folded into
+	   psCodeState */
+	IMG_UINT32				ui32NumComps;
+	IMG_UINT32				*pui32CandidateMask;
+	IMG_UINT32				*pui32VolatileMask;
+	IMG_UINT32				*pui32FoldedMask;
+
+	/* Draws since a candidate last changed value */
+	IMG_UINT32				ui32StableDraws;
+	IMG_BOOL				bDrawn;
+
+	/* A folded uniform changed; the generic code must be restored before the next draw */
+	IMG_BOOL				bFallback;
+
+	/* Private UniPatch shaders with the folded values, IMG_NULL while running the generic code */
+	GLES2SharedShaderState	*psCodeState;
+
+	/* Outstanding compile, protected by the share group's hPrimaryLock */
+	GLES2ShaderReoptJob		*psJob;
+
+} GLES2ShaderSpecialisation;
+
+/* The shared state USE variants of a program shader are patched from */
+#define GLES2_SHADER_CODE_STATE(psShader)	(((psShader)->psSpecialisation && (psShader)->psSpecialisation->psCodeState) ? \
+												(psShader)->psSpecialisation->psCodeState : (psShader)->psSharedState)
+
+#else
+
+#define GLES2_SHADER_CODE_STATE(psShader)	((psShader)->psSharedState)
+
+#endif /* defined(SUPPORT_SOURCE_SHADER) */
+
+
+/* A variant the prewarm worker should finalise. Lives on the queuing context's list */
+typedef struct GLES2ShaderPrewarmJobRec
+{
+	struct GLES2ShaderPrewarmJobRec *psNext;
+
+	/* Holds a reference until the job is reaped */
+	GLES2SharedShaderState	*psSharedState;
+
+	GLES2ShaderPrewarmKey	sKey;
+
+	/* Set by the worker, or by a draw that finalised the same key first */
+	IMG_BOOL				bDone;
+	IMG_BOOL				bPrewarmed;
+
+} GLES2ShaderPrewarmJob;
+
+
 /************************************************************************/
 /*                        GLES2 shader state                            */
 /*                                                                      */
@@ -450,6 +683,11 @@ struct GLES2ProgramShaderRec
 	
 	/* Linked list of compiled use shaders for different back end linkage */
 	struct GLES2USEShaderVariant_TAG *psVariant;
+
+#if defined(SUPPORT_SOURCE_SHADER)
+	/* Uniform value specialisation, IMG_NULL if not enabled for this program */
+	struct GLES2ShaderSpecialisationRec *psSpecialisation;
+#endif
 };
 
 
@@ -557,6 +795,12 @@ typedef struct GLES2CompilerFuncTableTAG
 
 	IMG_VOID                     (IMG_CALLCONV *pfnDisplayMetrics)(GLSLInitCompilerContext *psInitCompilerContext);
 
+	IMG_BOOL                     (IMG_CALLCONV *pfnGetPreprocessedTokens)
+	                                   (GLSLCompileProgramContext *psCompileProgramContext,
+	                                    IMG_VOID *(*pfnMalloc)(IMG_UINT32),
+	                                    IMG_UINT32 **ppuTokenStream,
+	                                    IMG_UINT32 *puTokenStreamSizeInDWords);
+
 	IMG_VOID                     (IMG_CALLCONV *pfnFreeCompiledUniflexProgram)
 	                                   (GLSLInitCompilerContext *psInitCompilerContext,
 	                                    GLSLCompiledUniflexProgram *psGLSLCompiledUniflexProgram);
@@ -593,6 +837,9 @@ typedef struct GLES2ProgramMachineRec
 	IMG_UINT32 aui32HashCompare[2 + (GLES2_MAX_TEXTURE_UNITS * (EURASIA_TAG_TEXTURE_STATE_SIZE+1))];
 #endif
 
+	HashTable sPDSVertexVariantHashTable;
+	IMG_UINT32 aui32VertexHashCompare[GLES2_PDS_VERTEX_HASH_COMPARE_SIZE];
+
 #if defined(SUPPORT_SOURCE_SHADER)
 	/* Handle for the GLSL compiler (a dynamically loaded library).
 	 * If the handle is non-null, the compiler was initialized successfully.
@@ -604,8 +851,33 @@ typedef struct GLES2ProgramMachineRec
 	/* Function pointers for the compiler API */
 	GLES2CompilerFuncTable sGLSLFuncTable;
 	GLSLInitCompilerContext sInitCompilerContext;
+
+	/* Background re-optimisation of fast tier shaders.
+	 * hCompilerLock serialises all use of the compiler and is always taken before hReoptLock,
+	 * which protects the job list.
+	 */
+	PVRSRV_MUTEX_HANDLE		hCompilerLock;
+	PVRSRV_MUTEX_HANDLE		hReoptLock;
+	PVRSRV_SEMAPHORE_HANDLE	hReoptSemaphore;
+	SceUID					hReoptThread;
+	volatile IMG_BOOL		bReoptThreadExit;
+	GLES2ShaderReoptJob		*psReoptJobs;
+
+	/* Foreground compiles since the last frame boundary; the worker backs off while non-zero */
+	volatile IMG_UINT32		ui32CompilesThisFrame;
+
+	/* Uniform specialised recompiles queued so far, limited by the UniformSpecialisationBudget apphint */
+	IMG_UINT32				ui32NumSpecialisations;
 #endif
 
+	/* Background prewarming of USE variants, on the share group's prewarm UniPatch context.
+	 * The job list is protected by the share group's hUniPatchLock.
+	 */
+	PVRSRV_SEMAPHORE_HANDLE	hPrewarmSemaphore;
+	SceUID					hPrewarmThread;
+	volatile IMG_BOOL		bPrewarmThreadExit;
+	GLES2ShaderPrewarmJob	*psPrewarmJobs;
+
 	PVRSRV_CLIENT_MEM_INFO	*psDummyFragUSECode;
 	PVRSRV_CLIENT_MEM_INFO	*psDummyVertUSECode;
 
@@ -626,9 +898,31 @@ IMG_VOID DestroyUSEShaderVariant(GLES2Context *gc, GLES2USEShaderVariant *psUSEV
 IMG_VOID DestroyUSEShaderVariantGhost(GLES2Context *gc, GLES2USEShaderVariantGhost *psUSEVariantGhost);
 IMG_VOID DestroyVertexVariants(GLES2Context *gc, const IMG_VOID* pvAttachment, GLES2NamedItem *psNamedItem);
 IMG_VOID DestroyHashedPDSVariant(GLES2Context *gc, IMG_UINT32 ui32Item);
+IMG_VOID DestroyHashedPDSVertexVariant(GLES2Context *gc, IMG_UINT32 ui32Item);
 
 IMG_BOOL InitializeGLSLCompiler(GLES2Context *gc);
 IMG_VOID DestroyGLSLCompiler(GLES2Context *gc);
+IMG_VOID ServiceShaderReoptimisations(GLES2Context *gc);
+IMG_VOID LockGLSLCompiler(GLES2Context *gc);
+IMG_VOID UnlockGLSLCompiler(GLES2Context *gc);
+IMG_VOID NoteUniformSpecialisationChange(GLES2Context *gc, GLES2ProgramShader *psShader,
+										 IMG_UINT32 ui32CompStart, IMG_UINT32 ui32CompCount);
+IMG_VOID UpdateUniformSpecialisation(GLES2Context *gc, GLES2Program *psProgram);
+IMG_VOID ForgetInternedShader(GLES2Context *gc, IMG_UINT32 ui32Item);
+
+IMG_VOID SharedShaderStateAddRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState);
+IMG_VOID SharedShaderStateDelRef(GLES2Context *gc, GLES2SharedShaderState *psSharedState);
+
+IMG_BOOL StartShaderPrewarmThread(GLES2Context *gc);
+IMG_VOID StopShaderPrewarmThread(GLES2Context *gc);
+IMG_VOID ServiceShaderPrewarm(GLES2Context *gc);
+IMG_VOID PrewarmProgramVariants(GLES2Context *gc, GLES2Program *psProgram);
+IMG_VOID RequeueShaderPrewarm(GLES2Context *gc, GLES2SharedShaderState *psSharedState);
+IMG_VOID DiscardPrewarmedShaders(GLES2Context *gc, GLES2SharedShaderState *psSharedState);
+IMG_VOID FreeSharedShaderPrewarmState(GLES2Context *gc, GLES2SharedShaderState *psSharedState);
+USP_HW_SHADER *FinaliseUSEShader(GLES2Context *gc, GLES2SharedShaderState *psSharedState, const GLES2ShaderPrewarmKey *psKey,
+								 IMG_BOOL *pbPrewarmed);
+IMG_VOID DestroyFinalisedUSEShader(GLES2Context *gc, USP_HW_SHADER *psPatchedShader, IMG_BOOL bPrewarmed);
 
 IMG_VOID USESecondaryUploadTaskAddRef(GLES2Context *gc, GLES2USESecondaryUploadTask *psUSESecondaryUploadTask);
 IMG_VOID USESecondaryUploadTaskDelRef(GLES2Context *gc, GLES2USESecondaryUploadTask *psUSESecondaryUploadTask);
@@ -638,6 +932,8 @@ IMG_VOID ShaderIndexableTempsMemAddRef(GLES2Context *gc, GLES2ShaderIndexableTem
 
 IMG_VOID ReclaimUSEShaderVariantMemKRM(IMG_VOID *pvContext, KRMResource *psResource);
 IMG_VOID DestroyUSECodeVariantGhostKRM(IMG_VOID *pvContext, KRMResource *psResource);
+IMG_VOID ReclaimPDSVertexVariantMemKRM(IMG_VOID *pvContext, KRMResource *psResource);
+IMG_VOID DestroyPDSVertexVariantGhostKRM(IMG_VOID *pvContext, KRMResource *psResource);
 
 
 
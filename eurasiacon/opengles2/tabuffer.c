@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Name         : tabuffer.c
+ *
+ * Copyright    : 2006-2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Resizing of the dynamic TA circular buffers
+ *
+ * Platform     : ANSI
+ *
+ * $Log: tabuffer.c $
+ *****************************************************************************/
+
+#include "context.h"
+
+
+/***********************************************************************************
+ Function Name      : ResizeTABuffer
+ Inputs             : gc, ui32BufferType, ui32SizeInBytes
+ Outputs            : -
+ Returns            : Success
+ Description        : Waits for the TA to finish with a dynamic TA buffer and replaces
+					  it with one of the requested size
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL ResizeTABuffer(GLES2Context *gc, IMG_UINT32 ui32BufferType, IMG_UINT32 ui32SizeInBytes)
+{
+	CircularBuffer *psBuffer, *psOldBuffer = gc->apsBuffers[ui32BufferType];
+	IMG_HANDLE hMemHeap;
+
+	/* The TA status update index only matches the buffer type for buffers before the unused auxiliary one */
+	GLES_ASSERT(ui32BufferType < CBUF_TYPE_PDS_AUXILIARY_PREGEN_BUFFER);
+
+	if(ui32BufferType == CBUF_TYPE_PDS_VERT_BUFFER)
+	{
+		hMemHeap = gc->psSysContext->hPDSVertexHeap;
+	}
+	else
+	{
+		hMemHeap = gc->psSysContext->hGeneralHeap;
+	}
+
+	if(ScheduleTA(gc, gc->psRenderSurface, GLES2_SCHEDULE_HW_WAIT_FOR_TA) != IMG_EGL_NO_ERROR)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"ResizeTABuffer: ScheduleTA did not work properly"));
+	}
+
+	psBuffer = CBUF_CreateBuffer(gc->ps3DDevData, 
+								ui32BufferType, 
+								hMemHeap, 
+								gc->psSysContext->hSyncInfoHeap, 
+								gc->psSysContext->sHWInfo.sMiscInfo.hOSGlobalEvent, 
+								ui32SizeInBytes,
+								gc->psSysContext->hPerProcRef);
+
+	if(!psBuffer)
+	{
+		PVR_DPF((PVR_DBG_ERROR,"ResizeTABuffer: Failed to create larger %s buffer", pszBufferNames[ui32BufferType]));
+
+		return IMG_FALSE;
+	}
+
+	PVR_DPF((PVR_DBG_WARNING,"ResizeTABuffer: Resized %s buffer. Was %u bytes, now %u bytes", 
+		pszBufferNames[ui32BufferType], psOldBuffer->ui32BufferLimitInBytes, psBuffer->ui32BufferLimitInBytes));
+
+#if defined(DEBUG) || defined(TIMING)
+	/* Keep the statistics across the resize */
+	psBuffer->ui32KickCount				= psOldBuffer->ui32KickCount;
+	psBuffer->ui32TotalStallCount		= psOldBuffer->ui32TotalStallCount;
+	psBuffer->ui32StallTimeInUs			= psOldBuffer->ui32StallTimeInUs;
+	psBuffer->ui32HighWaterMarkInBytes	= psOldBuffer->ui32HighWaterMarkInBytes;
+#endif /* defined(DEBUG) || defined(TIMING) */
+
+	CBUF_DestroyBuffer(gc->ps3DDevData, psOldBuffer);
+
+	gc->apsBuffers[ui32BufferType] = psBuffer;	
+
+	/* Point the TA Kick status update to the device memory reserved for status updates in the buffer */
+	gc->sKickTA.asTAStatusUpdate[ui32BufferType].hKernelMemInfo = psBuffer->psStatusUpdateMemInfo->hKernelMemInfo;
+	gc->sKickTA.asTAStatusUpdate[ui32BufferType].sCtlStatus.sStatusDevAddr.uiAddr = psBuffer->psStatusUpdateMemInfo->sDevVAddr.uiAddr;
+
+	/* set the read offset pointer in the buffer */
+	psBuffer->pui32ReadOffset = (IMG_UINT32*)psBuffer->psStatusUpdateMemInfo->pvLinAddr;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : GrowStalledTABuffers
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Called once per frame. Doubles, up to the apphint maximum, each
+					  dynamic TA buffer that stalled waiting for the hardware more
+					  often than BufferStallGrowThreshold during the frame.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID GrowStalledTABuffers(GLES2Context *gc)
+{
+	IMG_UINT32 i, ui32MaxSize;
+	CircularBuffer *psBuffer;
+
+	for(i = 0; i <= CBUF_TYPE_PDS_VERT_BUFFER; i++)
+	{
+		psBuffer = gc->apsBuffers[i];
+
+		if(!psBuffer)
+		{
+			continue;
+		}
+
+		if(!gc->sAppHints.ui32BufferStallGrowThreshold || 
+		   (psBuffer->ui32StallCount < gc->sAppHints.ui32BufferStallGrowThreshold))
+		{
+			psBuffer->ui32StallCount = 0;
+
+			continue;
+		}
+
+		psBuffer->ui32StallCount = 0;
+
+		switch(i)
+		{
+			case CBUF_TYPE_VDM_CTRL_BUFFER:
+			{
+				ui32MaxSize = gc->sAppHints.ui32MaxVDMBufferSize;
+
+				break;
+			}
+			case CBUF_TYPE_VERTEX_DATA_BUFFER:
+			{
+				ui32MaxSize = gc->sAppHints.ui32MaxVertexBufferSize;
+
+				break;
+			}
+			case CBUF_TYPE_INDEX_DATA_BUFFER:
+			{
+				ui32MaxSize = gc->sAppHints.ui32MaxIndexBufferSize;
+
+				break;
+			}
+			default:
+			{
+				ui32MaxSize = gc->sAppHints.ui32MaxPDSVertBufferSize;
+
+				break;
+			}
+		}
+
+		/* Only replace a buffer that has nothing left to be kicked */
+		if((psBuffer->ui32BufferLimitInBytes < ui32MaxSize) &&
+		   (psBuffer->ui32CurrentWriteOffsetInBytes == psBuffer->ui32CommittedHWOffsetInBytes))
+		{
+			ResizeTABuffer(gc, i, MIN(psBuffer->ui32BufferLimitInBytes * 2, ui32MaxSize));
+		}
+	}
+}
+
+
+/******************************************************************************
+ End of file (tabuffer.c)
+******************************************************************************/
@@ -2534,6 +2534,12 @@ bad_value:
 
 	GLES_ASSERT(psTex != NULL);
 
+	/* Sub-updates work on the application's format, undo driver ETC1 compression */
+	if(psTex->psAutoETC1Format && !TextureAutoETC1Demote(gc, psTex))
+	{
+		return IMG_NULL;
+	}
+
 	/* Get the format of the target texture level */
 	psTargetTexFormat = psTex->psMipLevel[ui32Level].psTexFormat;
 
@@ -2710,6 +2716,7 @@ GL_APICALL void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint inter
 	IMG_UINT32               ui32SrcBytesPerPixel;
 	const GLES2TextureFormat *psTexFormat;
 	GLES2MipMapLevel         *psMipLevel;
+	IMG_BOOL                 bAutoETC1;
 
 	__GLES2_GET_CONTEXT();
 
@@ -3485,8 +3492,12 @@ bad_op:
 	/* If the mipmap is attached to any framebuffer, notify it of the change */
 	FBOAttachableHasBeenModified(gc, (GLES2FrameBufferAttachable*)psMipLevel);
 
+	/* Eligible RGB levels may be stored as ETC1 (TexAutoETC1 apphint) */
+	bAutoETC1 = TextureAutoETC1Select(gc, psTex, ui32Level, psTexFormat, (IMG_UINT32)width, (IMG_UINT32)height, pixels);
+
 	/* Allocate memory for the level data */
-	pui8Dest = TextureCreateLevel(gc, psTex, ui32Level, (IMG_UINT32)format, psTexFormat, (IMG_UINT32)width, (IMG_UINT32)height);
+	pui8Dest = TextureCreateLevel(gc, psTex, ui32Level, (IMG_UINT32)format, bAutoETC1 ? &TexFormatETC1RGB : psTexFormat,
+								  (IMG_UINT32)width, (IMG_UINT32)height);
 
 
 	if(pixels && pui8Dest)
@@ -3504,8 +3515,16 @@ bad_op:
 
 		if ((height) && (width))
 		{
-			(*pfnCopyTextureData)(pvDest, pui8Src, (IMG_UINT32)width, (IMG_UINT32)height,
-					      ui32SrcRowSize, psMipLevel, IMG_FALSE);
+			if(bAutoETC1)
+			{
+				TextureAutoETC1Encode(gc, (IMG_UINT32 *)pvDest, pui8Src, ui32SrcBytesPerPixel,
+									  (IMG_UINT32)width, (IMG_UINT32)height, ui32SrcRowSize);
+			}
+			else
+			{
+				(*pfnCopyTextureData)(pvDest, pui8Src, (IMG_UINT32)width, (IMG_UINT32)height,
+						      ui32SrcRowSize, psMipLevel, IMG_FALSE);
+			}
 		}
 	}
 
@@ -4106,7 +4125,7 @@ bad_op:
 
 			TranslateLevel(gc, psTex, 0, 0);
 
-			GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+			TextureReleaseLevelBuffer(gc, psMipLevel);
 
 			psMipLevel->pui8Buffer = GLES2_LOADED_LEVEL;
 
@@ -4563,6 +4582,13 @@ GL_APICALL void GL_APIENTRY glCompressedTexImage2D(GLenum target, GLint level, G
 		return;
 	}
 
+	/* The level joins the texture as specified, undo driver ETC1 compression of the others */
+	if(psTex->psAutoETC1Format && !TextureAutoETC1Demote(gc, psTex))
+	{
+		GLES2_TIME_STOP(GLES2_TIMES_glCompressedTexImage2D);
+		return;
+	}
+
 #if defined(GLES2_EXTENSION_EGL_IMAGE)
 	if(psTex->psEGLImageSource)
 	{
@@ -4849,6 +4875,13 @@ GL_APICALL void GL_APIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum
 		return;
 	}
 
+	/* The level joins the texture as specified, undo driver ETC1 compression of the others */
+	if(psTex->psAutoETC1Format && !TextureAutoETC1Demote(gc, psTex))
+	{
+		GLES2_TIME_STOP(GLES2_TIMES_glCopyTexImage2D);
+		return;
+	}
+
 #if defined(GLES2_EXTENSION_REQUIRED_INTERNAL_FORMAT)
 
 	switch(internalformat)
@@ -6075,7 +6108,7 @@ bad_op:
 
 		TranslateLevel(gc, psTex, 0, 0);
 
-		GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+		TextureReleaseLevelBuffer(gc, psMipLevel);
 
 		psMipLevel->pui8Buffer = GLES2_LOADED_LEVEL;
 
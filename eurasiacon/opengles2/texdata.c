@@ -2557,7 +2557,8 @@ IMG_INTERNAL IMG_VOID TranslateLevel(GLES2Context *gc, GLES2Texture *psTex, IMG_
 	{
 		if (!gc->sAppHints.bDisableAsyncTextureOp)
 		{
-			if (psMipLevel->ui32Width >= 128 && psMipLevel->ui32Height >= 128)
+			if (psMipLevel->ui32Width >= gc->sAppHints.ui32SwTexOpMinDimension && 
+				psMipLevel->ui32Height >= gc->sAppHints.ui32SwTexOpMinDimension)
 			{
 				SWTextureUpload(gc, psTex, psMipLevel, ui32OffsetInBytes, psTexFmt, ui32Face, ui32Lod, ui32TopUsize, ui32TopVsize);
 			}
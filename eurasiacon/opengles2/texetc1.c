@@ -0,0 +1,449 @@
+/******************************************************************************
+ * Name         : texetc1.c
+ *
+ * Copyright    : 2005-2011 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * Description	: Driver side ETC1 compression of uncompressed RGB textures
+ *				  (TexAutoETC1 apphint).
+ *
+ *				  Eligible RGB888/RGB565 levels are encoded to ETC1 when they
+ *				  are specified and are then stored, twiddled and sampled like
+ *				  application supplied ETC1 data. Such levels keep GL_RGB as
+ *				  their requested format, which is how they are told apart
+ *				  from GL_ETC1_RGB8_OES levels. Anything that needs the texels
+ *				  in their original format (sub-updates, copies, rendering,
+ *				  EGL images) first decodes the texture back to that format
+ *				  and stops it from being compressed again.
+ *
+ * Modifications:-
+ * $Log: texetc1.c $
+ *****************************************************************************/
+
+#include "context.h"
+#include "psp2/swtexop.h"
+
+
+/***********************************************************************************
+ Function Name      : IsAutoETC1Level
+ Inputs             : psMipLevel
+ Outputs            : -
+ Returns            : Whether the level holds driver compressed ETC1 data
+ Description        : UTILITY: Application ETC1 levels request GL_ETC1_RGB8_OES,
+					  driver compressed ones keep the uncompressed request.
+************************************************************************************/
+static IMG_BOOL IsAutoETC1Level(const GLES2MipMapLevel *psMipLevel)
+{
+	return (psMipLevel->pui8Buffer &&
+			(psMipLevel->psTexFormat == &TexFormatETC1RGB) &&
+			(psMipLevel->eRequestedFormat != GL_ETC1_RGB8_OES)) ? IMG_TRUE : IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetAutoETC1LevelBlocks
+ Inputs             : gc, psTex, ui32Level
+ Outputs            : -
+ Returns            : A copy of the level's ETC1 blocks, or IMG_NULL
+ Description        : UTILITY: Copies the blocks of a driver compressed level
+					  from its host buffer, or reads them back from device
+					  memory if the level has been loaded. Free with GLES2Free.
+************************************************************************************/
+static IMG_UINT32 *GetAutoETC1LevelBlocks(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32Level)
+{
+	GLES2MipMapLevel *psMipLevel = &psTex->psMipLevel[ui32Level];
+	IMG_UINT32 ui32Size = ALIGNCOUNTINBLOCKS(psMipLevel->ui32Width, 2) * ALIGNCOUNTINBLOCKS(psMipLevel->ui32Height, 2) * 8;
+	IMG_UINT32 *pui32Blocks = GLES2Malloc(gc, ui32Size);
+
+	if(!pui32Blocks)
+	{
+		return IMG_NULL;
+	}
+
+	if(psMipLevel->pui8Buffer == GLES2_LOADED_LEVEL)
+	{
+		ReadBackTextureData(gc, psTex, ui32Level / GLES2_MAX_TEXTURE_MIPMAP_LEVELS,
+							ui32Level % GLES2_MAX_TEXTURE_MIPMAP_LEVELS, pui32Blocks);
+	}
+	else
+	{
+		GLES2MemCopy(pui32Blocks, psMipLevel->pui8Buffer, ui32Size);
+	}
+
+	return pui32Blocks;
+}
+
+
+/***********************************************************************************
+ Function Name      : TextureAutoETC1Encode
+ Inputs             : gc, pui8Src, ui32SrcBytesPerPixel, ui32Width, ui32Height,
+					  ui32SrcStrideInBytes
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : UTILITY: Encodes an RGB image to ETC1. Levels of at least
+					  SwTexOpMinDimension are split across the SW texture op
+					  threads.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID TextureAutoETC1Encode(GLES2Context *gc, IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src,
+											IMG_UINT32 ui32SrcBytesPerPixel, IMG_UINT32 ui32Width,
+											IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes)
+{
+	if((ui32Width >= gc->sAppHints.ui32SwTexOpMinDimension) &&
+	   (ui32Height >= gc->sAppHints.ui32SwTexOpMinDimension))
+	{
+		SWEncodeETC1(gc, pui32Dest, pui8Src, ui32SrcBytesPerPixel, ui32Width, ui32Height, ui32SrcStrideInBytes);
+	}
+	else
+	{
+		EncodeETC1Blocks(pui32Dest, pui8Src, ui32SrcBytesPerPixel, ui32Width, ui32Height, ui32SrcStrideInBytes,
+						 0, ALIGNCOUNTINBLOCKS(ui32Height, 2));
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : TextureAutoETC1Select
+ Inputs             : gc, psTex, ui32Level, psTexFormat, ui32Width, ui32Height,
+					  pvPixels
+ Outputs            : -
+ Returns            : Whether glTexImage2D should store this level as ETC1
+ Description        : UTILITY: Decides whether a level being specified is
+					  compressed by the driver. A texture is compressed when its
+					  first RGB888/RGB565 base level is power of two, at least
+					  TexAutoETC1MinDimension in both directions and nothing else
+					  has been specified yet; later levels follow if they have
+					  the same format. Re-specifying a compressed level, or
+					  specifying one that cannot be compressed, decodes the
+					  texture and stops it from being compressed again.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL TextureAutoETC1Select(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32Level,
+											const GLES2TextureFormat *psTexFormat, IMG_UINT32 ui32Width,
+											IMG_UINT32 ui32Height, const IMG_VOID *pvPixels)
+{
+	IMG_UINT32 ui32NumLevels, i;
+	IMG_BOOL bCompress = IMG_TRUE;
+
+	if(!gc->sAppHints.bTexAutoETC1)
+	{
+		return IMG_FALSE;
+	}
+
+	if(!pvPixels || psTex->bAutoETC1Disabled || psTex->ui32NumRenderTargets ||
+	   ((psTexFormat != &TexFormatXBGR8888) && (psTexFormat != &TexFormatRGB565)) ||
+	   (ui32Width & (ui32Width - 1)) || (ui32Height & (ui32Height - 1)))
+	{
+		bCompress = IMG_FALSE;
+	}
+
+#if defined(GLES2_EXTENSION_EGL_IMAGE)
+	if(psTex->psEGLImageSource || psTex->psEGLImageTarget)
+	{
+		bCompress = IMG_FALSE;
+	}
+#endif /* defined(GLES2_EXTENSION_EGL_IMAGE) */
+
+	/* Replacing compressed data means the texture is being updated */
+	if(IsAutoETC1Level(&psTex->psMipLevel[ui32Level]))
+	{
+		bCompress = IMG_FALSE;
+	}
+
+	if(bCompress)
+	{
+		if(psTex->psAutoETC1Format)
+		{
+			/* Every level with data is compressed, further levels must match them */
+			bCompress = (psTex->psAutoETC1Format == psTexFormat) ? IMG_TRUE : IMG_FALSE;
+		}
+		else if((ui32Level % GLES2_MAX_TEXTURE_MIPMAP_LEVELS) != 0 ||
+				ui32Width < gc->sAppHints.ui32TexAutoETC1MinDimension ||
+				ui32Height < gc->sAppHints.ui32TexAutoETC1MinDimension)
+		{
+			bCompress = IMG_FALSE;
+		}
+		else
+		{
+			ui32NumLevels = GLES2_MAX_TEXTURE_MIPMAP_LEVELS;
+
+			if(psTex->ui32TextureTarget == GLES2_TEXTURE_TARGET_CEM)
+			{
+				ui32NumLevels *= GLES2_TEXTURE_CEM_FACE_MAX;
+			}
+
+			/* Only start on a texture without uncompressed data */
+			for(i = 0; i < ui32NumLevels; i++)
+			{
+				if(psTex->psMipLevel[i].pui8Buffer)
+				{
+					bCompress = IMG_FALSE;
+
+					break;
+				}
+			}
+		}
+	}
+
+	if(!bCompress)
+	{
+		if(psTex->psAutoETC1Format)
+		{
+			TextureAutoETC1Demote(gc, psTex);
+		}
+
+		return IMG_FALSE;
+	}
+
+	psTex->psAutoETC1Format = psTexFormat;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : TextureAutoETC1Demote
+ Inputs             : gc, psTex
+ Outputs            : -
+ Returns            : IMG_FALSE if out of memory
+ Description        : UTILITY: Decodes every driver compressed level of a texture
+					  back to the format the application specified and stops the
+					  texture from being compressed again. Called before the
+					  texels are updated in place, copied, rendered to or shared.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL TextureAutoETC1Demote(GLES2Context *gc, GLES2Texture *psTex)
+{
+	IMG_UINT32 *apui32Blocks[GLES2_MAX_TEXTURE_MIPMAP_LEVELS * GLES2_TEXTURE_CEM_FACE_MAX];
+	const GLES2TextureFormat *psTexFormat = psTex->psAutoETC1Format;
+	IMG_UINT32 ui32NumLevels, i;
+	IMG_BOOL bResult = IMG_TRUE;
+
+	psTex->bAutoETC1Disabled = IMG_TRUE;
+
+	if(!psTexFormat)
+	{
+		return IMG_TRUE;
+	}
+
+	ui32NumLevels = GLES2_MAX_TEXTURE_MIPMAP_LEVELS;
+
+	if(psTex->ui32TextureTarget == GLES2_TEXTURE_TARGET_CEM)
+	{
+		ui32NumLevels *= GLES2_TEXTURE_CEM_FACE_MAX;
+	}
+
+	/* Fetch every level before any is re-created, readback needs the current layout */
+	for(i = 0; i < ui32NumLevels; i++)
+	{
+		apui32Blocks[i] = IMG_NULL;
+
+		if(IsAutoETC1Level(&psTex->psMipLevel[i]))
+		{
+			apui32Blocks[i] = GetAutoETC1LevelBlocks(gc, psTex, i);
+
+			if(!apui32Blocks[i])
+			{
+				bResult = IMG_FALSE;
+			}
+		}
+	}
+
+	for(i = 0; i < ui32NumLevels; i++)
+	{
+		GLES2MipMapLevel *psMipLevel = &psTex->psMipLevel[i];
+		IMG_UINT8 *pui8Dest;
+
+		if(!apui32Blocks[i])
+		{
+			continue;
+		}
+
+		if(bResult)
+		{
+			pui8Dest = TextureCreateLevel(gc, psTex, i, psMipLevel->eRequestedFormat, psTexFormat,
+										  psMipLevel->ui32Width, psMipLevel->ui32Height);
+
+			if(pui8Dest)
+			{
+				DecodeETC1Blocks(apui32Blocks[i], pui8Dest, psTexFormat->ui32TotalBytesPerTexel,
+								 psMipLevel->ui32Width, psMipLevel->ui32Height);
+			}
+			else
+			{
+				bResult = IMG_FALSE;
+			}
+		}
+
+		GLES2Free(gc, apui32Blocks[i]);
+	}
+
+	if(!bResult)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "TextureAutoETC1Demote: Out of memory decoding texture"));
+
+		SetError(gc, GL_OUT_OF_MEMORY);
+
+		return IMG_FALSE;
+	}
+
+	psTex->psAutoETC1Format = IMG_NULL;
+
+	TextureRemoveResident(gc, psTex);
+
+	gc->ui32DirtyState |= GLES2_DIRTYFLAG_TEXTURE_STATE;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HalveRGBX8888
+ Inputs             : pui8Src, ui32Width, ui32Height
+ Outputs            : pui8Dest
+ Returns            : -
+ Description        : UTILITY: 2x2 box filters a power of two RGBX image.
+************************************************************************************/
+static IMG_VOID HalveRGBX8888(const IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT8 *pui8Dest)
+{
+	IMG_UINT32 ui32DstWidth = MAX(ui32Width >> 1, 1);
+	IMG_UINT32 ui32DstHeight = MAX(ui32Height >> 1, 1);
+	IMG_UINT32 ui32XStep = (ui32Width > 1) ? 4 : 0;
+	IMG_UINT32 ui32YStep = (ui32Height > 1) ? ui32Width * 4 : 0;
+	IMG_UINT32 x, y, c;
+
+	for(y = 0; y < ui32DstHeight; y++)
+	{
+		const IMG_UINT8 *pui8Row = pui8Src + (y * 2 * ui32Width * 4);
+
+		for(x = 0; x < ui32DstWidth; x++)
+		{
+			const IMG_UINT8 *pui8Pixel = pui8Row + x * 8;
+
+			for(c = 0; c < 3; c++)
+			{
+				pui8Dest[c] = (IMG_UINT8)((pui8Pixel[c] + pui8Pixel[c + ui32XStep] +
+										   pui8Pixel[c + ui32YStep] + pui8Pixel[c + ui32XStep + ui32YStep] + 2) >> 2);
+			}
+
+			pui8Dest[3] = 0xFF;
+
+			pui8Dest += 4;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : TextureAutoETC1MakeMipmaps
+ Inputs             : gc, psTex, ui32MaxFace
+ Outputs            : -
+ Returns            : Success
+ Description        : UTILITY: glGenerateMipmap for a driver compressed texture.
+					  The base level is decoded once per face, then each level is
+					  filtered from the previous uncompressed level and encoded,
+					  so errors do not accumulate down the chain.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL TextureAutoETC1MakeMipmaps(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32MaxFace)
+{
+	IMG_UINT32 ui32Face, ui32Lod = 0;
+
+	for(ui32Face = 0; ui32Face < ui32MaxFace; ui32Face++)
+	{
+		IMG_UINT32 ui32BaseLevel = ui32Face * GLES2_MAX_TEXTURE_MIPMAP_LEVELS;
+		GLES2MipMapLevel *psBaseLevel = &psTex->psMipLevel[ui32BaseLevel];
+		IMG_UINT32 ui32Width = psBaseLevel->ui32Width, ui32Height = psBaseLevel->ui32Height;
+		IMG_UINT32 *pui32Blocks;
+		IMG_UINT8 *pui8Src, *pui8Dst, *pui8Swap;
+
+		if(!IsAutoETC1Level(psBaseLevel))
+		{
+			continue;
+		}
+
+		pui32Blocks = GetAutoETC1LevelBlocks(gc, psTex, ui32BaseLevel);
+		pui8Src = GLES2Malloc(gc, ui32Width * ui32Height * 4);
+		pui8Dst = GLES2Malloc(gc, MAX(ui32Width >> 1, 1) * MAX(ui32Height >> 1, 1) * 4);
+
+		if(!pui32Blocks || !pui8Src || !pui8Dst)
+		{
+			goto no_memory;
+		}
+
+		DecodeETC1Blocks(pui32Blocks, pui8Src, 4, ui32Width, ui32Height);
+
+		GLES2Free(gc, pui32Blocks);
+		pui32Blocks = IMG_NULL;
+
+		for(ui32Lod = 1; ui32Lod < GLES2_MAX_TEXTURE_MIPMAP_LEVELS; ui32Lod++)
+		{
+			IMG_UINT8 *pui8Dest;
+
+			HalveRGBX8888(pui8Src, ui32Width, ui32Height, pui8Dst);
+
+			ui32Width = MAX(ui32Width >> 1, 1);
+			ui32Height = MAX(ui32Height >> 1, 1);
+
+			pui8Dest = TextureCreateLevel(gc, psTex, ui32BaseLevel + ui32Lod, psBaseLevel->eRequestedFormat,
+										  &TexFormatETC1RGB, ui32Width, ui32Height);
+
+			if(!pui8Dest)
+			{
+				goto no_memory;
+			}
+
+			TextureAutoETC1Encode(gc, (IMG_UINT32 *)pui8Dest, pui8Dst, 4, ui32Width, ui32Height, ui32Width * 4);
+
+			/* The filtered level is the source of the next one */
+			pui8Swap = pui8Src;
+			pui8Src = pui8Dst;
+			pui8Dst = pui8Swap;
+
+			if(ui32Width == 1 && ui32Height == 1)
+			{
+				break;
+			}
+		}
+
+		GLES2Free(gc, pui8Src);
+		GLES2Free(gc, pui8Dst);
+
+		continue;
+
+no_memory:
+		if(pui32Blocks)
+		{
+			GLES2Free(gc, pui32Blocks);
+		}
+		if(pui8Src)
+		{
+			GLES2Free(gc, pui8Src);
+		}
+		if(pui8Dst)
+		{
+			GLES2Free(gc, pui8Dst);
+		}
+
+		SetError(gc, GL_OUT_OF_MEMORY);
+
+		return IMG_FALSE;
+	}
+
+	TextureRemoveResident(gc, psTex);
+
+	/* Update NumLevels to reflect the mipmaps that have been just created */
+	psTex->ui32NumLevels = ui32Lod + 1;
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ End of file (texetc1.c)
+******************************************************************************/
@@ -20,6 +20,7 @@
 #include <kernel.h>
 
 #include "context.h"
+#include "psp2/swtexop.h"
 
 #if (defined(DEBUG) || defined(TIMING))
 IMG_INTERNAL IMG_UINT32 ui32TextureMemCurrent = 0;
@@ -966,6 +967,30 @@ IMG_INTERNAL IMG_VOID  TextureRemoveResident(GLES2Context *gc, GLES2Texture *psT
 }
 
 
+/***********************************************************************************
+ Function Name      : TextureReleaseLevelBuffer
+ Inputs             : gc, psMipLevel
+ Outputs            : psMipLevel
+ Returns            : -
+ Description        : UTILITY: Releases the host copy of a texture level once any
+					  pending upload from it has finished. Pooled buffers are
+					  recycled, others are freed. The caller updates pui8Buffer.
+************************************************************************************/
+IMG_INTERNAL IMG_VOID TextureReleaseLevelBuffer(GLES2Context *gc, GLES2MipMapLevel *psMipLevel)
+{
+	if (psMipLevel->ui32StagingClass)
+	{
+		texOpStagingRelease(gc, psMipLevel->pui8Buffer, psMipLevel->ui32StagingClass);
+	}
+	else
+	{
+		GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+	}
+
+	psMipLevel->ui32StagingClass = 0;
+}
+
+
 #if defined PDUMP
 /***********************************************************************************
  Function Name      : PDumpTexture
@@ -1280,7 +1305,7 @@ IMG_INTERNAL IMG_BOOL TextureMakeResident(GLES2Context *gc, GLES2Texture *psTex)
 #if (defined(DEBUG) || defined(TIMING))
 					ui32TextureMemCurrent -= psMipLevel->ui32ImageSize;
 #endif
-					GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+					TextureReleaseLevelBuffer(gc, psMipLevel);
 
 					psMipLevel->pui8Buffer = GLES2_LOADED_LEVEL;
 				}
@@ -1976,8 +2001,7 @@ IMG_INTERNAL IMG_BOOL TextureCreateImageLevel(GLES2Context *gc, GLES2Texture *ps
 		/* The texture level is being freed */
 		if (psMipLevel->pui8Buffer != NULL && psMipLevel->pui8Buffer != GLES2_LOADED_LEVEL)
 		{
-			PVR_UNREFERENCED_PARAMETER(gc);
-			GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+			TextureReleaseLevelBuffer(gc, psMipLevel);
 		}
 
 		psMipLevel->pui8Buffer		 = IMG_NULL;
@@ -1992,6 +2016,9 @@ IMG_INTERNAL IMG_BOOL TextureCreateImageLevel(GLES2Context *gc, GLES2Texture *ps
 		psMipLevel->psTex            = psTex;
 	}
 
+	/* The image replaces any driver compressed levels */
+	psTex->psAutoETC1Format = IMG_NULL;
+
 	psMipLevel = &psTex->psMipLevel[0];
 
 	psEGLImage = psTex->psEGLImageTarget;
@@ -2371,7 +2398,7 @@ IMG_INTERNAL IMG_UINT8*  TextureCreateLevel(GLES2Context *gc, GLES2Texture *psTe
 											IMG_UINT32 ui32Width, IMG_UINT32 ui32Height)
 {
 	IMG_UINT8 *pui8Buffer;
-	IMG_UINT32 ui32BufferSize, ui32BufferWidth, ui32BufferHeight;
+	IMG_UINT32 ui32BufferSize, ui32BufferWidth, ui32BufferHeight, ui32StagingClass;
 	GLES2MipMapLevel *psMipLevel = &psTex->psMipLevel[ui32Level];
 	IMG_BOOL bUseCachedMemory = IMG_FALSE;
 
@@ -2436,10 +2463,36 @@ IMG_INTERNAL IMG_UINT8*  TextureCreateLevel(GLES2Context *gc, GLES2Texture *psTe
 		{
 			if (!bUseCachedMemory)
 			{
-				pui8Buffer = (IMG_UINT8 *)GLES2ReallocHeapUNC(gc, psMipLevel->pui8Buffer, ui32BufferSize);
+				if (psMipLevel->ui32StagingClass &&
+					(ui32BufferSize <= GLES2_STAGING_CLASS_SIZE(psMipLevel->ui32StagingClass)))
+				{
+					/* The pooled buffer is already big enough, the contents are replaced anyway */
+					pui8Buffer = psMipLevel->pui8Buffer;
+				}
+				else
+				{
+					pui8Buffer = (IMG_UINT8 *)texOpStagingAlloc(gc, ui32BufferSize, &ui32StagingClass);
+
+					if (pui8Buffer)
+					{
+						if (psMipLevel->pui8Buffer)
+						{
+							TextureReleaseLevelBuffer(gc, psMipLevel);
+						}
+
+						psMipLevel->ui32StagingClass = ui32StagingClass;
+					}
+				}
 			}
 			else
 			{
+				if (psMipLevel->ui32StagingClass)
+				{
+					TextureReleaseLevelBuffer(gc, psMipLevel);
+
+					psMipLevel->pui8Buffer = IMG_NULL;
+				}
+
 				pui8Buffer = (IMG_UINT8 *)GLES2Realloc(gc, psMipLevel->pui8Buffer, ui32BufferSize);
 			}
 
@@ -2465,11 +2518,12 @@ no_memory:
 		{
 			if (!bUseCachedMemory)
 			{
-				pui8Buffer = (IMG_UINT8 *)GLES2MallocHeapUNC(gc, ui32BufferSize);
+				pui8Buffer = (IMG_UINT8 *)texOpStagingAlloc(gc, ui32BufferSize, &ui32StagingClass);
 			}
 			else
 			{
 				pui8Buffer = (IMG_UINT8 *)GLES2Malloc(gc, ui32BufferSize);
+				ui32StagingClass = 0;
 			}
 
 			if (pui8Buffer == IMG_NULL) 
@@ -2478,6 +2532,7 @@ no_memory:
 			}
 
 			psMipLevel->pui8Buffer = pui8Buffer;
+			psMipLevel->ui32StagingClass = ui32StagingClass;
 
 #if (defined(DEBUG) || defined(TIMING))
 			ui32TextureMemCurrent += ui32BufferSize;
@@ -2526,7 +2581,7 @@ no_memory:
 #if (defined(DEBUG) || defined(TIMING))
 			ui32TextureMemCurrent -= psMipLevel->ui32ImageSize;
 #endif
-			GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+			TextureReleaseLevelBuffer(gc, psMipLevel);
 		}
 		psMipLevel->pui8Buffer = IMG_NULL;
 
@@ -2688,7 +2743,7 @@ static IMG_VOID FreeTexture(GLES2Context *gc, GLES2Texture *psTex)
 #if (defined(DEBUG) || defined(TIMING))
 			ui32TextureMemCurrent -= psMipLevel->ui32ImageSize;
 #endif
-			GLES2FreeAsync(gc, psMipLevel->pui8Buffer);
+			TextureReleaseLevelBuffer(gc, psMipLevel);
 			psMipLevel->pui8Buffer = IMG_NULL;
 		}
 	}
@@ -0,0 +1,270 @@
+/******************************************************************************
+ * Name         : texstaging.c
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Per-context pool of host staging buffers for texture levels
+ *
+ * Platform     : ANSI
+ *
+ * $Log: texstaging.c $
+ *****************************************************************************/
+
+#include "context.h"
+#include "psp2/swtexop.h"
+
+
+/***********************************************************************************
+ Function Name      : texOpStagingPoolInit
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Sets up the context's texture staging pool. The pool stays
+					  disabled if TexStagingPoolSize is 0 or no lock can be created.
+************************************************************************************/
+IMG_VOID texOpStagingPoolInit(GLES2Context *gc)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+
+	GLES2MemSet(psPool, 0, sizeof(GLES2StagingPool));
+
+	if (!gc->sAppHints.ui32TexStagingPoolSize)
+	{
+		return;
+	}
+
+	/* Without a lock the pool stays disabled and levels use the heap directly */
+	if (PVRSRVCreateMutex(&psPool->hLock) != PVRSRV_OK)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "texOpStagingPoolInit: couldn't create pool lock, staging pool disabled"));
+
+		psPool->hLock = IMG_NULL;
+	}
+}
+
+/***********************************************************************************
+ Function Name      : texOpStagingDrainFree
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Frees every buffer held for reuse. The caller holds the pool lock.
+************************************************************************************/
+static IMG_VOID texOpStagingDrainFree(GLES2Context *gc)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+	IMG_UINT32 i;
+
+	for (i = 0; i < GLES2_STAGING_NUM_CLASSES; i++)
+	{
+		while (psPool->aui32NumFree[i])
+		{
+			GLES2Free(gc, psPool->apvFree[i][--psPool->aui32NumFree[i]]);
+		}
+	}
+
+	psPool->ui32BytesHeld = 0;
+}
+
+/***********************************************************************************
+ Function Name      : texOpStagingPoolDeinit
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Frees all pending and cached buffers and the pool lock.
+************************************************************************************/
+IMG_VOID texOpStagingPoolDeinit(GLES2Context *gc)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+	IMG_UINT32 i;
+
+	if (!psPool->hLock)
+	{
+		return;
+	}
+
+	if (psPool->ui32NumPending)
+	{
+		SGXWaitTransfer(gc->ps3DDevData, gc->psSysContext->hTransferContext);
+
+		for (i = 0; i < psPool->ui32NumPending; i++)
+		{
+			GLES2Free(gc, psPool->apvPending[i]);
+		}
+
+		psPool->ui32NumPending = 0;
+	}
+
+	texOpStagingDrainFree(gc);
+
+	PVRSRVDestroyMutex(psPool->hLock);
+	psPool->hLock = IMG_NULL;
+}
+
+/***********************************************************************************
+ Function Name      : texOpStagingAlloc
+ Inputs             : gc, ui32Size
+ Outputs            : pui32Class
+ Returns            : Staging buffer of at least ui32Size bytes, or NULL
+ Description        : Gets a level staging buffer from the pool, or the UNC heap if
+					  none of the right class is free. *pui32Class is the size class
+					  to hand back to texOpStagingRelease, or 0 if not pooled.
+************************************************************************************/
+IMG_PVOID texOpStagingAlloc(GLES2Context *gc, IMG_UINT32 ui32Size, IMG_UINT32 *pui32Class)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+	IMG_UINT32 ui32Class = 1;
+	IMG_PVOID pvPtr = IMG_NULL;
+
+	while (ui32Class <= GLES2_STAGING_NUM_CLASSES && GLES2_STAGING_CLASS_SIZE(ui32Class) < ui32Size)
+	{
+		ui32Class++;
+	}
+
+	if (!psPool->hLock || ui32Class > GLES2_STAGING_NUM_CLASSES)
+	{
+		*pui32Class = 0;
+
+		return GLES2MallocHeapUNC(gc, ui32Size);
+	}
+
+	PVRSRVLockMutex(psPool->hLock);
+
+	if (psPool->aui32NumFree[ui32Class - 1])
+	{
+		pvPtr = psPool->apvFree[ui32Class - 1][--psPool->aui32NumFree[ui32Class - 1]];
+		psPool->ui32BytesHeld -= GLES2_STAGING_CLASS_SIZE(ui32Class);
+	}
+
+	PVRSRVUnlockMutex(psPool->hLock);
+
+	if (!pvPtr)
+	{
+		pvPtr = GLES2MallocHeapUNC(gc, GLES2_STAGING_CLASS_SIZE(ui32Class));
+
+		if (!pvPtr)
+		{
+			/* Give the cached buffers back to the heap and try once more */
+			PVRSRVLockMutex(psPool->hLock);
+			texOpStagingDrainFree(gc);
+			PVRSRVUnlockMutex(psPool->hLock);
+
+			pvPtr = GLES2MallocHeapUNC(gc, GLES2_STAGING_CLASS_SIZE(ui32Class));
+		}
+	}
+
+	*pui32Class = pvPtr ? ui32Class : 0;
+
+	return pvPtr;
+}
+
+/***********************************************************************************
+ Function Name      : texOpStagingRelease
+ Inputs             : gc, pvPtr, ui32Class
+ Outputs            : -
+ Returns            : -
+ Description        : Queues a staging buffer for reuse once any upload still reading
+					  from it has finished. Unpooled buffers go to async cleanup.
+************************************************************************************/
+IMG_VOID texOpStagingRelease(GLES2Context *gc, IMG_PVOID pvPtr, IMG_UINT32 ui32Class)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+
+	if (!ui32Class || !psPool->hLock)
+	{
+		texOpAsyncAddForCleanup(gc, pvPtr);
+
+		return;
+	}
+
+	/* An upload may still be reading the buffer, the cleanup thread recycles it once idle */
+	PVRSRVLockMutex(psPool->hLock);
+
+	if (psPool->ui32NumPending < GLES2_STAGING_MAX_PENDING)
+	{
+		psPool->apvPending[psPool->ui32NumPending] = pvPtr;
+		psPool->aui32PendingClass[psPool->ui32NumPending] = ui32Class;
+		psPool->ui32NumPending++;
+
+		pvPtr = IMG_NULL;
+	}
+
+	PVRSRVUnlockMutex(psPool->hLock);
+
+	if (pvPtr)
+	{
+		texOpAsyncAddForCleanup(gc, pvPtr);
+	}
+}
+
+/***********************************************************************************
+ Function Name      : texOpStagingRetirePending
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Called from the cleanup thread. Once no SW upload is running and
+					  the transfer queue is idle, moves released buffers to the free
+					  lists, or frees them if the pool is full.
+************************************************************************************/
+IMG_VOID texOpStagingRetirePending(GLES2Context *gc)
+{
+	GLES2StagingPool *psPool = &gc->sStagingPool;
+	IMG_UINT32 i, ui32NumPending, ui32Class;
+
+	if (!psPool->hLock || !psPool->ui32NumPending)
+	{
+		return;
+	}
+
+	/* Only buffers released before the idle check below are known to be unused */
+	PVRSRVLockMutex(psPool->hLock);
+	ui32NumPending = psPool->ui32NumPending;
+	PVRSRVUnlockMutex(psPool->hLock);
+
+	if (gc->ui32AsyncTexOpNum)
+	{
+		return;
+	}
+
+	SGXWaitTransfer(gc->ps3DDevData, gc->psSysContext->hTransferContext);
+
+	PVRSRVLockMutex(psPool->hLock);
+
+	for (i = 0; i < ui32NumPending; i++)
+	{
+		ui32Class = psPool->aui32PendingClass[i];
+
+		if ((psPool->aui32NumFree[ui32Class - 1] < GLES2_STAGING_CLASS_DEPTH) &&
+			(psPool->ui32BytesHeld + GLES2_STAGING_CLASS_SIZE(ui32Class) <= gc->sAppHints.ui32TexStagingPoolSize))
+		{
+			psPool->apvFree[ui32Class - 1][psPool->aui32NumFree[ui32Class - 1]++] = psPool->apvPending[i];
+			psPool->ui32BytesHeld += GLES2_STAGING_CLASS_SIZE(ui32Class);
+		}
+		else
+		{
+			GLES2Free(gc, psPool->apvPending[i]);
+		}
+	}
+
+	psPool->ui32NumPending -= ui32NumPending;
+
+	for (i = 0; i < psPool->ui32NumPending; i++)
+	{
+		psPool->apvPending[i] = psPool->apvPending[ui32NumPending + i];
+		psPool->aui32PendingClass[i] = psPool->aui32PendingClass[ui32NumPending + i];
+	}
+
+	PVRSRVUnlockMutex(psPool->hLock);
+}
+
+/******************************************************************************
+ End of file (texstaging.c)
+******************************************************************************/
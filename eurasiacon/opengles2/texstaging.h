@@ -0,0 +1,52 @@
+/******************************************************************************
+ * Name         : texstaging.h
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Platform     : ANSI
+ *
+ * $Log: texstaging.h $
+ *****************************************************************************/
+
+#ifndef _TEXSTAGING_
+#define _TEXSTAGING_
+
+/*
+ * Recycled host staging memory for texture levels. Buffers are grouped in
+ * power of two size classes; class N (1-based) holds buffers of
+ * 1 << (N - 1 + GLES2_STAGING_MIN_CLASS_LOG2) bytes.
+ */
+#define GLES2_STAGING_MIN_CLASS_LOG2	8
+#define GLES2_STAGING_MAX_CLASS_LOG2	22
+#define GLES2_STAGING_NUM_CLASSES		(GLES2_STAGING_MAX_CLASS_LOG2 - GLES2_STAGING_MIN_CLASS_LOG2 + 1)
+#define GLES2_STAGING_CLASS_DEPTH		8
+#define GLES2_STAGING_MAX_PENDING		256
+
+#define GLES2_STAGING_CLASS_SIZE(ui32Class)	(1U << ((ui32Class) - 1 + GLES2_STAGING_MIN_CLASS_LOG2))
+
+typedef struct GLES2StagingPoolRec
+{
+	PVRSRV_MUTEX_HANDLE hLock;
+
+	/* Buffers ready for reuse, per size class */
+	IMG_VOID   *apvFree[GLES2_STAGING_NUM_CLASSES][GLES2_STAGING_CLASS_DEPTH];
+	IMG_UINT32 aui32NumFree[GLES2_STAGING_NUM_CLASSES];
+	IMG_UINT32 ui32BytesHeld;
+
+	/* Released buffers which may still be read by a pending upload */
+	IMG_VOID   *apvPending[GLES2_STAGING_MAX_PENDING];
+	IMG_UINT32 aui32PendingClass[GLES2_STAGING_MAX_PENDING];
+	IMG_UINT32 ui32NumPending;
+
+} GLES2StagingPool;
+
+#endif /* _TEXSTAGING_ */
@@ -104,6 +104,9 @@ typedef struct GLES2MipMapLevelRec
 	/* The level of this mipmap in the parent texture             */
 	IMG_UINT32                 ui32Level;
 
+	/* Staging pool size class of pui8Buffer, 0 if not pooled      */
+	IMG_UINT32                 ui32StagingClass;
+
 } GLES2MipMapLevel;
 
 
@@ -203,6 +206,12 @@ typedef struct GLES2TextureRec
 
 	PVRSRV_CLIENT_MEM_INFO   *psMemInfo;
 
+	/* Uncompressed format of the levels the driver stored as ETC1, NULL if none */
+	const GLES2TextureFormat *psAutoETC1Format;
+
+	/* Set once the texture is updated in place or rendered to, never compress it again */
+	IMG_BOOL                  bAutoETC1Disabled;
+
 	IMG_VOID (*pfnReadBackData)(IMG_VOID *pvDest, const IMG_VOID *pvSrc,
 								IMG_UINT32 ui32Log2Width, IMG_UINT32 ui32Log2Height,
 								IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, 
@@ -341,6 +350,7 @@ IMG_VOID ReadBackTiledData(IMG_VOID *pvDest, const IMG_VOID *pvSrc,
 						   IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, 
 						   const GLES2Texture *psTex);
 IMG_VOID TextureRemoveResident(GLES2Context *gc, GLES2Texture *psTex);
+IMG_VOID TextureReleaseLevelBuffer(GLES2Context *gc, GLES2MipMapLevel *psMipLevel);
 typedef IMG_VOID (*PFNReadSpan)(const GLES2PixelSpanInfo *);
 
 IMG_BOOL TextureMakeResident(GLES2Context *gc, GLES2Texture *psTex);
@@ -355,6 +365,8 @@ IMG_BOOL ClipReadPixels(GLES2PixelSpanInfo *psSpanInfo, EGLDrawableParams *psRea
 
 IMG_VOID *GetStridedSurfaceData(GLES2Context *gc, EGLDrawableParams *psReadParams, GLES2PixelSpanInfo *psSpanInfo);
 
+IMG_UINT32 BytesPerPixel(PVRSRV_PIXEL_FORMAT ePixelFormat);
+
 
 IMG_VOID SetupTexNameArray(GLES2NamesArray *psNamesArray);
 IMG_VOID SetupTwiddleFns(GLES2Texture *psTex);
@@ -392,6 +404,20 @@ IMG_VOID ReleaseImageFromTexture(GLES2Context *gc, GLES2Texture *psTex);
 
 IMG_BOOL CreateTextureMemory(GLES2Context *gc, GLES2Texture *psTex);
 
+IMG_BOOL TextureAutoETC1Select(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32Level,
+							   const GLES2TextureFormat *psTexFormat, IMG_UINT32 ui32Width,
+							   IMG_UINT32 ui32Height, const IMG_VOID *pvPixels);
+IMG_BOOL TextureAutoETC1Demote(GLES2Context *gc, GLES2Texture *psTex);
+IMG_VOID TextureAutoETC1Encode(GLES2Context *gc, IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src,
+							   IMG_UINT32 ui32SrcBytesPerPixel, IMG_UINT32 ui32Width,
+							   IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes);
+IMG_BOOL TextureAutoETC1MakeMipmaps(GLES2Context *gc, GLES2Texture *psTex, IMG_UINT32 ui32MaxFace);
+IMG_VOID EncodeETC1Blocks(IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+						  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes,
+						  IMG_UINT32 ui32FirstBlockRow, IMG_UINT32 ui32NumBlockRows);
+IMG_VOID DecodeETC1Blocks(const IMG_UINT32 *pui32Src, IMG_UINT8 *pui8Dest, IMG_UINT32 ui32DstBytesPerPixel,
+						  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height);
+
 
 IMG_BOOL UnloadInconsistentTexture(GLES2Context *gc, GLES2Texture *psTex);
 
@@ -519,6 +519,8 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 	IMG_INT32 i32Loadcount;
 	IMG_UINT32 ui32Compstart, ui32Compcount;
 	IMG_INT32 i32Component;
+	IMG_FLOAT fValue;
+	IMG_BOOL bChanged;
 	IMG_BOOL bIsBool = (IMG_BOOL)(
 					   (psUniform->eTypeSpecifier == GLSLTS_BOOL)  || (psUniform->eTypeSpecifier == GLSLTS_BVEC2) ||
 	                   (psUniform->eTypeSpecifier == GLSLTS_BVEC3) || (psUniform->eTypeSpecifier == GLSLTS_BVEC4));
@@ -538,6 +540,8 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 
 		pfData = GetConstantDataPtr(psProgram->sVertex.pfConstantData, psSymbol, psUniform, i32Location);
 		
+		bChanged = IMG_FALSE;
+
 		/* Update the data */
 		for(i = 0; i < i32Loadcount; i++)
 		{
@@ -555,13 +559,21 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 					*/
 					if(bIsBool)
 					{
-						*pfDst = (*pfSrc)? 1.0f : 0.0f;
+						fValue = (*pfSrc)? 1.0f : 0.0f;
 					}
 					else
 					{
-						*pfDst = *pfSrc;
+						fValue = *pfSrc;
+					}
+
+					/* Compare bit patterns, so a change in the sign of zero is seen */
+					if(memcmp(pfDst, &fValue, sizeof(IMG_FLOAT)) != 0)
+					{
+						bChanged = IMG_TRUE;
 					}
 
+					*pfDst = fValue;
+
 					pfSrc++;
 
 					i32Component++;
@@ -582,6 +594,13 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 		/* Update start and end points */
 		UpdateConstantRange(psSymbol, &psProgram->sVertex.sUniformCopyRange, ui32Compstart, ui32Compstart +  ui32Compcount);
 
+#if defined(SUPPORT_SOURCE_SHADER)
+		if(bChanged && psProgram->sVertex.psSpecialisation)
+		{
+			NoteUniformSpecialisationChange(gc, &psProgram->sVertex, ui32Compstart, ui32Compcount);
+		}
+#endif
+
 		gc->ui32DirtyState |= GLES2_DIRTYFLAG_VERTPROG_CONSTANTS;
 	}
 
@@ -600,6 +619,8 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 
 		pfData = GetConstantDataPtr(psProgram->sFragment.pfConstantData, psSymbol, psUniform, i32Location);
 
+		bChanged = IMG_FALSE;
+
 		/* Update the data */
 		for(i = 0; i < i32Loadcount; i++)
 		{
@@ -617,13 +638,21 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 					*/
 					if(bIsBool)
 					{
-						*pfDst = (*pfSrc)? 1.0f : 0.0f;
+						fValue = (*pfSrc)? 1.0f : 0.0f;
 					}
 					else
 					{
-						*pfDst = *pfSrc;
+						fValue = *pfSrc;
+					}
+
+					/* Compare bit patterns, so a change in the sign of zero is seen */
+					if(memcmp(pfDst, &fValue, sizeof(IMG_FLOAT)) != 0)
+					{
+						bChanged = IMG_TRUE;
 					}
 
+					*pfDst = fValue;
+
 					pfSrc++;
 					i32Component++;
 
@@ -643,6 +672,13 @@ static IMG_VOID SaveUniformDataFloat(GLES2Context *gc, GLES2Program *psProgram,
 		/* Update start and end points */
 		UpdateConstantRange(psSymbol, &psProgram->sFragment.sUniformCopyRange, ui32Compstart, ui32Compstart +  ui32Compcount);
 
+#if defined(SUPPORT_SOURCE_SHADER)
+		if(bChanged && psProgram->sFragment.psSpecialisation)
+		{
+			NoteUniformSpecialisationChange(gc, &psProgram->sFragment, ui32Compstart, ui32Compcount);
+		}
+#endif
+
 		gc->ui32DirtyState |= GLES2_DIRTYFLAG_FRAGPROG_CONSTANTS;
 	}
 }
@@ -667,6 +703,8 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 	IMG_INT32 i32Loadcount;
 	IMG_UINT32 ui32Compstart, ui32Compcount;
 	IMG_INT32 i32Component;
+	IMG_FLOAT fValue;
+	IMG_BOOL bChanged;
 	IMG_BOOL bIsBool = (IMG_BOOL)(
 					   (psUniform->eTypeSpecifier == GLSLTS_BOOL)  || (psUniform->eTypeSpecifier == GLSLTS_BVEC2) ||
 	                   (psUniform->eTypeSpecifier == GLSLTS_BVEC3) || (psUniform->eTypeSpecifier == GLSLTS_BVEC4));
@@ -709,6 +747,8 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 		{
 			pfData = GetConstantDataPtr(psProgram->sVertex.pfConstantData, psSymbol, psUniform, i32Location);
 
+			bChanged = IMG_FALSE;
+
 			/* Update the data */
 			for(i = 0; i < i32Loadcount; i++)
 			{
@@ -726,13 +766,21 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 						*/
 						if(bIsBool)
 						{
-							*pfDst = (*pi32Src)? 1.0f : 0.0f;
+							fValue = (*pi32Src)? 1.0f : 0.0f;
 						}
 						else
 						{
-							*pfDst = (GLfloat)(*pi32Src);
+							fValue = (GLfloat)(*pi32Src);
+						}
+
+						/* Compare bit patterns, so a change in the sign of zero is seen */
+						if(memcmp(pfDst, &fValue, sizeof(IMG_FLOAT)) != 0)
+						{
+							bChanged = IMG_TRUE;
 						}
 
+						*pfDst = fValue;
+
 						pi32Src++;
 						i32Component++;
 
@@ -752,6 +800,13 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 			/* Update start and end points */
 			UpdateConstantRange(psSymbol, &psProgram->sVertex.sUniformCopyRange,
 								ui32Compstart, ui32Compstart +  ui32Compcount);
+
+#if defined(SUPPORT_SOURCE_SHADER)
+			if(bChanged && psProgram->sVertex.psSpecialisation)
+			{
+				NoteUniformSpecialisationChange(gc, &psProgram->sVertex, ui32Compstart, ui32Compcount);
+			}
+#endif
 		}
 
 		gc->ui32DirtyState |= GLES2_DIRTYFLAG_VERTPROG_CONSTANTS;
@@ -796,6 +851,8 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 		{
 			pfData = GetConstantDataPtr(psProgram->sFragment.pfConstantData, psSymbol, psUniform, i32Location);
 
+			bChanged = IMG_FALSE;
+
 			/* Update the data */
 			for(i = 0; i < i32Loadcount; i++)
 			{
@@ -813,13 +870,21 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 						*/
 						if(bIsBool)
 						{
-							*pfDst = (*pi32Src)? 1.0f : 0.0f;
+							fValue = (*pi32Src)? 1.0f : 0.0f;
 						}
 						else
 						{
-							*pfDst = (GLfloat)(*pi32Src);
+							fValue = (GLfloat)(*pi32Src);
+						}
+
+						/* Compare bit patterns, so a change in the sign of zero is seen */
+						if(memcmp(pfDst, &fValue, sizeof(IMG_FLOAT)) != 0)
+						{
+							bChanged = IMG_TRUE;
 						}
 
+						*pfDst = fValue;
+
 						pi32Src++;
 						i32Component++;
 
@@ -840,6 +905,13 @@ static IMG_VOID SaveUniformDataInteger(GLES2Context *gc, GLES2Program *psProgram
 			UpdateConstantRange(psSymbol, &psProgram->sFragment.sUniformCopyRange, 
 				ui32Compstart, ui32Compstart +  ui32Compcount);
 
+#if defined(SUPPORT_SOURCE_SHADER)
+			if(bChanged && psProgram->sFragment.psSpecialisation)
+			{
+				NoteUniformSpecialisationChange(gc, &psProgram->sFragment, ui32Compstart, ui32Compcount);
+			}
+#endif
+
 			gc->ui32DirtyState |= GLES2_DIRTYFLAG_FRAGPROG_CONSTANTS;
 		}
 	}
@@ -1821,6 +1821,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbP
 	IMG_UINT32 ui32ImageUnitEnables = psVertexTextureState->ui32ImageUnitEnables;
 	IMG_UINT16 i;
 	GLES2_MEMERROR eError = GLES2_NO_ERROR;
+	GLES2ShaderPrewarmKey sKey;
 #if defined(SGX_FEATURE_VCB)
 	IMG_UINT32 ui32NextPhaseMode, ui32NextPhaseAddress;
 #endif
@@ -1895,13 +1896,20 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbP
 
 		psVertexVariant->psProgramShader = psVertexShader;
 
+		GLES2MemSet(&sKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+		sKey.ui8Flags = GLES2_PREWARM_KEY_FLAG_VERTEX;
+
 		/* Add 1 instruction (PHAS) space at the beginning of uProgStartInstIdx (UniPatchShader) */
 #if defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
-		PVRUniPatchSetPreambleInstCount(gc->sProgram.pvUniPatchContext, 1);
+		sKey.ui8PreambleCount = 1;
+#else
+		sKey.ui8Flags |= GLES2_PREWARM_KEY_FLAG_KEEP_PREAMBLE;
 #endif
 
 		/* Setup state to for variant */
 		psVertexVariant->u.sVertex.ui32ImageUnitEnables = ui32ImageUnitEnables;
+		sKey.ui32ImageUnitEnables = ui32ImageUnitEnables;
 
 		if(ui32ImageUnitEnables)
 		{
@@ -1910,18 +1918,12 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbP
 				if(ui32ImageUnitEnables & (1U << i))
 				{
 					psVertexVariant->u.sVertex.apsTexFormat[i] = psVertexTextureState->apsTexFormat[i];
-					
-					PVRUniPatchSetTextureFormat(gc->sProgram.pvUniPatchContext,
-												i,
-												(USP_TEX_FORMAT *)((IMG_UINTPTR_T)(&psVertexTextureState->apsTexFormat[i]->sTexFormat)),
-												IMG_FALSE,
-												IMG_FALSE);
+					sKey.apsTexFormat[i] = psVertexTextureState->apsTexFormat[i];
 				}
 			}
 		}
 
-		psPatchedShader = PVRUniPatchFinaliseShader(gc->sProgram.pvUniPatchContext, 
-													psVertexShader->psSharedState->pvUniPatchShader);
+		psPatchedShader = FinaliseUSEShader(gc, GLES2_SHADER_CODE_STATE(psVertexShader), &sKey, &psVertexVariant->bPrewarmedShader);
 		
 		if(!psPatchedShader)
 		{
@@ -1934,18 +1936,18 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbP
 		/* Create the secondary code block as necessary */
 		if(psPatchedShader->uSAUpdateInstCount)
 		{
-			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, psVertexShader->psSharedState, IMG_TRUE);
+			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, GLES2_SHADER_CODE_STATE(psVertexShader), IMG_TRUE);
 
 			if(eError != GLES2_NO_ERROR)
 			{
-				PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+				DestroyFinalisedUSEShader(gc, psPatchedShader, psVertexVariant->bPrewarmedShader);
 				GLES2Free(IMG_NULL, psVertexVariant);
 				return eError;
 			}
 		}
 
 		psVertexVariant->psPatchedShader = psPatchedShader;
-		psVertexVariant->psSecondaryUploadTask = psVertexShader->psSharedState->psSecondaryUploadTask;
+		psVertexVariant->psSecondaryUploadTask = GLES2_SHADER_CODE_STATE(psVertexShader)->psSecondaryUploadTask;
 
 		/* Add 1 instruction for EMITVTX */
 		ui32CodeSizeInBytes = (psPatchedShader->uInstCount + 1) * EURASIA_USE_INSTRUCTION_SIZE;
@@ -1969,7 +1971,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbP
 		if(eError != GLES2_NO_ERROR)
 		{
 			USESecondaryUploadTaskDelRef(gc, psVertexVariant->psSecondaryUploadTask);
-			PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+			DestroyFinalisedUSEShader(gc, psPatchedShader, psVertexVariant->bPrewarmedShader);
 			GLES2Free(IMG_NULL, psVertexVariant);
 			return eError;
 		}
@@ -2498,6 +2500,63 @@ static IMG_VOID SetupIteratorsAndTextureLookups(GLES2Context *gc,
  *
  ****************************************************************************************/
 
+/****************************************************************
+ * Function Name  	: SetupFragmentPrewarmKey
+ * Returns        	: -
+ * Outputs			: psKey
+ * Globals Used    	: 
+ * Description    	: Fills in the output location and preamble a fragment
+ *					  variant is finalised with for the current blend and
+ *					  colormask state. The caller sets the texture formats.
+ ****************************************************************/
+IMG_INTERNAL IMG_VOID SetupFragmentPrewarmKey(GLES2Context *gc, IMG_UINT32 ui32AlphaTestFlags,
+											  IMG_BOOL bReadOnlyPAs, GLES2ShaderPrewarmKey *psKey)
+{
+	IMG_UINT32 ui32PreambleCount = 0;
+	IMG_BOOL bExtraCode = IMG_FALSE;
+
+	if((gc->ui32Enables & GLES2_ALPHABLEND_ENABLE) && gc->sState.sRaster.ui32BlendEquation)
+	{
+		bExtraCode = IMG_TRUE;
+	}
+
+	if(gc->sState.sRaster.ui32ColorMask && (gc->sState.sRaster.ui32ColorMask != GLES2_COLORMASK_ALL))
+	{
+		bExtraCode = IMG_TRUE;
+	}
+
+	PVR_UNREFERENCED_PARAMETER(bReadOnlyPAs);
+
+	/* Add 1 instruction (PHAS) space at the beginning of uProgStartInstIdx (UniPatchShader) */
+	ui32PreambleCount++;
+	
+#if !defined(SGX_FEATURE_ALPHATEST_AUTO_COEFF)
+	if(ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)
+	{
+		/* Add instruction (pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
+		ui32PreambleCount++;
+	}
+#endif
+
+#if defined(FIX_HW_BRN_29019)
+	if((ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)==0)
+	{
+		/* Blending or colormasking in a separate phase on MSAA surfaces */
+		if(gc->psMode->ui32AntiAliasMode && bExtraCode)
+		{
+			/* Add instruction (MOV) space at the beginning of uProgStartInstIdx (UniPatchShader) */
+			ui32PreambleCount++;
+		}
+	}
+#endif /* defined(FIX_HW_BRN_29019) */
+
+	/* If we are going to add on any code, don't bother patching */
+	psKey->ui8OutputLocation = (IMG_UINT8)(bExtraCode ? USP_OUTPUT_REGTYPE_DEFAULT : USP_OUTPUT_REGTYPE_OUTPUT);
+	psKey->ui8PreambleCount = (IMG_UINT8)ui32PreambleCount;
+	psKey->ui8Flags = 0;
+}
+
+
 /****************************************************************
  * Function Name  	: SetupUSEFragmentShader
  * Returns        	: Error code
@@ -2530,6 +2589,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 	IMG_UINT16 i;
 	IMG_UINT32 ui32PreambleCount = 0;
 	GLES2_MEMERROR eError = GLES2_NO_ERROR;
+	GLES2ShaderPrewarmKey sKey;
 	IMG_UINT32 ui32ExeAddr, ui32NextPhaseMode;
 	IMG_UINT32 ui32IncrementalCodeSizeInUSEInsts;
 #if defined(DEBUG)
@@ -2612,6 +2672,10 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		psFragmentVariant->u.sFragment.bSeparateBlendPhase = bSeparateBlendPhase; 
 		psFragmentVariant->u.sFragment.ui32ImageUnitEnables = ui32ImageUnitEnables;
 
+		GLES2MemSet(&sKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+		sKey.ui32ImageUnitEnables = ui32ImageUnitEnables;
+
 		if(ui32ImageUnitEnables)
 		{
 			for(i=0; i < GLES2_MAX_TEXTURE_UNITS; i++)
@@ -2619,53 +2683,16 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 				if(ui32ImageUnitEnables & (1 << i))
 				{
 					psFragmentVariant->u.sFragment.apsTexFormat[i] = psFragmentTextureState->apsTexFormat[i];
-					
-					PVRUniPatchSetTextureFormat(gc->sProgram.pvUniPatchContext,
-												i,
-												(USP_TEX_FORMAT *)&psFragmentTextureState->apsTexFormat[i]->sTexFormat,
-												IMG_FALSE,
-												IMG_FALSE);
+					sKey.apsTexFormat[i] = psFragmentTextureState->apsTexFormat[i];
 				}
 			}
 		}
 
-		/* Add 1 instruction (PHAS) space at the beginning of uProgStartInstIdx (UniPatchShader) */
-		ui32PreambleCount++;
-	
-#if !defined(SGX_FEATURE_ALPHATEST_AUTO_COEFF)
-		if(psRenderState->ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)
-		{
-			/* Add instruction (pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
-			ui32PreambleCount++;
-		}
-#endif
-
-#if defined(FIX_HW_BRN_29019)
-		if((psRenderState->ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)==0)
-		{
-			if(bSeparateBlendPhase)
-			{
-				/* Add instruction (MOV) space at the beginning of uProgStartInstIdx (UniPatchShader) */
-				ui32PreambleCount++;
-			}
-		}
-#endif /* defined(FIX_HW_BRN_29019) */
-
+		SetupFragmentPrewarmKey(gc, psRenderState->ui32AlphaTestFlags, IMG_FALSE, &sKey);
 
-		/* If we are going to add on any code, don't bother patching */
-		if(ui32BlendEquation || bColorMaskCode)
-		{
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_DEFAULT);
-		}
-		else
-		{
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_OUTPUT);
-		}
+		ui32PreambleCount = sKey.ui8PreambleCount;
 
-		PVRUniPatchSetPreambleInstCount(gc->sProgram.pvUniPatchContext, ui32PreambleCount);
-
-		psPatchedShader = PVRUniPatchFinaliseShader(gc->sProgram.pvUniPatchContext, 
-													psFragmentShader->psSharedState->pvUniPatchShader);
+		psPatchedShader = FinaliseUSEShader(gc, GLES2_SHADER_CODE_STATE(psFragmentShader), &sKey, &psFragmentVariant->bPrewarmedShader);
 
 		if(!psPatchedShader)
 		{
@@ -2678,11 +2705,11 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		/* Create the secondary code block as necessary */
 		if(psPatchedShader->uSAUpdateInstCount)
 		{
-			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, psFragmentShader->psSharedState, IMG_FALSE);
+			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, GLES2_SHADER_CODE_STATE(psFragmentShader), IMG_FALSE);
 
 			if(eError != GLES2_NO_ERROR)
 			{
-				PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+				DestroyFinalisedUSEShader(gc, psPatchedShader, psFragmentVariant->bPrewarmedShader);
 				GLES2Free(IMG_NULL, psFragmentVariant);
 				return eError;
 			}
@@ -2691,7 +2718,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		psFragmentVariant->psPatchedShader = psPatchedShader;
 		psFragmentVariant->psProgramShader = psFragmentShader;
 		psFragmentVariant->ui32USEPrimAttribCount = psPatchedShader->uPARegCount;
-		psFragmentVariant->psSecondaryUploadTask = psFragmentShader->psSharedState->psSecondaryUploadTask;
+		psFragmentVariant->psSecondaryUploadTask = GLES2_SHADER_CODE_STATE(psFragmentShader)->psSecondaryUploadTask;
 
 		/* Set current variant */
 		gc->sProgram.psCurrentFragmentVariant = psFragmentVariant;
@@ -2800,7 +2827,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 			{
 				gc->sProgram.psCurrentFragmentVariant = IMG_NULL;
 				USESecondaryUploadTaskDelRef(gc, psFragmentVariant->psSecondaryUploadTask);
-				PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+				DestroyFinalisedUSEShader(gc, psPatchedShader, psFragmentVariant->bPrewarmedShader);
 				GLES2Free(IMG_NULL, psFragmentVariant);
 				return GLES2_3D_USECODE_ERROR;
 			}
@@ -3285,6 +3312,65 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
  *
  ****************************************************************************************/
 
+/****************************************************************
+ * Function Name  	: SetupFragmentPrewarmKey
+ * Returns        	: -
+ * Outputs			: psKey
+ * Globals Used    	: 
+ * Description    	: Fills in the output location and preamble a fragment
+ *					  variant is finalised with for the current blend and
+ *					  colormask state. The caller sets the texture formats.
+ ****************************************************************/
+IMG_INTERNAL IMG_VOID SetupFragmentPrewarmKey(GLES2Context *gc, IMG_UINT32 ui32AlphaTestFlags,
+											  IMG_BOOL bReadOnlyPAs, GLES2ShaderPrewarmKey *psKey)
+{
+	IMG_UINT32 ui32PreambleCount = 0;
+	IMG_BOOL bExtraCode = IMG_FALSE;
+
+	if((gc->ui32Enables & GLES2_ALPHABLEND_ENABLE) && gc->sState.sRaster.ui32BlendEquation)
+	{
+		bExtraCode = IMG_TRUE;
+	}
+
+	if(gc->sState.sRaster.ui32ColorMask && (gc->sState.sRaster.ui32ColorMask != GLES2_COLORMASK_ALL))
+	{
+		bExtraCode = IMG_TRUE;
+	}
+
+	if(ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)
+	{
+#if defined(SGX_FEATURE_ALPHATEST_COEFREORDER)
+		/* Add instruction (pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
+		ui32PreambleCount++;
+#else
+		/* Add 2 instruction (smlsi/nop + pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
+		ui32PreambleCount += 2;
+#endif
+	}
+
+#if defined(FIX_HW_BRN_25077)
+	if(ui32AlphaTestFlags & GLES2_ALPHA_TEST_BRN25077)
+	{
+		/* Don't set dest to output as we will have a second phase */
+		bExtraCode = IMG_TRUE;
+
+#if defined(SGX_FEATURE_ALPHATEST_COEFREORDER)
+		/* Add space for pcoeff and atst8 */
+		ui32PreambleCount = 2;
+#else
+		/* Add space for smlsi/nop, pcoeff and atst8 */
+		ui32PreambleCount = 3;
+#endif
+	}
+#endif
+
+	/* If we are going to add on any code, don't bother patching */
+	psKey->ui8OutputLocation = (IMG_UINT8)(bExtraCode ? USP_OUTPUT_REGTYPE_DEFAULT : USP_OUTPUT_REGTYPE_OUTPUT);
+	psKey->ui8PreambleCount = (IMG_UINT8)ui32PreambleCount;
+	psKey->ui8Flags = (IMG_UINT8)(bReadOnlyPAs ? GLES2_PREWARM_KEY_FLAG_MSAATRANS : 0);
+}
+
+
 /****************************************************************
  * Function Name  	: SetupUSEFragmentShader
  * Returns        	: Error code
@@ -3315,6 +3401,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 	IMG_BOOL bReadOnlyPAs = IMG_FALSE;
 	IMG_UINT32 ui32PreambleCount = 0;
 	GLES2_MEMERROR eError;
+	GLES2ShaderPrewarmKey sKey;
 	IMG_UINT32 ui32IncrementalCodeSizeInUSEInsts;
 #if defined(DEBUG)
 	IMG_BOOL bNewShader = IMG_FALSE;
@@ -3404,6 +3491,10 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		psFragmentVariant->u.sFragment.ui32AlphaTestFlags = psRenderState->ui32AlphaTestFlags;
 #endif
 
+		GLES2MemSet(&sKey, 0, sizeof(GLES2ShaderPrewarmKey));
+
+		sKey.ui32ImageUnitEnables = ui32ImageUnitEnables;
+
 		if(ui32ImageUnitEnables)
 		{
 			for(i=0; i < GLES2_MAX_TEXTURE_UNITS; i++)
@@ -3411,67 +3502,17 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 				if(ui32ImageUnitEnables & (1U << i))
 				{
 					psFragmentVariant->u.sFragment.apsTexFormat[i] = psFragmentTextureState->apsTexFormat[i];
-					
-					PVRUniPatchSetTextureFormat(gc->sProgram.pvUniPatchContext,
-												i,
-												(USP_TEX_FORMAT *)((IMG_UINTPTR_T)(&psFragmentTextureState->apsTexFormat[i]->sTexFormat)),
-												IMG_FALSE,
-												IMG_FALSE);
+					sKey.apsTexFormat[i] = psFragmentTextureState->apsTexFormat[i];
 				}
 			}
 		}
 
-		if(psRenderState->ui32AlphaTestFlags & GLES2_ALPHA_TEST_DISCARD)
-		{
-#if defined(SGX_FEATURE_ALPHATEST_COEFREORDER)
-			/* Add instruction (pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
-			ui32PreambleCount++;
-#else
-			/* Add 2 instruction (smlsi/nop + pcoeff) space at the beginning of uProgStartInstIdx (UniPatchShader) */
-			ui32PreambleCount += 2;
-#endif
-		}
-
-#if defined(FIX_HW_BRN_25077)
-		if(psRenderState->ui32AlphaTestFlags & GLES2_ALPHA_TEST_BRN25077)
-		{
-#if defined(SGX_FEATURE_ALPHATEST_COEFREORDER)
-			/* Add space for pcoeff and atst8, and don't set dest to output as we will have a second phase */
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_DEFAULT);
-			
-			ui32PreambleCount = 2;
-#else
-			/* Add space for smlsi/nop, pcoeff and atst8, and don't set dest to output as we will have a second phase */
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_DEFAULT);
-			
-			ui32PreambleCount = 3;
-#endif
-		}
-		else
-#endif
-		/* If we are going to add on any code, don't bother patching */
-		if(ui32BlendEquation || bColorMaskCode)
-		{
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_DEFAULT);
-		}
-		else
-		{
-			PVRUniPatchSetOutputLocation(gc->sProgram.pvUniPatchContext, USP_OUTPUT_REGTYPE_OUTPUT);
-		}
+		/* Uses the MSAA version (ie read only PAs) if this object is translucent or translucent pt */
+		SetupFragmentPrewarmKey(gc, psRenderState->ui32AlphaTestFlags, bReadOnlyPAs, &sKey);
 
-		PVRUniPatchSetPreambleInstCount(gc->sProgram.pvUniPatchContext, ui32PreambleCount);
+		ui32PreambleCount = sKey.ui8PreambleCount;
 
-		/* Use MSAA version (ie read only PAs) if this object is translucent or translucent pt */
-		if(bReadOnlyPAs)
-		{
-			psPatchedShader = PVRUniPatchFinaliseShader(gc->sProgram.pvUniPatchContext, 
-													psFragmentShader->psSharedState->pvUniPatchShaderMSAATrans);
-		}
-		else
-		{
-			psPatchedShader = PVRUniPatchFinaliseShader(gc->sProgram.pvUniPatchContext, 
-													psFragmentShader->psSharedState->pvUniPatchShader);
-		}
+		psPatchedShader = FinaliseUSEShader(gc, GLES2_SHADER_CODE_STATE(psFragmentShader), &sKey, &psFragmentVariant->bPrewarmedShader);
 
 		if(!psPatchedShader)
 		{
@@ -3484,11 +3525,11 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		/* Create the secondary code block as necessary */
 		if(psPatchedShader->uSAUpdateInstCount)
 		{
-			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, psFragmentShader->psSharedState, IMG_FALSE);
+			eError = SetupUSESecondaryUploadTask(gc, psPatchedShader, GLES2_SHADER_CODE_STATE(psFragmentShader), IMG_FALSE);
 
 			if(eError != GLES2_NO_ERROR)
 			{
-				PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+				DestroyFinalisedUSEShader(gc, psPatchedShader, psFragmentVariant->bPrewarmedShader);
 				GLES2Free(IMG_NULL, psFragmentVariant);
 				return eError;
 			}
@@ -3497,7 +3538,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 		psFragmentVariant->psPatchedShader = psPatchedShader;
 		psFragmentVariant->psProgramShader = psFragmentShader;
 		psFragmentVariant->ui32USEPrimAttribCount = psPatchedShader->uPARegCount;
-		psFragmentVariant->psSecondaryUploadTask = psFragmentShader->psSharedState->psSecondaryUploadTask;
+		psFragmentVariant->psSecondaryUploadTask = GLES2_SHADER_CODE_STATE(psFragmentShader)->psSecondaryUploadTask;
 
 		/* Set current variant */
 		gc->sProgram.psCurrentFragmentVariant = psFragmentVariant;
@@ -3599,7 +3640,7 @@ IMG_INTERNAL GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *p
 			{
 				gc->sProgram.psCurrentFragmentVariant = IMG_NULL;
 				USESecondaryUploadTaskDelRef(gc, psFragmentVariant->psSecondaryUploadTask);
-				PVRUniPatchDestroyHWShader(gc->sProgram.pvUniPatchContext, psPatchedShader);
+				DestroyFinalisedUSEShader(gc, psPatchedShader, psFragmentVariant->bPrewarmedShader);
 				GLES2Free(IMG_NULL, psFragmentVariant);
 				return GLES2_3D_USECODE_ERROR;
 			}
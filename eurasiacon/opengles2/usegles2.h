@@ -37,7 +37,7 @@
 
 #define GLES2_VISIBILITYTEST_NUM_PHASE1_INSTRUCTIONS	1
 
-/* Important! Changes to these values should be reflected in oglcompiler/esbincompiler.c */
+/* Important! Changes to these values should be reflected in host/esbincompiler/main.c */
 #define GLES2_FRAGMENT_SECATTR_CONSTANTBASE				0x00000000
 #define GLES2_FRAGMENT_SECATTR_INDEXABLETEMPBASE		0x00000001
 #define GLES2_FRAGMENT_SECATTR_FBBLENDCONST				0x00000002
@@ -112,6 +112,7 @@
 /*****************************************************************************/
 GLES2_MEMERROR SetupUSEVertexShader(GLES2Context *gc, IMG_BOOL *pbProgramChanged);
 GLES2_MEMERROR SetupUSEFragmentShader(GLES2Context *gc, IMG_BOOL *pbProgramChanged);
+IMG_VOID SetupFragmentPrewarmKey(GLES2Context *gc, IMG_UINT32 ui32AlphaTestFlags, IMG_BOOL bReadOnlyPAs, GLES2ShaderPrewarmKey *psKey);
 
 IMG_BOOL InitSpecialUSECodeBlocks(GLES2Context *gc);
 IMG_VOID FreeSpecialUSECodeBlocks(GLES2Context *gc);
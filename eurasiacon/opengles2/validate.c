@@ -1409,6 +1409,7 @@ static GLES2_MEMERROR WritePDSVertexShaderProgramWithVAO(GLES2Context *gc, IMG_B
 	GLES2VertexArrayObject    *psVAO = gc->sVAOMachine.psActiveVAO;
 	GLES2PDSVertexState       *psPDSVertexState;
 	PDS_VERTEX_SHADER_PROGRAM *psPDSVertexShaderProgram;
+	GLES2PDSVertexCodeVariant *psPDSVertexVariant = IMG_NULL;
 
     IMG_BOOL bDirty = (gc->ui32DirtyState & ( GLES2_DIRTYFLAG_VP_STATE           |
 											  GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER |
@@ -1618,9 +1619,28 @@ static GLES2_MEMERROR WritePDSVertexShaderProgramWithVAO(GLES2Context *gc, IMG_B
 
 			  PDS vertex shader program has to be generated.
 			*/
+			IMG_BOOL   bCacheable = IMG_TRUE;
+			IMG_UINT32 *pui32HashCompare = gc->sProgram.aui32VertexHashCompare;
+			IMG_UINT32 ui32HashCompareSizeInDWords = 0;
+			HashValue  tPDSVariantHash = 0;
 
 		    GLES2_TIME_START(GLES2_TIMER_GENERATE_PDS_VERTEX_SHADER_PROGRAM_VAO_TIME);
 
+			/* Only programs that read nothing but buffer objects are cached. Client arrays and current
+			   state are copied into the circular buffer, so their addresses change on every draw.
+			*/
+			for (i = 0; i < psVAOMachine->ui32NumItemsPerVertex; i++)
+			{
+				GLES2AttribArrayPointerMachine *psVAOAttribPointer = psVAOMachine->apsPackedAttrib[i];
+
+				if (!psVAOAttribPointer->psState->psBufObj || psVAOAttribPointer->bIsCurrentState)
+				{
+					bCacheable = IMG_FALSE;
+
+					break;
+				}
+			}
+
 			/* Setup the input program structure */
 			psPDSVertexShaderProgram->pui32DataSegment   = IMG_NULL;
 			psPDSVertexShaderProgram->ui32DataSize       = 0;
@@ -1851,12 +1871,131 @@ static GLES2_MEMERROR WritePDSVertexShaderProgramWithVAO(GLES2Context *gc, IMG_B
 				}
 			}
 
-			/* Generate the PDS Program for this shader */
-			pui32Buffer = (IMG_UINT32 *)PDSGenerateVertexShaderProgram(psPDSVertexShaderProgram, 
-																	   psPDSVertexState->aui32LastPDSProgram,
-																	   &(psPDSVertexState->sProgramInfo));
+			if (bCacheable)
+			{
+				/* Build the hash key from the program inputs */
+				for (i = 0; i < PDS_NUM_USE_TASK_CONTROL_WORDS; i++)
+				{
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexShaderProgram->aui32USETaskControl[i];
+				}
+
+				pui32HashCompare[ui32HashCompareSizeInDWords++] = (IMG_UINT32)b32BitIndices;
+				pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexShaderProgram->ui32NumStreams;
+
+				for (i = 0; i < psPDSVertexShaderProgram->ui32NumStreams; i++)
+				{
+					PDS_VERTEX_STREAM *psPDSVertexStream = &(psPDSVertexShaderProgram->asStreams[i]);
+
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexStream->ui32Address;
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexStream->ui32Stride;
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexStream->ui32Shift;
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexStream->asElements[0].ui32Size;
+					pui32HashCompare[ui32HashCompareSizeInDWords++] = psPDSVertexStream->asElements[0].ui32Register;
+				}
+
+				tPDSVariantHash = HashFunc(pui32HashCompare, ui32HashCompareSizeInDWords, STATEHASH_INIT_VALUE);
+
+				/* Search hash table to see if we have already stored this program */
+				if (HashTableSearch(gc,
+									&gc->sProgram.sPDSVertexVariantHashTable, tPDSVariantHash,
+									pui32HashCompare, ui32HashCompareSizeInDWords,
+									(IMG_UINT32 *)&psPDSVertexVariant))
+				{
+					/* Restore the program and its patching information, so that later pointer-only 
+					   changes to this VAO can still be patched */
+					psPDSVertexState->ui32ProgramSize = psPDSVertexVariant->ui32ProgramSize;
+					psPDSVertexShaderProgram->ui32DataSize = psPDSVertexVariant->ui32DataSize;
+
+					GLES2MemCopy(&(psPDSVertexState->sProgramInfo), 
+								 &(psPDSVertexVariant->sProgramInfo), 
+								 sizeof(PDS_VERTEX_SHADER_PROGRAM_INFO));
+
+					GLES2MemCopy(psPDSVertexState->aui32LastPDSProgram, 
+								 psPDSVertexVariant->psCodeBlock->pui32LinAddress, 
+								 psPDSVertexVariant->ui32ProgramSize << 2);
+
+					GLES2_INC_COUNT(GLES2_TIMER_PDSVERTEXVARIANT_HIT_COUNT, 1);
+				}
+				else
+				{
+					GLES2_INC_COUNT(GLES2_TIMER_PDSVERTEXVARIANT_MISS_COUNT, 1);
+				}
+			}
+
+			if (!psPDSVertexVariant)
+			{
+				/* Generate the PDS Program for this shader */
+				pui32Buffer = (IMG_UINT32 *)PDSGenerateVertexShaderProgram(psPDSVertexShaderProgram, 
+																		   psPDSVertexState->aui32LastPDSProgram,
+																		   &(psPDSVertexState->sProgramInfo));
+
+				psPDSVertexState->ui32ProgramSize = (IMG_UINT32)(pui32Buffer - (psPDSVertexState->aui32LastPDSProgram));
+
+				if (bCacheable)
+				{
+					psPDSVertexVariant = GLES2Calloc(gc, sizeof(GLES2PDSVertexCodeVariant));
+
+					if (psPDSVertexVariant)
+					{
+						psPDSVertexVariant->psCodeBlock = UCH_CodeHeapAllocate(gc->psSharedState->psPDSVertexCodeHeap,
+																			   psPDSVertexState->ui32ProgramSize << 2,
+																			   gc->psSysContext->hPerProcRef);
+					}
+
+					/* Copy hashcompare data from temp buffer */
+					pui32HashCompare = IMG_NULL;
 
-			psPDSVertexState->ui32ProgramSize = (IMG_UINT32)(pui32Buffer - (psPDSVertexState->aui32LastPDSProgram));
+					if (psPDSVertexVariant && psPDSVertexVariant->psCodeBlock)
+					{
+						pui32HashCompare = GLES2Malloc(gc, ui32HashCompareSizeInDWords * sizeof(IMG_UINT32));
+					}
+
+					if (pui32HashCompare)
+					{
+						GLES2MemCopy(pui32HashCompare, 
+									 gc->sProgram.aui32VertexHashCompare, 
+									 ui32HashCompareSizeInDWords * sizeof(IMG_UINT32));
+
+						GLES2MemCopy(psPDSVertexVariant->psCodeBlock->pui32LinAddress, 
+									 psPDSVertexState->aui32LastPDSProgram, 
+									 psPDSVertexState->ui32ProgramSize << 2);
+
+						GLES2MemCopy(&(psPDSVertexVariant->sProgramInfo), 
+									 &(psPDSVertexState->sProgramInfo), 
+									 sizeof(PDS_VERTEX_SHADER_PROGRAM_INFO));
+
+						psPDSVertexVariant->ui32ProgramSize = psPDSVertexState->ui32ProgramSize;
+						psPDSVertexVariant->ui32DataSize    = psPDSVertexShaderProgram->ui32DataSize;
+
+						/* Insert PDS variant in hash table */
+						HashTableInsert(gc, 
+										&gc->sProgram.sPDSVertexVariantHashTable, tPDSVariantHash, 
+										pui32HashCompare, ui32HashCompareSizeInDWords, 
+										(IMG_UINT32)psPDSVertexVariant);
+
+						/* Add to USE variant list */
+						psPDSVertexVariant->psNext = psVertexVariant->psPDSVertexVariant;
+						psVertexVariant->psPDSVertexVariant = psPDSVertexVariant;
+
+						/* Record hashing info in item so we can retrieve it through the USE variant */
+						psPDSVertexVariant->pui32HashCompare = pui32HashCompare;
+						psPDSVertexVariant->ui32HashCompareSizeInDWords = ui32HashCompareSizeInDWords;
+						psPDSVertexVariant->tHashValue = tPDSVariantHash;
+
+						/* Link to USE variant */
+						psPDSVertexVariant->psUSEVariant = psVertexVariant;
+					}
+					else if (psPDSVertexVariant)
+					{
+						PVR_DPF((PVR_DBG_WARNING,"WritePDSVertexShaderProgramWithVAO: Failed to allocate PDS vertex variant"));
+
+						UCH_CodeHeapFree(psPDSVertexVariant->psCodeBlock);
+						GLES2Free(IMG_NULL, psPDSVertexVariant);
+
+						psPDSVertexVariant = IMG_NULL;
+					}
+				}
+			}
 			
 
 			GLES2_TIME_STOP(GLES2_TIMER_GENERATE_PDS_VERTEX_SHADER_PROGRAM_VAO_TIME);
@@ -1889,7 +2028,14 @@ static GLES2_MEMERROR WritePDSVertexShaderProgramWithVAO(GLES2Context *gc, IMG_B
 	    psVAO->bUseMemInfo = IMG_FALSE;
 	}
 
-	if (psVAO->bUseMemInfo == IMG_TRUE)
+	if (psPDSVertexVariant)
+	{
+		/* The program is cached in the PDS vertex code heap: make sure it outlives this TA kick */
+		KRM_Attach(&gc->sPDSVertexVariantKRM, gc, &gc->sKRMTAStatusUpdate, &psPDSVertexVariant->sResource);
+
+		uVertexPDSBaseAddress = psPDSVertexVariant->psCodeBlock->sCodeAddress;
+	}
+	else if (psVAO->bUseMemInfo == IMG_TRUE)
 	{
 	    if (psVAO->psMemInfo == IMG_NULL)
 		{
@@ -1964,6 +2110,7 @@ static GLES2_MEMERROR WritePDSVertexShaderProgramWithVAO(GLES2Context *gc, IMG_B
 
 	/* Reset sPrim.psPDSVertexState */
 	gc->sPrim.psPDSVertexState = psVAO->psPDSVertexState;
+	gc->sPrim.psPDSVertexVariant = psPDSVertexVariant;
 
 	/* Setup sPrim's PDS vertex shader data segment physical address and size */
 	gc->sPrim.uVertexPDSBaseAddress = uVertexPDSBaseAddress;
@@ -2374,7 +2521,7 @@ static GLES2_MEMERROR WritePDSUSEShaderSAProgram(GLES2Context *gc, IMG_UINT32 ui
 		}
 	
 		/* There is a secondary USSE program to run */
-		if(psShader->psSharedState->psSecondaryUploadTask)
+		if(GLES2_SHADER_CODE_STATE(psShader)->psSecondaryUploadTask)
 		{
 			IMG_UINT32 uUSETempCount = psPatchedShader->uSecTempRegCount;
 			IMG_UINT32 ui32SDSoft = 
@@ -2405,7 +2552,7 @@ static GLES2_MEMERROR WritePDSUSEShaderSAProgram(GLES2Context *gc, IMG_UINT32 ui
 			{
 				SetUSEExecutionAddress(&sProgram.aui32USETaskControl[0], 
 										0,
-										psShader->psSharedState->psSecondaryUploadTask->psSecondaryCodeBlock->sCodeAddress, 
+										GLES2_SHADER_CODE_STATE(psShader)->psSecondaryUploadTask->psSecondaryCodeBlock->sCodeAddress, 
 										gc->psSysContext->uUSEVertexHeapBase, 
 										SGX_VTXSHADER_USE_CODE_BASE_INDEX);
 			}
@@ -2413,7 +2560,7 @@ static GLES2_MEMERROR WritePDSUSEShaderSAProgram(GLES2Context *gc, IMG_UINT32 ui
 			{
 				SetUSEExecutionAddress(&sProgram.aui32USETaskControl[0], 
 										0, 
-										psShader->psSharedState->psSecondaryUploadTask->psSecondaryCodeBlock->sCodeAddress, 
+										GLES2_SHADER_CODE_STATE(psShader)->psSecondaryUploadTask->psSecondaryCodeBlock->sCodeAddress, 
 										gc->psSysContext->uUSEFragmentHeapBase, 
 										SGX_PIXSHADER_USE_CODE_BASE_INDEX);
 			}
@@ -2585,41 +2732,258 @@ static GLES2_MEMERROR WritePDSUSEShaderSAProgram(GLES2Context *gc, IMG_UINT32 ui
 
 
 /*****************************************************************************
- Function Name	: WriteMTEState
- Inputs			: 
+ Function Name	: SetupMTEStateCopyProgram
+ Inputs			: gc, ui32StateSizeInDWords, uStateDataHWAddress
+ Outputs		: psProgram
+ Returns		: none
+ Description	: Sets up the DMA and USE task control words of the PDS state
+				  copy program for a block of MTE state
+*****************************************************************************/
+static IMG_VOID SetupMTEStateCopyProgram(GLES2Context			*gc,
+										 PDS_STATE_COPY_PROGRAM	*psProgram,
+										 IMG_UINT32				ui32StateSizeInDWords,
+										 IMG_DEV_VIRTADDR		uStateDataHWAddress)
+{
+	IMG_DEV_VIRTADDR uUSEExecutionHWAddress;
+
+	uUSEExecutionHWAddress = GetStateCopyUSEAddress(gc, ui32StateSizeInDWords);
+
+	/*
+		Setup the parameters for the PDS program.
+	*/
+	psProgram->ui32NumDMAKicks = EncodeDmaBurst(psProgram->aui32DMAControl, 0, ui32StateSizeInDWords, uStateDataHWAddress);	/* PRQA S 3199 */
+
+#if defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	psProgram->aui32USETaskControl[0]	= (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU0_TRC_SHIFT);
+	psProgram->aui32USETaskControl[1]	= EURASIA_PDS_DOUTU1_MODE_PARALLEL;
+	psProgram->aui32USETaskControl[2]	= 0;
+#else
+	psProgram->aui32USETaskControl[0]	= EURASIA_PDS_DOUTU0_PDSDMADEPENDENCY;
+	psProgram->aui32USETaskControl[1]	= EURASIA_PDS_DOUTU1_MODE_PARALLEL | 
+										  (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU1_TRC_SHIFT);
+	psProgram->aui32USETaskControl[2]	= 0;
+#endif /* defined(SGX_FEATURE_USE_UNLIMITED_PHASES) */
+
+	SetUSEExecutionAddress(&psProgram->aui32USETaskControl[0], 
+							0,
+							uUSEExecutionHWAddress, 
+							gc->psSysContext->uUSEVertexHeapBase, 
+							SGX_VTXSHADER_USE_CODE_BASE_INDEX);
+}
+
+
+/*****************************************************************************
+ Function Name	: SetMTEStateBlockOutputState
+ Inputs			: gc, psStateBlock
  Outputs		: none
+ Returns		: none
+ Description	: Points the state update at a cached MTE state block
+*****************************************************************************/
+static IMG_VOID SetMTEStateBlockOutputState(GLES2Context *gc, GLES2MTEStateBlock *psStateBlock)
+{
+	/* The block is read by the TA: make sure it outlives this kick */
+	KRM_Attach(&gc->sMTEStateBlockKRM, gc, &gc->sKRMTAStatusUpdate, &psStateBlock->sResource);
+
+	gc->sPrim.uOutputStatePDSBaseAddress	= psStateBlock->uPDSBaseAddress;
+	gc->sPrim.ui32OutputStatePDSDataSize	= psStateBlock->ui32PDSDataSize;
+	gc->sPrim.ui32OutputStateUSEAttribSize	= psStateBlock->ui32StateSizeInDWords;
+
+#if defined(SGX_FEATURE_UNIFIED_TEMPS_AND_PAS)
+	gc->sPrim.ui32OutputStateUSEAttribSize += SGX_USE_MINTEMPREGS;
+#endif
+}
+
+
+/*****************************************************************************
+ Function Name	: CreateMTEStateBlock
+ Inputs			: gc, ui32StateSizeInDWords, tHashValue
+ Outputs		: none
+ Returns		: New state block or IMG_NULL
+ Description	: Copies the state words in gc->sPrim.aui32MTEStateWords and a
+				  state copy program reading them into the PDS vertex code heap,
+				  and inserts the result in the MTE state block hash table.
+*****************************************************************************/
+static GLES2MTEStateBlock *CreateMTEStateBlock(GLES2Context *gc, IMG_UINT32 ui32StateSizeInDWords, HashValue tHashValue)
+{
+	GLES2MTEStateBlock *psStateBlock;
+	PDS_STATE_COPY_PROGRAM sProgram = {0};
+	IMG_DEV_VIRTADDR uStateDataHWAddress;
+	IMG_UINT32 *pui32HashCompare = IMG_NULL, *pui32Code;
+
+	psStateBlock = GLES2Calloc(gc, sizeof(GLES2MTEStateBlock));
+
+	if(psStateBlock)
+	{
+		psStateBlock->psCodeBlock = UCH_CodeHeapAllocate(gc->psSharedState->psPDSVertexCodeHeap,
+														 GLES2_MTE_STATE_BLOCK_SIZE << 2,
+														 gc->psSysContext->hPerProcRef);
+
+		if(psStateBlock->psCodeBlock)
+		{
+			pui32HashCompare = GLES2Malloc(gc, ui32StateSizeInDWords * sizeof(IMG_UINT32));
+		}
+	}
+
+	if(!pui32HashCompare)
+	{
+		PVR_DPF((PVR_DBG_WARNING,"CreateMTEStateBlock: Failed to allocate MTE state block"));
+
+		if(psStateBlock)
+		{
+			UCH_CodeHeapFree(psStateBlock->psCodeBlock);
+			GLES2Free(IMG_NULL, psStateBlock);
+		}
+
+		return IMG_NULL;
+	}
+
+	GLES2MemCopy(pui32HashCompare, gc->sPrim.aui32MTEStateWords, ui32StateSizeInDWords * sizeof(IMG_UINT32));
+
+	/*
+		State words follow the copy program in the block
+	*/
+	pui32Code = psStateBlock->psCodeBlock->pui32LinAddress;
+
+	GLES2MemCopy(pui32Code + GLES2_MTE_STATE_BLOCK_STATE_OFFSET, gc->sPrim.aui32MTEStateWords, ui32StateSizeInDWords * sizeof(IMG_UINT32));
+
+	uStateDataHWAddress.uiAddr = psStateBlock->psCodeBlock->sCodeAddress.uiAddr + (GLES2_MTE_STATE_BLOCK_STATE_OFFSET << 2);
+
+	SetupMTEStateCopyProgram(gc, &sProgram, ui32StateSizeInDWords, uStateDataHWAddress);
+
+	pui32Code = PDSGenerateStateCopyProgram(&sProgram, pui32Code);
+
+	PVR_ASSERT(pui32Code <= psStateBlock->psCodeBlock->pui32LinAddress + GLES2_MTE_STATE_BLOCK_STATE_OFFSET);
+
+	psStateBlock->uPDSBaseAddress.uiAddr = psStateBlock->psCodeBlock->sCodeAddress.uiAddr +
+		(IMG_UINT32)((IMG_UINTPTR_T)sProgram.pui32DataSegment - (IMG_UINTPTR_T)psStateBlock->psCodeBlock->pui32LinAddress);
+
+#if !defined(SGX_FEATURE_EDM_VERTEX_PDSADDR_FULL_RANGE)
+	/* Adjust PDS execution address for restricted address range */
+	psStateBlock->uPDSBaseAddress.uiAddr -= gc->psSysContext->sHWInfo.uPDSExecBase.uiAddr;
+#endif
+
+	psStateBlock->ui32PDSDataSize		= sProgram.ui32DataSize;
+	psStateBlock->ui32StateSizeInDWords	= ui32StateSizeInDWords;
+
+	HashTableInsert(gc, &gc->sPrim.sMTEStateBlockHashTable, tHashValue, 
+					pui32HashCompare, ui32StateSizeInDWords, (IMG_UINT32)psStateBlock);
+
+	return psStateBlock;
+}
+
+
+/*****************************************************************************
+ Function Name	: DestroyHashedMTEStateBlock
+ Inputs			: gc, ui32Item
+ Outputs		: -
+ Returns		: -
+ Description	: Frees an MTE state block evicted from the hash table. If the
+				  block may still be read by a TA kick it is ghosted and freed
+				  once the kick has completed.
+*****************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyHashedMTEStateBlock(GLES2Context *gc, IMG_UINT32 ui32Item)
+{
+	GLES2MTEStateBlock *psStateBlock = (GLES2MTEStateBlock *)ui32Item;
+	GLES2MTEStateBlockGhost *psStateBlockGhost;
+
+	if(KRM_IsResourceNeeded(&gc->sMTEStateBlockKRM, &psStateBlock->sResource))
+	{
+		psStateBlockGhost = GLES2Calloc(gc, sizeof(GLES2MTEStateBlockGhost));
+
+		if(psStateBlockGhost)
+		{
+			/* Transfer ownership of the code block from the state block to the ghost */
+			psStateBlockGhost->psCodeBlock = psStateBlock->psCodeBlock;
+			psStateBlock->psCodeBlock = IMG_NULL;
+
+			KRM_GhostResource(&gc->sMTEStateBlockKRM, &psStateBlock->sResource, &psStateBlockGhost->sResource);
+		}
+		else
+		{
+			PVR_DPF((PVR_DBG_WARNING, "DestroyHashedMTEStateBlock: Out of memory. Waiting for the TA instead of ghosting"));
+
+			KRM_WaitUntilResourceIsNotNeeded(&gc->sMTEStateBlockKRM, &psStateBlock->sResource, GLES2_DEFAULT_WAIT_RETRIES);
+		}
+	}
+
+	KRM_RemoveResourceFromAllLists(&gc->sMTEStateBlockKRM, &psStateBlock->sResource);
+
+	UCH_CodeHeapFree(psStateBlock->psCodeBlock);
+	GLES2Free(IMG_NULL, psStateBlock);
+}
+
+
+/*****************************************************************************
+ Function Name	: ReclaimMTEStateBlockMemKRM
+ Inputs			: pvContext, psResource
+ Outputs		: -
+ Returns		: -
+ Description	: MTE state blocks are freed through the hash table, so the KRM
+				  is never asked to reclaim them.
+*****************************************************************************/
+IMG_INTERNAL IMG_VOID ReclaimMTEStateBlockMemKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	PVR_UNREFERENCED_PARAMETER(pvContext);
+	PVR_UNREFERENCED_PARAMETER(psResource);
+
+	PVR_DPF((PVR_DBG_WARNING, "ReclaimMTEStateBlockMemKRM: Called"));
+}
+
+
+/*****************************************************************************
+ Function Name	: DestroyMTEStateBlockGhostKRM
+ Inputs			: pvContext, psResource
+ Outputs		: -
+ Returns		: -
+ Description	: Destroys a ghosted MTE state block.
+*****************************************************************************/
+IMG_INTERNAL IMG_VOID DestroyMTEStateBlockGhostKRM(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	/* Note the tricky pointer arithmetic. It is necessary */
+	GLES2MTEStateBlockGhost *psStateBlockGhost =
+		(GLES2MTEStateBlockGhost*)((IMG_UINTPTR_T)psResource -offsetof(GLES2MTEStateBlockGhost, sResource));
+
+	PVR_UNREFERENCED_PARAMETER(pvContext);
+
+	UCH_CodeHeapFree(psStateBlockGhost->psCodeBlock);
+	GLES2Free(IMG_NULL, psStateBlockGhost);
+}
+
+
+/*****************************************************************************
+ Function Name	: WriteMTEState
+ Inputs			: gc, ePrimitiveType
+ Outputs		: pui32DWordsWritten, psStateAddr, pbCopyProgramWritten
  Returns		: Mem Error
- Description	: 
+ Description	: Packs the MTE state words. Blocks seen before are taken from
+				  the MTE state block cache together with their state copy
+				  program, in which case *pbCopyProgramWritten is set and
+				  psStateAddr is not written.
 *****************************************************************************/
 static GLES2_MEMERROR WriteMTEState(GLES2Context *gc,
 								IMG_UINT32 ePrimitiveType,
 								IMG_UINT32 *pui32DWordsWritten,
-								IMG_DEV_VIRTADDR *psStateAddr)
+								IMG_DEV_VIRTADDR *psStateAddr,
+								IMG_BOOL *pbCopyProgramWritten)
 {
 	IMG_UINT32	ui32USEFormatHeader = 0, *pui32Buffer, *pui32BufferBase;
 	IMG_UINT32	ui32ISPAPrimitiveType;
-	IMG_UINT32  ui32StateDWords = GLES2_MAX_MTE_STATE_DWORDS;
+	IMG_UINT32  ui32StateDWords;
 	IMG_FLOAT fWClamp = 0.00001f;
 	GLES2CompiledRenderState *psRenderState = &gc->sPrim.sRenderState;
 	GLES2USEShaderVariant *psFragmentVariant = gc->sProgram.psCurrentFragmentVariant;
 	GLES2PDSInfo *psPDSInfo = &psFragmentVariant->u.sFragment.sPDSInfo;
 	GLES2Program *psProgram = gc->sProgram.psCurrentProgram;
+	GLES2MTEStateBlock *psStateBlock = IMG_NULL;
+	HashValue tStateBlockHash;
 
-	/*
-		Get buffer space for the actual output state
-	*/
-	pui32BufferBase = CBUF_GetBufferSpace(gc->apsBuffers, 
-									ui32StateDWords, 
-									CBUF_TYPE_PDS_VERT_BUFFER, IMG_FALSE);
+	*pbCopyProgramWritten = IMG_FALSE;
 
-	if(!pui32BufferBase)
-	{
-		return GLES2_TA_BUFFER_ERROR;
-	}
-	
 	/*
-		Record the buffer base (for the header) and advance pointer past the header
+		Pack the state into the host-side buffer, the header goes first
 	*/
+	pui32BufferBase = gc->sPrim.aui32MTEStateWords;
+
 	pui32Buffer = pui32BufferBase;
 
 	pui32Buffer++;
@@ -2815,25 +3179,71 @@ static GLES2_MEMERROR WriteMTEState(GLES2Context *gc,
 	}
 	else
 	{
-		ui32StateDWords = 0;
-	}
+		*pui32DWordsWritten = 0;
 
-	/* Update PDS buffer position */
-	CBUF_UpdateBufferPos(gc->apsBuffers, ui32StateDWords, CBUF_TYPE_PDS_VERT_BUFFER);
-
-	GLES2_INC_COUNT(GLES2_TIMER_PDS_VERT_DATA_COUNT, ui32StateDWords);
+		return GLES2_NO_ERROR;
+	}
 
 	GLES2_INC_COUNT(GLES2_TIMER_MTE_STATE_COUNT, ui32StateDWords);
 
 	/* Write the format header */
 	*pui32BufferBase = ui32USEFormatHeader;
 
+	*pui32DWordsWritten = ui32StateDWords;
+
 	/*
-		Get the address of the state data in video memory.
+		A freshly written fragment secondary program lives in the circular buffer at an address
+		that will not come round again, so caching blocks that point at it would only churn the table.
 	*/
-	*psStateAddr = CBUF_GetBufferDeviceAddress(gc->apsBuffers, pui32BufferBase, CBUF_TYPE_PDS_VERT_BUFFER);
+	if((gc->ui32EmitMask & GLES2_EMITSTATE_PDS_FRAGMENT_SECONDARY_STATE) == 0)
+	{
+		tStateBlockHash = HashFunc(pui32BufferBase, ui32StateDWords, STATEHASH_INIT_VALUE);
 
-	*pui32DWordsWritten = ui32StateDWords;
+		if(HashTableSearch(gc, &gc->sPrim.sMTEStateBlockHashTable, tStateBlockHash,
+							pui32BufferBase, ui32StateDWords, (IMG_UINT32 *)&psStateBlock))
+		{
+			GLES2_INC_COUNT(GLES2_TIMER_MTESTATEBLOCK_HIT_COUNT, 1);
+		}
+		else
+		{
+			GLES2_INC_COUNT(GLES2_TIMER_MTESTATEBLOCK_MISS_COUNT, 1);
+
+			psStateBlock = CreateMTEStateBlock(gc, ui32StateDWords, tStateBlockHash);
+		}
+
+		if(psStateBlock)
+		{
+			SetMTEStateBlockOutputState(gc, psStateBlock);
+
+			*pbCopyProgramWritten = IMG_TRUE;
+
+			return GLES2_NO_ERROR;
+		}
+	}
+
+	/*
+		Get buffer space for the actual output state
+	*/
+	pui32Buffer = CBUF_GetBufferSpace(gc->apsBuffers, 
+									ui32StateDWords, 
+									CBUF_TYPE_PDS_VERT_BUFFER, IMG_FALSE);
+
+	if(!pui32Buffer)
+	{
+		return GLES2_TA_BUFFER_ERROR;
+	}
+
+	GLES2MemCopy(pui32Buffer, pui32BufferBase, ui32StateDWords * sizeof(IMG_UINT32));
+
+	/* Update PDS buffer position */
+	CBUF_UpdateBufferPos(gc->apsBuffers, ui32StateDWords, CBUF_TYPE_PDS_VERT_BUFFER);
+
+	GLES2_INC_COUNT(GLES2_TIMER_PDS_VERT_DATA_COUNT, ui32StateDWords);
+
+	/*
+		Get the address of the state data in video memory.
+	*/
+	*psStateAddr = CBUF_GetBufferDeviceAddress(gc->apsBuffers, pui32Buffer, CBUF_TYPE_PDS_VERT_BUFFER);
 
 	return GLES2_NO_ERROR; 
 }
@@ -2850,34 +3260,11 @@ IMG_INTERNAL GLES2_MEMERROR PatchPregenMTEStateCopyPrograms(GLES2Context	*gc,
 															IMG_DEV_VIRTADDR	uStateDataHWAddress)
 {
 	IMG_UINT32 *pui32BufferBase;
-	IMG_DEV_VIRTADDR uUSEExecutionHWAddress;
 	PDS_STATE_COPY_PROGRAM	sProgram;
 	
 	GLES2MemSet(&sProgram, 0, sizeof(PDS_STATE_COPY_PROGRAM));
 
-	uUSEExecutionHWAddress = GetStateCopyUSEAddress(gc, ui32StateSizeInDWords);
-
-	/*
-		Setup the parameters for the PDS program.
-	*/
-	sProgram.ui32NumDMAKicks = EncodeDmaBurst(sProgram.aui32DMAControl, 0, ui32StateSizeInDWords, uStateDataHWAddress);	/* PRQA S 3199 */
-
-#if defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
-	sProgram.aui32USETaskControl[0] = (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU0_TRC_SHIFT);
-	sProgram.aui32USETaskControl[1] = EURASIA_PDS_DOUTU1_MODE_PARALLEL;
-	sProgram.aui32USETaskControl[2]	= 0;
-#else
-	sProgram.aui32USETaskControl[0]	= EURASIA_PDS_DOUTU0_PDSDMADEPENDENCY;
-	sProgram.aui32USETaskControl[1]	= EURASIA_PDS_DOUTU1_MODE_PARALLEL | 
-									  (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU1_TRC_SHIFT);
-	sProgram.aui32USETaskControl[2]	= 0;
-#endif /* defined(SGX_FEATURE_USE_UNLIMITED_PHASES) */
-
-	SetUSEExecutionAddress(&sProgram.aui32USETaskControl[0], 
-							0,
-							uUSEExecutionHWAddress, 
-							gc->psSysContext->uUSEVertexHeapBase, 
-							SGX_VTXSHADER_USE_CODE_BASE_INDEX);
+	SetupMTEStateCopyProgram(gc, &sProgram, ui32StateSizeInDWords, uStateDataHWAddress);
 
 	sProgram.ui32DataSize =  PDS_MTESTATECOPY_DATA_SEGMENT_SIZE;
 
@@ -2949,32 +3336,9 @@ IMG_INTERNAL GLES2_MEMERROR WriteMTEStateCopyPrograms(GLES2Context	*gc,
 														IMG_DEV_VIRTADDR	uStateDataHWAddress)
 {
 	IMG_UINT32 *pui32BufferBase, *pui32Buffer;
-	IMG_DEV_VIRTADDR uUSEExecutionHWAddress;
 	PDS_STATE_COPY_PROGRAM	sProgram = {0};
 
-	uUSEExecutionHWAddress = GetStateCopyUSEAddress(gc, ui32StateSizeInDWords);
-
-	/*
-		Setup the parameters for the PDS program.
-	*/
-	sProgram.ui32NumDMAKicks = EncodeDmaBurst(sProgram.aui32DMAControl, 0, ui32StateSizeInDWords, uStateDataHWAddress);
-
-#if defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
-	sProgram.aui32USETaskControl[0]	= (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU0_TRC_SHIFT);
-	sProgram.aui32USETaskControl[1]	= EURASIA_PDS_DOUTU1_MODE_PARALLEL;
-	sProgram.aui32USETaskControl[2]	= 0;
-#else
-	sProgram.aui32USETaskControl[0]	= EURASIA_PDS_DOUTU0_PDSDMADEPENDENCY;
-	sProgram.aui32USETaskControl[1]	= EURASIA_PDS_DOUTU1_MODE_PARALLEL | 
-									  (SGX_USE_MINTEMPREGS << EURASIA_PDS_DOUTU1_TRC_SHIFT);
-	sProgram.aui32USETaskControl[2]	= 0;
-#endif /* defined(SGX_FEATURE_USE_UNLIMITED_PHASES) */
-
-	SetUSEExecutionAddress(&sProgram.aui32USETaskControl[0], 
-							0,
-							uUSEExecutionHWAddress, 
-							gc->psSysContext->uUSEVertexHeapBase, 
-							SGX_VTXSHADER_USE_CODE_BASE_INDEX);
+	SetupMTEStateCopyProgram(gc, &sProgram, ui32StateSizeInDWords, uStateDataHWAddress);
 
 	/*
 		Get buffer space for the PDS state copy program
@@ -3303,6 +3667,8 @@ static IMG_VOID SetupVAOAttribStreams(GLES2Context *gc)
 #endif
 						}
 
+						psVAOAPMachine->pfnGatherData = GatherData[ui32UserSize - 1][ui32Type];
+
 #if defined(NO_UNALIGNED_ACCESS)
 						if(psVAOAPMachine->ui32Size % 4)
 						{
@@ -3334,6 +3700,7 @@ static IMG_VOID SetupVAOAttribStreams(GLES2Context *gc)
 #else
 				psVAOAPMachine->pfnCopyData	           = CopyData[3][GLES2_STREAMTYPE_FLOAT];
 #endif
+				psVAOAPMachine->pfnGatherData	       = IMG_NULL;
 
 				psVAOAPMachine->pui8CopyPointer		   = (IMG_VOID *)&gc->sVAOMachine.asCurrentAttrib[i];
 				psVAOAPMachine->ui32CopyStreamTypeSize = GLES2_STREAMTYPE_FLOAT | (4 << GLES2_STREAMSIZE_SHIFT);
@@ -4099,10 +4466,36 @@ IMG_INTERNAL GLES2_MEMERROR ValidateState(GLES2Context *gc)
 	}
 #endif /* defined(GLES2_EXTENSION_EGL_IMAGE) */
 
+#if defined(SUPPORT_SOURCE_SHADER)
+	/* May put the program back on its generic code, dirtying the program state */
+	if(gc->sAppHints.ui32UniformSpecialisationDraws)
+	{
+		UpdateUniformSpecialisation(gc, gc->sProgram.psCurrentProgram);
+	}
+#endif
+
+	/* A buffer object may have moved since this VAO's stream addresses were patched */
+	if(psVAO->ui32BufObjRenameStamp != gc->psSharedState->ui32BufObjRenameStamp)
+	{
+		psVAO->ui32BufObjRenameStamp = gc->psSharedState->ui32BufObjRenameStamp;
+
+		psVAO->ui32DirtyState |= GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER;
+	}
 
 	/* Only setup context's VAO dirty flag once starting ValidateState() */
 	gc->ui32DirtyState |= psVAO->ui32DirtyState;
 
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+	/* Land readbacks queued into, or attached since, any buffer object the TA will fetch from */
+	if((psVAO->ui32PackReadbackStamp != gc->psSharedState->ui32PackReadbackStamp) ||
+	   (gc->ui32DirtyState & GLES2_DIRTYFLAG_VAO_ALL))
+	{
+		psVAO->ui32PackReadbackStamp = gc->psSharedState->ui32PackReadbackStamp;
+
+		ResolveVAOPackReadbacks(gc, psVAO);
+	}
+#endif
+
 
 	/* Setup the context's dirty state regarding element buffer,
 	   and accordingly set VAO Machine's element buffer */
@@ -4273,7 +4666,7 @@ IMG_INTERNAL GLES2_MEMERROR GLES2EmitState(GLES2Context *gc, IMG_UINT32 ePrimiti
 {
 	IMG_DEV_VIRTADDR uStateHWAddress;
 	IMG_UINT32 ui32NumStateDWords;
-	IMG_BOOL b32BitPDSIndices;
+	IMG_BOOL b32BitPDSIndices, bCopyProgramWritten;
 	GLES2_MEMERROR eError;
 #if defined(SGX_FEATURE_SW_VDM_CONTEXT_SWITCH)
 	IMG_BOOL bForceTAKick;
@@ -4416,7 +4809,7 @@ IMG_INTERNAL GLES2_MEMERROR GLES2EmitState(GLES2Context *gc, IMG_UINT32 ePrimiti
 
 			GLES2_TIME_START(GLES2_TIMER_WRITEMTESTATE_TIME);
 			
-			eError = WriteMTEState(gc, ePrimitiveType, &ui32NumStateDWords, &uStateHWAddress);
+			eError = WriteMTEState(gc, ePrimitiveType, &ui32NumStateDWords, &uStateHWAddress, &bCopyProgramWritten);
 		
 			GLES2_TIME_STOP(GLES2_TIMER_WRITEMTESTATE_TIME);
 		
@@ -4427,7 +4820,12 @@ IMG_INTERNAL GLES2_MEMERROR GLES2EmitState(GLES2Context *gc, IMG_UINT32 ePrimiti
 				return eError;
 			}
 		
-			if(ui32NumStateDWords)
+			if(bCopyProgramWritten)
+			{
+				/* The state came from the MTE state block cache along with its copy program */
+				gc->ui32EmitMask |= GLES2_EMITSTATE_STATEUPDATE;
+			}
+			else if(ui32NumStateDWords)
 			{
 				/*
 					Write the PDS/USE programs for copying MTE state through the primary attributes to the output buffer
@@ -106,6 +106,12 @@
 #endif
 #define	EURASIA_NUM_PDS_VERTEX_PROGRAM_DWORDS			(GLES2_MAX_VERTEX_ATTRIBS * (EURASIA_NUM_PDS_VERTEX_PROGRAM_CONSTANTS + EURASIA_NUM_PDS_VERTEX_PROGRAM_INSTRUCTIONS) + 1 + 1)
 
+/* MTE state blocks are cached as the state copy program followed by the state words */
+#define GLES2_MTE_STATE_BLOCK_STATE_OFFSET				((EURASIA_NUM_PDS_STATE_PROGRAM_DWORDS + 3) & ~3U)
+#define GLES2_MTE_STATE_BLOCK_SIZE						(GLES2_MTE_STATE_BLOCK_STATE_OFFSET + GLES2_MAX_MTE_STATE_DWORDS)
+#define GLES2_MTE_STATE_BLOCK_LOG2TABLESIZE				8
+#define GLES2_MTE_STATE_BLOCK_MAXNUMENTRIES				256
+
 #define GLES2_MTE_COPY_PROG_SIZE		 (PDS_MTESTATECOPY_SIZE >> 2)
 #define GLES2_ALIGNED_MTE_COPY_PROG_SIZE (GLES2_MTE_COPY_PROG_SIZE + (EURASIA_VDMPDS_BASEADDR_CACHEALIGN - GLES2_MTE_COPY_PROG_SIZE % EURASIA_VDMPDS_BASEADDR_CACHEALIGN))    
 
@@ -158,6 +164,32 @@ typedef struct GLES2PDSVertexState_TAG
 #define GLES1_ALPHA_TEST_BRNFIX_DEPTHF	(1U << 3)
 #endif /* defined(FIX_HW_BRN_29546) || defined(FIX_HW_BRN_31728) */
 
+typedef struct GLES2MTEStateBlock_TAG
+{
+	/* MTE state blocks are TA-kick resources */
+	KRMResource			sResource;
+
+	/* State copy program followed by the state words */
+	UCH_UseCodeBlock	*psCodeBlock;
+
+	/* PDS state copy program address (offset by PDS exec base) and sizes */
+	IMG_DEV_VIRTADDR	uPDSBaseAddress;
+	IMG_UINT32			ui32PDSDataSize;
+	IMG_UINT32			ui32StateSizeInDWords;
+
+} GLES2MTEStateBlock;
+
+
+typedef struct GLES2MTEStateBlockGhost_TAG
+{
+	/* MTE state block ghosts are TA-kick resources */
+	KRMResource			sResource;
+
+	UCH_UseCodeBlock	*psCodeBlock;
+
+} GLES2MTEStateBlockGhost;
+
+
 typedef struct GLES2CompiledRenderState_TAG
 {
 
@@ -207,6 +239,9 @@ typedef struct GLES2PrimitiveMachine_TAG
 	
 	GLES2PDSVertexState			*psPDSVertexState;
 
+	/* Cached PDS vertex program in use, or NULL if it was written to the circular buffer */
+	GLES2PDSVertexCodeVariant	*psPDSVertexVariant;
+
 	UCH_UseCodeBlock			*psHWBGCodeBlock;
 #if defined(FIX_HW_BRN_26922)
 	GLES2BRN26922State			sBRN26922State;
@@ -242,6 +277,10 @@ typedef struct GLES2PrimitiveMachine_TAG
 	
 	IMG_UINT32 ui32OutputStateUSEAttribSize;
 
+	/* Previously emitted MTE state blocks, keyed by their state words */
+	HashTable			sMTEStateBlockHashTable;
+	IMG_UINT32			aui32MTEStateWords[GLES2_MAX_MTE_STATE_DWORDS];
+
 
 	/*
 		Virtual base address and data size of the PDS primary program
@@ -286,6 +325,9 @@ GLES2_MEMERROR OutputTerminateState(GLES2Context *gc, EGLRenderSurface *psRender
 GLES2_MEMERROR SetupPixelEventProgram(GLES2Context *gc, EGLPixelBEState *psPixelBEState, IMG_BOOL bPatch);
 GLES2_MEMERROR SetupStateUpdate(GLES2Context *gc, IMG_BOOL bMTEStateUpdate);
 GLES2_MEMERROR SetupMTEPregenBuffer(GLES2Context *gc);
+IMG_VOID DestroyHashedMTEStateBlock(GLES2Context *gc, IMG_UINT32 ui32Item);
+IMG_VOID ReclaimMTEStateBlockMemKRM(IMG_VOID *pvContext, KRMResource *psResource);
+IMG_VOID DestroyMTEStateBlockGhostKRM(IMG_VOID *pvContext, KRMResource *psResource);
 GLES2_MEMERROR SendAccumulateObject(GLES2Context *gc, IMG_BOOL bClearDepth, IMG_FLOAT fDepth);
 IMG_BOOL InitAccumUSECodeBlocks(GLES2Context *gc);
 IMG_BOOL InitClearUSECodeBlocks(GLES2Context *gc);
@@ -27,6 +27,18 @@
 
 #define VAO_INDEX_BUFFER_OBJECT(gc) (gc->sVAOMachine.psActiveVAO->psBoundElementBuffer!=IMG_NULL)
 
+/* A buffer object rename in any sharing context leaves the stream addresses stale,
+ * and a readback queued into a buffer object leaves its contents unresolved
+ */
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+#define VAO_IS_DIRTY(gc) ((gc->sVAOMachine.psActiveVAO->ui32DirtyState != 0) || \
+						  (gc->sVAOMachine.psActiveVAO->ui32BufObjRenameStamp != gc->psSharedState->ui32BufObjRenameStamp) || \
+						  (gc->sVAOMachine.psActiveVAO->ui32PackReadbackStamp != gc->psSharedState->ui32PackReadbackStamp))
+#else
+#define VAO_IS_DIRTY(gc) ((gc->sVAOMachine.psActiveVAO->ui32DirtyState != 0) || \
+						  (gc->sVAOMachine.psActiveVAO->ui32BufObjRenameStamp != gc->psSharedState->ui32BufObjRenameStamp))
+#endif
+
 
 /* 
 ** Vertex array object 
@@ -61,6 +73,14 @@ typedef struct GLES2VertexArrayObjectRec
     /* Dirty state indicates whether PDS vertex shader program needs to be generated or patched */
     IMG_UINT32                      ui32DirtyState;
 
+    /* Buffer object rename stamp the stream addresses were last patched for */
+    IMG_UINT32                      ui32BufObjRenameStamp;
+
+#if defined(GLES2_EXTENSION_PIXEL_PACK_BUFFER)
+    /* Pixel pack readback stamp the VAO's buffer objects were last resolved for */
+    IMG_UINT32                      ui32PackReadbackStamp;
+#endif
+
 #if defined(PDUMP)
 	IMG_BOOL						bDumped;
 #endif
@@ -0,0 +1,969 @@
+/******************************************************************************
+ * Name         : vertexcopy.c
+ *
+ * Copyright    : 2005-2006 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either 
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Kernels that copy and gather client vertex attribute
+ *                streams into the vertex buffer
+ *
+ * Platform     : ANSI
+ *
+ * $Log: vertexcopy.c $
+ *
+ **************************************************************************/
+
+#include "context.h"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+
+static IMG_VOID Copy1Byte(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui8Dst[0] = pui8Src[0];
+
+		pui8Dst += 1;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+static IMG_VOID Copy3Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui8Dst[0] = pui8Src[0];
+		pui8Dst[1] = pui8Src[1];
+		pui8Dst[2] = pui8Src[2];
+
+		pui8Dst += 3;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy1Short(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Src = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Src);
+	pui16Dst = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui16Dst[0] = pui16Src[0];
+
+		pui16Dst += 1;
+
+		pui16Src = (IMG_UINT16 *)((IMG_UINTPTR_T)pui16Src + ui32SrcStride);
+	}
+}
+
+static IMG_VOID Copy3Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Src = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Src);
+	pui16Dst = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui16Dst[0] = pui16Src[0];
+		pui16Dst[1] = pui16Src[1];
+		pui16Dst[2] = pui16Src[2];
+
+		pui16Dst += 3;
+
+		pui16Src = (IMG_UINT16 *)((IMG_UINTPTR_T)pui16Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy1Long(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 *pui32Src, *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Src);
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui32Dst[0] = pui32Src[0];
+
+		pui32Dst += 1;
+
+		pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui32Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy2Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 *pui32Src, *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Src);
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+#if defined(__ARM_NEON__)
+		vst1_u32(pui32Dst, vld1_u32(pui32Src));
+#else
+		pui32Dst[0] = pui32Src[0];
+		pui32Dst[1] = pui32Src[1];
+#endif
+
+		pui32Dst += 2;
+
+		pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui32Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy3Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 *pui32Src, *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Src);
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui32Dst[0] = pui32Src[0];
+		pui32Dst[1] = pui32Src[1];
+		pui32Dst[2] = pui32Src[2];
+
+		pui32Dst += 3;
+
+		pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui32Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy4Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 *pui32Src, *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Src);
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	for (i=0; i<ui32Count; i++)
+	{
+#if defined(__ARM_NEON__)
+		vst1q_u32(pui32Dst, vld1q_u32(pui32Src));
+#else
+		pui32Dst[0] = pui32Src[0];
+		pui32Dst[1] = pui32Src[1];
+		pui32Dst[2] = pui32Src[2];
+		pui32Dst[3] = pui32Src[3];
+#endif
+
+		pui32Dst += 4;
+
+		pui32Src = (IMG_UINT32 *)((IMG_UINTPTR_T)pui32Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID MemCopy1Byte(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count);
+}
+
+static IMG_VOID MemCopy3Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*3);
+}
+
+static IMG_VOID MemCopy1Short(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*sizeof(IMG_UINT16));
+}
+
+static IMG_VOID MemCopy3Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*(3*sizeof(IMG_UINT16)));
+}
+
+static IMG_VOID MemCopy1Long(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*sizeof(IMG_UINT32));
+}
+
+static IMG_VOID MemCopy2Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*(2*sizeof(IMG_UINT32)));
+}
+
+static IMG_VOID MemCopy3Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*(3*sizeof(IMG_UINT32)));
+}
+
+static IMG_VOID MemCopy4Longs(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32SrcStride);
+
+	GLES2MemCopy(pui8Dst, pui8Src, ui32Count*(4*sizeof(IMG_UINT32)));
+}
+
+
+IMG_INTERNAL IMG_VOID (* const CopyData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count) = 
+{
+	{
+		Copy1Byte,
+		Copy1Byte,
+		Copy1Short,
+		Copy1Short,
+		Copy1Long,
+		Copy1Short,
+		Copy1Long 
+	},
+	{
+		Copy1Short,
+		Copy1Short,
+		Copy1Long,
+		Copy1Long,
+		Copy2Longs,
+		Copy1Long,
+		Copy2Longs 
+	},
+	{
+		Copy3Bytes,
+		Copy3Bytes,
+		Copy3Shorts,
+		Copy3Shorts,
+		Copy3Longs,
+		Copy3Shorts,
+		Copy3Longs 
+	},
+	{
+		Copy1Long,
+		Copy1Long,
+		Copy2Longs,
+		Copy2Longs,
+		Copy4Longs,
+		Copy2Longs,
+		Copy4Longs 
+	},
+};
+
+IMG_INTERNAL IMG_VOID (* const MemCopyData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count) = 
+{
+	{
+		MemCopy1Byte,
+		MemCopy1Byte,
+		MemCopy1Short,
+		MemCopy1Short,
+		MemCopy1Long,
+		MemCopy1Short,
+		MemCopy1Long 
+	},
+	{
+		MemCopy1Short,
+		MemCopy1Short,
+		MemCopy1Long,
+		MemCopy1Long,
+		MemCopy2Longs,
+		MemCopy1Long,
+		MemCopy2Longs 
+	},
+	{
+		MemCopy3Bytes,
+		MemCopy3Bytes,
+		MemCopy3Shorts,
+		MemCopy3Shorts,
+		MemCopy3Longs,
+		MemCopy3Shorts,
+		MemCopy3Longs 
+	},
+	{
+		MemCopy1Long,
+		MemCopy1Long,
+		MemCopy2Longs,
+		MemCopy2Longs,
+		MemCopy4Longs,
+		MemCopy2Longs,
+		MemCopy4Longs 
+	},
+};
+
+/*
+	Gather kernels: copy ui32Count vertices of one attribute stream, fetching each
+	vertex through the element list rather than walking the source linearly. This
+	fuses deindexing with the copy so that DrawElements on client arrays costs one
+	call per attribute instead of one call per attribute per vertex.
+	The kernels assume every gathered source is naturally aligned for its type.
+*/
+static IMG_VOID Gather1Byte(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT8 *pui8Src;
+	IMG_UINT32 i;
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui8Src = pui8SrcBase + pui32Elements[i] * ui32SrcStride;
+
+			pui8Dst[0] = pui8Src[0];
+
+			pui8Dst += 1;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui8Src = pui8SrcBase + pui16Elements[i] * ui32SrcStride;
+
+			pui8Dst[0] = pui8Src[0];
+
+			pui8Dst += 1;
+		}
+	}
+}
+
+
+static IMG_VOID Gather3Bytes(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT8 *pui8Src;
+	IMG_UINT32 i;
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui8Src = pui8SrcBase + pui32Elements[i] * ui32SrcStride;
+
+			pui8Dst[0] = pui8Src[0];
+			pui8Dst[1] = pui8Src[1];
+			pui8Dst[2] = pui8Src[2];
+
+			pui8Dst += 3;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui8Src = pui8SrcBase + pui16Elements[i] * ui32SrcStride;
+
+			pui8Dst[0] = pui8Src[0];
+			pui8Dst[1] = pui8Src[1];
+			pui8Dst[2] = pui8Src[2];
+
+			pui8Dst += 3;
+		}
+	}
+}
+
+
+static IMG_VOID Gather1Short(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT16 *pui16Src;
+	IMG_UINT16 *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Dst = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui16Src = (const IMG_UINT16 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+			pui16Dst[0] = pui16Src[0];
+
+			pui16Dst += 1;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui16Src = (const IMG_UINT16 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+			pui16Dst[0] = pui16Src[0];
+
+			pui16Dst += 1;
+		}
+	}
+}
+
+
+static IMG_VOID Gather3Shorts(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT16 *pui16Src;
+	IMG_UINT16 *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Dst = (IMG_UINT16 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui16Src = (const IMG_UINT16 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+			pui16Dst[0] = pui16Src[0];
+			pui16Dst[1] = pui16Src[1];
+			pui16Dst[2] = pui16Src[2];
+
+			pui16Dst += 3;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui16Src = (const IMG_UINT16 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+			pui16Dst[0] = pui16Src[0];
+			pui16Dst[1] = pui16Src[1];
+			pui16Dst[2] = pui16Src[2];
+
+			pui16Dst += 3;
+		}
+	}
+}
+
+
+static IMG_VOID Gather1Long(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT32 *pui32Src;
+	IMG_UINT32 *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+			pui32Dst[0] = pui32Src[0];
+
+			pui32Dst += 1;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+			pui32Dst[0] = pui32Src[0];
+
+			pui32Dst += 1;
+		}
+	}
+}
+
+
+static IMG_VOID Gather2Longs(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT32 *pui32Src;
+	IMG_UINT32 *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+#if defined(__ARM_NEON__)
+			vst1_u32(pui32Dst, vld1_u32(pui32Src));
+#else
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+#endif
+
+			pui32Dst += 2;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+#if defined(__ARM_NEON__)
+			vst1_u32(pui32Dst, vld1_u32(pui32Src));
+#else
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+#endif
+
+			pui32Dst += 2;
+		}
+	}
+}
+
+
+static IMG_VOID Gather3Longs(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT32 *pui32Src;
+	IMG_UINT32 *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+			pui32Dst[2] = pui32Src[2];
+
+			pui32Dst += 3;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+			pui32Dst[2] = pui32Src[2];
+
+			pui32Dst += 3;
+		}
+	}
+}
+
+
+static IMG_VOID Gather4Longs(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT32 *pui32Src;
+	IMG_UINT32 *pui32Dst;
+	IMG_UINT32 i;
+
+	pui32Dst = (IMG_UINT32 *)((IMG_UINTPTR_T)pui8Dst);
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui32Elements[i] * ui32SrcStride));
+
+#if defined(__ARM_NEON__)
+			vst1q_u32(pui32Dst, vld1q_u32(pui32Src));
+#else
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+			pui32Dst[2] = pui32Src[2];
+			pui32Dst[3] = pui32Src[3];
+#endif
+
+			pui32Dst += 4;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for (i=0; i<ui32Count; i++)
+		{
+			pui32Src = (const IMG_UINT32 *)((IMG_UINTPTR_T)(pui8SrcBase + pui16Elements[i] * ui32SrcStride));
+
+#if defined(__ARM_NEON__)
+			vst1q_u32(pui32Dst, vld1q_u32(pui32Src));
+#else
+			pui32Dst[0] = pui32Src[0];
+			pui32Dst[1] = pui32Src[1];
+			pui32Dst[2] = pui32Src[2];
+			pui32Dst[3] = pui32Src[3];
+#endif
+
+			pui32Dst += 4;
+		}
+	}
+}
+
+
+IMG_INTERNAL IMG_VOID (* const GatherData[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count) = 
+{
+	{
+		Gather1Byte,
+		Gather1Byte,
+		Gather1Short,
+		Gather1Short,
+		Gather1Long,
+		Gather1Short,
+		Gather1Long 
+	},
+	{
+		Gather1Short,
+		Gather1Short,
+		Gather1Long,
+		Gather1Long,
+		Gather2Longs,
+		Gather1Long,
+		Gather2Longs 
+	},
+	{
+		Gather3Bytes,
+		Gather3Bytes,
+		Gather3Shorts,
+		Gather3Shorts,
+		Gather3Longs,
+		Gather3Shorts,
+		Gather3Longs 
+	},
+	{
+		Gather1Long,
+		Gather1Long,
+		Gather2Longs,
+		Gather2Longs,
+		Gather4Longs,
+		Gather2Longs,
+		Gather4Longs 
+	},
+};
+
+#if defined(NO_UNALIGNED_ACCESS)
+static IMG_VOID Copy2Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui8Dst[0] = pui8Src[0];
+		pui8Dst[1] = pui8Src[1];
+
+		pui8Dst += 2;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy4Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui8Dst[0] = pui8Src[0];
+		pui8Dst[1] = pui8Src[1];
+		pui8Dst[2] = pui8Src[2];
+		pui8Dst[3] = pui8Src[3];
+
+		pui8Dst += 4;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy6Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i, j;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<6 ; j++)
+		{
+			pui8Dst[j] = pui8Src[j];
+		}
+
+		pui8Dst += 6;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy8Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i, j;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<8 ; j++)
+		{
+			pui8Dst[j] = pui8Src[j];
+		}
+
+		pui8Dst += 8;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy12Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i, j;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<12 ; j++)
+		{
+			pui8Dst[j] = pui8Src[j];
+		}
+
+		pui8Dst += 12;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy16Bytes(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 i, j;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<16 ; j++)
+		{
+			pui8Dst[j] = pui8Src[j];
+		}
+
+		pui8Dst += 16;
+
+		pui8Src += ui32SrcStride;
+	}
+}
+
+
+static IMG_VOID Copy2Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Src = (IMG_UINT16 *)pui8Src;
+	pui16Dst = (IMG_UINT16 *)pui8Dst;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui16Dst[0] = pui16Src[0];
+		pui16Dst[1] = pui16Src[1];
+
+		pui16Dst += 2;
+		pui16Src = (IMG_UINT16 *)((IMG_UINT8 *)pui16Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy4Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i;
+
+	pui16Src = (IMG_UINT16 *)pui8Src;
+	pui16Dst = (IMG_UINT16 *)pui8Dst;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		pui16Dst[0] = pui16Src[0];
+		pui16Dst[1] = pui16Src[1];
+		pui16Dst[2] = pui16Src[2];
+		pui16Dst[3] = pui16Src[3];
+
+		pui16Dst += 4;
+		pui16Src = (IMG_UINT16 *)((IMG_UINT8 *)pui16Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy6Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i, j;
+
+	pui16Src = (IMG_UINT16 *)pui8Src;
+	pui16Dst = (IMG_UINT16 *)pui8Dst;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<6 ; j++)
+		{
+			pui16Dst[j] = pui16Src[j];
+		}
+
+		pui16Dst += 6;
+		pui16Src = (IMG_UINT16 *)((IMG_UINT8 *)pui16Src + ui32SrcStride);
+	}
+}
+
+
+static IMG_VOID Copy8Shorts(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count)
+{
+	IMG_UINT16 *pui16Src, *pui16Dst;
+	IMG_UINT32 i, j;
+
+	pui16Src = (IMG_UINT16 *)pui8Src;
+	pui16Dst = (IMG_UINT16 *)pui8Dst;
+
+	for (i=0; i<ui32Count; i++)
+	{
+		for (j=0 ; j<8 ; j++)
+		{
+			pui16Dst[j] = pui16Src[j];
+		}
+
+		pui16Dst += 8;
+		pui16Src = (IMG_UINT16 *)((IMG_UINT8 *)pui16Src + ui32SrcStride);
+	}
+}
+
+
+IMG_VOID (* const CopyDataShortAligned[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count) = 
+{
+	{
+		Copy1Byte,
+		Copy1Byte,
+		Copy1Short,
+		Copy1Short,
+		Copy2Shorts,
+		Copy1Short,
+		Copy2Shorts 
+	},
+	{
+		Copy1Short,
+		Copy1Short,
+		Copy2Shorts,
+		Copy2Shorts,
+		Copy4Shorts,
+		Copy2Shorts,
+		Copy4Shorts 
+	},
+	{
+		Copy3Bytes,
+		Copy3Bytes,
+		Copy3Shorts,
+		Copy3Shorts,
+		Copy6Shorts,
+		Copy3Shorts,
+		Copy6Shorts 
+	},
+	{
+		Copy2Shorts,
+		Copy2Shorts,
+		Copy4Shorts,
+		Copy4Shorts,
+		Copy8Shorts,
+		Copy4Shorts,
+		Copy8Shorts 
+	},
+};
+
+IMG_VOID (* const CopyDataByteAligned[4][GLES2_STREAMTYPE_MAX])(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count) = 
+{
+	{
+		Copy1Byte,
+		Copy1Byte,
+		Copy2Bytes,
+		Copy2Bytes,
+		Copy4Bytes,
+		Copy2Bytes,
+		Copy4Bytes 
+	},
+	{
+		Copy2Bytes,
+		Copy2Bytes,
+		Copy4Bytes,
+		Copy4Bytes,
+		Copy8Bytes,
+		Copy4Bytes,
+		Copy8Bytes 
+	},
+	{
+		Copy3Bytes,
+		Copy3Bytes,
+		Copy6Bytes,
+		Copy6Bytes,
+		Copy12Bytes,
+		Copy6Bytes,
+		Copy12Bytes 
+	},
+	{
+		Copy4Bytes,
+		Copy4Bytes,
+		Copy8Bytes,
+		Copy8Bytes,
+		Copy16Bytes,
+		Copy8Bytes,
+		Copy16Bytes 
+	},
+};
+#endif
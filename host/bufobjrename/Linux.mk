@@ -0,0 +1,38 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host stress test of GLES2 buffer object renaming against a mocked TA and
+# the real kick resource manager. Run it with no arguments; it exits
+# non-zero if any check fails.
+#
+
+modules := bufobjrename
+
+bufobjrename_type := host_executable
+
+bufobjrename_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/bufobjrename.c \
+ $(TOP)/eurasiacon/common/kickresource.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header.
+bufobjrename_cflags := \
+ -DLINUX -DUSER \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/bufobjrename/hostcontext.h
+
+bufobjrename_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ intermediates/sgxsupport
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the rename stress test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of bufobjrename.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                buffer object, names, attribute and VAO headers are the
+ *                driver's own. The context keeps only the fields the rename
+ *                code and the VAO_IS_DIRTY test use, and device memory
+ *                comes from the harness.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h> /* For the macro offsetof() */
+
+#include "services.h"
+
+#include "ogles2_types.h"
+
+#include "drvgl2.h"
+
+#include "constants.h"
+#include "names.h"
+#include "kickresource.h"
+#include "bufobj.h"
+#include "attrib.h"
+
+/* Only referenced through pointers by vertexarrobj.h */
+typedef struct GLES2PDSVertexStateTAG GLES2PDSVertexState;
+typedef struct PDS_VERTEX_SHADER_PROGRAM_TAG PDS_VERTEX_SHADER_PROGRAM;
+
+#include "vertexarrobj.h"
+
+/* As validate.h */
+#define GLES2_DIRTYFLAG_VAO_ATTRIB_STREAM   0x00004000U
+#define GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER  0x00008000U
+
+#define GLES_ASSERT(expr) PVR_ASSERT(expr)
+
+#define GLES2Calloc(X,Y)		(IMG_VOID*)PVRSRVCallocUserModeMem(Y)
+#define GLES2Free(X,Y)			PVRSRVFreeUserModeMem(Y)
+#define	GLES2MemCopy(X,Y,Z)		memcpy(X, Y, Z)
+
+#define GLES2_INC_COUNT(X,Y)
+
+
+typedef struct GLES2ContextSharedStateTAG
+{
+	PVRSRV_MUTEX_HANDLE hPrimaryLock;
+
+	PVRSRV_MUTEX_HANDLE hSecondaryLock;
+
+	/* Keeps track of which buffer objects are attached to any given context */
+	KRMKickResourceManager sBufferObjectKRM;
+
+	/* Bumped whenever a buffer object moves to new device memory, so VAOs repatch their stream addresses */
+	IMG_UINT32 ui32BufObjRenameStamp;
+
+} GLES2ContextSharedState;
+
+
+struct GLES2Context_TAG
+{
+	IMG_UINT32 ui32DirtyState;
+
+	GLES2ContextSharedState *psSharedState;
+
+	KRMStatusUpdate sKRMTAStatusUpdate;
+
+	GLES2VertexArrayObjectMachine sVAOMachine;
+};
+
+
+/* Supplied by the harness's device memory mock */
+PVRSRV_ERROR GLES2ALLOCDEVICEMEM_HEAP(GLES2Context *gc, IMG_UINT32 ui32Attribs, IMG_UINT32 ui32Size,
+									  IMG_UINT32 ui32Alignment, PVRSRV_CLIENT_MEM_INFO **ppsMemInfo);
+PVRSRV_ERROR GLES2FREEDEVICEMEM_HEAP(GLES2Context *gc, PVRSRV_CLIENT_MEM_INFO *psMemInfo);
+
+#endif /* _CONTEXT_ */
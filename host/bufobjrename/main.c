@@ -0,0 +1,959 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Buffer object rename stress test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Drives the GLES2 buffer object rename code (bufobjrename.c)
+ *                and the kick resource manager (kickresource.c) with random
+ *                draws, kicks, TA completions, buffer updates,
+ *                respecifications and deletions from two contexts sharing
+ *                the buffers. The TA is a mock: each context's kicks
+ *                complete in order when the harness writes its status
+ *                value, and device memory is host memory that is marked,
+ *                not released, when the driver frees it.
+ *
+ *                Every draw goes through the same validation test as
+ *                drawvarray.c (gc->ui32DirtyState || VAO_IS_DIRTY) and
+ *                fails if the stream addresses it would use are not the
+ *                buffers' current memory. Every kick fails if the TA would
+ *                read memory that has been freed, and every CPU write or free
+ *                fails if a kick, submitted or not, still reads the memory.
+ *                Preserved contents are checked after every partial update.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "hostcontext.h"
+
+
+#define BR_NUM_CONTEXTS				2
+#define BR_NUM_BUFFERS				4
+#define BR_MAX_DRAWS_PER_KICK		8
+#define BR_MAX_KICKS_IN_FLIGHT		6
+#define BR_MAX_KICK_REFS			(BR_MAX_DRAWS_PER_KICK * BR_NUM_BUFFERS)
+#define BR_DEFAULT_ITERATIONS		200000
+
+/* Sizes a buffer is respecified with. The largest is too big to copy on a partial update */
+static const IMG_UINT32 g_aui32BufferSizes[] = {64, 1024, 4096, GLES2_BUFOBJ_MAX_RENAME_COPY + 4096};
+
+#define BR_NUM_BUFFER_SIZES			(sizeof(g_aui32BufferSizes) / sizeof(g_aui32BufferSizes[0]))
+
+/* Mock device allocation. The driver only sees sMemInfo */
+typedef struct _BR_MEMINFO_
+{
+	PVRSRV_CLIENT_MEM_INFO	sMemInfo;
+
+	IMG_BOOL				bFreed;
+
+	struct _BR_MEMINFO_		*psNext;
+
+} BR_MEMINFO;
+
+/* A TA kick and the device memory its draws read */
+typedef struct _BR_KICK_
+{
+	IMG_UINT32				ui32Value;
+	IMG_UINT32				ui32NumDraws;
+	IMG_UINT32				ui32NumRefs;
+	BR_MEMINFO				*apsRefs[BR_MAX_KICK_REFS];
+
+} BR_KICK;
+
+typedef struct _BR_CONTEXT_
+{
+	GLES2Context			sGC;
+
+	/* Completed TA kick value, read by the KRM through sStatusMemInfo */
+	IMG_UINT32				ui32Completed;
+	PVRSRV_CLIENT_MEM_INFO	sStatusMemInfo;
+
+	/* Stream addresses last patched into the VAO's PDS program */
+	PVRSRV_CLIENT_MEM_INFO	*apsPatched[BR_NUM_BUFFERS];
+
+	/* Kick being built, and submitted kicks oldest first */
+	BR_KICK					sCurrent;
+	BR_KICK					asInFlight[BR_MAX_KICKS_IN_FLIGHT];
+	IMG_UINT32				ui32NumInFlight;
+
+} BR_CONTEXT;
+
+typedef struct _BR_STATS_
+{
+	IMG_UINT32 ui32Draws;
+	IMG_UINT32 ui32Validations;
+	IMG_UINT32 ui32Kicks;
+	IMG_UINT32 ui32Updates;
+	IMG_UINT32 ui32Respecifies;
+	IMG_UINT32 ui32Deletes;
+	IMG_UINT32 ui32Waits;
+	IMG_UINT32 ui32Allocs;
+	IMG_UINT32 ui32PeakLive;
+
+} BR_STATS;
+
+static BR_CONTEXT g_asContexts[BR_NUM_CONTEXTS];
+static GLES2ContextSharedState g_sSharedState;
+static GLES2BufferObject *g_apsBuffers[BR_NUM_BUFFERS];
+static IMG_UINT8 g_aui8Fill[BR_NUM_BUFFERS];
+
+static BR_MEMINFO *g_psAllocations;
+static IMG_UINT32 g_ui32NumLive;
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+static IMG_BOOL g_bVerbose = IMG_FALSE;
+static BR_STATS g_sStats;
+
+/* Non-recursive locks, so nested locking by the code under test is caught */
+static IMG_BOOL g_bPrimaryLocked, g_bSecondaryLocked;
+
+static IMG_CHAR const* g_pszOptions =
+"-n=N        Run N random operations (default 200000).\n"
+"-seed=N     Seed for the operation sequence (default 1).\n"
+"-v          Print every failure, not just the first few.\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	if(g_ui32NumErrors++ < 10 || g_bVerbose)
+	{
+		va_start(sArgs, pszFormat);
+		fprintf(stderr, "error: ");
+		vfprintf(stderr, pszFormat, sArgs);
+		fprintf(stderr, "\n");
+		va_end(sArgs);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/*
+** Services, platform and device memory mocks
+*/
+
+IMG_EXPORT IMG_PVOID IMG_CALLCONV PVRSRVCallocUserModeMem(IMG_SIZE_T ui32Size)
+{
+	return calloc(1, ui32Size);
+}
+
+IMG_EXPORT IMG_PVOID IMG_CALLCONV PVRSRVReallocUserModeMem(IMG_PVOID pvBase, IMG_SIZE_T uNewSize)
+{
+	return realloc(pvBase, uNewSize);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVFreeUserModeMem(IMG_PVOID pvMem)
+{
+	free(pvMem);
+}
+
+IMG_EXPORT IMG_VOID PVRSRVMemSet(IMG_VOID *pvDest, IMG_UINT8 ui8Value, IMG_SIZE_T ui32Size)
+{
+	memset(pvDest, ui8Value, ui32Size);
+}
+
+static IMG_BOOL *GetLockFlag(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	return (hMutex == g_sSharedState.hPrimaryLock) ? &g_bPrimaryLocked : &g_bSecondaryLocked;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVLockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	IMG_BOOL *pbLocked = GetLockFlag(hMutex);
+
+	if(*pbLocked)
+	{
+		Fail("%s lock taken while already held", (pbLocked == &g_bPrimaryLocked) ? "primary" : "secondary");
+	}
+
+	*pbLocked = IMG_TRUE;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVUnlockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	IMG_BOOL *pbLocked = GetLockFlag(hMutex);
+
+	if(!*pbLocked)
+	{
+		Fail("%s lock released while not held", (pbLocked == &g_bPrimaryLocked) ? "primary" : "secondary");
+	}
+
+	*pbLocked = IMG_FALSE;
+}
+
+void *sceKernelGetTLSAddr(int key)
+{
+	PVR_UNREFERENCED_PARAMETER(key);
+
+	return IMG_NULL;
+}
+
+/* Only reached through KRM_WaitUntilResourceIsNotNeeded, which the mocked wait below replaces */
+int sceGpuSignalWait(void *unkTLS, unsigned int timeout)
+{
+	PVR_UNREFERENCED_PARAMETER(unkTLS);
+	PVR_UNREFERENCED_PARAMETER(timeout);
+
+	Fail("unexpected wait on the GPU");
+
+	return PVRSRV_OK;
+}
+
+PVRSRV_ERROR GLES2ALLOCDEVICEMEM_HEAP(GLES2Context *gc, IMG_UINT32 ui32Attribs, IMG_UINT32 ui32Size,
+									  IMG_UINT32 ui32Alignment, PVRSRV_CLIENT_MEM_INFO **ppsMemInfo)
+{
+	BR_MEMINFO *psAlloc = calloc(1, sizeof(BR_MEMINFO));
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+	PVR_UNREFERENCED_PARAMETER(ui32Attribs);
+	PVR_UNREFERENCED_PARAMETER(ui32Alignment);
+
+	if(!psAlloc || !(psAlloc->sMemInfo.pvLinAddr = malloc(ui32Size)))
+	{
+		free(psAlloc);
+
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	psAlloc->sMemInfo.uAllocSize = ui32Size;
+	psAlloc->psNext = g_psAllocations;
+	g_psAllocations = psAlloc;
+
+	g_sStats.ui32Allocs++;
+
+	if(++g_ui32NumLive > g_sStats.ui32PeakLive)
+	{
+		g_sStats.ui32PeakLive = g_ui32NumLive;
+	}
+
+	*ppsMemInfo = &psAlloc->sMemInfo;
+
+	return PVRSRV_OK;
+}
+
+PVRSRV_ERROR GLES2FREEDEVICEMEM_HEAP(GLES2Context *gc, PVRSRV_CLIENT_MEM_INFO *psMemInfo)
+{
+	BR_MEMINFO *psAlloc = (BR_MEMINFO *)psMemInfo;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	if(psAlloc->bFreed)
+	{
+		Fail("device memory %p freed twice", psMemInfo);
+
+		return PVRSRV_OK;
+	}
+
+	/* Keep the record so later reads of it are caught */
+	free(psMemInfo->pvLinAddr);
+
+	psMemInfo->pvLinAddr = IMG_NULL;
+	psAlloc->bFreed = IMG_TRUE;
+
+	g_ui32NumLive--;
+
+	return PVRSRV_OK;
+}
+
+
+/* The harness never runs the KRM's reclaim pass */
+static IMG_VOID ReclaimBufferObjectMem(IMG_VOID *pvContext, KRMResource *psResource)
+{
+	PVR_UNREFERENCED_PARAMETER(pvContext);
+	PVR_UNREFERENCED_PARAMETER(psResource);
+
+	Fail("unexpected reclaim of buffer object memory");
+}
+
+
+/*
+** Mock TA
+*/
+
+/***********************************************************************************
+ Function Name      : CompleteOldestKick
+ Inputs             : psContext
+ Outputs            : -
+ Returns            : -
+ Description        : Runs the oldest submitted kick on the mock TA and signals its
+					  completion. All the memory its draws read must still be live.
+************************************************************************************/
+static IMG_VOID CompleteOldestKick(BR_CONTEXT *psContext)
+{
+	BR_KICK *psKick = &psContext->asInFlight[0];
+	IMG_UINT32 i;
+
+	if(!psContext->ui32NumInFlight)
+	{
+		return;
+	}
+
+	for(i = 0; i < psKick->ui32NumRefs; i++)
+	{
+		if(psKick->apsRefs[i]->bFreed)
+		{
+			Fail("context %u kick %u reads device memory %p after it was freed",
+				 (IMG_UINT32)(psContext - g_asContexts), psKick->ui32Value, psKick->apsRefs[i]);
+		}
+	}
+
+	psContext->ui32Completed = psKick->ui32Value;
+
+	psContext->ui32NumInFlight--;
+	memmove(&psContext->asInFlight[0], &psContext->asInFlight[1], psContext->ui32NumInFlight * sizeof(BR_KICK));
+}
+
+
+/***********************************************************************************
+ Function Name      : KickTA
+ Inputs             : psContext
+ Outputs            : -
+ Returns            : -
+ Description        : Submits the context's current kick, as ScheduleTA does
+************************************************************************************/
+static IMG_VOID KickTA(BR_CONTEXT *psContext)
+{
+	if(!psContext->sCurrent.ui32NumDraws)
+	{
+		return;
+	}
+
+	if(psContext->ui32NumInFlight == BR_MAX_KICKS_IN_FLIGHT)
+	{
+		CompleteOldestKick(psContext);
+	}
+
+	psContext->asInFlight[psContext->ui32NumInFlight++] = psContext->sCurrent;
+
+	psContext->sGC.sKRMTAStatusUpdate.ui32StatusValue++;
+
+	memset(&psContext->sCurrent, 0, sizeof(BR_KICK));
+	psContext->sCurrent.ui32Value = psContext->sGC.sKRMTAStatusUpdate.ui32StatusValue;
+
+	g_sStats.ui32Kicks++;
+}
+
+
+/***********************************************************************************
+ Function Name      : WaitUntilBufObjNotUsed
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : IMG_TRUE
+ Description        : Mock of the bufobj.c wait. The driver kicks the calling context
+					  and waits for the TA. Other contexts' draws are ordered by the
+					  application's flushes, as GL requires for shared objects, so
+					  the mock kicks every context that uses the buffer and then
+					  lets the TA finish every submitted kick.
+************************************************************************************/
+IMG_INTERNAL IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	IMG_UINT32 i;
+
+	g_sStats.ui32Waits++;
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		GLES2Context *psOtherGC = &g_asContexts[i].sGC;
+
+		if(KRM_IsResourceInUse(&gc->psSharedState->sBufferObjectKRM, psOtherGC, &psOtherGC->sKRMTAStatusUpdate, &psBufObj->sResource))
+		{
+			KickTA(&g_asContexts[i]);
+		}
+	}
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		while(g_asContexts[i].ui32NumInFlight)
+		{
+			CompleteOldestKick(&g_asContexts[i]);
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckWritable
+ Inputs             : psMemInfo, pszWhat
+ Outputs            : -
+ Returns            : -
+ Description        : Fails if the CPU is about to write or free memory that a kick,
+					  submitted or not, will read
+************************************************************************************/
+static IMG_VOID CheckWritable(PVRSRV_CLIENT_MEM_INFO *psMemInfo, const IMG_CHAR *pszWhat)
+{
+	IMG_UINT32 i, j, k;
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		for(j = 0; j <= g_asContexts[i].ui32NumInFlight; j++)
+		{
+			BR_KICK *psKick = (j < g_asContexts[i].ui32NumInFlight) ? &g_asContexts[i].asInFlight[j] : &g_asContexts[i].sCurrent;
+
+			for(k = 0; k < psKick->ui32NumRefs; k++)
+			{
+				if(&psKick->apsRefs[k]->sMemInfo == psMemInfo)
+				{
+					Fail("%s touches device memory %p that context %u kick %u reads", pszWhat, psMemInfo, i, psKick->ui32Value);
+				}
+			}
+		}
+	}
+}
+
+
+/*
+** GL operations, following the driver entrypoints
+*/
+
+/***********************************************************************************
+ Function Name      : Validate
+ Inputs             : psContext
+ Outputs            : -
+ Returns            : -
+ Description        : The parts of ValidateState that concern stream addresses
+************************************************************************************/
+static IMG_VOID Validate(BR_CONTEXT *psContext)
+{
+	GLES2Context *gc = &psContext->sGC;
+	GLES2VertexArrayObject *psVAO = gc->sVAOMachine.psActiveVAO;
+	IMG_UINT32 i;
+
+	if(psVAO->ui32BufObjRenameStamp != gc->psSharedState->ui32BufObjRenameStamp)
+	{
+		psVAO->ui32BufObjRenameStamp = gc->psSharedState->ui32BufObjRenameStamp;
+
+		psVAO->ui32DirtyState |= GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER;
+	}
+
+	gc->ui32DirtyState |= psVAO->ui32DirtyState;
+
+	if(gc->ui32DirtyState & (GLES2_DIRTYFLAG_VAO_ATTRIB_STREAM | GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER))
+	{
+		for(i = 0; i < BR_NUM_BUFFERS; i++)
+		{
+			psContext->apsPatched[i] = g_apsBuffers[i]->psMemInfo;
+		}
+	}
+
+	psVAO->ui32DirtyState = 0;
+	gc->ui32DirtyState = 0;
+
+	g_sStats.ui32Validations++;
+}
+
+
+/***********************************************************************************
+ Function Name      : Draw
+ Inputs             : psContext
+ Outputs            : -
+ Returns            : -
+ Description        : A draw streaming from every buffer
+************************************************************************************/
+static IMG_VOID Draw(BR_CONTEXT *psContext)
+{
+	GLES2Context *gc = &psContext->sGC;
+	IMG_UINT32 i;
+
+	if(psContext->sCurrent.ui32NumDraws == BR_MAX_DRAWS_PER_KICK)
+	{
+		KickTA(psContext);
+	}
+
+	/* As drawvarray.c */
+	if(gc->ui32DirtyState || VAO_IS_DIRTY(gc))
+	{
+		Validate(psContext);
+	}
+
+	for(i = 0; i < BR_NUM_BUFFERS; i++)
+	{
+		GLES2BufferObject *psBufObj = g_apsBuffers[i];
+
+		if(psContext->apsPatched[i] != psBufObj->psMemInfo)
+		{
+			Fail("context %u draws buffer %u from stale address %p (now %p)",
+				 (IMG_UINT32)(psContext - g_asContexts), i, psContext->apsPatched[i], psBufObj->psMemInfo);
+		}
+
+		if(!KRM_Attach(&g_sSharedState.sBufferObjectKRM, gc, &gc->sKRMTAStatusUpdate, &psBufObj->sResource))
+		{
+			Fail("KRM_Attach failed");
+		}
+
+		psContext->sCurrent.apsRefs[psContext->sCurrent.ui32NumRefs++] = (BR_MEMINFO *)psContext->apsPatched[i];
+	}
+
+	psContext->sCurrent.ui32NumDraws++;
+
+	g_sStats.ui32Draws++;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckContents
+ Inputs             : ui32Buffer
+ Outputs            : -
+ Returns            : -
+ Description        : Samples a buffer for the fill value last written to it
+************************************************************************************/
+static IMG_VOID CheckContents(IMG_UINT32 ui32Buffer)
+{
+	GLES2BufferObject *psBufObj = g_apsBuffers[ui32Buffer];
+	IMG_UINT8 *pui8Data = psBufObj->psMemInfo->pvLinAddr;
+	IMG_UINT32 ui32Size = psBufObj->ui32BufferSize;
+
+	if(pui8Data[0] != g_aui8Fill[ui32Buffer] ||
+	   pui8Data[ui32Size / 2] != g_aui8Fill[ui32Buffer] ||
+	   pui8Data[ui32Size - 1] != g_aui8Fill[ui32Buffer])
+	{
+		Fail("buffer %u lost its contents across a partial update", ui32Buffer);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : BufferSubData
+ Inputs             : psContext, ui32Buffer
+ Outputs            : -
+ Returns            : -
+ Description        : glBufferSubData or glMapBufferOES: a partial or whole update
+************************************************************************************/
+static IMG_VOID BufferSubData(BR_CONTEXT *psContext, IMG_UINT32 ui32Buffer)
+{
+	GLES2BufferObject *psBufObj = g_apsBuffers[ui32Buffer];
+	IMG_BOOL bPreserveContents = Random(2) ? IMG_TRUE : IMG_FALSE;
+
+	if(!MakeBufObjWritable(&psContext->sGC, psBufObj, bPreserveContents))
+	{
+		Fail("MakeBufObjWritable failed");
+
+		return;
+	}
+
+	CheckWritable(psBufObj->psMemInfo, "update");
+
+	if(bPreserveContents)
+	{
+		CheckContents(ui32Buffer);
+	}
+
+	g_aui8Fill[ui32Buffer] = (IMG_UINT8)(g_aui8Fill[ui32Buffer] + 1);
+	memset(psBufObj->psMemInfo->pvLinAddr, g_aui8Fill[ui32Buffer], psBufObj->ui32BufferSize);
+
+	g_sStats.ui32Updates++;
+}
+
+
+/***********************************************************************************
+ Function Name      : BufferData
+ Inputs             : psContext, ui32Buffer
+ Outputs            : -
+ Returns            : -
+ Description        : glBufferData, following the bufobj.c respecification path
+************************************************************************************/
+static IMG_VOID BufferData(BR_CONTEXT *psContext, IMG_UINT32 ui32Buffer)
+{
+	GLES2Context *gc = &psContext->sGC;
+	GLES2BufferObject *psBufObj = g_apsBuffers[ui32Buffer];
+	IMG_UINT32 ui32Size = g_aui32BufferSizes[Random(BR_NUM_BUFFER_SIZES)];
+	IMG_BOOL bWritable;
+
+	if(psBufObj->psMemInfo)
+	{
+		IMG_BOOL bReuseMemory = (psBufObj->psMemInfo->uAllocSize == ui32Size) ? IMG_TRUE : IMG_FALSE;
+
+		if(bReuseMemory)
+		{
+			bWritable = MakeBufObjWritable(gc, psBufObj, IMG_FALSE);
+		}
+		else
+		{
+			FreeBufObjSpareMemory(gc, psBufObj);
+
+			if(KRM_IsResourceNeeded(&gc->psSharedState->sBufferObjectKRM, &psBufObj->sResource) &&
+			   GhostBufObjMemory(gc, psBufObj, IMG_NULL))
+			{
+				bWritable = IMG_TRUE;
+			}
+			else
+			{
+				bWritable = WaitUntilBufObjNotUsed(gc, psBufObj);
+			}
+		}
+
+		if(!bWritable)
+		{
+			Fail("buffer %u did not become writable", ui32Buffer);
+
+			return;
+		}
+
+		if(psBufObj->psMemInfo && !bReuseMemory)
+		{
+			CheckWritable(psBufObj->psMemInfo, "respecification");
+
+			GLES2FREEDEVICEMEM_HEAP(gc, psBufObj->psMemInfo);
+
+			psBufObj->psMemInfo = IMG_NULL;
+		}
+	}
+
+	if(!psBufObj->psMemInfo)
+	{
+		if(GLES2ALLOCDEVICEMEM_HEAP(gc, PVRSRV_MEM_READ, ui32Size, 4, &psBufObj->psMemInfo) != PVRSRV_OK)
+		{
+			Fail("out of host memory");
+			exit(1);
+		}
+
+		MarkBufObjMemoryMoved(gc);
+	}
+
+	CheckWritable(psBufObj->psMemInfo, "respecification");
+
+	gc->sVAOMachine.psActiveVAO->ui32DirtyState |= GLES2_DIRTYFLAG_VAO_ATTRIB_STREAM;
+
+	psBufObj->ui32BufferSize = ui32Size;
+
+	g_aui8Fill[ui32Buffer] = (IMG_UINT8)(g_aui8Fill[ui32Buffer] + 1);
+	memset(psBufObj->psMemInfo->pvLinAddr, g_aui8Fill[ui32Buffer], ui32Size);
+
+	g_sStats.ui32Respecifies++;
+}
+
+
+/***********************************************************************************
+ Function Name      : DeleteBuffer
+ Inputs             : psContext, ui32Buffer
+ Outputs            : -
+ Returns            : -
+ Description        : glDeleteBuffers, following FreeBufferObject
+************************************************************************************/
+static IMG_VOID DeleteBuffer(BR_CONTEXT *psContext, IMG_UINT32 ui32Buffer)
+{
+	GLES2Context *gc = &psContext->sGC;
+	GLES2BufferObject *psBufObj = g_apsBuffers[ui32Buffer];
+
+	/* Ghosts still in flight free their own memory when they retire */
+	if(psBufObj->psGhosts)
+	{
+		GLES2BufferObjectGhost *psGhost;
+
+		PVRSRVLockMutex(gc->psSharedState->hPrimaryLock);
+
+		for(psGhost = psBufObj->psGhosts; psGhost; psGhost = psGhost->psNextOwned)
+		{
+			psGhost->psOwner = IMG_NULL;
+		}
+
+		psBufObj->psGhosts = IMG_NULL;
+		psBufObj->ui32NumGhosts = 0;
+
+		PVRSRVUnlockMutex(gc->psSharedState->hPrimaryLock);
+	}
+
+	FreeBufObjSpareMemory(gc, psBufObj);
+
+	if(psBufObj->psMemInfo)
+	{
+		WaitUntilBufObjNotUsed(gc, psBufObj);
+
+		CheckWritable(psBufObj->psMemInfo, "deletion");
+
+		GLES2FREEDEVICEMEM_HEAP(gc, psBufObj->psMemInfo);
+	}
+
+	KRM_RemoveResourceFromAllLists(&gc->psSharedState->sBufferObjectKRM, &psBufObj->sResource);
+
+	free(psBufObj);
+
+	g_apsBuffers[ui32Buffer] = IMG_NULL;
+
+	g_sStats.ui32Deletes++;
+}
+
+
+/***********************************************************************************
+ Function Name      : CreateBuffer
+ Inputs             : psContext, ui32Buffer
+ Outputs            : -
+ Returns            : -
+ Description        : glGenBuffers, glBufferData and glVertexAttribPointer in every
+					  context, which re-points each context's VAO at the new buffer
+************************************************************************************/
+static IMG_VOID CreateBuffer(BR_CONTEXT *psContext, IMG_UINT32 ui32Buffer)
+{
+	IMG_UINT32 i;
+
+	g_apsBuffers[ui32Buffer] = calloc(1, sizeof(GLES2BufferObject));
+
+	if(!g_apsBuffers[ui32Buffer])
+	{
+		Fail("out of host memory");
+		exit(1);
+	}
+
+	g_apsBuffers[ui32Buffer]->sNamedItem.ui32Name = ui32Buffer + 1;
+
+	BufferData(psContext, ui32Buffer);
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		g_asContexts[i].sGC.sVAOMachine.psActiveVAO->ui32DirtyState |= GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER;
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : StartFrame
+ Inputs             : psContext
+ Outputs            : -
+ Returns            : -
+ Description        : Retires ghosts, as StartFrame in sgxif.c does
+************************************************************************************/
+static IMG_VOID StartFrame(BR_CONTEXT *psContext)
+{
+	KRM_DestroyUnneededGhosts(&psContext->sGC, &g_sSharedState.sBufferObjectKRM);
+}
+
+
+/***********************************************************************************
+ Function Name      : InitialiseContexts
+ Inputs             : -
+ Outputs            : -
+ Returns            : Success
+ Description        : Sets up the shared state, the contexts and the buffers
+************************************************************************************/
+static IMG_BOOL InitialiseContexts(IMG_VOID)
+{
+	static IMG_UINT32 ui32PrimaryLock, ui32SecondaryLock;
+	IMG_UINT32 i;
+
+	g_sSharedState.hPrimaryLock = (PVRSRV_MUTEX_HANDLE)&ui32PrimaryLock;
+	g_sSharedState.hSecondaryLock = (PVRSRV_MUTEX_HANDLE)&ui32SecondaryLock;
+
+	if(!KRM_Initialize(&g_sSharedState.sBufferObjectKRM,
+					   KRM_TYPE_TA,
+					   IMG_TRUE,
+					   g_sSharedState.hSecondaryLock,
+					   IMG_NULL,
+					   IMG_NULL,
+					   ReclaimBufferObjectMem,
+					   IMG_TRUE,
+					   DestroyBufferObjectGhostKRM))
+	{
+		return IMG_FALSE;
+	}
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		BR_CONTEXT *psContext = &g_asContexts[i];
+		GLES2Context *gc = &psContext->sGC;
+
+		gc->psSharedState = &g_sSharedState;
+
+		psContext->sStatusMemInfo.pvLinAddr = &psContext->ui32Completed;
+		gc->sKRMTAStatusUpdate.psMemInfo = &psContext->sStatusMemInfo;
+		gc->sKRMTAStatusUpdate.ui32StatusValue = 1;
+		psContext->sCurrent.ui32Value = 1;
+
+		gc->sVAOMachine.psActiveVAO = &gc->sVAOMachine.sDefaultVAO;
+		gc->ui32DirtyState = GLES2_DIRTYFLAG_VAO_ATTRIB_POINTER;
+	}
+
+	for(i = 0; i < BR_NUM_BUFFERS; i++)
+	{
+		CreateBuffer(&g_asContexts[0], i);
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : Shutdown
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : Deletes the buffers, lets the TA finish and retires every ghost.
+					  No device memory may be left allocated.
+************************************************************************************/
+static IMG_VOID Shutdown(IMG_VOID)
+{
+	BR_MEMINFO *psAlloc, *psNext;
+	IMG_UINT32 i;
+
+	for(i = 0; i < BR_NUM_BUFFERS; i++)
+	{
+		DeleteBuffer(&g_asContexts[0], i);
+	}
+
+	for(i = 0; i < BR_NUM_CONTEXTS; i++)
+	{
+		KickTA(&g_asContexts[i]);
+
+		while(g_asContexts[i].ui32NumInFlight)
+		{
+			CompleteOldestKick(&g_asContexts[i]);
+		}
+
+		KRM_RemoveAttachmentPointReferences(&g_sSharedState.sBufferObjectKRM, &g_asContexts[i].sGC);
+	}
+
+	KRM_DestroyUnneededGhosts(&g_asContexts[0].sGC, &g_sSharedState.sBufferObjectKRM);
+	KRM_Destroy(&g_asContexts[0].sGC, &g_sSharedState.sBufferObjectKRM);
+
+	if(g_ui32NumLive)
+	{
+		Fail("%u device allocations leaked", g_ui32NumLive);
+	}
+
+	for(psAlloc = g_psAllocations; psAlloc; psAlloc = psNext)
+	{
+		psNext = psAlloc->psNext;
+
+		free(psAlloc->sMemInfo.pvLinAddr);
+		free(psAlloc);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : main
+ Inputs             : argc, argv
+ Outputs            : -
+ Returns            : 0 if every check passed
+ Description        : Runs the stress test
+************************************************************************************/
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Iterations = BR_DEFAULT_ITERATIONS, ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-n=", strlen("-n=")) == 0)
+		{
+			ui32Iterations = strtoul(argv[1] + strlen("-n="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else if (strcmp(argv[1], "-v") == 0)
+		{
+			g_bVerbose = IMG_TRUE;
+		}
+		else
+		{
+			fprintf(stderr, "Usage: bufobjrename [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	if(!InitialiseContexts())
+	{
+		fprintf(stderr, "error: couldn't initialise the kick resource manager\n");
+		return 1;
+	}
+
+	for(i = 0; i < ui32Iterations; i++)
+	{
+		BR_CONTEXT *psContext = &g_asContexts[Random(BR_NUM_CONTEXTS)];
+		IMG_UINT32 ui32Buffer = Random(BR_NUM_BUFFERS);
+		IMG_UINT32 ui32Op = Random(100);
+
+		if(ui32Op < 40)
+		{
+			Draw(psContext);
+		}
+		else if(ui32Op < 50)
+		{
+			KickTA(psContext);
+		}
+		else if(ui32Op < 62)
+		{
+			CompleteOldestKick(psContext);
+		}
+		else if(ui32Op < 85)
+		{
+			BufferSubData(psContext, ui32Buffer);
+		}
+		else if(ui32Op < 90)
+		{
+			BufferData(psContext, ui32Buffer);
+		}
+		else if(ui32Op < 99)
+		{
+			StartFrame(psContext);
+		}
+		else
+		{
+			DeleteBuffer(psContext, ui32Buffer);
+			CreateBuffer(psContext, ui32Buffer);
+		}
+	}
+
+	Shutdown();
+
+	printf("%u operations (seed %u): %u draws, %u validations, %u kicks, %u updates, %u respecifications, %u deletions\n",
+		   ui32Iterations, ui32Seed, g_sStats.ui32Draws, g_sStats.ui32Validations, g_sStats.ui32Kicks,
+		   g_sStats.ui32Updates, g_sStats.ui32Respecifies, g_sStats.ui32Deletes);
+	printf("%u buffer moves, %u waits for the TA, %u device allocations, at most %u live\n",
+		   g_sSharedState.ui32BufObjRenameStamp, g_sStats.ui32Waits, g_sStats.ui32Allocs, g_sStats.ui32PeakLive);
+
+	if(g_ui32NumErrors)
+	{
+		printf("FAILED: %u errors\n", g_ui32NumErrors);
+		return 1;
+	}
+
+	printf("PASSED\n");
+
+	return 0;
+}
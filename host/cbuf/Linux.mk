@@ -0,0 +1,50 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the driver's TA circular buffers against a mocked TA. Random
+# frames fill the buffers until they wrap and stall, and the TA checks every
+# block it consumes is as written. The stall counts and the growth of
+# stalling buffers at the end of each frame are checked against a model.
+# Run it with no arguments; it exits non-zero if any check fails.
+#
+
+modules := cbuf
+
+cbuf_type := host_executable
+
+cbuf_src = \
+ main.c \
+ $(TOP)/eurasiacon/common/buffers.c \
+ $(TOP)/eurasiacon/opengles2/tabuffer.c
+
+# hostcontext.h stands in for the driver's context.h. DEBUG turns on the
+# buffer statistics and the consistency checks buffers.c prints. The EGL
+# headers expect services.h ahead of them, and mark exports with the psp2
+# compiler's __declspec. CBUF_GetBufferDeviceAddress, which the test doesn't
+# call, keeps addresses in 32 bits. The psp2 event handle passed to
+# CBUF_CreateBuffer is an integer.
+cbuf_cflags := \
+ -DLINUX -DUSER -DDEBUG -DOGLES2_MODULE -DSUPPORT_OPENGLES2 -DPDS_BUILD_OPENGLES -DSUPPORT_SGX -DSUPPORT_SGX543 \
+ -DUSE_GCC__thread_KEYWORD \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h -include services.h \
+ -D'__declspec(x)=' -Wno-pointer-to-int-cast -Wno-int-conversion \
+ -include $(TOP)/host/cbuf/hostcontext.h
+
+cbuf_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ include/gpu_es4/eurasia/services4/include \
+ include/gpu_es4/eurasia/services4/system/psp2 \
+ include/gpu_es4/eurasia/services4/srvclient/devices/sgx \
+ codegen/pds codegen/pixevent codegen/usegen \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ common/tls
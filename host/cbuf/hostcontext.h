@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the TA buffer test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of tabuffer.c and buffers.c in place
+ *                of the driver's context.h, whose include guard it defines.
+ *                The circular buffers are the driver's own buffers.h. The
+ *                context keeps only what ResizeTABuffer and
+ *                GrowStalledTABuffers read, and the TA kick comes from the
+ *                harness.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "eglapi.h"
+#include "pvr_debug.h"
+#include "sgxdefs.h"
+
+#include "buffers.h"
+
+
+/* As context.h */
+#define MIN(a,b) ((a)<(b)?(a):(b))
+
+#define GLES_ASSERT(expr) PVR_ASSERT(expr)
+
+#define GLES2_SCHEDULE_HW_WAIT_FOR_TA		0x00000002
+
+/* As misc.h */
+typedef struct GLESAppHintsRec
+{
+	IMG_UINT32 ui32MaxVertexBufferSize;
+	IMG_UINT32 ui32MaxIndexBufferSize;
+	IMG_UINT32 ui32MaxPDSVertBufferSize;
+	IMG_UINT32 ui32MaxVDMBufferSize;
+	IMG_UINT32 ui32BufferStallGrowThreshold;
+
+} GLESAppHints;
+
+/* As sgxapi.h */
+typedef struct HostKickTARec
+{
+	SGX_STATUS_UPDATE asTAStatusUpdate[SGX_MAX_TA_STATUS_VALS];
+
+} HostKickTA;
+
+/* As context.h */
+typedef struct GLES2Context_TAG
+{
+	PVRSRV_DEV_DATA *ps3DDevData;
+
+	SrvSysContext *psSysContext;
+
+	EGLRenderSurface *psRenderSurface;
+
+	CircularBuffer *apsBuffers[CBUF_NUM_BUFFERS];
+
+	HostKickTA sKickTA;
+
+	GLESAppHints sAppHints;
+
+} GLES2Context;
+
+/* services.h only declares the psp2 form, with the per process reference, for __psp2__ */
+#define PVRSRVAllocDeviceMem		HostAllocDeviceMem
+
+PVRSRV_ERROR HostAllocDeviceMem(const PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hDevMemHeap, IMG_UINT32 ui32Attribs,
+								IMG_SIZE_T ui32Size, IMG_SIZE_T ui32Alignment, IMG_SID hPerProcRef,
+								PVRSRV_CLIENT_MEM_INFO **ppsMemInfo);
+
+/* As context.h */
+IMG_EGLERROR ScheduleTA(GLES2Context *gc, EGLRenderSurface *psRenderSurface, IMG_UINT32 ui32KickFlags);
+IMG_BOOL ResizeTABuffer(GLES2Context *gc, IMG_UINT32 ui32BufferType, IMG_UINT32 ui32SizeInBytes);
+IMG_VOID GrowStalledTABuffers(GLES2Context *gc);
+
+#endif /* _CONTEXT_ */
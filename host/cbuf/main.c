@@ -0,0 +1,1492 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLES2 TA circular buffer test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's buffers.c and tabuffer.c against a
+ *                mocked TA, device memory and GPU signal wait.
+ *
+ *                Each run creates the six TA buffers as InitContext does,
+ *                at random sizes, with random apphint maximums and stall
+ *                threshold, and draws random frames. A draw asks for
+ *                vertex and index space as GetVertexIndexBufferSpace does,
+ *                kicking and retrying when either runs out, then for PDS
+ *                and VDM space. Every block handed out must lie inside its
+ *                buffer, clear of anything the TA has yet to consume, and
+ *                PDS blocks must be cache line aligned. Blocks are filled
+ *                with a tag the TA checks when it consumes them, along
+ *                with the stream link the VDM buffer leaves when it wraps.
+ *
+ *                Kicks complete in order, at random points between draws
+ *                or while the driver waits on the GPU signal, when they
+ *                write each buffer's read offset through the status
+ *                update the kick was given. A wait with no kick
+ *                outstanding would never return. Each request that waits
+ *                must count one stall and the time the waits took, and
+ *                the high water mark must cover what is outstanding.
+ *
+ *                At the end of each frame GrowStalledTABuffers must grow
+ *                exactly the buffers that stalled at least the threshold
+ *                number of times, had room to grow and nothing left to
+ *                kick, to double their size up to the maximum, keeping
+ *                their statistics and retargeting the status update.
+ *                Allocations fail at random while it runs, which must
+ *                leave the old buffer in place and leak nothing.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+
+#define CB_DEFAULT_RUNS			300
+#define CB_DEFAULT_FRAMES		12
+
+#define CB_MAX_DRAWS			60
+
+/* The buffers InitContext creates, up to the unused auxiliary one */
+#define CB_NUM_BUFFERS			CBUF_TYPE_PDS_AUXILIARY_PREGEN_BUFFER
+
+#define CB_MAX_BLOCKS			8192
+#define CB_MAX_KICKS			16
+#define CB_MAX_ALLOCS			32
+
+#define CB_DEVADDR_BASE			0x10000000U
+#define CB_DEVADDR_SPAN			0x00100000U
+
+/* Longest a wait on the GPU signal takes */
+#define CB_MAX_WAIT_US			200
+
+/* Waits with no kick outstanding before giving up on the driver */
+#define CB_MAX_IDLE_WAITS		1000
+
+#define CB_TAG_STEP				0x9E3779B9U
+
+typedef struct HostAllocRec
+{
+	/* First, so the driver's mem info leads back to the allocation */
+	PVRSRV_CLIENT_MEM_INFO sMemInfo;
+
+	IMG_HANDLE hHeap;
+	IMG_BOOL bLive;
+
+} HostAlloc;
+
+typedef struct HostBlockRec
+{
+	IMG_UINT32 ui32Offset;
+	IMG_UINT32 ui32Bytes;
+	IMG_UINT32 ui32Tag;
+
+	/* A VDM stream link, rather than tagged data */
+	IMG_BOOL bLink;
+
+} HostBlock;
+
+typedef struct HostTABufferRec
+{
+	/*
+		Blocks in the order the TA consumes them. The counts only ever grow,
+		and each is at most the one before it.
+	*/
+	HostBlock asBlocks[CB_MAX_BLOCKS];
+	IMG_UINT32 ui32NumWritten;
+	IMG_UINT32 ui32NumCommitted;
+	IMG_UINT32 ui32NumConsumed;
+
+	/* The block being written, from CBUF_GetBufferSpace */
+	IMG_UINT32 ui32LockedOffset;
+
+	IMG_UINT32 ui32MaxRequestDWords;
+
+	/* Requests which waited, since GrowStalledTABuffers last looked */
+	IMG_UINT32 ui32Stalls;
+
+} HostTABuffer;
+
+typedef struct HostKickRec
+{
+	SGX_STATUS_UPDATE asStatus[CB_NUM_BUFFERS];
+
+	/* Blocks the TA will have consumed when the kick completes */
+	IMG_UINT32 aui32NumConsumed[CB_NUM_BUFFERS];
+
+} HostKick;
+
+static GLES2Context g_sContext;
+static SrvSysContext g_sSysContext;
+static PVRSRV_DEV_DATA g_sDevData;
+static EGLRenderSurface g_sRenderSurface;
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+/* The heaps, and the GPU signal's TLS slot, are just addresses */
+static IMG_UINT32 g_ui32GeneralHeap, g_ui32PDSVertexHeap, g_ui32SyncInfoHeap;
+static IMG_UINT32 g_ui32SignalTLS;
+
+static HostAlloc g_asAllocs[CB_MAX_ALLOCS];
+static IMG_UINT32 g_ui32NumAllocs, g_ui32NextDevAddr, g_ui32NextKernelHandle;
+static IMG_UINT32 g_ui32NumUserAllocs, g_ui32NumSyncInfos;
+
+static HostTABuffer g_asTABuffers[CB_NUM_BUFFERS];
+
+static HostKick g_asKicks[CB_MAX_KICKS];
+static IMG_UINT32 g_ui32KickHead, g_ui32NumKicks;
+
+static IMG_UINT32 g_ui32Clock, g_ui32NumWaits, g_ui32NumIdleWaits;
+
+/* Allocations fail one in this many times while buffers grow */
+static IMG_UINT32 g_ui32AllocFailRate;
+static IMG_BOOL g_bInjectFailures, g_bFailureInjected;
+
+/* Buffers resized while GrowStalledTABuffers ran, and which of them failed */
+static IMG_UINT32 g_ui32NumResizes, g_ui32ResizeFailMask;
+
+static IMG_UINT32 g_ui32NumDraws, g_ui32NumTAKicks, g_ui32NumStalls, g_ui32NumWraps, g_ui32NumLinks;
+static IMG_UINT32 g_ui32NumGrows, g_ui32NumFailedGrows;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random runs (default 300).\n"
+"-frames=N   Frames per run (default 12).\n"
+"-seed=N     Seed for the runs (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : InjectFailure
+ Inputs             : -
+ Outputs            : -
+ Returns            : Whether an allocation should fail
+ Description        : UTILITY
+************************************************************************************/
+static IMG_BOOL InjectFailure(IMG_VOID)
+{
+	if (!g_bInjectFailures || Random(g_ui32AllocFailRate) != 0)
+	{
+		return IMG_FALSE;
+	}
+
+	g_bFailureInjected = IMG_TRUE;
+
+	if (g_ui32NumResizes)
+	{
+		g_ui32ResizeFailMask |= 1U << (g_ui32NumResizes - 1);
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetLinkValue
+ Inputs             : psBuffer
+ Outputs            : -
+ Returns            : The stream link to the start of a VDM buffer
+ Description        : As CheckTACtrlBufferSpace in buffers.c
+************************************************************************************/
+static IMG_UINT32 GetLinkValue(const CircularBuffer *psBuffer)
+{
+	return EURASIA_TAOBJTYPE_LINK | ((psBuffer->uDevVirtBase.uiAddr >> EURASIA_TASTRMLINK_ADDR_ALIGNSHIFT) << EURASIA_TASTRMLINK_ADDR_SHIFT);
+}
+
+
+/***********************************************************************************
+ Function Name      : GetOutstandingBytes
+ Inputs             : psBuffer
+ Outputs            : -
+ Returns            : Bytes written that the TA has yet to consume
+ Description        : UTILITY
+************************************************************************************/
+static IMG_UINT32 GetOutstandingBytes(const CircularBuffer *psBuffer)
+{
+	IMG_UINT32 ui32ReadOffset = *psBuffer->pui32ReadOffset;
+
+	if (ui32ReadOffset <= psBuffer->ui32CurrentWriteOffsetInBytes)
+	{
+		return psBuffer->ui32CurrentWriteOffsetInBytes - ui32ReadOffset;
+	}
+
+	return psBuffer->ui32BufferLimitInBytes - (ui32ReadOffset - psBuffer->ui32CurrentWriteOffsetInBytes);
+}
+
+
+/*
+** Services mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	IMG_CHAR acMessage[256];
+	va_list sArgs;
+
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+
+	if (!(ui32DebugLevel & (DBGPRIV_ERROR | DBGPRIV_WARNING)))
+	{
+		return;
+	}
+
+	va_start(sArgs, pszFormat);
+	vsnprintf(acMessage, sizeof(acMessage), pszFormat, sArgs);
+	va_end(sArgs);
+
+	/* Growing a buffer warns, and failing to grow one is an error */
+	if (strncmp(acMessage, "ResizeTABuffer: Resized", strlen("ResizeTABuffer: Resized")) == 0 ||
+		((ui32DebugLevel & DBGPRIV_ERROR) && g_bFailureInjected))
+	{
+		return;
+	}
+
+	Fail("driver reported: %s", acMessage);
+}
+
+IMG_EXPORT IMG_PVOID IMG_CALLCONV PVRSRVAllocUserModeMem(IMG_SIZE_T ui32Size)
+{
+	if (InjectFailure())
+	{
+		return IMG_NULL;
+	}
+
+	g_ui32NumUserAllocs++;
+
+	return malloc(ui32Size);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVFreeUserModeMem(IMG_PVOID pvMem)
+{
+	if (pvMem)
+	{
+		g_ui32NumUserAllocs--;
+
+		free(pvMem);
+	}
+}
+
+IMG_EXPORT IMG_VOID PVRSRVMemSet(IMG_VOID *pvDest, IMG_UINT8 ui8Value, IMG_SIZE_T ui32Size)
+{
+	memset(pvDest, ui8Value, ui32Size);
+}
+
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV PVRSRVAllocSyncInfo(IMG_CONST PVRSRV_DEV_DATA *psDevData,
+														 PVRSRV_CLIENT_SYNC_INFO **ppsSyncInfo)
+{
+	if (psDevData != &g_sDevData)
+	{
+		Fail("sync info allocated on the wrong device");
+	}
+
+	if (InjectFailure())
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	*ppsSyncInfo = calloc(1, sizeof(PVRSRV_CLIENT_SYNC_INFO));
+
+	g_ui32NumSyncInfos++;
+
+	return PVRSRV_OK;
+}
+
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV PVRSRVFreeSyncInfo(IMG_CONST PVRSRV_DEV_DATA *psDevData,
+														PVRSRV_CLIENT_SYNC_INFO *psSyncInfo)
+{
+	PVR_UNREFERENCED_PARAMETER(psDevData);
+
+	g_ui32NumSyncInfos--;
+
+	free(psSyncInfo);
+
+	return PVRSRV_OK;
+}
+
+IMG_EXPORT IMG_UINT32 PVRSRVClockus(void)
+{
+	return g_ui32Clock;
+}
+
+void *sceKernelGetTLSAddr(int key)
+{
+	if (key != 0x44)
+	{
+		Fail("TLS slot 0x%x asked for, not the GPU signal's", key);
+	}
+
+	return &g_ui32SignalTLS;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostAllocDeviceMem
+ Inputs             : psDevData, hDevMemHeap, ui32Attribs, ui32Size, ui32Alignment,
+					  hPerProcRef
+ Outputs            : ppsMemInfo
+ Returns            : Success
+ Description        : Mock of PVRSRVAllocDeviceMem. Memory starts out as garbage,
+					  at a device address never used before in the run.
+************************************************************************************/
+PVRSRV_ERROR HostAllocDeviceMem(const PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hDevMemHeap, IMG_UINT32 ui32Attribs,
+								IMG_SIZE_T ui32Size, IMG_SIZE_T ui32Alignment, IMG_SID hPerProcRef,
+								PVRSRV_CLIENT_MEM_INFO **ppsMemInfo)
+{
+	HostAlloc *psAlloc;
+	IMG_UINT32 i;
+
+	PVR_UNREFERENCED_PARAMETER(ui32Attribs);
+
+	if (psDevData != &g_sDevData || hPerProcRef != g_sSysContext.hPerProcRef)
+	{
+		Fail("device memory allocated on the wrong device or process");
+	}
+
+	if (hDevMemHeap != (IMG_HANDLE)&g_ui32GeneralHeap &&
+		hDevMemHeap != (IMG_HANDLE)&g_ui32PDSVertexHeap &&
+		hDevMemHeap != (IMG_HANDLE)&g_ui32SyncInfoHeap)
+	{
+		Fail("device memory allocated from an unknown heap");
+	}
+
+	if (!ui32Size || ui32Size > CB_DEVADDR_SPAN || !ui32Alignment || (CB_DEVADDR_SPAN % ui32Alignment) != 0)
+	{
+		Fail("bad device allocation: %u bytes aligned to %u", (IMG_UINT32)ui32Size, (IMG_UINT32)ui32Alignment);
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (InjectFailure())
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (i = 0; i < CB_MAX_ALLOCS && g_asAllocs[i].bLive; i++);
+
+	if (i == CB_MAX_ALLOCS)
+	{
+		Fail("more than %u device allocations live", CB_MAX_ALLOCS);
+
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	psAlloc = &g_asAllocs[i];
+
+	memset(psAlloc, 0, sizeof(*psAlloc));
+
+	psAlloc->sMemInfo.pvLinAddr = malloc(ui32Size);
+	psAlloc->sMemInfo.sDevVAddr.uiAddr = g_ui32NextDevAddr;
+	psAlloc->sMemInfo.uAllocSize = ui32Size;
+	psAlloc->sMemInfo.hKernelMemInfo = ++g_ui32NextKernelHandle;
+	psAlloc->hHeap = hDevMemHeap;
+	psAlloc->bLive = IMG_TRUE;
+
+	memset(psAlloc->sMemInfo.pvLinAddr, 0xCD, ui32Size);
+
+	g_ui32NextDevAddr += CB_DEVADDR_SPAN;
+	g_ui32NumAllocs++;
+
+	*ppsMemInfo = &psAlloc->sMemInfo;
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : PVRSRVFreeDeviceMem
+ Inputs             : psDevData, psMemInfo
+ Outputs            : -
+ Returns            : Success
+ Description        : The memory must be live. Neither a TA buffer's blocks the TA
+					  has yet to consume, nor a status update a kick has yet to
+					  write, may be in it.
+************************************************************************************/
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV PVRSRVFreeDeviceMem(IMG_CONST PVRSRV_DEV_DATA *psDevData,
+														 PVRSRV_CLIENT_MEM_INFO *psMemInfo)
+{
+	HostAlloc *psAlloc = (HostAlloc *)psMemInfo;
+	IMG_UINT32 i, j;
+
+	PVR_UNREFERENCED_PARAMETER(psDevData);
+
+	if (psAlloc < g_asAllocs || psAlloc >= &g_asAllocs[CB_MAX_ALLOCS] || !psAlloc->bLive)
+	{
+		Fail("freed device memory that isn't a live allocation");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		const HostTABuffer *psTABuffer = &g_asTABuffers[i];
+
+		if (g_sContext.apsBuffers[i] && g_sContext.apsBuffers[i]->psMemInfo == psMemInfo &&
+			psTABuffer->ui32NumConsumed != psTABuffer->ui32NumWritten)
+		{
+			Fail("%s buffer freed with %u blocks the TA has yet to consume", pszBufferNames[i],
+				 psTABuffer->ui32NumWritten - psTABuffer->ui32NumConsumed);
+		}
+	}
+
+	for (i = 0; i < g_ui32NumKicks; i++)
+	{
+		const HostKick *psKick = &g_asKicks[(g_ui32KickHead + i) % CB_MAX_KICKS];
+
+		for (j = 0; j < CB_NUM_BUFFERS; j++)
+		{
+			if (psKick->asStatus[j].sCtlStatus.sStatusDevAddr.uiAddr == psMemInfo->sDevVAddr.uiAddr)
+			{
+				Fail("%s buffer status freed with a kick still to write it", pszBufferNames[j]);
+			}
+		}
+	}
+
+	free(psAlloc->sMemInfo.pvLinAddr);
+
+	psAlloc->bLive = IMG_FALSE;
+
+	g_ui32NumAllocs--;
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostConsumeBlocks
+ Inputs             : ui32BufferType, ui32NumConsumed
+ Outputs            : -
+ Returns            : -
+ Description        : The TA consumes a buffer's blocks up to ui32NumConsumed, each of
+					  which must still hold what was written
+************************************************************************************/
+static IMG_VOID HostConsumeBlocks(IMG_UINT32 ui32BufferType, IMG_UINT32 ui32NumConsumed)
+{
+	HostTABuffer *psTABuffer = &g_asTABuffers[ui32BufferType];
+	const CircularBuffer *psBuffer = g_sContext.apsBuffers[ui32BufferType];
+	IMG_UINT32 i;
+
+	for (; psTABuffer->ui32NumConsumed < ui32NumConsumed; psTABuffer->ui32NumConsumed++)
+	{
+		const HostBlock *psBlock = &psTABuffer->asBlocks[psTABuffer->ui32NumConsumed % CB_MAX_BLOCKS];
+		const IMG_UINT32 *pui32Data = psBuffer->pui32BufferBase + (psBlock->ui32Offset >> 2);
+
+		if (psBlock->bLink)
+		{
+			if (pui32Data[0] != GetLinkValue(psBuffer))
+			{
+				Fail("TA found 0x%08x, not a stream link, at the end of the %s buffer",
+					 pui32Data[0], pszBufferNames[ui32BufferType]);
+			}
+
+			continue;
+		}
+
+		for (i = 0; i < (psBlock->ui32Bytes >> 2); i++)
+		{
+			if (pui32Data[i] != psBlock->ui32Tag + i * CB_TAG_STEP)
+			{
+				Fail("TA found dword %u of the %s block at 0x%x overwritten",
+					 i, pszBufferNames[ui32BufferType], psBlock->ui32Offset);
+
+				break;
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostCompleteKick
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : The oldest kick completes. The TA consumes the blocks it was
+					  given and writes each buffer's read offset.
+************************************************************************************/
+static IMG_VOID HostCompleteKick(IMG_VOID)
+{
+	HostKick *psKick = &g_asKicks[g_ui32KickHead];
+	IMG_UINT32 i, j;
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		const SGX_STATUS_UPDATE *psStatus = &psKick->asStatus[i];
+
+		for (j = 0; j < CB_MAX_ALLOCS; j++)
+		{
+			if (g_asAllocs[j].bLive && g_asAllocs[j].sMemInfo.sDevVAddr.uiAddr == psStatus->sCtlStatus.sStatusDevAddr.uiAddr)
+			{
+				break;
+			}
+		}
+
+		if (j == CB_MAX_ALLOCS)
+		{
+			Fail("%s buffer status update to freed memory", pszBufferNames[i]);
+
+			continue;
+		}
+
+		if (g_asAllocs[j].sMemInfo.hKernelMemInfo != psStatus->hKernelMemInfo)
+		{
+			Fail("%s buffer status update names another allocation's kernel mem info", pszBufferNames[i]);
+		}
+
+		HostConsumeBlocks(i, psKick->aui32NumConsumed[i]);
+
+		*(IMG_UINT32 *)g_asAllocs[j].sMemInfo.pvLinAddr = psStatus->sCtlStatus.ui32StatusValue;
+	}
+
+	g_ui32KickHead = (g_ui32KickHead + 1) % CB_MAX_KICKS;
+	g_ui32NumKicks--;
+}
+
+
+/*
+** PSP2 mocks
+*/
+
+int sceGpuSignalWait(void *unkTLS, unsigned int timeout)
+{
+	PVR_UNREFERENCED_PARAMETER(timeout);
+
+	if (unkTLS != &g_ui32SignalTLS)
+	{
+		Fail("waited on a GPU signal other than the context's");
+	}
+
+	g_ui32NumWaits++;
+	g_ui32Clock += 1 + Random(CB_MAX_WAIT_US);
+
+	if (!g_ui32NumKicks)
+	{
+		if (++g_ui32NumIdleWaits == CB_MAX_IDLE_WAITS)
+		{
+			fprintf(stderr, "error: driver waits on the GPU with no kick outstanding\n");
+			exit(1);
+		}
+
+		return 1;
+	}
+
+	/* Otherwise the wait times out */
+	if (Random(2))
+	{
+		HostCompleteKick();
+
+		return SCE_OK;
+	}
+
+	return 1;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostCheckFree
+ Inputs             : ui32BufferType, ui32Offset, ui32Bytes
+ Outputs            : -
+ Returns            : -
+ Description        : Space about to be written must be clear of every block the TA
+					  has yet to consume
+************************************************************************************/
+static IMG_VOID HostCheckFree(IMG_UINT32 ui32BufferType, IMG_UINT32 ui32Offset, IMG_UINT32 ui32Bytes)
+{
+	const HostTABuffer *psTABuffer = &g_asTABuffers[ui32BufferType];
+	IMG_UINT32 i;
+
+	for (i = psTABuffer->ui32NumConsumed; i != psTABuffer->ui32NumWritten; i++)
+	{
+		const HostBlock *psBlock = &psTABuffer->asBlocks[i % CB_MAX_BLOCKS];
+
+		if (ui32Offset < psBlock->ui32Offset + psBlock->ui32Bytes && psBlock->ui32Offset < ui32Offset + ui32Bytes)
+		{
+			Fail("%s space 0x%x+0x%x handed out over a block at 0x%x+0x%x the TA has yet to consume",
+				 pszBufferNames[ui32BufferType], ui32Offset, ui32Bytes, psBlock->ui32Offset, psBlock->ui32Bytes);
+
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostCheckLink
+ Inputs             : ui32WriteOffset
+ Outputs            : -
+ Returns            : -
+ Description        : If the VDM buffer wrapped from ui32WriteOffset, there must be
+					  a stream link there, in space nothing else is using
+************************************************************************************/
+static IMG_VOID HostCheckLink(IMG_UINT32 ui32WriteOffset)
+{
+	const CircularBuffer *psBuffer = g_sContext.apsBuffers[CBUF_TYPE_VDM_CTRL_BUFFER];
+	HostTABuffer *psTABuffer = &g_asTABuffers[CBUF_TYPE_VDM_CTRL_BUFFER];
+	HostBlock *psBlock;
+
+	if (psBuffer->ui32CurrentWriteOffsetInBytes || !ui32WriteOffset)
+	{
+		return;
+	}
+
+	g_ui32NumLinks++;
+
+	if (ui32WriteOffset + 4 > psBuffer->ui32BufferLimitInBytes)
+	{
+		Fail("VDM buffer stream link at 0x%x is past the end", ui32WriteOffset);
+
+		return;
+	}
+
+	if (psBuffer->pui32BufferBase[ui32WriteOffset >> 2] != GetLinkValue(psBuffer))
+	{
+		Fail("VDM buffer wrapped without a stream link");
+	}
+
+	HostCheckFree(CBUF_TYPE_VDM_CTRL_BUFFER, ui32WriteOffset, 4);
+
+	if (psTABuffer->ui32NumWritten - psTABuffer->ui32NumConsumed == CB_MAX_BLOCKS)
+	{
+		Fail("more than %u blocks outstanding", CB_MAX_BLOCKS);
+
+		return;
+	}
+
+	psBlock = &psTABuffer->asBlocks[psTABuffer->ui32NumWritten++ % CB_MAX_BLOCKS];
+
+	psBlock->ui32Offset = ui32WriteOffset;
+	psBlock->ui32Bytes = 4;
+	psBlock->bLink = IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDoKickTA
+ Inputs             : gc, bLastInScene
+ Outputs            : -
+ Returns            : -
+ Description        : As DoKickTA in sgxif.c. Each buffer's committed blocks go to the
+					  TA, which will write the committed primitive offset as the
+					  read offset when it completes.
+************************************************************************************/
+static IMG_VOID HostDoKickTA(GLES2Context *gc, IMG_BOOL bLastInScene)
+{
+	CircularBuffer *psVDMBuffer = gc->apsBuffers[CBUF_TYPE_VDM_CTRL_BUFFER];
+	HostKick *psKick;
+	IMG_UINT32 ui32WriteOffset, i;
+
+	if (g_ui32NumKicks == CB_MAX_KICKS)
+	{
+		HostCompleteKick();
+	}
+
+	psKick = &g_asKicks[(g_ui32KickHead + g_ui32NumKicks) % CB_MAX_KICKS];
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		psKick->asStatus[i] = gc->sKickTA.asTAStatusUpdate[i];
+		psKick->asStatus[i].sCtlStatus.ui32StatusValue = gc->apsBuffers[i]->ui32CommittedPrimOffsetInBytes;
+		psKick->aui32NumConsumed[i] = g_asTABuffers[i].ui32NumCommitted;
+	}
+
+	g_ui32NumKicks++;
+	g_ui32NumTAKicks++;
+
+	CBUF_UpdateBufferCommittedHWOffsets(gc->apsBuffers, bLastInScene);
+
+	ui32WriteOffset = psVDMBuffer->ui32CurrentWriteOffsetInBytes;
+
+	CBUF_UpdateTACtrlKickBase(gc->apsBuffers);
+
+	HostCheckLink(ui32WriteOffset);
+
+	if ((psVDMBuffer->ui32CurrentWriteOffsetInBytes & ((1U << EUR_CR_VDM_CTRL_STREAM_BASE_ALIGNSHIFT) - 1)) ||
+		psVDMBuffer->uTACtrlKickDevAddr.uiAddr != psVDMBuffer->uDevVirtBase.uiAddr + psVDMBuffer->ui32CurrentWriteOffsetInBytes)
+	{
+		Fail("next TA kick's control stream base isn't the aligned VDM write offset");
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ScheduleTA
+ Inputs             : gc, psRenderSurface, ui32KickFlags
+ Outputs            : -
+ Returns            : Success
+ Description        : Kicks the TA, then waits for every kick to complete if asked to
+************************************************************************************/
+IMG_EGLERROR ScheduleTA(GLES2Context *gc, EGLRenderSurface *psRenderSurface, IMG_UINT32 ui32KickFlags)
+{
+	if (gc != &g_sContext || psRenderSurface != gc->psRenderSurface)
+	{
+		Fail("TA scheduled on the wrong context or surface");
+	}
+
+	if (ui32KickFlags & ~GLES2_SCHEDULE_HW_WAIT_FOR_TA)
+	{
+		Fail("TA scheduled with unexpected flags 0x%x", ui32KickFlags);
+	}
+
+	HostDoKickTA(gc, IMG_FALSE);
+
+	if (ui32KickFlags & GLES2_SCHEDULE_HW_WAIT_FOR_TA)
+	{
+		/* Only ResizeTABuffer waits */
+		g_ui32NumResizes++;
+
+		while (g_ui32NumKicks)
+		{
+			HostCompleteKick();
+		}
+	}
+
+	return IMG_EGL_NO_ERROR;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostKickLimit
+ Inputs             : pvContext, bLastInScene
+ Outputs            : -
+ Returns            : -
+ Description        : As KickLimit_ScheduleTA, when a buffer passes its single kick
+					  limit
+************************************************************************************/
+static IMG_VOID HostKickLimit(IMG_VOID *pvContext, IMG_BOOL bLastInScene)
+{
+	if (pvContext != &g_sContext)
+	{
+		Fail("kick limit reached on the wrong context");
+	}
+
+	HostDoKickTA(&g_sContext, bLastInScene);
+}
+
+
+/***********************************************************************************
+ Function Name      : HostGetSpace
+ Inputs             : gc, ui32BufferType, ui32DWords
+ Outputs            : -
+ Returns            : Space for the block, or IMG_NULL
+ Description        : CBUF_GetBufferSpace, checking where the space is and what any
+					  wait for it cost
+************************************************************************************/
+static IMG_UINT32 *HostGetSpace(GLES2Context *gc, IMG_UINT32 ui32BufferType, IMG_UINT32 ui32DWords)
+{
+	CircularBuffer *psBuffer = gc->apsBuffers[ui32BufferType];
+	HostTABuffer *psTABuffer = &g_asTABuffers[ui32BufferType];
+	IMG_UINT32 ui32Waits = g_ui32NumWaits, ui32Clock = g_ui32Clock;
+	IMG_UINT32 ui32StallCount = psBuffer->ui32StallCount;
+	IMG_UINT32 ui32TotalStallCount = psBuffer->ui32TotalStallCount;
+	IMG_UINT32 ui32StallTime = psBuffer->ui32StallTimeInUs;
+	IMG_UINT32 ui32WriteOffset = psBuffer->ui32CurrentWriteOffsetInBytes;
+	IMG_UINT32 ui32Offset, ui32Bytes = ui32DWords << 2;
+	IMG_UINT32 *pui32Space;
+	IMG_BOOL bStalled;
+
+	pui32Space = CBUF_GetBufferSpace(gc->apsBuffers, ui32DWords, ui32BufferType, IMG_FALSE);
+
+	g_ui32NumIdleWaits = 0;
+
+	/* However many times a request polls, it counts as one stall */
+	bStalled = (g_ui32NumWaits != ui32Waits) ? IMG_TRUE : IMG_FALSE;
+
+	if (psBuffer->ui32StallCount != ui32StallCount + bStalled ||
+		psBuffer->ui32TotalStallCount != ui32TotalStallCount + bStalled)
+	{
+		Fail("%s request %s, but the stall count went from %u to %u", pszBufferNames[ui32BufferType],
+			 bStalled ? "waited" : "didn't wait", ui32StallCount, psBuffer->ui32StallCount);
+	}
+
+	if (psBuffer->ui32StallTimeInUs - ui32StallTime != g_ui32Clock - ui32Clock)
+	{
+		Fail("%s request waited %uus, but the stall time went up %uus", pszBufferNames[ui32BufferType],
+			 g_ui32Clock - ui32Clock, psBuffer->ui32StallTimeInUs - ui32StallTime);
+	}
+
+	psTABuffer->ui32Stalls += bStalled;
+	g_ui32NumStalls += bStalled;
+
+	if (!pui32Space)
+	{
+		return IMG_NULL;
+	}
+
+	ui32Offset = (IMG_UINT32)((IMG_UINT8 *)pui32Space - (IMG_UINT8 *)psBuffer->pui32BufferBase);
+
+	if (ui32Offset < ui32WriteOffset)
+	{
+		g_ui32NumWraps++;
+	}
+
+	if (ui32Offset != psBuffer->ui32CurrentWriteOffsetInBytes || ui32Offset + ui32Bytes > psBuffer->ui32BufferLimitInBytes)
+	{
+		Fail("%s space 0x%x+0x%x isn't at the write offset inside the buffer", pszBufferNames[ui32BufferType], ui32Offset, ui32Bytes);
+
+		return pui32Space;
+	}
+
+	if (ui32BufferType == CBUF_TYPE_VDM_CTRL_BUFFER)
+	{
+		HostCheckLink(ui32WriteOffset);
+
+		/* The terminate is written without asking for space, and the VDM fetches a burst beyond it */
+		ui32Bytes += (VDM_CTRL_TERMINATE_DWORDS << 2) + EURASIA_VDM_CTRL_STREAM_BURST_SIZE;
+
+		if (ui32Offset + ui32Bytes > psBuffer->ui32BufferLimitInBytes)
+		{
+			Fail("no room for the terminate and guard band after VDM space at 0x%x", ui32Offset);
+		}
+	}
+	else if (ui32BufferType != CBUF_TYPE_VERTEX_DATA_BUFFER && ui32BufferType != CBUF_TYPE_INDEX_DATA_BUFFER)
+	{
+		if (ui32Offset % EURASIA_VDMPDS_BASEADDR_CACHEALIGN)
+		{
+			Fail("%s space at 0x%x isn't cache line aligned", pszBufferNames[ui32BufferType], ui32Offset);
+		}
+	}
+
+	HostCheckFree(ui32BufferType, ui32Offset, ui32Bytes);
+
+	psTABuffer->ui32LockedOffset = ui32Offset;
+
+	return pui32Space;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostPutSpace
+ Inputs             : gc, ui32BufferType, pui32Space, ui32DWords
+ Outputs            : -
+ Returns            : -
+ Description        : Writes a tagged block of up to ui32DWords into space from
+					  HostGetSpace, and CBUF_UpdateBufferPos
+************************************************************************************/
+static IMG_VOID HostPutSpace(GLES2Context *gc, IMG_UINT32 ui32BufferType, IMG_UINT32 *pui32Space, IMG_UINT32 ui32DWords)
+{
+	CircularBuffer *psBuffer = gc->apsBuffers[ui32BufferType];
+	HostTABuffer *psTABuffer = &g_asTABuffers[ui32BufferType];
+	IMG_UINT32 ui32WriteOffset = psBuffer->ui32CurrentWriteOffsetInBytes;
+	IMG_UINT32 ui32Outstanding, i;
+
+	if (ui32DWords)
+	{
+		HostBlock *psBlock;
+
+		if (psTABuffer->ui32NumWritten - psTABuffer->ui32NumConsumed == CB_MAX_BLOCKS)
+		{
+			Fail("more than %u blocks outstanding", CB_MAX_BLOCKS);
+
+			return;
+		}
+
+		psBlock = &psTABuffer->asBlocks[psTABuffer->ui32NumWritten++ % CB_MAX_BLOCKS];
+
+		psBlock->ui32Offset = psTABuffer->ui32LockedOffset;
+		psBlock->ui32Bytes = ui32DWords << 2;
+		psBlock->ui32Tag = Random(0xFFFFFFFFU);
+		psBlock->bLink = IMG_FALSE;
+
+		for (i = 0; i < ui32DWords; i++)
+		{
+			pui32Space[i] = psBlock->ui32Tag + i * CB_TAG_STEP;
+		}
+	}
+
+	CBUF_UpdateBufferPos(gc->apsBuffers, ui32DWords, ui32BufferType);
+
+	if (psBuffer->ui32CurrentWriteOffsetInBytes < ui32WriteOffset)
+	{
+		g_ui32NumWraps++;
+	}
+
+	ui32Outstanding = GetOutstandingBytes(psBuffer);
+
+	if (psBuffer->ui32HighWaterMarkInBytes < ui32Outstanding ||
+		psBuffer->ui32HighWaterMarkInBytes >= psBuffer->ui32BufferLimitInBytes)
+	{
+		Fail("%s high water mark %u with %u of %u bytes outstanding", pszBufferNames[ui32BufferType],
+			 psBuffer->ui32HighWaterMarkInBytes, ui32Outstanding, psBuffer->ui32BufferLimitInBytes);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostRequest
+ Inputs             : gc, ui32BufferType
+ Outputs            : -
+ Returns            : -
+ Description        : A random sized block, which may be written short, in a PDS or
+					  VDM buffer
+************************************************************************************/
+static IMG_VOID HostRequest(GLES2Context *gc, IMG_UINT32 ui32BufferType)
+{
+	IMG_UINT32 ui32DWords = Random(g_asTABuffers[ui32BufferType].ui32MaxRequestDWords + 1);
+	IMG_UINT32 *pui32Space;
+
+	pui32Space = HostGetSpace(gc, ui32BufferType, ui32DWords);
+
+	if (!pui32Space)
+	{
+		Fail("no %s space for %u dwords", pszBufferNames[ui32BufferType], ui32DWords);
+
+		return;
+	}
+
+	HostPutSpace(gc, ui32BufferType, pui32Space, Random(2) ? ui32DWords : Random(ui32DWords + 1));
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDraw
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : One primitive's worth of TA buffer space, as a draw asks for
+					  it, then committed as the draw commits it
+************************************************************************************/
+static IMG_VOID HostDraw(GLES2Context *gc)
+{
+	CircularBuffer *psVertexBuffer = gc->apsBuffers[CBUF_TYPE_VERTEX_DATA_BUFFER];
+	CircularBuffer *psIndexBuffer = gc->apsBuffers[CBUF_TYPE_INDEX_DATA_BUFFER];
+	IMG_UINT32 ui32VertexDWords = Random(g_asTABuffers[CBUF_TYPE_VERTEX_DATA_BUFFER].ui32MaxRequestDWords + 1);
+	IMG_UINT32 ui32IndexDWords = Random(g_asTABuffers[CBUF_TYPE_INDEX_DATA_BUFFER].ui32MaxRequestDWords + 1);
+	IMG_UINT32 *pui32Vertex, *pui32Index = IMG_NULL, i;
+	IMG_BOOL bKickTA = IMG_FALSE;
+
+	g_ui32NumDraws++;
+
+	/* As GetVertexIndexBufferSpace in drawvarray.c */
+	pui32Vertex = HostGetSpace(gc, CBUF_TYPE_VERTEX_DATA_BUFFER, ui32VertexDWords);
+
+	if (!pui32Vertex && psVertexBuffer->ui32CommittedPrimOffsetInBytes != psVertexBuffer->ui32CommittedHWOffsetInBytes)
+	{
+		bKickTA = IMG_TRUE;
+	}
+
+	if (!bKickTA)
+	{
+		pui32Index = HostGetSpace(gc, CBUF_TYPE_INDEX_DATA_BUFFER, ui32IndexDWords);
+
+		if (!pui32Index && psIndexBuffer->ui32CommittedPrimOffsetInBytes != psIndexBuffer->ui32CommittedHWOffsetInBytes)
+		{
+			bKickTA = IMG_TRUE;
+
+			CBUF_UpdateBufferPos(gc->apsBuffers, 0, CBUF_TYPE_VERTEX_DATA_BUFFER);
+		}
+	}
+
+	if (bKickTA)
+	{
+		ScheduleTA(gc, gc->psRenderSurface, 0);
+
+		pui32Vertex = HostGetSpace(gc, CBUF_TYPE_VERTEX_DATA_BUFFER, ui32VertexDWords);
+		pui32Index = HostGetSpace(gc, CBUF_TYPE_INDEX_DATA_BUFFER, ui32IndexDWords);
+	}
+
+	if (!pui32Vertex || !pui32Index)
+	{
+		Fail("no vertex or index space for %u and %u dwords, even after a kick", ui32VertexDWords, ui32IndexDWords);
+
+		return;
+	}
+
+	HostPutSpace(gc, CBUF_TYPE_VERTEX_DATA_BUFFER, pui32Vertex, ui32VertexDWords);
+	HostPutSpace(gc, CBUF_TYPE_INDEX_DATA_BUFFER, pui32Index, Random(ui32IndexDWords + 1));
+
+	if (Random(4))
+	{
+		HostRequest(gc, CBUF_TYPE_PDS_VERT_BUFFER);
+	}
+
+	for (i = CBUF_TYPE_PDS_VERT_SECONDARY_PREGEN_BUFFER; i <= CBUF_TYPE_MTE_COPY_PREGEN_BUFFER; i++)
+	{
+		if (!Random(3))
+		{
+			HostRequest(gc, i);
+		}
+	}
+
+	HostRequest(gc, CBUF_TYPE_VDM_CTRL_BUFFER);
+
+	/* As the end of a draw in validate.c, vertex and index buffers first */
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		if (i == CBUF_TYPE_VERTEX_DATA_BUFFER || i == CBUF_TYPE_INDEX_DATA_BUFFER)
+		{
+			g_asTABuffers[i].ui32NumCommitted = g_asTABuffers[i].ui32NumWritten;
+		}
+	}
+
+	CBUF_UpdateVIBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA,
+											(IMG_VOID *)gc, HostKickLimit);
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		g_asTABuffers[i].ui32NumCommitted = g_asTABuffers[i].ui32NumWritten;
+	}
+
+	CBUF_UpdateBufferCommittedPrimOffsets(gc->apsBuffers, &gc->psRenderSurface->bPrimitivesSinceLastTA,
+										  (IMG_VOID *)gc, HostKickLimit);
+}
+
+
+/***********************************************************************************
+ Function Name      : GetMaxSize
+ Inputs             : gc, ui32BufferType
+ Outputs            : -
+ Returns            : Largest a buffer may grow to
+ Description        : As GrowStalledTABuffers
+************************************************************************************/
+static IMG_UINT32 GetMaxSize(const GLES2Context *gc, IMG_UINT32 ui32BufferType)
+{
+	switch (ui32BufferType)
+	{
+		case CBUF_TYPE_VDM_CTRL_BUFFER:
+		{
+			return gc->sAppHints.ui32MaxVDMBufferSize;
+		}
+		case CBUF_TYPE_VERTEX_DATA_BUFFER:
+		{
+			return gc->sAppHints.ui32MaxVertexBufferSize;
+		}
+		case CBUF_TYPE_INDEX_DATA_BUFFER:
+		{
+			return gc->sAppHints.ui32MaxIndexBufferSize;
+		}
+		default:
+		{
+			return gc->sAppHints.ui32MaxPDSVertBufferSize;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetCreatedSize
+ Inputs             : ui32BufferType, ui32Size
+ Outputs            : -
+ Returns            : Size CBUF_CreateBuffer makes a buffer asked to be ui32Size
+ Description        : UTILITY
+************************************************************************************/
+static IMG_UINT32 GetCreatedSize(IMG_UINT32 ui32BufferType, IMG_UINT32 ui32Size)
+{
+	switch (ui32BufferType)
+	{
+		case CBUF_TYPE_VDM_CTRL_BUFFER:
+		{
+			return (ui32Size + EURASIA_VDM_CTRL_STREAM_BURST_SIZE - 1) & ~(EURASIA_VDM_CTRL_STREAM_BURST_SIZE - 1);
+		}
+		case CBUF_TYPE_VERTEX_DATA_BUFFER:
+		{
+			return (ui32Size + EURASIA_CACHE_LINE_SIZE - 1) & ~(EURASIA_CACHE_LINE_SIZE - 1);
+		}
+		case CBUF_TYPE_INDEX_DATA_BUFFER:
+		{
+			return (ui32Size + EURASIA_VDM_INDEX_FETCH_BURST_SIZE - 1) & ~(EURASIA_VDM_INDEX_FETCH_BURST_SIZE - 1);
+		}
+		default:
+		{
+			return ui32Size;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostEndFrame
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : As the end of a frame in eglglue.c: kick the scene, then grow
+					  the buffers that stalled. Checks each buffer grew, or didn't,
+					  as the stall counts say it should have.
+************************************************************************************/
+static IMG_VOID HostEndFrame(GLES2Context *gc)
+{
+	CircularBuffer asOld[CB_NUM_BUFFERS], *apsOld[CB_NUM_BUFFERS];
+	IMG_BOOL abGrow[CB_NUM_BUFFERS];
+	IMG_UINT32 ui32NumGrows = 0, i;
+
+	/* Now and then the scene is still being built when the buffers are looked at */
+	if (Random(8))
+	{
+		HostDoKickTA(gc, IMG_TRUE);
+	}
+
+	for (i = Random(3); i && g_ui32NumKicks; i--)
+	{
+		HostCompleteKick();
+	}
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		apsOld[i] = gc->apsBuffers[i];
+		asOld[i] = *apsOld[i];
+
+		/* Once one buffer has been resized, the kick it waited for has left nothing to kick */
+		abGrow[i] = (i <= CBUF_TYPE_PDS_VERT_BUFFER &&
+					 gc->sAppHints.ui32BufferStallGrowThreshold &&
+					 g_asTABuffers[i].ui32Stalls >= gc->sAppHints.ui32BufferStallGrowThreshold &&
+					 apsOld[i]->ui32BufferLimitInBytes < GetMaxSize(gc, i) &&
+					 apsOld[i]->ui32CurrentWriteOffsetInBytes == (ui32NumGrows ? apsOld[i]->ui32CommittedPrimOffsetInBytes :
+																	apsOld[i]->ui32CommittedHWOffsetInBytes)) ? IMG_TRUE : IMG_FALSE;
+
+		ui32NumGrows += abGrow[i];
+	}
+
+	ui32NumGrows = 0;
+
+	g_ui32NumResizes = 0;
+	g_ui32ResizeFailMask = 0;
+	g_bInjectFailures = IMG_TRUE;
+
+	GrowStalledTABuffers(gc);
+
+	g_bInjectFailures = IMG_FALSE;
+	g_bFailureInjected = IMG_FALSE;
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		CircularBuffer *psBuffer = gc->apsBuffers[i];
+		HostTABuffer *psTABuffer = &g_asTABuffers[i];
+		IMG_BOOL bFailed = IMG_FALSE;
+
+		if (abGrow[i])
+		{
+			bFailed = (g_ui32ResizeFailMask & (1U << ui32NumGrows)) ? IMG_TRUE : IMG_FALSE;
+
+			ui32NumGrows++;
+		}
+
+		/* The pregenerated buffers are never grown, so their counts are never reset */
+		if (i <= CBUF_TYPE_PDS_VERT_BUFFER)
+		{
+			psTABuffer->ui32Stalls = 0;
+		}
+
+		if (psBuffer->ui32StallCount != psTABuffer->ui32Stalls)
+		{
+			Fail("%s buffer stall count %u after the frame, not %u", pszBufferNames[i], psBuffer->ui32StallCount, psTABuffer->ui32Stalls);
+		}
+
+		if (!abGrow[i] || bFailed)
+		{
+			if (psBuffer != apsOld[i] || psBuffer->ui32BufferLimitInBytes != asOld[i].ui32BufferLimitInBytes)
+			{
+				Fail("%s buffer of %u bytes replaced when it %s", pszBufferNames[i], asOld[i].ui32BufferLimitInBytes,
+					 bFailed ? "failed to grow" : "shouldn't have grown");
+			}
+
+			if (bFailed)
+			{
+				g_ui32NumFailedGrows++;
+			}
+
+			continue;
+		}
+
+		g_ui32NumGrows++;
+
+		if (psBuffer == apsOld[i] ||
+			psBuffer->ui32BufferLimitInBytes != GetCreatedSize(i, MIN(asOld[i].ui32BufferLimitInBytes * 2, GetMaxSize(gc, i))))
+		{
+			Fail("%s buffer of %u bytes, with maximum %u, grew to %u bytes", pszBufferNames[i],
+				 asOld[i].ui32BufferLimitInBytes, GetMaxSize(gc, i), psBuffer->ui32BufferLimitInBytes);
+
+			continue;
+		}
+
+		/* As InitContext */
+		if (((HostAlloc *)psBuffer->psMemInfo)->hHeap != ((i == CBUF_TYPE_PDS_VERT_BUFFER) ? (IMG_HANDLE)&g_ui32PDSVertexHeap : (IMG_HANDLE)&g_ui32GeneralHeap) ||
+			((HostAlloc *)psBuffer->psStatusUpdateMemInfo)->hHeap != (IMG_HANDLE)&g_ui32SyncInfoHeap)
+		{
+			Fail("%s buffer grew into the wrong heap", pszBufferNames[i]);
+		}
+
+		if (psBuffer->ui32KickCount != asOld[i].ui32KickCount ||
+			psBuffer->ui32TotalStallCount != asOld[i].ui32TotalStallCount ||
+			psBuffer->ui32StallTimeInUs != asOld[i].ui32StallTimeInUs ||
+			psBuffer->ui32HighWaterMarkInBytes != asOld[i].ui32HighWaterMarkInBytes)
+		{
+			Fail("%s buffer statistics lost when it grew", pszBufferNames[i]);
+		}
+
+		if (gc->sKickTA.asTAStatusUpdate[i].sCtlStatus.sStatusDevAddr.uiAddr != psBuffer->psStatusUpdateMemInfo->sDevVAddr.uiAddr ||
+			gc->sKickTA.asTAStatusUpdate[i].hKernelMemInfo != psBuffer->psStatusUpdateMemInfo->hKernelMemInfo ||
+			psBuffer->pui32ReadOffset != (IMG_UINT32 *)psBuffer->psStatusUpdateMemInfo->pvLinAddr)
+		{
+			Fail("%s buffer status update not retargeted when it grew", pszBufferNames[i]);
+		}
+
+		if (psTABuffer->ui32NumConsumed != psTABuffer->ui32NumWritten)
+		{
+			Fail("%s buffer grew with blocks still to consume", pszBufferNames[i]);
+		}
+	}
+
+	if (g_ui32NumResizes != ui32NumGrows)
+	{
+		Fail("%u buffers resized, when %u should have grown", g_ui32NumResizes, ui32NumGrows);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ResetRun
+ Inputs             : gc
+ Outputs            : -
+ Returns            : Success
+ Description        : Creates the buffers, as InitContext in eglglue.c, at random
+					  sizes, with random apphints
+************************************************************************************/
+static IMG_BOOL ResetRun(GLES2Context *gc)
+{
+	static const IMG_UINT32 aui32MinSize[CB_NUM_BUFFERS] = {2048, 1024, 512, 512, 256, 256};
+	IMG_UINT32 aui32Size[CB_NUM_BUFFERS], i;
+
+	memset(gc->apsBuffers, 0, sizeof(gc->apsBuffers));
+	memset(&gc->sKickTA, 0, sizeof(gc->sKickTA));
+	memset(g_asTABuffers, 0, sizeof(g_asTABuffers));
+	memset(&g_sRenderSurface, 0, sizeof(g_sRenderSurface));
+
+	g_ui32NextDevAddr = CB_DEVADDR_BASE;
+	g_ui32KickHead = 0;
+	g_ui32NumKicks = 0;
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		IMG_HANDLE hMemHeap = (i >= CBUF_TYPE_PDS_VERT_BUFFER) ? (IMG_HANDLE)&g_ui32PDSVertexHeap : (IMG_HANDLE)&g_ui32GeneralHeap;
+		IMG_UINT32 ui32Limit;
+
+		aui32Size[i] = aui32MinSize[i] * (1 + Random(4)) + 4 * Random(64);
+
+		gc->apsBuffers[i] = CBUF_CreateBuffer(gc->ps3DDevData, i, hMemHeap, gc->psSysContext->hSyncInfoHeap,
+											  gc->psSysContext->sHWInfo.sMiscInfo.hOSGlobalEvent, aui32Size[i],
+											  gc->psSysContext->hPerProcRef);
+
+		if (!gc->apsBuffers[i])
+		{
+			Fail("failed to create the %s buffer", pszBufferNames[i]);
+
+			return IMG_FALSE;
+		}
+
+		gc->sKickTA.asTAStatusUpdate[i].hKernelMemInfo = gc->apsBuffers[i]->psStatusUpdateMemInfo->hKernelMemInfo;
+		gc->sKickTA.asTAStatusUpdate[i].sCtlStatus.sStatusDevAddr.uiAddr = gc->apsBuffers[i]->psStatusUpdateMemInfo->sDevVAddr.uiAddr;
+
+		gc->apsBuffers[i]->pui32ReadOffset = (IMG_UINT32*)gc->apsBuffers[i]->psStatusUpdateMemInfo->pvLinAddr;
+
+		ui32Limit = gc->apsBuffers[i]->ui32BufferLimitInBytes;
+
+		/*
+			Kicks at half full, plus a draw, leave a quarter of a buffer free
+			in one piece, once the TA catches up. Keep a request and
+			everything that pads it inside that.
+		*/
+		if (i == CBUF_TYPE_VDM_CTRL_BUFFER)
+		{
+			g_asTABuffers[i].ui32MaxRequestDWords = (ui32Limit / 2 - 2 * ((VDM_CTRL_TERMINATE_DWORDS << 2) + EURASIA_VDM_CTRL_STREAM_BURST_SIZE + 8)) / 12;
+		}
+		else
+		{
+			g_asTABuffers[i].ui32MaxRequestDWords = (ui32Limit / 2 - 2 * (EURASIA_VDMPDS_BASEADDR_CACHEALIGN + 8)) / 12;
+		}
+	}
+
+	gc->sAppHints.ui32MaxVDMBufferSize = aui32Size[CBUF_TYPE_VDM_CTRL_BUFFER] << Random(4);
+	gc->sAppHints.ui32MaxVertexBufferSize = (aui32Size[CBUF_TYPE_VERTEX_DATA_BUFFER] << Random(4)) + 4 * Random(64);
+	gc->sAppHints.ui32MaxIndexBufferSize = (aui32Size[CBUF_TYPE_INDEX_DATA_BUFFER] << Random(4)) + 4 * Random(64);
+	gc->sAppHints.ui32MaxPDSVertBufferSize = (aui32Size[CBUF_TYPE_PDS_VERT_BUFFER] << Random(4)) + 4 * Random(64);
+	gc->sAppHints.ui32BufferStallGrowThreshold = Random(4);
+
+	g_ui32AllocFailRate = 4 + Random(16);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunFrames
+ Inputs             : ui32Run, ui32Frames
+ Outputs            : -
+ Returns            : -
+ Description        : One run of random frames
+************************************************************************************/
+static IMG_VOID RunFrames(IMG_UINT32 ui32Run, IMG_UINT32 ui32Frames)
+{
+	GLES2Context *gc = &g_sContext;
+	IMG_UINT32 ui32Errors = g_ui32NumErrors;
+	IMG_UINT32 ui32Frame, ui32Draws, i;
+
+	if (!ResetRun(gc))
+	{
+		return;
+	}
+
+	/* How often the TA gets on between draws */
+	i = 1 + Random(8);
+
+	for (ui32Frame = 0; ui32Frame < ui32Frames && g_ui32NumErrors == ui32Errors; ui32Frame++)
+	{
+		for (ui32Draws = 1 + Random(CB_MAX_DRAWS); ui32Draws && g_ui32NumErrors == ui32Errors; ui32Draws--)
+		{
+			HostDraw(gc);
+
+			if (g_ui32NumKicks && !Random(i))
+			{
+				HostCompleteKick();
+			}
+		}
+
+		if (g_ui32NumErrors == ui32Errors)
+		{
+			HostEndFrame(gc);
+		}
+	}
+
+	HostDoKickTA(gc, IMG_TRUE);
+
+	while (g_ui32NumKicks)
+	{
+		HostCompleteKick();
+	}
+
+	for (i = 0; i < CB_NUM_BUFFERS; i++)
+	{
+		CBUF_DestroyBuffer(gc->ps3DDevData, gc->apsBuffers[i]);
+
+		gc->apsBuffers[i] = IMG_NULL;
+	}
+
+	if (g_ui32NumAllocs || g_ui32NumUserAllocs || g_ui32NumSyncInfos)
+	{
+		Fail("%u device allocations, %u user allocations and %u sync infos leaked",
+			 g_ui32NumAllocs, g_ui32NumUserAllocs, g_ui32NumSyncInfos);
+	}
+
+	if (g_ui32NumErrors != ui32Errors)
+	{
+		fprintf(stderr, "run %u failed in frame %u\n", ui32Run, ui32Frame);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = CB_DEFAULT_RUNS, ui32Frames = CB_DEFAULT_FRAMES;
+	IMG_UINT32 ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-frames=", strlen("-frames=")) == 0)
+		{
+			ui32Frames = strtoul(argv[1] + strlen("-frames="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: cbuf [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	g_sSysContext.hGeneralHeap = (IMG_HANDLE)&g_ui32GeneralHeap;
+	g_sSysContext.hPDSVertexHeap = (IMG_HANDLE)&g_ui32PDSVertexHeap;
+	g_sSysContext.hSyncInfoHeap = (IMG_HANDLE)&g_ui32SyncInfoHeap;
+	g_sSysContext.hPerProcRef = 0x5A;
+
+	g_sContext.ps3DDevData = &g_sDevData;
+	g_sContext.psSysContext = &g_sSysContext;
+	g_sContext.psRenderSurface = &g_sRenderSurface;
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunFrames(i, ui32Frames);
+	}
+
+	printf("%u runs of %u frames (seed %u): %u draws, %u TA kicks, %u stalls, %u wraps, %u stream links, "
+		   "%u buffers grown, %u failed to grow\n",
+		   i, ui32Frames, ui32Seed, g_ui32NumDraws, g_ui32NumTAKicks, g_ui32NumStalls, g_ui32NumWraps, g_ui32NumLinks,
+		   g_ui32NumGrows, g_ui32NumFailedGrows);
+
+	if (ui32Runs && !g_ui32NumErrors && (!g_ui32NumStalls || !g_ui32NumLinks || !g_ui32NumGrows || !g_ui32NumFailedGrows))
+	{
+		Fail("the runs never stalled, wrapped the VDM buffer, grew a buffer and failed to");
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
+
+/******************************************************************************
+ End of file (main.c)
+******************************************************************************/
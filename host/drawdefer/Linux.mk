@@ -0,0 +1,41 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the GLES2 deferred draw merge against a mocked command buffer.
+# Random draw sequences must emit exactly the vertices they asked for, under
+# the state each draw was issued with, and runs of contiguous sprites must
+# merge. It then times sprite batches with and without deferral. Run it with
+# no arguments; it exits non-zero if any check fails.
+#
+
+modules := drawdefer
+
+drawdefer_type := host_executable
+
+drawdefer_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/drawdefer.c
+
+drawdefer_extlibs := pthread
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header.
+drawdefer_cflags := \
+ -DLINUX -DUSER \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/drawdefer/hostcontext.h
+
+drawdefer_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ intermediates/sgxsupport
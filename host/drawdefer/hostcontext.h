@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the deferred draw test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of drawdefer.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                deferred draw is the driver's own drawdefer.h. The context
+ *                keeps only the state DeferDraw reads, and DrawArrays and
+ *                DrawElements come from the harness's mocked command
+ *                buffer.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "services.h"
+#include "pvr_debug.h"
+
+#include "ogles2_types.h"
+
+#include "drvgl2.h"
+
+#include "drawdefer.h"
+
+
+/* As attrib.h */
+#define ATTRIBARRAY_SOURCE_VARRAY		0x00000002
+#define ATTRIBARRAY_MAP_BUFOBJ			0x00000008
+#define ATTRIBARRAY_BAD_BUFOBJ			0x00000010
+
+/* As vertexarrobj.h */
+#define VAO_IS_DIRTY(gc) ((gc->sVAOMachine.psActiveVAO->ui32DirtyState != 0) || \
+						  (gc->sVAOMachine.psActiveVAO->ui32BufObjRenameStamp != gc->psSharedState->ui32BufObjRenameStamp))
+
+typedef struct GLES2VertexArrayObjectRec
+{
+	IMG_UINT32 ui32DirtyState;
+	IMG_UINT32 ui32BufObjRenameStamp;
+
+} GLES2VertexArrayObject;
+
+typedef struct GLES2VertexArrayObjectMachineRec
+{
+	GLES2VertexArrayObject *psActiveVAO;
+
+	IMG_UINT32 ui32ControlWord;
+
+} GLES2VertexArrayObjectMachine;
+
+/* As context.h */
+typedef struct GLES2ContextSharedStateTAG
+{
+	IMG_UINT32 ui32BufObjRenameStamp;
+
+} GLES2ContextSharedState;
+
+
+struct GLES2Context_TAG
+{
+	IMG_UINT32 ui32DirtyState;
+
+	GLES2ContextSharedState *psSharedState;
+
+	GLES2DeferredDraw sDeferredDraw;
+
+	GLES2VertexArrayObjectMachine sVAOMachine;
+};
+
+
+/* As context.h */
+IMG_VOID FlushDeferredDraw(GLES2Context *gc);
+
+#endif /* _CONTEXT_ */
@@ -0,0 +1,1041 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLES2 deferred draw merge test and draw-rate benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's drawdefer.c against a mocked command
+ *                buffer. DrawArrays and DrawElements are replaced by mocks
+ *                which validate dirty state, drop draws with a mapped or
+ *                undefined buffer object as the driver does, and record
+ *                each primitive block they are given.
+ *
+ *                Random sequences of glDrawArrays and glDrawElements calls
+ *                of every primitive type, with partial primitives, client
+ *                and buffer object indices, unaligned index offsets and
+ *                contiguous and broken ranges, are interleaved with other
+ *                entrypoints. Some of those change state, bind or unbind
+ *                client arrays or the element buffer, or map a buffer.
+ *                The vertices the recorded blocks draw, with their
+ *                primitive boundaries, must be exactly those the calls
+ *                asked for, in order. Each must also be emitted under the
+ *                state it was issued with, so no draw may be held across
+ *                a state change. Once any other entrypoint has run,
+ *                nothing may still be held.
+ *
+ *                Fixed runs of contiguous sprites check that a batch
+ *                costs two primitive blocks: the first draw after the
+ *                state change, then one for the rest. Client array
+ *                batches must still cost one block per draw.
+ *
+ *                The benchmark times sprite batches of several sizes with
+ *                and without deferral. The mocked command buffer only
+ *                charges a surface lock and a fixed block write per
+ *                primitive block, and a state write per validation, so the
+ *                blocks per draw are the figure to carry over to hardware.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+
+
+#define DD_DEFAULT_RUNS			300
+#define DD_DEFAULT_STEPS		400
+#define DD_DEFAULT_DRAWS		400000
+
+#define DD_MAX_COUNT			16
+#define DD_MAX_STREAM			(DD_DEFAULT_STEPS * DD_MAX_COUNT * 2)
+#define DD_MAX_VERTEX			1024
+#define DD_ELEMENT_BYTES		4096
+
+/* Mocked command buffer costs, in words written */
+#define DD_CMDBUF_WORDS			16384
+#define DD_BLOCK_WORDS			8
+#define DD_STATE_WORDS			64
+
+#define DD_SPRITE_VERTICES		6
+#define DD_SPRITE_RUN			100
+
+/* Entrypoints other than draws */
+#define DD_ENTRY_QUERY			0
+#define DD_ENTRY_STATE			1
+#define DD_ENTRY_VAO			2
+#define DD_ENTRY_CLIENT_ARRAYS	3
+#define DD_ENTRY_MAP_BUFFER		4
+#define DD_ENTRY_BAD_BUFFER		5
+#define DD_ENTRY_ELEMENT_BUFFER	6
+#define DD_NUM_ENTRIES			7
+
+typedef struct HostVertexRec
+{
+	GLenum eMode;
+	IMG_UINT32 ui32Stamp;
+	IMG_UINT32 ui32Vertex;
+
+	/* First vertex of a primitive, or of a strip, loop or fan */
+	IMG_BOOL bStart;
+
+} HostVertex;
+
+typedef struct HostStreamRec
+{
+	HostVertex asVertices[DD_MAX_STREAM];
+	IMG_UINT32 ui32NumVertices;
+
+} HostStream;
+
+static GLES2Context g_sContext;
+static GLES2ContextSharedState g_sShared;
+static GLES2VertexArrayObject g_sVAO;
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+/* Bumped by every entrypoint that changes what a draw would produce */
+static IMG_UINT32 g_ui32Stamp;
+
+static IMG_BOOL g_bElementBuffer;
+
+/* Picked up into the control word when the VAO is next validated */
+static IMG_BOOL g_bClientArrays;
+static IMG_BOOL g_bDeferEnabled = IMG_TRUE;
+static IMG_BOOL g_bRecord = IMG_TRUE;
+
+static IMG_UINT8 g_aui8ElementBuffer[DD_ELEMENT_BYTES];
+static IMG_UINT8 g_aui8ClientIndices[DD_ELEMENT_BYTES];
+
+static HostStream g_sExpected, g_sEmitted;
+
+static IMG_UINT32 g_ui32NumBlocks, g_ui32NumValidates;
+static IMG_UINT32 g_ui32TotalDraws, g_ui32TotalBlocks;
+
+/* Mocked command buffer, and the render surface lock PrepareToDraw takes */
+static IMG_UINT32 g_aui32CmdBuf[DD_CMDBUF_WORDS];
+static IMG_UINT32 g_ui32CmdOffset;
+static pthread_mutex_t g_sSurfaceLock = PTHREAD_MUTEX_INITIALIZER;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random draw sequences (default 300).\n"
+"-steps=N    Calls per sequence (default 400).\n"
+"-draws=N    Draws timed per case (default 400000). 0 skips the timing.\n"
+"-seed=N     Seed for the sequences (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/*
+** Services mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+
+/***********************************************************************************
+ Function Name      : GetNumIndices
+ Inputs             : eMode, ui32Count
+ Outputs            : -
+ Returns            : Number of indices drawn for ui32Count vertices
+ Description        : As GetNumIndices in drawvarray.c
+************************************************************************************/
+static IMG_UINT32 GetNumIndices(GLenum eMode, IMG_UINT32 ui32Count)
+{
+	switch(eMode)
+	{
+		case GL_POINTS:
+		{
+			return ui32Count;
+		}
+		case GL_LINES:
+		{
+			ui32Count = ui32Count - ui32Count%2;
+
+			return (ui32Count < 2) ? 0 : ui32Count;
+		}
+		case GL_LINE_LOOP:
+		{
+			return (ui32Count < 2) ? 0 : (2 * ui32Count);
+		}
+		case GL_LINE_STRIP:
+		{
+			return (ui32Count < 2) ? 0 : (2 * (ui32Count-1));
+		}
+		case GL_TRIANGLES:
+		{
+			ui32Count = ui32Count - ui32Count%3;
+
+			return (ui32Count < 3) ? 0 : ui32Count;
+		}
+		default:
+		{
+			return (ui32Count < 3) ? 0 : ui32Count;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetListPrimitiveSize
+ Inputs             : eMode
+ Outputs            : -
+ Returns            : Vertices per primitive for list types, 0 otherwise
+ Description        : -
+************************************************************************************/
+static IMG_UINT32 GetListPrimitiveSize(GLenum eMode)
+{
+	switch(eMode)
+	{
+		case GL_POINTS:
+		{
+			return 1;
+		}
+		case GL_LINES:
+		{
+			return 2;
+		}
+		case GL_TRIANGLES:
+		{
+			return 3;
+		}
+		default:
+		{
+			return 0;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetIndexSize
+ Inputs             : eType
+ Outputs            : -
+ Returns            : Bytes per index
+ Description        : -
+************************************************************************************/
+static IMG_UINT32 GetIndexSize(GLenum eType)
+{
+	switch(eType)
+	{
+		case GL_UNSIGNED_BYTE:
+		{
+			return 1;
+		}
+		case GL_UNSIGNED_SHORT:
+		{
+			return 2;
+		}
+		default:
+		{
+			return 4;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : AppendVertices
+ Inputs             : psStream, eMode, eType, pui8Indices, ui32Start, ui32Count,
+					  ui32NumIndices, ui32Stamp
+ Outputs            : psStream
+ Returns            : -
+ Description        : Adds the vertices one draw or primitive block uses. For
+					  arrays ui32Start is the first vertex, for elements the
+					  byte offset of the first index in pui8Indices. List
+					  types draw ui32NumIndices vertices, so a trailing
+					  partial primitive is dropped. The other types are
+					  recorded as their ui32Count vertices, starting afresh.
+************************************************************************************/
+static IMG_VOID AppendVertices(HostStream *psStream, GLenum eMode, GLenum eType, const IMG_UINT8 *pui8Indices,
+							   IMG_UINT32 ui32Start, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices,
+							   IMG_UINT32 ui32Stamp)
+{
+	IMG_UINT32 ui32PrimSize = GetListPrimitiveSize(eMode);
+	IMG_UINT32 ui32NumVertices = ui32PrimSize ? ui32NumIndices : ui32Count;
+	IMG_UINT32 i;
+
+	if (psStream->ui32NumVertices + ui32NumVertices > DD_MAX_STREAM)
+	{
+		Fail("vertex stream overflow");
+		return;
+	}
+
+	for (i = 0; i < ui32NumVertices; i++)
+	{
+		HostVertex *psVertex = &psStream->asVertices[psStream->ui32NumVertices++];
+
+		if (eType == 0)
+		{
+			psVertex->ui32Vertex = ui32Start + i;
+		}
+		else
+		{
+			IMG_UINT32 ui32Offset = ui32Start + i * GetIndexSize(eType);
+
+			if (eType == GL_UNSIGNED_BYTE)
+			{
+				psVertex->ui32Vertex = pui8Indices[ui32Offset];
+			}
+			else if (eType == GL_UNSIGNED_SHORT)
+			{
+				IMG_UINT16 ui16Index;
+
+				memcpy(&ui16Index, &pui8Indices[ui32Offset], sizeof(ui16Index));
+				psVertex->ui32Vertex = ui16Index;
+			}
+			else
+			{
+				memcpy(&psVertex->ui32Vertex, &pui8Indices[ui32Offset], sizeof(IMG_UINT32));
+			}
+		}
+
+		psVertex->eMode = eMode;
+		psVertex->ui32Stamp = ui32Stamp;
+		psVertex->bStart = ui32PrimSize ? ((i % ui32PrimSize) == 0) : (i == 0);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : EmitBlock
+ Inputs             : gc, eMode, eType, pui8Indices, ui32Start, ui32Count, ui32NumIndices
+ Outputs            : -
+ Returns            : -
+ Description        : The mocked draw path: takes the surface lock, validates
+					  dirty state, drops the draw if a buffer object is
+					  mapped or undefined, then writes one primitive block
+************************************************************************************/
+static IMG_VOID EmitBlock(GLES2Context *gc, GLenum eMode, GLenum eType, const IMG_UINT8 *pui8Indices,
+						  IMG_UINT32 ui32Start, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices)
+{
+	IMG_UINT32 i;
+
+	if (gc->sDeferredDraw.bPending)
+	{
+		Fail("the draw path was entered with a draw still deferred");
+	}
+
+	/* PrepareToDraw */
+	pthread_mutex_lock(&g_sSurfaceLock);
+
+	/* ValidateState */
+	if (gc->ui32DirtyState || VAO_IS_DIRTY(gc))
+	{
+		for (i = 0; i < DD_STATE_WORDS; i++)
+		{
+			g_aui32CmdBuf[(g_ui32CmdOffset + i) % DD_CMDBUF_WORDS] = gc->ui32DirtyState ^ i;
+		}
+
+		g_ui32CmdOffset = (g_ui32CmdOffset + DD_STATE_WORDS) % DD_CMDBUF_WORDS;
+
+		if (g_bClientArrays)
+		{
+			gc->sVAOMachine.ui32ControlWord |= ATTRIBARRAY_SOURCE_VARRAY;
+		}
+		else
+		{
+			gc->sVAOMachine.ui32ControlWord &= ~ATTRIBARRAY_SOURCE_VARRAY;
+		}
+
+		gc->ui32DirtyState = 0;
+		gc->sVAOMachine.psActiveVAO->ui32DirtyState = 0;
+		gc->sVAOMachine.psActiveVAO->ui32BufObjRenameStamp = gc->psSharedState->ui32BufObjRenameStamp;
+
+		g_ui32NumValidates++;
+	}
+
+	if (gc->sVAOMachine.ui32ControlWord & (ATTRIBARRAY_BAD_BUFOBJ | ATTRIBARRAY_MAP_BUFOBJ))
+	{
+		pthread_mutex_unlock(&g_sSurfaceLock);
+
+		return;
+	}
+
+	/* WriteVDMControlStream */
+	for (i = 0; i < DD_BLOCK_WORDS; i++)
+	{
+		g_aui32CmdBuf[(g_ui32CmdOffset + i) % DD_CMDBUF_WORDS] = ui32Start + ui32Count + i;
+	}
+
+	g_ui32CmdOffset = (g_ui32CmdOffset + DD_BLOCK_WORDS) % DD_CMDBUF_WORDS;
+
+	g_ui32NumBlocks++;
+
+	if (g_bRecord)
+	{
+		AppendVertices(&g_sEmitted, eMode, eType, pui8Indices, ui32Start, ui32Count, ui32NumIndices, g_ui32Stamp);
+	}
+
+	pthread_mutex_unlock(&g_sSurfaceLock);
+}
+
+
+/*
+** The draw paths drawdefer.c emits through
+*/
+
+IMG_VOID DrawArrays(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32First, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices)
+{
+	if (ui32NumIndices != GetNumIndices(eMode, ui32Count))
+	{
+		Fail("DrawArrays was given %u indices for %u vertices", ui32NumIndices, ui32Count);
+	}
+
+	EmitBlock(gc, eMode, 0, IMG_NULL, ui32First, ui32Count, ui32NumIndices);
+}
+
+IMG_VOID DrawElements(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices,
+					  GLenum eType, const IMG_VOID *indices)
+{
+	if (ui32NumIndices != GetNumIndices(eMode, ui32Count))
+	{
+		Fail("DrawElements was given %u indices for %u vertices", ui32NumIndices, ui32Count);
+	}
+
+	/* With an element buffer bound, indices is an offset into it */
+	if (g_bElementBuffer)
+	{
+		EmitBlock(gc, eMode, eType, g_aui8ElementBuffer, (IMG_UINT32)(IMG_UINTPTR_T)indices, ui32Count, ui32NumIndices);
+	}
+	else
+	{
+		EmitBlock(gc, eMode, eType, g_aui8ClientIndices, (IMG_UINT32)((const IMG_UINT8 *)indices - g_aui8ClientIndices),
+				  ui32Count, ui32NumIndices);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpectDraw
+ Inputs             : gc, eMode, eType, pui8Indices, ui32Start, ui32Count, ui32NumIndices
+ Outputs            : -
+ Returns            : -
+ Description        : Records what the driver drew for this call before draws
+					  were deferred
+************************************************************************************/
+static IMG_VOID ExpectDraw(GLES2Context *gc, GLenum eMode, GLenum eType, const IMG_UINT8 *pui8Indices,
+						   IMG_UINT32 ui32Start, IMG_UINT32 ui32Count, IMG_UINT32 ui32NumIndices)
+{
+	g_ui32TotalDraws++;
+
+	if (g_bRecord && !(gc->sVAOMachine.ui32ControlWord & (ATTRIBARRAY_BAD_BUFOBJ | ATTRIBARRAY_MAP_BUFOBJ)))
+	{
+		AppendVertices(&g_sExpected, eMode, eType, pui8Indices, ui32Start, ui32Count, ui32NumIndices, g_ui32Stamp);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDrawArrays
+ Inputs             : gc, eMode, ui32First, ui32Count
+ Outputs            : -
+ Returns            : -
+ Description        : As the end of glDrawArrays, once its arguments and
+					  framebuffer have been checked
+************************************************************************************/
+static IMG_VOID HostDrawArrays(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32First, IMG_UINT32 ui32Count)
+{
+	IMG_UINT32 ui32NumIndices = GetNumIndices(eMode, ui32Count);
+
+	if (ui32Count == 0 || ui32NumIndices == 0)
+	{
+		return;
+	}
+
+	ExpectDraw(gc, eMode, 0, IMG_NULL, ui32First, ui32Count, ui32NumIndices);
+
+	if (!g_bDeferEnabled || !DeferDraw(gc, eMode, 0, ui32First, ui32Count, ui32NumIndices))
+	{
+		DrawArrays(gc, eMode, ui32First, ui32Count, ui32NumIndices);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDrawElements
+ Inputs             : gc, eMode, ui32Count, eType, ui32Offset
+ Outputs            : -
+ Returns            : -
+ Description        : As the end of glDrawElements, once its arguments and
+					  framebuffer have been checked. ui32Offset is the byte
+					  offset of the first index in the element buffer or the
+					  client indices.
+************************************************************************************/
+static IMG_VOID HostDrawElements(GLES2Context *gc, GLenum eMode, IMG_UINT32 ui32Count, GLenum eType,
+								 IMG_UINT32 ui32Offset)
+{
+	IMG_UINT32 ui32NumIndices = GetNumIndices(eMode, ui32Count);
+	IMG_UINT32 ui32IndexSize = (eType == GL_UNSIGNED_BYTE) ? 0 : GetIndexSize(eType);
+	const IMG_VOID *indices;
+
+	if (ui32Count == 0 || ui32NumIndices == 0)
+	{
+		return;
+	}
+
+	if (g_bElementBuffer)
+	{
+		indices = (const IMG_VOID *)(IMG_UINTPTR_T)ui32Offset;
+
+		ExpectDraw(gc, eMode, eType, g_aui8ElementBuffer, ui32Offset, ui32Count, ui32NumIndices);
+	}
+	else
+	{
+		indices = &g_aui8ClientIndices[ui32Offset];
+
+		ExpectDraw(gc, eMode, eType, g_aui8ClientIndices, ui32Offset, ui32Count, ui32NumIndices);
+	}
+
+	if (g_bDeferEnabled && ui32IndexSize && g_bElementBuffer && ((ui32Offset % ui32IndexSize) == 0))
+	{
+		if (!DeferDraw(gc, eMode, eType, ui32Offset / ui32IndexSize, ui32Count, ui32NumIndices))
+		{
+			DrawElements(gc, eMode, ui32Count, ui32NumIndices, eType, indices);
+		}
+	}
+	else
+	{
+		if (gc->sDeferredDraw.bPending)
+		{
+			FlushDeferredDraw(gc);
+		}
+
+		DrawElements(gc, eMode, ui32Count, ui32NumIndices, eType, indices);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostEntryPoint
+ Inputs             : gc, ui32Entry
+ Outputs            : -
+ Returns            : -
+ Description        : Any other GL entrypoint: flushes as __GLES2_GET_CONTEXT
+					  does, then makes the change ui32Entry selects
+************************************************************************************/
+static IMG_VOID HostEntryPoint(GLES2Context *gc, IMG_UINT32 ui32Entry)
+{
+	if (gc->sDeferredDraw.bPending)
+	{
+		FlushDeferredDraw(gc);
+	}
+
+	switch (ui32Entry)
+	{
+		case DD_ENTRY_STATE:
+		{
+			/* glBindTexture, glUniform, glBlendFunc... */
+			gc->ui32DirtyState |= 1U << Random(8);
+			g_ui32Stamp++;
+
+			break;
+		}
+		case DD_ENTRY_VAO:
+		{
+			/* glVertexAttribPointer, glBindVertexArrayOES... */
+			gc->sVAOMachine.psActiveVAO->ui32DirtyState |= 1;
+			g_ui32Stamp++;
+
+			break;
+		}
+		case DD_ENTRY_CLIENT_ARRAYS:
+		{
+			/* glEnableVertexAttribArray on an attrib with no buffer object */
+			g_bClientArrays = !g_bClientArrays;
+			gc->sVAOMachine.psActiveVAO->ui32DirtyState |= 1;
+			g_ui32Stamp++;
+
+			break;
+		}
+		case DD_ENTRY_MAP_BUFFER:
+		{
+			/* glMapBufferOES / glUnmapBufferOES */
+			gc->sVAOMachine.ui32ControlWord ^= ATTRIBARRAY_MAP_BUFOBJ;
+			g_ui32Stamp++;
+
+			break;
+		}
+		case DD_ENTRY_BAD_BUFFER:
+		{
+			/* glBufferData running out of memory, then succeeding */
+			gc->sVAOMachine.ui32ControlWord ^= ATTRIBARRAY_BAD_BUFOBJ;
+			g_ui32Stamp++;
+
+			break;
+		}
+		case DD_ENTRY_ELEMENT_BUFFER:
+		{
+			g_bElementBuffer = !g_bElementBuffer;
+			gc->sVAOMachine.psActiveVAO->ui32DirtyState |= 1;
+			g_ui32Stamp++;
+
+			break;
+		}
+		default:
+		{
+			/* glGetError, glIsEnabled... */
+			break;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CompareStreams
+ Inputs             : bComplete
+ Outputs            : -
+ Returns            : -
+ Description        : The emitted vertices must match the expected ones as far
+					  as they go, and all of them once bComplete
+************************************************************************************/
+static IMG_VOID CompareStreams(IMG_BOOL bComplete)
+{
+	IMG_UINT32 i;
+
+	if (g_sEmitted.ui32NumVertices > g_sExpected.ui32NumVertices)
+	{
+		Fail("%u vertices emitted but only %u drawn", g_sEmitted.ui32NumVertices, g_sExpected.ui32NumVertices);
+		return;
+	}
+
+	if (bComplete && g_sEmitted.ui32NumVertices != g_sExpected.ui32NumVertices)
+	{
+		Fail("%u of %u vertices still held after another entrypoint", g_sExpected.ui32NumVertices - g_sEmitted.ui32NumVertices,
+			 g_sExpected.ui32NumVertices);
+		return;
+	}
+
+	for (i = 0; i < g_sEmitted.ui32NumVertices; i++)
+	{
+		const HostVertex *psEmitted = &g_sEmitted.asVertices[i];
+		const HostVertex *psExpected = &g_sExpected.asVertices[i];
+
+		if (psEmitted->eMode != psExpected->eMode || psEmitted->ui32Vertex != psExpected->ui32Vertex ||
+			psEmitted->bStart != psExpected->bStart)
+		{
+			Fail("vertex %u: emitted mode 0x%x vertex %u%s, drawn mode 0x%x vertex %u%s", i,
+				 psEmitted->eMode, psEmitted->ui32Vertex, psEmitted->bStart ? " (start)" : "",
+				 psExpected->eMode, psExpected->ui32Vertex, psExpected->bStart ? " (start)" : "");
+			return;
+		}
+
+		if (psEmitted->ui32Stamp != psExpected->ui32Stamp)
+		{
+			Fail("vertex %u: drawn under state %u but emitted under state %u", i, psExpected->ui32Stamp,
+				 psEmitted->ui32Stamp);
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ResetContext
+ Inputs             : gc
+ Outputs            : gc
+ Returns            : -
+ Description        : A freshly made-current context with dirty state and
+					  buffer object attribs
+************************************************************************************/
+static IMG_VOID ResetContext(GLES2Context *gc)
+{
+	memset(gc, 0, sizeof(*gc));
+	memset(&g_sShared, 0, sizeof(g_sShared));
+	memset(&g_sVAO, 0, sizeof(g_sVAO));
+
+	gc->psSharedState = &g_sShared;
+	gc->sVAOMachine.psActiveVAO = &g_sVAO;
+	gc->ui32DirtyState = 1;
+
+	g_bClientArrays = IMG_FALSE;
+
+	g_ui32Stamp = 0;
+	g_ui32NumBlocks = 0;
+	g_sExpected.ui32NumVertices = 0;
+	g_sEmitted.ui32NumVertices = 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunSequence
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : Issues random draws and other entrypoints, comparing
+					  the emitted vertices with the drawn ones after each
+************************************************************************************/
+static IMG_VOID RunSequence(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	static const GLenum aeModes[] = {GL_POINTS, GL_LINES, GL_LINE_LOOP, GL_LINE_STRIP,
+									 GL_TRIANGLES, GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN};
+	static const GLenum aeTypes[] = {GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT};
+	GLES2Context *gc = &g_sContext;
+	GLenum eMode = GL_TRIANGLES, eType = GL_UNSIGNED_SHORT;
+	IMG_UINT32 ui32NextFirst = 0, ui32NextOffset = 0;
+	IMG_UINT32 ui32Step, i, ui32Errors = g_ui32NumErrors;
+
+	ResetContext(gc);
+
+	g_bElementBuffer = Random(4) ? IMG_TRUE : IMG_FALSE;
+
+	for (i = 0; i < DD_ELEMENT_BYTES; i++)
+	{
+		g_aui8ElementBuffer[i] = (IMG_UINT8)Random(256);
+		g_aui8ClientIndices[i] = (IMG_UINT8)Random(256);
+	}
+
+	for (ui32Step = 0; ui32Step < ui32Steps && g_ui32NumErrors == ui32Errors; ui32Step++)
+	{
+		IMG_UINT32 ui32Op = Random(10);
+		IMG_UINT32 ui32Count = Random(DD_MAX_COUNT + 1);
+
+		/* Mostly keep the primitive type, so that draws can merge */
+		if (Random(4) == 0)
+		{
+			eMode = aeModes[Random(sizeof(aeModes) / sizeof(aeModes[0]))];
+		}
+
+		if (ui32Op < 6)
+		{
+			IMG_UINT32 ui32First = Random(3) ? ui32NextFirst : Random(DD_MAX_VERTEX);
+
+			HostDrawArrays(gc, eMode, ui32First, ui32Count);
+
+			ui32NextFirst = ui32First + ui32Count;
+
+			CompareStreams(IMG_FALSE);
+		}
+		else if (ui32Op < 8)
+		{
+			IMG_UINT32 ui32Offset;
+
+			if (Random(4) == 0)
+			{
+				eType = aeTypes[Random(sizeof(aeTypes) / sizeof(aeTypes[0]))];
+			}
+
+			/*
+				Continue from the last draw's bytes or its index after a type
+				change, or start anywhere, aligned or not
+			*/
+			switch (Random(4))
+			{
+				case 0:
+				{
+					ui32Offset = Random(DD_ELEMENT_BYTES / 2);
+					break;
+				}
+				case 1:
+				{
+					ui32Offset = ui32NextFirst * GetIndexSize(eType);
+					break;
+				}
+				default:
+				{
+					ui32Offset = ui32NextOffset;
+					break;
+				}
+			}
+
+			if (ui32Offset + ui32Count * GetIndexSize(eType) > DD_ELEMENT_BYTES)
+			{
+				ui32Offset = 0;
+			}
+
+			HostDrawElements(gc, eMode, ui32Count, eType, ui32Offset);
+
+			ui32NextOffset = ui32Offset + ui32Count * GetIndexSize(eType);
+			ui32NextFirst = ui32NextOffset / GetIndexSize(eType);
+
+			CompareStreams(IMG_FALSE);
+		}
+		else
+		{
+			HostEntryPoint(gc, Random(DD_NUM_ENTRIES));
+
+			CompareStreams(IMG_TRUE);
+		}
+	}
+
+	/* eglMakeCurrent / eglSwapBuffers */
+	HostEntryPoint(gc, DD_ENTRY_QUERY);
+
+	CompareStreams(IMG_TRUE);
+
+	g_ui32TotalBlocks += g_ui32NumBlocks;
+
+	if (g_ui32NumErrors != ui32Errors)
+	{
+		fprintf(stderr, "error: sequence %u failed at step %u\n", ui32Run, ui32Step - 1);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckSpriteRun
+ Inputs             : bElements, bClientArrays, ui32ExpectedBlocks
+ Outputs            : -
+ Returns            : -
+ Description        : Draws a run of contiguous sprites after a state change,
+					  or after enabling client arrays, and checks the number
+					  of primitive blocks emitted
+************************************************************************************/
+static IMG_VOID CheckSpriteRun(IMG_BOOL bElements, IMG_BOOL bClientArrays, IMG_UINT32 ui32ExpectedBlocks)
+{
+	GLES2Context *gc = &g_sContext;
+	IMG_UINT32 i;
+
+	ResetContext(gc);
+
+	g_bElementBuffer = IMG_TRUE;
+
+	/*
+		Enabling client arrays only dirties the VAO, so the draws must not be
+		held on the strength of a control word that is yet to be validated
+	*/
+	if (bClientArrays)
+	{
+		gc->ui32DirtyState = 0;
+
+		HostEntryPoint(gc, DD_ENTRY_CLIENT_ARRAYS);
+	}
+	else
+	{
+		HostEntryPoint(gc, DD_ENTRY_STATE);
+	}
+
+	for (i = 0; i < DD_SPRITE_RUN; i++)
+	{
+		if (bElements)
+		{
+			HostDrawElements(gc, GL_TRIANGLES, DD_SPRITE_VERTICES, GL_UNSIGNED_SHORT, i * DD_SPRITE_VERTICES * 2);
+		}
+		else
+		{
+			HostDrawArrays(gc, GL_TRIANGLES, i * DD_SPRITE_VERTICES, DD_SPRITE_VERTICES);
+		}
+	}
+
+	HostEntryPoint(gc, DD_ENTRY_QUERY);
+
+	CompareStreams(IMG_TRUE);
+
+	if (g_ui32NumBlocks != ui32ExpectedBlocks)
+	{
+		Fail("%u %s sprites%s took %u primitive blocks, expected %u", DD_SPRITE_RUN,
+			 bElements ? "indexed" : "array", bClientArrays ? " from client arrays" : "", g_ui32NumBlocks,
+			 ui32ExpectedBlocks);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeSprites
+ Inputs             : ui32Batch, ui32Draws
+ Outputs            : -
+ Returns            : -
+ Description        : Times ui32Draws sprite draws in batches of ui32Batch
+					  separated by a state change, without and with deferral
+************************************************************************************/
+static IMG_VOID TimeSprites(IMG_UINT32 ui32Batch, IMG_UINT32 ui32Draws)
+{
+	GLES2Context *gc = &g_sContext;
+	IMG_UINT32 aui32Blocks[2], ui32Pass, i;
+	double afTime[2];
+
+	g_bRecord = IMG_FALSE;
+
+	for (ui32Pass = 0; ui32Pass < 2; ui32Pass++)
+	{
+		double fStart;
+
+		g_bDeferEnabled = ui32Pass ? IMG_TRUE : IMG_FALSE;
+
+		ResetContext(gc);
+		g_bElementBuffer = IMG_TRUE;
+
+		fStart = GetSeconds();
+
+		for (i = 0; i < ui32Draws; i++)
+		{
+			if ((i % ui32Batch) == 0)
+			{
+				/* glBindTexture for the next sprite sheet */
+				HostEntryPoint(gc, DD_ENTRY_STATE);
+			}
+
+			HostDrawArrays(gc, GL_TRIANGLES, (i % ui32Batch) * DD_SPRITE_VERTICES, DD_SPRITE_VERTICES);
+		}
+
+		HostEntryPoint(gc, DD_ENTRY_QUERY);
+
+		afTime[ui32Pass] = GetSeconds() - fStart;
+		aui32Blocks[ui32Pass] = g_ui32NumBlocks;
+	}
+
+	g_bDeferEnabled = IMG_TRUE;
+	g_bRecord = IMG_TRUE;
+
+	printf("batch of %5u: %8.2f ns %8.2f ns %7.2fx %10.3f %10.3f\n", ui32Batch,
+		   afTime[0] * 1e9 / ui32Draws, afTime[1] * 1e9 / ui32Draws, afTime[0] / afTime[1],
+		   (double)aui32Blocks[0] / ui32Draws, (double)aui32Blocks[1] / ui32Draws);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = DD_DEFAULT_RUNS, ui32Steps = DD_DEFAULT_STEPS, ui32Draws = DD_DEFAULT_DRAWS;
+	IMG_UINT32 ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			ui32Steps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-draws=", strlen("-draws=")) == 0)
+		{
+			ui32Draws = strtoul(argv[1] + strlen("-draws="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: drawdefer [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	if (ui32Steps > DD_DEFAULT_STEPS)
+	{
+		/* The vertex streams are sized for the default */
+		ui32Steps = DD_DEFAULT_STEPS;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	/* The first sprite validates and draws at once, the rest merge */
+	CheckSpriteRun(IMG_FALSE, IMG_FALSE, 2);
+	CheckSpriteRun(IMG_TRUE, IMG_FALSE, 2);
+
+	/* Client arrays may change between draws without a GL call */
+	CheckSpriteRun(IMG_FALSE, IMG_TRUE, DD_SPRITE_RUN);
+	CheckSpriteRun(IMG_TRUE, IMG_TRUE, DD_SPRITE_RUN);
+
+	printf("sprite runs of %u checked\n", DD_SPRITE_RUN);
+
+	g_ui32TotalDraws = 0;
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunSequence(i, ui32Steps);
+	}
+
+	printf("%u sequences of %u calls (seed %u): %u draws emitted as %u primitive blocks\n",
+		   i, ui32Steps, ui32Seed, g_ui32TotalDraws, g_ui32TotalBlocks);
+
+	if (ui32Draws && !g_ui32NumErrors)
+	{
+		static const IMG_UINT32 aui32Batches[] = {1, 4, 16, 64, 256};
+
+		printf("ns per draw      %11s %11s %8s %10s %10s\n", "immediate", "deferred", "speedup", "blocks", "deferred");
+
+		for (i = 0; i < sizeof(aui32Batches) / sizeof(aui32Batches[0]); i++)
+		{
+			TimeSprites(aui32Batches[i], ui32Draws);
+		}
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+#
+# $Log: Linux.mk $
+#
+# Host test and benchmark of the EGL per-thread fast paths in tls.c: TLS
+# creation, the current surface and context checks and the cached
+# eglGetDisplay lookup, each against the locked or list-walking path it
+# stands in for. Run it with no arguments; it exits non-zero if any check
+# fails.
+#
+
+modules := egltls
+
+egltls_type := host_executable
+
+egltls_src = \
+ main.c \
+ $(TOP)/eurasiacon/imgegl/imgegl/tls.c
+
+egltls_extlibs := pthread
+
+# The EGL headers expect services.h ahead of them, and eglapi_int.h marks its
+# exports with the psp2 compiler's __declspec.
+egltls_cflags := \
+ -DLINUX -DUSER -DEGL_MODULE -DIMGEGL_MODULE -DPDS_BUILD_OPENGLES \
+ -DPROFILE_COMMON -DSUPPORT_SGX -DSUPPORT_SGX543 -DSUPPORT_OPENGLES1_V1 \
+ -DAPI_MODULES_RUNTIME_CHECKED -DUSE_GCC__thread_KEYWORD \
+ -DEGL_EXTENSION_ANDROID_BLOB_CACHE \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h -include services.h \
+ -D'__declspec(x)='
+
+egltls_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ include/gpu_es4/eurasia/services4/include \
+ include/gpu_es4/eurasia/services4/system/psp2 \
+ include/gpu_es4/eurasia/services4/srvclient/devices/sgx \
+ codegen/pds codegen/pixevent codegen/usegen \
+ eurasiacon/include eurasiacon/common eurasiacon/imgegl/imgegl \
+ common/tls common/dmscalc
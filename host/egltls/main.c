@@ -0,0 +1,1298 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : EGL per-thread fast path test and benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the EGL module's tls.c against a thread-local mock
+ *                of the platform TLS slot and checks the lock-free paths
+ *                the entry points take.
+ *
+ *                TLS_Open must create the thread's state once, return it
+ *                unchanged afterwards, give each thread its own and leave
+ *                nothing behind when initialisation fails.
+ *
+ *                Random sequences of surface and context creation,
+ *                deferred destruction, make-current and eglBindAPI are
+ *                applied to three displays. After every step each object
+ *                is looked up on each display. IsCurrentEGLSurface and
+ *                IsCurrentEGLContext must accept exactly the objects bound
+ *                to the thread for its current API on that display, and
+ *                never one the display's list walk would reject.
+ *
+ *                Random eglGetDisplay and eglTerminate calls from several
+ *                threads' TLS are run through the cached lookup and, in a
+ *                second copy of the display table, through the locked slot
+ *                scan alone. Both must return the same EGLDisplay and
+ *                leave the same slots behind.
+ *
+ *                The benchmark then runs the old and new forms of the
+ *                surface check, the swap count update and eglGetDisplay
+ *                on 1, 2 and 4 threads sharing one mutex in place of the
+ *                EGL global lock.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "egl_internal.h"
+#include "tls.h"
+
+
+#define ET_DEFAULT_RUNS			200
+#define ET_DEFAULT_STEPS		400
+#define ET_DEFAULT_CALLS		1000000
+#define ET_DEFAULT_SURFACES		16
+
+#define ET_NUM_DISPLAYS			3
+#define ET_NUM_SURFACES			12
+#define ET_NUM_CONTEXTS			6
+#define ET_NUM_NATIVES			6
+#define ET_NUM_THREADS			3
+#define ET_MAX_THREADS			4
+
+/* Benchmark cases */
+#define ET_CASE_SURFACE			0
+#define ET_CASE_SWAPCOUNT		1
+#define ET_CASE_GETDISPLAY		2
+#define ET_NUM_CASES			3
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+/* Platform TLS slot, and the failures the TLS tests inject */
+static __thread IMG_VOID *g_pvTLSValue;
+static volatile IMG_BOOL g_bFailInit;
+static volatile IMG_BOOL g_bFailSetTLS;
+static IMG_UINT32 g_ui32NumInits;
+static IMG_UINT32 g_ui32NumDeinits;
+
+static EGLGlobal g_sGlobal;
+
+/* Stand-in window system module; only its address is used */
+static WSEGL_FunctionTable g_sWSEGLFunctions;
+
+/* Stand-in for the EGL global lock in the benchmark */
+static pthread_mutex_t g_sGlobalLock = PTHREAD_MUTEX_INITIALIZER;
+
+static IMG_UINT32 g_ui32SurfaceHits, g_ui32SurfaceChecks;
+static IMG_UINT32 g_ui32DisplayHits, g_ui32DisplayCalls;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random sequences for each of the binding and display tests (default 200).\n"
+"-steps=N    Operations per sequence (default 400).\n"
+"-calls=N    Calls timed per thread for each case (default 1000000). 0 skips the timing.\n"
+"-surfaces=N Surfaces on the display the benchmark walks (default 16).\n"
+"-seed=N     Seed for the sequences (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/*
+** Services and platform mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+IMG_INTERNAL IMG_VOID *IMGEGL_GetTLSValue(IMG_VOID)
+{
+	return g_pvTLSValue;
+}
+
+IMG_INTERNAL IMG_BOOL IMGEGL_SetTLSValue(IMG_VOID *pvA)
+{
+	if (g_bFailSetTLS)
+	{
+		return IMG_FALSE;
+	}
+
+	g_pvTLSValue = pvA;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostTlsInit
+ Inputs             : psTls
+ Outputs            : psTls
+ Returns            : IMG_FALSE if a failure is being injected
+ Description        : The parts of _TlsInit the fast paths read
+************************************************************************************/
+static IMG_BOOL HostTlsInit(TLS psTls)
+{
+	IMG_UINT32 i;
+
+	__sync_fetch_and_add(&g_ui32NumInits, 1);
+
+	if (g_bFailInit)
+	{
+		return IMG_FALSE;
+	}
+
+	psTls->lastError = EGL_SUCCESS;
+	psTls->ui32API = IMGEGL_API_NONE;
+
+	for (i = 0; i < IMGEGL_NUMBER_OF_APIS; i++)
+	{
+		psTls->apsCurrentReadSurface[i] = EGL_NO_SURFACE;
+		psTls->apsCurrentDrawSurface[i] = EGL_NO_SURFACE;
+		psTls->apsCurrentContext[i]     = EGL_NO_CONTEXT;
+	}
+
+	psTls->eglCachedDisplay = EGL_NO_DISPLAY;
+	psTls->psGlobalData = &g_sGlobal;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostTlsDeinit
+ Inputs             : psTls
+ Outputs            : -
+ Returns            : -
+ Description        : Counts the deinit callbacks from TLS_Close
+************************************************************************************/
+static IMG_VOID HostTlsDeinit(TLS psTls)
+{
+	PVR_UNREFERENCED_PARAMETER(psTls);
+
+	__sync_fetch_and_add(&g_ui32NumDeinits, 1);
+}
+
+
+/***********************************************************************************
+ Function Name      : OpenTLSThread
+ Inputs             : pvArg - barrier shared by the threads
+ Outputs            : -
+ Returns            : This thread's TLS, or IMG_NULL on failure
+ Description        : Opens the TLS twice, holds it until every thread has
+					  one, then closes it
+************************************************************************************/
+static IMG_VOID *OpenTLSThread(IMG_VOID *pvArg)
+{
+	TLS psTls = TLS_Open(HostTlsInit);
+
+	if (psTls == IMG_NULL || TLS_Open(HostTlsInit) != psTls || IMGEGLGetTLSValue() != psTls)
+	{
+		psTls = IMG_NULL;
+	}
+
+	pthread_barrier_wait((pthread_barrier_t *)pvArg);
+
+	TLS_Close(HostTlsDeinit);
+
+	if (IMGEGLGetTLSValue() != IMG_NULL)
+	{
+		psTls = IMG_NULL;
+	}
+
+	return psTls;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckTLSOpen
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : Checks creation, reuse, failure and per-thread separation
+					  of the EGL thread local storage
+************************************************************************************/
+static IMG_VOID CheckTLSOpen(IMG_VOID)
+{
+	pthread_t asThreads[ET_MAX_THREADS];
+	IMG_VOID *apvTls[ET_MAX_THREADS];
+	pthread_barrier_t sBarrier;
+	TLS psTls;
+	IMG_UINT32 i, j;
+
+	g_ui32NumInits = g_ui32NumDeinits = 0;
+
+	psTls = TLS_Open(HostTlsInit);
+
+	if (psTls == IMG_NULL || IMGEGLGetTLSValue() != psTls || g_ui32NumInits != 1)
+	{
+		Fail("TLS_Open did not create and store the thread's TLS");
+	}
+
+	if (TLS_Open(HostTlsInit) != psTls || g_ui32NumInits != 1)
+	{
+		Fail("TLS_Open did not return the existing TLS unchanged");
+	}
+
+	TLS_Close(HostTlsDeinit);
+
+	if (IMGEGLGetTLSValue() != IMG_NULL || g_ui32NumDeinits != 1)
+	{
+		Fail("TLS_Close did not deinitialise and clear the TLS");
+	}
+
+	TLS_Close(HostTlsDeinit);
+
+	if (g_ui32NumDeinits != 1)
+	{
+		Fail("TLS_Close deinitialised a thread with no TLS");
+	}
+
+	g_bFailInit = IMG_TRUE;
+
+	if (TLS_Open(HostTlsInit) != IMG_NULL || IMGEGLGetTLSValue() != IMG_NULL)
+	{
+		Fail("TLS_Open kept a TLS whose initialisation failed");
+	}
+
+	g_bFailInit = IMG_FALSE;
+	g_bFailSetTLS = IMG_TRUE;
+
+	if (TLS_Open(HostTlsInit) != IMG_NULL || IMGEGLGetTLSValue() != IMG_NULL)
+	{
+		Fail("TLS_Open returned a TLS it could not store");
+	}
+
+	g_bFailSetTLS = IMG_FALSE;
+
+	/* A thread that failed before must be able to open its TLS later */
+	psTls = TLS_Open(HostTlsInit);
+
+	if (psTls == IMG_NULL || IMGEGLGetTLSValue() != psTls)
+	{
+		Fail("TLS_Open failed after an earlier failure");
+	}
+
+	pthread_barrier_init(&sBarrier, NULL, ET_MAX_THREADS);
+
+	for (i = 0; i < ET_MAX_THREADS; i++)
+	{
+		pthread_create(&asThreads[i], NULL, OpenTLSThread, &sBarrier);
+	}
+
+	for (i = 0; i < ET_MAX_THREADS; i++)
+	{
+		pthread_join(asThreads[i], &apvTls[i]);
+
+		if (apvTls[i] == IMG_NULL)
+		{
+			Fail("thread %u did not get a stable TLS of its own", i);
+		}
+
+		for (j = 0; j < i; j++)
+		{
+			if (apvTls[i] == apvTls[j])
+			{
+				Fail("threads %u and %u shared a TLS", j, i);
+			}
+		}
+
+		if (apvTls[i] == psTls)
+		{
+			Fail("thread %u got the main thread's TLS", i);
+		}
+	}
+
+	pthread_barrier_destroy(&sBarrier);
+
+	if (IMGEGLGetTLSValue() != psTls)
+	{
+		Fail("other threads changed the main thread's TLS");
+	}
+
+	TLS_Close(HostTlsDeinit);
+}
+
+
+/***********************************************************************************
+ Function Name      : ListHasSurface
+ Inputs             : psDpy, psInputSurface
+ Outputs            : -
+ Returns            : IMG_TRUE if the surface is on the display's list
+ Description        : As IsEGLSurface in khronos_egl.c, without the
+					  EGL_NO_SURFACE case
+************************************************************************************/
+static IMG_BOOL ListHasSurface(KEGL_DISPLAY *psDpy, KEGL_SURFACE *psInputSurface)
+{
+	KEGL_SURFACE *psSurface;
+
+	for (psSurface = psDpy->psHeadSurface; psSurface != IMG_NULL; psSurface = psSurface->psNextSurface)
+	{
+		if (psSurface == psInputSurface)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : ListHasContext
+ Inputs             : psDpy, psInputContext
+ Outputs            : -
+ Returns            : IMG_TRUE if the context is on the display's list
+ Description        : As IsEGLContext in khronos_egl.c, without the
+					  EGL_NO_CONTEXT case
+************************************************************************************/
+static IMG_BOOL ListHasContext(KEGL_DISPLAY *psDpy, KEGL_CONTEXT *psInputContext)
+{
+	KEGL_CONTEXT *psContext;
+
+	for (psContext = psDpy->psHeadContext; psContext != IMG_NULL; psContext = psContext->psNextContext)
+	{
+		if (psContext == psInputContext)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : IsBoundSurface
+ Inputs             : psTls, psSurface
+ Outputs            : -
+ Returns            : IMG_TRUE if the surface is bound to the thread for any API
+ Description        : eglDestroySurface defers the destruction of these
+************************************************************************************/
+static IMG_BOOL IsBoundSurface(TLS psTls, KEGL_SURFACE *psSurface)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < IMGEGL_NUMBER_OF_APIS; i++)
+	{
+		if (psTls->apsCurrentDrawSurface[i] == psSurface || psTls->apsCurrentReadSurface[i] == psSurface)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : IsBoundContext
+ Inputs             : psTls, psContext
+ Outputs            : -
+ Returns            : IMG_TRUE if the context is current to the thread for any API
+ Description        : eglDestroyContext defers the destruction of these
+************************************************************************************/
+static IMG_BOOL IsBoundContext(TLS psTls, KEGL_CONTEXT *psContext)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < IMGEGL_NUMBER_OF_APIS; i++)
+	{
+		if (psTls->apsCurrentContext[i] == psContext)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : PickListedSurface
+ Inputs             : psDpy
+ Outputs            : -
+ Returns            : A random surface on the display's list, or EGL_NO_SURFACE
+ Description        : Chooses a surface for a make-current
+************************************************************************************/
+static KEGL_SURFACE *PickListedSurface(KEGL_DISPLAY *psDpy)
+{
+	KEGL_SURFACE *psSurface;
+	IMG_UINT32 ui32Count = 0, ui32Pick;
+
+	for (psSurface = psDpy->psHeadSurface; psSurface != IMG_NULL; psSurface = psSurface->psNextSurface)
+	{
+		ui32Count++;
+	}
+
+	ui32Pick = Random(ui32Count + 1);
+
+	for (psSurface = psDpy->psHeadSurface; psSurface != IMG_NULL && ui32Pick; psSurface = psSurface->psNextSurface)
+	{
+		ui32Pick--;
+	}
+
+	return psSurface;
+}
+
+
+/***********************************************************************************
+ Function Name      : PickListedContext
+ Inputs             : psDpy
+ Outputs            : -
+ Returns            : A random context on the display's list, or EGL_NO_CONTEXT
+ Description        : Chooses a context for a make-current
+************************************************************************************/
+static KEGL_CONTEXT *PickListedContext(KEGL_DISPLAY *psDpy)
+{
+	KEGL_CONTEXT *psContext;
+	IMG_UINT32 ui32Count = 0, ui32Pick;
+
+	for (psContext = psDpy->psHeadContext; psContext != IMG_NULL; psContext = psContext->psNextContext)
+	{
+		ui32Count++;
+	}
+
+	ui32Pick = Random(ui32Count + 1);
+
+	for (psContext = psDpy->psHeadContext; psContext != IMG_NULL && ui32Pick; psContext = psContext->psNextContext)
+	{
+		ui32Pick--;
+	}
+
+	return psContext;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckBindings
+ Inputs             : psTls, asDpy, apsSurfaces, apsContexts
+ Outputs            : -
+ Returns            : -
+ Description        : Looks every surface and context, plus the null handles,
+					  up on every display and compares the lock-free checks
+					  with the thread's bindings and the display lists
+************************************************************************************/
+static IMG_VOID CheckBindings(TLS psTls, KEGL_DISPLAY *asDpy, KEGL_SURFACE **apsSurfaces,
+							  KEGL_CONTEXT **apsContexts)
+{
+	IMG_UINT32 ui32API = psTls->ui32API;
+	IMG_UINT32 i, j;
+
+	for (j = 0; j < ET_NUM_DISPLAYS; j++)
+	{
+		KEGL_DISPLAY *psDpy = &asDpy[j];
+
+		for (i = 0; i <= ET_NUM_SURFACES; i++)
+		{
+			KEGL_SURFACE *psSurface = (i < ET_NUM_SURFACES) ? apsSurfaces[i] : EGL_NO_SURFACE;
+			IMG_BOOL bExpected = IMG_FALSE, bCurrent;
+
+			if (psSurface != EGL_NO_SURFACE && ui32API < IMGEGL_NUMBER_OF_APIS &&
+				(psTls->apsCurrentDrawSurface[ui32API] == psSurface ||
+				 psTls->apsCurrentReadSurface[ui32API] == psSurface) &&
+				psSurface->psDpy == psDpy)
+			{
+				bExpected = IMG_TRUE;
+			}
+
+			bCurrent = IsCurrentEGLSurface(psTls, psDpy, psSurface);
+
+			g_ui32SurfaceChecks++;
+
+			if (bCurrent != bExpected)
+			{
+				Fail("IsCurrentEGLSurface gave %u for surface %u on display %u, API %u", bCurrent, i, j, ui32API);
+			}
+
+			if (bCurrent)
+			{
+				g_ui32SurfaceHits++;
+
+				if (!ListHasSurface(psDpy, psSurface))
+				{
+					Fail("surface %u was accepted on display %u but is not on its list", i, j);
+				}
+			}
+		}
+
+		for (i = 0; i <= ET_NUM_CONTEXTS; i++)
+		{
+			KEGL_CONTEXT *psContext = (i < ET_NUM_CONTEXTS) ? apsContexts[i] : EGL_NO_CONTEXT;
+			IMG_BOOL bExpected = IMG_FALSE, bCurrent;
+
+			if (psContext != EGL_NO_CONTEXT && ui32API < IMGEGL_NUMBER_OF_APIS &&
+				psTls->apsCurrentContext[ui32API] == psContext &&
+				psContext->psDpy == psDpy)
+			{
+				bExpected = IMG_TRUE;
+			}
+
+			bCurrent = IsCurrentEGLContext(psTls, psDpy, psContext);
+
+			if (bCurrent != bExpected)
+			{
+				Fail("IsCurrentEGLContext gave %u for context %u on display %u, API %u", bCurrent, i, j, ui32API);
+			}
+
+			if (bCurrent && !ListHasContext(psDpy, psContext))
+			{
+				Fail("context %u was accepted on display %u but is not on its list", i, j);
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : RunBindingSequence
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : Applies random creations, destructions, make-currents
+					  and API binds, checking every lookup after each
+************************************************************************************/
+static IMG_VOID RunBindingSequence(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	KEGL_DISPLAY asDpy[ET_NUM_DISPLAYS];
+	KEGL_SURFACE *apsSurfaces[ET_NUM_SURFACES];
+	KEGL_CONTEXT *apsContexts[ET_NUM_CONTEXTS];
+	IMG_BOOL abSurfaceListed[ET_NUM_SURFACES], abContextListed[ET_NUM_CONTEXTS];
+	struct tls_tag sTls;
+	IMG_UINT32 ui32Step, i, ui32Errors = g_ui32NumErrors;
+
+	memset(asDpy, 0, sizeof(asDpy));
+	memset(abSurfaceListed, 0, sizeof(abSurfaceListed));
+	memset(abContextListed, 0, sizeof(abContextListed));
+	memset(&sTls, 0, sizeof(sTls));
+
+	/* The API stays unbound until the first eglBindAPI */
+	HostTlsInit(&sTls);
+
+	for (i = 0; i < ET_NUM_SURFACES; i++)
+	{
+		apsSurfaces[i] = calloc(1, sizeof(KEGL_SURFACE));
+	}
+
+	for (i = 0; i < ET_NUM_CONTEXTS; i++)
+	{
+		apsContexts[i] = calloc(1, sizeof(KEGL_CONTEXT));
+	}
+
+	for (ui32Step = 0; ui32Step < ui32Steps && g_ui32NumErrors == ui32Errors; ui32Step++)
+	{
+		switch (Random(6))
+		{
+			case 0:
+			{
+				/* eglCreate*Surface: a surface is put on the head of its display's list */
+				i = Random(ET_NUM_SURFACES);
+
+				if (!abSurfaceListed[i])
+				{
+					KEGL_DISPLAY *psDpy = &asDpy[Random(ET_NUM_DISPLAYS)];
+
+					apsSurfaces[i]->psDpy = psDpy;
+					apsSurfaces[i]->psNextSurface = psDpy->psHeadSurface;
+					psDpy->psHeadSurface = apsSurfaces[i];
+					abSurfaceListed[i] = IMG_TRUE;
+				}
+
+				/* eglCreateContext */
+				i = Random(ET_NUM_CONTEXTS);
+
+				if (!abContextListed[i])
+				{
+					KEGL_DISPLAY *psDpy = &asDpy[Random(ET_NUM_DISPLAYS)];
+
+					apsContexts[i]->psDpy = psDpy;
+					apsContexts[i]->psNextContext = psDpy->psHeadContext;
+					psDpy->psHeadContext = apsContexts[i];
+					abContextListed[i] = IMG_TRUE;
+				}
+
+				break;
+			}
+			case 1:
+			{
+				/* eglDestroySurface: only surfaces that are not bound leave the list */
+				i = Random(ET_NUM_SURFACES);
+
+				if (abSurfaceListed[i] && !IsBoundSurface(&sTls, apsSurfaces[i]))
+				{
+					KEGL_SURFACE **ppsLink = &apsSurfaces[i]->psDpy->psHeadSurface;
+
+					while (*ppsLink != apsSurfaces[i])
+					{
+						ppsLink = &(*ppsLink)->psNextSurface;
+					}
+
+					*ppsLink = apsSurfaces[i]->psNextSurface;
+					abSurfaceListed[i] = IMG_FALSE;
+				}
+
+				/* eglDestroyContext */
+				i = Random(ET_NUM_CONTEXTS);
+
+				if (abContextListed[i] && !IsBoundContext(&sTls, apsContexts[i]))
+				{
+					KEGL_CONTEXT **ppsLink = &apsContexts[i]->psDpy->psHeadContext;
+
+					while (*ppsLink != apsContexts[i])
+					{
+						ppsLink = &(*ppsLink)->psNextContext;
+					}
+
+					*ppsLink = apsContexts[i]->psNextContext;
+					abContextListed[i] = IMG_FALSE;
+				}
+
+				break;
+			}
+			case 2:
+			case 3:
+			{
+				/* eglMakeCurrent for the bound API, or release when no API is bound */
+				KEGL_DISPLAY *psDpy = &asDpy[Random(ET_NUM_DISPLAYS)];
+
+				if (sTls.ui32API < IMGEGL_NUMBER_OF_APIS)
+				{
+					sTls.apsCurrentDrawSurface[sTls.ui32API] = PickListedSurface(psDpy);
+					sTls.apsCurrentReadSurface[sTls.ui32API] = Random(2) ? sTls.apsCurrentDrawSurface[sTls.ui32API] :
+																		   PickListedSurface(psDpy);
+					sTls.apsCurrentContext[sTls.ui32API] = PickListedContext(psDpy);
+				}
+
+				break;
+			}
+			case 4:
+			{
+				/* eglBindAPI */
+				sTls.ui32API = Random(IMGEGL_NUMBER_OF_APIS);
+
+				break;
+			}
+			default:
+			{
+				/* A surface or context already on one display is looked up on another */
+				break;
+			}
+		}
+
+		CheckBindings(&sTls, asDpy, apsSurfaces, apsContexts);
+	}
+
+	if (g_ui32NumErrors != ui32Errors)
+	{
+		fprintf(stderr, "error: binding sequence %u failed at step %u\n", ui32Run, ui32Step - 1);
+	}
+
+	for (i = 0; i < ET_NUM_SURFACES; i++)
+	{
+		free(apsSurfaces[i]);
+	}
+
+	for (i = 0; i < ET_NUM_CONTEXTS; i++)
+	{
+		free(apsContexts[i]);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostLoadWSModule
+ Inputs             : psDisplay, bFail
+ Outputs            : psDisplay
+ Returns            : Module handle, or IMG_NULL if loading failed
+ Description        : As LoadWSModule in generic_ws.c, whose failure path
+					  clears the function table
+************************************************************************************/
+static IMG_HANDLE HostLoadWSModule(KEGL_DISPLAY *psDisplay, IMG_BOOL bFail)
+{
+	if (bFail)
+	{
+		psDisplay->pWSEGL_FT = IMG_NULL;
+
+		return IMG_NULL;
+	}
+
+	psDisplay->pWSEGL_FT = &g_sWSEGLFunctions;
+
+	return (IMG_HANDLE)&g_sWSEGLFunctions;
+}
+
+
+/***********************************************************************************
+ Function Name      : LockedGetDisplay
+ Inputs             : psDisplay, pdpyCount, nativeDisplay, bLoadFails
+ Outputs            : psDisplay, pdpyCount
+ Returns            : EGLDisplay, or EGL_NO_DISPLAY
+ Description        : As the slot scan IMGeglGetDisplay makes under the global
+					  lock, with the window system module load mocked
+************************************************************************************/
+static EGLDisplay LockedGetDisplay(KEGL_DISPLAY *psDisplay, EGLint *pdpyCount, NativeDisplayType nativeDisplay,
+								   IMG_BOOL bLoadFails)
+{
+	IMG_UINT32 ui32Slot;
+	IMG_BOOL bSeenBefore = IMG_FALSE;
+
+	for (ui32Slot = 0; ui32Slot < EGL_MAX_NUM_DISPLAYS; ui32Slot++)
+	{
+		if (psDisplay[ui32Slot].nativeDisplay == nativeDisplay)
+		{
+			if (psDisplay[ui32Slot].pWSEGL_FT)
+			{
+				bSeenBefore = IMG_TRUE;
+			}
+			break;
+		}
+
+		if (psDisplay[ui32Slot].pWSEGL_FT == IMG_NULL)
+		{
+			break;
+		}
+	}
+
+	if (ui32Slot == EGL_MAX_NUM_DISPLAYS)
+	{
+		return EGL_NO_DISPLAY;
+	}
+
+	if (!psDisplay[ui32Slot].hWSDrv)
+	{
+		psDisplay[ui32Slot].hWSDrv = HostLoadWSModule(&psDisplay[ui32Slot], bLoadFails);
+
+		if (!psDisplay[ui32Slot].hWSDrv)
+		{
+			return EGL_NO_DISPLAY;
+		}
+
+		if (!bSeenBefore)
+		{
+			(*pdpyCount)++;
+		}
+	}
+
+	psDisplay[ui32Slot].nativeDisplay = nativeDisplay;
+
+	return (EGLDisplay)(IMG_UINTPTR_T)(ui32Slot + 1);
+}
+
+
+/***********************************************************************************
+ Function Name      : HostGetDisplay
+ Inputs             : psTls, nativeDisplay, bLoadFails
+ Outputs            : psTls
+ Returns            : EGLDisplay, or EGL_NO_DISPLAY
+ Description        : As IMGeglGetDisplay: the thread's cached display, or the
+					  locked slot scan, whose answer is then cached
+************************************************************************************/
+static EGLDisplay HostGetDisplay(TLS psTls, NativeDisplayType nativeDisplay, IMG_BOOL bLoadFails)
+{
+	EGLDisplay eglDpy;
+
+	eglDpy = GetCachedEGLDisplay(psTls, nativeDisplay);
+
+	if (eglDpy != EGL_NO_DISPLAY)
+	{
+		return eglDpy;
+	}
+
+	pthread_mutex_lock(&g_sGlobalLock);
+
+	eglDpy = LockedGetDisplay(psTls->psGlobalData->asDisplay, &psTls->psGlobalData->dpyCount, nativeDisplay,
+							  bLoadFails);
+
+	pthread_mutex_unlock(&g_sGlobalLock);
+
+	if (eglDpy != EGL_NO_DISPLAY)
+	{
+		psTls->hCachedNativeDisplay = nativeDisplay;
+		psTls->eglCachedDisplay     = eglDpy;
+	}
+
+	return eglDpy;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunDisplaySequence
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : Applies random eglGetDisplay and eglTerminate calls from
+					  several threads' TLS to the cached lookup and to a
+					  locked-only copy of the display table, comparing the
+					  results and the tables after each
+************************************************************************************/
+static IMG_VOID RunDisplaySequence(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	static KEGL_DISPLAY asRefDisplay[EGL_MAX_NUM_DISPLAYS];
+	struct tls_tag asTls[ET_NUM_THREADS];
+	EGLint dpyRefCount = 0;
+	IMG_UINT32 ui32Step, i, ui32Errors = g_ui32NumErrors;
+
+	memset(&g_sGlobal, 0, sizeof(g_sGlobal));
+	memset(asRefDisplay, 0, sizeof(asRefDisplay));
+	memset(asTls, 0, sizeof(asTls));
+
+	for (i = 0; i < ET_NUM_THREADS; i++)
+	{
+		HostTlsInit(&asTls[i]);
+	}
+
+	for (ui32Step = 0; ui32Step < ui32Steps && g_ui32NumErrors == ui32Errors; ui32Step++)
+	{
+		if (Random(4) == 0)
+		{
+			/* eglTerminate unloads the window system module but keeps the slot */
+			i = Random(EGL_MAX_NUM_DISPLAYS);
+
+			g_sGlobal.asDisplay[i].hWSDrv = IMG_NULL;
+			asRefDisplay[i].hWSDrv = IMG_NULL;
+		}
+		else
+		{
+			TLS psTls = &asTls[Random(ET_NUM_THREADS)];
+			/* Native display 0 is EGL_DEFAULT_DISPLAY */
+			NativeDisplayType nativeDisplay = (NativeDisplayType)(IMG_UINTPTR_T)Random(ET_NUM_NATIVES);
+			IMG_BOOL bLoadFails = (Random(8) == 0) ? IMG_TRUE : IMG_FALSE;
+			EGLDisplay eglDpy, eglRefDpy;
+
+			if (GetCachedEGLDisplay(psTls, nativeDisplay) != EGL_NO_DISPLAY)
+			{
+				g_ui32DisplayHits++;
+			}
+
+			g_ui32DisplayCalls++;
+
+			eglDpy = HostGetDisplay(psTls, nativeDisplay, bLoadFails);
+			eglRefDpy = LockedGetDisplay(asRefDisplay, &dpyRefCount, nativeDisplay, bLoadFails);
+
+			if (eglDpy != eglRefDpy)
+			{
+				Fail("eglGetDisplay returned %p where the locked scan gives %p", eglDpy, eglRefDpy);
+			}
+		}
+
+		for (i = 0; i < EGL_MAX_NUM_DISPLAYS; i++)
+		{
+			if (g_sGlobal.asDisplay[i].nativeDisplay != asRefDisplay[i].nativeDisplay ||
+				g_sGlobal.asDisplay[i].hWSDrv != asRefDisplay[i].hWSDrv ||
+				g_sGlobal.asDisplay[i].pWSEGL_FT != asRefDisplay[i].pWSEGL_FT)
+			{
+				Fail("display slot %u differs from the locked scan's", i);
+			}
+		}
+
+		if (g_sGlobal.dpyCount != dpyRefCount)
+		{
+			Fail("display count %d differs from the locked scan's %d", g_sGlobal.dpyCount, dpyRefCount);
+		}
+	}
+
+	if (g_ui32NumErrors != ui32Errors)
+	{
+		fprintf(stderr, "error: display sequence %u failed at step %u\n", ui32Run, ui32Step - 1);
+	}
+}
+
+
+/*
+** Benchmark
+*/
+
+typedef struct BenchThread_TAG
+{
+	pthread_t sThread;
+	pthread_barrier_t *psBarrier;
+
+	IMG_UINT32 ui32Case;
+	IMG_BOOL bNew;
+	IMG_UINT32 ui32Calls;
+
+	KEGL_DISPLAY *psDpy;
+	KEGL_SURFACE *psSurface;
+
+	IMG_UINT32 ui32Accepted;
+
+} BenchThread;
+
+static IMG_UINT32 g_ui32BenchSurfaces = ET_DEFAULT_SURFACES;
+
+
+/***********************************************************************************
+ Function Name      : BenchThreadMain
+ Inputs             : pvArg - the thread's BenchThread
+ Outputs            : -
+ Returns            : IMG_NULL
+ Description        : Makes its surface current, then repeats one case the old
+					  way or the new way, opening the TLS on each call as the
+					  entry points do
+************************************************************************************/
+static IMG_VOID *BenchThreadMain(IMG_VOID *pvArg)
+{
+	BenchThread *psBench = (BenchThread *)pvArg;
+	NativeDisplayType nativeDisplay = (NativeDisplayType)(IMG_UINTPTR_T)1;
+	TLS psTls = TLS_Open(HostTlsInit);
+	IMG_UINT32 i, ui32Accepted = 0;
+
+	if (psTls == IMG_NULL)
+	{
+		Fail("benchmark thread could not open its TLS");
+		pthread_barrier_wait(psBench->psBarrier);
+		return IMG_NULL;
+	}
+
+	psTls->ui32API = 0;
+	psTls->apsCurrentDrawSurface[0] = psBench->psSurface;
+	psTls->apsCurrentReadSurface[0] = psBench->psSurface;
+
+	/* Prime the display cache as the first eglGetDisplay would */
+	HostGetDisplay(psTls, nativeDisplay, IMG_FALSE);
+
+	pthread_barrier_wait(psBench->psBarrier);
+
+	for (i = 0; i < psBench->ui32Calls; i++)
+	{
+		psTls = TLS_Open(HostTlsInit);
+
+		switch (psBench->ui32Case)
+		{
+			case ET_CASE_SURFACE:
+			{
+				/* eglQuerySurface / eglSwapBuffers handle check */
+				if (psBench->bNew)
+				{
+					if (IsCurrentEGLSurface(psTls, psBench->psDpy, psBench->psSurface) ||
+						ListHasSurface(psBench->psDpy, psBench->psSurface))
+					{
+						ui32Accepted++;
+					}
+				}
+				else if (ListHasSurface(psBench->psDpy, psBench->psSurface))
+				{
+					ui32Accepted++;
+				}
+
+				break;
+			}
+			case ET_CASE_SWAPCOUNT:
+			{
+				/* eglSwapBuffers swap count update */
+				if (psBench->bNew)
+				{
+					psBench->psSurface->u.window.ui32SwapCount++;
+				}
+				else
+				{
+					pthread_mutex_lock(&g_sGlobalLock);
+					psBench->psSurface->u.window.ui32SwapCount++;
+					pthread_mutex_unlock(&g_sGlobalLock);
+				}
+
+				ui32Accepted++;
+
+				break;
+			}
+			default:
+			{
+				/* eglGetDisplay */
+				EGLDisplay eglDpy;
+
+				if (psBench->bNew)
+				{
+					eglDpy = HostGetDisplay(psTls, nativeDisplay, IMG_FALSE);
+				}
+				else
+				{
+					pthread_mutex_lock(&g_sGlobalLock);
+					eglDpy = LockedGetDisplay(g_sGlobal.asDisplay, &g_sGlobal.dpyCount, nativeDisplay, IMG_FALSE);
+					pthread_mutex_unlock(&g_sGlobalLock);
+				}
+
+				if (eglDpy != EGL_NO_DISPLAY)
+				{
+					ui32Accepted++;
+				}
+
+				break;
+			}
+		}
+	}
+
+	psBench->ui32Accepted = ui32Accepted;
+
+	TLS_Close(HostTlsDeinit);
+
+	return IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeCase
+ Inputs             : ui32Case, bNew, ui32Threads, ui32Calls, psDpy, apsSurfaces
+ Outputs            : -
+ Returns            : Wall time in seconds for all threads to finish
+ Description        : Runs one case on ui32Threads threads at once, each with
+					  its own current surface
+************************************************************************************/
+static double TimeCase(IMG_UINT32 ui32Case, IMG_BOOL bNew, IMG_UINT32 ui32Threads, IMG_UINT32 ui32Calls,
+					   KEGL_DISPLAY *psDpy, KEGL_SURFACE **apsSurfaces)
+{
+	BenchThread asBench[ET_MAX_THREADS];
+	pthread_barrier_t sBarrier;
+	double fStart, fTime;
+	IMG_UINT32 i;
+
+	pthread_barrier_init(&sBarrier, NULL, ui32Threads + 1);
+
+	for (i = 0; i < ui32Threads; i++)
+	{
+		asBench[i].psBarrier = &sBarrier;
+		asBench[i].ui32Case = ui32Case;
+		asBench[i].bNew = bNew;
+		asBench[i].ui32Calls = ui32Calls;
+		asBench[i].psDpy = psDpy;
+		/* The oldest surfaces are at the tail of the display's list */
+		asBench[i].psSurface = apsSurfaces[i];
+		asBench[i].ui32Accepted = 0;
+
+		pthread_create(&asBench[i].sThread, NULL, BenchThreadMain, &asBench[i]);
+	}
+
+	pthread_barrier_wait(&sBarrier);
+
+	fStart = GetSeconds();
+
+	for (i = 0; i < ui32Threads; i++)
+	{
+		pthread_join(asBench[i].sThread, NULL);
+	}
+
+	fTime = GetSeconds() - fStart;
+
+	pthread_barrier_destroy(&sBarrier);
+
+	for (i = 0; i < ui32Threads; i++)
+	{
+		if (asBench[i].ui32Accepted != ui32Calls)
+		{
+			Fail("benchmark case %u thread %u: %u of %u calls succeeded", ui32Case, i, asBench[i].ui32Accepted, ui32Calls);
+		}
+	}
+
+	return fTime;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunBenchmark
+ Inputs             : ui32Calls
+ Outputs            : -
+ Returns            : -
+ Description        : Times each case old and new on 1, 2 and 4 threads and
+					  prints the time per call and the total call rate
+************************************************************************************/
+static IMG_VOID RunBenchmark(IMG_UINT32 ui32Calls)
+{
+	static const IMG_CHAR *apszCases[ET_NUM_CASES] = {"surface check", "swap count", "eglGetDisplay"};
+	static const IMG_UINT32 aui32Threads[] = {1, 2, 4};
+	KEGL_DISPLAY *psDpy;
+	KEGL_SURFACE **apsSurfaces;
+	IMG_UINT32 ui32Case, ui32Threads, i;
+
+	memset(&g_sGlobal, 0, sizeof(g_sGlobal));
+
+	/* One loaded display in slot 0, for native display 1 */
+	psDpy = &g_sGlobal.asDisplay[0];
+	psDpy->nativeDisplay = (NativeDisplayType)(IMG_UINTPTR_T)1;
+	psDpy->pWSEGL_FT = &g_sWSEGLFunctions;
+	psDpy->hWSDrv = (IMG_HANDLE)&g_sWSEGLFunctions;
+	g_sGlobal.dpyCount = 1;
+
+	if (g_ui32BenchSurfaces < ET_MAX_THREADS)
+	{
+		g_ui32BenchSurfaces = ET_MAX_THREADS;
+	}
+
+	apsSurfaces = calloc(g_ui32BenchSurfaces, sizeof(KEGL_SURFACE *));
+
+	for (i = 0; i < g_ui32BenchSurfaces; i++)
+	{
+		apsSurfaces[i] = calloc(1, sizeof(KEGL_SURFACE));
+		apsSurfaces[i]->psDpy = psDpy;
+		apsSurfaces[i]->psNextSurface = psDpy->psHeadSurface;
+		psDpy->psHeadSurface = apsSurfaces[i];
+	}
+
+	printf("%u calls per thread, %u surfaces on the display, %ld CPUs online\n",
+		   ui32Calls, g_ui32BenchSurfaces, sysconf(_SC_NPROCESSORS_ONLN));
+	printf("%-14s %7s %11s %11s %8s %13s %13s\n", "case", "threads", "old ns", "new ns", "speedup",
+		   "old Mcalls/s", "new Mcalls/s");
+
+	for (ui32Case = 0; ui32Case < ET_NUM_CASES; ui32Case++)
+	{
+		for (ui32Threads = 0; ui32Threads < sizeof(aui32Threads) / sizeof(aui32Threads[0]); ui32Threads++)
+		{
+			IMG_UINT32 ui32NumThreads = aui32Threads[ui32Threads];
+			double fOld, fNew;
+
+			fOld = TimeCase(ui32Case, IMG_FALSE, ui32NumThreads, ui32Calls, psDpy, apsSurfaces);
+			fNew = TimeCase(ui32Case, IMG_TRUE, ui32NumThreads, ui32Calls, psDpy, apsSurfaces);
+
+			printf("%-14s %7u %11.2f %11.2f %7.2fx %13.2f %13.2f\n", apszCases[ui32Case], ui32NumThreads,
+				   fOld * 1e9 / ui32Calls, fNew * 1e9 / ui32Calls, fOld / fNew,
+				   ui32NumThreads * (double)ui32Calls / fOld * 1e-6,
+				   ui32NumThreads * (double)ui32Calls / fNew * 1e-6);
+		}
+	}
+
+	for (i = 0; i < g_ui32BenchSurfaces; i++)
+	{
+		free(apsSurfaces[i]);
+	}
+
+	free(apsSurfaces);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = ET_DEFAULT_RUNS, ui32Steps = ET_DEFAULT_STEPS, ui32Calls = ET_DEFAULT_CALLS;
+	IMG_UINT32 ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			ui32Steps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-calls=", strlen("-calls=")) == 0)
+		{
+			ui32Calls = strtoul(argv[1] + strlen("-calls="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-surfaces=", strlen("-surfaces=")) == 0)
+		{
+			g_ui32BenchSurfaces = strtoul(argv[1] + strlen("-surfaces="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: egltls [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	CheckTLSOpen();
+
+	printf("TLS open, reuse, failure and per-thread checks done\n");
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunBindingSequence(i, ui32Steps);
+	}
+
+	printf("%u binding sequences of %u steps (seed %u): %u of %u surface lookups took the current-surface path\n",
+		   i, ui32Steps, ui32Seed, g_ui32SurfaceHits, g_ui32SurfaceChecks);
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunDisplaySequence(i, ui32Steps);
+	}
+
+	printf("%u display sequences of %u steps: %u of %u eglGetDisplay calls hit the thread's cache\n",
+		   i, ui32Steps, g_ui32DisplayHits, g_ui32DisplayCalls);
+
+	if (ui32Calls && !g_ui32NumErrors)
+	{
+		RunBenchmark(ui32Calls);
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without
+# the express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host build of the GLSL ES compiler stack and the offline binary shader
+# compiler. The compiler is built with the same feature defines as the
+# opengles2 driver so the binaries it writes load through glShaderBinary
+# and glProgramBinaryOES unchanged.
+#
+
+modules := esbincompiler
+
+esbincompiler_type := host_executable
+
+esbincompiler_src = \
+ main.c \
+ $(TOP)/intermediates/glslparser/glsl_parser.tab.c \
+ $(TOP)/tools/intern/oglcompiler/binshader/esbinshader.c \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/glsl/, \
+  astbuiltin.c common.c error.c glsl.c glslfns.c glsltabs.c glsltree.c \
+  icbuiltin.c icemul.c icgen.c icode.c icunroll.c prepro.c semantic.c) \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/parser/, \
+  glsldebug.c lex.c memmgr.c parser_metrics.c parser.c symtab.c) \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/powervr/, \
+  bindingsym.c glsl2uf.c ic2uf.c) \
+ $(addprefix $(TOP)/tools/intern/usc2/, \
+  asm.c cdg.c cfa.c data.c dce.c debug.c dgraph.c domcalc.c dualissue.c \
+  efo.c execpred.c f16opt.c finalise.c groupinst.c hw.c icvt_c10.c \
+  icvt_core.c icvt_f16.c icvt_f16_vec.c icvt_f32.c icvt_f32_vec.c \
+  icvt_i32.c icvt_mem.c indexreg.c inst_usc.c intcvt.c iregalloc.c \
+  iselect.c layout.c pconvert.c precovr.c pregalloc.c regalloc.c \
+  reggroup.c regpack.c reorder.c ssa.c usc.c usc_utils.c usedef.c \
+  uspbin.c vec34.c) \
+ $(addprefix $(TOP)/tools/intern/useasm/, \
+  specialregs.c specialregs_vec.c useasm.c usedisasm.c useopt.c usetab.c \
+  utils.c) \
+ $(addprefix $(TOP)/tools/intern/usp/, \
+  hwinst.c usp.c usp_finalise.c usp_inputdata.c usp_instblock.c \
+  usp_resultref.c usp_sample.c usp_texwrite.c uspshader.c)
+
+# The compiler sources take IMG_ABORT and the USE opcode names from the
+# on-device user-mode build, and every source expects the platform
+# descriptor to be visible.
+esbincompiler_cflags := \
+ -DLINUX -DUSER -D'IMG_ABORT()=abort()' -DSTANDALONE -DGLSL_ES -DGEN_HW_CODE -DOUTPUT_USPBIN \
+ -DINCLUDE_SGX_FEATURE_TABLE -DINCLUDE_SGX_BUG_TABLE -DSUPPORT_SGX543 \
+ -DSUPPORT_BINARY_SHADER -DSUPPORT_SOURCE_SHADER \
+ -DGLES2_EXTENSION_GET_PROGRAM_BINARY \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h
+
+# eurasiacon/opengles2 is only searched for constants.h and must come last:
+# its metrics.h would otherwise shadow the compiler's.
+esbincompiler_includes := include/gpu_es4 \
+ include/gpu_es4/eurasia/hwdefs include/gpu_es4/eurasia/include4 \
+ tools/intern/usp tools/intern/usc2 tools/intern/useasm \
+ tools/intern/oglcompiler/glsl tools/intern/oglcompiler/parser \
+ tools/intern/oglcompiler/powervr tools/intern/oglcompiler/binshader \
+ intermediates/glslparser intermediates/sgxsupport intermediates/errata \
+ eurasiacon/opengles2
+
+esbincompiler_extlibs := m
+
+ifeq ($(BUILD),debug)
+esbincompiler_cflags += -DDEBUG -DDUMP_LOGFILES
+endif
@@ -0,0 +1,17 @@
+/* Separable Gaussian blur using bilinear taps between texels */
+uniform sampler2D sTexture;
+
+varying mediump vec2 TexCoord;
+varying mediump vec2 TexCoordOffsets[4];
+
+void main()
+{
+	lowp vec4 colour = texture2D(sTexture, TexCoord) * 0.2270270270;
+
+	colour += texture2D(sTexture, TexCoordOffsets[0]) * 0.0702702703;
+	colour += texture2D(sTexture, TexCoordOffsets[1]) * 0.3162162162;
+	colour += texture2D(sTexture, TexCoordOffsets[2]) * 0.3162162162;
+	colour += texture2D(sTexture, TexCoordOffsets[3]) * 0.0702702703;
+
+	gl_FragColor = colour;
+}
@@ -0,0 +1,18 @@
+/* Full screen quad for post processing passes */
+attribute highp vec2 inVertex;
+
+uniform mediump vec2 TexelOffset;
+
+varying mediump vec2 TexCoord;
+varying mediump vec2 TexCoordOffsets[4];
+
+void main()
+{
+	gl_Position = vec4(inVertex, 0.0, 1.0);
+
+	TexCoord = inVertex * 0.5 + 0.5;
+	TexCoordOffsets[0] = TexCoord - TexelOffset * 3.0;
+	TexCoordOffsets[1] = TexCoord - TexelOffset;
+	TexCoordOffsets[2] = TexCoord + TexelOffset;
+	TexCoordOffsets[3] = TexCoord + TexelOffset * 3.0;
+}
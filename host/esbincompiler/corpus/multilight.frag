@@ -0,0 +1,10 @@
+/* Blends the lit vertex colour towards the fog colour */
+uniform lowp vec4 FogColour;
+
+varying lowp vec4 Colour;
+varying lowp float FogFactor;
+
+void main()
+{
+	gl_FragColor = mix(FogColour, Colour, FogFactor);
+}
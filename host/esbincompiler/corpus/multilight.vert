@@ -0,0 +1,83 @@
+/* Fixed-function style vertex lighting with fog, as emitted for GLES1 content ports */
+#define MAX_LIGHTS 4
+
+struct Light
+{
+	highp vec4 position;
+	lowp vec4 ambient;
+	lowp vec4 diffuse;
+	lowp vec4 specular;
+	mediump vec3 attenuation;
+	mediump float spotCutoff;
+	mediump vec3 spotDirection;
+	mediump float spotExponent;
+};
+
+attribute highp vec4 inVertex;
+attribute mediump vec3 inNormal;
+attribute lowp vec4 inColour;
+
+uniform highp mat4 ModelViewMatrix;
+uniform highp mat4 ProjectionMatrix;
+uniform mediump mat3 NormalMatrix;
+uniform Light Lights[MAX_LIGHTS];
+uniform mediump int NumLights;
+uniform lowp vec4 SceneAmbient;
+uniform mediump float MaterialShininess;
+uniform mediump vec2 FogRange;
+
+varying lowp vec4 Colour;
+varying lowp float FogFactor;
+
+lowp vec4 ApplyLight(Light light, highp vec3 eyePos, mediump vec3 normal)
+{
+	mediump vec3 lightVec = light.position.xyz - eyePos * light.position.w;
+	mediump float dist = length(lightVec);
+	mediump float attenuation = 1.0;
+
+	lightVec /= dist;
+
+	if (light.position.w != 0.0)
+	{
+		attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * dist + light.attenuation.z * dist * dist);
+	}
+
+	if (light.spotCutoff < 180.0)
+	{
+		mediump float spotDot = dot(-lightVec, normalize(light.spotDirection));
+
+		attenuation *= spotDot < cos(radians(light.spotCutoff)) ? 0.0 : pow(max(spotDot, 0.0), light.spotExponent);
+	}
+
+	mediump float nDotL = max(dot(normal, lightVec), 0.0);
+	mediump vec3 halfVec = normalize(lightVec + vec3(0.0, 0.0, 1.0));
+	mediump float nDotH = max(dot(normal, halfVec), 0.0);
+	lowp vec4 colour = light.ambient + light.diffuse * nDotL;
+
+	if (nDotL > 0.0)
+	{
+		colour += light.specular * pow(nDotH, MaterialShininess);
+	}
+
+	return colour * attenuation;
+}
+
+void main()
+{
+	highp vec4 eyePos = ModelViewMatrix * inVertex;
+	mediump vec3 normal = normalize(NormalMatrix * inNormal);
+	lowp vec4 colour = SceneAmbient;
+
+	for (int i = 0; i < MAX_LIGHTS; i++)
+	{
+		if (i < NumLights)
+		{
+			colour += ApplyLight(Lights[i], eyePos.xyz, normal);
+		}
+	}
+
+	Colour = clamp(colour * inColour, 0.0, 1.0);
+	FogFactor = clamp((FogRange.y + eyePos.z) / (FogRange.y - FogRange.x), 0.0, 1.0);
+
+	gl_Position = ProjectionMatrix * eyePos;
+}
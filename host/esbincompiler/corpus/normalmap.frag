@@ -0,0 +1,23 @@
+/* Per-pixel Blinn-Phong from a normal map and a gloss map in the base alpha */
+uniform sampler2D sBaseTex;
+uniform sampler2D sNormalMap;
+uniform lowp vec3 AmbientColour;
+uniform lowp vec3 LightColour;
+uniform mediump float Shininess;
+
+varying mediump vec2 TexCoord;
+varying mediump vec3 LightVec;
+varying mediump vec3 HalfVec;
+
+void main()
+{
+	lowp vec4 base = texture2D(sBaseTex, TexCoord);
+	mediump vec3 normal = normalize(texture2D(sNormalMap, TexCoord).rgb * 2.0 - 1.0);
+	mediump vec3 lightVec = normalize(LightVec);
+	mediump vec3 halfVec = normalize(HalfVec);
+
+	lowp float diffuse = max(dot(normal, lightVec), 0.0);
+	lowp float specular = pow(max(dot(normal, halfVec), 0.0), Shininess) * base.a;
+
+	gl_FragColor = vec4(base.rgb * (AmbientColour + LightColour * diffuse) + LightColour * specular, 1.0);
+}
@@ -0,0 +1,30 @@
+/* Tangent space bump mapping: moves the light and eye vectors into tangent space */
+attribute highp vec4 inVertex;
+attribute mediump vec3 inNormal;
+attribute mediump vec3 inTangent;
+attribute mediump vec2 inTexCoord;
+
+uniform highp mat4 MVPMatrix;
+uniform highp vec3 LightPosModel;
+uniform highp vec3 EyePosModel;
+
+varying mediump vec2 TexCoord;
+varying mediump vec3 LightVec;
+varying mediump vec3 HalfVec;
+
+void main()
+{
+	gl_Position = MVPMatrix * inVertex;
+
+	mediump vec3 binormal = cross(inNormal, inTangent);
+	mediump mat3 tangentSpace = mat3(inTangent.x, binormal.x, inNormal.x,
+									 inTangent.y, binormal.y, inNormal.y,
+									 inTangent.z, binormal.z, inNormal.z);
+
+	mediump vec3 lightDir = normalize(LightPosModel - inVertex.xyz);
+	mediump vec3 eyeDir = normalize(EyePosModel - inVertex.xyz);
+
+	LightVec = tangentSpace * lightDir;
+	HalfVec = tangentSpace * normalize(lightDir + eyeDir);
+	TexCoord = inTexCoord;
+}
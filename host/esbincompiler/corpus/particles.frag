@@ -0,0 +1,9 @@
+/* Soft round point sprites */
+uniform sampler2D sSprite;
+
+varying lowp vec4 Colour;
+
+void main()
+{
+	gl_FragColor = texture2D(sSprite, gl_PointCoord) * Colour;
+}
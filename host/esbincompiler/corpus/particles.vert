@@ -0,0 +1,24 @@
+/* Point sprite particles aged and sized in the shader */
+attribute highp vec3 inPosition;
+attribute highp vec3 inVelocity;
+attribute highp float inBirthTime;
+
+uniform highp mat4 MVPMatrix;
+uniform highp float Time;
+uniform highp float Lifetime;
+uniform highp vec3 Gravity;
+uniform mediump float PointScale;
+
+varying lowp vec4 Colour;
+
+void main()
+{
+	highp float age = Time - inBirthTime;
+	highp float life = clamp(age / Lifetime, 0.0, 1.0);
+	highp vec3 position = inPosition + inVelocity * age + 0.5 * Gravity * age * age;
+
+	gl_Position = MVPMatrix * vec4(position, 1.0);
+	gl_PointSize = life < 1.0 ? PointScale * (1.0 - life) / gl_Position.w : 0.0;
+
+	Colour = mix(vec4(1.0, 0.9, 0.5, 1.0), vec4(0.6, 0.1, 0.0, 0.0), life);
+}
@@ -0,0 +1,36 @@
+/* 3x3 percentage closer filtering of a depth packed RGBA shadow map */
+uniform sampler2D sTexture;
+uniform sampler2D sShadowMap;
+uniform highp vec2 ShadowTexelSize;
+uniform lowp float ShadowAmbient;
+
+varying highp vec4 ShadowCoord;
+varying mediump vec2 TexCoord;
+varying lowp float Diffuse;
+
+highp float UnpackDepth(lowp vec4 packedDepth)
+{
+	const highp vec4 bitShifts = vec4(1.0 / (256.0 * 256.0 * 256.0), 1.0 / (256.0 * 256.0), 1.0 / 256.0, 1.0);
+
+	return dot(packedDepth, bitShifts);
+}
+
+void main()
+{
+	highp vec3 coord = ShadowCoord.xyz / ShadowCoord.w;
+	lowp float lit = 0.0;
+
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			highp float depth = UnpackDepth(texture2D(sShadowMap, coord.xy + vec2(float(x), float(y)) * ShadowTexelSize));
+
+			lit += (coord.z - 0.005 > depth) ? 0.0 : 1.0 / 9.0;
+		}
+	}
+
+	lowp vec4 colour = texture2D(sTexture, TexCoord);
+
+	gl_FragColor = vec4(colour.rgb * (ShadowAmbient + Diffuse * lit), colour.a);
+}
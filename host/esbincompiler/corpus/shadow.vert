@@ -0,0 +1,21 @@
+/* Transforms into light space for shadow map lookups */
+attribute highp vec4 inVertex;
+attribute mediump vec3 inNormal;
+attribute mediump vec2 inTexCoord;
+
+uniform highp mat4 MVPMatrix;
+uniform highp mat4 ShadowMatrix;
+uniform mediump vec3 LightDirModel;
+
+varying highp vec4 ShadowCoord;
+varying mediump vec2 TexCoord;
+varying lowp float Diffuse;
+
+void main()
+{
+	gl_Position = MVPMatrix * inVertex;
+
+	ShadowCoord = ShadowMatrix * inVertex;
+	TexCoord = inTexCoord;
+	Diffuse = max(dot(inNormal, LightDirModel), 0.0);
+}
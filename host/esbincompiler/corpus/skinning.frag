@@ -0,0 +1,13 @@
+/* Modulates a base texture by interpolated lighting */
+uniform sampler2D sTexture;
+
+varying mediump vec2 TexCoord;
+varying lowp float Diffuse;
+varying lowp float Specular;
+
+void main()
+{
+	lowp vec3 texColour = texture2D(sTexture, TexCoord).rgb;
+
+	gl_FragColor = vec4(texColour * Diffuse + vec3(Specular), 1.0);
+}
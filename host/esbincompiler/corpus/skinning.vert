@@ -0,0 +1,50 @@
+/* Four-bone matrix palette skinning with per-vertex diffuse and specular */
+attribute highp vec4 inVertex;
+attribute mediump vec3 inNormal;
+attribute mediump vec2 inTexCoord;
+attribute mediump vec4 inBoneIndex;
+attribute mediump vec4 inBoneWeights;
+
+uniform highp mat4 ViewProjMatrix;
+uniform highp mat4 BoneMatrixArray[8];
+uniform highp mat3 BoneMatrixArrayIT[8];
+uniform mediump vec3 LightPos;
+uniform mediump vec3 EyePos;
+uniform mediump int BoneCount;
+
+varying mediump vec2 TexCoord;
+varying lowp float Diffuse;
+varying lowp float Specular;
+
+void main()
+{
+	highp vec4 position = vec4(0.0);
+	mediump vec3 normal = vec3(0.0);
+	mediump ivec4 boneIndex = ivec4(inBoneIndex);
+	mediump vec4 boneWeights = inBoneWeights;
+
+	for (lowp int i = 0; i < 4; ++i)
+	{
+		if (i < BoneCount)
+		{
+			position += BoneMatrixArray[boneIndex.x] * inVertex * boneWeights.x;
+			normal += BoneMatrixArrayIT[boneIndex.x] * inNormal * boneWeights.x;
+
+			boneIndex = boneIndex.yzwx;
+			boneWeights = boneWeights.yzwx;
+		}
+	}
+
+	gl_Position = ViewProjMatrix * position;
+
+	normal = normalize(normal);
+
+	mediump vec3 lightDir = normalize(LightPos - position.xyz);
+	mediump vec3 eyeDir = normalize(EyePos - position.xyz);
+	mediump vec3 halfVector = normalize(lightDir + eyeDir);
+
+	Diffuse = max(dot(normal, lightDir), 0.0);
+	Specular = Diffuse > 0.0 ? pow(max(dot(normal, halfVector), 0.0), 16.0) : 0.0;
+
+	TexCoord = inTexCoord;
+}
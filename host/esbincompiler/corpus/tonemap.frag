@@ -0,0 +1,43 @@
+/* Bloom composite, exposure, filmic tone curve, vignette and colour grading */
+uniform sampler2D sScene;
+uniform sampler2D sBloom;
+uniform mediump float Exposure;
+uniform mediump float BloomStrength;
+uniform mediump float VignetteStrength;
+uniform mediump mat3 ColourGrade;
+
+varying mediump vec2 TexCoord;
+varying mediump vec2 TexCoordOffsets[4];
+
+mediump vec3 Filmic(mediump vec3 x)
+{
+	const mediump float A = 0.22;
+	const mediump float B = 0.30;
+	const mediump float C = 0.10;
+	const mediump float D = 0.20;
+	const mediump float E = 0.01;
+	const mediump float F = 0.30;
+
+	return ((x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F)) - E / F;
+}
+
+void main()
+{
+	mediump vec3 colour = texture2D(sScene, TexCoord).rgb;
+	mediump vec3 bloom = vec3(0.0);
+
+	for (int i = 0; i < 4; i++)
+	{
+		bloom += texture2D(sBloom, TexCoordOffsets[i]).rgb;
+	}
+
+	colour += bloom * (BloomStrength * 0.25);
+	colour = Filmic(colour * Exposure) / Filmic(vec3(11.2));
+	colour = ColourGrade * colour;
+
+	mediump vec2 centre = TexCoord - 0.5;
+
+	colour *= 1.0 - dot(centre, centre) * VignetteStrength;
+
+	gl_FragColor = vec4(clamp(colour, 0.0, 1.0), 1.0);
+}
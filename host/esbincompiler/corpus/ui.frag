@@ -0,0 +1,10 @@
+/* Font and icon atlas lookups */
+uniform sampler2D sAtlas;
+
+varying mediump vec2 TexCoord;
+varying lowp vec4 Colour;
+
+void main()
+{
+	gl_FragColor = texture2D(sAtlas, TexCoord) * Colour;
+}
@@ -0,0 +1,17 @@
+/* Screen space textured and coloured quads */
+attribute highp vec2 inVertex;
+attribute mediump vec2 inTexCoord;
+attribute lowp vec4 inColour;
+
+uniform highp mat4 ProjectionMatrix;
+
+varying mediump vec2 TexCoord;
+varying lowp vec4 Colour;
+
+void main()
+{
+	gl_Position = ProjectionMatrix * vec4(inVertex, 0.0, 1.0);
+
+	TexCoord = inTexCoord;
+	Colour = inColour;
+}
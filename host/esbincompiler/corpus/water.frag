@@ -0,0 +1,27 @@
+/* Perturbed reflection and refraction lookups blended by a Fresnel term */
+uniform sampler2D sNormalMap;
+uniform sampler2D sReflectionMap;
+uniform sampler2D sRefractionMap;
+uniform lowp vec4 WaterColour;
+uniform mediump float WaveDistortion;
+
+varying mediump vec2 BumpCoord0;
+varying mediump vec2 BumpCoord1;
+varying highp vec4 ProjCoord;
+varying mediump vec3 EyeDir;
+
+void main()
+{
+	mediump vec3 normal = texture2D(sNormalMap, BumpCoord0).rgb + texture2D(sNormalMap, BumpCoord1).rgb - 1.0;
+	highp vec2 screenCoord = (ProjCoord.xy / ProjCoord.w) * 0.5 + 0.5;
+	mediump vec2 offset = normal.xz * WaveDistortion;
+
+	lowp vec4 reflection = texture2D(sReflectionMap, vec2(screenCoord.x, 1.0 - screenCoord.y) + offset);
+	lowp vec4 refraction = texture2D(sRefractionMap, screenCoord - offset) * WaterColour;
+
+	mediump float fresnel = 1.0 - max(dot(normalize(EyeDir), normalize(normal.xzy)), 0.0);
+
+	fresnel = fresnel * fresnel * fresnel;
+
+	gl_FragColor = mix(refraction, reflection, fresnel);
+}
@@ -0,0 +1,36 @@
+/* Summed sine wave displacement for a water surface */
+attribute highp vec4 inVertex;
+
+uniform highp mat4 MVPMatrix;
+uniform highp mat4 ModelMatrix;
+uniform highp vec3 EyePos;
+uniform highp float Time;
+uniform highp vec4 WaveDirs[2];
+uniform highp vec4 WaveParams;
+
+varying mediump vec2 BumpCoord0;
+varying mediump vec2 BumpCoord1;
+varying highp vec4 ProjCoord;
+varying mediump vec3 EyeDir;
+
+void main()
+{
+	highp vec4 position = inVertex;
+	highp float height = 0.0;
+
+	for (int i = 0; i < 2; i++)
+	{
+		highp float phase = dot(WaveDirs[i].xy, position.xz) * WaveDirs[i].z + Time * WaveDirs[i].w;
+
+		height += sin(phase) * WaveParams.x;
+	}
+
+	position.y += height;
+
+	gl_Position = MVPMatrix * position;
+
+	ProjCoord = gl_Position;
+	BumpCoord0 = position.xz * WaveParams.y + vec2(Time * 0.03, Time * 0.01);
+	BumpCoord1 = position.xz * WaveParams.z - vec2(Time * 0.02, Time * 0.04);
+	EyeDir = normalize(EyePos - (ModelMatrix * position).xyz);
+}
@@ -0,0 +1,1109 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Offline GLSL ES to SGX binary shader compiler
+ *
+ * Copyright    : 2002-2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Compiles GLSL ES shaders on the host into the binaries
+ *                accepted by glShaderBinary (one shader) and glProgramBinaryOES
+ *                (a vertex/fragment pair), so that applications can ship
+ *                precompiled shaders and never call glCompileShader on device.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdarg.h>
+#include <ctype.h>
+#if !defined(LINUX)
+#include <io.h>
+#include <time.h>
+#else
+#include <strings.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#define stricmp strcasecmp
+#endif
+
+
+#include "psp2_pvr_desc.h"
+
+#include "sgxdefs.h"
+
+#include "glsl2uf.h"
+#include "esbinshader.h"
+#include "useasm.h"
+
+/* Resource limits are shared with the driver */
+#include "constants.h"
+
+/*
+	Secondary attribute layout. These must match eurasiacon/opengles2/usegles2.h
+	and PVR_MAX_{VS,PS}_SECONDARIES in common/dmscalc/dmscalc.h, which can't be
+	included here as they depend on the services headers.
+*/
+#define GLES2_FRAGMENT_SECATTR_CONSTANTBASE				0x00000000
+#define GLES2_FRAGMENT_SECATTR_INDEXABLETEMPBASE		0x00000001
+#define GLES2_FRAGMENT_SECATTR_SCRATCHBASE				0x00000005
+#define GLES2_FRAGMENT_SECATTR_NUM_RESERVED				0x00000009
+
+#define GLES2_VERTEX_SECATTR_CONSTANTBASE				0x00000000
+#define GLES2_VERTEX_SECATTR_INDEXABLETEMPBASE			0x00000001
+#define GLES2_VERTEX_SECATTR_SCRATCHBASE				0x00000006
+#define GLES2_VERTEX_SECATTR_NUM_RESERVED				0x0000000A
+
+#if(EURASIA_USE_NUM_UNIFIED_REGISTERS > 2048)
+#define PVR_MAX_VS_SECONDARIES			512
+#else
+#define PVR_MAX_VS_SECONDARIES			300
+#endif
+
+#define PVR_MAX_PS_SECONDARIES			128
+
+
+#define ESBC_MAX_LINE_LENGTH		1024
+#define ESBC_MAX_JOBS				64
+
+/* Compile stages that are timed separately */
+typedef enum _ESBC_STAGE_
+{
+	ESBC_STAGE_READ		= 0,
+	ESBC_STAGE_COMPILE	= 1,
+	ESBC_STAGE_PACK		= 2,
+	ESBC_STAGE_WRITE	= 3,
+	ESBC_STAGE_MAX		= 4
+
+} ESBC_STAGE;
+
+static const IMG_CHAR * const g_apszStageNames[ESBC_STAGE_MAX] =
+{
+	"read", "compile", "pack", "write"
+};
+
+/* One line of work: a vertex shader, a fragment shader or both, and where to put the binary */
+typedef struct _ESBC_JOB_
+{
+	IMG_CHAR *pszVertexFile;
+	IMG_CHAR *pszFragmentFile;
+	IMG_CHAR *pszOutputFile;
+
+} ESBC_JOB;
+
+typedef struct _ESBC_OPTIONS_
+{
+	IMG_UINT32	ui32NumTemporaries;
+	IMG_UINT32	ui32PrecisionMask;
+	IMG_UINT32	ui32Warnings;
+	IMG_UINT32	ui32NumParallelJobs;
+	IMG_UINT32	ui32BenchRepeats;
+	IMG_BOOL	bMetrics;
+	IMG_BOOL	bPerf;
+	IMG_BOOL	bLinkVaryings;
+	IMG_BOOL	bQuiet;
+
+} ESBC_OPTIONS;
+
+static IMG_CHAR const* g_pszOptions =
+"-v=FILE        Vertex shader source.\n"
+"-f=FILE        Fragment shader source.\n"
+"-o=FILE        Output binary. With both -v and -f a program binary for\n"
+"               glProgramBinaryOES is written, otherwise a shader binary\n"
+"               for glShaderBinary.\n"
+"-list=FILE     Compile every line of FILE. Each line is\n"
+"               'VERTEX FRAGMENT OUTPUT' and '-' omits a stage.\n"
+"-j=N           Compile a list with N parallel processes.\n"
+"-temps=N       Number of USE temporaries available to a shader. This must\n"
+"               match the driver (sHWInfo.ui32NumUSETemporaryRegisters >> 2).\n"
+"-precision=N   Precision override bitmask, as the AdjustShaderPrecision\n"
+"               apphint.\n"
+"-warnings=N    Enabled GLSL warnings, as the GLSLEnabledWarnings apphint.\n"
+"-bench=N       Compile every job N times without writing any output and\n"
+"               print the compile throughput of each worker, for timing\n"
+"               the compiler against a shader corpus.\n"
+"-metrics       Print per-stage compile times and the compiler's own\n"
+"               metrics.\n"
+"-perf          Print USC's static performance report for each shader as\n"
+"               one 'FILE: perf key=value ...' line, even with -quiet.\n"
+"-linkvaryings  For vertex and fragment pairs, recompile both against each\n"
+"               other as the OptimiseLinkedVaryings apphint does, write the\n"
+"               result and print one 'VERTEX: link key=before->after ...'\n"
+"               line of outputs, output components and instructions saved.\n"
+"-quiet         Only print errors.\n";
+
+
+/***********************************************************************************
+ Function Name      : GetTimeInUs
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in microseconds
+ Description        :
+************************************************************************************/
+static IMG_UINT64 GetTimeInUs(IMG_VOID)
+{
+#if defined(LINUX)
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return ((IMG_UINT64)sTime.tv_sec * 1000000) + ((IMG_UINT64)sTime.tv_nsec / 1000);
+#else
+	return ((IMG_UINT64)clock() * 1000000) / CLOCKS_PER_SEC;
+#endif
+}
+
+
+/***********************************************************************************
+ Function Name      : ReadSourceFile
+ Inputs             : pszFileName
+ Outputs            : -
+ Returns            : NUL terminated file contents, or NULL
+ Description        :
+************************************************************************************/
+static IMG_CHAR *ReadSourceFile(const IMG_CHAR *pszFileName)
+{
+	FILE *fInFile;
+	IMG_CHAR *pszSource;
+	long lLength;
+
+	fInFile = fopen(pszFileName, "rb");
+
+	if (fInFile == NULL)
+	{
+		fprintf(stderr, "%s: error: couldn't open file\n", pszFileName);
+		return NULL;
+	}
+
+	fseek(fInFile, 0, SEEK_END);
+	lLength = ftell(fInFile);
+	fseek(fInFile, 0, SEEK_SET);
+
+	pszSource = malloc((size_t)lLength + 1);
+
+	if (pszSource == NULL || fread(pszSource, 1, (size_t)lLength, fInFile) != (size_t)lLength)
+	{
+		fprintf(stderr, "%s: error: couldn't read file\n", pszFileName);
+		free(pszSource);
+		fclose(fInFile);
+		return NULL;
+	}
+
+	pszSource[lLength] = '\0';
+
+	fclose(fInFile);
+
+	return pszSource;
+}
+
+
+/***********************************************************************************
+ Function Name      : SetPrecision
+ Inputs             : ui32PrecisionBitMask
+ Outputs            : psRP
+ Returns            : -
+ Description        : Sets the default precisions exactly as the driver does.
+************************************************************************************/
+static IMG_VOID SetPrecision(GLSLRequestedPrecisions *psRP, IMG_UINT32 ui32PrecisionBitMask)
+{
+	psRP->eDefaultUserVertFloat   = GLSLPRECQ_HIGH;
+	psRP->eDefaultUserVertInt     = GLSLPRECQ_HIGH;
+	psRP->eDefaultUserVertSampler = GLSLPRECQ_LOW;
+	psRP->eDefaultUserFragFloat   = GLSLPRECQ_UNKNOWN;
+	psRP->eDefaultUserFragInt     = GLSLPRECQ_MEDIUM;
+	psRP->eDefaultUserFragSampler = GLSLPRECQ_LOW;
+
+	psRP->eVertBooleanPrecision	  = GLSLPRECQ_HIGH;
+	psRP->eFragBooleanPrecision	  = GLSLPRECQ_HIGH;
+
+	psRP->eBIStateInt             = GLSLPRECQ_HIGH;
+	psRP->eBIFragFloat            = GLSLPRECQ_MEDIUM;
+
+	psRP->eGLPosition             = GLSLPRECQ_HIGH;
+	psRP->eGLPointSize            = GLSLPRECQ_MEDIUM;
+	psRP->eGLPointCoord           = GLSLPRECQ_MEDIUM;
+	psRP->eDepthRange             = GLSLPRECQ_HIGH;
+
+	psRP->eForceUserVertFloat     = GLSLPRECQ_UNKNOWN;
+	psRP->eForceUserVertInt       = GLSLPRECQ_UNKNOWN;
+	psRP->eForceUserVertSampler   = GLSLPRECQ_UNKNOWN;
+	psRP->eForceUserFragFloat     = GLSLPRECQ_UNKNOWN;
+	psRP->eForceUserFragInt       = GLSLPRECQ_UNKNOWN;
+	psRP->eForceUserFragSampler   = GLSLPRECQ_UNKNOWN;
+
+	psRP->eBIStateFloat           = GLSLPRECQ_UNKNOWN;
+	psRP->eBIVertAttribFloat      = GLSLPRECQ_UNKNOWN;
+	psRP->eBIVaryingFloat         = GLSLPRECQ_UNKNOWN;
+
+	if (ui32PrecisionBitMask)
+	{
+		SET_BITFIELD_REQUESTED_PRECISION(psRP, ui32PrecisionBitMask);
+		if(ui32PrecisionBitMask == 0xFFFFFFFF)
+		{
+			psRP->eDefaultUserVertSampler = GLSLPRECQ_HIGH;
+			psRP->eDefaultUserFragSampler = GLSLPRECQ_HIGH;
+			psRP->eForceUserVertSampler = GLSLPRECQ_HIGH;
+			psRP->eForceUserFragSampler = GLSLPRECQ_HIGH;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : InitCompiler
+ Inputs             : psOptions
+ Outputs            : psInitCompilerContext
+ Returns            : Success
+ Description        : Initialises the GLSL compiler with the driver's resources
+                      and inlining/unrolling rules (see InitializeGLSLCompiler).
+************************************************************************************/
+static IMG_BOOL InitCompiler(GLSLInitCompilerContext *psInitCompilerContext, const ESBC_OPTIONS *psOptions)
+{
+	GLSLCompilerResources *psResources;
+
+	memset(psInitCompilerContext, 0, sizeof(GLSLInitCompilerContext));
+
+	psInitCompilerContext->eLogFiles = GLSLLF_NOT_LOG;
+
+	psResources = &psInitCompilerContext->sCompilerResources;
+	psResources->iGLMaxVertexAttribs = GLES2_MAX_VERTEX_ATTRIBS;
+	psResources->iGLMaxVertexUniformVectors = GLES2_MAX_VERTEX_UNIFORM_VECTORS;
+	psResources->iGLMaxVaryingVectors = GLES2_MAX_VARYING_VECTORS;
+	psResources->iGLMaxVertexTextureImageUnits = GLES2_MAX_VERTEX_TEXTURE_UNITS;
+	psResources->iGLMaxCombinedTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxFragmentUniformVectors = GLES2_MAX_FRAGMENT_UNIFORM_VECTORS;
+	psResources->iGLMaxDrawBuffers = GLES2_MAX_DRAW_BUFFERS;
+
+	SetPrecision(&psInitCompilerContext->sRequestedPrecisions, psOptions->ui32PrecisionMask);
+
+	psInitCompilerContext->sInlineFuncRules.bInlineCalledOnceFunc			= IMG_TRUE;
+	psInitCompilerContext->sInlineFuncRules.bInlineSamplerParamFunc			= IMG_TRUE;
+	psInitCompilerContext->sInlineFuncRules.uNumICInstrsBodyLessThan		= 10;
+	psInitCompilerContext->sInlineFuncRules.uNumParamComponentsGreaterThan	= 32;
+
+	psInitCompilerContext->sUnrollLoopRules.bEnableUnroll					= IMG_TRUE;
+	psInitCompilerContext->sUnrollLoopRules.bUnrollRelativeAddressingOnly	= IMG_TRUE;
+	psInitCompilerContext->sUnrollLoopRules.uMaxNumIterations				= 50;
+
+	return GLSLInitCompiler(psInitCompilerContext);
+}
+
+
+/***********************************************************************************
+ Function Name      : PrintPerfReport
+ Inputs             : pszFileName, psReport
+ Outputs            : -
+ Returns            : -
+ Description        : Prints a shader's static performance report on a single line
+					  so that it can be compared between compiler versions.
+************************************************************************************/
+static IMG_VOID PrintPerfReport(const IMG_CHAR *pszFileName, const UNIFLEX_PERF_REPORT *psReport)
+{
+	IMG_UINT32 ui32DualIssuePermille = 0;
+
+	if (psReport->uMainProgInstCount)
+	{
+		ui32DualIssuePermille = (psReport->uDualIssueCount * 1000) / psReport->uMainProgInstCount;
+	}
+
+	printf("%s: perf insts=%u sa_insts=%u cycles_min=%u cycles_max=%u samples=%u nd_samples=%u "
+		   "dual=%u dual_ratio=%u.%03u spill_ld=%u spill_st=%u spill_area=%u pa=%u sa=%u temps=%u sa_temps=%u\n",
+		   pszFileName,
+		   psReport->uMainProgInstCount,
+		   psReport->uSAProgInstCount,
+		   psReport->uMinPathCycles,
+		   psReport->uMaxPathCycles,
+		   psReport->uTextureSampleCount,
+		   psReport->uNonDependentTextureLoadCount,
+		   psReport->uDualIssueCount,
+		   ui32DualIssuePermille / 1000, ui32DualIssuePermille % 1000,
+		   psReport->uSpillLoadCount,
+		   psReport->uSpillStoreCount,
+		   psReport->uSpillAreaSize,
+		   psReport->uPrimaryAttributeCount,
+		   psReport->uConstSecAttrCount,
+		   psReport->uTemporaryRegisterCount,
+		   psReport->uSecTemporaryRegisterCount);
+}
+
+
+/***********************************************************************************
+ Function Name      : CompileShader
+ Inputs             : psInitCompilerContext, psOptions, pszFileName, eProgramType,
+                      ui32NumLinkedVaryings, psLinkedVaryings
+ Outputs            : aui64StageTimes
+ Returns            : Compiled program or NULL
+ Description        : Compiles one shader with the same Uniflex parameters the
+                      driver uses in glCompileShader, or in glLinkProgram for a
+                      link variant when linked varyings are given.
+************************************************************************************/
+static GLSLCompiledUniflexProgram *CompileShader(GLSLInitCompilerContext *psInitCompilerContext,
+												 const ESBC_OPTIONS *psOptions,
+												 const IMG_CHAR *pszFileName,
+												 GLSLProgramType eProgramType,
+												 IMG_UINT32 ui32NumLinkedVaryings,
+												 const GLSLLinkedVarying *psLinkedVaryings,
+												 IMG_UINT64 aui64StageTimes[ESBC_STAGE_MAX])
+{
+	GLSLUniFlexHWCodeInfo sUniFlexInfo;
+	UNIFLEX_PROGRAM_PARAMETERS sUniFlexParams;
+	GLSLCompileProgramContext sCompileContext;
+	GLSLCompileUniflexProgramContext sCompileUniflexContext;
+	GLSLCompiledUniflexProgram *psCompiledProgram;
+	IMG_CHAR *pszSource;
+	IMG_UINT64 ui64Start;
+
+	ui64Start = GetTimeInUs();
+
+	pszSource = ReadSourceFile(pszFileName);
+
+	aui64StageTimes[ESBC_STAGE_READ] += GetTimeInUs() - ui64Start;
+
+	if (pszSource == NULL)
+	{
+		return NULL;
+	}
+
+	memset(&sUniFlexInfo, 0, sizeof(GLSLUniFlexHWCodeInfo));
+	memset(&sUniFlexParams, 0, sizeof(UNIFLEX_PROGRAM_PARAMETERS));
+	memset(&sCompileContext, 0, sizeof(GLSLCompileProgramContext));
+	memset(&sCompileUniflexContext, 0, sizeof(GLSLCompileUniflexProgramContext));
+
+	sUniFlexParams.uNumAvailableTemporaries = psOptions->ui32NumTemporaries;
+
+	if (eProgramType == GLSLPT_FRAGMENT)
+	{
+		sUniFlexParams.uConstantBase		= GLES2_FRAGMENT_SECATTR_CONSTANTBASE;
+		sUniFlexParams.uIndexableTempBase	= GLES2_FRAGMENT_SECATTR_INDEXABLETEMPBASE;
+		sUniFlexParams.uScratchBase			= GLES2_FRAGMENT_SECATTR_SCRATCHBASE;
+
+		sUniFlexParams.uInRegisterConstantOffset = GLES2_FRAGMENT_SECATTR_NUM_RESERVED;
+		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_PS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
+
+		sUniFlexParams.uPackDestType = USEASM_REGTYPE_PRIMATTR;
+		sUniFlexParams.uPackPrecision = 5;
+		sUniFlexParams.uExtraPARegisters = 0;
+	}
+	else
+	{
+		sUniFlexParams.uConstantBase		= GLES2_VERTEX_SECATTR_CONSTANTBASE;
+		sUniFlexParams.uIndexableTempBase	= GLES2_VERTEX_SECATTR_INDEXABLETEMPBASE;
+		sUniFlexParams.uScratchBase			= GLES2_VERTEX_SECATTR_SCRATCHBASE;
+
+		sUniFlexParams.uInRegisterConstantOffset = GLES2_VERTEX_SECATTR_NUM_RESERVED;
+		sUniFlexParams.uInRegisterConstantLimit = PVR_MAX_VS_SECONDARIES - sUniFlexParams.uInRegisterConstantOffset;
+
+		sUniFlexParams.uExtraPARegisters = 0;
+	}
+
+	sUniFlexParams.ePredicationLevel = UF_PREDLVL_AUTO;
+	sUniFlexParams.uMaxALUInstsToFlatten = 0;
+
+	sUniFlexInfo.psUFParams = &sUniFlexParams;
+
+	sCompileUniflexContext.eOutputCodeType = GLSLPF_UNIFLEX_OUTPUT;
+	sCompileUniflexContext.psUniflexHWCodeInfo = &sUniFlexInfo;
+	sCompileUniflexContext.psCompileProgramContext = &sCompileContext;
+	sCompileUniflexContext.uNumLinkedVaryings = ui32NumLinkedVaryings;
+	sCompileUniflexContext.psLinkedVaryings = psLinkedVaryings;
+
+#if !defined(SGX_FEATURE_USE_UNLIMITED_PHASES)
+	/* The driver always builds the MSAA translucent variant of fragment shaders */
+	sCompileUniflexContext.bCompileMSAATrans = (eProgramType == GLSLPT_FRAGMENT) ? IMG_TRUE : IMG_FALSE;
+#else
+	sCompileUniflexContext.bCompileMSAATrans = IMG_FALSE;
+#endif
+
+	sCompileContext.psInitCompilerContext = psInitCompilerContext;
+	sCompileContext.eProgramType = eProgramType;
+	sCompileContext.ppszSourceCodeStrings = &pszSource;
+	sCompileContext.uNumSourceCodeStrings = 1;
+	sCompileContext.bCompleteProgram = IMG_TRUE;
+	sCompileContext.bDisplayMetrics = psOptions->bMetrics;
+	sCompileContext.bValidateOnly = IMG_FALSE;
+	sCompileContext.eEnabledWarnings = (GLSLCompilerWarnings)psOptions->ui32Warnings;
+
+	ui64Start = GetTimeInUs();
+
+	psCompiledProgram = GLSLCompileToUniflex(&sCompileUniflexContext);
+
+	aui64StageTimes[ESBC_STAGE_COMPILE] += GetTimeInUs() - ui64Start;
+
+	free(pszSource);
+
+	if (psCompiledProgram == NULL)
+	{
+		fprintf(stderr, "%s: error: the compiler failed\n", pszFileName);
+		return NULL;
+	}
+
+	if (psCompiledProgram->sInfoLog.pszInfoLogString && psCompiledProgram->sInfoLog.pszInfoLogString[0] &&
+		(!psOptions->bQuiet || !psCompiledProgram->bSuccessfullyCompiled))
+	{
+		fprintf(stderr, "%s:\n%s", pszFileName, psCompiledProgram->sInfoLog.pszInfoLogString);
+	}
+
+	if (!psCompiledProgram->bSuccessfullyCompiled)
+	{
+		GLSLFreeCompiledUniflexProgram(psInitCompilerContext, psCompiledProgram);
+		return NULL;
+	}
+
+	if (psOptions->bPerf)
+	{
+		PrintPerfReport(pszFileName, &psCompiledProgram->psUniFlexCode->sPerfReport);
+	}
+
+	return psCompiledProgram;
+}
+
+
+/***********************************************************************************
+ Function Name      : BinaryMalloc/BinaryFree
+ Description        : Allocators handed to SGXBS_CreateBinaryShader
+************************************************************************************/
+static IMG_VOID *BinaryMalloc(IMG_UINT32 ui32Size)
+{
+	return malloc(ui32Size);
+}
+
+static IMG_VOID BinaryFree(IMG_VOID *pvData)
+{
+	free(pvData);
+}
+
+
+/***********************************************************************************
+ Function Name      : ReadsVarying
+ Inputs             : psProgram, pszName
+ Outputs            : -
+ Returns            : IMG_TRUE if the fragment shader reads the user varying
+ Description        :
+************************************************************************************/
+static IMG_BOOL ReadsVarying(const GLSLCompiledUniflexProgram *psProgram, const IMG_CHAR *pszName)
+{
+	const GLSLBindingSymbolList *psSymbolList = psProgram->psBindingSymbolList;
+	IMG_UINT32 i;
+
+	for (i = 0; i < psSymbolList->uNumBindings; i++)
+	{
+		const GLSLBindingSymbol *psSymbol = &psSymbolList->psBindingSymbolEntries[i];
+
+		if (psSymbol->eBIVariableID == GLSLBV_NOT_BTIN &&
+			psSymbol->eTypeQualifier == GLSLTQ_FRAGMENT_IN &&
+			strcmp(psSymbol->pszName, pszName) == 0)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : CountVertexOutputs
+ Inputs             : psProgram
+ Outputs            : pui32NumComponents
+ Returns            : Number of texture coordinate outputs
+ Description        : Counts the outputs a vertex shader's varyings are packed into,
+                      and the components the TA stores for them.
+************************************************************************************/
+static IMG_UINT32 CountVertexOutputs(const GLSLCompiledUniflexProgram *psProgram, IMG_UINT32 *pui32NumComponents)
+{
+	const GLSLUniFlexCode *psUFCode = psProgram->psUniFlexCode;
+	IMG_UINT32 ui32NumOutputs = 0, i;
+
+	*pui32NumComponents = 0;
+
+	for (i = 0; i < NUM_TC_REGISTERS; i++)
+	{
+		if (psUFCode->eActiveVaryingMask & (GLSLVM_TEXCOORD0 << i))
+		{
+			ui32NumOutputs++;
+			*pui32NumComponents += psUFCode->auTexCoordDims[i];
+		}
+	}
+
+	return ui32NumOutputs;
+}
+
+
+/***********************************************************************************
+ Function Name      : LinkVaryings
+ Inputs             : psInitCompilerContext, psOptions, psJob, ppsVertex, ppsFragment
+ Outputs            : ppsVertex, ppsFragment, aui64StageTimes
+ Returns            : Success
+ Description        : Recompiles a vertex and fragment shader pair against each
+                      other, as glLinkProgram does with the OptimiseLinkedVaryings
+                      apphint: constant varyings are folded into the fragment
+                      shader, then the varyings it doesn't read are removed from
+                      the vertex shader. Prints what was saved.
+************************************************************************************/
+static IMG_BOOL LinkVaryings(GLSLInitCompilerContext *psInitCompilerContext, const ESBC_OPTIONS *psOptions,
+							 const ESBC_JOB *psJob, GLSLCompiledUniflexProgram **ppsVertex,
+							 GLSLCompiledUniflexProgram **ppsFragment, IMG_UINT64 aui64StageTimes[ESBC_STAGE_MAX])
+{
+	GLSLCompiledUniflexProgram *psVertex = *ppsVertex, *psFragment = *ppsFragment;
+	const GLSLBindingSymbolList *psVertexSymbolList = psVertex->psBindingSymbolList;
+	GLSLLinkedVarying *psFragmentKey, *psVertexKey;
+	IMG_UINT32 ui32NumFragmentKey = 0, ui32NumVertexKey = 0, ui32NumFolded = 0;
+	IMG_UINT32 ui32OldOutputs, ui32NewOutputs, ui32OldComponents, ui32NewComponents, i;
+
+	if (!psVertexSymbolList->uNumBindings)
+	{
+		return IMG_TRUE;
+	}
+
+	psFragmentKey = malloc(2 * psVertexSymbolList->uNumBindings * sizeof(GLSLLinkedVarying));
+
+	if (psFragmentKey == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", psJob->pszVertexFile);
+		return IMG_FALSE;
+	}
+
+	psVertexKey = &psFragmentKey[psVertexSymbolList->uNumBindings];
+
+	for (i = 0; i < psVertex->uNumConstantVaryings; i++)
+	{
+		if (ReadsVarying(psFragment, psVertex->psConstantVaryings[i].pszName))
+		{
+			psFragmentKey[ui32NumFragmentKey++] = psVertex->psConstantVaryings[i];
+		}
+	}
+
+	if (ui32NumFragmentKey)
+	{
+		psFragment = CompileShader(psInitCompilerContext, psOptions, psJob->pszFragmentFile, GLSLPT_FRAGMENT,
+								   ui32NumFragmentKey, psFragmentKey, aui64StageTimes);
+
+		if (psFragment == NULL)
+		{
+			free(psFragmentKey);
+			return IMG_FALSE;
+		}
+	}
+
+	for (i = 0; i < psVertexSymbolList->uNumBindings; i++)
+	{
+		const GLSLBindingSymbol *psSymbol = &psVertexSymbolList->psBindingSymbolEntries[i];
+
+		if (psSymbol->eBIVariableID != GLSLBV_NOT_BTIN || psSymbol->eTypeQualifier != GLSLTQ_VERTEX_OUT)
+		{
+			continue;
+		}
+
+		if (!ReadsVarying(psFragment, psSymbol->pszName))
+		{
+			psVertexKey[ui32NumVertexKey].pszName = psSymbol->pszName;
+			psVertexKey[ui32NumVertexKey].uNumComponents = 0;
+			ui32NumVertexKey++;
+
+			if (ReadsVarying(*ppsFragment, psSymbol->pszName))
+			{
+				ui32NumFolded++;
+			}
+		}
+	}
+
+	if (ui32NumVertexKey)
+	{
+		psVertex = CompileShader(psInitCompilerContext, psOptions, psJob->pszVertexFile, GLSLPT_VERTEX,
+								 ui32NumVertexKey, psVertexKey, aui64StageTimes);
+
+		if (psVertex == NULL)
+		{
+			if (psFragment != *ppsFragment)
+			{
+				GLSLFreeCompiledUniflexProgram(psInitCompilerContext, psFragment);
+			}
+
+			free(psFragmentKey);
+			return IMG_FALSE;
+		}
+	}
+
+	ui32OldOutputs = CountVertexOutputs(*ppsVertex, &ui32OldComponents);
+	ui32NewOutputs = CountVertexOutputs(psVertex, &ui32NewComponents);
+
+	printf("%s: link outputs=%u->%u components=%u->%u removed=%u folded=%u vs_insts=%u->%u fs_insts=%u->%u\n",
+		   psJob->pszVertexFile,
+		   ui32OldOutputs, ui32NewOutputs,
+		   ui32OldComponents, ui32NewComponents,
+		   ui32NumVertexKey, ui32NumFolded,
+		   (*ppsVertex)->psUniFlexCode->sPerfReport.uMainProgInstCount,
+		   psVertex->psUniFlexCode->sPerfReport.uMainProgInstCount,
+		   (*ppsFragment)->psUniFlexCode->sPerfReport.uMainProgInstCount,
+		   psFragment->psUniFlexCode->sPerfReport.uMainProgInstCount);
+
+	/* The binary is written from the variants */
+	if (psVertex != *ppsVertex)
+	{
+		GLSLFreeCompiledUniflexProgram(psInitCompilerContext, *ppsVertex);
+		*ppsVertex = psVertex;
+	}
+
+	if (psFragment != *ppsFragment)
+	{
+		GLSLFreeCompiledUniflexProgram(psInitCompilerContext, *ppsFragment);
+		*ppsFragment = psFragment;
+	}
+
+	free(psFragmentKey);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunJob
+ Inputs             : psInitCompilerContext, psOptions, psJob
+ Outputs            : aui64StageTimes
+ Returns            : 0 on success
+ Description        : Compiles one line of work and writes its binary. Nothing
+                      is written in -bench mode.
+************************************************************************************/
+static int RunJob(GLSLInitCompilerContext *psInitCompilerContext, const ESBC_OPTIONS *psOptions,
+				  const ESBC_JOB *psJob, IMG_UINT64 aui64StageTimes[ESBC_STAGE_MAX])
+{
+	GLSLCompiledUniflexProgram *psVertex = NULL, *psFragment = NULL;
+	IMG_VOID *pvBinary = NULL;
+	IMG_UINT32 ui32BinarySize = 0;
+	SGXBS_Error eError = SGXBS_INTERNAL_ERROR;
+	IMG_UINT64 ui64Start;
+	FILE *fOutFile;
+	int iResult = 1;
+
+	if (psJob->pszVertexFile)
+	{
+		psVertex = CompileShader(psInitCompilerContext, psOptions, psJob->pszVertexFile, GLSLPT_VERTEX, 0, NULL, aui64StageTimes);
+
+		if (psVertex == NULL)
+		{
+			goto Cleanup;
+		}
+	}
+
+	if (psJob->pszFragmentFile)
+	{
+		psFragment = CompileShader(psInitCompilerContext, psOptions, psJob->pszFragmentFile, GLSLPT_FRAGMENT, 0, NULL, aui64StageTimes);
+
+		if (psFragment == NULL)
+		{
+			goto Cleanup;
+		}
+	}
+
+	if (psVertex && psFragment && psOptions->bLinkVaryings)
+	{
+		if (!LinkVaryings(psInitCompilerContext, psOptions, psJob, &psVertex, &psFragment, aui64StageTimes))
+		{
+			goto Cleanup;
+		}
+	}
+
+	ui64Start = GetTimeInUs();
+
+	if (psVertex && psFragment)
+	{
+		/* First pass sizes the program binary, the second writes it */
+		eError = SGXBS_CreateBinaryProgram(psVertex, psFragment, NULL, 1, &ui32BinarySize, &ui32BinarySize, IMG_FALSE);
+
+		if (eError == SGXBS_NO_ERROR)
+		{
+			pvBinary = malloc(ui32BinarySize);
+
+			eError = pvBinary ? SGXBS_CreateBinaryProgram(psVertex, psFragment, NULL, ui32BinarySize, &ui32BinarySize, pvBinary, IMG_TRUE)
+							  : SGXBS_OUT_OF_MEMORY_ERROR;
+		}
+	}
+	else
+	{
+		eError = SGXBS_CreateBinaryShader(psVertex ? psVertex : psFragment, BinaryMalloc, BinaryFree, &pvBinary, &ui32BinarySize);
+	}
+
+	aui64StageTimes[ESBC_STAGE_PACK] += GetTimeInUs() - ui64Start;
+
+	if (eError != SGXBS_NO_ERROR)
+	{
+		fprintf(stderr, "%s: error: couldn't create the binary (error %d)\n", psJob->pszOutputFile, (int)eError);
+		goto Cleanup;
+	}
+
+	if (psOptions->ui32BenchRepeats)
+	{
+		iResult = 0;
+		goto Cleanup;
+	}
+
+	ui64Start = GetTimeInUs();
+
+	fOutFile = fopen(psJob->pszOutputFile, "wb");
+
+	if (fOutFile == NULL || fwrite(pvBinary, 1, ui32BinarySize, fOutFile) != ui32BinarySize)
+	{
+		fprintf(stderr, "%s: error: couldn't write output\n", psJob->pszOutputFile);
+
+		if (fOutFile)
+		{
+			fclose(fOutFile);
+		}
+
+		goto Cleanup;
+	}
+
+	fclose(fOutFile);
+
+	aui64StageTimes[ESBC_STAGE_WRITE] += GetTimeInUs() - ui64Start;
+
+	if (!psOptions->bQuiet)
+	{
+		printf("%s: %u bytes\n", psJob->pszOutputFile, ui32BinarySize);
+	}
+
+	iResult = 0;
+
+Cleanup:
+	free(pvBinary);
+
+	if (psVertex)
+	{
+		GLSLFreeCompiledUniflexProgram(psInitCompilerContext, psVertex);
+	}
+
+	if (psFragment)
+	{
+		GLSLFreeCompiledUniflexProgram(psInitCompilerContext, psFragment);
+	}
+
+	return iResult;
+}
+
+
+/***********************************************************************************
+ Function Name      : ParseJobList
+ Inputs             : pszListFile
+ Outputs            : ppsJobs, pui32NumJobs
+ Returns            : Success
+ Description        : Reads 'VERTEX FRAGMENT OUTPUT' lines. '#' starts a comment.
+************************************************************************************/
+static IMG_BOOL ParseJobList(const IMG_CHAR *pszListFile, ESBC_JOB **ppsJobs, IMG_UINT32 *pui32NumJobs)
+{
+	IMG_CHAR pszLine[ESBC_MAX_LINE_LENGTH];
+	IMG_CHAR pszVertex[ESBC_MAX_LINE_LENGTH], pszFragment[ESBC_MAX_LINE_LENGTH], pszOutput[ESBC_MAX_LINE_LENGTH];
+	ESBC_JOB *psJobs = NULL;
+	IMG_UINT32 ui32NumJobs = 0, ui32Line = 0;
+	FILE *fListFile;
+
+	fListFile = fopen(pszListFile, "r");
+
+	if (fListFile == NULL)
+	{
+		fprintf(stderr, "%s: error: couldn't open file\n", pszListFile);
+		return IMG_FALSE;
+	}
+
+	while (fgets(pszLine, sizeof(pszLine), fListFile))
+	{
+		ESBC_JOB *psNewJobs;
+
+		ui32Line++;
+
+		if (pszLine[0] == '#' || sscanf(pszLine, "%1023s", pszOutput) != 1)
+		{
+			continue;
+		}
+
+		if (sscanf(pszLine, "%1023s %1023s %1023s", pszVertex, pszFragment, pszOutput) != 3 ||
+			(strcmp(pszVertex, "-") == 0 && strcmp(pszFragment, "-") == 0))
+		{
+			fprintf(stderr, "%s(%u): error: expected 'VERTEX FRAGMENT OUTPUT'\n", pszListFile, ui32Line);
+			fclose(fListFile);
+			return IMG_FALSE;
+		}
+
+		psNewJobs = realloc(psJobs, (ui32NumJobs + 1) * sizeof(ESBC_JOB));
+
+		if (psNewJobs == NULL)
+		{
+			fprintf(stderr, "Out of memory\n");
+			fclose(fListFile);
+			return IMG_FALSE;
+		}
+
+		psJobs = psNewJobs;
+
+		psJobs[ui32NumJobs].pszVertexFile   = strcmp(pszVertex, "-") ? strdup(pszVertex) : NULL;
+		psJobs[ui32NumJobs].pszFragmentFile = strcmp(pszFragment, "-") ? strdup(pszFragment) : NULL;
+		psJobs[ui32NumJobs].pszOutputFile   = strdup(pszOutput);
+		ui32NumJobs++;
+	}
+
+	fclose(fListFile);
+
+	*ppsJobs = psJobs;
+	*pui32NumJobs = ui32NumJobs;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunJobs
+ Inputs             : psOptions, psJobs, ui32NumJobs, ui32Worker, ui32NumWorkers
+ Outputs            : -
+ Returns            : Number of failed jobs
+ Description        : Runs every ui32NumWorkers'th job starting at ui32Worker with
+                      a private compiler instance, then reports stage times. In
+                      -bench mode the jobs are run ui32BenchRepeats times over
+                      and the compile stage throughput is reported.
+************************************************************************************/
+static IMG_UINT32 RunJobs(const ESBC_OPTIONS *psOptions, const ESBC_JOB *psJobs, IMG_UINT32 ui32NumJobs,
+						  IMG_UINT32 ui32Worker, IMG_UINT32 ui32NumWorkers)
+{
+	GLSLInitCompilerContext sInitCompilerContext;
+	IMG_UINT64 aui64StageTimes[ESBC_STAGE_MAX] = {0};
+	IMG_UINT32 ui32NumFailed = 0, ui32NumRun = 0, ui32NumShaders = 0, ui32Repeat = 0, i;
+
+	if (!InitCompiler(&sInitCompilerContext, psOptions))
+	{
+		fprintf(stderr, "Failed to initialise the GLSL compiler\n");
+		return ui32NumJobs;
+	}
+
+	do
+	{
+		for (i = ui32Worker; i < ui32NumJobs; i += ui32NumWorkers)
+		{
+			if (RunJob(&sInitCompilerContext, psOptions, &psJobs[i], aui64StageTimes))
+			{
+				ui32NumFailed++;
+			}
+
+			ui32NumShaders += (psJobs[i].pszVertexFile ? 1 : 0) + (psJobs[i].pszFragmentFile ? 1 : 0);
+			ui32NumRun++;
+		}
+	}
+	while (++ui32Repeat < psOptions->ui32BenchRepeats);
+
+	if (psOptions->ui32BenchRepeats)
+	{
+		IMG_UINT64 ui64Compile = aui64StageTimes[ESBC_STAGE_COMPILE];
+
+		printf("worker %u: %u shaders compiled in %.3f ms, %.1f shaders/s, %.1f us per shader\n",
+			   ui32Worker, ui32NumShaders, (double)ui64Compile / 1000.0,
+			   ui64Compile ? (double)ui32NumShaders * 1000000.0 / (double)ui64Compile : 0.0,
+			   ui32NumShaders ? (double)ui64Compile / (double)ui32NumShaders : 0.0);
+	}
+
+	if (psOptions->bMetrics)
+	{
+		IMG_UINT64 ui64Total = 0;
+
+		for (i = 0; i < ESBC_STAGE_MAX; i++)
+		{
+			ui64Total += aui64StageTimes[i];
+		}
+
+		printf("worker %u: %u jobs in %.3f ms", ui32Worker, ui32NumRun, (double)ui64Total / 1000.0);
+
+		for (i = 0; i < ESBC_STAGE_MAX; i++)
+		{
+			printf(", %s %.3f ms", g_apszStageNames[i], (double)aui64StageTimes[i] / 1000.0);
+		}
+
+		printf("\n");
+
+		GLSLDisplayMetrics(&sInitCompilerContext);
+	}
+
+	GLSLShutDownCompiler(&sInitCompilerContext);
+
+	return ui32NumFailed;
+}
+
+
+int main(int argc, char* argv[])
+{
+	ESBC_OPTIONS sOptions;
+	ESBC_JOB sSingleJob = {NULL, NULL, NULL};
+	ESBC_JOB *psJobs = &sSingleJob;
+	IMG_UINT32 ui32NumJobs = 1, ui32NumFailed = 0;
+	IMG_CHAR *pszListFile = NULL;
+	IMG_UINT64 ui64Start;
+
+	memset(&sOptions, 0, sizeof(sOptions));
+	sOptions.ui32NumTemporaries = EURASIA_USE_NUM_UNIFIED_REGISTERS >> 2;
+	sOptions.ui32NumParallelJobs = 1;
+
+	while (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')
+	{
+		if (strncmp(argv[1], "-v=", strlen("-v=")) == 0)
+		{
+			sSingleJob.pszVertexFile = argv[1] + strlen("-v=");
+		}
+		else if (strncmp(argv[1], "-f=", strlen("-f=")) == 0)
+		{
+			sSingleJob.pszFragmentFile = argv[1] + strlen("-f=");
+		}
+		else if (strncmp(argv[1], "-o=", strlen("-o=")) == 0)
+		{
+			sSingleJob.pszOutputFile = argv[1] + strlen("-o=");
+		}
+		else if (strncmp(argv[1], "-list=", strlen("-list=")) == 0)
+		{
+			pszListFile = argv[1] + strlen("-list=");
+		}
+		else if (strncmp(argv[1], "-j=", strlen("-j=")) == 0)
+		{
+			sOptions.ui32NumParallelJobs = strtoul(argv[1] + strlen("-j="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-temps=", strlen("-temps=")) == 0)
+		{
+			sOptions.ui32NumTemporaries = strtoul(argv[1] + strlen("-temps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-precision=", strlen("-precision=")) == 0)
+		{
+			sOptions.ui32PrecisionMask = strtoul(argv[1] + strlen("-precision="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-warnings=", strlen("-warnings=")) == 0)
+		{
+			sOptions.ui32Warnings = strtoul(argv[1] + strlen("-warnings="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-bench=", strlen("-bench=")) == 0)
+		{
+			sOptions.ui32BenchRepeats = strtoul(argv[1] + strlen("-bench="), NULL, 0);
+		}
+		else if (strcmp(argv[1], "-metrics") == 0)
+		{
+			sOptions.bMetrics = IMG_TRUE;
+		}
+		else if (strcmp(argv[1], "-perf") == 0)
+		{
+			sOptions.bPerf = IMG_TRUE;
+		}
+		else if (strcmp(argv[1], "-linkvaryings") == 0)
+		{
+			sOptions.bLinkVaryings = IMG_TRUE;
+		}
+		else if (strcmp(argv[1], "-quiet") == 0)
+		{
+			sOptions.bQuiet = IMG_TRUE;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown option '%s'\n\n", argv[1]);
+			fprintf(stderr, "Usage: esbincompiler [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		memmove(&argv[1], &argv[2], (argc - 2) * sizeof(argv[1]));
+		argc--;
+	}
+
+	if (pszListFile)
+	{
+		if (!ParseJobList(pszListFile, &psJobs, &ui32NumJobs))
+		{
+			return 1;
+		}
+	}
+	else if ((!sSingleJob.pszVertexFile && !sSingleJob.pszFragmentFile) || !sSingleJob.pszOutputFile)
+	{
+		fprintf(stderr, "Usage: esbincompiler [options]\n%s", g_pszOptions);
+		return 1;
+	}
+
+	if (sOptions.ui32NumParallelJobs < 1)
+	{
+		sOptions.ui32NumParallelJobs = 1;
+	}
+	else if (sOptions.ui32NumParallelJobs > ESBC_MAX_JOBS)
+	{
+		sOptions.ui32NumParallelJobs = ESBC_MAX_JOBS;
+	}
+
+	if (sOptions.ui32NumParallelJobs > ui32NumJobs)
+	{
+		sOptions.ui32NumParallelJobs = ui32NumJobs;
+	}
+
+	ui64Start = GetTimeInUs();
+
+#if defined(LINUX)
+	if (sOptions.ui32NumParallelJobs > 1)
+	{
+		/*
+			The compiler keeps per-instance globals, so parallel compiles use
+			processes rather than threads. Each worker reports its failures
+			through its exit status.
+		*/
+		pid_t aiWorkers[ESBC_MAX_JOBS];
+		IMG_UINT32 i;
+
+		fflush(stdout);
+
+		for (i = 0; i < sOptions.ui32NumParallelJobs; i++)
+		{
+			aiWorkers[i] = fork();
+
+			if (aiWorkers[i] == 0)
+			{
+				_exit(RunJobs(&sOptions, psJobs, ui32NumJobs, i, sOptions.ui32NumParallelJobs) ? 1 : 0);
+			}
+			else if (aiWorkers[i] < 0)
+			{
+				fprintf(stderr, "Couldn't start worker %u, compiling its jobs here\n", i);
+				ui32NumFailed += RunJobs(&sOptions, psJobs, ui32NumJobs, i, sOptions.ui32NumParallelJobs);
+			}
+		}
+
+		for (i = 0; i < sOptions.ui32NumParallelJobs; i++)
+		{
+			int iStatus;
+
+			if (aiWorkers[i] > 0 &&
+				(waitpid(aiWorkers[i], &iStatus, 0) < 0 || !WIFEXITED(iStatus) || WEXITSTATUS(iStatus) != 0))
+			{
+				ui32NumFailed++;
+			}
+		}
+	}
+	else
+#endif /* defined(LINUX) */
+	{
+		ui32NumFailed = RunJobs(&sOptions, psJobs, ui32NumJobs, 0, 1);
+	}
+
+	if (sOptions.bMetrics || sOptions.ui32BenchRepeats)
+	{
+		IMG_UINT64 ui64Elapsed = GetTimeInUs() - ui64Start;
+		IMG_UINT32 ui32NumRun = ui32NumJobs * (sOptions.ui32BenchRepeats ? sOptions.ui32BenchRepeats : 1);
+
+		printf("%u jobs, %u workers: %.3f ms wall, %.1f jobs/s\n",
+			   ui32NumRun, sOptions.ui32NumParallelJobs, (double)ui64Elapsed / 1000.0,
+			   ui64Elapsed ? (double)ui32NumRun * 1000000.0 / (double)ui64Elapsed : 0.0);
+	}
+
+	return ui32NumFailed ? 1 : 0;
+}
+
+/******************************************************************************
+ End of file (main.c)
+******************************************************************************/
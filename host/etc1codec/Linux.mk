@@ -0,0 +1,42 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test and benchmark of the GLES2 driver's ETC1 encoder. It builds
+# etc1codec.c with and without its NEON path, checks they encode every image
+# bit for bit the same, and reports the PSNR and encode rate on a set of
+# generated images. Run it with no arguments; it exits non-zero if any
+# check fails.
+#
+
+modules := etc1codec
+
+etc1codec_type := host_executable
+
+etc1codec_extlibs := m
+
+etc1codec_src = \
+ main.c \
+ etc1neon.c \
+ $(TOP)/eurasiacon/opengles2/etc1codec.c
+
+# hostcontext.h stands in for the driver's context.h. The scalar build must
+# stay scalar on an ARM host, and etc1neon.c turns the NEON path back on.
+# Off ARM, neon/arm_neon.h supplies the intrinsics lane by lane.
+etc1codec_cflags := \
+ -DLINUX -DUSER -U__ARM_NEON__ \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/etc1codec/hostcontext.h
+
+etc1codec_includes := host/etc1codec/neon host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2
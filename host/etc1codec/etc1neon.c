@@ -0,0 +1,33 @@
+/******************************************************************************
+ * Name         : etc1neon.c
+ * Title        : NEON build of the GLES2 ETC1 encoder
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's etc1codec.c a second time, with its
+ *                NEON path, under names of its own. On ARM it uses the
+ *                compiler's intrinsics, elsewhere neon/arm_neon.h.
+ *
+ * Modifications:-
+ * $Log: etc1neon.c $
+ *****************************************************************************/
+
+#define __ARM_NEON__ 1
+
+#define EncodeETC1Blocks	NeonEncodeETC1Blocks
+#define DecodeETC1Blocks	NeonDecodeETC1Blocks
+
+#include "etc1codec.c"
+
+/******************************************************************************
+ End of file (etc1neon.c)
+******************************************************************************/
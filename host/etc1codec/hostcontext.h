@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the ETC1 encoder test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of etc1codec.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                codec only needs the image types and two macros.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "img_types.h"
+#include "img_defs.h"
+
+
+/* As context.h */
+#define MIN(a,b) ((a)<(b)?(a):(b))
+
+/* As validate.h */
+#define ALIGNCOUNTINBLOCKS(Size, Log2OfBlockSsize)	(((Size) + ((1UL << (Log2OfBlockSsize)) - 1)) >> (Log2OfBlockSsize))
+
+/* As texture.h */
+IMG_VOID EncodeETC1Blocks(IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+						  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes,
+						  IMG_UINT32 ui32FirstBlockRow, IMG_UINT32 ui32NumBlockRows);
+IMG_VOID DecodeETC1Blocks(const IMG_UINT32 *pui32Src, IMG_UINT8 *pui8Dest, IMG_UINT32 ui32DstBytesPerPixel,
+						  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height);
+
+#endif /* _CONTEXT_ */
@@ -0,0 +1,696 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLES2 ETC1 encoder test and benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's etc1codec.c twice, once scalar and
+ *                once (etc1neon.c) with its NEON sub-block fit, and checks
+ *                the two encode every image to the same blocks bit for
+ *                bit. The images are gradients, smooth noise, hard edges,
+ *                random noise and solid colours, which between them hit
+ *                the clamped candidates and the tied errors where the two
+ *                fits could part ways. Sizes which aren't a multiple of 4,
+ *                all three source formats and padded strides are covered,
+ *                and encoding in bands must give the whole image encode.
+ *
+ *                A fixed set of images is then encoded, decoded and
+ *                compared with its source. Each PSNR must stay above a
+ *                floor a few tenths of a dB under what the encoder gets
+ *                today. Last, the scalar encoder's rate on a large noise
+ *                image is timed. The NEON rate is only timed when built
+ *                for ARM, as the host intrinsics say nothing about speed.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+
+
+#define EC_DEFAULT_RUNS			2000
+#define EC_DEFAULT_PIXELS		(1024 * 1024)
+
+#define EC_MAX_SIZE				67
+#define EC_MAX_PADDING			13
+
+#define EC_CLAMP(i)				(((i) < 0) ? 0 : (((i) > 255) ? 255 : (i)))
+
+/* Image of the PSNR table */
+#define EC_PSNR_SIZE			128
+
+/* Kinds of image */
+#define EC_IMAGE_GRADIENT		0
+#define EC_IMAGE_SMOOTH			1
+#define EC_IMAGE_EDGES			2
+#define EC_IMAGE_NOISE			3
+#define EC_IMAGE_SOLID			4
+#define EC_NUM_IMAGES			5
+
+typedef struct HostSourceRec
+{
+	IMG_UINT32 ui32BytesPerPixel;
+	const IMG_CHAR *pszName;
+
+} HostSource;
+
+static const HostSource g_asSources[] =
+{
+	{2, "RGB565"},
+	{3, "RGB888"},
+	{4, "RGBX8888"},
+};
+
+#define EC_NUM_SOURCES			(sizeof(g_asSources) / sizeof(g_asSources[0]))
+
+static const IMG_CHAR * const g_apszImages[EC_NUM_IMAGES] =
+{
+	"gradient", "smooth", "edges", "noise", "solid"
+};
+
+/*
+ * Least PSNR in dB for each image and 565/888 source. Measured with this
+ * encoder and lowered by 0.3 dB; random noise is what ETC1 is worst at, and
+ * a solid colour is only off by its base colour quantisation.
+ */
+static const double g_adfPSNRFloor[EC_NUM_IMAGES][2] =
+{
+	{39.6, 40.4},
+	{33.0, 33.5},
+	{43.5, 44.8},
+	{12.5, 12.7},
+	{43.0, 39.3},
+};
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random images compared bit for bit (default 2000).\n"
+"-seed=N     Seed for the images (default 1).\n"
+"-pixels=N   Pixels of the timed encode, 0 to skip (default 1048576).\n";
+
+IMG_VOID NeonEncodeETC1Blocks(IMG_UINT32 *pui32Dest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32SrcBytesPerPixel,
+							  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT32 ui32SrcStrideInBytes,
+							  IMG_UINT32 ui32FirstBlockRow, IMG_UINT32 ui32NumBlockRows);
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/*
+** Services mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+
+/***********************************************************************************
+ Function Name      : MakeImage
+ Inputs             : ui32Kind, ui32Width, ui32Height
+ Outputs            : pui8RGB
+ Returns            : -
+ Description        : Fills a tightly packed RGB888 image of the given kind
+************************************************************************************/
+static IMG_VOID MakeImage(IMG_UINT32 ui32Kind, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, IMG_UINT8 *pui8RGB)
+{
+	IMG_UINT32 ui32Pixels = ui32Width * ui32Height;
+	IMG_UINT32 x, y, c, i;
+
+	switch (ui32Kind)
+	{
+		case EC_IMAGE_GRADIENT:
+		{
+			/* Per channel ramps, some running to the ends of the range to clamp the candidates */
+			IMG_INT32 ai32Start[3], ai32DX[3], ai32DY[3];
+
+			for (c = 0; c < 3; c++)
+			{
+				ai32Start[c] = (IMG_INT32)Random(256);
+				ai32DX[c] = (IMG_INT32)Random(33) - 16;
+				ai32DY[c] = (IMG_INT32)Random(33) - 16;
+			}
+
+			for (y = 0; y < ui32Height; y++)
+			{
+				for (x = 0; x < ui32Width; x++)
+				{
+					for (c = 0; c < 3; c++)
+					{
+						IMG_INT32 i32Value = ai32Start[c] + (ai32DX[c] * (IMG_INT32)x + ai32DY[c] * (IMG_INT32)y) / 2;
+
+						pui8RGB[(y * ui32Width + x) * 3 + c] = (IMG_UINT8)EC_CLAMP(i32Value);
+					}
+				}
+			}
+
+			break;
+		}
+		case EC_IMAGE_SMOOTH:
+		{
+			/* Bilinear value noise on a coarse lattice, a stand-in for photographs */
+			IMG_UINT8 aui8Lattice[3][5][5];
+			IMG_UINT32 ui32Cell = 4 + Random(13);
+
+			for (c = 0; c < 3; c++)
+			{
+				for (i = 0; i < 25; i++)
+				{
+					aui8Lattice[c][i / 5][i % 5] = (IMG_UINT8)Random(256);
+				}
+			}
+
+			for (y = 0; y < ui32Height; y++)
+			{
+				for (x = 0; x < ui32Width; x++)
+				{
+					IMG_UINT32 ui32LX = (x / ui32Cell) % 4, ui32LY = (y / ui32Cell) % 4;
+					IMG_UINT32 ui32FX = x % ui32Cell, ui32FY = y % ui32Cell;
+
+					for (c = 0; c < 3; c++)
+					{
+						IMG_UINT32 ui32Top = aui8Lattice[c][ui32LY][ui32LX] * (ui32Cell - ui32FX) +
+											 aui8Lattice[c][ui32LY][ui32LX + 1] * ui32FX;
+						IMG_UINT32 ui32Bottom = aui8Lattice[c][ui32LY + 1][ui32LX] * (ui32Cell - ui32FX) +
+												aui8Lattice[c][ui32LY + 1][ui32LX + 1] * ui32FX;
+						IMG_INT32 i32Value = (IMG_INT32)((ui32Top * (ui32Cell - ui32FY) + ui32Bottom * ui32FY) /
+														 (ui32Cell * ui32Cell)) + (IMG_INT32)Random(7) - 3;
+
+						pui8RGB[(y * ui32Width + x) * 3 + c] = (IMG_UINT8)EC_CLAMP(i32Value);
+					}
+				}
+			}
+
+			break;
+		}
+		case EC_IMAGE_EDGES:
+		{
+			/* Flat regions of two colours split by random lines, often black and white */
+			IMG_UINT8 aui8Colour[2][3];
+			IMG_INT32 i32NX = (IMG_INT32)Random(9) - 4, i32NY = (IMG_INT32)Random(9) - 4;
+			IMG_INT32 i32Offset = (IMG_INT32)Random(2 * EC_MAX_SIZE) - EC_MAX_SIZE;
+			IMG_UINT32 ui32Stripe = 1 + Random(8);
+
+			for (c = 0; c < 3; c++)
+			{
+				aui8Colour[0][c] = (IMG_UINT8)(Random(2) ? 0 : Random(256));
+				aui8Colour[1][c] = (IMG_UINT8)(Random(2) ? 255 : Random(256));
+			}
+
+			for (y = 0; y < ui32Height; y++)
+			{
+				for (x = 0; x < ui32Width; x++)
+				{
+					IMG_INT32 i32Side = i32NX * (IMG_INT32)x + i32NY * (IMG_INT32)y + i32Offset;
+					IMG_UINT32 ui32Colour = (i32Side >= 0) ^ ((x / ui32Stripe) & 1 & (ui32Stripe < 4));
+
+					for (c = 0; c < 3; c++)
+					{
+						pui8RGB[(y * ui32Width + x) * 3 + c] = aui8Colour[ui32Colour][c];
+					}
+				}
+			}
+
+			break;
+		}
+		case EC_IMAGE_NOISE:
+		{
+			for (i = 0; i < ui32Pixels * 3; i++)
+			{
+				pui8RGB[i] = (IMG_UINT8)Random(256);
+			}
+
+			break;
+		}
+		case EC_IMAGE_SOLID:
+		default:
+		{
+			IMG_UINT8 aui8Colour[3];
+
+			for (c = 0; c < 3; c++)
+			{
+				aui8Colour[c] = (IMG_UINT8)(Random(4) ? Random(256) : (Random(2) ? 255 : 0));
+			}
+
+			for (i = 0; i < ui32Pixels; i++)
+			{
+				memcpy(&pui8RGB[i * 3], aui8Colour, 3);
+			}
+
+			break;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : MakeSource
+ Inputs             : pui8RGB, ui32Width, ui32Height, ui32BytesPerPixel, ui32Stride
+ Outputs            : pui8Src, pui8Reference
+ Returns            : -
+ Description        : Packs an RGB888 image into a source of the given format and
+					  stride, with garbage in the padding. The reference is the
+					  RGB888 the encoder sees, so 565 sources are expanded back.
+************************************************************************************/
+static IMG_VOID MakeSource(const IMG_UINT8 *pui8RGB, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height,
+						   IMG_UINT32 ui32BytesPerPixel, IMG_UINT32 ui32Stride,
+						   IMG_UINT8 *pui8Src, IMG_UINT8 *pui8Reference)
+{
+	IMG_UINT32 x, y, i;
+
+	for (i = 0; i < ui32Height * ui32Stride; i++)
+	{
+		pui8Src[i] = (IMG_UINT8)Random(256);
+	}
+
+	for (y = 0; y < ui32Height; y++)
+	{
+		for (x = 0; x < ui32Width; x++)
+		{
+			const IMG_UINT8 *pui8In = &pui8RGB[(y * ui32Width + x) * 3];
+			IMG_UINT8 *pui8Out = &pui8Src[y * ui32Stride + x * ui32BytesPerPixel];
+			IMG_UINT8 *pui8Ref = &pui8Reference[(y * ui32Width + x) * 3];
+
+			if (ui32BytesPerPixel == 2)
+			{
+				IMG_UINT32 ui32R = pui8In[0] >> 3, ui32G = pui8In[1] >> 2, ui32B = pui8In[2] >> 3;
+				IMG_UINT16 ui16Texel = (IMG_UINT16)((ui32R << 11) | (ui32G << 5) | ui32B);
+
+				memcpy(pui8Out, &ui16Texel, 2);
+
+				pui8Ref[0] = (IMG_UINT8)((ui32R << 3) | (ui32R >> 2));
+				pui8Ref[1] = (IMG_UINT8)((ui32G << 2) | (ui32G >> 4));
+				pui8Ref[2] = (IMG_UINT8)((ui32B << 3) | (ui32B >> 2));
+			}
+			else
+			{
+				memcpy(pui8Out, pui8In, 3);
+				memcpy(pui8Ref, pui8In, 3);
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetPSNR
+ Inputs             : pui32Blocks, pui8Reference, ui32Width, ui32Height
+ Outputs            : -
+ Returns            : PSNR in dB of the decoded blocks against the reference
+ Description        : Decodes with the driver's DecodeETC1Blocks to RGBX8888
+************************************************************************************/
+static double GetPSNR(const IMG_UINT32 *pui32Blocks, const IMG_UINT8 *pui8Reference, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height)
+{
+	IMG_UINT8 *pui8Decoded = malloc(ui32Width * ui32Height * 4);
+	double dfError = 0.0;
+	IMG_UINT32 i, c;
+
+	DecodeETC1Blocks(pui32Blocks, pui8Decoded, 4, ui32Width, ui32Height);
+
+	for (i = 0; i < ui32Width * ui32Height; i++)
+	{
+		for (c = 0; c < 3; c++)
+		{
+			double dfDiff = (double)pui8Decoded[i * 4 + c] - (double)pui8Reference[i * 3 + c];
+
+			dfError += dfDiff * dfDiff;
+		}
+	}
+
+	free(pui8Decoded);
+
+	dfError /= (double)(ui32Width * ui32Height * 3);
+
+	return (dfError > 0.0) ? 10.0 * log10(255.0 * 255.0 / dfError) : 99.0;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckImage
+ Inputs             : ui32Run
+ Outputs            : -
+ Returns            : -
+ Description        : Encodes one random image with both paths and in bands
+************************************************************************************/
+static IMG_VOID CheckImage(IMG_UINT32 ui32Run)
+{
+	IMG_UINT32 ui32Kind = Random(EC_NUM_IMAGES);
+	IMG_UINT32 ui32Source = Random(EC_NUM_SOURCES);
+	IMG_UINT32 ui32BytesPerPixel = g_asSources[ui32Source].ui32BytesPerPixel;
+	IMG_UINT32 ui32Width = 1 + Random(EC_MAX_SIZE), ui32Height = 1 + Random(EC_MAX_SIZE);
+	IMG_UINT32 ui32Stride = ui32Width * ui32BytesPerPixel + (Random(2) ? Random(EC_MAX_PADDING) : 0);
+	IMG_UINT32 ui32BlockRows = (ui32Height + 3) >> 2;
+	IMG_UINT32 ui32Blocks = ((ui32Width + 3) >> 2) * ui32BlockRows;
+	IMG_UINT8 *pui8RGB = malloc(ui32Width * ui32Height * 3);
+	IMG_UINT8 *pui8Reference = malloc(ui32Width * ui32Height * 3);
+	IMG_UINT8 *pui8Src;
+	IMG_UINT32 *pui32Scalar = malloc(ui32Blocks * 8);
+	IMG_UINT32 *pui32Neon = malloc(ui32Blocks * 8);
+	IMG_UINT32 *pui32Bands = malloc(ui32Blocks * 8);
+	IMG_UINT32 ui32Row, i;
+
+	/* 16 bit loads of 565 sources need an even stride */
+	if (ui32BytesPerPixel == 2)
+	{
+		ui32Stride = (ui32Stride + 1) & ~1U;
+	}
+
+	pui8Src = malloc(ui32Height * ui32Stride);
+
+	MakeImage(ui32Kind, ui32Width, ui32Height, pui8RGB);
+	MakeSource(pui8RGB, ui32Width, ui32Height, ui32BytesPerPixel, ui32Stride, pui8Src, pui8Reference);
+
+	memset(pui32Scalar, 0xCD, ui32Blocks * 8);
+	memset(pui32Neon, 0xEF, ui32Blocks * 8);
+	memset(pui32Bands, 0xAB, ui32Blocks * 8);
+
+	EncodeETC1Blocks(pui32Scalar, pui8Src, ui32BytesPerPixel, ui32Width, ui32Height, ui32Stride, 0, ui32BlockRows);
+	NeonEncodeETC1Blocks(pui32Neon, pui8Src, ui32BytesPerPixel, ui32Width, ui32Height, ui32Stride, 0, ui32BlockRows);
+
+	for (i = 0; i < ui32Blocks * 2; i += 2)
+	{
+		if (pui32Neon[i] != pui32Scalar[i] || pui32Neon[i + 1] != pui32Scalar[i + 1])
+		{
+			Fail("run %u: %ux%u %s %s image block %u: NEON 0x%08x 0x%08x, scalar 0x%08x 0x%08x",
+				 ui32Run, ui32Width, ui32Height, g_asSources[ui32Source].pszName, g_apszImages[ui32Kind], i / 2,
+				 pui32Neon[i], pui32Neon[i + 1], pui32Scalar[i], pui32Scalar[i + 1]);
+			break;
+		}
+	}
+
+	/* Bands of random height, alternating between the paths */
+	for (ui32Row = 0; ui32Row < ui32BlockRows; )
+	{
+		IMG_UINT32 ui32NumRows = 1 + Random(4);
+
+		ui32NumRows = MIN(ui32NumRows, ui32BlockRows - ui32Row);
+
+		if (ui32Row & 1)
+		{
+			NeonEncodeETC1Blocks(pui32Bands, pui8Src, ui32BytesPerPixel, ui32Width, ui32Height, ui32Stride, ui32Row, ui32NumRows);
+		}
+		else
+		{
+			EncodeETC1Blocks(pui32Bands, pui8Src, ui32BytesPerPixel, ui32Width, ui32Height, ui32Stride, ui32Row, ui32NumRows);
+		}
+
+		ui32Row += ui32NumRows;
+	}
+
+	if (memcmp(pui32Bands, pui32Scalar, ui32Blocks * 8) != 0)
+	{
+		Fail("run %u: %ux%u %s %s image encoded in bands differs from the whole image",
+			 ui32Run, ui32Width, ui32Height, g_asSources[ui32Source].pszName, g_apszImages[ui32Kind]);
+	}
+
+	/* A solid colour must decode to within its base colour quantisation */
+	if (ui32Kind == EC_IMAGE_SOLID && GetPSNR(pui32Scalar, pui8Reference, ui32Width, ui32Height) < 30.0)
+	{
+		Fail("run %u: %ux%u %s solid image decodes at %.2f dB", ui32Run, ui32Width, ui32Height,
+			 g_asSources[ui32Source].pszName, GetPSNR(pui32Scalar, pui8Reference, ui32Width, ui32Height));
+	}
+
+	free(pui8RGB);
+	free(pui8Reference);
+	free(pui8Src);
+	free(pui32Scalar);
+	free(pui32Neon);
+	free(pui32Bands);
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckPSNR
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : Prints and checks the PSNR of a fixed image of each kind
+************************************************************************************/
+static IMG_VOID CheckPSNR(IMG_VOID)
+{
+	IMG_UINT32 ui32Blocks = (EC_PSNR_SIZE / 4) * (EC_PSNR_SIZE / 4);
+	IMG_UINT8 *pui8RGB = malloc(EC_PSNR_SIZE * EC_PSNR_SIZE * 3);
+	IMG_UINT8 *pui8Reference = malloc(EC_PSNR_SIZE * EC_PSNR_SIZE * 3);
+	IMG_UINT8 *pui8Src = malloc(EC_PSNR_SIZE * EC_PSNR_SIZE * 3);
+	IMG_UINT32 *pui32Scalar = malloc(ui32Blocks * 8);
+	IMG_UINT32 *pui32Neon = malloc(ui32Blocks * 8);
+	IMG_UINT32 ui32Kind, ui32Source, ui32SavedRandom = g_ui32Random;
+
+	printf("%-9s %10s %10s\n", "image", "565 PSNR", "888 PSNR");
+
+	for (ui32Kind = 0; ui32Kind < EC_NUM_IMAGES; ui32Kind++)
+	{
+		printf("%-9s", g_apszImages[ui32Kind]);
+
+		for (ui32Source = 0; ui32Source < 2; ui32Source++)
+		{
+			IMG_UINT32 ui32BytesPerPixel = ui32Source ? 3 : 2;
+			double dfPSNR;
+
+			/* The same images whatever the seed, so the floors hold */
+			g_ui32Random = 0x9E3779B9U + ui32Kind;
+
+			MakeImage(ui32Kind, EC_PSNR_SIZE, EC_PSNR_SIZE, pui8RGB);
+			MakeSource(pui8RGB, EC_PSNR_SIZE, EC_PSNR_SIZE, ui32BytesPerPixel, EC_PSNR_SIZE * ui32BytesPerPixel,
+					   pui8Src, pui8Reference);
+
+			EncodeETC1Blocks(pui32Scalar, pui8Src, ui32BytesPerPixel, EC_PSNR_SIZE, EC_PSNR_SIZE,
+							 EC_PSNR_SIZE * ui32BytesPerPixel, 0, EC_PSNR_SIZE / 4);
+			NeonEncodeETC1Blocks(pui32Neon, pui8Src, ui32BytesPerPixel, EC_PSNR_SIZE, EC_PSNR_SIZE,
+								 EC_PSNR_SIZE * ui32BytesPerPixel, 0, EC_PSNR_SIZE / 4);
+
+			dfPSNR = GetPSNR(pui32Scalar, pui8Reference, EC_PSNR_SIZE, EC_PSNR_SIZE);
+
+			printf(" %7.2f dB", dfPSNR);
+
+			if (memcmp(pui32Neon, pui32Scalar, ui32Blocks * 8) != 0)
+			{
+				Fail("%s %s image: NEON and scalar blocks differ", g_apszImages[ui32Kind], g_asSources[ui32Source + 1].pszName);
+			}
+
+			if (dfPSNR < g_adfPSNRFloor[ui32Kind][ui32Source])
+			{
+				Fail("%s %s image: PSNR %.2f dB is under its floor of %.2f dB", g_apszImages[ui32Kind],
+					 ui32Source ? "RGB888" : "RGB565", dfPSNR, g_adfPSNRFloor[ui32Kind][ui32Source]);
+			}
+		}
+
+		printf("\n");
+	}
+
+	g_ui32Random = ui32SavedRandom;
+
+	free(pui8RGB);
+	free(pui8Reference);
+	free(pui8Src);
+	free(pui32Scalar);
+	free(pui32Neon);
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeEncode
+ Inputs             : pfnEncode, pui8Src, ui32Size
+ Outputs            : pui32Blocks
+ Returns            : Best of three encode rates in Mpixel/s
+ Description        : Times whole image RGB888 encodes of a square image
+************************************************************************************/
+static double TimeEncode(IMG_VOID (*pfnEncode)(IMG_UINT32 *, const IMG_UINT8 *, IMG_UINT32, IMG_UINT32, IMG_UINT32,
+											   IMG_UINT32, IMG_UINT32, IMG_UINT32),
+						 const IMG_UINT8 *pui8Src, IMG_UINT32 ui32Size, IMG_UINT32 *pui32Blocks)
+{
+	double dfBest = 1e30;
+	IMG_UINT32 i;
+
+	for (i = 0; i < 3; i++)
+	{
+		double dfStart = GetSeconds(), dfTime;
+
+		pfnEncode(pui32Blocks, pui8Src, 3, ui32Size, ui32Size, ui32Size * 3, 0, (ui32Size + 3) >> 2);
+
+		dfTime = GetSeconds() - dfStart;
+
+		if (dfTime < dfBest)
+		{
+			dfBest = dfTime;
+		}
+	}
+
+	return (double)ui32Size * (double)ui32Size / dfBest / 1e6;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunBenchmark
+ Inputs             : ui32Pixels
+ Outputs            : -
+ Returns            : -
+ Description        : Encode rate of a smooth noise image of about ui32Pixels
+************************************************************************************/
+static IMG_VOID RunBenchmark(IMG_UINT32 ui32Pixels)
+{
+	IMG_UINT32 ui32Size = (IMG_UINT32)sqrt((double)ui32Pixels);
+	IMG_UINT32 ui32Blocks, ui32SavedRandom = g_ui32Random;
+	IMG_UINT8 *pui8RGB;
+	IMG_UINT32 *pui32Blocks;
+	double dfRate;
+
+	ui32Size = (ui32Size + 3) & ~3U;
+	ui32Blocks = (ui32Size / 4) * (ui32Size / 4);
+
+	pui8RGB = malloc(ui32Size * ui32Size * 3);
+	pui32Blocks = malloc(ui32Blocks * 8);
+
+	g_ui32Random = 0x9E3779B9U;
+
+	MakeImage(EC_IMAGE_SMOOTH, ui32Size, ui32Size, pui8RGB);
+
+	dfRate = TimeEncode(EncodeETC1Blocks, pui8RGB, ui32Size, pui32Blocks);
+
+	printf("%ux%u RGB888 smooth image: scalar %.2f Mpixel/s", ui32Size, ui32Size, dfRate);
+
+#if defined(__arm__) || defined(__aarch64__)
+	printf(", NEON %.2f Mpixel/s", TimeEncode(NeonEncodeETC1Blocks, pui8RGB, ui32Size, pui32Blocks));
+#endif
+
+	printf(", %.2f dB\n", GetPSNR(pui32Blocks, pui8RGB, ui32Size, ui32Size));
+
+	g_ui32Random = ui32SavedRandom;
+
+	free(pui8RGB);
+	free(pui32Blocks);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = EC_DEFAULT_RUNS, ui32Pixels = EC_DEFAULT_PIXELS;
+	IMG_UINT32 ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-pixels=", strlen("-pixels=")) == 0)
+		{
+			ui32Pixels = strtoul(argv[1] + strlen("-pixels="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: etc1codec [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		CheckImage(i);
+	}
+
+	printf("%u random images (seed %u) encoded by both paths\n", i, ui32Seed);
+
+	CheckPSNR();
+
+	if (ui32Pixels)
+	{
+		RunBenchmark(ui32Pixels);
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
+
+/******************************************************************************
+ End of file (main.c)
+******************************************************************************/
@@ -0,0 +1,281 @@
+/******************************************************************************
+ * Name         : arm_neon.h
+ * Title        : Lane by lane NEON intrinsics for host builds
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : On ARM this is the compiler's arm_neon.h. Elsewhere it
+ *                defines the intrinsics etc1codec.c uses, with the ARM
+ *                prototypes and per-lane results, so the NEON path can be
+ *                checked against the scalar one on the build host. Each
+ *                vector type is a distinct struct, so passing the wrong
+ *                type is a compile error as it is on ARM. Integer lanes
+ *                wrap as the instructions do.
+ *
+ * Modifications:-
+ * $Log: arm_neon.h $
+ *****************************************************************************/
+
+#if defined(__arm__) || defined(__aarch64__)
+
+#include_next <arm_neon.h>
+
+#else /* defined(__arm__) || defined(__aarch64__) */
+
+#ifndef _HOST_ARM_NEON_
+#define _HOST_ARM_NEON_
+
+#include <stdint.h>
+
+typedef struct { int16_t  v[4]; } int16x4_t;
+typedef struct { int16_t  v[8]; } int16x8_t;
+typedef struct { int32_t  v[2]; } int32x2_t;
+typedef struct { int32_t  v[4]; } int32x4_t;
+typedef struct { uint32_t v[4]; } uint32x4_t;
+
+/* VLD1.16 */
+static __inline int16x8_t vld1q_s16(const int16_t *p)
+{
+	int16x8_t r;
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		r.v[i] = p[i];
+	}
+
+	return r;
+}
+
+/* VST1.32 */
+static __inline void vst1q_u32(uint32_t *p, uint32x4_t a)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		p[i] = a.v[i];
+	}
+}
+
+/* VDUP */
+static __inline int16x8_t vdupq_n_s16(int16_t a)
+{
+	int16x8_t r;
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		r.v[i] = a;
+	}
+
+	return r;
+}
+
+static __inline int32x4_t vdupq_n_s32(int32_t a)
+{
+	int32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = a;
+	}
+
+	return r;
+}
+
+static __inline uint32x4_t vdupq_n_u32(uint32_t a)
+{
+	uint32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = a;
+	}
+
+	return r;
+}
+
+/* VSUB.I16, modulo 2^16 */
+static __inline int16x8_t vsubq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t r;
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		r.v[i] = (int16_t)(uint16_t)((uint16_t)a.v[i] - (uint16_t)b.v[i]);
+	}
+
+	return r;
+}
+
+/* Halves of a quad register */
+static __inline int16x4_t vget_low_s16(int16x8_t a)
+{
+	int16x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = a.v[i];
+	}
+
+	return r;
+}
+
+static __inline int16x4_t vget_high_s16(int16x8_t a)
+{
+	int16x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = a.v[i + 4];
+	}
+
+	return r;
+}
+
+static __inline int32x2_t vget_low_s32(int32x4_t a)
+{
+	int32x2_t r;
+
+	r.v[0] = a.v[0];
+	r.v[1] = a.v[1];
+
+	return r;
+}
+
+static __inline int32x2_t vget_high_s32(int32x4_t a)
+{
+	int32x2_t r;
+
+	r.v[0] = a.v[2];
+	r.v[1] = a.v[3];
+
+	return r;
+}
+
+/* VMULL.S16, exact */
+static __inline int32x4_t vmull_s16(int16x4_t a, int16x4_t b)
+{
+	int32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (int32_t)a.v[i] * (int32_t)b.v[i];
+	}
+
+	return r;
+}
+
+/* VMLAL.S16, accumulating modulo 2^32 */
+static __inline int32x4_t vmlal_s16(int32x4_t c, int16x4_t a, int16x4_t b)
+{
+	int32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (int32_t)((uint32_t)c.v[i] + (uint32_t)((int32_t)a.v[i] * (int32_t)b.v[i]));
+	}
+
+	return r;
+}
+
+/* VADD.I32, modulo 2^32 */
+static __inline int32x4_t vaddq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (int32_t)((uint32_t)a.v[i] + (uint32_t)b.v[i]);
+	}
+
+	return r;
+}
+
+static __inline int32x2_t vadd_s32(int32x2_t a, int32x2_t b)
+{
+	int32x2_t r;
+
+	r.v[0] = (int32_t)((uint32_t)a.v[0] + (uint32_t)b.v[0]);
+	r.v[1] = (int32_t)((uint32_t)a.v[1] + (uint32_t)b.v[1]);
+
+	return r;
+}
+
+/* VPADD.I32: pairs of a, then pairs of b */
+static __inline int32x2_t vpadd_s32(int32x2_t a, int32x2_t b)
+{
+	int32x2_t r;
+
+	r.v[0] = (int32_t)((uint32_t)a.v[0] + (uint32_t)a.v[1]);
+	r.v[1] = (int32_t)((uint32_t)b.v[0] + (uint32_t)b.v[1]);
+
+	return r;
+}
+
+/* VCGT.S32 with the operands swapped, all ones where a < b */
+static __inline uint32x4_t vcltq_s32(int32x4_t a, int32x4_t b)
+{
+	uint32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (a.v[i] < b.v[i]) ? 0xFFFFFFFFU : 0;
+	}
+
+	return r;
+}
+
+/* VMIN.S32 */
+static __inline int32x4_t vminq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (a.v[i] < b.v[i]) ? a.v[i] : b.v[i];
+	}
+
+	return r;
+}
+
+/* VBSL: bits of a where the mask is set, else bits of b */
+static __inline uint32x4_t vbslq_u32(uint32x4_t m, uint32x4_t a, uint32x4_t b)
+{
+	uint32x4_t r;
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		r.v[i] = (m.v[i] & a.v[i]) | (~m.v[i] & b.v[i]);
+	}
+
+	return r;
+}
+
+/* VMOV.32 from a lane; the lane must be a constant on ARM */
+#define vget_lane_s32(a, lane)	((a).v[(lane)])
+
+#endif /* _HOST_ARM_NEON_ */
+
+#endif /* defined(__arm__) || defined(__aarch64__) */
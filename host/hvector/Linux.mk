@@ -0,0 +1,43 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without
+# the express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test and benchmark of the USC hybrid bitvectors. It checks every
+# USC_HVECTOR operation against the extendable USC_VECTOR and a plain bit
+# array, then solves register liveness on random flow graphs with each and
+# reports the time each takes. Run it with no arguments; it exits non-zero
+# if any result differs.
+#
+
+modules := hvector
+
+hvector_type := host_executable
+
+hvector_src = \
+ main.c \
+ $(TOP)/tools/intern/usc2/data.c
+
+# The same feature defines as the compiler build in host/esbincompiler, so
+# the intermediate state headers lay out as they do there.
+hvector_cflags := \
+ -DLINUX -DUSER -D'IMG_ABORT()=abort()' -DSTANDALONE -DGLSL_ES -DGEN_HW_CODE -DOUTPUT_USPBIN \
+ -DINCLUDE_SGX_FEATURE_TABLE -DINCLUDE_SGX_BUG_TABLE -DSUPPORT_SGX543 \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h
+
+hvector_includes := include/gpu_es4 \
+ include/gpu_es4/eurasia/hwdefs include/gpu_es4/eurasia/include4 \
+ tools/intern/usp tools/intern/usc2 tools/intern/useasm \
+ intermediates/sgxsupport intermediates/errata
+
+ifeq ($(BUILD),debug)
+hvector_cflags += -DDEBUG
+endif
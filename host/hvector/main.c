@@ -0,0 +1,1119 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : USC hybrid bitvector test and liveness benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : The first part runs random sequences of range updates,
+ *                unions, intersections, subtractions, copies and
+ *                comparisons on USC_HVECTORs (data.c), repeating each on
+ *                the extendable USC_VECTOR the register livesets used
+ *                before and on a plain bit array. The spans and densities
+ *                are chosen so the vectors move between the sparse and
+ *                dense forms. After every step all three must hold the
+ *                same bits, the hybrid operations must report a change
+ *                exactly when the plain array changed, and both iterators
+ *                must visit the same ranges at every step size.
+ *
+ *                The second part solves backward register liveness over
+ *                random flow graphs the way dce.c does: once with
+ *                USC_VECTORs and a FIFO of blocks in program order, as
+ *                before, then with USC_HVECTORs through the same FIFO and
+ *                with USC_HVECTORs swept in postorder. The live-in and
+ *                live-out sets of every block must match. It then reports
+ *                the time each solution takes, so the representation and
+ *                the visit order can be judged separately.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "uscshrd.h"
+
+
+/* Largest bit index the equivalence test uses */
+#define HV_MAX_BITS				(1U << 16)
+#define HV_MAX_WORDS			(HV_MAX_BITS / BITS_PER_UINT)
+#define HV_NUM_SETS				4
+
+#define HV_DEFAULT_RUNS			400
+#define HV_DEFAULT_STEPS		200
+
+#define HV_DEFAULT_BLOCKS		200
+#define HV_DEFAULT_REGISTERS	2000
+#define HV_DEFAULT_REPS			20
+#define HV_INSTS_PER_BLOCK		12
+
+/* Each block mostly touches registers near its own, as shader temporaries do */
+#define HV_REGISTER_WINDOW		64
+
+typedef struct _HV_SET_
+{
+	USC_HVECTOR	sHybrid;
+	USC_VECTOR	sExtendable;
+	IMG_UINT32	auBits[HV_MAX_WORDS];
+
+} HV_SET;
+
+typedef struct _HV_INST_
+{
+	IMG_UINT32	uRegister;
+	IMG_UINT32	uDefMask;
+	IMG_UINT32	uUseMask;
+
+} HV_INST;
+
+typedef struct _HV_BLOCK_
+{
+	HV_INST		asInsts[HV_INSTS_PER_BLOCK];
+	IMG_UINT32	uNumSuccs;
+	IMG_UINT32	auSuccs[2];
+	IMG_UINT32	uNumPreds;
+	IMG_PUINT32	puPreds;
+
+	/* Liveness solved with the extendable vectors */
+	USC_VECTOR	sLiveInExtendable;
+	USC_VECTOR	sLiveOutExtendable;
+
+	/* Liveness solved with the hybrid vectors */
+	USC_HVECTOR	sLiveInHybrid;
+	USC_HVECTOR	sLiveOutHybrid;
+	IMG_BOOL	bNeedsUpdate;
+
+} HV_BLOCK;
+
+typedef struct _HV_GRAPH_
+{
+	HV_BLOCK	*psBlocks;
+	IMG_UINT32	uNumBlocks;
+	IMG_UINT32	uNumRegisters;
+	IMG_PUINT32	puPostorder;
+
+} HV_GRAPH;
+
+static HV_SET g_asSets[HV_NUM_SETS];
+static IMG_UINT32 g_uNumErrors;
+static IMG_UINT32 g_uRandom = 1;
+static IMG_UINT32 g_uLiveAllocs;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N       Random operation sequences (default 400).\n"
+"-steps=N      Operations per sequence (default 200).\n"
+"-blocks=N     Blocks in each liveness graph (default 200).\n"
+"-registers=N  Registers in each liveness graph (default 2000).\n"
+"-reps=N       Liveness solutions timed (default 20, 0 to only compare).\n"
+"-seed=N       Seed for the sequences and graphs (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_uNumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : uRange
+ Outputs            : -
+ Returns            : Pseudo-random number below uRange
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 uRange)
+{
+	g_uRandom ^= g_uRandom << 13;
+	g_uRandom ^= g_uRandom >> 17;
+	g_uRandom ^= g_uRandom << 5;
+
+	return g_uRandom % uRange;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/*
+** Compiler memory and error mocks
+*/
+
+IMG_PVOID UscAllocfn(USC_DATA_STATE_PTR psState, IMG_UINT32 uSize)
+{
+	IMG_PVOID pvBlock;
+
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	pvBlock = malloc(uSize ? uSize : 1);
+
+	if (pvBlock == NULL)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	g_uLiveAllocs++;
+
+	return pvBlock;
+}
+
+IMG_VOID _UscFree(USC_DATA_STATE_PTR psState, IMG_PVOID *pvBlock)
+{
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	if (*pvBlock != NULL)
+	{
+		g_uLiveAllocs--;
+		free(*pvBlock);
+		*pvBlock = NULL;
+	}
+}
+
+void UscAbort(IMG_PVOID pvState, IMG_UINT32 uError, IMG_PCHAR pcErrorStr, IMG_PCHAR pszFile, IMG_UINT32 uLine)
+{
+	PVR_UNREFERENCED_PARAMETER(pvState);
+
+	fprintf(stderr, "error: compiler abort %u (%s) at %s:%u\n", uError, pcErrorStr ? pcErrorStr : "", pszFile, uLine);
+	exit(1);
+}
+
+IMG_INT32 CompareArgs(const ARG *psArgA, const ARG *psArgB)
+{
+	PVR_UNREFERENCED_PARAMETER(psArgA);
+	PVR_UNREFERENCED_PARAMETER(psArgB);
+
+	fprintf(stderr, "error: CompareArgs isn't used by the bitvectors\n");
+	exit(1);
+}
+
+
+/***********************************************************************************
+ Function Name      : RefGet
+ Inputs             : puBits, uEndIdx, uStartIdx
+ Outputs            : -
+ Returns            : Bits uStartIdx to uEndIdx of a plain bit array
+ Description        : -
+************************************************************************************/
+static IMG_UINT32 RefGet(const IMG_UINT32 *puBits, IMG_UINT32 uEndIdx, IMG_UINT32 uStartIdx)
+{
+	IMG_UINT32 uData = 0, uBit;
+
+	for (uBit = uStartIdx; uBit <= uEndIdx; uBit++)
+	{
+		uData |= ((puBits[uBit / BITS_PER_UINT] >> (uBit % BITS_PER_UINT)) & 1) << (uBit - uStartIdx);
+	}
+
+	return uData;
+}
+
+
+/***********************************************************************************
+ Function Name      : RefUpdate
+ Inputs             : puBits, uEndIdx, uStartIdx, uClear, uSet
+ Outputs            : puBits
+ Returns            : -
+ Description        : Clears then sets bits in a range of a plain bit array
+************************************************************************************/
+static IMG_VOID RefUpdate(IMG_UINT32 *puBits, IMG_UINT32 uEndIdx, IMG_UINT32 uStartIdx,
+						  IMG_UINT32 uClear, IMG_UINT32 uSet)
+{
+	IMG_UINT32 uBit, uMask;
+
+	for (uBit = uStartIdx; uBit <= uEndIdx; uBit++)
+	{
+		uMask = 1U << (uBit % BITS_PER_UINT);
+
+		if ((uClear >> (uBit - uStartIdx)) & 1)
+		{
+			puBits[uBit / BITS_PER_UINT] &= ~uMask;
+		}
+		if ((uSet >> (uBit - uStartIdx)) & 1)
+		{
+			puBits[uBit / BITS_PER_UINT] |= uMask;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckIterators
+ Inputs             : psSet, uSpan, uStep, pszName
+ Outputs            : -
+ Returns            : -
+ Description        : Walks both iterators over a set in ranges of uStep bits
+					  and checks they visit exactly the non-empty ranges of
+					  the plain array in the first uSpan bits, in order, and
+					  nothing after
+************************************************************************************/
+static IMG_VOID CheckIterators(HV_SET *psSet, IMG_UINT32 uSpan, IMG_UINT32 uStep, const IMG_CHAR *pszName)
+{
+	HVECTOR_ITERATOR sHybridIter;
+	VECTOR_ITERATOR sExtendableIter;
+	IMG_UINT32 uPos, uMask;
+
+	HVectorIteratorInitialize(IMG_NULL, &psSet->sHybrid, uStep, &sHybridIter);
+	VectorIteratorInitialize(IMG_NULL, &psSet->sExtendable, uStep, &sExtendableIter);
+
+	for (uPos = 0; uPos < uSpan; uPos += uStep)
+	{
+		uMask = RefGet(psSet->auBits, uPos + uStep - 1, uPos);
+
+		if (uMask == 0)
+		{
+			continue;
+		}
+
+		if (!HVectorIteratorContinue(&sHybridIter) ||
+			HVectorIteratorCurrentPosition(&sHybridIter) != uPos ||
+			HVectorIteratorCurrentMask(&sHybridIter) != uMask)
+		{
+			Fail("%s: hybrid iterator with step %u missed bits %u-%u (0x%x)", pszName, uStep, uPos, uPos + uStep - 1, uMask);
+			return;
+		}
+
+		if (!VectorIteratorContinue(&sExtendableIter) ||
+			VectorIteratorCurrentPosition(&sExtendableIter) != uPos ||
+			VectorIteratorCurrentMask(&sExtendableIter) != uMask)
+		{
+			Fail("%s: extendable iterator with step %u missed bits %u-%u (0x%x)", pszName, uStep, uPos, uPos + uStep - 1, uMask);
+			return;
+		}
+
+		HVectorIteratorNext(&sHybridIter);
+		VectorIteratorNext(&sExtendableIter);
+	}
+
+	if (HVectorIteratorContinue(&sHybridIter))
+	{
+		Fail("%s: hybrid iterator with step %u visits bit %u, which is clear", pszName, uStep,
+			 HVectorIteratorCurrentPosition(&sHybridIter));
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckSet
+ Inputs             : psSet, uSpan, pszName
+ Outputs            : -
+ Returns            : -
+ Description        : Checks the hybrid and extendable vectors hold the bits of
+					  the plain array, and that the hybrid vector's storage
+					  is consistent
+************************************************************************************/
+static IMG_VOID CheckSet(HV_SET *psSet, IMG_UINT32 uSpan, const IMG_CHAR *pszName)
+{
+	USC_PHVECTOR psHybrid = &psSet->sHybrid;
+	IMG_UINT32 uWord, uHybrid, uExtendable, uEntry;
+	IMG_UINT32 uNumWords = (uSpan + BITS_PER_UINT - 1) / BITS_PER_UINT + 1;
+
+	if (psHybrid->uCount > psHybrid->uMaxCount)
+	{
+		Fail("%s: %u entries stored in space for %u", pszName, psHybrid->uCount, psHybrid->uMaxCount);
+		return;
+	}
+
+	if (!psHybrid->bDense)
+	{
+		for (uEntry = 1; uEntry < psHybrid->uCount; uEntry++)
+		{
+			if (psHybrid->puWordIdx[uEntry - 1] >= psHybrid->puWordIdx[uEntry])
+			{
+				Fail("%s: sparse word numbers out of order at entry %u", pszName, uEntry);
+				return;
+			}
+		}
+	}
+
+	for (uWord = 0; uWord < uNumWords && uWord < HV_MAX_WORDS; uWord++)
+	{
+		uHybrid = HVectorGetRange(IMG_NULL, psHybrid, uWord * BITS_PER_UINT + BITS_PER_UINT - 1, uWord * BITS_PER_UINT);
+		uExtendable = VectorGetRange(IMG_NULL, &psSet->sExtendable, uWord * BITS_PER_UINT + BITS_PER_UINT - 1, uWord * BITS_PER_UINT);
+
+		if (uHybrid != psSet->auBits[uWord] || uExtendable != psSet->auBits[uWord])
+		{
+			Fail("%s: word %u is 0x%08x hybrid (%s), 0x%08x extendable, expected 0x%08x", pszName, uWord,
+				 uHybrid, psHybrid->bDense ? "dense" : "sparse", uExtendable, psSet->auBits[uWord]);
+			return;
+		}
+	}
+
+	/* Beyond the largest span both must read as clear */
+	if (HVectorGetRange(IMG_NULL, psHybrid, HV_MAX_BITS + 40, HV_MAX_BITS + 9) != 0 ||
+		VectorGetRange(IMG_NULL, &psSet->sExtendable, HV_MAX_BITS + 40, HV_MAX_BITS + 9) != 0)
+	{
+		Fail("%s: bits set beyond the span", pszName);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : RunSequence
+ Inputs             : uRun, uSteps
+ Outputs            : -
+ Returns            : -
+ Description        : One random sequence of operations over HV_NUM_SETS sets
+					  confined to a random span and density
+************************************************************************************/
+static IMG_VOID RunSequence(IMG_UINT32 uRun, IMG_UINT32 uSteps)
+{
+	static const IMG_UINT32 auSpans[] = {32, 100, 1024, 8192, HV_MAX_BITS};
+	static const IMG_UINT32 auSteps[] = {1, 2, 4, 8, 16, 32};
+	IMG_UINT32 uSpan = auSpans[Random(sizeof(auSpans) / sizeof(auSpans[0]))];
+	IMG_UINT32 uStep, uDest, uSrc, uWord, uStart, uLength, uEnd, uData;
+	IMG_UINT32 auBefore[HV_MAX_WORDS];
+	IMG_BOOL bChanged, bRefChanged, bEqual;
+	IMG_CHAR acName[96];
+	USC_VECTOR sCompare;
+
+	for (uDest = 0; uDest < HV_NUM_SETS; uDest++)
+	{
+		InitHVector(&g_asSets[uDest].sHybrid);
+		InitVector(&g_asSets[uDest].sExtendable, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+		memset(g_asSets[uDest].auBits, 0, sizeof(g_asSets[uDest].auBits));
+	}
+
+	for (uStep = 0; uStep < uSteps && !g_uNumErrors; uStep++)
+	{
+		HV_SET *psDest, *psSrc;
+		IMG_UINT32 uOp = Random(100);
+
+		uDest = Random(HV_NUM_SETS);
+		uSrc = Random(HV_NUM_SETS);
+		psDest = &g_asSets[uDest];
+		psSrc = &g_asSets[uSrc];
+
+		memcpy(auBefore, psDest->auBits, sizeof(auBefore));
+
+		uStart = Random(uSpan);
+		uLength = 1 + Random(BITS_PER_UINT);
+		uEnd = (uStart + uLength - 1 < uSpan) ? uStart + uLength - 1 : uSpan - 1;
+		uData = Random(0xFFFFFFFFU) ^ (Random(2) ? 0 : Random(0xFFFFFFFFU));
+
+		sprintf(acName, "run %u step %u op %u set %u<-%u", uRun, uStep, uOp, uDest, uSrc);
+
+		if (uOp < 30)
+		{
+			HVectorSetRange(IMG_NULL, &psDest->sHybrid, uEnd, uStart, uData);
+			VectorSetRange(IMG_NULL, &psDest->sExtendable, uEnd, uStart, uData);
+			RefUpdate(psDest->auBits, uEnd, uStart, UINT_MAX, uData);
+		}
+		else if (uOp < 50)
+		{
+			HVectorOrRange(IMG_NULL, &psDest->sHybrid, uEnd, uStart, uData);
+			VectorOrRange(IMG_NULL, &psDest->sExtendable, uEnd, uStart, uData);
+			RefUpdate(psDest->auBits, uEnd, uStart, 0, uData);
+		}
+		else if (uOp < 58)
+		{
+			HVectorAndRange(IMG_NULL, &psDest->sHybrid, uEnd, uStart, uData);
+			VectorAndRange(IMG_NULL, &psDest->sExtendable, uEnd, uStart, uData);
+			RefUpdate(psDest->auBits, uEnd, uStart, ~uData, 0);
+		}
+		else if (uOp < 72)
+		{
+			bChanged = HVectorUnion(IMG_NULL, &psDest->sHybrid, &psSrc->sHybrid);
+			VectorOp(IMG_NULL, USC_VEC_OR, &psDest->sExtendable, &psDest->sExtendable, &psSrc->sExtendable);
+			for (uWord = 0; uWord < HV_MAX_WORDS; uWord++)
+			{
+				psDest->auBits[uWord] |= psSrc->auBits[uWord];
+			}
+
+			bRefChanged = memcmp(auBefore, psDest->auBits, sizeof(auBefore)) ? IMG_TRUE : IMG_FALSE;
+			if (bChanged != bRefChanged)
+			{
+				Fail("%s: union reported %s", acName, bChanged ? "a change" : "no change");
+			}
+		}
+		else if (uOp < 78)
+		{
+			bChanged = HVectorIntersect(IMG_NULL, &psDest->sHybrid, &psSrc->sHybrid);
+			VectorOp(IMG_NULL, USC_VEC_AND, &psDest->sExtendable, &psDest->sExtendable, &psSrc->sExtendable);
+			for (uWord = 0; uWord < HV_MAX_WORDS; uWord++)
+			{
+				psDest->auBits[uWord] &= psSrc->auBits[uWord];
+			}
+
+			bRefChanged = memcmp(auBefore, psDest->auBits, sizeof(auBefore)) ? IMG_TRUE : IMG_FALSE;
+			if (bChanged != bRefChanged)
+			{
+				Fail("%s: intersect reported %s", acName, bChanged ? "a change" : "no change");
+			}
+		}
+		else if (uOp < 86)
+		{
+			bChanged = HVectorSubtract(IMG_NULL, &psDest->sHybrid, &psSrc->sHybrid);
+
+			/* USC_VECTOR has no subtract, so clear the source's bits a word at a time */
+			if (uDest == uSrc)
+			{
+				memset(psDest->auBits, 0, sizeof(psDest->auBits));
+				ClearVector(IMG_NULL, &psDest->sExtendable);
+			}
+			else
+			{
+				for (uWord = 0; uWord < HV_MAX_WORDS; uWord++)
+				{
+					if (psSrc->auBits[uWord] != 0)
+					{
+						psDest->auBits[uWord] &= ~psSrc->auBits[uWord];
+						VectorAndRange(IMG_NULL, &psDest->sExtendable, uWord * BITS_PER_UINT + BITS_PER_UINT - 1,
+									   uWord * BITS_PER_UINT, ~psSrc->auBits[uWord]);
+					}
+				}
+			}
+
+			bRefChanged = memcmp(auBefore, psDest->auBits, sizeof(auBefore)) ? IMG_TRUE : IMG_FALSE;
+			if (bChanged != bRefChanged)
+			{
+				Fail("%s: subtract reported %s", acName, bChanged ? "a change" : "no change");
+			}
+		}
+		else if (uOp < 92)
+		{
+			bEqual = HVectorEqual(IMG_NULL, &psDest->sHybrid, &psSrc->sHybrid);
+			bRefChanged = memcmp(psDest->auBits, psSrc->auBits, sizeof(psDest->auBits)) ? IMG_FALSE : IMG_TRUE;
+
+			if (bEqual != bRefChanged)
+			{
+				Fail("%s: equal returned %u", acName, bEqual);
+			}
+
+			InitVector(&sCompare, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+			if ((VectorOp(IMG_NULL, USC_VEC_EQ, &sCompare, &psDest->sExtendable, &psSrc->sExtendable) != IMG_NULL) != bRefChanged)
+			{
+				Fail("%s: extendable equal disagrees", acName);
+			}
+			ClearVector(IMG_NULL, &sCompare);
+		}
+		else if (uOp < 98)
+		{
+			HVectorCopy(IMG_NULL, &psSrc->sHybrid, &psDest->sHybrid);
+
+			/* VectorCopy detaches the destination's chunks before walking the source's, so self-copies are skipped */
+			if (uDest != uSrc)
+			{
+				VectorCopy(IMG_NULL, &psSrc->sExtendable, &psDest->sExtendable);
+			}
+			memcpy(psDest->auBits, psSrc->auBits, sizeof(psDest->auBits));
+		}
+		else
+		{
+			ClearHVector(IMG_NULL, &psDest->sHybrid);
+			ClearVector(IMG_NULL, &psDest->sExtendable);
+			memset(psDest->auBits, 0, sizeof(psDest->auBits));
+		}
+
+		CheckSet(psDest, uSpan, acName);
+
+		if ((uStep % 16) == 0)
+		{
+			CheckIterators(psDest, uSpan, auSteps[Random(sizeof(auSteps) / sizeof(auSteps[0]))], acName);
+		}
+	}
+
+	for (uDest = 0; uDest < HV_NUM_SETS; uDest++)
+	{
+		ClearHVector(IMG_NULL, &g_asSets[uDest].sHybrid);
+		ClearVector(IMG_NULL, &g_asSets[uDest].sExtendable);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : BuildFlowGraph
+ Inputs             : psGraph, uNumBlocks, uNumRegisters
+ Outputs            : psGraph
+ Returns            : -
+ Description        : Builds a random flow graph in which every block falls
+					  through to the next, and some also branch forwards or
+					  back, with instructions defining and using channels of
+					  registers near the block's own
+************************************************************************************/
+static IMG_VOID BuildFlowGraph(HV_GRAPH *psGraph, IMG_UINT32 uNumBlocks, IMG_UINT32 uNumRegisters)
+{
+	IMG_PUINT32 puStack, puNextSucc;
+	IMG_PBOOL pbVisited;
+	IMG_UINT32 uBlock, uInst, uSucc, uDepth, uNumPost;
+
+	psGraph->uNumBlocks = uNumBlocks;
+	psGraph->uNumRegisters = uNumRegisters;
+	psGraph->psBlocks = calloc(uNumBlocks, sizeof(HV_BLOCK));
+	psGraph->puPostorder = malloc(uNumBlocks * sizeof(IMG_UINT32));
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+		IMG_UINT32 uBase = (IMG_UINT32)(((IMG_UINT64)uBlock * uNumRegisters) / uNumBlocks);
+
+		for (uInst = 0; uInst < HV_INSTS_PER_BLOCK; uInst++)
+		{
+			HV_INST *psInst = &psBlock->asInsts[uInst];
+
+			/* A few registers live across the whole shader, as uniforms loaded once do */
+			if (Random(16) == 0)
+			{
+				psInst->uRegister = Random(16);
+			}
+			else
+			{
+				psInst->uRegister = (uBase + Random(HV_REGISTER_WINDOW)) % uNumRegisters;
+			}
+
+			psInst->uDefMask = Random(2) ? Random(16) : 0;
+			psInst->uUseMask = Random(2) ? Random(16) : 0;
+		}
+
+		if (uBlock + 1 < uNumBlocks)
+		{
+			psBlock->auSuccs[psBlock->uNumSuccs++] = uBlock + 1;
+
+			if (Random(4) == 0)
+			{
+				/* Mostly short loops and skips, as structured control flow gives */
+				IMG_UINT32 uTarget = (Random(2) ? uBlock + 2 + Random(8) : uBlock - Random(8 < uBlock ? 8 : uBlock + 1));
+
+				if (uTarget < uNumBlocks && uTarget != uBlock + 1)
+				{
+					psBlock->auSuccs[psBlock->uNumSuccs++] = uTarget;
+				}
+			}
+		}
+	}
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		for (uSucc = 0; uSucc < psGraph->psBlocks[uBlock].uNumSuccs; uSucc++)
+		{
+			psGraph->psBlocks[psGraph->psBlocks[uBlock].auSuccs[uSucc]].uNumPreds++;
+		}
+	}
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		psGraph->psBlocks[uBlock].puPreds = malloc((psGraph->psBlocks[uBlock].uNumPreds + 1) * sizeof(IMG_UINT32));
+		psGraph->psBlocks[uBlock].uNumPreds = 0;
+	}
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		for (uSucc = 0; uSucc < psGraph->psBlocks[uBlock].uNumSuccs; uSucc++)
+		{
+			HV_BLOCK *psSucc = &psGraph->psBlocks[psGraph->psBlocks[uBlock].auSuccs[uSucc]];
+
+			psSucc->puPreds[psSucc->uNumPreds++] = uBlock;
+		}
+	}
+
+	/* Postorder by an iterative depth first search from the entry */
+	puStack = malloc(uNumBlocks * sizeof(IMG_UINT32));
+	puNextSucc = calloc(uNumBlocks, sizeof(IMG_UINT32));
+	pbVisited = calloc(uNumBlocks, sizeof(IMG_BOOL));
+
+	uDepth = 0;
+	uNumPost = 0;
+	puStack[uDepth++] = 0;
+	pbVisited[0] = IMG_TRUE;
+
+	while (uDepth > 0)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[puStack[uDepth - 1]];
+
+		if (puNextSucc[puStack[uDepth - 1]] < psBlock->uNumSuccs)
+		{
+			uSucc = psBlock->auSuccs[puNextSucc[puStack[uDepth - 1]]++];
+
+			if (!pbVisited[uSucc])
+			{
+				pbVisited[uSucc] = IMG_TRUE;
+				puStack[uDepth++] = uSucc;
+			}
+		}
+		else
+		{
+			psGraph->puPostorder[uNumPost++] = puStack[--uDepth];
+		}
+	}
+
+	if (uNumPost != uNumBlocks)
+	{
+		Fail("only %u of %u blocks reachable", uNumPost, uNumBlocks);
+	}
+
+	free(puStack);
+	free(puNextSucc);
+	free(pbVisited);
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeFlowGraph
+ Inputs             : psGraph
+ Outputs            : -
+ Returns            : -
+ Description        : -
+************************************************************************************/
+static IMG_VOID FreeFlowGraph(HV_GRAPH *psGraph)
+{
+	IMG_UINT32 uBlock;
+
+	for (uBlock = 0; uBlock < psGraph->uNumBlocks; uBlock++)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+
+		ClearVector(IMG_NULL, &psBlock->sLiveInExtendable);
+		ClearVector(IMG_NULL, &psBlock->sLiveOutExtendable);
+		ClearHVector(IMG_NULL, &psBlock->sLiveInHybrid);
+		ClearHVector(IMG_NULL, &psBlock->sLiveOutHybrid);
+		free(psBlock->puPreds);
+	}
+
+	free(psGraph->psBlocks);
+	free(psGraph->puPostorder);
+}
+
+
+/***********************************************************************************
+ Function Name      : SolveExtendable
+ Inputs             : psGraph
+ Outputs            : psGraph
+ Returns            : -
+ Description        : Backward liveness with USC_VECTORs and a FIFO of blocks
+					  seeded in program order, as DoDataflow worked before
+************************************************************************************/
+static IMG_VOID SolveExtendable(HV_GRAPH *psGraph)
+{
+	IMG_UINT32 uNumBlocks = psGraph->uNumBlocks;
+	IMG_PUINT32 puQueue = malloc(uNumBlocks * sizeof(IMG_UINT32));
+	IMG_PBOOL pbQueued = malloc(uNumBlocks * sizeof(IMG_BOOL));
+	IMG_UINT32 uHead = 0, uCount = 0, uBlock, uSucc, uInst, uPred;
+	USC_VECTOR sNewIn, sCompare;
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+
+		ClearVector(IMG_NULL, &psBlock->sLiveInExtendable);
+		ClearVector(IMG_NULL, &psBlock->sLiveOutExtendable);
+		InitVector(&psBlock->sLiveInExtendable, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+		InitVector(&psBlock->sLiveOutExtendable, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+
+		puQueue[uCount++] = uBlock;
+		pbQueued[uBlock] = IMG_TRUE;
+	}
+
+	InitVector(&sNewIn, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+	InitVector(&sCompare, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+
+	while (uCount > 0)
+	{
+		HV_BLOCK *psBlock;
+
+		uBlock = puQueue[uHead];
+		uHead = (uHead + 1) % uNumBlocks;
+		uCount--;
+		pbQueued[uBlock] = IMG_FALSE;
+		psBlock = &psGraph->psBlocks[uBlock];
+
+		ClearVector(IMG_NULL, &psBlock->sLiveOutExtendable);
+		for (uSucc = 0; uSucc < psBlock->uNumSuccs; uSucc++)
+		{
+			VectorOp(IMG_NULL, USC_VEC_OR, &psBlock->sLiveOutExtendable, &psBlock->sLiveOutExtendable,
+					 &psGraph->psBlocks[psBlock->auSuccs[uSucc]].sLiveInExtendable);
+		}
+
+		VectorCopy(IMG_NULL, &psBlock->sLiveOutExtendable, &sNewIn);
+		for (uInst = HV_INSTS_PER_BLOCK; uInst > 0; uInst--)
+		{
+			HV_INST *psInst = &psBlock->asInsts[uInst - 1];
+			IMG_UINT32 uStart = psInst->uRegister * CHANS_PER_REGISTER;
+
+			VectorAndRange(IMG_NULL, &sNewIn, uStart + CHANS_PER_REGISTER - 1, uStart, ~psInst->uDefMask);
+			VectorOrRange(IMG_NULL, &sNewIn, uStart + CHANS_PER_REGISTER - 1, uStart, psInst->uUseMask);
+		}
+
+		if (VectorOp(IMG_NULL, USC_VEC_EQ, &sCompare, &sNewIn, &psBlock->sLiveInExtendable) == IMG_NULL)
+		{
+			VectorCopy(IMG_NULL, &sNewIn, &psBlock->sLiveInExtendable);
+
+			for (uPred = 0; uPred < psBlock->uNumPreds; uPred++)
+			{
+				IMG_UINT32 uPredBlock = psBlock->puPreds[uPred];
+
+				if (!pbQueued[uPredBlock])
+				{
+					puQueue[(uHead + uCount) % uNumBlocks] = uPredBlock;
+					uCount++;
+					pbQueued[uPredBlock] = IMG_TRUE;
+				}
+			}
+		}
+	}
+
+	ClearVector(IMG_NULL, &sNewIn);
+	ClearVector(IMG_NULL, &sCompare);
+	free(puQueue);
+	free(pbQueued);
+}
+
+
+/***********************************************************************************
+ Function Name      : UpdateHybrid
+ Inputs             : psGraph, uBlock, psNewIn
+ Outputs            : psGraph
+ Returns            : IMG_TRUE if the block's live-in set changed
+ Description        : Recomputes one block's liveness with USC_HVECTORs.
+					  psNewIn is scratch.
+************************************************************************************/
+static IMG_BOOL UpdateHybrid(HV_GRAPH *psGraph, IMG_UINT32 uBlock, USC_PHVECTOR psNewIn)
+{
+	HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+	IMG_UINT32 uSucc, uInst;
+
+	ClearHVector(IMG_NULL, &psBlock->sLiveOutHybrid);
+	for (uSucc = 0; uSucc < psBlock->uNumSuccs; uSucc++)
+	{
+		HVectorUnion(IMG_NULL, &psBlock->sLiveOutHybrid, &psGraph->psBlocks[psBlock->auSuccs[uSucc]].sLiveInHybrid);
+	}
+
+	HVectorCopy(IMG_NULL, &psBlock->sLiveOutHybrid, psNewIn);
+	for (uInst = HV_INSTS_PER_BLOCK; uInst > 0; uInst--)
+	{
+		HV_INST *psInst = &psBlock->asInsts[uInst - 1];
+		IMG_UINT32 uStart = psInst->uRegister * CHANS_PER_REGISTER;
+
+		HVectorAndRange(IMG_NULL, psNewIn, uStart + CHANS_PER_REGISTER - 1, uStart, ~psInst->uDefMask);
+		HVectorOrRange(IMG_NULL, psNewIn, uStart + CHANS_PER_REGISTER - 1, uStart, psInst->uUseMask);
+	}
+
+	if (HVectorEqual(IMG_NULL, psNewIn, &psBlock->sLiveInHybrid))
+	{
+		return IMG_FALSE;
+	}
+
+	HVectorCopy(IMG_NULL, psNewIn, &psBlock->sLiveInHybrid);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : SolveHybrid
+ Inputs             : psGraph, bPostorder
+ Outputs            : psGraph
+ Returns            : -
+ Description        : Backward liveness with USC_HVECTORs. With bPostorder the
+					  blocks needing an update are swept in postorder, as
+					  DoDataflow now does; otherwise they go through the old
+					  FIFO, so the two changes can be timed apart.
+************************************************************************************/
+static IMG_VOID SolveHybrid(HV_GRAPH *psGraph, IMG_BOOL bPostorder)
+{
+	IMG_UINT32 uNumBlocks = psGraph->uNumBlocks;
+	IMG_PUINT32 puQueue = malloc(uNumBlocks * sizeof(IMG_UINT32));
+	IMG_UINT32 uHead = 0, uCount = 0, uBlock, uPred, uIdx;
+	IMG_BOOL bAnyUpdate = IMG_TRUE;
+	USC_HVECTOR sNewIn;
+
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+
+		ClearHVector(IMG_NULL, &psBlock->sLiveInHybrid);
+		ClearHVector(IMG_NULL, &psBlock->sLiveOutHybrid);
+		psBlock->bNeedsUpdate = IMG_TRUE;
+		puQueue[uCount++] = uBlock;
+	}
+
+	InitHVector(&sNewIn);
+
+	if (bPostorder)
+	{
+		while (bAnyUpdate)
+		{
+			bAnyUpdate = IMG_FALSE;
+
+			for (uIdx = 0; uIdx < uNumBlocks; uIdx++)
+			{
+				HV_BLOCK *psBlock;
+
+				uBlock = psGraph->puPostorder[uIdx];
+				psBlock = &psGraph->psBlocks[uBlock];
+
+				if (!psBlock->bNeedsUpdate)
+				{
+					continue;
+				}
+				psBlock->bNeedsUpdate = IMG_FALSE;
+
+				if (UpdateHybrid(psGraph, uBlock, &sNewIn))
+				{
+					for (uPred = 0; uPred < psBlock->uNumPreds; uPred++)
+					{
+						psGraph->psBlocks[psBlock->puPreds[uPred]].bNeedsUpdate = IMG_TRUE;
+					}
+					bAnyUpdate = IMG_TRUE;
+				}
+			}
+		}
+	}
+	else
+	{
+		while (uCount > 0)
+		{
+			HV_BLOCK *psBlock;
+
+			uBlock = puQueue[uHead];
+			uHead = (uHead + 1) % uNumBlocks;
+			uCount--;
+			psBlock = &psGraph->psBlocks[uBlock];
+			psBlock->bNeedsUpdate = IMG_FALSE;
+
+			if (UpdateHybrid(psGraph, uBlock, &sNewIn))
+			{
+				for (uPred = 0; uPred < psBlock->uNumPreds; uPred++)
+				{
+					IMG_UINT32 uPredBlock = psBlock->puPreds[uPred];
+
+					if (!psGraph->psBlocks[uPredBlock].bNeedsUpdate)
+					{
+						puQueue[(uHead + uCount) % uNumBlocks] = uPredBlock;
+						uCount++;
+						psGraph->psBlocks[uPredBlock].bNeedsUpdate = IMG_TRUE;
+					}
+				}
+			}
+		}
+	}
+
+	ClearHVector(IMG_NULL, &sNewIn);
+	free(puQueue);
+}
+
+
+/***********************************************************************************
+ Function Name      : CompareLiveness
+ Inputs             : psGraph, uGraph
+ Outputs            : -
+ Returns            : -
+ Description        : Checks both solutions agree for every block
+************************************************************************************/
+static IMG_VOID CompareLiveness(HV_GRAPH *psGraph, IMG_UINT32 uGraph)
+{
+	IMG_UINT32 uBlock, uWord, uNumWords = (psGraph->uNumRegisters * CHANS_PER_REGISTER + BITS_PER_UINT - 1) / BITS_PER_UINT;
+
+	for (uBlock = 0; uBlock < psGraph->uNumBlocks; uBlock++)
+	{
+		HV_BLOCK *psBlock = &psGraph->psBlocks[uBlock];
+
+		for (uWord = 0; uWord < uNumWords + 1; uWord++)
+		{
+			IMG_UINT32 uEnd = uWord * BITS_PER_UINT + BITS_PER_UINT - 1, uStart = uWord * BITS_PER_UINT;
+
+			if (HVectorGetRange(IMG_NULL, &psBlock->sLiveInHybrid, uEnd, uStart) !=
+				VectorGetRange(IMG_NULL, &psBlock->sLiveInExtendable, uEnd, uStart) ||
+				HVectorGetRange(IMG_NULL, &psBlock->sLiveOutHybrid, uEnd, uStart) !=
+				VectorGetRange(IMG_NULL, &psBlock->sLiveOutExtendable, uEnd, uStart))
+			{
+				Fail("graph %u block %u: liveness differs at bits %u-%u", uGraph, uBlock, uStart, uEnd);
+				return;
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeSolve
+ Inputs             : psGraph, pfnSolve, bPostorder, uReps
+ Outputs            : -
+ Returns            : Milliseconds per solution
+ Description        : Times uReps solutions of one liveness solver
+************************************************************************************/
+static double TimeSolve(HV_GRAPH *psGraph, IMG_VOID (*pfnSolve)(HV_GRAPH *, IMG_BOOL), IMG_BOOL bPostorder, IMG_UINT32 uReps)
+{
+	IMG_UINT32 uRep;
+	double fStart = GetSeconds();
+
+	for (uRep = 0; uRep < uReps; uRep++)
+	{
+		pfnSolve(psGraph, bPostorder);
+	}
+
+	return (GetSeconds() - fStart) * 1000.0 / uReps;
+}
+
+
+/***********************************************************************************
+ Function Name      : SolveExtendableFIFO
+ Inputs             : psGraph, bPostorder
+ Outputs            : psGraph
+ Returns            : -
+ Description        : SolveExtendable with the signature TimeSolve takes
+************************************************************************************/
+static IMG_VOID SolveExtendableFIFO(HV_GRAPH *psGraph, IMG_BOOL bPostorder)
+{
+	PVR_UNREFERENCED_PARAMETER(bPostorder);
+
+	SolveExtendable(psGraph);
+}
+
+
+/***********************************************************************************
+ Function Name      : RunLiveness
+ Inputs             : uGraph, uNumBlocks, uNumRegisters, uReps
+ Outputs            : -
+ Returns            : -
+ Description        : Solves liveness on one random graph with USC_VECTORs and
+					  both USC_HVECTOR visit orders, compares the results and
+					  times uReps solutions of each
+************************************************************************************/
+static IMG_VOID RunLiveness(IMG_UINT32 uGraph, IMG_UINT32 uNumBlocks, IMG_UINT32 uNumRegisters, IMG_UINT32 uReps)
+{
+	HV_GRAPH sGraph;
+	IMG_UINT32 uBlock, uDense = 0;
+	double fExtendable, fHybridFIFO, fHybrid;
+
+	BuildFlowGraph(&sGraph, uNumBlocks, uNumRegisters);
+
+	SolveExtendable(&sGraph);
+	SolveHybrid(&sGraph, IMG_FALSE);
+	CompareLiveness(&sGraph, uGraph);
+	SolveHybrid(&sGraph, IMG_TRUE);
+	CompareLiveness(&sGraph, uGraph);
+
+	if (uReps)
+	{
+		fExtendable = TimeSolve(&sGraph, SolveExtendableFIFO, IMG_FALSE, uReps);
+		fHybridFIFO = TimeSolve(&sGraph, SolveHybrid, IMG_FALSE, uReps);
+		fHybrid = TimeSolve(&sGraph, SolveHybrid, IMG_TRUE, uReps);
+
+		for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+		{
+			uDense += sGraph.psBlocks[uBlock].sLiveInHybrid.bDense ? 1 : 0;
+		}
+
+		printf("%5u blocks %6u registers: USC_VECTOR FIFO %9.3f ms, USC_HVECTOR FIFO %8.3f ms, "
+			   "USC_HVECTOR postorder %8.3f ms, %u dense live-in sets\n",
+			   uNumBlocks, uNumRegisters, fExtendable, fHybridFIFO, fHybrid, uDense);
+	}
+
+	FreeFlowGraph(&sGraph);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 uRuns = HV_DEFAULT_RUNS, uSteps = HV_DEFAULT_STEPS, uNumBlocks = HV_DEFAULT_BLOCKS;
+	IMG_UINT32 uNumRegisters = HV_DEFAULT_REGISTERS, uReps = HV_DEFAULT_REPS, uSeed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			uRuns = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			uSteps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-blocks=", strlen("-blocks=")) == 0)
+		{
+			uNumBlocks = strtoul(argv[1] + strlen("-blocks="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-registers=", strlen("-registers=")) == 0)
+		{
+			uNumRegisters = strtoul(argv[1] + strlen("-registers="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-reps=", strlen("-reps=")) == 0)
+		{
+			uReps = strtoul(argv[1] + strlen("-reps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			uSeed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: hvector [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	if (uNumBlocks < 1 || uNumRegisters < 16)
+	{
+		fprintf(stderr, "error: graphs need at least 1 block and 16 registers\n");
+		return 1;
+	}
+
+	g_uRandom = uSeed ? uSeed : 1;
+
+	for (i = 0; i < uRuns && !g_uNumErrors; i++)
+	{
+		RunSequence(i, uSteps);
+	}
+
+	printf("%u operation sequences of %u steps\n", i, uSteps);
+
+	/* The requested graph, then smaller and larger ones to show how the gap scales */
+	RunLiveness(0, uNumBlocks, uNumRegisters, uReps);
+	RunLiveness(1, uNumBlocks / 4 + 1, uNumRegisters / 4 + 16, uReps);
+	RunLiveness(2, uNumBlocks * 2, uNumRegisters * 2, uReps / 4 + (uReps ? 1 : 0));
+
+	for (i = 0; i < 16 && !g_uNumErrors; i++)
+	{
+		RunLiveness(3 + i, 1 + Random(uNumBlocks), 16 + Random(uNumRegisters), 0);
+	}
+
+	if (g_uLiveAllocs)
+	{
+		Fail("%u compiler allocations not freed", g_uLiveAllocs);
+	}
+
+	printf("%s\n", g_uNumErrors ? "FAILED" : "PASSED");
+
+	return g_uNumErrors ? 1 : 0;
+}
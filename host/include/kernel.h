@@ -0,0 +1,34 @@
+/******************************************************************************
+ * Name         : kernel.h
+ * Title        : Host stand-in for the platform kernel header
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : psp2_pvr_defs.h includes the platform kernel header. Host
+ *                test harnesses that build driver sources search this
+ *                directory for it instead. It declares only what those
+ *                sources use, and each harness supplies the definitions.
+ *
+ * Modifications:-
+ * $Log: kernel.h $
+ *****************************************************************************/
+
+#ifndef _HOST_KERNEL_H_
+#define _HOST_KERNEL_H_
+
+#define SCE_OK	0
+
+typedef int SceUID;
+
+void *sceKernelGetTLSAddr(int key);
+
+#endif /* _HOST_KERNEL_H_ */
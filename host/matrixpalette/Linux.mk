@@ -0,0 +1,40 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test and benchmark of the GLES1 matrix palette constants. It builds
+# matrix.c, checks the batched kernels and the cached palette constants bit
+# for bit against the per-matrix paths they replaced, and times both. It
+# exits non-zero if any result differs.
+#
+
+modules := matrixpalette
+
+matrixpalette_type := host_executable
+
+matrixpalette_extlibs := m
+
+matrixpalette_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles1/matrix.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header. Assertions stay on without a debug build.
+matrixpalette_cflags := \
+ -DLINUX -DUSER -DPVRSRV_NEED_PVR_ASSERT \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/matrixpalette/hostcontext.h
+
+matrixpalette_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles1 \
+ intermediates/sgxsupport
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES1 context for the matrix palette test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of matrix.c in place of the driver's
+ *                context.h, whose include guard it defines. The transform
+ *                machine and procs tables are the driver's own xform.h and
+ *                tnlstate.h. The context keeps only the state matrix.c
+ *                touches, and the current context and error hook come
+ *                from the harness.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "imgextensions.h"
+
+#include "services.h"
+#include "pvr_debug.h"
+
+#include "ogles_types.h"
+
+#include "drvgl.h"
+#include "drvglext.h"
+
+#include "constants.h"
+
+/* As bufobj.h; the attrib array state only holds a pointer to one */
+typedef struct GLESBufferObjectRec GLESBufferObject;
+
+#include "tnlstate.h"
+
+/* The NE10 headers are only used by the __psp2__ paths and need arm_neon.h */
+#define _PSP2_NE10GLES_
+#define NE10_SETC_H
+
+#define GLES1_ASSERT(n) PVR_ASSERT(n)
+
+#define MIN(a,b) ((a)<(b)?(a):(b))
+#define MAX(a,b) ((a)>(b)?(a):(b))
+
+#define GLES1Calloc(X,Y)		(IMG_VOID*)calloc(1, Y)
+#define GLES1Free(X,Y)			free(Y)
+#define GLES1MemCopy(X,Y,Z)		memcpy(X, Y, Z)
+
+#define GLES1_TIME_START(X)
+#define GLES1_TIME_STOP(X)
+
+/* As context.h */
+#define GLES1_TL_RESCALE				9
+#define GLES1_TL_RESCALE_ENABLE			(1UL << GLES1_TL_RESCALE)
+
+#define __GLES1_GET_CONTEXT() \
+	GLES1Context *gc = HostGetContext(); \
+	if(!gc) return
+
+/* As validate.h */
+#define GLES1_DIRTYFLAG_VERTPROG_CONSTANTS		0x00000008UL
+#define GLES1_DIRTYFLAG_VERTEX_PROGRAM			0x00000100UL
+
+/* As misc.h */
+#define SetError(gc, code) SetErrorFileLine(gc, code, __FILE__, __LINE__)
+
+
+/* As state.h */
+typedef struct GLESViewportRec
+{
+	IMG_FLOAT fZNear, fZFar;
+	IMG_FLOAT fZCenter, fZScale;
+
+	GLEScoord sFrontBackClip[2];
+
+} GLESViewport;
+
+typedef struct GLESTextureStateRec
+{
+	IMG_UINT32 ui32ActiveTexture;
+
+} GLESTextureState;
+
+typedef struct GLESStateRec
+{
+	GLenum eMatrixMode;
+
+	GLESCurrentState sCurrent;
+	GLESTextureState sTexture;
+	GLESViewport sViewport;
+
+} GLESState;
+
+/* As validate.h */
+typedef struct GLESPrimitiveMachine_TAG
+{
+	IMG_UINT32 ui32MaxMatrixPaletteIndex;
+
+} GLESPrimitiveMachine;
+
+
+struct GLES1Context_TAG
+{
+	GLESState sState;
+	GLESPrimitiveMachine sPrim;
+	GLESProcs sProcs;
+	GLES1TransformMachine sTransform;
+
+	IMG_UINT32 ui32DirtyMask;
+	IMG_UINT32 ui32TnLEnables;
+};
+
+
+/* Supplied by the harness */
+GLES1Context *HostGetContext(IMG_VOID);
+IMG_VOID SetErrorFileLine(GLES1Context *gc, GLenum code, const IMG_CHAR *szFile, int iLine);
+
+#endif /* _CONTEXT_ */
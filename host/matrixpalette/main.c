@@ -0,0 +1,801 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLES1 matrix palette constant test and benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's matrix.c against a cut down context.
+ *
+ *                The first part runs the batched kernels, TransposeMatrices
+ *                and InvertTransposeMatrices, over random batches of
+ *                general, affine, 2D, identity and singular matrices, and
+ *                fails unless every result matches TransposeMatrix and
+ *                InvertTransposeMatrix applied one matrix at a time, bit
+ *                for bit.
+ *
+ *                The second part drives the palette through random
+ *                sequences of matrix mode and index changes, loads,
+ *                multiplies, scales, translates, identities, loads from
+ *                the modelview and GL_RESCALE_NORMAL toggles, with random
+ *                draws in between. At each draw the cached constants from
+ *                GetPaletteMatrixConstants and
+ *                GetPaletteInverseTransposeConstants must match, bit for
+ *                bit, what the per-matrix loop they replaced in
+ *                fftnlgles.c builds from the same state. So must the
+ *                rescale factors.
+ *
+ *                Afterwards both ways of building the constants are timed
+ *                for skinned draws that change none, some or all of the
+ *                palette between draws.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "hostcontext.h"
+
+
+#define MP_MATRIX_FLOATS			16
+#define MP_MAX_BATCH				(GLES1_MAX_PALETTE_MATRICES * 2 + 1)
+#define MP_DEFAULT_RUNS				200
+#define MP_DEFAULT_STEPS			400
+#define MP_DEFAULT_DRAWS			20000
+
+/* Ready-made matrices the benchmark loads into the palette */
+#define MP_BENCH_MATRICES			256
+
+static GLES1Context g_sContext;
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+static IMG_UINT32 g_ui32NumDraws;
+
+/* Keeps the timed loops from being optimised away */
+static volatile IMG_FLOAT g_fSink;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random palette sequences (default 200).\n"
+"-steps=N    Operations per sequence (default 400).\n"
+"-draws=N    Draws timed per case (default 20000). 0 skips the timing.\n"
+"-seed=N     Seed for the matrices and sequences (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : RandomFloat
+ Inputs             : -
+ Outputs            : -
+ Returns            : Pseudo-random float in [-4, 4]
+ Description        : Matrix element generator
+************************************************************************************/
+static IMG_FLOAT RandomFloat(IMG_VOID)
+{
+	return ((IMG_FLOAT)Random(2001) - 1000.0f) / 250.0f;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/*
+** Services and driver mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+GLES1Context *HostGetContext(IMG_VOID)
+{
+	return &g_sContext;
+}
+
+IMG_VOID SetErrorFileLine(GLES1Context *gc, GLenum code, const IMG_CHAR *szFile, int iLine)
+{
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	Fail("unexpected GL error 0x%x at %s:%d", code, szFile, iLine);
+}
+
+
+/***********************************************************************************
+ Function Name      : InitContext
+ Inputs             : gc
+ Outputs            : gc
+ Returns            : -
+ Description        : Sets up the matrix procs as SetupTransformLightingProcs does,
+					  then the transform state
+************************************************************************************/
+static IMG_VOID InitContext(GLES1Context *gc)
+{
+	memset(gc, 0, sizeof(*gc));
+
+	gc->sProcs.sMatrixProcs.pfnCopy                = CopyMatrix;
+	gc->sProcs.sMatrixProcs.pfnInvertTranspose     = InvertTransposeMatrix;
+	gc->sProcs.sMatrixProcs.pfnMakeIdentity        = MakeIdentity;
+	gc->sProcs.sMatrixProcs.pfnMult                = MultMatrix;
+	gc->sProcs.sMatrixProcs.pfnTransposeMany       = TransposeMatrices;
+	gc->sProcs.sMatrixProcs.pfnInvertTransposeMany = InvertTransposeMatrices;
+
+	gc->sProcs.pfnPushMatrix              = PushModelViewMatrix;
+	gc->sProcs.pfnPopMatrix               = PopModelViewMatrix;
+	gc->sProcs.pfnLoadIdentity            = LoadIdentityModelViewMatrix;
+	gc->sProcs.pfnPickMatrixProcs         = PickMatrixProcs;
+	gc->sProcs.pfnPickInvTransposeProcs   = PickInvTransposeProcs;
+	gc->sProcs.pfnComputeInverseTranspose = ComputeInverseTranspose;
+
+	if (!InitTransformState(gc))
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : SetMatrixMode
+ Inputs             : gc, eMode
+ Outputs            : -
+ Returns            : -
+ Description        : As glMatrixMode, for the state matrix.c uses
+************************************************************************************/
+static IMG_VOID SetMatrixMode(GLES1Context *gc, GLenum eMode)
+{
+	gc->sState.eMatrixMode = eMode;
+
+	switch (eMode)
+	{
+		case GL_MODELVIEW:
+		{
+			gc->sProcs.pfnLoadIdentity = LoadIdentityModelViewMatrix;
+
+			break;
+		}
+		case GL_PROJECTION:
+		{
+			gc->sProcs.pfnLoadIdentity = LoadIdentityProjectionMatrix;
+
+			break;
+		}
+		case GL_TEXTURE:
+		{
+			gc->sProcs.pfnLoadIdentity = LoadIdentityTextureMatrix;
+
+			break;
+		}
+		case GL_MATRIX_PALETTE_OES:
+		{
+			gc->sProcs.pfnLoadIdentity = LoadIdentityMatrixPaletteMatrix;
+
+			break;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : RandomMatrix
+ Inputs             : -
+ Outputs            : psMatrix
+ Returns            : -
+ Description        : Fills a matrix with one of: general, affine (the usual
+					  skinning bone), 2D, identity or singular
+************************************************************************************/
+static IMG_VOID RandomMatrix(GLESMatrix *psMatrix)
+{
+	IMG_UINT32 ui32Row, ui32Col, ui32Kind = Random(8);
+
+	for (ui32Row = 0; ui32Row < 4; ui32Row++)
+	{
+		for (ui32Col = 0; ui32Col < 4; ui32Col++)
+		{
+			psMatrix->afMatrix[ui32Row][ui32Col] = RandomFloat();
+		}
+	}
+
+	switch (ui32Kind)
+	{
+		case 0:
+		case 1:
+		{
+			/* General */
+			break;
+		}
+		case 2:
+		{
+			/* 2D: z and w pass through */
+			psMatrix->afMatrix[0][2] = psMatrix->afMatrix[1][2] = psMatrix->afMatrix[3][2] = 0.0f;
+			psMatrix->afMatrix[2][0] = psMatrix->afMatrix[2][1] = psMatrix->afMatrix[2][3] = 0.0f;
+			psMatrix->afMatrix[2][2] = 1.0f;
+		}
+		/* fall through */
+		case 3:
+		case 4:
+		case 5:
+		{
+			/* Affine */
+			psMatrix->afMatrix[0][3] = psMatrix->afMatrix[1][3] = psMatrix->afMatrix[2][3] = 0.0f;
+			psMatrix->afMatrix[3][3] = 1.0f;
+
+			break;
+		}
+		case 6:
+		{
+			MakeIdentity(psMatrix);
+
+			break;
+		}
+		case 7:
+		{
+			/* Singular: a repeated row, or a zero column */
+			if (Random(2))
+			{
+				memcpy(psMatrix->afMatrix[Random(4)], psMatrix->afMatrix[Random(4)], sizeof(psMatrix->afMatrix[0]));
+				memcpy(psMatrix->afMatrix[1], psMatrix->afMatrix[0], sizeof(psMatrix->afMatrix[0]));
+			}
+			else
+			{
+				ui32Col = Random(4);
+
+				for (ui32Row = 0; ui32Row < 4; ui32Row++)
+				{
+					psMatrix->afMatrix[ui32Row][ui32Col] = 0.0f;
+				}
+			}
+
+			break;
+		}
+	}
+
+	psMatrix->eMatrixType = GLES1_MT_GENERAL;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckKernels
+ Inputs             : ui32Count
+ Outputs            : -
+ Returns            : -
+ Description        : Runs both batched kernels over ui32Count random matrices and
+					  compares them with the single matrix functions
+************************************************************************************/
+static IMG_VOID CheckKernels(IMG_UINT32 ui32Count)
+{
+	static GLESMatrix asSrc[MP_MAX_BATCH], asInverse[MP_MAX_BATCH], asExpected[MP_MAX_BATCH];
+	static IMG_FLOAT afPacked[MP_MAX_BATCH * MP_MATRIX_FLOATS + 1];
+	const GLESMatrix *apsSrc[MP_MAX_BATCH];
+	GLESMatrix *apsInverse[MP_MAX_BATCH];
+	GLESMatrix sTranspose;
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		RandomMatrix(&asSrc[i]);
+
+		/* The palette keeps the types PickMatrixProcs works out */
+		PickMatrixProcs(&g_sContext, &asSrc[i]);
+
+		apsSrc[i] = &asSrc[i];
+		apsInverse[i] = &asInverse[i];
+
+		InvertTransposeMatrix(&asExpected[i], &asSrc[i]);
+	}
+
+	/* One float past the batch must survive */
+	afPacked[ui32Count * MP_MATRIX_FLOATS] = 12345.0f;
+
+	TransposeMatrices(afPacked, apsSrc, ui32Count);
+	InvertTransposeMatrices(apsInverse, apsSrc, ui32Count);
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		TransposeMatrix(&sTranspose, &asSrc[i]);
+
+		if (memcmp(&afPacked[i * MP_MATRIX_FLOATS], sTranspose.afMatrix, sizeof(sTranspose.afMatrix)) != 0)
+		{
+			Fail("batch of %u: transpose %u differs from TransposeMatrix", ui32Count, i);
+		}
+
+		if (memcmp(asInverse[i].afMatrix, asExpected[i].afMatrix, sizeof(asExpected[i].afMatrix)) != 0 ||
+			asInverse[i].eMatrixType != asExpected[i].eMatrixType)
+		{
+			Fail("batch of %u: inverse transpose %u differs from InvertTransposeMatrix", ui32Count, i);
+		}
+	}
+
+	if (afPacked[ui32Count * MP_MATRIX_FLOATS] != 12345.0f)
+	{
+		Fail("batch of %u: TransposeMatrices wrote past the batch", ui32Count);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : LoadMatrix
+ Inputs             : gc, psMatrix
+ Outputs            : -
+ Returns            : -
+ Description        : As glLoadMatrixf: writes the current matrix, then lets
+					  DoLoadMatrix update its state
+************************************************************************************/
+static IMG_VOID LoadMatrix(GLES1Context *gc, const GLESMatrix *psMatrix)
+{
+	GLES1Transform *psTransform;
+
+	switch (gc->sState.eMatrixMode)
+	{
+		case GL_MODELVIEW:
+		default:
+		{
+			psTransform = gc->sTransform.psModelView;
+
+			break;
+		}
+		case GL_PROJECTION:
+		{
+			psTransform = gc->sTransform.psProjection;
+
+			break;
+		}
+		case GL_TEXTURE:
+		{
+			psTransform = gc->sTransform.apsTexture[gc->sState.sTexture.ui32ActiveTexture];
+
+			break;
+		}
+		case GL_MATRIX_PALETTE_OES:
+		{
+			psTransform = &gc->sTransform.psMatrixPalette[gc->sState.sCurrent.ui32MatrixPaletteIndex];
+
+			break;
+		}
+	}
+
+	memcpy(psTransform->sMatrix.afMatrix, psMatrix->afMatrix, sizeof(psMatrix->afMatrix));
+	psTransform->sMatrix.eMatrixType = GLES1_MT_GENERAL;
+
+	DoLoadMatrix(gc, &psTransform->sMatrix);
+}
+
+
+/***********************************************************************************
+ Function Name      : OldPaletteConstants
+ Inputs             : gc, ui32NumMatrices
+ Outputs            : pfPalette, pfInverse
+ Returns            : -
+ Description        : The per-matrix loops SetupBuildFFTNLShaderConstants used for
+					  FFGEN_STATE_MODELVIEWMATRIXPALETTE and
+					  FFGEN_STATE_MODELVIEWMATRIXINVERSETRANSPOSEPALETTE. Either
+					  output may be NULL.
+************************************************************************************/
+static IMG_VOID OldPaletteConstants(GLES1Context *gc, IMG_UINT32 ui32NumMatrices,
+									IMG_FLOAT *pfPalette, IMG_FLOAT *pfInverse)
+{
+	GLESMatrix sTempMatrix;
+	IMG_UINT32 i;
+
+	if (pfPalette)
+	{
+		for (i = 0; i < ui32NumMatrices; i++)
+		{
+			TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sMatrix);
+
+			memcpy(&pfPalette[i * MP_MATRIX_FLOATS], sTempMatrix.afMatrix, sizeof(sTempMatrix.afMatrix));
+		}
+	}
+
+	if (pfInverse)
+	{
+		for (i = 0; i < ui32NumMatrices; i++)
+		{
+			if (gc->sTransform.psMatrixPalette[i].bUpdateInverse)
+			{
+				(*gc->sProcs.pfnComputeInverseTranspose)(gc, &gc->sTransform.psMatrixPalette[i]);
+			}
+
+			TransposeMatrix(&sTempMatrix, &gc->sTransform.psMatrixPalette[i].sInverseTranspose);
+
+			memcpy(&pfInverse[i * MP_MATRIX_FLOATS], sTempMatrix.afMatrix, sizeof(sTempMatrix.afMatrix));
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckDraw
+ Inputs             : gc, pszName
+ Outputs            : -
+ Returns            : -
+ Description        : A draw with a random palette size. The old loops run on a
+					  copy of the palette taken first, and the cached constants
+					  and rescale factors must match them exactly.
+************************************************************************************/
+static IMG_VOID CheckDraw(GLES1Context *gc, const IMG_CHAR *pszName)
+{
+	static GLES1Transform asSaved[GLES1_MAX_PALETTE_MATRICES], asExpected[GLES1_MAX_PALETTE_MATRICES];
+	static IMG_FLOAT afPalette[GLES1_MAX_PALETTE_MATRICES * MP_MATRIX_FLOATS];
+	static IMG_FLOAT afInverse[GLES1_MAX_PALETTE_MATRICES * MP_MATRIX_FLOATS];
+	IMG_UINT32 ui32NumMatrices = 1 + Random(GLES1_MAX_PALETTE_MATRICES);
+	IMG_UINT32 ui32Which = 1 + Random(3);
+	IMG_BOOL bPalette = (ui32Which & 1) ? IMG_TRUE : IMG_FALSE;
+	IMG_BOOL bInverse = (ui32Which & 2) ? IMG_TRUE : IMG_FALSE;
+	const IMG_FLOAT *pfConstants;
+	IMG_UINT32 i;
+
+	g_ui32NumDraws++;
+
+	/* Expected results, leaving the palette as it was */
+	memcpy(asSaved, gc->sTransform.psMatrixPalette, sizeof(asSaved));
+
+	OldPaletteConstants(gc, ui32NumMatrices, bPalette ? afPalette : IMG_NULL, bInverse ? afInverse : IMG_NULL);
+
+	memcpy(asExpected, gc->sTransform.psMatrixPalette, sizeof(asExpected));
+	memcpy(gc->sTransform.psMatrixPalette, asSaved, sizeof(asSaved));
+
+	if (bPalette)
+	{
+		pfConstants = GetPaletteMatrixConstants(gc, ui32NumMatrices);
+
+		for (i = 0; i < ui32NumMatrices; i++)
+		{
+			if (memcmp(&pfConstants[i * MP_MATRIX_FLOATS], &afPalette[i * MP_MATRIX_FLOATS],
+					   MP_MATRIX_FLOATS * sizeof(IMG_FLOAT)) != 0)
+			{
+				Fail("%s: palette matrix %u of %u is stale", pszName, i, ui32NumMatrices);
+			}
+		}
+	}
+
+	if (bInverse)
+	{
+		pfConstants = GetPaletteInverseTransposeConstants(gc, ui32NumMatrices);
+
+		for (i = 0; i < ui32NumMatrices; i++)
+		{
+			GLES1Transform *psPalette = &gc->sTransform.psMatrixPalette[i];
+
+			if (memcmp(&pfConstants[i * MP_MATRIX_FLOATS], &afInverse[i * MP_MATRIX_FLOATS],
+					   MP_MATRIX_FLOATS * sizeof(IMG_FLOAT)) != 0)
+			{
+				Fail("%s: palette inverse transpose %u of %u is stale", pszName, i, ui32NumMatrices);
+			}
+
+			if (psPalette->bUpdateInverse ||
+				memcmp(&psPalette->sInverseTranspose, &asExpected[i].sInverseTranspose, sizeof(GLESMatrix)) != 0 ||
+				memcmp(&psPalette->fRescaleFactor, &asExpected[i].fRescaleFactor, sizeof(IMG_FLOAT)) != 0)
+			{
+				Fail("%s: palette entry %u of %u differs from ComputeInverseTranspose", pszName, i, ui32NumMatrices);
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : RunSequence
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : One random sequence of matrix calls and draws on a fresh
+					  context
+************************************************************************************/
+static IMG_VOID RunSequence(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	static const GLenum aeModes[] = {GL_MATRIX_PALETTE_OES, GL_MATRIX_PALETTE_OES, GL_MATRIX_PALETTE_OES,
+									 GL_MODELVIEW, GL_MODELVIEW, GL_PROJECTION, GL_TEXTURE};
+	GLES1Context *gc = &g_sContext;
+	IMG_UINT32 ui32Step;
+	IMG_CHAR acName[64];
+
+	InitContext(gc);
+
+	SetMatrixMode(gc, GL_MATRIX_PALETTE_OES);
+
+	for (ui32Step = 0; ui32Step < ui32Steps && !g_ui32NumErrors; ui32Step++)
+	{
+		IMG_UINT32 ui32Op = Random(100);
+		GLESMatrix sMatrix;
+		IMG_FLOAT afVector[3];
+
+		sprintf(acName, "run %u step %u op %u", ui32Run, ui32Step, ui32Op);
+
+		if (ui32Op < 8)
+		{
+			glCurrentPaletteMatrixOES(Random(GLES1_MAX_PALETTE_MATRICES));
+		}
+		else if (ui32Op < 14)
+		{
+			SetMatrixMode(gc, aeModes[Random(sizeof(aeModes) / sizeof(aeModes[0]))]);
+		}
+		else if (ui32Op < 32)
+		{
+			RandomMatrix(&sMatrix);
+			LoadMatrix(gc, &sMatrix);
+		}
+		else if (ui32Op < 42)
+		{
+			RandomMatrix(&sMatrix);
+			DoMultMatrix(gc, &sMatrix, MultiplyMatrix);
+		}
+		else if (ui32Op < 47)
+		{
+			afVector[0] = RandomFloat();
+			afVector[1] = RandomFloat();
+			afVector[2] = RandomFloat();
+			DoMultMatrix(gc, afVector, ScaleMatrix);
+		}
+		else if (ui32Op < 52)
+		{
+			afVector[0] = RandomFloat();
+			afVector[1] = RandomFloat();
+			afVector[2] = RandomFloat();
+			DoMultMatrix(gc, afVector, TranslateMatrix);
+		}
+		else if (ui32Op < 58)
+		{
+			(*gc->sProcs.pfnLoadIdentity)(gc);
+		}
+		else if (ui32Op < 66)
+		{
+			glLoadPaletteFromModelViewMatrixOES();
+		}
+		else if (ui32Op < 69)
+		{
+			gc->ui32TnLEnables ^= GLES1_TL_RESCALE_ENABLE;
+		}
+		else if (ui32Op < 72)
+		{
+			/* As lighting validation, so the modelview carries a fresh inverse into the palette */
+			if (gc->sTransform.psModelView->bUpdateInverse)
+			{
+				(*gc->sProcs.pfnComputeInverseTranspose)(gc, gc->sTransform.psModelView);
+			}
+		}
+		else
+		{
+			CheckDraw(gc, acName);
+		}
+	}
+
+	FreeTransformState(gc);
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeDraws
+ Inputs             : ui32NumMatrices, ui32Changed, ui32Draws, psMatrices
+ Outputs            : -
+ Returns            : -
+ Description        : Times skinned draws of ui32NumMatrices bones that reload
+					  ui32Changed of them before each draw, building both the
+					  palette and inverse transpose constants the old way and
+					  the cached way
+************************************************************************************/
+static IMG_VOID TimeDraws(IMG_UINT32 ui32NumMatrices, IMG_UINT32 ui32Changed, IMG_UINT32 ui32Draws,
+						  const GLESMatrix *psMatrices)
+{
+	static IMG_FLOAT afPalette[GLES1_MAX_PALETTE_MATRICES * MP_MATRIX_FLOATS];
+	static IMG_FLOAT afInverse[GLES1_MAX_PALETTE_MATRICES * MP_MATRIX_FLOATS];
+	GLES1Context *gc = &g_sContext;
+	IMG_UINT32 ui32Draw, i, ui32Next, ui32Pass;
+	double afTime[2];
+
+	for (ui32Pass = 0; ui32Pass < 2; ui32Pass++)
+	{
+		double fStart;
+
+		InitContext(gc);
+		SetMatrixMode(gc, GL_MATRIX_PALETTE_OES);
+
+		ui32Next = 0;
+		fStart = GetSeconds();
+
+		for (ui32Draw = 0; ui32Draw < ui32Draws; ui32Draw++)
+		{
+			const IMG_FLOAT *pfPalette, *pfInverse;
+
+			/* The animation updates the first bones in turn */
+			for (i = 0; i < ui32Changed; i++)
+			{
+				glCurrentPaletteMatrixOES((ui32Draw * ui32Changed + i) % ui32NumMatrices);
+				LoadMatrix(gc, &psMatrices[ui32Next]);
+
+				ui32Next = (ui32Next + 1) % MP_BENCH_MATRICES;
+			}
+
+			if (ui32Pass == 0)
+			{
+				OldPaletteConstants(gc, ui32NumMatrices, afPalette, afInverse);
+
+				pfPalette = afPalette;
+				pfInverse = afInverse;
+			}
+			else
+			{
+				pfPalette = GetPaletteMatrixConstants(gc, ui32NumMatrices);
+				pfInverse = GetPaletteInverseTransposeConstants(gc, ui32NumMatrices);
+			}
+
+			/* Stand in for the copy into the constant buffer */
+			g_fSink += pfPalette[ui32Draw % (ui32NumMatrices * MP_MATRIX_FLOATS)] +
+					pfInverse[ui32Draw % (ui32NumMatrices * MP_MATRIX_FLOATS)];
+		}
+
+		afTime[ui32Pass] = GetSeconds() - fStart;
+
+		FreeTransformState(gc);
+	}
+
+	printf("%2u bones %2u changed: %10.3f us %10.3f us %7.2fx\n", ui32NumMatrices, ui32Changed,
+		   afTime[0] * 1e6 / ui32Draws, afTime[1] * 1e6 / ui32Draws, afTime[0] / afTime[1]);
+}
+
+
+/***********************************************************************************
+ Function Name      : main
+ Inputs             : argc, argv
+ Outputs            : -
+ Returns            : 0 if every check passed
+ Description        : Runs the kernel and palette checks, then the benchmark
+************************************************************************************/
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = MP_DEFAULT_RUNS, ui32Steps = MP_DEFAULT_STEPS, ui32Draws = MP_DEFAULT_DRAWS;
+	IMG_UINT32 ui32Seed = 1, ui32Count, i;
+	static GLESMatrix asMatrices[MP_BENCH_MATRICES];
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			ui32Steps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-draws=", strlen("-draws=")) == 0)
+		{
+			ui32Draws = strtoul(argv[1] + strlen("-draws="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: matrixpalette [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	InitContext(&g_sContext);
+
+	for (i = 0; i < 16; i++)
+	{
+		for (ui32Count = 1; ui32Count <= MP_MAX_BATCH; ui32Count++)
+		{
+			CheckKernels(ui32Count);
+		}
+	}
+
+	FreeTransformState(&g_sContext);
+
+	printf("batched kernels compared for batches of 1 to %u (seed %u)\n", MP_MAX_BATCH, ui32Seed);
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunSequence(i, ui32Steps);
+	}
+
+	printf("%u palette sequences of %u steps, %u draws checked, %u palette matrices\n",
+		   i, ui32Steps, g_ui32NumDraws, GLES1_MAX_PALETTE_MATRICES);
+
+	if (ui32Draws && !g_ui32NumErrors)
+	{
+		static const IMG_UINT32 aui32Bones[] = {9, GLES1_MAX_PALETTE_MATRICES};
+		IMG_UINT32 ui32Bones;
+
+		for (i = 0; i < MP_BENCH_MATRICES; i++)
+		{
+			RandomMatrix(&asMatrices[i]);
+		}
+
+		printf("per draw              %13s %13s %8s\n", "old loops", "cached", "speedup");
+
+		for (ui32Bones = 0; ui32Bones < sizeof(aui32Bones) / sizeof(aui32Bones[0]); ui32Bones++)
+		{
+			IMG_UINT32 ui32NumMatrices = aui32Bones[ui32Bones];
+
+			TimeDraws(ui32NumMatrices, 0, ui32Draws, asMatrices);
+			TimeDraws(ui32NumMatrices, 1, ui32Draws, asMatrices);
+			TimeDraws(ui32NumMatrices, ui32NumMatrices / 4, ui32Draws, asMatrices);
+			TimeDraws(ui32NumMatrices, ui32NumMatrices, ui32Draws, asMatrices);
+		}
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
@@ -0,0 +1,47 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the GLES2 pixel pack buffer readback queue against a mocked
+# transfer queue. Reads queued into buffer objects must land, after the
+# blits' fences, exactly as synchronous glReadPixels calls would have
+# written them, whether the buffer is next mapped, updated or drawn from.
+# Run it with no arguments; it exits non-zero if any check fails.
+#
+
+modules := pixelpack
+
+pixelpack_type := host_executable
+
+pixelpack_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/pixelpack.c \
+ $(TOP)/eurasiacon/opengles2/spanpack.c
+
+# hostcontext.h stands in for the driver's context.h. The EGL headers expect
+# services.h ahead of them, and mark exports with the psp2 compiler's
+# __declspec.
+pixelpack_cflags := \
+ -DLINUX -DUSER -DOGLES2_MODULE -DPDS_BUILD_OPENGLES -DSUPPORT_SGX -DSUPPORT_SGX543 \
+ -DUSE_GCC__thread_KEYWORD \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h -include services.h \
+ -D'__declspec(x)=' \
+ -include $(TOP)/host/pixelpack/hostcontext.h
+
+pixelpack_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ include/gpu_es4/eurasia/services4/include \
+ include/gpu_es4/eurasia/services4/system/psp2 \
+ include/gpu_es4/eurasia/services4/srvclient/devices/sgx \
+ codegen/pds codegen/pixevent codegen/usegen \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ common/tls
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the pixel pack test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of pixelpack.c and spanpack.c in place
+ *                of the driver's context.h, whose include guard it defines.
+ *                The readback queue is the driver's own pixelpack.h. The
+ *                context keeps only the state the queue reads, and the
+ *                render kick, device memory and transfer queue come from
+ *                the harness's mocks.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "eglapi.h"
+#include "pvr_debug.h"
+#include "sgxdefs.h"
+
+#include "ogles2_types.h"
+
+#include "constants.h"
+
+
+/* As osglue.h */
+#define GLES2MemSet(X,Y,Z)			memset(X,Y,Z)
+#define GLES2MemCopy(X,Y,Z)			memcpy(X,Y,Z)
+#define GLES2Calloc(X,Y)			(IMG_VOID*)calloc(1, Y)
+#define GLES2Free(X,Y)				free(Y)
+
+/* As validate.h */
+#define ALIGNCOUNT(X, Y)	(((X) + ((Y) - 1)) & ~((Y) - 1))
+
+/* As context.h */
+#define GLES2_SCHEDULE_HW_LAST_IN_SCENE		0x00000001
+#define GLES2_SCHEDULE_HW_WAIT_FOR_3D		0x00000004
+#define GLES2_SCHEDULE_HW_MIDSCENE_RENDER	0x00000080
+
+/* As bufobj.h */
+typedef struct GLES2BufferObjectRec
+{
+	PVRSRV_CLIENT_MEM_INFO *psMemInfo;
+	IMG_UINT32 ui32BufferSize;
+	IMG_BOOL bMapped;
+
+	/* Stands in for the vertex cache optimised index copy */
+	IMG_VOID *pvOptimisedIndices;
+
+	struct GLES2PackReadbackRec *psPackReadbacks;
+
+} GLES2BufferObject;
+
+/* As attrib.h */
+typedef struct GLES2AttribArrayPointerStateRec
+{
+	GLES2BufferObject *psBufObj;
+
+} GLES2AttribArrayPointerState;
+
+/* As vertexarrobj.h */
+typedef struct GLES2VertexArrayObjectRec
+{
+	GLES2AttribArrayPointerState asVAOState[GLES2_MAX_VERTEX_ATTRIBS];
+
+	GLES2BufferObject *psBoundElementBuffer;
+
+	IMG_UINT32 ui32DirtyState;
+	IMG_UINT32 ui32PackReadbackStamp;
+
+} GLES2VertexArrayObject;
+
+/* As fbo.h */
+typedef struct GLES2FrameBufferRec GLES2FrameBuffer;
+
+typedef struct GLES2FrameBufferObjectMachineRec
+{
+	GLES2FrameBuffer *psActiveFrameBuffer;
+
+} GLES2FrameBufferObjectMachine;
+
+/* As misc.h */
+typedef struct GLESAppHintsRec
+{
+	IMG_BOOL bDisableHWTQNormalBlit;
+
+} GLESAppHints;
+
+/* As context.h */
+typedef struct GLES2ContextSharedStateTAG
+{
+	PVRSRV_MUTEX_HANDLE hPrimaryLock;
+
+	IMG_UINT32 ui32PackReadbackStamp;
+
+} GLES2ContextSharedState;
+
+
+struct GLES2Context_TAG
+{
+	SrvSysContext *psSysContext;
+
+	GLES2ContextSharedState *psSharedState;
+
+	GLES2FrameBufferObjectMachine sFrameBuffer;
+
+	EGLDrawableParams *psReadParams;
+
+	GLESAppHints sAppHints;
+};
+
+
+/* As context.h, with device memory from the harness */
+#define GLES2ALLOCDEVICEMEM_HEAP	HostAllocDeviceMem
+#define GLES2FREEDEVICEMEM_HEAP		HostFreeDeviceMem
+
+PVRSRV_ERROR HostAllocDeviceMem(GLES2Context *gc, IMG_UINT32 ui32Attribs, IMG_UINT32 ui32Size,
+								IMG_UINT32 ui32Alignment, PVRSRV_CLIENT_MEM_INFO **ppsMemInfo);
+PVRSRV_ERROR HostFreeDeviceMem(GLES2Context *gc, PVRSRV_CLIENT_MEM_INFO *psMemInfo);
+
+/* sgxapi.h only declares the psp2 form, with the device data, for __psp2__ */
+#define SGXQueueTransfer			HostQueueTransfer
+
+PVRSRV_ERROR HostQueueTransfer(PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hTransferContext,
+							   SGX_QUEUETRANSFER *psQueueTransfer);
+
+/* As context.h */
+IMG_EGLERROR ScheduleTA(GLES2Context *gc, EGLRenderSurface *psRenderSurface, IMG_UINT32 ui32KickFlags);
+
+/* As fbo.h */
+IMG_MEMLAYOUT GetColorAttachmentMemFormat(GLES2Context *gc, GLES2FrameBuffer *psFrameBuffer);
+
+/* As bufobj.h */
+IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj);
+IMG_VOID FreeOptimisedIndices(GLES2Context *gc, GLES2BufferObject *psBufObj);
+
+/* As texture.h */
+IMG_UINT32 BytesPerPixel(PVRSRV_PIXEL_FORMAT ePixelFormat);
+
+#include "pixelpack.h"
+
+#endif /* _CONTEXT_ */
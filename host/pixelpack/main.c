@@ -0,0 +1,1590 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLES2 pixel pack buffer readback test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Builds the driver's pixelpack.c and spanpack.c against a
+ *                mocked render kick, device memory and transfer queue.
+ *
+ *                The render only lands the scene in the surface when it is
+ *                kicked, so a blit queued ahead of its render reads stale
+ *                pixels. Each queued blit is checked against the surface
+ *                and staging memory it names, and takes its copy of the
+ *                read rectangle at queue time. It only writes that copy
+ *                into the staging memory, which starts out as garbage,
+ *                when it completes. Blits complete in order, at random
+ *                points, or when their fence is waited on, which may also
+ *                time out after partial progress. Freeing staging memory
+ *                a blit has yet to write is an error.
+ *
+ *                Random sequences render, read pixels into buffer
+ *                objects, map and update them, respecify them, attach
+ *                them to vertex array objects and draw. Each run uses one
+ *                surface format, orientation and memory layout. Every
+ *                buffer keeps a shadow written the way a synchronous
+ *                glReadPixels would have written it, at issue time. Maps,
+ *                and draws which fetch from a buffer through either
+ *                vertex array object, must see the shadow exactly. A draw
+ *                must not see a stale vertex cache optimised index copy,
+ *                and a buffer a draw is still fetching from must not be
+ *                written under it. In half the runs the draws go to
+ *                another surface, so a read's kick doesn't run them.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+
+#define PP_DEFAULT_RUNS			300
+#define PP_DEFAULT_STEPS		200
+
+#define PP_MAX_WIDTH			64
+#define PP_MAX_HEIGHT			48
+#define PP_MAX_STRIDE			(PP_MAX_WIDTH * 4 + 16)
+
+/* Reads may overhang the surface by this much on each side */
+#define PP_READ_OVERHANG		8
+
+#define PP_NUM_BUFFERS			4
+#define PP_BUFFER_BYTES			32768
+#define PP_NUM_VAOS				2
+
+#define PP_MAX_ALLOCS			64
+#define PP_MAX_BLITS			32
+
+#define PP_DEVADDR_BASE			0x10000000U
+#define PP_DEVADDR_SPAN			0x00100000U
+#define PP_SURFACE_DEVADDR		0x08000000U
+
+/* Steps of a sequence */
+#define PP_STEP_RENDER			0
+#define PP_STEP_READ			1
+#define PP_STEP_MAP				2
+#define PP_STEP_SUBDATA			3
+#define PP_STEP_DATA			4
+#define PP_STEP_DRAW			5
+#define PP_STEP_ATTACH			6
+#define PP_STEP_BIND_VAO		7
+#define PP_STEP_RETIRE			8
+
+typedef struct HostPackFormatRec
+{
+	PVRSRV_PIXEL_FORMAT ePixelFormat;
+	IMG_UINT32 ui32GroupBytes;
+	PFNSpanPack pfnSpanPack;
+	const IMG_CHAR *pszName;
+
+} HostPackFormat;
+
+typedef struct HostAllocRec
+{
+	/* First, so the driver's mem info leads back to the allocation */
+	PVRSRV_CLIENT_MEM_INFO sMemInfo;
+	PVRSRV_CLIENT_SYNC_INFO sSyncInfo;
+
+	IMG_BOOL bLive;
+	IMG_UINT32 ui32PendingBlits;
+
+} HostAlloc;
+
+typedef struct HostBlitRec
+{
+	HostAlloc *psDst;
+
+	/* The read rectangle as the blit found it, in staging layout */
+	IMG_UINT8 *pui8Pixels;
+	IMG_UINT32 ui32Bytes;
+
+} HostBlit;
+
+typedef struct HostBufferRec
+{
+	/* First, so the driver's buffer object leads back to the buffer */
+	GLES2BufferObject sBufObj;
+	PVRSRV_CLIENT_MEM_INFO sMemInfo;
+
+	IMG_UINT32 aui32Data[PP_BUFFER_BYTES / sizeof(IMG_UINT32)];
+
+	/* As synchronous reads would have left the buffer */
+	IMG_UINT32 aui32Shadow[PP_BUFFER_BYTES / sizeof(IMG_UINT32)];
+
+	/* What a draw still to be run by the TA fetches */
+	IMG_UINT32 aui32TACopy[PP_BUFFER_BYTES / sizeof(IMG_UINT32)];
+	IMG_BOOL bTAPending;
+
+} HostBuffer;
+
+/* As CheckReadPixelArgs in pixelop.c */
+static const HostPackFormat g_asPackFormats[] =
+{
+	{PVRSRV_PIXEL_FORMAT_RGB565,	2, SpanPack16,						"RGB/UNSIGNED_SHORT_5_6_5"},
+	{PVRSRV_PIXEL_FORMAT_RGB565,	4, SpanPackRGB565toXBGR8888,		"RGBA/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_ARGB4444,	4, SpanPackARGB4444toABGR8888,		"RGBA/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_ARGB4444,	2, SpanPackARGB4444toRGBA4444,		"RGBA/UNSIGNED_SHORT_4_4_4_4"},
+	{PVRSRV_PIXEL_FORMAT_ARGB4444,	2, SpanPack16,						"BGRA_IMG/UNSIGNED_SHORT_4_4_4_4_REV_IMG"},
+	{PVRSRV_PIXEL_FORMAT_ARGB1555,	4, SpanPackARGB1555toABGR8888,		"RGBA/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_ARGB1555,	2, SpanPackARGB1555toRGBA5551,		"RGBA/UNSIGNED_SHORT_5_5_5_1"},
+	{PVRSRV_PIXEL_FORMAT_ARGB8888,	4, SpanPackARGB8888toABGR8888,		"RGBA/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_ARGB8888,	4, SpanPack32,						"BGRA_IMG/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_ABGR8888,	4, SpanPack32,						"RGBA/UNSIGNED_BYTE"},
+	{PVRSRV_PIXEL_FORMAT_XRGB8888,	4, SpanPackXRGB8888to1BGR8888,		"RGBA/UNSIGNED_BYTE"},
+};
+
+#define PP_NUM_PACK_FORMATS		(sizeof(g_asPackFormats) / sizeof(g_asPackFormats[0]))
+
+static const PVRSRV_PIXEL_FORMAT g_aeSurfaceFormats[] =
+{
+	PVRSRV_PIXEL_FORMAT_RGB565,
+	PVRSRV_PIXEL_FORMAT_ARGB4444,
+	PVRSRV_PIXEL_FORMAT_ARGB1555,
+	PVRSRV_PIXEL_FORMAT_ARGB8888,
+	PVRSRV_PIXEL_FORMAT_ABGR8888,
+	PVRSRV_PIXEL_FORMAT_XRGB8888,
+};
+
+static const IMG_MEMLAYOUT g_aeMemLayouts[] =
+{
+	IMG_MEMLAYOUT_STRIDED,
+	IMG_MEMLAYOUT_TILED,
+	IMG_MEMLAYOUT_TWIDDLED,
+	IMG_MEMLAYOUT_HYBRIDTWIDDLED,
+};
+
+static GLES2Context g_sContext;
+static GLES2ContextSharedState g_sShared;
+static SrvSysContext g_sSysContext;
+static EGLDrawableParams g_sReadParams;
+static EGLRenderSurface g_sRenderSurface;
+static PVRSRV_CLIENT_SYNC_INFO g_sSurfaceSyncInfo;
+static IMG_MEMLAYOUT g_eMemLayout;
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+/* The primary lock's handle, and whether it is held */
+static IMG_UINT32 g_ui32PrimaryLock;
+static IMG_BOOL g_bPrimaryLockHeld;
+
+static IMG_UINT32 g_ui32TransferContext;
+
+/* What has been rendered, and what the last kick left in memory */
+static IMG_UINT32 g_aui32Scene[PP_MAX_HEIGHT * PP_MAX_STRIDE / sizeof(IMG_UINT32)];
+static IMG_UINT32 g_aui32Surface[PP_MAX_HEIGHT * PP_MAX_STRIDE / sizeof(IMG_UINT32)];
+static IMG_BOOL g_bSceneDirty;
+
+/* Otherwise draws go to another surface, which a read doesn't kick */
+static IMG_BOOL g_bReadDrawSurface;
+
+static HostAlloc g_asAllocs[PP_MAX_ALLOCS];
+static IMG_UINT32 g_ui32NumAllocs;
+
+static HostBlit g_asBlits[PP_MAX_BLITS];
+static IMG_UINT32 g_ui32BlitHead, g_ui32NumBlits;
+
+static HostBuffer g_asBuffers[PP_NUM_BUFFERS];
+
+static GLES2VertexArrayObject g_asVAOs[PP_NUM_VAOS];
+static GLES2VertexArrayObject *g_psActiveVAO;
+
+/* Injected failures, one in this many */
+static IMG_UINT32 g_ui32AllocFailRate, g_ui32QueueFailRate;
+
+static IMG_UINT32 g_ui32NumQueued, g_ui32NumSync, g_ui32NumDrawResolves, g_ui32NumTimeouts;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Random sequences (default 300).\n"
+"-steps=N    Calls per sequence (default 200).\n"
+"-seed=N     Seed for the sequences (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : FillRandom
+ Inputs             : pvData, ui32Bytes
+ Outputs            : pvData
+ Returns            : -
+ Description        : Fills memory with random bytes
+************************************************************************************/
+static IMG_VOID FillRandom(IMG_VOID *pvData, IMG_UINT32 ui32Bytes)
+{
+	IMG_UINT8 *pui8Data = (IMG_UINT8 *)pvData;
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Bytes; i++)
+	{
+		pui8Data[i] = (IMG_UINT8)Random(256);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GetBufferIndex
+ Inputs             : psBufObj
+ Outputs            : -
+ Returns            : Index of the harness buffer holding psBufObj
+ Description        : UTILITY
+************************************************************************************/
+static IMG_UINT32 GetBufferIndex(const GLES2BufferObject *psBufObj)
+{
+	return (IMG_UINT32)((const HostBuffer *)psBufObj - g_asBuffers);
+}
+
+
+/*
+** Services mocks
+*/
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVLockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	if (hMutex != (PVRSRV_MUTEX_HANDLE)&g_ui32PrimaryLock)
+	{
+		Fail("locked a mutex other than the shared state's primary lock");
+	}
+
+	if (g_bPrimaryLockHeld)
+	{
+		Fail("primary lock taken while already held");
+	}
+
+	g_bPrimaryLockHeld = IMG_TRUE;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVUnlockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	if (hMutex != (PVRSRV_MUTEX_HANDLE)&g_ui32PrimaryLock || !g_bPrimaryLockHeld)
+	{
+		Fail("unlocked a mutex that wasn't held");
+	}
+
+	g_bPrimaryLockHeld = IMG_FALSE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostRetireBlits
+ Inputs             : ui32Count
+ Outputs            : -
+ Returns            : -
+ Description        : Completes the oldest queued blits, writing their copies of
+					  the read rectangle into the staging memory
+************************************************************************************/
+static IMG_VOID HostRetireBlits(IMG_UINT32 ui32Count)
+{
+	while (ui32Count-- && g_ui32NumBlits)
+	{
+		HostBlit *psBlit = &g_asBlits[g_ui32BlitHead];
+
+		if (psBlit->psDst)
+		{
+			memcpy(psBlit->psDst->sMemInfo.pvLinAddr, psBlit->pui8Pixels, psBlit->ui32Bytes);
+
+			psBlit->psDst->ui32PendingBlits--;
+		}
+
+		free(psBlit->pui8Pixels);
+
+		g_ui32BlitHead = (g_ui32BlitHead + 1) % PP_MAX_BLITS;
+		g_ui32NumBlits--;
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : SGX2DQueryBlitsComplete
+ Inputs             : psDevData, psSyncInfo, bWaitForComplete
+ Outputs            : -
+ Returns            : PVRSRV_OK once every blit writing the memory has completed
+ Description        : Mock. A wait may time out after completing one blit.
+************************************************************************************/
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV SGX2DQueryBlitsComplete(PVRSRV_DEV_DATA *psDevData,
+															 PVRSRV_CLIENT_SYNC_INFO *psSyncInfo,
+															 IMG_BOOL bWaitForComplete)
+{
+	HostAlloc *psAlloc = IMG_NULL;
+	IMG_UINT32 i;
+
+	if (psDevData != &g_sSysContext.s3D)
+	{
+		Fail("blit fence queried on the wrong device");
+	}
+
+	for (i = 0; i < PP_MAX_ALLOCS; i++)
+	{
+		if (g_asAllocs[i].bLive && &g_asAllocs[i].sSyncInfo == psSyncInfo)
+		{
+			psAlloc = &g_asAllocs[i];
+		}
+	}
+
+	if (!psAlloc)
+	{
+		Fail("blit fence queried on a sync object that isn't live staging memory");
+
+		return PVRSRV_OK;
+	}
+
+	if (!psAlloc->ui32PendingBlits)
+	{
+		return PVRSRV_OK;
+	}
+
+	if (!bWaitForComplete)
+	{
+		return PVRSRV_ERROR_RETRY;
+	}
+
+	if (Random(4) == 0)
+	{
+		g_ui32NumTimeouts++;
+
+		HostRetireBlits(1);
+
+		return psAlloc->ui32PendingBlits ? PVRSRV_ERROR_TIMEOUT : PVRSRV_OK;
+	}
+
+	while (psAlloc->ui32PendingBlits)
+	{
+		HostRetireBlits(1);
+	}
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostAllocDeviceMem
+ Inputs             : gc, ui32Attribs, ui32Size, ui32Alignment
+ Outputs            : ppsMemInfo
+ Returns            : Success
+ Description        : Mock of GLES2ALLOCDEVICEMEM_HEAP. Memory starts out as
+					  garbage, at a fake device address.
+************************************************************************************/
+PVRSRV_ERROR HostAllocDeviceMem(GLES2Context *gc, IMG_UINT32 ui32Attribs, IMG_UINT32 ui32Size,
+								IMG_UINT32 ui32Alignment, PVRSRV_CLIENT_MEM_INFO **ppsMemInfo)
+{
+	HostAlloc *psAlloc;
+	IMG_UINT32 i;
+
+	PVR_UNREFERENCED_PARAMETER(ui32Attribs);
+
+	if (gc != &g_sContext)
+	{
+		Fail("device memory allocated on the wrong context");
+	}
+
+	if (!ui32Size || ui32Size > PP_DEVADDR_SPAN || (PP_DEVADDR_SPAN % ui32Alignment) != 0)
+	{
+		Fail("bad staging allocation: %u bytes aligned to %u", ui32Size, ui32Alignment);
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (g_ui32AllocFailRate && Random(g_ui32AllocFailRate) == 0)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (i = 0; i < PP_MAX_ALLOCS && g_asAllocs[i].bLive; i++);
+
+	if (i == PP_MAX_ALLOCS)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	psAlloc = &g_asAllocs[i];
+
+	memset(psAlloc, 0, sizeof(*psAlloc));
+
+	psAlloc->sMemInfo.pvLinAddr = malloc(ui32Size);
+	psAlloc->sMemInfo.sDevVAddr.uiAddr = PP_DEVADDR_BASE + i * PP_DEVADDR_SPAN;
+	psAlloc->sMemInfo.uAllocSize = ui32Size;
+	psAlloc->sMemInfo.psClientSyncInfo = &psAlloc->sSyncInfo;
+	psAlloc->bLive = IMG_TRUE;
+
+	memset(psAlloc->sMemInfo.pvLinAddr, 0xCD, ui32Size);
+
+	g_ui32NumAllocs++;
+
+	*ppsMemInfo = &psAlloc->sMemInfo;
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostFreeDeviceMem
+ Inputs             : gc, psMemInfo
+ Outputs            : -
+ Returns            : Success
+ Description        : Mock of GLES2FREEDEVICEMEM_HEAP. The memory must be live,
+					  and no blit may still be due to write it.
+************************************************************************************/
+PVRSRV_ERROR HostFreeDeviceMem(GLES2Context *gc, PVRSRV_CLIENT_MEM_INFO *psMemInfo)
+{
+	HostAlloc *psAlloc = (HostAlloc *)psMemInfo;
+	IMG_UINT32 i;
+
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	if (psAlloc < g_asAllocs || psAlloc >= &g_asAllocs[PP_MAX_ALLOCS] || !psAlloc->bLive)
+	{
+		Fail("freed device memory that isn't a live allocation");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (psAlloc->ui32PendingBlits)
+	{
+		Fail("staging memory freed with %u blits still to write it", psAlloc->ui32PendingBlits);
+
+		/* Drop the writes rather than make them into freed memory */
+		for (i = 0; i < g_ui32NumBlits; i++)
+		{
+			HostBlit *psBlit = &g_asBlits[(g_ui32BlitHead + i) % PP_MAX_BLITS];
+
+			if (psBlit->psDst == psAlloc)
+			{
+				psBlit->psDst = IMG_NULL;
+			}
+		}
+	}
+
+	free(psAlloc->sMemInfo.pvLinAddr);
+
+	psAlloc->bLive = IMG_FALSE;
+
+	g_ui32NumAllocs--;
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostRunTA
+ Inputs             : psBuffer
+ Outputs            : -
+ Returns            : -
+ Description        : Runs a buffer's pending draws, which must fetch what they
+					  would have when they were issued
+************************************************************************************/
+static IMG_VOID HostRunTA(HostBuffer *psBuffer)
+{
+	if (psBuffer->bTAPending)
+	{
+		if (memcmp(psBuffer->aui32TACopy, psBuffer->aui32Data, PP_BUFFER_BYTES) != 0)
+		{
+			Fail("buffer %u was written while a draw still fetched from it", GetBufferIndex(&psBuffer->sBufObj));
+		}
+
+		psBuffer->bTAPending = IMG_FALSE;
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ScheduleTA
+ Inputs             : gc, psRenderSurface, ui32KickFlags
+ Outputs            : -
+ Returns            : Success
+ Description        : Mock. Lands the scene in the surface, and runs the TA for
+					  every pending draw if they were to the same surface.
+************************************************************************************/
+IMG_EGLERROR ScheduleTA(GLES2Context *gc, EGLRenderSurface *psRenderSurface, IMG_UINT32 ui32KickFlags)
+{
+	IMG_UINT32 i;
+
+	if (gc != &g_sContext || psRenderSurface != &g_sRenderSurface)
+	{
+		Fail("kicked the wrong surface");
+	}
+
+	if (!(ui32KickFlags & GLES2_SCHEDULE_HW_LAST_IN_SCENE))
+	{
+		Fail("a read kicked without ending the scene: flags 0x%x", ui32KickFlags);
+	}
+
+	if (g_bReadDrawSurface)
+	{
+		for (i = 0; i < PP_NUM_BUFFERS; i++)
+		{
+			HostRunTA(&g_asBuffers[i]);
+		}
+	}
+
+	memcpy(g_aui32Surface, g_aui32Scene, sizeof(g_aui32Surface));
+
+	g_bSceneDirty = IMG_FALSE;
+
+	return IMG_EGL_NO_ERROR;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetColorAttachmentMemFormat
+ Inputs             : gc, psFrameBuffer
+ Outputs            : -
+ Returns            : The run's surface layout
+ Description        : Mock
+************************************************************************************/
+IMG_MEMLAYOUT GetColorAttachmentMemFormat(GLES2Context *gc, GLES2FrameBuffer *psFrameBuffer)
+{
+	PVR_UNREFERENCED_PARAMETER(gc);
+	PVR_UNREFERENCED_PARAMETER(psFrameBuffer);
+
+	return g_eMemLayout;
+}
+
+
+/***********************************************************************************
+ Function Name      : WaitUntilBufObjNotUsed
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : Success
+ Description        : Mock. Runs the buffer's pending draws.
+************************************************************************************/
+IMG_BOOL WaitUntilBufObjNotUsed(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	HostRunTA((HostBuffer *)psBufObj);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : FreeOptimisedIndices
+ Inputs             : gc, psBufObj
+ Outputs            : -
+ Returns            : -
+ Description        : Mock. Drops the buffer's reordered index copy.
+************************************************************************************/
+IMG_VOID FreeOptimisedIndices(GLES2Context *gc, GLES2BufferObject *psBufObj)
+{
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	free(psBufObj->pvOptimisedIndices);
+
+	psBufObj->pvOptimisedIndices = IMG_NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : BytesPerPixel
+ Inputs             : ePixelFormat
+ Outputs            : -
+ Returns            : Number of bytes per pixel
+ Description        : As BytesPerPixel in pixelop.c
+************************************************************************************/
+IMG_UINT32 BytesPerPixel(PVRSRV_PIXEL_FORMAT ePixelFormat)
+{
+	switch(ePixelFormat)
+	{
+		case PVRSRV_PIXEL_FORMAT_RGB565:
+		case PVRSRV_PIXEL_FORMAT_ARGB4444:
+		case PVRSRV_PIXEL_FORMAT_ARGB1555:
+		{
+			return 2;
+		}
+		case PVRSRV_PIXEL_FORMAT_ARGB8888:
+		case PVRSRV_PIXEL_FORMAT_ABGR8888:
+		case PVRSRV_PIXEL_FORMAT_XRGB8888:
+		case PVRSRV_PIXEL_FORMAT_XBGR8888:
+		{
+			return 4;
+		}
+		default:
+		{
+			return 0;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostQueueTransfer
+ Inputs             : psDevData, hTransferContext, psQueueTransfer
+ Outputs            : -
+ Returns            : Success
+ Description        : Mock of SGXQueueTransfer. Checks the blit against the
+					  surface and staging memory, and copies the read rectangle
+					  as the render has left it. The copy only reaches the
+					  staging memory when the blit completes.
+************************************************************************************/
+PVRSRV_ERROR HostQueueTransfer(PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hTransferContext,
+							   SGX_QUEUETRANSFER *psQueueTransfer)
+{
+	const SGXTQ_SURFACE *psSrc = &psQueueTransfer->asSources[0];
+	const SGXTQ_SURFACE *psDst = &psQueueTransfer->asDests[0];
+	const IMG_RECT *psSrcRect = &psQueueTransfer->asSrcRects[0];
+	const IMG_RECT *psDstRect = &psQueueTransfer->asDestRects[0];
+	IMG_UINT32 ui32BytesPerPixel = BytesPerPixel(g_sReadParams.ePixelFormat);
+	IMG_UINT32 ui32Width, ui32Height, ui32Alloc, i;
+	SGXTQ_MEMLAYOUT eExpectedLayout;
+	HostAlloc *psAlloc;
+	HostBlit *psBlit;
+
+	if (psDevData != &g_sSysContext.s3D || hTransferContext != (IMG_HANDLE)&g_ui32TransferContext)
+	{
+		Fail("blit queued on the wrong device or transfer context");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (g_bSceneDirty)
+	{
+		Fail("readback blit queued ahead of the render it reads");
+	}
+
+	if (psQueueTransfer->eType != SGXTQ_BLIT || !(psQueueTransfer->ui32Flags & SGX_KICKTRANSFER_FLAGS_3DTQ_SYNC) ||
+		psQueueTransfer->ui32NumSources != 1 || psQueueTransfer->ui32NumDest != 1 ||
+		psQueueTransfer->ui32NumSrcRects != 1 || psQueueTransfer->ui32NumDestRects != 1 ||
+		psQueueTransfer->Details.sBlit.eRotation != SGXTQ_ROTATION_NONE)
+	{
+		Fail("readback isn't a single synchronised unrotated blit");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	/* Source */
+	switch (g_eMemLayout)
+	{
+		case IMG_MEMLAYOUT_STRIDED:
+		{
+			eExpectedLayout = SGXTQ_MEMLAYOUT_STRIDE;
+			break;
+		}
+		case IMG_MEMLAYOUT_TILED:
+		{
+			eExpectedLayout = SGXTQ_MEMLAYOUT_TILED;
+			break;
+		}
+		default:
+		{
+			eExpectedLayout = SGXTQ_MEMLAYOUT_2D;
+			break;
+		}
+	}
+
+	if (psSrc->sDevVAddr.uiAddr != g_sReadParams.ui32HWSurfaceAddress || psSrc->eFormat != g_sReadParams.ePixelFormat ||
+		psSrc->psSyncInfo != g_sReadParams.psSyncInfo || psSrc->eMemLayout != eExpectedLayout ||
+		psSrc->ui32Width < g_sReadParams.ui32Width || psSrc->ui32Height < g_sReadParams.ui32Height ||
+		(eExpectedLayout == SGXTQ_MEMLAYOUT_STRIDE && psSrc->i32StrideInBytes != (IMG_INT32)g_sReadParams.ui32Stride))
+	{
+		Fail("readback blit source doesn't describe the read surface");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (psSrcRect->x0 < 0 || psSrcRect->y0 < 0 || psSrcRect->x0 >= psSrcRect->x1 || psSrcRect->y0 >= psSrcRect->y1 ||
+		psSrcRect->x1 > (IMG_INT32)g_sReadParams.ui32Width || psSrcRect->y1 > (IMG_INT32)g_sReadParams.ui32Height)
+	{
+		Fail("readback blit source rectangle (%d,%d)-(%d,%d) is outside the %ux%u surface",
+			 psSrcRect->x0, psSrcRect->y0, psSrcRect->x1, psSrcRect->y1,
+			 g_sReadParams.ui32Width, g_sReadParams.ui32Height);
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	ui32Width  = (IMG_UINT32)(psSrcRect->x1 - psSrcRect->x0);
+	ui32Height = (IMG_UINT32)(psSrcRect->y1 - psSrcRect->y0);
+
+	/* Destination */
+	ui32Alloc = (psDst->sDevVAddr.uiAddr - PP_DEVADDR_BASE) / PP_DEVADDR_SPAN;
+
+	if (psDst->sDevVAddr.uiAddr < PP_DEVADDR_BASE || ui32Alloc >= PP_MAX_ALLOCS ||
+		psDst->sDevVAddr.uiAddr != PP_DEVADDR_BASE + ui32Alloc * PP_DEVADDR_SPAN || !g_asAllocs[ui32Alloc].bLive)
+	{
+		Fail("readback blit destination isn't live staging memory");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	psAlloc = &g_asAllocs[ui32Alloc];
+
+	if (psDst->eFormat != g_sReadParams.ePixelFormat || psDst->eMemLayout != SGXTQ_MEMLAYOUT_OUT_LINEAR ||
+		psDst->psSyncInfo != &psAlloc->sSyncInfo || psDst->i32StrideInBytes < (IMG_INT32)(ui32Width * ui32BytesPerPixel) ||
+		psDst->ui32Width * ui32BytesPerPixel != (IMG_UINT32)psDst->i32StrideInBytes ||
+		psDst->ui32Height != ui32Height ||
+		(IMG_UINT32)psDst->i32StrideInBytes * ui32Height > psAlloc->sMemInfo.uAllocSize)
+	{
+		Fail("readback blit destination doesn't describe its staging memory");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (psDstRect->x0 != 0 || psDstRect->y0 != 0 ||
+		psDstRect->x1 != (IMG_INT32)ui32Width || psDstRect->y1 != (IMG_INT32)ui32Height)
+	{
+		Fail("readback blit destination rectangle doesn't match the source");
+
+		return PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	if (g_ui32QueueFailRate && Random(g_ui32QueueFailRate) == 0)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	if (g_ui32NumBlits == PP_MAX_BLITS)
+	{
+		HostRetireBlits(1);
+	}
+
+	psBlit = &g_asBlits[(g_ui32BlitHead + g_ui32NumBlits) % PP_MAX_BLITS];
+
+	psBlit->psDst = psAlloc;
+	psBlit->ui32Bytes = (IMG_UINT32)psDst->i32StrideInBytes * ui32Height;
+	psBlit->pui8Pixels = malloc(psBlit->ui32Bytes);
+
+	/* The staging padding is left as the blit finds it */
+	memcpy(psBlit->pui8Pixels, psAlloc->sMemInfo.pvLinAddr, psBlit->ui32Bytes);
+
+	for (i = 0; i < ui32Height; i++)
+	{
+		memcpy(psBlit->pui8Pixels + i * (IMG_UINT32)psDst->i32StrideInBytes,
+			   (IMG_UINT8 *)g_aui32Surface + ((IMG_UINT32)psSrcRect->y0 + i) * g_sReadParams.ui32Stride +
+			   (IMG_UINT32)psSrcRect->x0 * ui32BytesPerPixel,
+			   ui32Width * ui32BytesPerPixel);
+	}
+
+	psAlloc->ui32PendingBlits++;
+	g_ui32NumBlits++;
+
+	return PVRSRV_OK;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostSetupSpanInfo
+ Inputs             : i32X, i32Y, ui32Width, ui32Height, psFormat, ui32Alignment
+ Outputs            : psSpanInfo
+ Returns            : Anything to read
+ Description        : As SetupReadPixelsSpanInfo and ClipReadPixels in pixelop.c,
+					  for the orientations the tests use
+************************************************************************************/
+static IMG_BOOL HostSetupSpanInfo(GLES2PixelSpanInfo *psSpanInfo, IMG_INT32 i32X, IMG_INT32 i32Y,
+								  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height,
+								  const HostPackFormat *psFormat, IMG_UINT32 ui32Alignment)
+{
+	IMG_INT32 i32X1 = i32X, i32Y1 = i32Y;
+	IMG_INT32 i32X2 = i32X + (IMG_INT32)ui32Width, i32Y2 = i32Y + (IMG_INT32)ui32Height;
+	IMG_UINT32 ui32Padding;
+
+	memset(psSpanInfo, 0, sizeof(*psSpanInfo));
+
+	if (i32X1 < 0)
+	{
+		psSpanInfo->ui32DstSkipPixels = (IMG_UINT32)-i32X1;
+		i32X1 = 0;
+	}
+
+	if (i32Y1 < 0)
+	{
+		psSpanInfo->ui32DstSkipLines = (IMG_UINT32)-i32Y1;
+		i32Y1 = 0;
+	}
+
+	if (i32X2 > (IMG_INT32)g_sReadParams.ui32Width)
+	{
+		i32X2 = (IMG_INT32)g_sReadParams.ui32Width;
+	}
+
+	if (i32Y2 > (IMG_INT32)g_sReadParams.ui32Height)
+	{
+		i32Y2 = (IMG_INT32)g_sReadParams.ui32Height;
+	}
+
+	if (i32X1 >= i32X2 || i32Y1 >= i32Y2)
+	{
+		return IMG_FALSE;
+	}
+
+	psSpanInfo->i32ReadX = i32X1;
+	psSpanInfo->i32ReadY = i32Y1;
+	psSpanInfo->ui32Width = (IMG_UINT32)(i32X2 - i32X1);
+	psSpanInfo->ui32Height = (IMG_UINT32)(i32Y2 - i32Y1);
+
+	psSpanInfo->ui32DstGroupIncrement = psFormat->ui32GroupBytes;
+	psSpanInfo->ui32DstRowIncrement = ui32Width * psFormat->ui32GroupBytes;
+
+	ui32Padding = psSpanInfo->ui32DstRowIncrement % ui32Alignment;
+
+	if (ui32Padding)
+	{
+		psSpanInfo->ui32DstRowIncrement += ui32Alignment - ui32Padding;
+	}
+
+	psSpanInfo->i32SrcGroupIncrement = (IMG_INT32)BytesPerPixel(g_sReadParams.ePixelFormat);
+
+	if (g_sReadParams.eRotationAngle == PVRSRV_FLIP_Y)
+	{
+		psSpanInfo->i32SrcRowIncrement = (IMG_INT32)g_sReadParams.ui32Stride;
+	}
+	else
+	{
+		psSpanInfo->i32SrcRowIncrement = -(IMG_INT32)g_sReadParams.ui32Stride;
+		psSpanInfo->i32ReadY = 1 + psSpanInfo->i32ReadY - (IMG_INT32)g_sReadParams.ui32Height;
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostPackPixels
+ Inputs             : pui8Dst, pui8Surface, psSpanInfo, pfnSpanPack
+ Outputs            : pui8Dst
+ Returns            : -
+ Description        : As the synchronous path of glReadPixels
+************************************************************************************/
+static IMG_VOID HostPackPixels(IMG_UINT8 *pui8Dst, IMG_UINT8 *pui8Surface, const GLES2PixelSpanInfo *psSpanInfo,
+							   PFNSpanPack pfnSpanPack)
+{
+	GLES2PixelSpanInfo sSpanInfo = *psSpanInfo;
+	IMG_UINT32 i;
+
+	sSpanInfo.pvOutData = (IMG_VOID *)(pui8Dst +
+									   sSpanInfo.ui32DstSkipLines * sSpanInfo.ui32DstRowIncrement +
+									   sSpanInfo.ui32DstSkipPixels * sSpanInfo.ui32DstGroupIncrement);
+
+	sSpanInfo.pvInData = (IMG_VOID *)(pui8Surface +
+									  sSpanInfo.i32ReadY * sSpanInfo.i32SrcRowIncrement +
+									  sSpanInfo.i32ReadX * sSpanInfo.i32SrcGroupIncrement);
+
+	for (i = 0; i < sSpanInfo.ui32Height; i++)
+	{
+		(*pfnSpanPack)(&sSpanInfo);
+
+		sSpanInfo.pvOutData = (IMG_VOID *)((IMG_UINT8 *)sSpanInfo.pvOutData + sSpanInfo.ui32DstRowIncrement);
+
+		sSpanInfo.pvInData  = (IMG_VOID *)((IMG_UINT8 *)sSpanInfo.pvInData  + sSpanInfo.i32SrcRowIncrement);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckBuffer
+ Inputs             : psBuffer, pszWhen
+ Outputs            : -
+ Returns            : -
+ Description        : The buffer's contents must match its shadow
+************************************************************************************/
+static IMG_VOID CheckBuffer(const HostBuffer *psBuffer, const IMG_CHAR *pszWhen)
+{
+	const IMG_UINT8 *pui8Data = (const IMG_UINT8 *)psBuffer->aui32Data;
+	const IMG_UINT8 *pui8Shadow = (const IMG_UINT8 *)psBuffer->aui32Shadow;
+	IMG_UINT32 i;
+
+	for (i = 0; i < PP_BUFFER_BYTES; i++)
+	{
+		if (pui8Data[i] != pui8Shadow[i])
+		{
+			Fail("%s buffer %u: byte %u is 0x%02x, a synchronous read gives 0x%02x (%s %ux%u, %s)",
+				 pszWhen, GetBufferIndex(&psBuffer->sBufObj), i, pui8Data[i], pui8Shadow[i],
+				 (g_sReadParams.eRotationAngle == PVRSRV_FLIP_Y) ? "flipped" : "unflipped",
+				 g_sReadParams.ui32Width, g_sReadParams.ui32Height,
+				 (g_eMemLayout == IMG_MEMLAYOUT_STRIDED) ? "strided" : "not strided");
+
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostReadPixels
+ Inputs             : gc, psBuffer
+ Outputs            : -
+ Returns            : -
+ Description        : glReadPixels into a pack buffer, at a random rectangle,
+					  format, pack alignment and offset. The shadow is written
+					  as a synchronous read of the scene would write it.
+************************************************************************************/
+static IMG_VOID HostReadPixels(GLES2Context *gc, HostBuffer *psBuffer)
+{
+	static const IMG_UINT32 aui32Alignments[] = {1, 2, 4, 8};
+	const HostPackFormat *psFormat;
+	GLES2PixelSpanInfo sSpanInfo;
+	IMG_UINT32 ui32Width, ui32Height, ui32Alignment, ui32RowSize, ui32ImageSize, ui32Offset;
+	IMG_INT32 i32X, i32Y;
+
+	do
+	{
+		psFormat = &g_asPackFormats[Random(PP_NUM_PACK_FORMATS)];
+	}
+	while (psFormat->ePixelFormat != g_sReadParams.ePixelFormat);
+
+	i32X = (IMG_INT32)Random(g_sReadParams.ui32Width + PP_READ_OVERHANG) - PP_READ_OVERHANG / 2;
+	i32Y = (IMG_INT32)Random(g_sReadParams.ui32Height + PP_READ_OVERHANG) - PP_READ_OVERHANG / 2;
+	ui32Width  = 1 + Random(g_sReadParams.ui32Width + PP_READ_OVERHANG);
+	ui32Height = 1 + Random(g_sReadParams.ui32Height + PP_READ_OVERHANG);
+	ui32Alignment = aui32Alignments[Random(4)];
+
+	/* As GetPackedImageSize in pixelop.c */
+	ui32RowSize = ALIGNCOUNT(ui32Width * psFormat->ui32GroupBytes, ui32Alignment);
+	ui32ImageSize = (ui32Height - 1) * ui32RowSize + ui32Width * psFormat->ui32GroupBytes;
+
+	/* A few offsets, so reads into the same buffer overlap */
+	ui32Offset = Random(8) * 512 + Random(2) * psFormat->ui32GroupBytes;
+
+	if (ui32Offset + ui32ImageSize > PP_BUFFER_BYTES)
+	{
+		ui32Offset = 0;
+
+		if (ui32ImageSize > PP_BUFFER_BYTES)
+		{
+			return;
+		}
+	}
+
+	if (!HostSetupSpanInfo(&sSpanInfo, i32X, i32Y, ui32Width, ui32Height, psFormat, ui32Alignment))
+	{
+		return;
+	}
+
+	HostPackPixels((IMG_UINT8 *)psBuffer->aui32Shadow + ui32Offset, (IMG_UINT8 *)g_aui32Scene,
+				   &sSpanInfo, psFormat->pfnSpanPack);
+
+	if (QueuePackBufferReadback(gc, &psBuffer->sBufObj, ui32Offset, &sSpanInfo, psFormat->pfnSpanPack))
+	{
+		g_ui32NumQueued++;
+
+		return;
+	}
+
+	/* As the synchronous fallback in glReadPixels */
+	g_ui32NumSync++;
+
+	if (!ResolvePackBufferReadbacks(gc, &psBuffer->sBufObj) || !WaitUntilBufObjNotUsed(gc, &psBuffer->sBufObj))
+	{
+		Fail("synchronous read couldn't resolve the buffer's readbacks");
+
+		return;
+	}
+
+	FreeOptimisedIndices(gc, &psBuffer->sBufObj);
+
+	ScheduleTA(gc, &g_sRenderSurface, GLES2_SCHEDULE_HW_LAST_IN_SCENE | GLES2_SCHEDULE_HW_WAIT_FOR_3D);
+
+	HostPackPixels((IMG_UINT8 *)psBuffer->aui32Data + ui32Offset, (IMG_UINT8 *)g_aui32Surface,
+				   &sSpanInfo, psFormat->pfnSpanPack);
+}
+
+
+/***********************************************************************************
+ Function Name      : HostMapBuffer
+ Inputs             : gc, psBuffer
+ Outputs            : -
+ Returns            : -
+ Description        : As glMapBufferOES, then checks what the app would read
+************************************************************************************/
+static IMG_VOID HostMapBuffer(GLES2Context *gc, HostBuffer *psBuffer)
+{
+	if (!ResolvePackBufferReadbacks(gc, &psBuffer->sBufObj))
+	{
+		Fail("map couldn't resolve the buffer's readbacks");
+	}
+
+	FreeOptimisedIndices(gc, &psBuffer->sBufObj);
+
+	WaitUntilBufObjNotUsed(gc, &psBuffer->sBufObj);
+
+	if (psBuffer->sBufObj.psPackReadbacks)
+	{
+		Fail("buffer %u mapped with readbacks outstanding", GetBufferIndex(&psBuffer->sBufObj));
+	}
+
+	CheckBuffer(psBuffer, "mapped");
+}
+
+
+/***********************************************************************************
+ Function Name      : HostBufferSubData
+ Inputs             : gc, psBuffer
+ Outputs            : -
+ Returns            : -
+ Description        : As glBufferSubData, at a random range
+************************************************************************************/
+static IMG_VOID HostBufferSubData(GLES2Context *gc, HostBuffer *psBuffer)
+{
+	IMG_UINT32 ui32Offset = Random(PP_BUFFER_BYTES);
+	IMG_UINT32 ui32Size = 1 + Random(PP_BUFFER_BYTES - ui32Offset);
+
+	if (!ResolvePackBufferReadbacks(gc, &psBuffer->sBufObj))
+	{
+		Fail("subdata couldn't resolve the buffer's readbacks");
+	}
+
+	WaitUntilBufObjNotUsed(gc, &psBuffer->sBufObj);
+
+	FreeOptimisedIndices(gc, &psBuffer->sBufObj);
+
+	FillRandom((IMG_UINT8 *)psBuffer->aui32Data + ui32Offset, ui32Size);
+
+	memcpy((IMG_UINT8 *)psBuffer->aui32Shadow + ui32Offset, (IMG_UINT8 *)psBuffer->aui32Data + ui32Offset, ui32Size);
+}
+
+
+/***********************************************************************************
+ Function Name      : HostBufferData
+ Inputs             : gc, psBuffer
+ Outputs            : -
+ Returns            : -
+ Description        : As glBufferData respecifying the whole buffer, which
+					  drops its readbacks
+************************************************************************************/
+static IMG_VOID HostBufferData(GLES2Context *gc, HostBuffer *psBuffer)
+{
+	DiscardPackBufferReadbacks(gc, &psBuffer->sBufObj);
+
+	if (psBuffer->sBufObj.psPackReadbacks)
+	{
+		Fail("buffer %u respecified with readbacks outstanding", GetBufferIndex(&psBuffer->sBufObj));
+	}
+
+	WaitUntilBufObjNotUsed(gc, &psBuffer->sBufObj);
+
+	FreeOptimisedIndices(gc, &psBuffer->sBufObj);
+
+	FillRandom(psBuffer->aui32Data, PP_BUFFER_BYTES);
+
+	memcpy(psBuffer->aui32Shadow, psBuffer->aui32Data, PP_BUFFER_BYTES);
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDraw
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Validates the active VAO as ValidateState does, then
+					  checks every buffer the draw fetches from
+************************************************************************************/
+static IMG_VOID HostDraw(GLES2Context *gc)
+{
+	GLES2VertexArrayObject *psVAO = g_psActiveVAO;
+	GLES2BufferObject *apsBufObjs[GLES2_MAX_VERTEX_ATTRIBS + 1];
+	IMG_UINT32 i;
+
+	for (i = 0; i < GLES2_MAX_VERTEX_ATTRIBS; i++)
+	{
+		apsBufObjs[i] = psVAO->asVAOState[i].psBufObj;
+	}
+
+	apsBufObjs[GLES2_MAX_VERTEX_ATTRIBS] = psVAO->psBoundElementBuffer;
+
+	for (i = 0; i <= GLES2_MAX_VERTEX_ATTRIBS; i++)
+	{
+		if (apsBufObjs[i] && apsBufObjs[i]->psPackReadbacks)
+		{
+			g_ui32NumDrawResolves++;
+
+			break;
+		}
+	}
+
+	/* As ValidateState */
+	if ((psVAO->ui32PackReadbackStamp != gc->psSharedState->ui32PackReadbackStamp) || psVAO->ui32DirtyState)
+	{
+		psVAO->ui32PackReadbackStamp = gc->psSharedState->ui32PackReadbackStamp;
+
+		ResolveVAOPackReadbacks(gc, psVAO);
+	}
+
+	psVAO->ui32DirtyState = 0;
+
+	for (i = 0; i <= GLES2_MAX_VERTEX_ATTRIBS; i++)
+	{
+		HostBuffer *psBuffer = (HostBuffer *)apsBufObjs[i];
+
+		if (!psBuffer)
+		{
+			continue;
+		}
+
+		CheckBuffer(psBuffer, (i < GLES2_MAX_VERTEX_ATTRIBS) ? "draw fetched attributes from" : "draw fetched indices from");
+
+		psBuffer->bTAPending = IMG_TRUE;
+
+		memcpy(psBuffer->aui32TACopy, psBuffer->aui32Data, PP_BUFFER_BYTES);
+	}
+
+	if (psVAO->psBoundElementBuffer)
+	{
+		HostBuffer *psBuffer = (HostBuffer *)psVAO->psBoundElementBuffer;
+
+		if (psBuffer->sBufObj.pvOptimisedIndices)
+		{
+			if (memcmp(psBuffer->sBufObj.pvOptimisedIndices, psBuffer->aui32Data, PP_BUFFER_BYTES) != 0)
+			{
+				Fail("draw used an optimised index copy of buffer %u that its readbacks made stale",
+					 GetBufferIndex(&psBuffer->sBufObj));
+			}
+		}
+		else
+		{
+			psBuffer->sBufObj.pvOptimisedIndices = malloc(PP_BUFFER_BYTES);
+
+			memcpy(psBuffer->sBufObj.pvOptimisedIndices, psBuffer->aui32Data, PP_BUFFER_BYTES);
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : HostAttach
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Points a random attribute or the element buffer of a
+					  random VAO at a random buffer, or none. Half the time the
+					  buffer is bound first, as glBindBuffer, and half the time
+					  it was bound earlier.
+************************************************************************************/
+static IMG_VOID HostAttach(GLES2Context *gc)
+{
+	GLES2VertexArrayObject *psVAO = &g_asVAOs[Random(PP_NUM_VAOS)];
+	IMG_UINT32 ui32Slot = Random(GLES2_MAX_VERTEX_ATTRIBS + 1);
+	GLES2BufferObject *psBufObj = IMG_NULL;
+
+	if (Random(4))
+	{
+		psBufObj = &g_asBuffers[Random(PP_NUM_BUFFERS)].sBufObj;
+
+		if (Random(2) && !ResolvePackBufferReadbacks(gc, psBufObj))
+		{
+			Fail("bind couldn't resolve the buffer's readbacks");
+		}
+	}
+
+	if (ui32Slot == GLES2_MAX_VERTEX_ATTRIBS)
+	{
+		psVAO->psBoundElementBuffer = psBufObj;
+	}
+	else
+	{
+		psVAO->asVAOState[ui32Slot].psBufObj = psBufObj;
+	}
+
+	psVAO->ui32DirtyState = 1;
+}
+
+
+/***********************************************************************************
+ Function Name      : HostDeleteBuffers
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : As FreeBufferObject for every buffer
+************************************************************************************/
+static IMG_VOID HostDeleteBuffers(GLES2Context *gc)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < PP_NUM_BUFFERS; i++)
+	{
+		GLES2BufferObject *psBufObj = &g_asBuffers[i].sBufObj;
+
+		WaitUntilBufObjNotUsed(gc, psBufObj);
+
+		DiscardPackBufferReadbacks(gc, psBufObj);
+
+		FreeOptimisedIndices(gc, psBufObj);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ResetRun
+ Inputs             : gc
+ Outputs            : -
+ Returns            : -
+ Description        : Picks the run's surface and fills the buffers and scene
+************************************************************************************/
+static IMG_VOID ResetRun(GLES2Context *gc)
+{
+	IMG_UINT32 ui32BytesPerPixel, i;
+
+	memset(&g_sReadParams, 0, sizeof(g_sReadParams));
+
+	g_sReadParams.ePixelFormat = g_aeSurfaceFormats[Random(sizeof(g_aeSurfaceFormats) / sizeof(g_aeSurfaceFormats[0]))];
+	g_sReadParams.eRotationAngle = Random(2) ? PVRSRV_FLIP_Y : PVRSRV_ROTATE_0;
+	g_sReadParams.ui32Width = 1 + Random(PP_MAX_WIDTH);
+	g_sReadParams.ui32Height = 1 + Random(PP_MAX_HEIGHT);
+
+	ui32BytesPerPixel = BytesPerPixel(g_sReadParams.ePixelFormat);
+
+	g_sReadParams.ui32Stride = ALIGNCOUNT(g_sReadParams.ui32Width * ui32BytesPerPixel, 4) + 4 * Random(4);
+	g_sReadParams.ui32HWSurfaceAddress = PP_SURFACE_DEVADDR;
+	g_sReadParams.psSyncInfo = &g_sSurfaceSyncInfo;
+	g_sReadParams.psRenderSurface = &g_sRenderSurface;
+
+	g_eMemLayout = g_aeMemLayouts[Random(sizeof(g_aeMemLayouts) / sizeof(g_aeMemLayouts[0]))];
+
+	gc->sAppHints.bDisableHWTQNormalBlit = (Random(16) == 0) ? IMG_TRUE : IMG_FALSE;
+
+	g_bReadDrawSurface = Random(2) ? IMG_TRUE : IMG_FALSE;
+
+	g_ui32AllocFailRate = Random(2) ? 16 : 0;
+	g_ui32QueueFailRate = Random(2) ? 16 : 0;
+
+	FillRandom(g_aui32Scene, sizeof(g_aui32Scene));
+	memcpy(g_aui32Surface, g_aui32Scene, sizeof(g_aui32Surface));
+	g_bSceneDirty = IMG_FALSE;
+
+	for (i = 0; i < PP_NUM_BUFFERS; i++)
+	{
+		HostBuffer *psBuffer = &g_asBuffers[i];
+
+		memset(&psBuffer->sBufObj, 0, sizeof(psBuffer->sBufObj));
+		memset(&psBuffer->sMemInfo, 0, sizeof(psBuffer->sMemInfo));
+
+		psBuffer->sMemInfo.pvLinAddr = psBuffer->aui32Data;
+		psBuffer->sMemInfo.uAllocSize = PP_BUFFER_BYTES;
+
+		psBuffer->sBufObj.psMemInfo = &psBuffer->sMemInfo;
+		psBuffer->sBufObj.ui32BufferSize = PP_BUFFER_BYTES;
+
+		FillRandom(psBuffer->aui32Data, PP_BUFFER_BYTES);
+		memcpy(psBuffer->aui32Shadow, psBuffer->aui32Data, PP_BUFFER_BYTES);
+
+		psBuffer->bTAPending = IMG_FALSE;
+	}
+
+	memset(g_asVAOs, 0, sizeof(g_asVAOs));
+
+	for (i = 0; i < PP_NUM_VAOS; i++)
+	{
+		g_asVAOs[i].ui32PackReadbackStamp = g_sShared.ui32PackReadbackStamp;
+	}
+
+	g_psActiveVAO = &g_asVAOs[0];
+}
+
+
+/***********************************************************************************
+ Function Name      : RunSequence
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : One random sequence on one surface
+************************************************************************************/
+static IMG_VOID RunSequence(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	static const IMG_UINT32 aui32Weights[] = {3, 4, 1, 1, 1, 3, 2, 1, 2};
+	GLES2Context *gc = &g_sContext;
+	IMG_UINT32 ui32Errors = g_ui32NumErrors;
+	IMG_UINT32 ui32Step, ui32Total = 0, i;
+
+	for (i = 0; i < sizeof(aui32Weights) / sizeof(aui32Weights[0]); i++)
+	{
+		ui32Total += aui32Weights[i];
+	}
+
+	ResetRun(gc);
+
+	for (ui32Step = 0; ui32Step < ui32Steps && g_ui32NumErrors == ui32Errors; ui32Step++)
+	{
+		HostBuffer *psBuffer = &g_asBuffers[Random(PP_NUM_BUFFERS)];
+		IMG_UINT32 ui32Pick = Random(ui32Total);
+
+		for (i = 0; ui32Pick >= aui32Weights[i]; i++)
+		{
+			ui32Pick -= aui32Weights[i];
+		}
+
+		switch (i)
+		{
+			case PP_STEP_RENDER:
+			{
+				IMG_UINT32 ui32Row = Random(g_sReadParams.ui32Height);
+				IMG_UINT32 ui32Rows = 1 + Random(g_sReadParams.ui32Height - ui32Row);
+
+				FillRandom((IMG_UINT8 *)g_aui32Scene + ui32Row * g_sReadParams.ui32Stride, ui32Rows * g_sReadParams.ui32Stride);
+
+				g_bSceneDirty = IMG_TRUE;
+
+				break;
+			}
+			case PP_STEP_READ:
+			{
+				HostReadPixels(gc, psBuffer);
+
+				break;
+			}
+			case PP_STEP_MAP:
+			{
+				HostMapBuffer(gc, psBuffer);
+
+				break;
+			}
+			case PP_STEP_SUBDATA:
+			{
+				HostBufferSubData(gc, psBuffer);
+
+				break;
+			}
+			case PP_STEP_DATA:
+			{
+				HostBufferData(gc, psBuffer);
+
+				break;
+			}
+			case PP_STEP_DRAW:
+			{
+				HostDraw(gc);
+
+				break;
+			}
+			case PP_STEP_ATTACH:
+			{
+				HostAttach(gc);
+
+				break;
+			}
+			case PP_STEP_BIND_VAO:
+			{
+				g_psActiveVAO = &g_asVAOs[Random(PP_NUM_VAOS)];
+
+				/* As glBindVertexArrayOES, which may find the VAO dirty */
+				if (Random(2))
+				{
+					g_psActiveVAO->ui32DirtyState = 1;
+				}
+
+				break;
+			}
+			case PP_STEP_RETIRE:
+			{
+				HostRetireBlits(Random(4));
+
+				break;
+			}
+		}
+
+		if (g_bPrimaryLockHeld)
+		{
+			Fail("primary lock left held");
+		}
+	}
+
+	if (Random(2))
+	{
+		for (i = 0; i < PP_NUM_BUFFERS; i++)
+		{
+			HostMapBuffer(gc, &g_asBuffers[i]);
+		}
+	}
+
+	HostDeleteBuffers(gc);
+
+	if (g_ui32NumAllocs)
+	{
+		Fail("%u staging allocations leaked", g_ui32NumAllocs);
+	}
+
+	if (g_ui32NumErrors != ui32Errors)
+	{
+		fprintf(stderr, "run %u failed at step %u\n", ui32Run, ui32Step);
+	}
+
+	/* Blits into freed staging memory were reported above */
+	HostRetireBlits(g_ui32NumBlits);
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckDrawAfterRead
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : A read into a buffer already attached to a validated VAO
+					  must land before the next draw, with no GL call between
+					  which would resolve it
+************************************************************************************/
+static IMG_VOID CheckDrawAfterRead(IMG_VOID)
+{
+	GLES2Context *gc = &g_sContext;
+	HostBuffer *psBuffer = &g_asBuffers[1];
+	IMG_UINT32 ui32Queued = g_ui32NumQueued, i, j;
+
+	ResetRun(gc);
+
+	g_sReadParams.ePixelFormat = PVRSRV_PIXEL_FORMAT_ARGB8888;
+	g_sReadParams.ui32Width = PP_MAX_WIDTH;
+	g_sReadParams.ui32Height = PP_MAX_HEIGHT;
+	g_sReadParams.ui32Stride = PP_MAX_WIDTH * 4;
+	g_eMemLayout = IMG_MEMLAYOUT_STRIDED;
+	gc->sAppHints.bDisableHWTQNormalBlit = IMG_FALSE;
+	g_ui32AllocFailRate = 0;
+	g_ui32QueueFailRate = 0;
+
+	for (i = 0; i < 2; i++)
+	{
+		/* Attribute stream, then element buffer */
+		if (i == 0)
+		{
+			g_psActiveVAO->asVAOState[3].psBufObj = &psBuffer->sBufObj;
+		}
+		else
+		{
+			g_psActiveVAO->asVAOState[3].psBufObj = IMG_NULL;
+			g_psActiveVAO->psBoundElementBuffer = &psBuffer->sBufObj;
+		}
+
+		g_psActiveVAO->ui32DirtyState = 1;
+
+		HostDraw(gc);
+
+		FillRandom(g_aui32Scene, sizeof(g_aui32Scene));
+		g_bSceneDirty = IMG_TRUE;
+
+		for (j = 0; j < 64 && g_ui32NumQueued == ui32Queued; j++)
+		{
+			HostReadPixels(gc, psBuffer);
+		}
+
+		if (g_ui32NumQueued == ui32Queued)
+		{
+			Fail("no read of a %ux%u ARGB8888 surface was queued", PP_MAX_WIDTH, PP_MAX_HEIGHT);
+		}
+
+		ui32Queued = g_ui32NumQueued;
+
+		HostDraw(gc);
+	}
+
+	HostDeleteBuffers(gc);
+	HostRetireBlits(g_ui32NumBlits);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = PP_DEFAULT_RUNS, ui32Steps = PP_DEFAULT_STEPS;
+	IMG_UINT32 ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			ui32Steps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: pixelpack [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	g_sShared.hPrimaryLock = (PVRSRV_MUTEX_HANDLE)&g_ui32PrimaryLock;
+
+	g_sSysContext.hTransferContext = (IMG_HANDLE)&g_ui32TransferContext;
+
+	g_sContext.psSysContext = &g_sSysContext;
+	g_sContext.psSharedState = &g_sShared;
+	g_sContext.psReadParams = &g_sReadParams;
+
+	CheckDrawAfterRead();
+
+	printf("draw after read checked\n");
+
+	for (i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunSequence(i, ui32Steps);
+	}
+
+	printf("%u sequences of %u calls (seed %u): %u reads queued, %u synchronous, "
+		   "%u draws resolved readbacks, %u fence waits timed out\n",
+		   i, ui32Steps, ui32Seed, g_ui32NumQueued, g_ui32NumSync, g_ui32NumDrawResolves, g_ui32NumTimeouts);
+
+	if (ui32Runs && !g_ui32NumErrors && (!g_ui32NumQueued || !g_ui32NumDrawResolves))
+	{
+		Fail("the sequences never queued a read a draw had to resolve");
+	}
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
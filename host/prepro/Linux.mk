@@ -0,0 +1,74 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without
+# the express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test and benchmark of the GLSL lexer and preprocessor. It checks the
+# hashed symbol table lookups against the linear scan, checks macro
+# expansion on generated shaders, then reports preprocessing throughput in
+# tokens per second as the number of #defines grows. Run it with no
+# arguments; it exits non-zero if any result differs.
+#
+
+modules := prepro
+
+prepro_type := host_executable
+
+prepro_src = \
+ main.c \
+ $(TOP)/intermediates/glslparser/glsl_parser.tab.c \
+ $(TOP)/tools/intern/oglcompiler/binshader/esbinshader.c \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/glsl/, \
+  astbuiltin.c common.c error.c glsl.c glslfns.c glsltabs.c glsltree.c \
+  icbuiltin.c icemul.c icgen.c icode.c icunroll.c prepro.c semantic.c) \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/parser/, \
+  glsldebug.c lex.c memmgr.c parser_metrics.c parser.c symtab.c) \
+ $(addprefix $(TOP)/tools/intern/oglcompiler/powervr/, \
+  bindingsym.c glsl2uf.c ic2uf.c) \
+ $(addprefix $(TOP)/tools/intern/usc2/, \
+  asm.c cdg.c cfa.c data.c dce.c debug.c dgraph.c domcalc.c dualissue.c \
+  efo.c execpred.c f16opt.c finalise.c groupinst.c hw.c icvt_c10.c \
+  icvt_core.c icvt_f16.c icvt_f16_vec.c icvt_f32.c icvt_f32_vec.c \
+  icvt_i32.c icvt_mem.c indexreg.c inst_usc.c intcvt.c iregalloc.c \
+  iselect.c layout.c pconvert.c precovr.c pregalloc.c regalloc.c \
+  reggroup.c regpack.c reorder.c ssa.c usc.c usc_utils.c usedef.c \
+  uspbin.c vec34.c) \
+ $(addprefix $(TOP)/tools/intern/useasm/, \
+  specialregs.c specialregs_vec.c useasm.c usedisasm.c useopt.c usetab.c \
+  utils.c) \
+ $(addprefix $(TOP)/tools/intern/usp/, \
+  hwinst.c usp.c usp_finalise.c usp_inputdata.c usp_instblock.c \
+  usp_resultref.c usp_sample.c usp_texwrite.c uspshader.c)
+
+# The preprocessor needs an initialised compiler, so this links the same
+# compiler stack as host/esbincompiler, built with the same defines.
+prepro_cflags := \
+ -DLINUX -DUSER -D'IMG_ABORT()=abort()' -DSTANDALONE -DGLSL_ES -DGEN_HW_CODE -DOUTPUT_USPBIN \
+ -DINCLUDE_SGX_FEATURE_TABLE -DINCLUDE_SGX_BUG_TABLE -DSUPPORT_SGX543 \
+ -DSUPPORT_BINARY_SHADER -DSUPPORT_SOURCE_SHADER \
+ -DGLES2_EXTENSION_GET_PROGRAM_BINARY \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h
+
+# eurasiacon/opengles2 is only searched for constants.h and must come last:
+# its metrics.h would otherwise shadow the compiler's.
+prepro_includes := include/gpu_es4 \
+ include/gpu_es4/eurasia/hwdefs include/gpu_es4/eurasia/include4 \
+ tools/intern/usp tools/intern/usc2 tools/intern/useasm \
+ tools/intern/oglcompiler/glsl tools/intern/oglcompiler/parser \
+ tools/intern/oglcompiler/powervr tools/intern/oglcompiler/binshader \
+ intermediates/glslparser intermediates/sgxsupport intermediates/errata \
+ eurasiacon/opengles2
+
+prepro_extlibs := m
+
+ifeq ($(BUILD),debug)
+prepro_cflags += -DDEBUG -DDUMP_LOGFILES
+endif
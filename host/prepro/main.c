@@ -0,0 +1,839 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : GLSL preprocessor test and throughput benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : The first part runs random sequences of adds, duplicate
+ *                adds, removes and lookups on two symbol tables (symtab.c),
+ *                one with the hashed name index the preprocessor uses and
+ *                one without. Both must give the same result and symbol
+ *                index for every call, through table growth, index growth
+ *                and the scope changes that drop the index.
+ *
+ *                The second part generates shaders with object-like,
+ *                function-like and chained macros, #undef, redefinition,
+ *                #ifdef/#else and #if defined(), runs them through the
+ *                lexer and preprocessor (CreateParseContext) and checks the
+ *                identifiers and integers that come out against the
+ *                expansion the generator expects.
+ *
+ *                The last part times the lexer and preprocessor on the same
+ *                kind of shader as the number of #defines grows and reports
+ *                source tokens per second.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+
+#include "glsl2uf.h"
+#include "parser.h"
+#include "prepro.h"
+#include "error.h"
+
+/* Resource limits are shared with the driver */
+#include "constants.h"
+
+
+#define PP_DEFAULT_RUNS			200
+#define PP_DEFAULT_STEPS		2000
+#define PP_DEFAULT_SHADERS		50
+#define PP_DEFAULT_DEFINES		2000
+#define PP_DEFAULT_REPS			10
+
+/* Integer constants the #ifdef and #if blocks leave in the output */
+#define PP_IFDEF_TAKEN			1111
+#define PP_IFDEF_NOT_TAKEN		2222
+#define PP_IF_TAKEN				3333
+
+/* A growable string */
+typedef struct _PP_STRING_
+{
+	IMG_CHAR	*pszData;
+	IMG_UINT32	uLength;
+	IMG_UINT32	uSize;
+
+} PP_STRING;
+
+/* Macro state the shader generator tracks */
+typedef struct _PP_MACRO_
+{
+	/* Current value of M<n>, or -1 while it is undefined */
+	IMG_INT32	iValue;
+	/* Constant added by F<n>(a, b), or -1 if F<n> isn't defined */
+	IMG_INT32	iFuncConstant;
+	/* Index of the M macro C<n> expands to, or -1 if C<n> isn't defined */
+	IMG_INT32	iChainTarget;
+
+} PP_MACRO;
+
+static IMG_UINT32 g_uNumErrors;
+static IMG_UINT32 g_uRandom = 1;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N       Random symbol table sequences (default 200).\n"
+"-steps=N      Operations per sequence (default 2000).\n"
+"-shaders=N    Generated shaders checked through the preprocessor (default 50).\n"
+"-defines=N    #defines in the largest timed shader (default 2000).\n"
+"-reps=N       Preprocessor runs timed per shader (default 10, 0 to only check).\n"
+"-seed=N       Seed for the sequences and shaders (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_uNumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : uRange
+ Outputs            : -
+ Returns            : Pseudo-random number below uRange
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 uRange)
+{
+	g_uRandom ^= g_uRandom << 13;
+	g_uRandom ^= g_uRandom >> 17;
+	g_uRandom ^= g_uRandom << 5;
+
+	return g_uRandom % uRange;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/***********************************************************************************
+ Function Name      : Append
+ Inputs             : psString, pszFormat, ...
+ Outputs            : psString
+ Returns            : -
+ Description        : printf onto the end of a growable string
+************************************************************************************/
+static IMG_VOID Append(PP_STRING *psString, const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+	int iLength;
+
+	for (;;)
+	{
+		IMG_UINT32 uSpace = psString->uSize - psString->uLength;
+
+		va_start(sArgs, pszFormat);
+		iLength = vsnprintf(psString->pszData + psString->uLength, uSpace, pszFormat, sArgs);
+		va_end(sArgs);
+
+		if (iLength >= 0 && (IMG_UINT32)iLength < uSpace)
+		{
+			psString->uLength += (IMG_UINT32)iLength;
+			return;
+		}
+
+		psString->uSize = psString->uSize ? psString->uSize * 2 : 4096;
+		psString->pszData = realloc(psString->pszData, psString->uSize);
+
+		if (psString->pszData == NULL)
+		{
+			fprintf(stderr, "error: out of memory\n");
+			exit(1);
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CountSourceTokens
+ Inputs             : pszSource
+ Outputs            : -
+ Returns            : Number of tokens in the source
+ Description        : Each identifier or number counts as one token, as does
+                      every other character that isn't white space. This is
+                      the count the throughput is reported against.
+************************************************************************************/
+static IMG_UINT32 CountSourceTokens(const IMG_CHAR *pszSource)
+{
+	IMG_UINT32 uNumTokens = 0;
+	IMG_BOOL bInWord = IMG_FALSE;
+
+	for (; *pszSource; pszSource++)
+	{
+		IMG_CHAR c = *pszSource;
+
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')
+		{
+			if (!bInWord)
+			{
+				uNumTokens++;
+				bInWord = IMG_TRUE;
+			}
+		}
+		else
+		{
+			bInWord = IMG_FALSE;
+
+			if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+			{
+				uNumTokens++;
+			}
+		}
+	}
+
+	return uNumTokens;
+}
+
+
+/*
+** Symbol table sequences
+*/
+
+/***********************************************************************************
+ Function Name      : ReleaseSymbolData
+ Inputs             : pvData
+ Outputs            : -
+ Returns            : -
+ Description        : Symbol deconstructor; the test data is never allocated
+************************************************************************************/
+static IMG_VOID ReleaseSymbolData(IMG_VOID *pvData)
+{
+	PVR_UNREFERENCED_PARAMETER(pvData);
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckFind
+ Inputs             : psHashed, psLinear, pszName, bCurrentScopeOnly
+ Outputs            : -
+ Returns            : IMG_TRUE if the symbol was found
+ Description        : Looks a name up in both tables and checks they agree
+************************************************************************************/
+static IMG_BOOL CheckFind(SymTable *psHashed, SymTable *psLinear, IMG_CHAR *pszName, IMG_BOOL bCurrentScopeOnly)
+{
+	IMG_UINT32 uHashedID = 0, uLinearID = 0;
+	IMG_BOOL bHashed, bLinear;
+
+	bHashed = FindSymbol(psHashed, pszName, &uHashedID, bCurrentScopeOnly);
+	bLinear = FindSymbol(psLinear, pszName, &uLinearID, bCurrentScopeOnly);
+
+	if (bHashed != bLinear)
+	{
+		Fail("'%s' found %s with the index, %s without", pszName, bHashed ? "yes" : "no", bLinear ? "yes" : "no");
+		return IMG_FALSE;
+	}
+
+	if (!bHashed)
+	{
+		return IMG_FALSE;
+	}
+
+	if ((uHashedID & psHashed->uSymbolIDMask) != (uLinearID & psLinear->uSymbolIDMask))
+	{
+		Fail("'%s' found at entry %u with the index, %u without", pszName,
+			 uHashedID & psHashed->uSymbolIDMask, uLinearID & psLinear->uSymbolIDMask);
+		return IMG_FALSE;
+	}
+
+	if (strcmp(GetSymbolName(psHashed, uHashedID), pszName) != 0)
+	{
+		Fail("'%s' found as '%s'", pszName, GetSymbolName(psHashed, uHashedID));
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunSymTableSequence
+ Inputs             : uRun, uSteps
+ Outputs            : -
+ Returns            : -
+ Description        : Runs one random sequence on a hashed and a plain table
+************************************************************************************/
+static IMG_VOID RunSymTableSequence(IMG_UINT32 uRun, IMG_UINT32 uSteps)
+{
+	SymbolTableContext *psContext;
+	SymTable *psHashed, *psLinear;
+	IMG_UINT32 uNumNames = 1 + Random(Random(4) ? 300 : 4000);
+	IMG_UINT32 uInitialSize = 1 + Random(64);
+	IMG_UINT32 uNumBuckets = 1 + Random(Random(2) ? 4 : 512);
+	IMG_UINT32 i;
+	/* Most runs stay flat, as the preprocessor's table does, so the index is kept throughout */
+	IMG_BOOL bAllowScopes = (Random(4) == 0) ? IMG_TRUE : IMG_FALSE;
+	IMG_BOOL bScoped = IMG_FALSE;
+	IMG_CHAR acName[32];
+
+	psContext = InitSymbolTableManager();
+	psHashed  = CreateSymTable(psContext, "Hashed", uInitialSize, GLSL_NUM_BITS_FOR_SYMBOL_IDS, IMG_NULL);
+	psLinear  = CreateSymTable(psContext, "Linear", uInitialSize, GLSL_NUM_BITS_FOR_SYMBOL_IDS, IMG_NULL);
+
+	if (!psContext || !psHashed || !psLinear)
+	{
+		Fail("run %u: couldn't create the symbol tables", uRun);
+		return;
+	}
+
+	if (!EnableSymTableHashing(psHashed, uNumBuckets))
+	{
+		Fail("run %u: couldn't index an empty table", uRun);
+	}
+
+	for (i = 0; i < uSteps && !g_uNumErrors; i++)
+	{
+		IMG_UINT32 uOperation = Random(100);
+		IMG_UINT32 uName = Random(uNumNames);
+
+		/* Vary the name lengths so the hashes see more than a changing suffix */
+		sprintf(acName, (uName & 3) ? "M%u" : "macro_%u_name", uName);
+
+		if (uOperation < 40)
+		{
+			IMG_UINT32 uHashedID = 0, uLinearID = 0;
+			IMG_BOOL bAllowDuplicates = (IMG_BOOL)Random(2);
+			IMG_BOOL bHashed, bLinear;
+
+			bHashed = AddSymbol(psHashed, acName, IMG_NULL, 0, bAllowDuplicates, &uHashedID, ReleaseSymbolData);
+			bLinear = AddSymbol(psLinear, acName, IMG_NULL, 0, bAllowDuplicates, &uLinearID, ReleaseSymbolData);
+
+			if (bHashed != bLinear)
+			{
+				Fail("run %u step %u: adding '%s' %s with the index, %s without", uRun, i, acName,
+					 bHashed ? "succeeded" : "failed", bLinear ? "succeeded" : "failed");
+			}
+			else if (bHashed && (uHashedID & psHashed->uSymbolIDMask) != (uLinearID & psLinear->uSymbolIDMask))
+			{
+				Fail("run %u step %u: '%s' added at entry %u with the index, %u without", uRun, i, acName,
+					 uHashedID & psHashed->uSymbolIDMask, uLinearID & psLinear->uSymbolIDMask);
+			}
+		}
+		else if (uOperation < 55)
+		{
+			IMG_UINT32 uHashedID, uLinearID;
+
+			/* Remove one reference, as #undef does */
+			if (CheckFind(psHashed, psLinear, acName, IMG_FALSE) &&
+				FindSymbol(psHashed, acName, &uHashedID, IMG_FALSE) &&
+				FindSymbol(psLinear, acName, &uLinearID, IMG_FALSE))
+			{
+				if (!RemoveSymbol(psHashed, uHashedID) || !RemoveSymbol(psLinear, uLinearID))
+				{
+					Fail("run %u step %u: couldn't remove '%s'", uRun, i, acName);
+				}
+			}
+		}
+		else if (uOperation < 99 || !bAllowScopes || bScoped || !psHashed->uNumEntries)
+		{
+			CheckFind(psHashed, psLinear, acName, (IMG_BOOL)Random(2));
+		}
+		else
+		{
+			/*
+				A scope change must drop the index, after which both tables scan.
+				The scan reads the entry before a scope modifier, so like the
+				compiler's tables this never opens a scope on an empty table.
+			*/
+			bScoped = IMG_TRUE;
+
+			if (!IncreaseScopeLevel(psHashed) || !IncreaseScopeLevel(psLinear))
+			{
+				Fail("run %u step %u: couldn't increase the scope level", uRun, i);
+			}
+
+			if (psHashed->puHashBuckets)
+			{
+				Fail("run %u step %u: the name index survived a scope change", uRun, i);
+			}
+		}
+	}
+
+	/* Every name once more, then check the index only goes on empty tables */
+	for (i = 0; i < uNumNames && !g_uNumErrors; i++)
+	{
+		sprintf(acName, (i & 3) ? "M%u" : "macro_%u_name", i);
+
+		CheckFind(psHashed, psLinear, acName, IMG_FALSE);
+	}
+
+	if (psHashed->uNumEntries && EnableSymTableHashing(psLinear, uNumBuckets))
+	{
+		Fail("run %u: indexed a table that already has entries", uRun);
+	}
+
+	if (!bScoped && psHashed->uNumEntries > (psHashed->uHashMask + 1) * 2)
+	{
+		Fail("run %u: %u entries in %u chains, the index didn't grow", uRun,
+			 psHashed->uNumEntries, psHashed->uHashMask + 1);
+	}
+
+	RemoveSymbolTableFromManager(psContext, psHashed);
+	RemoveSymbolTableFromManager(psContext, psLinear);
+	DestroySymTable(psHashed);
+	DestroySymTable(psLinear);
+	DestroySymbolTableManager(psContext);
+}
+
+
+/*
+** Generated shaders
+*/
+
+/***********************************************************************************
+ Function Name      : AppendExpansion
+ Inputs             : psExpected, psMacros, uMacro
+ Outputs            : psExpected
+ Returns            : -
+ Description        : Appends what M<uMacro> currently expands to
+************************************************************************************/
+static IMG_VOID AppendExpansion(PP_STRING *psExpected, const PP_MACRO *psMacros, IMG_UINT32 uMacro)
+{
+	if (psMacros[uMacro].iValue >= 0)
+	{
+		Append(psExpected, "%d ", psMacros[uMacro].iValue);
+	}
+	else
+	{
+		Append(psExpected, "M%u ", uMacro);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : GenerateShader
+ Inputs             : uNumDefines
+ Outputs            : psSource, psExpected
+ Returns            : -
+ Description        : Writes a shader with uNumDefines object-like macros and
+                      a quarter as many function-like and chained ones, then a
+                      body that uses, redefines and tests them. psExpected gets
+                      the identifiers and integers the preprocessed body
+                      should contain, separated by spaces.
+************************************************************************************/
+static IMG_VOID GenerateShader(IMG_UINT32 uNumDefines, PP_STRING *psSource, PP_STRING *psExpected)
+{
+	PP_MACRO *psMacros = calloc(uNumDefines, sizeof(PP_MACRO));
+	IMG_UINT32 uNumLines = uNumDefines / 2 + 8, i;
+
+	if (psMacros == NULL)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	psSource->uLength = 0;
+	psExpected->uLength = 0;
+
+	Append(psSource, "");
+	Append(psExpected, "");
+
+	for (i = 0; i < uNumDefines; i++)
+	{
+		psMacros[i].iValue = (IMG_INT32)Random(100000);
+		psMacros[i].iFuncConstant = -1;
+		psMacros[i].iChainTarget = -1;
+
+		Append(psSource, "#define M%u %d\n", i, psMacros[i].iValue);
+
+		if (Random(4) == 0)
+		{
+			psMacros[i].iFuncConstant = (IMG_INT32)Random(1000);
+
+			Append(psSource, "#define F%u(a, b) (a * b + %d)\n", i, psMacros[i].iFuncConstant);
+		}
+
+		if (Random(4) == 0)
+		{
+			/* Chains are expanded when used, so they see later redefinitions */
+			psMacros[i].iChainTarget = (IMG_INT32)Random(uNumDefines);
+
+			Append(psSource, "#define C%u M%d\n", i, psMacros[i].iChainTarget);
+		}
+	}
+
+	for (i = 0; i < uNumLines; i++)
+	{
+		IMG_UINT32 uOperation = Random(100);
+		IMG_UINT32 uMacro = Random(uNumDefines);
+		IMG_UINT32 uOther = Random(uNumDefines);
+
+		if (uOperation < 35)
+		{
+			Append(psSource, "x = M%u;\n", uMacro);
+			Append(psExpected, "x ");
+			AppendExpansion(psExpected, psMacros, uMacro);
+		}
+		else if (uOperation < 50 && psMacros[uMacro].iChainTarget >= 0)
+		{
+			Append(psSource, "y = C%u;\n", uMacro);
+			Append(psExpected, "y ");
+			AppendExpansion(psExpected, psMacros, (IMG_UINT32)psMacros[uMacro].iChainTarget);
+		}
+		else if (uOperation < 62 && psMacros[uMacro].iFuncConstant >= 0)
+		{
+			Append(psSource, "z = F%u(M%u, 3);\n", uMacro, uOther);
+			Append(psExpected, "z ");
+			AppendExpansion(psExpected, psMacros, uOther);
+			Append(psExpected, "3 %d ", psMacros[uMacro].iFuncConstant);
+		}
+		else if (uOperation < 72)
+		{
+			if (psMacros[uMacro].iValue >= 0)
+			{
+				Append(psSource, "#undef M%u\n", uMacro);
+			}
+
+			psMacros[uMacro].iValue = (IMG_INT32)Random(100000);
+
+			Append(psSource, "#define M%u %d\n", uMacro, psMacros[uMacro].iValue);
+		}
+		else if (uOperation < 78)
+		{
+			if (psMacros[uMacro].iValue >= 0)
+			{
+				Append(psSource, "#undef M%u\n", uMacro);
+
+				psMacros[uMacro].iValue = -1;
+			}
+		}
+		else if (uOperation < 90)
+		{
+			Append(psSource, "#ifdef M%u\nw = %u;\n#else\nw = %u;\n#endif\n", uMacro, PP_IFDEF_TAKEN, PP_IFDEF_NOT_TAKEN);
+			Append(psExpected, "w %u ", (psMacros[uMacro].iValue >= 0) ? PP_IFDEF_TAKEN : PP_IFDEF_NOT_TAKEN);
+		}
+		else
+		{
+			Append(psSource, "#if defined(M%u) && defined(M%u)\nv = %u;\n#endif\n", uMacro, uOther, PP_IF_TAKEN);
+
+			if (psMacros[uMacro].iValue >= 0 && psMacros[uOther].iValue >= 0)
+			{
+				Append(psExpected, "v %u ", PP_IF_TAKEN);
+			}
+		}
+	}
+
+	free(psMacros);
+}
+
+
+/***********************************************************************************
+ Function Name      : Preprocess
+ Inputs             : psInitCompilerContext, pszSource
+ Outputs            : -
+ Returns            : Parse context holding the preprocessed tokens, or NULL
+ Description        : Runs the lexer and preprocessor the way
+                      GLSLCompileToIntermediateCode does
+************************************************************************************/
+static ParseContext *Preprocess(GLSLInitCompilerContext *psInitCompilerContext, IMG_CHAR *pszSource)
+{
+	GLSLCompilerPrivateData *psCPD = (GLSLCompilerPrivateData *)psInitCompilerContext->pvCompilerPrivateData;
+	ErrorLog sErrorLog;
+	ParseContext *psParseContext;
+
+	SetErrorLog(&sErrorLog, IMG_FALSE);
+
+	psCPD->psErrorLog = &sErrorLog;
+
+	psParseContext = CreateParseContext((IMG_VOID *)psCPD, &pszSource, 1);
+
+	if (psParseContext == NULL || (sErrorLog.uNumProgramErrorMessages || sErrorLog.uNumInternalErrorMessages))
+	{
+		DisplayErrorMessages(&sErrorLog, ERRORTYPE_ALL);
+
+		if (psParseContext)
+		{
+			PPDestroyPreProcessorData(psParseContext->pvPreProcessorData);
+			DestroyParseContext(psParseContext);
+			psParseContext = NULL;
+		}
+	}
+
+	FreeErrorLogMessages(&sErrorLog);
+
+	psCPD->psErrorLog = IMG_NULL;
+
+	return psParseContext;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckShader
+ Inputs             : psInitCompilerContext, uShader, uNumDefines
+ Outputs            : -
+ Returns            : -
+ Description        : Preprocesses one generated shader and compares the
+                      identifiers and integers that come out with the
+                      expected expansion
+************************************************************************************/
+static IMG_VOID CheckShader(GLSLInitCompilerContext *psInitCompilerContext, IMG_UINT32 uShader, IMG_UINT32 uNumDefines)
+{
+	PP_STRING sSource = {NULL, 0, 0}, sExpected = {NULL, 0, 0}, sActual = {NULL, 0, 0};
+	ParseContext *psParseContext;
+	IMG_UINT32 i;
+
+	GenerateShader(uNumDefines, &sSource, &sExpected);
+
+	psParseContext = Preprocess(psInitCompilerContext, sSource.pszData);
+
+	if (psParseContext == NULL)
+	{
+		Fail("shader %u (%u defines): preprocessing failed", uShader, uNumDefines);
+	}
+	else
+	{
+		Append(&sActual, "");
+
+		for (i = 0; i < psParseContext->uNumTokens; i++)
+		{
+			const Token *psToken = &psParseContext->psTokenList[i];
+
+			if ((psToken->eTokenName == TOK_IDENTIFIER || psToken->eTokenName == TOK_INTCONSTANT) && psToken->pvData)
+			{
+				Append(&sActual, "%s ", psToken->pvData);
+			}
+		}
+
+		if (strcmp(sActual.pszData, sExpected.pszData) != 0)
+		{
+			IMG_UINT32 uOffset = 0;
+
+			while (sActual.pszData[uOffset] && sActual.pszData[uOffset] == sExpected.pszData[uOffset])
+			{
+				uOffset++;
+			}
+
+			uOffset = (uOffset > 40) ? uOffset - 40 : 0;
+
+			Fail("shader %u (%u defines): expanded to\n  ...%.80s\nrather than\n  ...%.80s", uShader, uNumDefines,
+				 sActual.pszData + uOffset, sExpected.pszData + uOffset);
+		}
+
+		PPDestroyPreProcessorData(psParseContext->pvPreProcessorData);
+		DestroyParseContext(psParseContext);
+	}
+
+	free(sSource.pszData);
+	free(sExpected.pszData);
+	free(sActual.pszData);
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeShader
+ Inputs             : psInitCompilerContext, uNumDefines, uReps
+ Outputs            : -
+ Returns            : -
+ Description        : Times the lexer and preprocessor on one generated shader
+************************************************************************************/
+static IMG_VOID TimeShader(GLSLInitCompilerContext *psInitCompilerContext, IMG_UINT32 uNumDefines, IMG_UINT32 uReps)
+{
+	PP_STRING sSource = {NULL, 0, 0}, sExpected = {NULL, 0, 0};
+	IMG_UINT32 uNumTokens, i;
+	double fStart, fBest = 0.0;
+
+	GenerateShader(uNumDefines, &sSource, &sExpected);
+
+	uNumTokens = CountSourceTokens(sSource.pszData);
+
+	for (i = 0; i < uReps && !g_uNumErrors; i++)
+	{
+		ParseContext *psParseContext;
+		double fTime;
+
+		fStart = GetSeconds();
+
+		psParseContext = Preprocess(psInitCompilerContext, sSource.pszData);
+
+		if (psParseContext)
+		{
+			PPDestroyPreProcessorData(psParseContext->pvPreProcessorData);
+			DestroyParseContext(psParseContext);
+		}
+		else
+		{
+			Fail("%u defines: preprocessing failed", uNumDefines);
+		}
+
+		fTime = GetSeconds() - fStart;
+
+		if (i == 0 || fTime < fBest)
+		{
+			fBest = fTime;
+		}
+	}
+
+	if (uReps && !g_uNumErrors)
+	{
+		printf("%6u defines: %7u tokens, %6u bytes, best of %u: %9.3f ms, %6.2f Mtokens/s\n",
+			   uNumDefines, uNumTokens, sSource.uLength, uReps, fBest * 1000.0,
+			   fBest > 0.0 ? (double)uNumTokens / fBest / 1e6 : 0.0);
+	}
+
+	free(sSource.pszData);
+	free(sExpected.pszData);
+}
+
+
+/***********************************************************************************
+ Function Name      : InitCompiler
+ Inputs             : -
+ Outputs            : psInitCompilerContext
+ Returns            : Success
+ Description        : Initialises the GLSL compiler with the driver's resources
+************************************************************************************/
+static IMG_BOOL InitCompiler(GLSLInitCompilerContext *psInitCompilerContext)
+{
+	GLSLCompilerResources *psResources;
+
+	memset(psInitCompilerContext, 0, sizeof(GLSLInitCompilerContext));
+
+	psInitCompilerContext->eLogFiles = GLSLLF_NOT_LOG;
+
+	psResources = &psInitCompilerContext->sCompilerResources;
+	psResources->iGLMaxVertexAttribs = GLES2_MAX_VERTEX_ATTRIBS;
+	psResources->iGLMaxVertexUniformVectors = GLES2_MAX_VERTEX_UNIFORM_VECTORS;
+	psResources->iGLMaxVaryingVectors = GLES2_MAX_VARYING_VECTORS;
+	psResources->iGLMaxVertexTextureImageUnits = GLES2_MAX_VERTEX_TEXTURE_UNITS;
+	psResources->iGLMaxCombinedTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxTextureImageUnits = GLES2_MAX_TEXTURE_UNITS;
+	psResources->iGLMaxFragmentUniformVectors = GLES2_MAX_FRAGMENT_UNIFORM_VECTORS;
+	psResources->iGLMaxDrawBuffers = GLES2_MAX_DRAW_BUFFERS;
+
+	return GLSLInitCompiler(psInitCompilerContext);
+}
+
+
+int main(int argc, char* argv[])
+{
+	GLSLInitCompilerContext sInitCompilerContext;
+	IMG_UINT32 uRuns = PP_DEFAULT_RUNS, uSteps = PP_DEFAULT_STEPS, uNumShaders = PP_DEFAULT_SHADERS;
+	IMG_UINT32 uNumDefines = PP_DEFAULT_DEFINES, uReps = PP_DEFAULT_REPS, uSeed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			uRuns = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			uSteps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-shaders=", strlen("-shaders=")) == 0)
+		{
+			uNumShaders = strtoul(argv[1] + strlen("-shaders="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-defines=", strlen("-defines=")) == 0)
+		{
+			uNumDefines = strtoul(argv[1] + strlen("-defines="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-reps=", strlen("-reps=")) == 0)
+		{
+			uReps = strtoul(argv[1] + strlen("-reps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			uSeed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: prepro [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	if (uNumDefines < 1)
+	{
+		fprintf(stderr, "error: shaders need at least 1 define\n");
+		return 1;
+	}
+
+	g_uRandom = uSeed ? uSeed : 1;
+
+	for (i = 0; i < uRuns && !g_uNumErrors; i++)
+	{
+		RunSymTableSequence(i, uSteps);
+	}
+
+	printf("%u symbol table sequences of %u steps\n", i, uSteps);
+
+	if (!InitCompiler(&sInitCompilerContext))
+	{
+		fprintf(stderr, "error: failed to initialise the GLSL compiler\n");
+		return 1;
+	}
+
+	for (i = 0; i < uNumShaders && !g_uNumErrors; i++)
+	{
+		/* Mostly small shaders, with the odd one past the initial table and index sizes */
+		CheckShader(&sInitCompilerContext, i, 1 + Random(Random(8) ? 64 : 1000));
+	}
+
+	printf("%u generated shaders checked\n", i);
+
+	/* Smaller shaders first to show how the cost scales, then the requested size */
+	for (i = (uNumDefines >= 100) ? uNumDefines / 100 : 1; i < uNumDefines && !g_uNumErrors; i *= 10)
+	{
+		TimeShader(&sInitCompilerContext, i, uReps);
+	}
+
+	if (!g_uNumErrors)
+	{
+		TimeShader(&sInitCompilerContext, uNumDefines, uReps);
+	}
+
+	GLSLShutDownCompiler(&sInitCompilerContext);
+
+	printf("%s\n", g_uNumErrors ? "FAILED" : "PASSED");
+
+	return g_uNumErrors ? 1 : 0;
+}
+
+/******************************************************************************
+ End of file (main.c)
+******************************************************************************/
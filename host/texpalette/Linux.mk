@@ -0,0 +1,38 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the GLES1 paletted texture expanders. It checks them bit for
+# bit against the per-texel expansion they replaced, and times both. It
+# exits non-zero if any output differs.
+#
+
+modules := texpalette
+
+texpalette_type := host_executable
+
+texpalette_src = \
+ main.c \
+ reference.c \
+ $(TOP)/eurasiacon/opengles1/texpalette.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header.
+texpalette_cflags := \
+ -DLINUX -DUSER \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/texpalette/hostcontext.h
+
+texpalette_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles1 \
+ intermediates/sgxsupport
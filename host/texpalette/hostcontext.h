@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES1 context for the palette test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of texpalette.c in place of the GLES1
+ *                driver's context.h, whose include guard it defines. The
+ *                expanders need only the GL and IMG types. texture.h pulls
+ *                in the whole driver, so its palette prototypes are
+ *                repeated here.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "services.h"
+
+#include "ogles_types.h"
+
+#include "drvgl.h"
+#include "drvglext.h"
+
+/* As texture.h */
+typedef IMG_VOID (*PFNExpandPaletteLevel)(IMG_VOID *, const IMG_UINT8 *, IMG_UINT32, const IMG_UINT32 *);
+
+IMG_VOID BuildPaletteLUT(IMG_UINT32 *pui32LUT, GLenum eInternalFormat, const IMG_VOID *pvPalette,
+			 IMG_UINT32 ui32SrcBitsPerPixel, IMG_UINT32 ui32DstBytesPerTexel);
+
+IMG_VOID ExpandPalette4Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette4Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette8Level16bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+IMG_VOID ExpandPalette8Level32bpp(IMG_VOID *pvDest, const IMG_UINT8 *pui8Src, IMG_UINT32 ui32NumTexels,
+				  const IMG_UINT32 *pui32LUT);
+
+#endif /* _CONTEXT_ */
@@ -0,0 +1,378 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Paletted texture expansion test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Expands random GL_OES_compressed_paletted_texture images
+ *                with the lookup table expanders (texpalette.c) and with the
+ *                per-texel functions they replaced (reference.c), and fails
+ *                if any level differs by a single bit or either writes past
+ *                the end of the level.
+ *
+ *                Every paletted format is run for every power of two size
+ *                from 1x1 to 256x256, including 1xN and Nx1, as a full mip
+ *                chain walked the way glCompressedTexImage2D walks it, with
+ *                the palette at each of the four byte alignments.
+ *
+ *                Afterwards each format's 256x256 level is timed both ways.
+ *                The new path includes building the table, which the driver
+ *                does once per upload.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hostcontext.h"
+#include "reference.h"
+
+
+#define TP_MAX_SIZE_LOG2			8
+#define TP_MAX_SIZE					(1U << TP_MAX_SIZE_LOG2)
+#define TP_DEFAULT_REPEATS			50
+
+/* Bytes checked past the end of each expanded level */
+#define TP_GUARD_SIZE				16
+#define TP_GUARD_VALUE				0xA5
+
+typedef struct _TP_FORMAT_
+{
+	GLenum				eInternalFormat;
+	const IMG_CHAR		*pszName;
+	IMG_UINT32			ui32SrcBitsPerPixel;
+	IMG_UINT32			ui32PaletteSize;
+	IMG_UINT32			ui32DstBytesPerTexel;
+
+} TP_FORMAT;
+
+static const TP_FORMAT g_asFormats[] =
+{
+	{GL_PALETTE4_RGB8_OES,		"PALETTE4_RGB8",		4, 3 * 16,	4},
+	{GL_PALETTE4_RGBA8_OES,		"PALETTE4_RGBA8",		4, 4 * 16,	4},
+	{GL_PALETTE4_R5_G6_B5_OES,	"PALETTE4_R5_G6_B5",	4, 2 * 16,	2},
+	{GL_PALETTE4_RGBA4_OES,		"PALETTE4_RGBA4",		4, 2 * 16,	2},
+	{GL_PALETTE4_RGB5_A1_OES,	"PALETTE4_RGB5_A1",		4, 2 * 16,	2},
+	{GL_PALETTE8_RGB8_OES,		"PALETTE8_RGB8",		8, 3 * 256,	4},
+	{GL_PALETTE8_RGBA8_OES,		"PALETTE8_RGBA8",		8, 4 * 256,	4},
+	{GL_PALETTE8_R5_G6_B5_OES,	"PALETTE8_R5_G6_B5",	8, 2 * 256,	2},
+	{GL_PALETTE8_RGBA4_OES,		"PALETTE8_RGBA4",		8, 2 * 256,	2},
+	{GL_PALETTE8_RGB5_A1_OES,	"PALETTE8_RGB5_A1",		8, 2 * 256,	2},
+};
+
+#define TP_NUM_FORMATS				(sizeof(g_asFormats) / sizeof(g_asFormats[0]))
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+static IMG_CHAR const* g_pszOptions =
+"-reps=N     Expansions timed per format (default 50). 0 skips the timing.\n"
+"-seed=N     Seed for the palettes and indices (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetExpander
+ Inputs             : psFormat
+ Outputs            : -
+ Returns            : Level expander
+ Description        : Picks the expander the way glCompressedTexImage2D does
+************************************************************************************/
+static PFNExpandPaletteLevel GetExpander(const TP_FORMAT *psFormat)
+{
+	if(psFormat->ui32SrcBitsPerPixel == 8)
+	{
+		return (psFormat->ui32DstBytesPerTexel == 4) ? ExpandPalette8Level32bpp : ExpandPalette8Level16bpp;
+	}
+	else
+	{
+		return (psFormat->ui32DstBytesPerTexel == 4) ? ExpandPalette4Level32bpp : ExpandPalette4Level16bpp;
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckGuard
+ Inputs             : pui8Guard, pszWhich, psFormat, ui32Width, ui32Height
+ Outputs            : -
+ Returns            : -
+ Description        : Fails if anything was written past the end of a level
+************************************************************************************/
+static IMG_VOID CheckGuard(const IMG_UINT8 *pui8Guard, const IMG_CHAR *pszWhich, const TP_FORMAT *psFormat,
+						   IMG_UINT32 ui32Width, IMG_UINT32 ui32Height)
+{
+	IMG_UINT32 i;
+
+	for(i = 0; i < TP_GUARD_SIZE; i++)
+	{
+		if(pui8Guard[i] != TP_GUARD_VALUE)
+		{
+			fprintf(stderr, "error: %s %ux%u: %s expansion wrote past the end of the level\n",
+					psFormat->pszName, ui32Width, ui32Height, pszWhich);
+
+			g_ui32NumErrors++;
+
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckChain
+ Inputs             : psFormat, ui32Width, ui32Height, ui32PaletteOffset, pui8Data,
+					  pui8Old, pui8New
+ Outputs            : -
+ Returns            : Number of levels compared
+ Description        : Fills a random palette and mip chain at pui8Data + ui32PaletteOffset
+					  and expands every level both ways
+************************************************************************************/
+static IMG_UINT32 CheckChain(const TP_FORMAT *psFormat, IMG_UINT32 ui32Width, IMG_UINT32 ui32Height,
+							 IMG_UINT32 ui32PaletteOffset, IMG_UINT8 *pui8Data, IMG_UINT8 *pui8Old, IMG_UINT8 *pui8New)
+{
+	PFNExpandPaletteLevel pfnExpandLevel = GetExpander(psFormat);
+	/* Big enough for 4bit 32bpp tables, which hold two DWORDs per entry */
+	IMG_UINT32 aui32LUT[512];
+	IMG_UINT8 *pui8Palette = pui8Data + ui32PaletteOffset;
+	const IMG_UINT8 *pui8Pixels;
+	IMG_UINT32 ui32Size = 0, ui32NumLevels = 0, i;
+	IMG_UINT32 ui32TopWidth = ui32Width, ui32TopHeight = ui32Height;
+
+	/* Size the chain as glCompressedTexImage2D does, 1x1 level included */
+	for(;;)
+	{
+		ui32NumLevels++;
+
+		if(ui32Width == 1 && ui32Height == 1)
+		{
+			ui32Size += 1;
+			break;
+		}
+
+		ui32Size += (ui32Width * ui32Height * psFormat->ui32SrcBitsPerPixel) >> 3;
+
+		ui32Width = (ui32Width > 1) ? (ui32Width >> 1) : 1;
+		ui32Height = (ui32Height > 1) ? (ui32Height >> 1) : 1;
+	}
+
+	for(i = 0; i < psFormat->ui32PaletteSize + ui32Size; i++)
+	{
+		pui8Palette[i] = (IMG_UINT8)Random(256);
+	}
+
+	BuildPaletteLUT(aui32LUT, psFormat->eInternalFormat, pui8Palette, psFormat->ui32SrcBitsPerPixel,
+					psFormat->ui32DstBytesPerTexel);
+
+	pui8Pixels = pui8Palette + psFormat->ui32PaletteSize;
+	ui32Width = ui32TopWidth;
+	ui32Height = ui32TopHeight;
+
+	for(i = 0; i < ui32NumLevels; i++)
+	{
+		IMG_UINT32 ui32DstSize = ui32Width * ui32Height * psFormat->ui32DstBytesPerTexel;
+
+		memset(pui8Old, TP_GUARD_VALUE, ui32DstSize + TP_GUARD_SIZE);
+		memset(pui8New, TP_GUARD_VALUE, ui32DstSize + TP_GUARD_SIZE);
+
+		if(!ReferenceExpandLevel(psFormat->eInternalFormat, pui8Old, pui8Pixels, ui32Width, ui32Height, pui8Palette))
+		{
+			fprintf(stderr, "error: %s %ux%u: the reference rejected the level\n", psFormat->pszName, ui32Width, ui32Height);
+			g_ui32NumErrors++;
+		}
+
+		(*pfnExpandLevel)(pui8New, pui8Pixels, ui32Width * ui32Height, aui32LUT);
+
+		if(memcmp(pui8Old, pui8New, ui32DstSize) != 0)
+		{
+			fprintf(stderr, "error: %s %ux%u level of a %ux%u chain, palette offset %u: outputs differ\n",
+					psFormat->pszName, ui32Width, ui32Height, ui32TopWidth, ui32TopHeight, ui32PaletteOffset);
+			g_ui32NumErrors++;
+		}
+
+		CheckGuard(pui8Old + ui32DstSize, "reference", psFormat, ui32Width, ui32Height);
+		CheckGuard(pui8New + ui32DstSize, "table", psFormat, ui32Width, ui32Height);
+
+		/* As glCompressedTexImage2D */
+		pui8Pixels += (ui32Width * ui32Height * psFormat->ui32SrcBitsPerPixel) >> 3;
+
+		ui32Width = (ui32Width > 1) ? (ui32Width >> 1) : 1;
+		ui32Height = (ui32Height > 1) ? (ui32Height >> 1) : 1;
+	}
+
+	return ui32NumLevels;
+}
+
+
+/***********************************************************************************
+ Function Name      : TimeFormat
+ Inputs             : psFormat, ui32Repeats, pui8Data, pui8Old, pui8New
+ Outputs            : -
+ Returns            : -
+ Description        : Times the expansion of one TP_MAX_SIZE square level both ways
+************************************************************************************/
+static IMG_VOID TimeFormat(const TP_FORMAT *psFormat, IMG_UINT32 ui32Repeats, IMG_UINT8 *pui8Data,
+						   IMG_UINT8 *pui8Old, IMG_UINT8 *pui8New)
+{
+	PFNExpandPaletteLevel pfnExpandLevel = GetExpander(psFormat);
+	IMG_UINT32 aui32LUT[512];
+	const IMG_UINT8 *pui8Pixels = pui8Data + psFormat->ui32PaletteSize;
+	IMG_UINT32 ui32NumTexels = TP_MAX_SIZE * TP_MAX_SIZE, i;
+	double dStart, dOld, dNew;
+
+	dStart = GetSeconds();
+
+	for(i = 0; i < ui32Repeats; i++)
+	{
+		ReferenceExpandLevel(psFormat->eInternalFormat, pui8Old, pui8Pixels, TP_MAX_SIZE, TP_MAX_SIZE, pui8Data);
+	}
+
+	dOld = GetSeconds() - dStart;
+	dStart = GetSeconds();
+
+	for(i = 0; i < ui32Repeats; i++)
+	{
+		BuildPaletteLUT(aui32LUT, psFormat->eInternalFormat, pui8Data, psFormat->ui32SrcBitsPerPixel,
+						psFormat->ui32DstBytesPerTexel);
+
+		(*pfnExpandLevel)(pui8New, pui8Pixels, ui32NumTexels, aui32LUT);
+	}
+
+	dNew = GetSeconds() - dStart;
+
+	printf("%-18s %9.1f Mtexels/s %9.1f Mtexels/s %7.2fx\n", psFormat->pszName,
+		   (double)ui32Repeats * ui32NumTexels / dOld * 1e-6,
+		   (double)ui32Repeats * ui32NumTexels / dNew * 1e-6,
+		   dOld / dNew);
+}
+
+
+/***********************************************************************************
+ Function Name      : main
+ Inputs             : argc, argv
+ Outputs            : -
+ Returns            : 0 if every level matched, 1 otherwise
+ Description        : Runs every format, size and palette alignment, then the timing
+************************************************************************************/
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Repeats = TP_DEFAULT_REPEATS, ui32Seed = 1;
+	IMG_UINT32 ui32Format, ui32WidthLog2, ui32HeightLog2, ui32PaletteOffset;
+	IMG_UINT32 ui32NumChains = 0, ui32NumLevels = 0;
+	IMG_UINT32 ui32MaxDst = TP_MAX_SIZE * TP_MAX_SIZE * 4 + TP_GUARD_SIZE;
+	IMG_UINT8 *pui8Data, *pui8Old, *pui8New;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-reps=", strlen("-reps=")) == 0)
+		{
+			ui32Repeats = strtoul(argv[1] + strlen("-reps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: texpalette [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	/* Room for the largest palette at any offset, and a full 8bit chain */
+	pui8Data = malloc(3 + 4 * 256 + TP_MAX_SIZE * TP_MAX_SIZE * 2);
+	pui8Old = malloc(ui32MaxDst);
+	pui8New = malloc(ui32MaxDst);
+
+	if(!pui8Data || !pui8Old || !pui8New)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		return 1;
+	}
+
+	for(ui32Format = 0; ui32Format < TP_NUM_FORMATS; ui32Format++)
+	{
+		for(ui32WidthLog2 = 0; ui32WidthLog2 <= TP_MAX_SIZE_LOG2; ui32WidthLog2++)
+		{
+			for(ui32HeightLog2 = 0; ui32HeightLog2 <= TP_MAX_SIZE_LOG2; ui32HeightLog2++)
+			{
+				for(ui32PaletteOffset = 0; ui32PaletteOffset < 4; ui32PaletteOffset++)
+				{
+					ui32NumLevels += CheckChain(&g_asFormats[ui32Format], 1U << ui32WidthLog2, 1U << ui32HeightLog2,
+												ui32PaletteOffset, pui8Data, pui8Old, pui8New);
+					ui32NumChains++;
+				}
+			}
+		}
+	}
+
+	printf("%u mip chains, %u levels compared (seed %u)\n", ui32NumChains, ui32NumLevels, ui32Seed);
+
+	if(ui32Repeats && !g_ui32NumErrors)
+	{
+		printf("%ux%u level       %18s %18s %8s\n", TP_MAX_SIZE, TP_MAX_SIZE, "per texel", "table", "speedup");
+
+		for(ui32Format = 0; ui32Format < TP_NUM_FORMATS; ui32Format++)
+		{
+			TimeFormat(&g_asFormats[ui32Format], ui32Repeats, pui8Data, pui8Old, pui8New);
+		}
+	}
+
+	free(pui8Data);
+	free(pui8Old);
+	free(pui8New);
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
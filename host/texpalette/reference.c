@@ -0,0 +1,802 @@
+/******************************************************************************
+ * Name         : reference.c
+ * Title        : Paletted texture expansion before the lookup tables
+ *
+ * Copyright    : 2003-2009 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : The per-format span and 1xN functions that
+ *                glCompressedTexImage2D (opengles1/tex.c) used to expand
+ *                GL_OES_compressed_paletted_texture levels one texel at a
+ *                time, kept unchanged as the reference the lookup table
+ *                expanders in texpalette.c must match bit for bit.
+ *
+ * Modifications:-
+ * $Log: reference.c $
+ *****************************************************************************/
+
+#include "hostcontext.h"
+#include "reference.h"
+
+typedef IMG_VOID (*PFNCopyPaletteSpan)(IMG_VOID *, const IMG_VOID *, IMG_UINT32, const IMG_VOID *);
+
+
+#if defined(NO_UNALIGNED_ACCESS)
+/***********************************************************************************
+ Function Name      : READ_UNALIGNED_32
+ Inputs             : pui32Val
+ Returns            : 32bit value pointed to by pui32Val
+ Description        : If pui32Val isn't DWORD aligned, reads bytes, otherwise reads DWORD
+************************************************************************************/
+static IMG_UINT32 READ_UNALIGNED_32(const IMG_UINT32 *pui32Val)
+{	// Cast pointer to INT32 and see if it's already DWORD aligned
+	if ((((IMG_UINT32)pui32Val)&3)==0)
+	{	// If so then it's safe to just read and return the DWORD
+		return *pui32Val;
+	}
+	else
+	{	// Otherwise, build it up from the individual bytes
+		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui32Val;
+		return	(((IMG_UINT32)pui8Val[3])<<24)|
+				(((IMG_UINT32)pui8Val[2])<<16)|
+				(((IMG_UINT32)pui8Val[1])<<8)|
+				 ((IMG_UINT32)pui8Val[0]);
+	}	
+}
+
+
+/***********************************************************************************
+ Function Name      : READ_UNALIGNED_16
+ Inputs             : pui16Val
+ Returns            : 16bit value pointed to by pui16Val
+ Description        : If pui16Val isn't WORD aligned, reads bytes, otherwise reads WORD
+************************************************************************************/
+static IMG_UINT16 READ_UNALIGNED_16(const IMG_UINT16 *pui16Val)
+{	// Cast pointer to INT32 and see if it's already WORD aligned
+	if ((((IMG_UINT32)pui16Val)&1)==0)
+	{	// If so then it's safe to just read and return the WORD
+		return *pui16Val;
+	}
+	else
+	{	// Otherwise, build it up from the individual bytes
+		const IMG_UINT8 * pui8Val=(const IMG_UINT8 *)pui16Val;
+		return (((IMG_UINT16)pui8Val[1])<<8)|pui8Val[0];
+	}
+}
+#else
+#define READ_UNALIGNED_32(pui32Val) ((IMG_UINT32)(*(const IMG_UINT32 *)(pui32Val)))
+#define READ_UNALIGNED_16(pui16Val) ((IMG_UINT16)(*(const IMG_UINT16 *)(pui16Val)))
+#endif
+
+
+/***********************************************************************************
+ Function Name      : Copy888Palette4Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 888 format
+					  to RGBA8888 HW format
+************************************************************************************/
+static IMG_VOID Copy888Palette4Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT32 ui32Temp;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
+	IMG_UINT8 aui8PalTemp[3];
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue0 = *pui8Src++;
+		ui8Invalue1 = ui8Invalue0 & 0xF;
+		ui8Invalue0 >>= 4;
+
+		aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
+		aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
+		aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
+
+		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+		*pui32Dest++ = ui32Temp;
+
+		aui8PalTemp[0] = pui8Palette[ui8Invalue1*3];
+		aui8PalTemp[1] = pui8Palette[ui8Invalue1*3+1];
+		aui8PalTemp[2] = pui8Palette[ui8Invalue1*3+2];
+
+		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+		*pui32Dest++ = ui32Temp;
+
+		i -= 2;
+	}
+	while(i);
+
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy888Palette4Level1xN
+ Inputs             : pui8Src, ui32Height, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 888 format
+					  to RGBA8888 HW format, whole level 1xN
+************************************************************************************/
+static IMG_VOID Copy888Palette4Level1xN(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT32 ui32Temp;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
+	IMG_UINT8 aui8PalTemp[3];
+
+	if(ui32Height == 1)
+	{
+		ui8Invalue0 = *pui8Src;
+		ui8Invalue0 >>= 4;
+
+		aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
+		aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
+		aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
+
+		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+		*pui32Dest = ui32Temp;
+
+	}
+	else
+	{
+		i = ui32Height;
+
+		do
+		{
+			ui8Invalue0 = *pui8Src++;
+			ui8Invalue1 = ui8Invalue0 & 0xF;
+			ui8Invalue0 >>= 4;
+
+			aui8PalTemp[0] = pui8Palette[ui8Invalue0*3];
+			aui8PalTemp[1] = pui8Palette[ui8Invalue0*3+1];
+			aui8PalTemp[2] = pui8Palette[ui8Invalue0*3+2];
+
+			ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+			*pui32Dest++ = ui32Temp;
+
+			aui8PalTemp[0] = pui8Palette[ui8Invalue1*3];
+			aui8PalTemp[1] = pui8Palette[ui8Invalue1*3+1];
+			aui8PalTemp[2] = pui8Palette[ui8Invalue1*3+2];
+
+			ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+			*pui32Dest++ = ui32Temp;
+
+			i -= 2;
+		}
+		while(i);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy888Palette8Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 8bit Palette with 888 format
+					  to RGBA8888 HW format
+************************************************************************************/
+static IMG_VOID Copy888Palette8Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width, 
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT32 ui32Temp;
+	IMG_UINT8 ui8Invalue;
+	const IMG_UINT8 *pui8Palette = (const IMG_UINT8 *)pvPalette;
+	IMG_UINT8 aui8PalTemp[3];
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue = *pui8Src++;
+
+		aui8PalTemp[0] = pui8Palette[ui8Invalue*3];
+		aui8PalTemp[1] = pui8Palette[ui8Invalue*3+1];
+		aui8PalTemp[2] = pui8Palette[ui8Invalue*3+2];
+
+		ui32Temp = 0xFF000000 | (aui8PalTemp[2] << 16) | (aui8PalTemp[1] << 8) | aui8PalTemp[0];
+
+		*pui32Dest++ = ui32Temp;
+	}
+	while(--i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy8888Palette4Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 8888 format
+					  to RGBA8888 HW format
+************************************************************************************/
+static IMG_VOID Copy8888Palette4Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
+	IMG_UINT32 ui32PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue0 = *pui8Src++;
+		ui8Invalue1 = ui8Invalue0 & 0xF;
+		ui8Invalue0 >>= 4;
+
+		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
+
+		*pui32Dest++ = ui32PalTemp; 
+
+		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue1] );
+
+		*pui32Dest++ = ui32PalTemp; 
+
+		i -= 2;
+	}
+	while(i);
+
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy8888Palette4Level1xN
+ Inputs             : pui8Src, ui32Height, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 8888 format
+					  to RGBA8888 HW format, whole level 1xN
+************************************************************************************/
+static IMG_VOID Copy8888Palette4Level1xN(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
+	IMG_UINT32 ui32PalTemp;
+
+	if(ui32Height == 1)
+	{
+		ui8Invalue0 = *pui8Src;
+		ui8Invalue0 >>= 4;
+
+		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
+
+		*pui32Dest = ui32PalTemp; 
+	}
+	else
+	{
+		i = ui32Height;
+
+		do 
+		{
+			ui8Invalue0 = *pui8Src++;
+			ui8Invalue1 = ui8Invalue0 & 0xF;
+			ui8Invalue0 >>= 4;
+
+			ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue0] );
+
+			*pui32Dest++ = ui32PalTemp; 
+
+			ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue1] );
+
+			*pui32Dest++ = ui32PalTemp; 
+
+			i -= 2;
+		}
+		while(i);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy8888Palette8Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 8bit Palette with 8888 format
+					  to RGBA8888 HW format
+************************************************************************************/
+static IMG_VOID Copy8888Palette8Span(IMG_UINT32 *pui32Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue;
+	const IMG_UINT32 *pui32Palette = (const IMG_UINT32 *)pvPalette;
+	IMG_UINT32 ui32PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue = *pui8Src++;
+
+		ui32PalTemp = READ_UNALIGNED_32( &pui32Palette[ui8Invalue] );
+
+		*pui32Dest++ = ui32PalTemp; 
+	}
+	while(--i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy565Palette4Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 565 format
+					  to RGB565 HW format
+************************************************************************************/
+static IMG_VOID Copy565Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue0 = *pui8Src++;
+		ui8Invalue1 = ui8Invalue0 & 0xF;
+		ui8Invalue0 >>= 4;
+
+		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
+		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
+
+		i -= 2;
+	}
+	while(i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy565Palette4Level1xN
+ Inputs             : pui8Src, ui32Height, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 565 format
+					  to RGBA565 HW format, whole level 1xN
+************************************************************************************/
+static IMG_VOID Copy565Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+
+	if(ui32Height == 1)
+	{
+		ui8Invalue0 = *pui8Src;
+		ui8Invalue0 >>= 4;
+
+		*pui16Dest = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
+	}
+	else
+	{
+		i = ui32Height;
+
+		do
+		{
+			ui8Invalue0 = *pui8Src++;
+			ui8Invalue1 = ui8Invalue0 & 0xF;
+			ui8Invalue0 >>= 4;
+
+			*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
+			*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
+
+			i -= 2;
+		}
+		while(i);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy565Palette8Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 8bit Palette with 565 format
+					  to RGB565 HW format
+************************************************************************************/
+static IMG_VOID Copy565Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue = *pui8Src++;
+
+		*pui16Dest++ = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
+	}
+	while(--i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy4444Palette4Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 4444 format
+					  to RGBA4444 HW format
+************************************************************************************/
+static IMG_VOID Copy4444Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pu16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue0 = *pui8Src++;
+		ui8Invalue1 = ui8Invalue0 & 0xF;
+		ui8Invalue0 >>= 4;
+
+		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0] );
+		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+
+		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue1] );
+		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+
+		i -= 2;
+	}
+	while(i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy4444Palette4Level1xN
+ Inputs             : pui8Src, ui32Height, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 4444 format
+					  to RGBA4444 HW format, whole level 1xN
+************************************************************************************/
+static IMG_VOID Copy4444Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pu16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	if(ui32Height == 1)
+	{
+		ui8Invalue0 = *pui8Src;
+
+		ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0 >> 4]);
+
+		*pui16Dest = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+	}
+	else
+	{
+		i = ui32Height;
+
+		do
+		{
+			ui8Invalue0 = *pui8Src++;
+			ui8Invalue1 = ui8Invalue0 & 0xF;
+			ui8Invalue0 >>= 4;
+
+			ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue0] );
+			*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+
+			ui16PalTemp = READ_UNALIGNED_16( &pu16Palette[ui8Invalue1] );
+			*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+
+			i -= 2;
+		}
+		while(i);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy4444Palette8Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 8bit Palette with 4444 format
+					  to RGBA4444 HW format
+************************************************************************************/
+static IMG_VOID Copy4444Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue = *pui8Src++;
+		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
+
+		*pui16Dest++ = (ui16PalTemp << 12) | (ui16PalTemp >> 4);
+	}
+	while(--i);
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy5551Palette4Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 5551 format
+					  to RGBA1555 HW format
+************************************************************************************/
+static IMG_VOID Copy5551Palette4Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue0 = *pui8Src++;
+		ui8Invalue1 = ui8Invalue0 & 0xF;
+		ui8Invalue0 >>= 4;
+
+		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
+		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+
+		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
+		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+
+		i -= 2;
+	}
+	while(i);
+
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy5551Palette4Level1xN
+ Inputs             : pui8Src, ui32Height, pvPalette
+ Outputs            : pui32Dest
+ Returns            : -
+ Description        : Copies texture data from 4bit Palette with 5551 format
+					  to RGBA5551 HW format, whole level 1xN
+************************************************************************************/
+static IMG_VOID Copy5551Palette4Level1xN(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Height,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue0, ui8Invalue1;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	if(ui32Height == 1)
+	{
+		ui8Invalue0 = *pui8Src;
+
+		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0 >> 4] );
+
+		*pui16Dest = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+	}
+	else
+	{
+		i = ui32Height;
+
+		do
+		{
+			ui8Invalue0 = *pui8Src++;
+			ui8Invalue1 = ui8Invalue0 & 0xF;
+			ui8Invalue0 >>= 4;
+
+			ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue0] );
+			*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+
+			ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue1] );
+			*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+
+			i -= 2;
+		}
+		while(i);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : Copy5551Palette8Span
+ Inputs             : pui8Src, ui32Width, pvPalette
+ Outputs            : pui16Dest
+ Returns            : -
+ Description        : Copies texture data from 8bit Palette with 5551 format
+					  to RGBA1555 HW format
+************************************************************************************/
+static IMG_VOID Copy5551Palette8Span(IMG_UINT16 *pui16Dest, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Width,
+									 const IMG_VOID *pvPalette)
+{
+	IMG_UINT32 i;
+	IMG_UINT8 ui8Invalue;
+	const IMG_UINT16 *pui16Palette = (const IMG_UINT16 *)pvPalette;
+	IMG_UINT16 ui16PalTemp;
+
+	i = ui32Width;
+
+	do
+	{
+		ui8Invalue = *pui8Src++;
+		ui16PalTemp = READ_UNALIGNED_16( &pui16Palette[ui8Invalue] );
+
+		*pui16Dest++ = (ui16PalTemp << 15) | (ui16PalTemp >> 1);
+	}
+	while(--i);
+}
+
+
+/***********************************************************************************
+ Function Name      : ReferenceExpandLevel
+ Inputs             : eInternalFormat, pui8Src, ui32Width, ui32Height, pvPalette
+ Outputs            : pvDest
+ Returns            : IMG_TRUE if the format and size were accepted
+ Description        : Expands one level the way glCompressedTexImage2D did: a span
+					  per row, or one 1xN call for 4bit levels one texel wide
+************************************************************************************/
+IMG_BOOL ReferenceExpandLevel(GLenum eInternalFormat, IMG_VOID *pvDest, const IMG_UINT8 *pui8Src,
+							  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, const IMG_VOID *pvPalette)
+{
+	PFNCopyPaletteSpan pfnCopySpan = IMG_NULL;
+	PFNCopyPaletteSpan pfnCopyLevel1xN = IMG_NULL;
+	IMG_UINT32 ui32SrcBitsPerPixel, ui32DstBytesPerTexel;
+	IMG_UINT32 ui32SrcRowSize, ui32DstRowSize, j;
+
+	switch(eInternalFormat)
+	{
+		case GL_PALETTE4_RGB8_OES:
+		{
+			ui32SrcBitsPerPixel = 4;
+			ui32DstBytesPerTexel = 4;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy888Palette4Span;
+			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy888Palette4Level1xN;
+			break;
+		}
+		case GL_PALETTE4_RGBA8_OES:
+		{
+			ui32SrcBitsPerPixel = 4;
+			ui32DstBytesPerTexel = 4;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy8888Palette4Span;
+			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy8888Palette4Level1xN;
+			break;
+		}
+		case GL_PALETTE4_R5_G6_B5_OES:
+		{
+			ui32SrcBitsPerPixel = 4;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy565Palette4Span;
+			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy565Palette4Level1xN;
+			break;
+		}
+		case GL_PALETTE4_RGBA4_OES:
+		{
+			ui32SrcBitsPerPixel = 4;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy4444Palette4Span;
+			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy4444Palette4Level1xN;
+			break;
+		}
+		case GL_PALETTE4_RGB5_A1_OES:
+		{
+			ui32SrcBitsPerPixel = 4;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy5551Palette4Span;
+			pfnCopyLevel1xN = (PFNCopyPaletteSpan) Copy5551Palette4Level1xN;
+			break;
+		}
+		case GL_PALETTE8_RGB8_OES:
+		{
+			ui32SrcBitsPerPixel = 8;
+			ui32DstBytesPerTexel = 4;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy888Palette8Span;
+			break;
+		}
+		case GL_PALETTE8_RGBA8_OES:
+		{
+			ui32SrcBitsPerPixel = 8;
+			ui32DstBytesPerTexel = 4;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy8888Palette8Span;
+			break;
+		}
+		case GL_PALETTE8_R5_G6_B5_OES:
+		{
+			ui32SrcBitsPerPixel = 8;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy565Palette8Span;
+			break;
+		}
+		case GL_PALETTE8_RGBA4_OES:
+		{
+			ui32SrcBitsPerPixel = 8;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy4444Palette8Span;
+			break;
+		}
+		case GL_PALETTE8_RGB5_A1_OES:
+		{
+			ui32SrcBitsPerPixel = 8;
+			ui32DstBytesPerTexel = 2;
+			pfnCopySpan = (PFNCopyPaletteSpan) Copy5551Palette8Span;
+			break;
+		}
+		default:
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	ui32SrcRowSize = (ui32Width * ui32SrcBitsPerPixel) >> 3;
+	ui32DstRowSize = ui32Width * ui32DstBytesPerTexel;
+
+	if(!ui32Height || !ui32Width)
+	{
+		return IMG_TRUE;
+	}
+
+	if((ui32SrcBitsPerPixel == 8 || ui32Width != 1) && (pfnCopySpan != IMG_NULL))
+	{
+		j = ui32Height;
+
+		do
+		{
+			(*pfnCopySpan)(pvDest, pui8Src, ui32Width, pvPalette);
+
+			pvDest = (IMG_UINT8 *)pvDest + ui32DstRowSize;
+			pui8Src += ui32SrcRowSize;
+		}
+		while(--j);
+	}
+	else if((ui32SrcBitsPerPixel != 8 && ui32Width == 1) && (pfnCopyLevel1xN != IMG_NULL))
+	{
+		(*pfnCopyLevel1xN)(pvDest, pui8Src, ui32Height, pvPalette);
+	}
+	else
+	{
+		return IMG_FALSE;
+	}
+
+	return IMG_TRUE;
+}
@@ -0,0 +1,26 @@
+/******************************************************************************
+ * Name         : reference.h
+ * Title        : Paletted texture expansion before the lookup tables
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Modifications:-
+ * $Log: reference.h $
+ *****************************************************************************/
+
+#ifndef _REFERENCE_H_
+#define _REFERENCE_H_
+
+IMG_BOOL ReferenceExpandLevel(GLenum eInternalFormat, IMG_VOID *pvDest, const IMG_UINT8 *pui8Src,
+							  IMG_UINT32 ui32Width, IMG_UINT32 ui32Height, const IMG_VOID *pvPalette);
+
+#endif /* _REFERENCE_H_ */
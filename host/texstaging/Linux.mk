@@ -0,0 +1,38 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the GLES2 texture staging pool against mocked heap, lock and
+# transfer queue services. It checks reuse, size classes and the pool limit
+# after every step, and that nothing is left allocated once the pool is torn
+# down. Run it with no arguments; it exits non-zero if any check fails.
+#
+
+modules := texstaging
+
+texstaging_type := host_executable
+
+texstaging_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/texstaging.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header.
+texstaging_cflags := \
+ -DLINUX -DUSER \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/texstaging/hostcontext.h
+
+texstaging_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ intermediates/sgxsupport
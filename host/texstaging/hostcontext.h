@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the staging pool test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of texstaging.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                pool structure is the driver's own texstaging.h. The
+ *                context keeps only the fields the pool uses, and the UNC
+ *                heap, async cleanup queue and transfer wait come from the
+ *                harness.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "services.h"
+#include "pvr_debug.h"
+
+#include "ogles2_types.h"
+
+#include "texstaging.h"
+
+#define GLES2MemSet(X,Y,Z)		memset(X, Y, Z)
+
+#define GLES2MallocHeapUNC(X,Y)	HostHeapAlloc(Y)
+#define GLES2Free(X,Y)			HostHeapFree(Y)
+
+
+/* As srvcontext.h */
+typedef struct SrvSysContextTAG
+{
+	IMG_HANDLE hTransferContext;
+
+} SrvSysContext;
+
+/* As misc.h */
+typedef struct GLESAppHintsRec
+{
+	IMG_UINT32 ui32TexStagingPoolSize;
+
+} GLESAppHints;
+
+
+struct GLES2Context_TAG
+{
+	PVRSRV_DEV_DATA *ps3DDevData;
+	SrvSysContext *psSysContext;
+
+	GLESAppHints sAppHints;
+
+	IMG_UINT32 ui32AsyncTexOpNum;
+	GLES2StagingPool sStagingPool;
+};
+
+
+/* As psp2_pvr_defs.h */
+PVRSRV_ERROR IMG_CALLCONV SGXWaitTransfer(PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hTransferContext);
+
+/* Supplied by the harness's heap mock */
+IMG_VOID *HostHeapAlloc(IMG_UINT32 ui32Size);
+IMG_VOID HostHeapFree(IMG_VOID *pvPtr);
+
+
+/* psp2/swtexop.h includes context.h by a Windows path, so its prototypes are repeated here */
+#define _PSP2_SWTEXOP_
+
+IMG_VOID texOpAsyncAddForCleanup(GLES2Context *gc, IMG_PVOID pvPtr);
+
+IMG_VOID texOpStagingPoolInit(GLES2Context *gc);
+
+IMG_VOID texOpStagingPoolDeinit(GLES2Context *gc);
+
+IMG_PVOID texOpStagingAlloc(GLES2Context *gc, IMG_UINT32 ui32Size, IMG_UINT32 *pui32Class);
+
+IMG_VOID texOpStagingRelease(GLES2Context *gc, IMG_PVOID pvPtr, IMG_UINT32 ui32Class);
+
+IMG_VOID texOpStagingRetirePending(GLES2Context *gc);
+
+#endif /* _CONTEXT_ */
@@ -0,0 +1,1004 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Texture staging pool test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Drives the texture staging pool (texstaging.c) the way
+ *                texture uploads and the async cleanup thread do, against
+ *                mocks of the UNC heap, the pool lock and the transfer
+ *                queue.
+ *
+ *                A streaming texture re-specified every frame must be
+ *                served from the pool once its first released buffers are
+ *                retired, and must allocate every level when the pool is
+ *                disabled. Released buffers must not be reused while the
+ *                cleanup thread sees SW uploads running.
+ *
+ *                Random runs then upload, delete and retire levels of any
+ *                size with the transfer queue, the SW upload count and the
+ *                heap limit changing under them. After every step each
+ *                level's buffer must be a heap block of at least its size,
+ *                of exactly its class size if pooled, and never one an
+ *                upload is still reading. The free lists must match
+ *                ui32BytesHeld and stay within TexStagingPoolSize. Every
+ *                live heap block must be owned by exactly one level or
+ *                pool list, and none may be left once the pool is torn
+ *                down and the cleanup queue drained.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "hostcontext.h"
+
+
+#define TS_MAX_LEVELS			64
+#define TS_MAX_BLOCKS			4096
+#define TS_MAX_ASYNC			4096
+#define TS_DEFAULT_RUNS			100
+#define TS_DEFAULT_STEPS		2000
+
+/* Levels up to a little over the largest class, so some bypass the pool */
+#define TS_MAX_LEVEL_LOG2		(GLES2_STAGING_MAX_CLASS_LOG2 + 1)
+
+/* A 256x256 RGBA texture and its mipmaps, as the streaming test uploads it */
+#define TS_STREAM_LEVELS		9
+#define TS_STREAM_FRAMES		50
+
+typedef struct _TS_BLOCK_
+{
+	IMG_VOID	*pvPtr;
+	IMG_UINT32	ui32Size;
+
+} TS_BLOCK;
+
+typedef struct _TS_LEVEL_
+{
+	IMG_UINT8	*pui8Buffer;
+	IMG_UINT32	ui32Size;
+	IMG_UINT32	ui32Class;
+	IMG_UINT8	ui8Fill;
+
+} TS_LEVEL;
+
+static GLES2Context g_sGC;
+static SrvSysContext g_sSysContext;
+static TS_LEVEL g_asLevels[TS_MAX_LEVELS];
+
+/* UNC heap mock */
+static TS_BLOCK g_asBlocks[TS_MAX_BLOCKS];
+static IMG_UINT32 g_ui32NumBlocks;
+static IMG_UINT32 g_ui32BytesLive;
+static IMG_UINT32 g_ui32HeapLimit;
+static IMG_UINT32 g_ui32NumHeapAllocs;
+
+/* Buffers a transfer queue upload may still be reading */
+static IMG_VOID *g_apvInFlight[TS_MAX_BLOCKS];
+static IMG_UINT32 g_ui32NumInFlight;
+
+/* Async cleanup queue mock */
+static IMG_VOID *g_apvAsync[TS_MAX_ASYNC];
+static IMG_UINT32 g_ui32NumAsync;
+
+/* Pool lock mock */
+static IMG_UINT32 g_ui32Lock;
+static IMG_BOOL g_bLockCreated;
+static IMG_BOOL g_bLocked;
+static IMG_BOOL g_bFailLockCreate;
+
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+
+static IMG_CHAR const* g_pszOptions =
+"-runs=N     Number of random runs (default 100).\n"
+"-steps=N    Uploads, deletes and retires per run (default 2000).\n"
+"-seed=N     Seed for the random runs (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : FindBlock
+ Inputs             : pvPtr
+ Outputs            : -
+ Returns            : Index of the live heap block at pvPtr, or TS_MAX_BLOCKS
+ Description        : Looks up a block handed out by the heap mock
+************************************************************************************/
+static IMG_UINT32 FindBlock(const IMG_VOID *pvPtr)
+{
+	IMG_UINT32 i;
+
+	for(i = 0; i < g_ui32NumBlocks; i++)
+	{
+		if(g_asBlocks[i].pvPtr == pvPtr)
+		{
+			return i;
+		}
+	}
+
+	return TS_MAX_BLOCKS;
+}
+
+
+/***********************************************************************************
+ Function Name      : IsInFlight
+ Inputs             : pvPtr
+ Outputs            : -
+ Returns            : IMG_TRUE if an upload may still be reading pvPtr
+ Description        : -
+************************************************************************************/
+static IMG_BOOL IsInFlight(const IMG_VOID *pvPtr)
+{
+	IMG_UINT32 i;
+
+	for(i = 0; i < g_ui32NumInFlight; i++)
+	{
+		if(g_apvInFlight[i] == pvPtr)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
+
+/*
+** Heap, lock, transfer queue and cleanup queue mocks
+*/
+
+IMG_VOID *HostHeapAlloc(IMG_UINT32 ui32Size)
+{
+	IMG_VOID *pvPtr;
+
+	if(g_ui32NumBlocks == TS_MAX_BLOCKS)
+	{
+		Fail("more than %u heap blocks live", TS_MAX_BLOCKS);
+
+		return IMG_NULL;
+	}
+
+	if(g_ui32HeapLimit && (g_ui32BytesLive + ui32Size > g_ui32HeapLimit))
+	{
+		return IMG_NULL;
+	}
+
+	pvPtr = malloc(ui32Size);
+
+	if(!pvPtr)
+	{
+		Fail("host malloc of %u bytes failed", ui32Size);
+
+		return IMG_NULL;
+	}
+
+	g_asBlocks[g_ui32NumBlocks].pvPtr = pvPtr;
+	g_asBlocks[g_ui32NumBlocks].ui32Size = ui32Size;
+	g_ui32NumBlocks++;
+
+	g_ui32BytesLive += ui32Size;
+	g_ui32NumHeapAllocs++;
+
+	return pvPtr;
+}
+
+IMG_VOID HostHeapFree(IMG_VOID *pvPtr)
+{
+	IMG_UINT32 ui32Block = FindBlock(pvPtr);
+
+	if(ui32Block == TS_MAX_BLOCKS)
+	{
+		Fail("free of %p, which is not a live heap block", pvPtr);
+
+		return;
+	}
+
+	if(IsInFlight(pvPtr))
+	{
+		Fail("free of %p while an upload may still read it", pvPtr);
+	}
+
+	g_ui32BytesLive -= g_asBlocks[ui32Block].ui32Size;
+	g_asBlocks[ui32Block] = g_asBlocks[--g_ui32NumBlocks];
+
+	free(pvPtr);
+}
+
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV PVRSRVCreateMutex(PVRSRV_MUTEX_HANDLE *phMutex)
+{
+	if(g_bFailLockCreate)
+	{
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+
+	if(g_bLockCreated)
+	{
+		Fail("pool lock created twice");
+	}
+
+	g_bLockCreated = IMG_TRUE;
+	*phMutex = (PVRSRV_MUTEX_HANDLE)&g_ui32Lock;
+
+	return PVRSRV_OK;
+}
+
+IMG_EXPORT PVRSRV_ERROR IMG_CALLCONV PVRSRVDestroyMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	if(!g_bLockCreated || (hMutex != (PVRSRV_MUTEX_HANDLE)&g_ui32Lock) || g_bLocked)
+	{
+		Fail("pool lock destroyed while held or never created");
+	}
+
+	g_bLockCreated = IMG_FALSE;
+
+	return PVRSRV_OK;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVLockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	if(!g_bLockCreated || (hMutex != (PVRSRV_MUTEX_HANDLE)&g_ui32Lock) || g_bLocked)
+	{
+		Fail("pool lock taken while held or never created");
+	}
+
+	g_bLocked = IMG_TRUE;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVUnlockMutex(PVRSRV_MUTEX_HANDLE hMutex)
+{
+	if(!g_bLocked || (hMutex != (PVRSRV_MUTEX_HANDLE)&g_ui32Lock))
+	{
+		Fail("pool lock released but not held");
+	}
+
+	g_bLocked = IMG_FALSE;
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+PVRSRV_ERROR IMG_CALLCONV SGXWaitTransfer(PVRSRV_DEV_DATA *psDevData, IMG_HANDLE hTransferContext)
+{
+	PVR_UNREFERENCED_PARAMETER(psDevData);
+
+	if(hTransferContext != g_sSysContext.hTransferContext)
+	{
+		Fail("wait on the wrong transfer context");
+	}
+
+	if(g_bLocked)
+	{
+		Fail("transfer wait with the pool lock held");
+	}
+
+	g_ui32NumInFlight = 0;
+
+	return PVRSRV_OK;
+}
+
+IMG_VOID texOpAsyncAddForCleanup(GLES2Context *gc, IMG_PVOID pvPtr)
+{
+	PVR_UNREFERENCED_PARAMETER(gc);
+
+	if(g_ui32NumAsync == TS_MAX_ASYNC)
+	{
+		Fail("cleanup queue full");
+
+		return;
+	}
+
+	g_apvAsync[g_ui32NumAsync++] = pvPtr;
+}
+
+
+/***********************************************************************************
+ Function Name      : CleanupThreadPass
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : One pass of texOpAsyncCleanupThread: frees the cleanup
+					  queue once no SW upload runs, then retires the pool's
+					  released buffers.
+************************************************************************************/
+static IMG_VOID CleanupThreadPass(IMG_VOID)
+{
+	IMG_UINT32 i;
+
+	if(g_ui32NumAsync && !g_sGC.ui32AsyncTexOpNum)
+	{
+		SGXWaitTransfer(g_sGC.ps3DDevData, g_sSysContext.hTransferContext);
+
+		for(i = 0; i < g_ui32NumAsync; i++)
+		{
+			HostHeapFree(g_apvAsync[i]);
+		}
+
+		g_ui32NumAsync = 0;
+	}
+
+	texOpStagingRetirePending(&g_sGC);
+}
+
+
+/***********************************************************************************
+ Function Name      : ExpectedClass
+ Inputs             : ui32Size
+ Outputs            : -
+ Returns            : Smallest size class holding ui32Size, 0 if none does
+ Description        : -
+************************************************************************************/
+static IMG_UINT32 ExpectedClass(IMG_UINT32 ui32Size)
+{
+	IMG_UINT32 ui32Class;
+
+	for(ui32Class = 1; ui32Class <= GLES2_STAGING_NUM_CLASSES; ui32Class++)
+	{
+		if(GLES2_STAGING_CLASS_SIZE(ui32Class) >= ui32Size)
+		{
+			return ui32Class;
+		}
+	}
+
+	return 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : ReleaseLevel
+ Inputs             : ui32Level
+ Outputs            : -
+ Returns            : -
+ Description        : Checks nothing else wrote to the level's buffer, then
+					  releases it as TextureReleaseLevelBuffer does
+************************************************************************************/
+static IMG_VOID ReleaseLevel(IMG_UINT32 ui32Level)
+{
+	TS_LEVEL *psLevel = &g_asLevels[ui32Level];
+	IMG_UINT32 i;
+
+	if(!psLevel->pui8Buffer)
+	{
+		return;
+	}
+
+	/* A byte in every page and the last byte is enough to catch a second owner */
+	for(i = 0; i < psLevel->ui32Size; i += 4096)
+	{
+		if((psLevel->pui8Buffer[i] != psLevel->ui8Fill) ||
+		   (psLevel->pui8Buffer[psLevel->ui32Size - 1] != psLevel->ui8Fill))
+		{
+			Fail("level %u: its buffer was overwritten", ui32Level);
+
+			break;
+		}
+	}
+
+	if(psLevel->ui32Class)
+	{
+		texOpStagingRelease(&g_sGC, psLevel->pui8Buffer, psLevel->ui32Class);
+	}
+	else
+	{
+		texOpAsyncAddForCleanup(&g_sGC, psLevel->pui8Buffer);
+	}
+
+	psLevel->pui8Buffer = IMG_NULL;
+	psLevel->ui32Class = 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : UploadLevel
+ Inputs             : ui32Level, ui32Size
+ Outputs            : -
+ Returns            : IMG_TRUE if the level got a buffer
+ Description        : Re-specifies a level with a new staging buffer, checks
+					  it, fills it and queues an upload reading from it
+************************************************************************************/
+static IMG_BOOL UploadLevel(IMG_UINT32 ui32Level, IMG_UINT32 ui32Size)
+{
+	TS_LEVEL *psLevel = &g_asLevels[ui32Level];
+	IMG_BOOL bPooled = (g_sGC.sStagingPool.hLock != IMG_NULL);
+	IMG_UINT32 ui32Class, ui32Block, ui32Expected;
+	IMG_UINT8 *pui8Buffer;
+
+	ReleaseLevel(ui32Level);
+
+	pui8Buffer = (IMG_UINT8 *)texOpStagingAlloc(&g_sGC, ui32Size, &ui32Class);
+
+	if(!pui8Buffer)
+	{
+		if(ui32Class)
+		{
+			Fail("level %u: failed allocation returned class %u", ui32Level, ui32Class);
+		}
+
+		return IMG_FALSE;
+	}
+
+	ui32Expected = bPooled ? ExpectedClass(ui32Size) : 0;
+	ui32Block = FindBlock(pui8Buffer);
+
+	if(ui32Class != ui32Expected)
+	{
+		Fail("level %u: %u bytes got class %u, expected %u", ui32Level, ui32Size, ui32Class, ui32Expected);
+	}
+
+	if(ui32Block == TS_MAX_BLOCKS)
+	{
+		Fail("level %u: buffer %p is not a live heap block", ui32Level, pui8Buffer);
+
+		return IMG_FALSE;
+	}
+
+	if(ui32Class ? (g_asBlocks[ui32Block].ui32Size != GLES2_STAGING_CLASS_SIZE(ui32Class)) :
+				   (g_asBlocks[ui32Block].ui32Size < ui32Size))
+	{
+		Fail("level %u: %u bytes in class %u got a %u byte block",
+			 ui32Level, ui32Size, ui32Class, g_asBlocks[ui32Block].ui32Size);
+
+		return IMG_FALSE;
+	}
+
+	if(IsInFlight(pui8Buffer))
+	{
+		Fail("level %u: got buffer %p while an upload may still read it", ui32Level, pui8Buffer);
+	}
+
+	psLevel->pui8Buffer = pui8Buffer;
+	psLevel->ui32Size = ui32Size;
+	psLevel->ui32Class = ui32Class;
+	psLevel->ui8Fill = (IMG_UINT8)(1 + Random(255));
+
+	memset(pui8Buffer, psLevel->ui8Fill, ui32Size);
+
+	/* A full transfer queue stalls until its uploads are done */
+	if(g_ui32NumInFlight == TS_MAX_BLOCKS)
+	{
+		g_ui32NumInFlight = 0;
+	}
+
+	g_apvInFlight[g_ui32NumInFlight++] = pui8Buffer;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckOwner
+ Inputs             : pvPtr, pszOwner, pui8Owned
+ Outputs            : pui8Owned
+ Returns            : -
+ Description        : Marks the heap block at pvPtr as owned, failing if it
+					  isn't live or already has an owner
+************************************************************************************/
+static IMG_VOID CheckOwner(const IMG_VOID *pvPtr, const IMG_CHAR *pszOwner, IMG_UINT8 *pui8Owned)
+{
+	IMG_UINT32 ui32Block = FindBlock(pvPtr);
+
+	if(ui32Block == TS_MAX_BLOCKS)
+	{
+		Fail("%s holds %p, which is not a live heap block", pszOwner, pvPtr);
+	}
+	else if(pui8Owned[ui32Block]++)
+	{
+		Fail("%s holds %p, which something else holds too", pszOwner, pvPtr);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckPool
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : Checks the free lists against ui32BytesHeld and the pool
+					  limit, and that every live heap block has one owner
+************************************************************************************/
+static IMG_VOID CheckPool(IMG_VOID)
+{
+	static IMG_UINT8 aui8Owned[TS_MAX_BLOCKS];
+	GLES2StagingPool *psPool = &g_sGC.sStagingPool;
+	IMG_UINT32 ui32Class, ui32BytesHeld = 0, i;
+
+	memset(aui8Owned, 0, sizeof(aui8Owned));
+
+	if(g_bLocked)
+	{
+		Fail("pool lock left held");
+	}
+
+	for(ui32Class = 1; ui32Class <= GLES2_STAGING_NUM_CLASSES; ui32Class++)
+	{
+		if(psPool->aui32NumFree[ui32Class - 1] > GLES2_STAGING_CLASS_DEPTH)
+		{
+			Fail("class %u holds %u free buffers", ui32Class, psPool->aui32NumFree[ui32Class - 1]);
+
+			continue;
+		}
+
+		for(i = 0; i < psPool->aui32NumFree[ui32Class - 1]; i++)
+		{
+			IMG_VOID *pvPtr = psPool->apvFree[ui32Class - 1][i];
+			IMG_UINT32 ui32Block = FindBlock(pvPtr);
+
+			CheckOwner(pvPtr, "a free list", aui8Owned);
+
+			if((ui32Block != TS_MAX_BLOCKS) && (g_asBlocks[ui32Block].ui32Size != GLES2_STAGING_CLASS_SIZE(ui32Class)))
+			{
+				Fail("class %u free list holds a %u byte block", ui32Class, g_asBlocks[ui32Block].ui32Size);
+			}
+
+			if(IsInFlight(pvPtr))
+			{
+				Fail("class %u free list holds %p while an upload may still read it", ui32Class, pvPtr);
+			}
+
+			ui32BytesHeld += GLES2_STAGING_CLASS_SIZE(ui32Class);
+		}
+	}
+
+	if(ui32BytesHeld != psPool->ui32BytesHeld)
+	{
+		Fail("free lists hold %u bytes, pool counts %u", ui32BytesHeld, psPool->ui32BytesHeld);
+	}
+
+	if(ui32BytesHeld > g_sGC.sAppHints.ui32TexStagingPoolSize)
+	{
+		Fail("free lists hold %u bytes, over the %u byte limit", ui32BytesHeld, g_sGC.sAppHints.ui32TexStagingPoolSize);
+	}
+
+	if(psPool->ui32NumPending > GLES2_STAGING_MAX_PENDING)
+	{
+		Fail("%u buffers pending", psPool->ui32NumPending);
+	}
+	else
+	{
+		for(i = 0; i < psPool->ui32NumPending; i++)
+		{
+			if(!psPool->aui32PendingClass[i] || (psPool->aui32PendingClass[i] > GLES2_STAGING_NUM_CLASSES))
+			{
+				Fail("pending buffer %u has class %u", i, psPool->aui32PendingClass[i]);
+			}
+
+			CheckOwner(psPool->apvPending[i], "the pending list", aui8Owned);
+		}
+	}
+
+	for(i = 0; i < g_ui32NumAsync; i++)
+	{
+		CheckOwner(g_apvAsync[i], "the cleanup queue", aui8Owned);
+	}
+
+	for(i = 0; i < TS_MAX_LEVELS; i++)
+	{
+		if(g_asLevels[i].pui8Buffer)
+		{
+			CheckOwner(g_asLevels[i].pui8Buffer, "a level", aui8Owned);
+		}
+	}
+
+	for(i = 0; i < g_ui32NumBlocks; i++)
+	{
+		if(!aui8Owned[i])
+		{
+			Fail("heap block %p (%u bytes) leaked", g_asBlocks[i].pvPtr, g_asBlocks[i].ui32Size);
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : InitPool
+ Inputs             : ui32PoolSize, bFailLock
+ Outputs            : -
+ Returns            : -
+ Description        : Sets up the context and pool as context creation does
+************************************************************************************/
+static IMG_VOID InitPool(IMG_UINT32 ui32PoolSize, IMG_BOOL bFailLock)
+{
+	memset(&g_sGC, 0xCD, sizeof(g_sGC));
+
+	g_sGC.ps3DDevData = IMG_NULL;
+	g_sGC.psSysContext = &g_sSysContext;
+	g_sGC.sAppHints.ui32TexStagingPoolSize = ui32PoolSize;
+	g_sGC.ui32AsyncTexOpNum = 0;
+
+	g_sSysContext.hTransferContext = (IMG_HANDLE)&g_sSysContext;
+
+	g_bFailLockCreate = bFailLock;
+
+	texOpStagingPoolInit(&g_sGC);
+
+	if((g_sGC.sStagingPool.hLock != IMG_NULL) != (ui32PoolSize && !bFailLock))
+	{
+		Fail("%u byte pool %s", ui32PoolSize, g_sGC.sStagingPool.hLock ? "enabled" : "disabled");
+	}
+
+	CheckPool();
+}
+
+
+/***********************************************************************************
+ Function Name      : DeinitPool
+ Inputs             : pszName
+ Outputs            : -
+ Returns            : -
+ Description        : Releases every level, tears the pool down as context
+					  destruction does, drains the cleanup queue as the
+					  cleanup thread does on exit and checks nothing is left
+************************************************************************************/
+static IMG_VOID DeinitPool(const IMG_CHAR *pszName)
+{
+	IMG_UINT32 i;
+
+	for(i = 0; i < TS_MAX_LEVELS; i++)
+	{
+		ReleaseLevel(i);
+	}
+
+	g_sGC.ui32AsyncTexOpNum = 0;
+
+	CheckPool();
+
+	texOpStagingPoolDeinit(&g_sGC);
+
+	CleanupThreadPass();
+
+	if(g_ui32NumBlocks)
+	{
+		Fail("%s: %u heap blocks (%u bytes) left after deinit", pszName, g_ui32NumBlocks, g_ui32BytesLive);
+
+		while(g_ui32NumBlocks)
+		{
+			free(g_asBlocks[--g_ui32NumBlocks].pvPtr);
+		}
+
+		g_ui32BytesLive = 0;
+	}
+
+	if(g_bLockCreated)
+	{
+		Fail("%s: pool lock not destroyed", pszName);
+
+		g_bLockCreated = IMG_FALSE;
+	}
+
+	g_ui32NumInFlight = 0;
+	g_ui32HeapLimit = 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunStream
+ Inputs             : pszName, ui32PoolSize, ui32Busy, ui32ExpectedAllocs
+ Outputs            : -
+ Returns            : -
+ Description        : Re-specifies a 256x256 RGBA texture and its mipmaps every
+					  frame, with one cleanup thread pass per frame, and checks
+					  the number of heap allocations
+************************************************************************************/
+static IMG_VOID RunStream(const IMG_CHAR *pszName, IMG_UINT32 ui32PoolSize, IMG_UINT32 ui32Busy,
+						  IMG_UINT32 ui32ExpectedAllocs)
+{
+	IMG_UINT32 ui32Frame, ui32Level, ui32Uploads = 0;
+
+	InitPool(ui32PoolSize, IMG_FALSE);
+
+	g_ui32NumHeapAllocs = 0;
+
+	for(ui32Frame = 0; ui32Frame < TS_STREAM_FRAMES; ui32Frame++)
+	{
+		for(ui32Level = 0; ui32Level < TS_STREAM_LEVELS; ui32Level++)
+		{
+			IMG_UINT32 ui32Dim = 256 >> ui32Level;
+
+			ui32Uploads += UploadLevel(ui32Level, ui32Dim * ui32Dim * 4);
+		}
+
+		g_sGC.ui32AsyncTexOpNum = ui32Busy;
+
+		CleanupThreadPass();
+		CheckPool();
+	}
+
+	printf("%-32s %u uploads, %u heap allocations\n", pszName, ui32Uploads, g_ui32NumHeapAllocs);
+
+	if(ui32Uploads != TS_STREAM_FRAMES * TS_STREAM_LEVELS)
+	{
+		Fail("%s: only %u uploads got a buffer", pszName, ui32Uploads);
+	}
+
+	if(g_ui32NumHeapAllocs != ui32ExpectedAllocs)
+	{
+		Fail("%s: %u heap allocations, expected %u", pszName, g_ui32NumHeapAllocs, ui32ExpectedAllocs);
+	}
+
+	DeinitPool(pszName);
+}
+
+
+/***********************************************************************************
+ Function Name      : RunDrainOnFailure
+ Inputs             : -
+ Outputs            : -
+ Returns            : -
+ Description        : Fills the pool with small buffers, then caps the heap so
+					  a large level only fits once they are given back
+************************************************************************************/
+static IMG_VOID RunDrainOnFailure(IMG_VOID)
+{
+	IMG_UINT32 i;
+
+	InitPool(256 * 1024, IMG_FALSE);
+
+	for(i = 0; i < 8; i++)
+	{
+		UploadLevel(i, 16 * 1024);
+	}
+
+	for(i = 0; i < 8; i++)
+	{
+		ReleaseLevel(i);
+	}
+
+	CleanupThreadPass();
+	CheckPool();
+
+	if(g_sGC.sStagingPool.ui32BytesHeld != 8 * 16 * 1024)
+	{
+		Fail("drain on failure: pool holds %u bytes before the large level", g_sGC.sStagingPool.ui32BytesHeld);
+	}
+
+	g_ui32HeapLimit = g_ui32BytesLive + 64 * 1024;
+
+	if(!UploadLevel(0, 128 * 1024))
+	{
+		Fail("drain on failure: 128KB level not allocated after giving back the pool");
+	}
+
+	if(g_sGC.sStagingPool.ui32BytesHeld)
+	{
+		Fail("drain on failure: pool still holds %u bytes", g_sGC.sStagingPool.ui32BytesHeld);
+	}
+
+	CheckPool();
+
+	/* Nothing left to give back, so this one must fail cleanly */
+	if(UploadLevel(1, 4 * 1024 * 1024))
+	{
+		Fail("drain on failure: 4MB level allocated over the heap limit");
+	}
+
+	CheckPool();
+
+	DeinitPool("drain on failure");
+}
+
+
+/***********************************************************************************
+ Function Name      : RandomLevelSize
+ Inputs             : -
+ Outputs            : -
+ Returns            : Level size in bytes
+ Description        : Sizes spread evenly over powers of two, with exact powers
+					  of two and their neighbours more likely
+************************************************************************************/
+static IMG_UINT32 RandomLevelSize(IMG_VOID)
+{
+	IMG_UINT32 ui32Log2 = Random(TS_MAX_LEVEL_LOG2 + 1);
+	IMG_UINT32 ui32Size = 1U << ui32Log2;
+
+	switch(Random(4))
+	{
+		case 0:
+		{
+			break;
+		}
+		case 1:
+		{
+			ui32Size++;
+
+			break;
+		}
+		case 2:
+		{
+			ui32Size = (ui32Size > 1) ? ui32Size - 1 : 1;
+
+			break;
+		}
+		default:
+		{
+			ui32Size = (ui32Size >> 1) + 1 + Random(ui32Size - (ui32Size >> 1));
+
+			break;
+		}
+	}
+
+	return ui32Size;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunRandom
+ Inputs             : ui32Run, ui32Steps
+ Outputs            : -
+ Returns            : -
+ Description        : One random run: a random pool size, then uploads, deletes
+					  and cleanup passes with the upload count, transfer queue
+					  and heap limit changing under them
+************************************************************************************/
+static IMG_VOID RunRandom(IMG_UINT32 ui32Run, IMG_UINT32 ui32Steps)
+{
+	static const IMG_UINT32 aui32PoolSizes[] = {0, 4 * 1024, 64 * 1024, 2 * 1024 * 1024, 16 * 1024 * 1024};
+	IMG_UINT32 ui32PoolSize, ui32Step, ui32Choice;
+	IMG_CHAR acName[32];
+
+	if(Random(8))
+	{
+		ui32PoolSize = aui32PoolSizes[Random(sizeof(aui32PoolSizes) / sizeof(aui32PoolSizes[0]))];
+	}
+	else
+	{
+		ui32PoolSize = 1 + Random(8 * 1024 * 1024);
+	}
+
+	InitPool(ui32PoolSize, (Random(16) == 0) ? IMG_TRUE : IMG_FALSE);
+
+	for(ui32Step = 0; ui32Step < ui32Steps; ui32Step++)
+	{
+		ui32Choice = Random(100);
+
+		if(ui32Choice < 50)
+		{
+			UploadLevel(Random(TS_MAX_LEVELS), RandomLevelSize());
+		}
+		else if(ui32Choice < 65)
+		{
+			ReleaseLevel(Random(TS_MAX_LEVELS));
+		}
+		else if(ui32Choice < 80)
+		{
+			CleanupThreadPass();
+		}
+		else if(ui32Choice < 90)
+		{
+			g_sGC.ui32AsyncTexOpNum = Random(2) ? 0 : 1 + Random(3);
+		}
+		else if(ui32Choice < 95)
+		{
+			/* The transfer queue catches up on its own */
+			g_ui32NumInFlight = 0;
+		}
+		else
+		{
+			g_ui32HeapLimit = Random(2) ? 0 : g_ui32BytesLive + Random(8 * 1024 * 1024);
+		}
+
+		CheckPool();
+
+		if(g_ui32NumErrors)
+		{
+			fprintf(stderr, "error: run %u, step %u, pool size %u\n", ui32Run, ui32Step, ui32PoolSize);
+
+			break;
+		}
+	}
+
+	sprintf(acName, "random run %u", ui32Run);
+
+	DeinitPool(acName);
+}
+
+
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32Runs = TS_DEFAULT_RUNS, ui32Steps = TS_DEFAULT_STEPS, ui32Seed = 1, i;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-runs=", strlen("-runs=")) == 0)
+		{
+			ui32Runs = strtoul(argv[1] + strlen("-runs="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-steps=", strlen("-steps=")) == 0)
+		{
+			ui32Steps = strtoul(argv[1] + strlen("-steps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: texstaging [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	/*
+		Frame 1 allocates every level. Its buffers are released in frame 2,
+		which has to allocate again as they are still pending, and retired
+		by that frame's cleanup pass. Every later frame reuses them.
+	*/
+	RunStream("streaming texture", 2 * 1024 * 1024, 0, 2 * TS_STREAM_LEVELS);
+	RunStream("streaming texture, no pool", 0, 0, TS_STREAM_FRAMES * TS_STREAM_LEVELS);
+
+	/* Buffers released while SW uploads run are never retired, or reused */
+	RunStream("streaming texture, uploads busy", 2 * 1024 * 1024, 1, TS_STREAM_FRAMES * TS_STREAM_LEVELS);
+
+	RunDrainOnFailure();
+
+	for(i = 0; i < ui32Runs && !g_ui32NumErrors; i++)
+	{
+		RunRandom(i, ui32Steps);
+	}
+
+	printf("%u random runs of %u steps\n", i, ui32Steps);
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
@@ -0,0 +1,42 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without
+# the express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host build of the USSE binary analyser, which reports the instruction mix
+# and likely stall sites of assembled programs using the useasm decoder.
+#
+
+modules := useanalyse
+
+useanalyse_type := host_executable
+
+useanalyse_src = \
+ main.c \
+ $(addprefix $(TOP)/tools/intern/useasm/, \
+  specialregs.c specialregs_vec.c useanalyse.c usedisasm.c usetab.c \
+  utils.c)
+
+# USER brings in the opcode names used in the reports.
+useanalyse_cflags := \
+ -DLINUX -DUSER -D'IMG_ABORT()=abort()' \
+ -DINCLUDE_SGX_FEATURE_TABLE -DINCLUDE_SGX_BUG_TABLE -DSUPPORT_SGX543 \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h
+
+useanalyse_includes := include/gpu_es4 \
+ include/gpu_es4/eurasia/hwdefs include/gpu_es4/eurasia/include4 \
+ tools/intern/useasm intermediates/sgxsupport intermediates/errata
+
+useanalyse_extlibs := pthread
+
+ifeq ($(BUILD),debug)
+useanalyse_cflags += -DDEBUG
+endif
@@ -0,0 +1,731 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : USSE binary analyser
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Reports the instruction mix, dual-issue pairs, repeat and
+ *                MOE use, texture samples, sync points and estimated stall
+ *                sites of assembled USSE programs, and ranks the programs by
+ *                a static cost, without running them. Input files are raw
+ *                code (useasm output or code heap dumps, which may hold many
+ *                programs each ended by an instruction with the END flag) or
+ *                useasm object files.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#if defined(LINUX)
+#include <pthread.h>
+#endif
+
+#include "psp2_pvr_desc.h"
+
+#include "sgxdefs.h"
+
+#include "use.h"
+#include "useasm.h"
+#include "usedisasm.h"
+#include "useanalyse.h"
+#include "objectfile.h"
+
+
+#define UA_MAX_LINE_LENGTH			1024
+#define UA_MAX_THREADS				64
+#define UA_DEFAULT_TOP				20
+
+/* First word of an SGXBS binary shader (see esbinshaderinternal.h) */
+#define UA_SGXBS_MAGIC				0x38B4FA10U
+
+/* Summary of one program */
+typedef struct _UA_PROGRAM_
+{
+	/* Offset of the first instruction in the file in bytes */
+	IMG_UINT32	ui32Offset;
+
+	IMG_UINT32	ui32InstCount;
+	IMG_UINT32	ui32IssueCount;
+	IMG_UINT32	ui32TextureSampleCount;
+	IMG_UINT32	ui32DualIssueCount;
+	IMG_UINT32	ui32StallSiteCount;
+	IMG_UINT32	ui32Cycles;
+
+} UA_PROGRAM;
+
+/* One input file and the programs found in it */
+typedef struct _UA_FILE_
+{
+	const IMG_CHAR	*pszFileName;
+	UA_PROGRAM		*psPrograms;
+	IMG_UINT32		ui32NumPrograms;
+	IMG_BOOL		bFailed;
+
+} UA_FILE;
+
+/* A scan thread: every ui32NumWorkers'th file starting at ui32Worker */
+typedef struct _UA_WORKER_
+{
+	UA_FILE				*psFiles;
+	IMG_UINT32			ui32NumFiles;
+	IMG_UINT32			ui32Worker;
+	IMG_UINT32			ui32NumWorkers;
+	PCSGX_CORE_DESC		psTarget;
+	USEANALYSE_STATS	sStats;
+
+} UA_WORKER;
+
+static IMG_CHAR const* g_pszOptions =
+"-list=FILE     Also analyse every file named in FILE, one per line.\n"
+"-j=N           Scan the files with N threads.\n"
+"-targetrev=N   Core revision the code was assembled for. Object files\n"
+"               name their own target.\n"
+"-top=N         Rank the N most expensive programs (default 20, 0 for none).\n"
+"-quiet         Only print the summary, not one line per program.\n";
+
+
+/***********************************************************************************
+ Function Name      : ReadBinaryFile
+ Inputs             : pszFileName
+ Outputs            : pui32Size
+ Returns            : File contents, or NULL
+ Description        :
+************************************************************************************/
+static IMG_UINT8 *ReadBinaryFile(const IMG_CHAR *pszFileName, IMG_UINT32 *pui32Size)
+{
+	FILE *fInFile;
+	IMG_UINT8 *pui8Data;
+	long lLength;
+
+	fInFile = fopen(pszFileName, "rb");
+
+	if (fInFile == NULL)
+	{
+		fprintf(stderr, "%s: error: couldn't open file\n", pszFileName);
+		return NULL;
+	}
+
+	fseek(fInFile, 0, SEEK_END);
+	lLength = ftell(fInFile);
+	fseek(fInFile, 0, SEEK_SET);
+
+	/* Keep the buffer aligned for reading instructions */
+	pui8Data = malloc((size_t)lLength + sizeof(IMG_UINT32));
+
+	if (pui8Data == NULL || fread(pui8Data, 1, (size_t)lLength, fInFile) != (size_t)lLength)
+	{
+		fprintf(stderr, "%s: error: couldn't read file\n", pszFileName);
+		free(pui8Data);
+		fclose(fInFile);
+		return NULL;
+	}
+
+	fclose(fInFile);
+
+	*pui32Size = (IMG_UINT32)lLength;
+
+	return pui8Data;
+}
+
+
+/***********************************************************************************
+ Function Name      : AnalyseCode
+ Inputs             : psTarget, pui32Code, ui32NumInsts, ui32BaseOffset
+ Outputs            : psFile, psTotals
+ Returns            : Success
+ Description        : Splits code into programs at END flags, skipping zeroed
+                      padding between them, and records each one.
+************************************************************************************/
+static IMG_BOOL AnalyseCode(PCSGX_CORE_DESC psTarget, const IMG_UINT32 *pui32Code, IMG_UINT32 ui32NumInsts,
+							IMG_UINT32 ui32BaseOffset, UA_FILE *psFile, USEANALYSE_STATS *psTotals)
+{
+	IMG_UINT32 ui32Inst = 0;
+
+	while (ui32Inst < ui32NumInsts)
+	{
+		USEANALYSE_STATS sStats;
+		UA_PROGRAM *psNewPrograms, *psProgram;
+		IMG_UINT32 ui32Decoded;
+
+		if (pui32Code[ui32Inst * 2] == 0 && pui32Code[ui32Inst * 2 + 1] == 0)
+		{
+			ui32Inst++;
+			continue;
+		}
+
+		UseAnalyseInitStats(&sStats);
+
+		ui32Decoded = UseAnalyseProgram(psTarget, ui32NumInsts - ui32Inst, &pui32Code[ui32Inst * 2], &sStats);
+
+		psNewPrograms = realloc(psFile->psPrograms, (psFile->ui32NumPrograms + 1) * sizeof(UA_PROGRAM));
+
+		if (psNewPrograms == NULL)
+		{
+			fprintf(stderr, "Out of memory\n");
+			return IMG_FALSE;
+		}
+
+		psFile->psPrograms = psNewPrograms;
+		psProgram = &psNewPrograms[psFile->ui32NumPrograms++];
+
+		psProgram->ui32Offset             = ui32BaseOffset + ui32Inst * EURASIA_USE_INSTRUCTION_SIZE;
+		psProgram->ui32InstCount          = sStats.uInstCount;
+		psProgram->ui32IssueCount         = sStats.uIssueCount;
+		psProgram->ui32TextureSampleCount = sStats.uTextureSampleCount;
+		psProgram->ui32DualIssueCount     = sStats.uDualIssueCount;
+		psProgram->ui32StallSiteCount     = sStats.uStallSiteCount;
+		psProgram->ui32Cycles             = UseAnalyseEstimateCycles(&sStats);
+
+		UseAnalyseMergeStats(psTotals, &sStats);
+
+		ui32Inst += ui32Decoded;
+	}
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : AnalyseFile
+ Inputs             : psTarget
+ Outputs            : psFile, psTotals
+ Returns            : Success
+ Description        :
+************************************************************************************/
+static IMG_BOOL AnalyseFile(PCSGX_CORE_DESC psTarget, UA_FILE *psFile, USEANALYSE_STATS *psTotals)
+{
+	IMG_UINT8 *pui8Data;
+	IMG_UINT32 ui32Size, ui32CodeOffset, ui32NumInsts;
+	IMG_BOOL bResult;
+
+	pui8Data = ReadBinaryFile(psFile->pszFileName, &ui32Size);
+
+	if (pui8Data == NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	ui32CodeOffset = 0;
+	ui32NumInsts = ui32Size / EURASIA_USE_INSTRUCTION_SIZE;
+
+	if (ui32Size >= sizeof(USEASM_OBJFILE_HEADER) &&
+		memcmp(pui8Data, USEASM_OBJFILE_ID, strlen(USEASM_OBJFILE_ID)) == 0)
+	{
+		USEASM_OBJFILE_HEADER sHeader;
+		PCSGX_CORE_DESC psObjTarget;
+
+		memcpy(&sHeader, pui8Data, sizeof(sHeader));
+
+		if (sHeader.uInstructionOffset > ui32Size ||
+			sHeader.uInstructionCount > (ui32Size - sHeader.uInstructionOffset) / EURASIA_USE_INSTRUCTION_SIZE ||
+			(sHeader.uInstructionOffset % sizeof(IMG_UINT32)) != 0)
+		{
+			fprintf(stderr, "%s: error: corrupt object file\n", psFile->pszFileName);
+			free(pui8Data);
+			return IMG_FALSE;
+		}
+
+		psObjTarget = UseAsmGetCoreDesc(&sHeader.sTarget);
+
+		if (psObjTarget != NULL)
+		{
+			psTarget = psObjTarget;
+		}
+
+		ui32CodeOffset = sHeader.uInstructionOffset;
+		ui32NumInsts = sHeader.uInstructionCount;
+	}
+	else if (ui32Size >= sizeof(IMG_UINT32) &&
+			 (pui8Data[0] << 24 | pui8Data[1] << 16 | pui8Data[2] << 8 | pui8Data[3]) == UA_SGXBS_MAGIC)
+	{
+		/* Binary shaders hold UniPatch input rather than finished code */
+		fprintf(stderr, "%s: error: SGXBS binaries aren't finalised USSE code; analyse a code heap dump instead\n",
+				psFile->pszFileName);
+		free(pui8Data);
+		return IMG_FALSE;
+	}
+	else if ((ui32Size % EURASIA_USE_INSTRUCTION_SIZE) != 0)
+	{
+		fprintf(stderr, "%s: warning: ignoring %u trailing bytes\n",
+				psFile->pszFileName, ui32Size % EURASIA_USE_INSTRUCTION_SIZE);
+	}
+
+	bResult = AnalyseCode(psTarget, (const IMG_UINT32 *)(pui8Data + ui32CodeOffset), ui32NumInsts,
+						  ui32CodeOffset, psFile, psTotals);
+
+	free(pui8Data);
+
+	return bResult;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunWorker
+ Inputs             : pvWorker
+ Outputs            : -
+ Returns            : NULL
+ Description        : Thread entry point. Files are only touched by the thread
+                      analysing them and each thread keeps its own totals.
+************************************************************************************/
+static IMG_VOID *RunWorker(IMG_VOID *pvWorker)
+{
+	UA_WORKER *psWorker = (UA_WORKER *)pvWorker;
+	IMG_UINT32 i;
+
+	for (i = psWorker->ui32Worker; i < psWorker->ui32NumFiles; i += psWorker->ui32NumWorkers)
+	{
+		if (!AnalyseFile(psWorker->psTarget, &psWorker->psFiles[i], &psWorker->sStats))
+		{
+			psWorker->psFiles[i].bFailed = IMG_TRUE;
+		}
+	}
+
+	return NULL;
+}
+
+
+/***********************************************************************************
+ Function Name      : AddFile
+ Inputs             : pszFileName
+ Outputs            : ppsFiles, pui32NumFiles
+ Returns            : Success
+ Description        :
+************************************************************************************/
+static IMG_BOOL AddFile(const IMG_CHAR *pszFileName, UA_FILE **ppsFiles, IMG_UINT32 *pui32NumFiles)
+{
+	UA_FILE *psNewFiles;
+
+	psNewFiles = realloc(*ppsFiles, (*pui32NumFiles + 1) * sizeof(UA_FILE));
+
+	if (psNewFiles == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return IMG_FALSE;
+	}
+
+	memset(&psNewFiles[*pui32NumFiles], 0, sizeof(UA_FILE));
+	psNewFiles[*pui32NumFiles].pszFileName = pszFileName;
+
+	*ppsFiles = psNewFiles;
+	(*pui32NumFiles)++;
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : ParseFileList
+ Inputs             : pszListFile
+ Outputs            : ppsFiles, pui32NumFiles
+ Returns            : Success
+ Description        : Reads one file name per line. '#' starts a comment.
+************************************************************************************/
+static IMG_BOOL ParseFileList(const IMG_CHAR *pszListFile, UA_FILE **ppsFiles, IMG_UINT32 *pui32NumFiles)
+{
+	IMG_CHAR pszLine[UA_MAX_LINE_LENGTH], pszName[UA_MAX_LINE_LENGTH];
+	FILE *fListFile;
+
+	fListFile = fopen(pszListFile, "r");
+
+	if (fListFile == NULL)
+	{
+		fprintf(stderr, "%s: error: couldn't open file\n", pszListFile);
+		return IMG_FALSE;
+	}
+
+	while (fgets(pszLine, sizeof(pszLine), fListFile))
+	{
+		if (pszLine[0] == '#' || sscanf(pszLine, "%1023s", pszName) != 1)
+		{
+			continue;
+		}
+
+		if (!AddFile(strdup(pszName), ppsFiles, pui32NumFiles))
+		{
+			fclose(fListFile);
+			return IMG_FALSE;
+		}
+	}
+
+	fclose(fListFile);
+
+	return IMG_TRUE;
+}
+
+
+/***********************************************************************************
+ Function Name      : CompareCounts
+ Inputs             : pvA, pvB
+ Outputs            : -
+ Returns            : qsort order for descending counts
+ Description        : Sorts (index, count) pairs.
+************************************************************************************/
+static int CompareCounts(const void *pvA, const void *pvB)
+{
+	const IMG_UINT32 *pui32A = (const IMG_UINT32 *)pvA;
+	const IMG_UINT32 *pui32B = (const IMG_UINT32 *)pvB;
+
+	if (pui32A[1] != pui32B[1])
+	{
+		return (pui32A[1] > pui32B[1]) ? -1 : 1;
+	}
+
+	return (pui32A[0] < pui32B[0]) ? -1 : ((pui32A[0] > pui32B[0]) ? 1 : 0);
+}
+
+
+/***********************************************************************************
+ Function Name      : PrintPercent
+ Inputs             : pszName, ui32Count, ui32Total
+ Outputs            : -
+ Returns            : -
+ Description        :
+************************************************************************************/
+static IMG_VOID PrintPercent(const IMG_CHAR *pszName, IMG_UINT32 ui32Count, IMG_UINT32 ui32Total)
+{
+	printf("  %-24s %10u  %5.1f%%\n", pszName, ui32Count, ui32Total ? (100.0 * ui32Count) / ui32Total : 0.0);
+}
+
+
+/***********************************************************************************
+ Function Name      : PrintSummary
+ Inputs             : psStats
+ Outputs            : -
+ Returns            : -
+ Description        :
+************************************************************************************/
+static IMG_VOID PrintSummary(const USEANALYSE_STATS *psStats)
+{
+	IMG_UINT32 (*paui32Sorted)[2];
+	IMG_UINT32 i, ui32NumSorted;
+
+	printf("%u programs, %u instructions (%u invalid), %u issues, %u estimated cycles\n",
+		   psStats->uProgramCount, psStats->uInstCount, psStats->uInvalidInstCount,
+		   psStats->uIssueCount, UseAnalyseEstimateCycles(psStats));
+
+	paui32Sorted = malloc(USEASM_OP_MAXIMUM * sizeof(paui32Sorted[0]));
+
+	if (paui32Sorted != NULL)
+	{
+		printf("\nopcode mix:\n");
+
+		for (i = 0, ui32NumSorted = 0; i < USEASM_OP_MAXIMUM; i++)
+		{
+			if (psStats->auOpcodeCount[i])
+			{
+				paui32Sorted[ui32NumSorted][0] = i;
+				paui32Sorted[ui32NumSorted][1] = psStats->auOpcodeCount[i];
+				ui32NumSorted++;
+			}
+		}
+
+		qsort(paui32Sorted, ui32NumSorted, sizeof(paui32Sorted[0]), CompareCounts);
+
+		for (i = 0; i < ui32NumSorted; i++)
+		{
+			PrintPercent(OpcodeName(paui32Sorted[i][0]), paui32Sorted[i][1], psStats->uInstCount);
+		}
+
+		free(paui32Sorted);
+	}
+
+	printf("\ndual-issue:\n");
+	PrintPercent("dual-issued", psStats->uDualIssueCount, psStats->uInstCount);
+
+	for (i = 0; i < psStats->uDualIssuePairCount; i++)
+	{
+		IMG_CHAR pszPair[UA_MAX_LINE_LENGTH];
+
+		sprintf(pszPair, "%s + %s",
+				OpcodeName(psStats->asDualIssuePairs[i].uPrimaryOpcode),
+				OpcodeName(psStats->asDualIssuePairs[i].uSecondaryOpcode));
+		PrintPercent(pszPair, psStats->asDualIssuePairs[i].uCount, psStats->uDualIssueCount);
+	}
+
+	printf("\nrepeats and MOE:\n");
+	PrintPercent("repeated", psStats->uRepeatedInstCount, psStats->uInstCount);
+
+	for (i = 2; i <= USEANALYSE_MAX_REPEAT; i++)
+	{
+		if (psStats->auRepeatCount[i])
+		{
+			IMG_CHAR pszRepeat[32];
+
+			sprintf(pszRepeat, (i == USEANALYSE_MAX_REPEAT) ? "%u+ iterations" : "%u iterations", i);
+			PrintPercent(pszRepeat, psStats->auRepeatCount[i], psStats->uInstCount);
+		}
+	}
+
+	PrintPercent("MOE state changes", psStats->uMOEControlCount, psStats->uInstCount);
+	PrintPercent("per-instruction MOE", psStats->uPerInstMOECount, psStats->uInstCount);
+
+	printf("\nmemory and flow control:\n");
+	PrintPercent("texture samples", psStats->uTextureSampleCount, psStats->uInstCount);
+	PrintPercent("loads", psStats->uMemoryLoadCount, psStats->uInstCount);
+	PrintPercent("stores", psStats->uMemoryStoreCount, psStats->uInstCount);
+	PrintPercent("branches", psStats->uBranchCount, psStats->uInstCount);
+
+	printf("\nscheduling:\n");
+	PrintPercent("nosched", psStats->uNoSchedCount, psStats->uInstCount);
+	PrintPercent("syncstart", psStats->uSyncStartCount, psStats->uInstCount);
+	PrintPercent("syncend", psStats->uSyncEndCount, psStats->uInstCount);
+	PrintPercent("fences", psStats->uFenceCount, psStats->uInstCount);
+	PrintPercent("locks", psStats->uLockCount, psStats->uInstCount);
+	PrintPercent("early result reads", psStats->uDependentReadCount, psStats->uInstCount);
+	PrintPercent("estimated stall sites", psStats->uStallSiteCount, psStats->uInstCount);
+}
+
+
+/***********************************************************************************
+ Function Name      : PrintRanking
+ Inputs             : psFiles, ui32NumFiles, ui32Top
+ Outputs            : -
+ Returns            : -
+ Description        : Prints the ui32Top programs with the highest static cost.
+************************************************************************************/
+static IMG_VOID PrintRanking(const UA_FILE *psFiles, IMG_UINT32 ui32NumFiles, IMG_UINT32 ui32Top)
+{
+	IMG_UINT32 (*paui32Sorted)[2];
+	IMG_UINT32 (*paui32Ids)[2];
+	IMG_UINT32 i, j, ui32NumPrograms = 0;
+
+	for (i = 0; i < ui32NumFiles; i++)
+	{
+		ui32NumPrograms += psFiles[i].ui32NumPrograms;
+	}
+
+	if (ui32NumPrograms == 0 || ui32Top == 0)
+	{
+		return;
+	}
+
+	/* Sort (index, cycles) and look the index up in a parallel (file, program) table */
+	paui32Sorted = malloc(ui32NumPrograms * sizeof(paui32Sorted[0]));
+	paui32Ids = malloc(ui32NumPrograms * sizeof(paui32Ids[0]));
+
+	if (paui32Sorted == NULL || paui32Ids == NULL)
+	{
+		free(paui32Sorted);
+		free(paui32Ids);
+		return;
+	}
+
+	for (i = 0, ui32NumPrograms = 0; i < ui32NumFiles; i++)
+	{
+		for (j = 0; j < psFiles[i].ui32NumPrograms; j++)
+		{
+			paui32Sorted[ui32NumPrograms][0] = ui32NumPrograms;
+			paui32Sorted[ui32NumPrograms][1] = psFiles[i].psPrograms[j].ui32Cycles;
+			paui32Ids[ui32NumPrograms][0] = i;
+			paui32Ids[ui32NumPrograms][1] = j;
+			ui32NumPrograms++;
+		}
+	}
+
+	qsort(paui32Sorted, ui32NumPrograms, sizeof(paui32Sorted[0]), CompareCounts);
+
+	printf("\nmost expensive programs:\n");
+
+	for (i = 0; i < ui32NumPrograms && i < ui32Top; i++)
+	{
+		const UA_FILE *psFile = &psFiles[paui32Ids[paui32Sorted[i][0]][0]];
+		const UA_PROGRAM *psProgram = &psFile->psPrograms[paui32Ids[paui32Sorted[i][0]][1]];
+
+		printf("  %10u  %s+0x%x\n", psProgram->ui32Cycles, psFile->pszFileName, psProgram->ui32Offset);
+	}
+
+	free(paui32Sorted);
+	free(paui32Ids);
+}
+
+
+int main(int argc, char* argv[])
+{
+	UA_WORKER asWorkers[UA_MAX_THREADS];
+	UA_FILE *psFiles = NULL;
+	IMG_UINT32 ui32NumFiles = 0, ui32NumThreads = 1, ui32Top = UA_DEFAULT_TOP, ui32NumFailed = 0, i, j;
+	SGX_CORE_INFO sTargetInfo = {SGX_CORE_ID, SGX_CORE_REV};
+	PCSGX_CORE_DESC psTarget;
+	USEANALYSE_STATS sTotals;
+	IMG_BOOL bQuiet = IMG_FALSE;
+
+	while (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')
+	{
+		if (strncmp(argv[1], "-list=", strlen("-list=")) == 0)
+		{
+			if (!ParseFileList(argv[1] + strlen("-list="), &psFiles, &ui32NumFiles))
+			{
+				return 1;
+			}
+		}
+		else if (strncmp(argv[1], "-j=", strlen("-j=")) == 0)
+		{
+			ui32NumThreads = strtoul(argv[1] + strlen("-j="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-targetrev=", strlen("-targetrev=")) == 0)
+		{
+			sTargetInfo.uiRev = strtoul(argv[1] + strlen("-targetrev="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-top=", strlen("-top=")) == 0)
+		{
+			ui32Top = strtoul(argv[1] + strlen("-top="), NULL, 0);
+		}
+		else if (strcmp(argv[1], "-quiet") == 0)
+		{
+			bQuiet = IMG_TRUE;
+		}
+		else
+		{
+			fprintf(stderr, "Unknown option '%s'\n\n", argv[1]);
+			fprintf(stderr, "Usage: useanalyse [options] FILE...\n%s", g_pszOptions);
+			return 1;
+		}
+
+		memmove(&argv[1], &argv[2], (argc - 2) * sizeof(argv[1]));
+		argc--;
+	}
+
+	for (i = 1; i < (IMG_UINT32)argc; i++)
+	{
+		if (!AddFile(argv[i], &psFiles, &ui32NumFiles))
+		{
+			return 1;
+		}
+	}
+
+	if (ui32NumFiles == 0)
+	{
+		fprintf(stderr, "Usage: useanalyse [options] FILE...\n%s", g_pszOptions);
+		return 1;
+	}
+
+	psTarget = UseAsmGetCoreDesc(&sTargetInfo);
+
+	if (psTarget == NULL)
+	{
+		fprintf(stderr, "No description of core revision %u\n", sTargetInfo.uiRev);
+		return 1;
+	}
+
+	if (ui32NumThreads < 1)
+	{
+		ui32NumThreads = 1;
+	}
+	else if (ui32NumThreads > UA_MAX_THREADS)
+	{
+		ui32NumThreads = UA_MAX_THREADS;
+	}
+
+	if (ui32NumThreads > ui32NumFiles)
+	{
+		ui32NumThreads = ui32NumFiles;
+	}
+
+	for (i = 0; i < ui32NumThreads; i++)
+	{
+		asWorkers[i].psFiles = psFiles;
+		asWorkers[i].ui32NumFiles = ui32NumFiles;
+		asWorkers[i].ui32Worker = i;
+		asWorkers[i].ui32NumWorkers = ui32NumThreads;
+		asWorkers[i].psTarget = psTarget;
+		UseAnalyseInitStats(&asWorkers[i].sStats);
+	}
+
+#if defined(LINUX)
+	if (ui32NumThreads > 1)
+	{
+		/* The decoder keeps no state between instructions so files can be scanned on threads */
+		pthread_t asThreads[UA_MAX_THREADS];
+		IMG_BOOL abStarted[UA_MAX_THREADS];
+
+		for (i = 0; i < ui32NumThreads; i++)
+		{
+			abStarted[i] = (pthread_create(&asThreads[i], NULL, RunWorker, &asWorkers[i]) == 0) ? IMG_TRUE : IMG_FALSE;
+
+			if (!abStarted[i])
+			{
+				fprintf(stderr, "Couldn't start thread %u, scanning its files here\n", i);
+				RunWorker(&asWorkers[i]);
+			}
+		}
+
+		for (i = 0; i < ui32NumThreads; i++)
+		{
+			if (abStarted[i])
+			{
+				pthread_join(asThreads[i], NULL);
+			}
+		}
+	}
+	else
+#endif /* defined(LINUX) */
+	{
+		for (i = 0; i < ui32NumThreads; i++)
+		{
+			RunWorker(&asWorkers[i]);
+		}
+	}
+
+	UseAnalyseInitStats(&sTotals);
+
+	for (i = 0; i < ui32NumThreads; i++)
+	{
+		UseAnalyseMergeStats(&sTotals, &asWorkers[i].sStats);
+	}
+
+	for (i = 0; i < ui32NumFiles; i++)
+	{
+		if (psFiles[i].bFailed)
+		{
+			ui32NumFailed++;
+		}
+
+		if (bQuiet)
+		{
+			continue;
+		}
+
+		for (j = 0; j < psFiles[i].ui32NumPrograms; j++)
+		{
+			const UA_PROGRAM *psProgram = &psFiles[i].psPrograms[j];
+
+			printf("%s+0x%x: insts=%u issues=%u samples=%u dual=%u stalls=%u cycles=%u\n",
+				   psFiles[i].pszFileName, psProgram->ui32Offset, psProgram->ui32InstCount,
+				   psProgram->ui32IssueCount, psProgram->ui32TextureSampleCount,
+				   psProgram->ui32DualIssueCount, psProgram->ui32StallSiteCount, psProgram->ui32Cycles);
+		}
+	}
+
+	if (!bQuiet)
+	{
+		printf("\n");
+	}
+
+	PrintSummary(&sTotals);
+	PrintRanking(psFiles, ui32NumFiles, ui32Top);
+
+	for (i = 0; i < ui32NumFiles; i++)
+	{
+		free(psFiles[i].psPrograms);
+	}
+
+	free(psFiles);
+
+	return ui32NumFailed ? 1 : 0;
+}
+
+/******************************************************************************
+ End of file (main.c)
+******************************************************************************/
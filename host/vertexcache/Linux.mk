@@ -0,0 +1,38 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host test of the GLES2 static index buffer reorder. It checks that the
+# reordered lists draw the same triangles with the same winding, and that
+# the simulated vertex cache miss ratio improves on shuffled meshes. It
+# exits non-zero if any check fails.
+#
+
+modules := vertexcache
+
+vertexcache_type := host_executable
+
+vertexcache_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/indexopt.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header. Assertions stay on without a debug build.
+vertexcache_cflags := \
+ -DLINUX -DUSER -DPVRSRV_NEED_PVR_ASSERT \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/vertexcache/hostcontext.h
+
+vertexcache_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ intermediates/sgxsupport
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the index reorder test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of indexopt.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                reorder uses the context only to allocate its scratch
+ *                memory, which comes from the harness.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "services.h"
+#include "pvr_debug.h"
+
+#include "ogles2_types.h"
+
+#include "drvgl2.h"
+
+#include "constants.h"
+#include "names.h"
+#include "kickresource.h"
+#include "bufobj.h"
+
+#define GLES_ASSERT(expr) PVR_ASSERT(expr)
+
+#define GLES2Malloc(X,Y)		(IMG_VOID*)PVRSRVAllocUserModeMem(Y)
+#define GLES2Free(X,Y)			PVRSRVFreeUserModeMem(Y)
+
+
+struct GLES2Context_TAG
+{
+	IMG_UINT32 ui32Unused;
+};
+
+#endif /* _CONTEXT_ */
@@ -0,0 +1,547 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Static index buffer reorder test
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Runs ReorderIndicesForVertexCache (indexopt.c) over grids
+ *                drawn in row order, with their triangles shuffled, and with
+ *                their vertices renumbered as well, then over random
+ *                triangle soups and a few degenerate lists.
+ *
+ *                Every reordered list must draw exactly the triangles of
+ *                the original, each with its vertices in the original
+ *                order. The average cache miss ratio (vertex transforms per
+ *                triangle, ACMR) is measured with a FIFO cache of
+ *                GLES2_INDEX_OPTIMISER_CACHE_SIZE entries that is simulated
+ *                here independently of the driver. The reorder must not make
+ *                any grid worse, and must bring a shuffled grid down to
+ *                VC_MAX_SHUFFLED_GRID_ACMR.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "hostcontext.h"
+
+
+#define VC_DEFAULT_GRID_SIZE		100
+#define VC_NUM_SOUPS				8
+
+/*
+	An ideal order for a large grid transforms each vertex once, an ACMR of
+	0.5. A 16-entry FIFO cache can't hold a whole row, so expect a little
+	above that. A shuffled grid is near 3, every vertex of every triangle.
+*/
+#define VC_MAX_SHUFFLED_GRID_ACMR	0.75f
+
+typedef struct _VC_MESH_
+{
+	IMG_UINT16	*pui16Indices;
+	IMG_UINT32	ui32NumIndices;
+	IMG_UINT32	ui32NumVertices;
+
+} VC_MESH;
+
+static GLES2Context g_sGC;
+static IMG_UINT32 g_ui32NumErrors;
+static IMG_UINT32 g_ui32Random = 1;
+static IMG_BOOL g_bFailAllocations = IMG_FALSE;
+static IMG_BOOL g_bVerbose = IMG_FALSE;
+
+static IMG_CHAR const* g_pszOptions =
+"-grid=N     Grids are N by N vertices (default 100, at most 256).\n"
+"-seed=N     Seed for the shuffles and soups (default 1).\n"
+"-v          Print the ACMR of every mesh, not just the grids.\n";
+
+
+/***********************************************************************************
+ Function Name      : Fail
+ Inputs             : pszFormat, ...
+ Outputs            : -
+ Returns            : -
+ Description        : Records a failed check
+************************************************************************************/
+static IMG_VOID Fail(const IMG_CHAR *pszFormat, ...)
+{
+	va_list sArgs;
+
+	g_ui32NumErrors++;
+
+	va_start(sArgs, pszFormat);
+	fprintf(stderr, "error: ");
+	vfprintf(stderr, pszFormat, sArgs);
+	fprintf(stderr, "\n");
+	va_end(sArgs);
+}
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number below ui32Range
+ Description        : xorshift32, so a seed always gives the same sequence
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/*
+** Services mocks
+*/
+
+IMG_EXPORT IMG_PVOID IMG_CALLCONV PVRSRVAllocUserModeMem(IMG_SIZE_T ui32Size)
+{
+	return g_bFailAllocations ? IMG_NULL : malloc(ui32Size);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVFreeUserModeMem(IMG_PVOID pvMem)
+{
+	free(pvMem);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugAssertFail(const IMG_CHAR *pszFile, IMG_UINT32 ui32Line)
+{
+	fprintf(stderr, "error: assertion failed at %s:%u\n", pszFile, ui32Line);
+	exit(1);
+}
+
+IMG_EXPORT IMG_VOID IMG_CALLCONV PVRSRVDebugPrintf(IMG_UINT32 ui32DebugLevel, const IMG_CHAR *pszFileName,
+												   IMG_UINT32 ui32Line, const IMG_CHAR *pszFormat, ...)
+{
+	PVR_UNREFERENCED_PARAMETER(ui32DebugLevel);
+	PVR_UNREFERENCED_PARAMETER(pszFileName);
+	PVR_UNREFERENCED_PARAMETER(ui32Line);
+	PVR_UNREFERENCED_PARAMETER(pszFormat);
+}
+
+
+/***********************************************************************************
+ Function Name      : SimulateACMR
+ Inputs             : psMesh, pui16Indices
+ Outputs            : -
+ Returns            : Vertex transforms per triangle
+ Description        : Plays a triangle list through a FIFO post-transform cache of
+					  GLES2_INDEX_OPTIMISER_CACHE_SIZE entries
+************************************************************************************/
+static IMG_FLOAT SimulateACMR(const VC_MESH *psMesh, const IMG_UINT16 *pui16Indices)
+{
+	IMG_UINT32 aui32Cache[GLES2_INDEX_OPTIMISER_CACHE_SIZE];
+	IMG_UINT32 ui32Filled = 0, ui32Next = 0, ui32Misses = 0, i, j;
+
+	for(i = 0; i < psMesh->ui32NumIndices; i++)
+	{
+		for(j = 0; j < ui32Filled; j++)
+		{
+			if(aui32Cache[j] == pui16Indices[i])
+			{
+				break;
+			}
+		}
+
+		if(j == ui32Filled)
+		{
+			aui32Cache[ui32Next] = pui16Indices[i];
+			ui32Next = (ui32Next + 1) % GLES2_INDEX_OPTIMISER_CACHE_SIZE;
+
+			if(ui32Filled < GLES2_INDEX_OPTIMISER_CACHE_SIZE)
+			{
+				ui32Filled++;
+			}
+
+			ui32Misses++;
+		}
+	}
+
+	return (IMG_FLOAT)ui32Misses / (IMG_FLOAT)(psMesh->ui32NumIndices / 3);
+}
+
+
+/***********************************************************************************
+ Function Name      : CompareTriangles
+ Inputs             : pvA, pvB
+ Outputs            : -
+ Returns            : qsort ordering of two triangles
+ Description        : Orders triangles by their vertices, first vertex first. The
+					  vertices within a triangle are not sorted, so winding counts.
+************************************************************************************/
+static int CompareTriangles(const void *pvA, const void *pvB)
+{
+	const IMG_UINT16 *pui16A = (const IMG_UINT16 *)pvA;
+	const IMG_UINT16 *pui16B = (const IMG_UINT16 *)pvB;
+	IMG_UINT32 i;
+
+	for(i = 0; i < 3; i++)
+	{
+		if(pui16A[i] != pui16B[i])
+		{
+			return (pui16A[i] < pui16B[i]) ? -1 : 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/***********************************************************************************
+ Function Name      : CheckSameTriangles
+ Inputs             : psMesh, pui16Reordered
+ Outputs            : -
+ Returns            : IMG_TRUE if the lists hold the same triangles
+ Description        : Sorts copies of both lists by triangle and compares them
+************************************************************************************/
+static IMG_BOOL CheckSameTriangles(const VC_MESH *psMesh, const IMG_UINT16 *pui16Reordered)
+{
+	IMG_UINT32 ui32Bytes = psMesh->ui32NumIndices * sizeof(IMG_UINT16);
+	IMG_UINT16 *pui16A = malloc(ui32Bytes);
+	IMG_UINT16 *pui16B = malloc(ui32Bytes);
+	IMG_BOOL bSame;
+
+	if(!pui16A || !pui16B)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	memcpy(pui16A, psMesh->pui16Indices, ui32Bytes);
+	memcpy(pui16B, pui16Reordered, ui32Bytes);
+
+	qsort(pui16A, psMesh->ui32NumIndices / 3, 3 * sizeof(IMG_UINT16), CompareTriangles);
+	qsort(pui16B, psMesh->ui32NumIndices / 3, 3 * sizeof(IMG_UINT16), CompareTriangles);
+
+	bSame = (memcmp(pui16A, pui16B, ui32Bytes) == 0) ? IMG_TRUE : IMG_FALSE;
+
+	free(pui16A);
+	free(pui16B);
+
+	return bSame;
+}
+
+
+/***********************************************************************************
+ Function Name      : RunMesh
+ Inputs             : pszName, psMesh, fMaxACMR, bMustNotWorsen, bPrint
+ Outputs            : -
+ Returns            : -
+ Description        : Reorders one mesh and checks the result. fMaxACMR of 0 means
+					  no bound.
+************************************************************************************/
+static IMG_VOID RunMesh(const IMG_CHAR *pszName, const VC_MESH *psMesh, IMG_FLOAT fMaxACMR,
+						IMG_BOOL bMustNotWorsen, IMG_BOOL bPrint)
+{
+	IMG_UINT16 *pui16Reordered;
+	IMG_FLOAT fBefore, fAfter;
+
+	/* One spare index either side to catch writes out of bounds */
+	pui16Reordered = malloc((psMesh->ui32NumIndices + 2) * sizeof(IMG_UINT16));
+
+	if(!pui16Reordered)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	pui16Reordered[0] = 0xDEAD;
+	pui16Reordered[psMesh->ui32NumIndices + 1] = 0xBEEF;
+
+	if(!ReorderIndicesForVertexCache(&g_sGC, psMesh->pui16Indices, pui16Reordered + 1, psMesh->ui32NumIndices))
+	{
+		Fail("%s: reorder failed", pszName);
+		free(pui16Reordered);
+		return;
+	}
+
+	if(pui16Reordered[0] != 0xDEAD || pui16Reordered[psMesh->ui32NumIndices + 1] != 0xBEEF)
+	{
+		Fail("%s: reorder wrote outside the destination", pszName);
+	}
+
+	if(!CheckSameTriangles(psMesh, pui16Reordered + 1))
+	{
+		Fail("%s: reordered list draws different triangles", pszName);
+	}
+
+	fBefore = SimulateACMR(psMesh, psMesh->pui16Indices);
+	fAfter = SimulateACMR(psMesh, pui16Reordered + 1);
+
+	if(bPrint || g_bVerbose)
+	{
+		printf("%-28s %6u triangles  ACMR %.3f -> %.3f\n", pszName, psMesh->ui32NumIndices / 3, fBefore, fAfter);
+	}
+
+	if(bMustNotWorsen && fAfter > fBefore)
+	{
+		Fail("%s: ACMR rose from %.3f to %.3f", pszName, fBefore, fAfter);
+	}
+
+	if(fMaxACMR > 0.0f && fAfter > fMaxACMR)
+	{
+		Fail("%s: ACMR %.3f is above %.3f", pszName, fAfter, fMaxACMR);
+	}
+
+	free(pui16Reordered);
+}
+
+
+/***********************************************************************************
+ Function Name      : BuildGrid
+ Inputs             : ui32Size
+ Outputs            : psMesh
+ Returns            : -
+ Description        : Builds a triangle list for a square grid of ui32Size by
+					  ui32Size vertices, row by row, two triangles per quad
+************************************************************************************/
+static IMG_VOID BuildGrid(VC_MESH *psMesh, IMG_UINT32 ui32Size)
+{
+	IMG_UINT32 x, y, i = 0;
+
+	psMesh->ui32NumVertices = ui32Size * ui32Size;
+	psMesh->ui32NumIndices = (ui32Size - 1) * (ui32Size - 1) * 6;
+	psMesh->pui16Indices = malloc(psMesh->ui32NumIndices * sizeof(IMG_UINT16));
+
+	if(!psMesh->pui16Indices)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	for(y = 0; y < ui32Size - 1; y++)
+	{
+		for(x = 0; x < ui32Size - 1; x++)
+		{
+			IMG_UINT16 ui16V0 = (IMG_UINT16)(y * ui32Size + x);
+			IMG_UINT16 ui16V1 = (IMG_UINT16)(ui16V0 + 1);
+			IMG_UINT16 ui16V2 = (IMG_UINT16)(ui16V0 + ui32Size);
+			IMG_UINT16 ui16V3 = (IMG_UINT16)(ui16V2 + 1);
+
+			psMesh->pui16Indices[i++] = ui16V0;
+			psMesh->pui16Indices[i++] = ui16V2;
+			psMesh->pui16Indices[i++] = ui16V1;
+
+			psMesh->pui16Indices[i++] = ui16V1;
+			psMesh->pui16Indices[i++] = ui16V2;
+			psMesh->pui16Indices[i++] = ui16V3;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : ShuffleTriangles
+ Inputs             : psMesh
+ Outputs            : psMesh
+ Returns            : -
+ Description        : Fisher-Yates shuffle of the triangle order
+************************************************************************************/
+static IMG_VOID ShuffleTriangles(VC_MESH *psMesh)
+{
+	IMG_UINT32 i, k;
+
+	for(i = psMesh->ui32NumIndices / 3; i > 1; i--)
+	{
+		IMG_UINT32 j = Random(i);
+
+		for(k = 0; k < 3; k++)
+		{
+			IMG_UINT16 ui16Temp = psMesh->pui16Indices[(i - 1) * 3 + k];
+
+			psMesh->pui16Indices[(i - 1) * 3 + k] = psMesh->pui16Indices[j * 3 + k];
+			psMesh->pui16Indices[j * 3 + k] = ui16Temp;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : RenumberVertices
+ Inputs             : psMesh
+ Outputs            : psMesh
+ Returns            : -
+ Description        : Applies a random permutation to the vertex numbers, so the
+					  reorder's forward scan for a new start vertex gets no help
+					  from the grid layout
+************************************************************************************/
+static IMG_VOID RenumberVertices(VC_MESH *psMesh)
+{
+	IMG_UINT16 *pui16Map = malloc(psMesh->ui32NumVertices * sizeof(IMG_UINT16));
+	IMG_UINT32 i;
+
+	if(!pui16Map)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	for(i = 0; i < psMesh->ui32NumVertices; i++)
+	{
+		pui16Map[i] = (IMG_UINT16)i;
+	}
+
+	for(i = psMesh->ui32NumVertices; i > 1; i--)
+	{
+		IMG_UINT32 j = Random(i);
+		IMG_UINT16 ui16Temp = pui16Map[i - 1];
+
+		pui16Map[i - 1] = pui16Map[j];
+		pui16Map[j] = ui16Temp;
+	}
+
+	for(i = 0; i < psMesh->ui32NumIndices; i++)
+	{
+		psMesh->pui16Indices[i] = pui16Map[psMesh->pui16Indices[i]];
+	}
+
+	free(pui16Map);
+}
+
+
+/***********************************************************************************
+ Function Name      : BuildSoup
+ Inputs             : ui32NumTriangles, ui32NumVertices
+ Outputs            : psMesh
+ Returns            : -
+ Description        : Builds a list of random triangles, some degenerate
+************************************************************************************/
+static IMG_VOID BuildSoup(VC_MESH *psMesh, IMG_UINT32 ui32NumTriangles, IMG_UINT32 ui32NumVertices)
+{
+	IMG_UINT32 i;
+
+	psMesh->ui32NumVertices = ui32NumVertices;
+	psMesh->ui32NumIndices = ui32NumTriangles * 3;
+	psMesh->pui16Indices = malloc(psMesh->ui32NumIndices * sizeof(IMG_UINT16));
+
+	if(!psMesh->pui16Indices)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		exit(1);
+	}
+
+	for(i = 0; i < psMesh->ui32NumIndices; i++)
+	{
+		psMesh->pui16Indices[i] = (IMG_UINT16)Random(ui32NumVertices);
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : main
+ Inputs             : argc, argv
+ Outputs            : -
+ Returns            : 0 if every check passed, 1 otherwise
+ Description        : Runs the grids, soups and small cases
+************************************************************************************/
+int main(int argc, char* argv[])
+{
+	static IMG_UINT16 aui16Single[] = {7, 3, 5};
+	static IMG_UINT16 aui16Degenerate[] = {0, 0, 0, 1, 1, 2, 2, 1, 1, 0, 0, 0};
+	static IMG_UINT16 aui16TopVertex[] = {65535, 0, 1, 1, 65535, 65534};
+	IMG_UINT32 ui32GridSize = VC_DEFAULT_GRID_SIZE, ui32Seed = 1, i;
+	IMG_CHAR acName[64];
+	VC_MESH sMesh;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-grid=", strlen("-grid=")) == 0)
+		{
+			ui32GridSize = strtoul(argv[1] + strlen("-grid="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else if (strcmp(argv[1], "-v") == 0)
+		{
+			g_bVerbose = IMG_TRUE;
+		}
+		else
+		{
+			fprintf(stderr, "Usage: vertexcache [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	if(ui32GridSize < 2 || ui32GridSize > 256)
+	{
+		fprintf(stderr, "error: grids must be 2 to 256 vertices wide\n");
+		return 1;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	/* Grids: as drawn, triangles shuffled, and shuffled with the vertices renumbered */
+	BuildGrid(&sMesh, ui32GridSize);
+	sprintf(acName, "%ux%u grid", ui32GridSize, ui32GridSize);
+	RunMesh(acName, &sMesh, 0.0f, IMG_TRUE, IMG_TRUE);
+
+	ShuffleTriangles(&sMesh);
+	sprintf(acName, "%ux%u grid, shuffled", ui32GridSize, ui32GridSize);
+	RunMesh(acName, &sMesh, (ui32GridSize >= 16) ? VC_MAX_SHUFFLED_GRID_ACMR : 0.0f, IMG_TRUE, IMG_TRUE);
+
+	RenumberVertices(&sMesh);
+	sprintf(acName, "%ux%u grid, renumbered", ui32GridSize, ui32GridSize);
+	RunMesh(acName, &sMesh, (ui32GridSize >= 16) ? VC_MAX_SHUFFLED_GRID_ACMR : 0.0f, IMG_TRUE, IMG_TRUE);
+
+	free(sMesh.pui16Indices);
+
+	/* Soups have little locality to find, so only the triangles are checked */
+	for(i = 0; i < VC_NUM_SOUPS; i++)
+	{
+		BuildSoup(&sMesh, 1 + Random(20000), 1 + Random(65536));
+		sprintf(acName, "soup %u", i);
+		RunMesh(acName, &sMesh, 0.0f, IMG_FALSE, IMG_FALSE);
+		free(sMesh.pui16Indices);
+	}
+
+	sMesh.pui16Indices = aui16Single;
+	sMesh.ui32NumIndices = sizeof(aui16Single) / sizeof(aui16Single[0]);
+	sMesh.ui32NumVertices = 8;
+	RunMesh("single triangle", &sMesh, 0.0f, IMG_TRUE, IMG_FALSE);
+
+	sMesh.pui16Indices = aui16Degenerate;
+	sMesh.ui32NumIndices = sizeof(aui16Degenerate) / sizeof(aui16Degenerate[0]);
+	sMesh.ui32NumVertices = 3;
+	RunMesh("degenerate triangles", &sMesh, 0.0f, IMG_TRUE, IMG_FALSE);
+
+	sMesh.pui16Indices = aui16TopVertex;
+	sMesh.ui32NumIndices = sizeof(aui16TopVertex) / sizeof(aui16TopVertex[0]);
+	sMesh.ui32NumVertices = 65536;
+	RunMesh("vertex 65535", &sMesh, 0.0f, IMG_TRUE, IMG_FALSE);
+
+	/* glBufferData keeps the application's order when the scratch allocation fails */
+	g_bFailAllocations = IMG_TRUE;
+
+	if(ReorderIndicesForVertexCache(&g_sGC, aui16Single, aui16Single, 3))
+	{
+		Fail("reorder succeeded without its scratch memory");
+	}
+
+	g_bFailAllocations = IMG_FALSE;
+
+	printf("%s\n", g_ui32NumErrors ? "FAILED" : "PASSED");
+
+	return g_ui32NumErrors ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+# Copyright	2010 Imagination Technologies Limited. All rights reserved.
+#
+# No part of this software, either material or conceptual may be
+# copied or distributed, transmitted, transcribed, stored in a
+# retrieval system or translated into any human or computer
+# language in any form by any means, electronic, mechanical,
+# manual or other-wise, or disclosed to third parties without the
+# express written permission of: Imagination Technologies
+# Limited, HomePark Industrial Estate, Kings Langley,
+# Hertfordshire, WD4 8LZ, UK
+#
+# $Log: Linux.mk $
+#
+# Host benchmark of the GLES2 client array deindexing kernels. It reports
+# vertices per second for the per-vertex copy loop and for the gather
+# kernels, and exits non-zero if their outputs differ.
+#
+
+modules := vertexgather
+
+vertexgather_type := host_executable
+
+vertexgather_src = \
+ main.c \
+ $(TOP)/eurasiacon/opengles2/vertexcopy.c
+
+# hostcontext.h stands in for the driver's context.h, and host/include for
+# the platform kernel header.
+vertexgather_cflags := \
+ -DLINUX -DUSER \
+ -include $(TOP)/include/gpu_es4/psp2_pvr_desc.h \
+ -include $(TOP)/host/vertexgather/hostcontext.h
+
+vertexgather_includes := host/include include/gpu_es4 \
+ include/gpu_es4/eurasia/include4 include/gpu_es4/eurasia/hwdefs \
+ eurasiacon/include eurasiacon/common eurasiacon/opengles2 \
+ intermediates/sgxsupport
@@ -0,0 +1,46 @@
+/******************************************************************************
+ * Name         : hostcontext.h
+ * Title        : Host build of the GLES2 context for the gather benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Force-included ahead of vertexcopy.c in place of the
+ *                driver's context.h, whose include guard it defines. The
+ *                kernels need only the stream types and table declarations
+ *                from attrib.h and GLES2MemCopy.
+ *
+ * Modifications:-
+ * $Log: hostcontext.h $
+ *****************************************************************************/
+
+#ifndef _CONTEXT_
+#define _CONTEXT_
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "services.h"
+
+#include "ogles2_types.h"
+
+#include "drvgl2.h"
+
+#include "constants.h"
+#include "names.h"
+#include "kickresource.h"
+#include "bufobj.h"
+#include "attrib.h"
+
+#define	GLES2MemCopy(X,Y,Z)		memcpy(X, Y, Z)
+
+#endif /* _CONTEXT_ */
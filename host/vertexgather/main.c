@@ -0,0 +1,329 @@
+/******************************************************************************
+ * Name         : main.c
+ * Title        : Client array gather benchmark
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Times the two ways CopyVArrayDataDeindex (drawvarray.c) can
+ *                deindex a client attribute array into the vertex buffer:
+ *                one pfnCopyData call per vertex, as the driver did before
+ *                the gather kernels, and one GatherData call per attribute.
+ *                Each stream type and size is run with a tightly packed and
+ *                an interleaved source, and with 16-bit and 32-bit indices
+ *                in shuffled order. The kernels are the driver's own
+ *                (vertexcopy.c), picked from the tables the way validate.c
+ *                picks them.
+ *
+ *                Both outputs are checked against a plain memcpy of each
+ *                indexed vertex, and the run fails if either differs.
+ *
+ * Modifications:-
+ * $Log: main.c $
+ *****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hostcontext.h"
+
+
+#define VG_DEFAULT_VERTICES			4096
+#define VG_DEFAULT_INDICES			6144
+#define VG_DEFAULT_REPEATS			200
+
+/* Stride of the interleaved source. Large enough for the largest attribute */
+#define VG_INTERLEAVED_STRIDE		32
+
+/* As aui32AttribSize in validate.c */
+static const IMG_UINT32 g_aui32AttribSize[GLES2_STREAMTYPE_MAX] = {1, 1, 2, 2, 4, 2, 4};
+
+static const IMG_CHAR * const g_apszTypeNames[GLES2_STREAMTYPE_MAX] =
+{
+	"byte", "ubyte", "short", "ushort", "float", "half", "fixed"
+};
+
+typedef IMG_VOID (*PFN_COPYDATA)(const IMG_UINT8 *pui8Src, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, IMG_UINT32 ui32Count);
+typedef IMG_VOID (*PFN_GATHERDATA)(const IMG_UINT8 *pui8SrcBase, IMG_UINT8 * IMG_RESTRICT pui8Dst, IMG_UINT32 ui32SrcStride, const IMG_VOID *pvElements, IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count);
+
+static IMG_UINT32 g_ui32Random = 1;
+
+static IMG_CHAR const* g_pszOptions =
+"-vertices=N Size of the source arrays in vertices (default 4096).\n"
+"-indices=N  Indices per draw (default 6144).\n"
+"-reps=N     Draws timed per case (default 200). 0 checks the outputs only.\n"
+"-seed=N     Seed for the source data and indices (default 1).\n";
+
+
+/***********************************************************************************
+ Function Name      : Random
+ Inputs             : ui32Range
+ Outputs            : -
+ Returns            : Pseudo-random number in [0, ui32Range)
+ Description        : xorshift32, so runs are repeatable from the seed
+************************************************************************************/
+static IMG_UINT32 Random(IMG_UINT32 ui32Range)
+{
+	g_ui32Random ^= g_ui32Random << 13;
+	g_ui32Random ^= g_ui32Random >> 17;
+	g_ui32Random ^= g_ui32Random << 5;
+
+	return g_ui32Random % ui32Range;
+}
+
+
+/***********************************************************************************
+ Function Name      : GetSeconds
+ Inputs             : -
+ Outputs            : -
+ Returns            : Monotonic time in seconds
+ Description        : Timer for the benchmark loops
+************************************************************************************/
+static double GetSeconds(IMG_VOID)
+{
+	struct timespec sTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &sTime);
+
+	return (double)sTime.tv_sec + (double)sTime.tv_nsec * 1e-9;
+}
+
+
+/***********************************************************************************
+ Function Name      : DeindexPerVertex
+ Inputs             : pfnCopyData, pui8SrcBase, ui32Stride, ui32DstSize, pvElements,
+					  bAreElements32Bit, ui32Count
+ Outputs            : pui8Dst
+ Returns            : -
+ Description        : The deindexing loop CopyVArrayDataDeindex used before the
+					  gather kernels: one copy call per vertex
+************************************************************************************/
+static IMG_VOID DeindexPerVertex(PFN_COPYDATA pfnCopyData, const IMG_UINT8 *pui8SrcBase, IMG_UINT8 *pui8Dst,
+								 IMG_UINT32 ui32Stride, IMG_UINT32 ui32DstSize, const IMG_VOID *pvElements,
+								 IMG_BOOL bAreElements32Bit, IMG_UINT32 ui32Count)
+{
+	const IMG_UINT8 *pui8Src;
+	IMG_UINT32 j;
+
+	if(bAreElements32Bit)
+	{
+		const IMG_UINT32 *pui32Elements = (const IMG_UINT32 *)pvElements;
+
+		for(j=0; j < ui32Count; j++)
+		{
+			pui8Src = pui8SrcBase + pui32Elements[j] * ui32Stride;
+
+			pfnCopyData(pui8Src, pui8Dst, ui32Stride, 1);
+
+			pui8Dst += ui32DstSize;
+		}
+	}
+	else
+	{
+		const IMG_UINT16 *pui16Elements = (const IMG_UINT16 *)pvElements;
+
+		for(j=0; j < ui32Count; j++)
+		{
+			pui8Src = pui8SrcBase + pui16Elements[j] * ui32Stride;
+
+			pfnCopyData(pui8Src, pui8Dst, ui32Stride, 1);
+
+			pui8Dst += ui32DstSize;
+		}
+	}
+}
+
+
+/***********************************************************************************
+ Function Name      : main
+ Inputs             : argc, argv
+ Outputs            : -
+ Returns            : 0 if every output matched the reference, 1 otherwise
+ Description        : Runs every stream type, size, source layout and index width
+************************************************************************************/
+int main(int argc, char* argv[])
+{
+	IMG_UINT32 ui32NumVertices = VG_DEFAULT_VERTICES, ui32NumIndices = VG_DEFAULT_INDICES;
+	IMG_UINT32 ui32Repeats = VG_DEFAULT_REPEATS, ui32Seed = 1;
+	IMG_UINT32 ui32Type, ui32Components, ui32Layout, ui32Index32, i, j;
+	IMG_UINT32 ui32NumCases = 0, ui32NumFailures = 0;
+	IMG_UINT8 *pui8Src, *pui8Reference, *pui8Old, *pui8New;
+	IMG_UINT16 *pui16Elements;
+	IMG_UINT32 *pui32Elements;
+	double dOldTotal = 0.0, dNewTotal = 0.0;
+
+	while (argc > 1 && argv[1][0] == '-')
+	{
+		if (strncmp(argv[1], "-vertices=", strlen("-vertices=")) == 0)
+		{
+			ui32NumVertices = strtoul(argv[1] + strlen("-vertices="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-indices=", strlen("-indices=")) == 0)
+		{
+			ui32NumIndices = strtoul(argv[1] + strlen("-indices="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-reps=", strlen("-reps=")) == 0)
+		{
+			ui32Repeats = strtoul(argv[1] + strlen("-reps="), NULL, 0);
+		}
+		else if (strncmp(argv[1], "-seed=", strlen("-seed=")) == 0)
+		{
+			ui32Seed = strtoul(argv[1] + strlen("-seed="), NULL, 0);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: vertexgather [options]\n%s", g_pszOptions);
+			return 1;
+		}
+
+		argc--;
+		argv++;
+	}
+
+	if(ui32NumVertices == 0 || ui32NumVertices > 65536 || ui32NumIndices == 0)
+	{
+		fprintf(stderr, "error: need 1 to 65536 vertices and at least 1 index\n");
+		return 1;
+	}
+
+	g_ui32Random = ui32Seed ? ui32Seed : 1;
+
+	pui8Src			= malloc(ui32NumVertices * VG_INTERLEAVED_STRIDE);
+	pui8Reference	= malloc(ui32NumIndices * 16);
+	pui8Old			= malloc(ui32NumIndices * 16);
+	pui8New			= malloc(ui32NumIndices * 16);
+	pui16Elements	= malloc(ui32NumIndices * sizeof(IMG_UINT16));
+	pui32Elements	= malloc(ui32NumIndices * sizeof(IMG_UINT32));
+
+	if(!pui8Src || !pui8Reference || !pui8Old || !pui8New || !pui16Elements || !pui32Elements)
+	{
+		fprintf(stderr, "error: out of memory\n");
+		return 1;
+	}
+
+	for(i = 0; i < ui32NumVertices * VG_INTERLEAVED_STRIDE; i++)
+	{
+		pui8Src[i] = (IMG_UINT8)Random(256);
+	}
+
+	/* Shuffled, so consecutive indices rarely share a cache line of the source */
+	for(i = 0; i < ui32NumIndices; i++)
+	{
+		pui32Elements[i] = Random(ui32NumVertices);
+		pui16Elements[i] = (IMG_UINT16)pui32Elements[i];
+	}
+
+	printf("%u vertices, %u indices, %u draws per case (seed %u)\n", ui32NumVertices, ui32NumIndices, ui32Repeats, ui32Seed);
+	printf("%-7s %4s %-12s %5s %14s %14s %8s\n", "type", "size", "source", "index", "per-vertex", "gather", "speedup");
+
+	for(ui32Type = 0; ui32Type < GLES2_STREAMTYPE_MAX; ui32Type++)
+	{
+		for(ui32Components = 1; ui32Components <= 4; ui32Components++)
+		{
+			IMG_UINT32 ui32Size = ui32Components * g_aui32AttribSize[ui32Type];
+
+			for(ui32Layout = 0; ui32Layout < 2; ui32Layout++)
+			{
+				IMG_UINT32 ui32Stride = ui32Layout ? VG_INTERLEAVED_STRIDE : ui32Size;
+
+				/* As validate.c: a tightly packed array copies with memcpy */
+				PFN_COPYDATA pfnCopyData = ui32Layout ? CopyData[ui32Components - 1][ui32Type] : MemCopyData[ui32Components - 1][ui32Type];
+				PFN_GATHERDATA pfnGatherData = GatherData[ui32Components - 1][ui32Type];
+
+				for(ui32Index32 = 0; ui32Index32 < 2; ui32Index32++)
+				{
+					const IMG_VOID *pvElements = ui32Index32 ? (const IMG_VOID *)pui32Elements : (const IMG_VOID *)pui16Elements;
+					IMG_BOOL bAreElements32Bit = ui32Index32 ? IMG_TRUE : IMG_FALSE;
+					double dStart, dOld = 0.0, dNew = 0.0;
+
+					for(j = 0; j < ui32NumIndices; j++)
+					{
+						memcpy(pui8Reference + j * ui32Size, pui8Src + pui32Elements[j] * ui32Stride, ui32Size);
+					}
+
+					memset(pui8Old, 0xCD, ui32NumIndices * ui32Size);
+					memset(pui8New, 0xCD, ui32NumIndices * ui32Size);
+
+					DeindexPerVertex(pfnCopyData, pui8Src, pui8Old, ui32Stride, ui32Size, pvElements, bAreElements32Bit, ui32NumIndices);
+					pfnGatherData(pui8Src, pui8New, ui32Stride, pvElements, bAreElements32Bit, ui32NumIndices);
+
+					ui32NumCases++;
+
+					if(memcmp(pui8Old, pui8Reference, ui32NumIndices * ui32Size) != 0 ||
+					   memcmp(pui8New, pui8Reference, ui32NumIndices * ui32Size) != 0)
+					{
+						fprintf(stderr, "FAIL: %s x%u, %s source, %u-bit indices: %s output differs from the reference\n",
+								g_apszTypeNames[ui32Type], ui32Components, ui32Layout ? "interleaved" : "packed",
+								ui32Index32 ? 32 : 16,
+								memcmp(pui8New, pui8Reference, ui32NumIndices * ui32Size) ? "gather" : "per-vertex");
+
+						ui32NumFailures++;
+
+						continue;
+					}
+
+					if(!ui32Repeats)
+					{
+						continue;
+					}
+
+					dStart = GetSeconds();
+
+					for(i = 0; i < ui32Repeats; i++)
+					{
+						DeindexPerVertex(pfnCopyData, pui8Src, pui8Old, ui32Stride, ui32Size, pvElements, bAreElements32Bit, ui32NumIndices);
+					}
+
+					dOld = GetSeconds() - dStart;
+					dStart = GetSeconds();
+
+					for(i = 0; i < ui32Repeats; i++)
+					{
+						pfnGatherData(pui8Src, pui8New, ui32Stride, pvElements, bAreElements32Bit, ui32NumIndices);
+					}
+
+					dNew = GetSeconds() - dStart;
+
+					dOldTotal += dOld;
+					dNewTotal += dNew;
+
+					printf("%-7s %4u %-12s %5u %9.1f Mv/s %9.1f Mv/s %7.2fx\n",
+						   g_apszTypeNames[ui32Type], ui32Components, ui32Layout ? "interleaved" : "packed",
+						   ui32Index32 ? 32 : 16,
+						   (double)ui32Repeats * ui32NumIndices / dOld * 1e-6,
+						   (double)ui32Repeats * ui32NumIndices / dNew * 1e-6,
+						   dOld / dNew);
+				}
+			}
+		}
+	}
+
+	if(ui32Repeats && dOldTotal > 0.0 && dNewTotal > 0.0)
+	{
+		double dVertices = (double)ui32Repeats * ui32NumIndices * (ui32NumCases - ui32NumFailures);
+
+		printf("all cases: per-vertex %.1f Mv/s, gather %.1f Mv/s, %.2fx\n",
+			   dVertices / dOldTotal * 1e-6, dVertices / dNewTotal * 1e-6, dOldTotal / dNewTotal);
+	}
+
+	free(pui8Src);
+	free(pui8Reference);
+	free(pui8Old);
+	free(pui8New);
+	free(pui16Elements);
+	free(pui32Elements);
+
+	printf("%u cases, %u failed: %s\n", ui32NumCases, ui32NumFailures, ui32NumFailures ? "FAILED" : "PASSED");
+
+	return ui32NumFailures ? 1 : 0;
+}
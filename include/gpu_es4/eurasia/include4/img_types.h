@@ -92,6 +92,10 @@ typedef IMG_INT32       IMG_RESULT;
 	typedef unsigned __int64	IMG_UINTPTR_T;
 	typedef signed __int64		IMG_PTRDIFF_T;
 	typedef IMG_UINT64			IMG_SIZE_T;
+#elif defined(__LP64__)
+	/* 64-bit host tools */
+	typedef unsigned long		IMG_UINTPTR_T;
+	typedef IMG_UINT32		IMG_SIZE_T;
 #else
 	typedef unsigned int	IMG_UINTPTR_T;
 	typedef IMG_UINT32		IMG_SIZE_T;
@@ -2918,7 +2918,7 @@ static IMG_BOOL PPProcessVersion(GLSLCompilerPrivateData *psCPD,
 		 * OGL64 Review.
 		 * ...?
 		 */
-		asToken.pszStartOfLine = (IMG_CHAR*)(IMG_SIZE_T)(uVersion);
+		asToken.pszStartOfLine = (IMG_CHAR*)(IMG_UINTPTR_T)(uVersion);
 
 		/* Insert a version change token into the list */
 		PPInsertTokensIntoLinkedList(psTokMemHeap, psTokenEntry, &asToken, 1, IMG_NULL);
@@ -3194,7 +3194,7 @@ ExtensionNotSupportedWarning:
 	 * OGL64 Review.
 	 * ...what is going on here?
 	 */
-	acTokens[1].pszStartOfLine = (IMG_CHAR*)(IMG_SIZE_T)psContext->eEnabledExtensions;
+	acTokens[1].pszStartOfLine = (IMG_CHAR*)(IMG_UINTPTR_T)psContext->eEnabledExtensions;
 
 	/* Insert some version change tokens into the list */
 	PPInsertTokensIntoLinkedList(psTokMemHeap, psTokenEntry, acTokens, 2, IMG_NULL);
@@ -3471,6 +3471,10 @@ IMG_INTERNAL IMG_BOOL PPPreProcessTokenList(GLSLCompilerPrivateData *psCPD,
 	if(!psSymbolTable)
 		return IMG_FALSE;
 
+	/* Every identifier token is looked up here, so index the macro names rather
+	   than scanning the whole table. Without the index lookups are just slower. */
+	EnableSymTableHashing(psSymbolTable, 256);
+
 	/* 1.2 seems to be a fairly consistant ratio */
 	/* Using 1.25 to avoid floating point multiply */
 	psTokMemHeap = DebugCreateHeap(sizeof(TokenLL), uNumTokens + (uNumTokens >> 2));
@@ -32,6 +32,12 @@
 #endif
 #include "debug.h"
 
+#if defined(__psp2__)
+#define GLSL_LOGFILE_DIR "ux0:data/gles/glsl/logfiles"
+#else
+#define GLSL_LOGFILE_DIR "logfiles"
+#endif
+
 
 #if !defined(STANDALONE)
 #include "pvr_debug.h"
@@ -100,6 +106,7 @@ IMG_INTERNAL IMG_BOOL CreateLogFile(LogFile eLogFile, IMG_CHAR *pszFileName)
 		return IMG_FALSE;
 	}
 
+#if defined(__psp2__)
 	SceUID fd = sceIoDopen("ux0:data/gles/glsl/logfiles");
 
 	if (fd <= 0)
@@ -125,10 +132,19 @@ IMG_INTERNAL IMG_BOOL CreateLogFile(LogFile eLogFile, IMG_CHAR *pszFileName)
 		sceIoDclose(fd);
 		bChangedToLogFileDir = IMG_TRUE;
 	}
+#else /* defined(__psp2__) */
+	/* Host builds (e.g. the offline binary compiler) log to the current directory */
+#if defined(LINUX)
+	mkdir(GLSL_LOGFILE_DIR, 0777);
+#else
+	_mkdir(GLSL_LOGFILE_DIR);
+#endif
+	bChangedToLogFileDir = IMG_TRUE;
+#endif /* defined(__psp2__) */
 
 	if (pszFileName)
 	{
-		snprintf(szPath, 256, "%s%s", "ux0:data/gles/glsl/logfiles/", pszFileName);
+		snprintf(szPath, 256, "%s/%s", GLSL_LOGFILE_DIR, pszFileName);
 		LogFile = fopen(szPath, "wc");
 	}
 
@@ -64,6 +64,9 @@ void MemChkDestroy()
 
 #define MARKER 0xDEADBED5
 
+/* Space at the start of a heap overflow block, keeps the items 8 byte aligned */
+#define HEAP_BLOCK_HEADER_SIZE	8
+
 typedef struct MemAllocRecordTAG *PMemAllocRecord;
 
 typedef struct MemAllocTAG
@@ -944,11 +947,15 @@ IMG_INTERNAL MemHeap *DebugCreateHeapfn(IMG_UINT32  uItemSizeInBytes,
 	psMemHeap->pbEndOfHeap              = &psMemHeap->pbHeap[psMemHeap->uHeapSizeInBytes];
 	psMemHeap->pbCurrentWaterMark       = psMemHeap->pbHeap;
 	psMemHeap->pvFreeListHead           = IMG_NULL;
+	psMemHeap->pvOverflowBlocks         = IMG_NULL;
 	
 #if defined(DUMP_LOGFILES) || defined(DEBUG)
 	psMemHeap->pszHeapCreationInfo = DebugMemAlloc2(strlen(pszFileName) + 15, uLineNumber, pszFileName);
 	sprintf(psMemHeap->pszHeapCreationInfo, "%u : %s", uLineNumber, pszFileName);
 	psMemHeap->uHeapOverflows           = 0;
+	psMemHeap->uNumItemsAllocated       = 0;
+	psMemHeap->uNumItemsLive            = 0;
+	psMemHeap->uMaxItemsLive            = 0;
 #endif
 
 	return psMemHeap;
@@ -977,18 +984,44 @@ IMG_INTERNAL IMG_VOID *DebugAllocHeapItemfn(MemHeap *psMemHeap
 	{
 		psMemHeap->pvFreeListHead = *(IMG_VOID**)psMemHeap->pvFreeListHead;
 	}
-	else if(psMemHeap->pbCurrentWaterMark < psMemHeap->pbEndOfHeap)
+	else
 	{
+		if(psMemHeap->pbCurrentWaterMark >= psMemHeap->pbEndOfHeap)
+		{
+			/* 
+			   Grow the pool by another block of the original size. The first 
+			   8 bytes of the block link it to the previous overflow block.
+			*/
+			IMG_BYTE *pbBlock = DebugMemAlloc2(HEAP_BLOCK_HEADER_SIZE + psMemHeap->uHeapSizeInBytes, uLineNumber, pszFileName);
+
+			if(!pbBlock)
+			{
+				return IMG_NULL;
+			}
+
+			*(IMG_VOID**)pbBlock = psMemHeap->pvOverflowBlocks;
+			psMemHeap->pvOverflowBlocks = pbBlock;
+
+			psMemHeap->pbCurrentWaterMark = pbBlock + HEAP_BLOCK_HEADER_SIZE;
+			psMemHeap->pbEndOfHeap        = psMemHeap->pbCurrentWaterMark + psMemHeap->uHeapSizeInBytes;
+
+#if defined(DUMP_LOGFILES) || defined(DEBUG)
+			psMemHeap->uHeapOverflows++;
+#endif
+		}
+
 		pvResult = (IMG_VOID*)psMemHeap->pbCurrentWaterMark;
 		psMemHeap->pbCurrentWaterMark += psMemHeap->uHeapItemSizeInBytes;
 	}
-	else
+
+#if defined(DUMP_LOGFILES) || defined(DEBUG)
+	psMemHeap->uNumItemsAllocated++;
+	psMemHeap->uNumItemsLive++;
+	if(psMemHeap->uNumItemsLive > psMemHeap->uMaxItemsLive)
 	{
-#ifdef DUMP_LOGFILES
-		psMemHeap->uHeapOverflows++;	
-#endif
-		pvResult = DebugMemAlloc2(psMemHeap->uHeapItemSizeInBytes, uLineNumber, pszFileName);
+		psMemHeap->uMaxItemsLive = psMemHeap->uNumItemsLive;
 	}
+#endif
 
 	return pvResult;
 }
@@ -1009,6 +1042,10 @@ IMG_INTERNAL IMG_VOID DebugFreeHeapItemfn(MemHeap *psMemHeap,
 	/* Append it to the free list */
 	*(IMG_VOID**)pvItem = psMemHeap->pvFreeListHead;
 	psMemHeap->pvFreeListHead = pvItem;
+
+#if defined(DUMP_LOGFILES) || defined(DEBUG)
+	psMemHeap->uNumItemsLive--;
+#endif
 }
 
 /******************************************************************************
@@ -1037,12 +1074,13 @@ IMG_INTERNAL IMG_VOID DebugDestroyHeapfn(MemHeap *psMemHeap
 #ifdef DUMP_LOGFILES
 	DumpLogMessage(LOGFILE_MEMORY_STATS,
 				   0,
-				   "Heap Stats for %s\nHeap usage = %d/%d slots, Heap Overflows = %d, High watermark = %d\n\n",
+				   "Heap Stats for %s\nHeap usage = %d allocations, %d/%d slots at peak, Heap Overflows = %d, High watermark = %d\n\n",
 				   psMemHeap->pszHeapCreationInfo,
-				   (psMemHeap->pbCurrentWaterMark -psMemHeap->pbHeap)/psMemHeap->uHeapItemSizeInBytes,
+				   psMemHeap->uNumItemsAllocated,
+				   psMemHeap->uMaxItemsLive,
 				   psMemHeap->uHeapSizeInBytes/psMemHeap->uHeapItemSizeInBytes,
 				   psMemHeap->uHeapOverflows,
-				   psMemHeap->uHeapSizeInBytes + psMemHeap->uHeapOverflows*psMemHeap->uHeapItemSizeInBytes);
+				   psMemHeap->uHeapSizeInBytes * (psMemHeap->uHeapOverflows + 1));
 
 #endif
 
@@ -1050,16 +1088,13 @@ IMG_INTERNAL IMG_VOID DebugDestroyHeapfn(MemHeap *psMemHeap
 	DebugMemFree2(psMemHeap->pszHeapCreationInfo, uLineNumber, pszFileName);
 #endif
 
-	while(psMemHeap->pvFreeListHead)
+	/* Every item lives in one of the blocks, so the free list can be dropped */
+	while(psMemHeap->pvOverflowBlocks)
 	{
-		pvBlock = psMemHeap->pvFreeListHead;
-		psMemHeap->pvFreeListHead = *(IMG_VOID**)psMemHeap->pvFreeListHead;
-		
-		if(pvBlock < (IMG_VOID *)psMemHeap->pbHeap || pvBlock >= (IMG_VOID *)psMemHeap->pbEndOfHeap)
-		{
-			/* The block did not came from the pool, it was externally allocated */
-			DebugMemFree2(pvBlock, uLineNumber, pszFileName);
-		}
+		pvBlock = psMemHeap->pvOverflowBlocks;
+		psMemHeap->pvOverflowBlocks = *(IMG_VOID**)pvBlock;
+
+		DebugMemFree2(pvBlock, uLineNumber, pszFileName);
 	}
 
 	DebugMemFree2(psMemHeap->pbHeap, uLineNumber, pszFileName);
@@ -160,7 +160,12 @@ IMG_VOID DebugDumpMemoryAllocLog(IMG_VOID);
 #endif
 
 
-/* Memory pool for same-sized objects. Simple segregated storage. */
+/*
+	Memory pool for same-sized objects. Simple segregated storage.
+	When the pool is exhausted it grows by another block of the same size,
+	so every item lives in one of the pool's blocks and destroying the pool
+	frees the blocks rather than each item.
+*/
 typedef struct MemHeapTAG
 {
 	IMG_UINT32   uHeapItemSizeInBytes;
@@ -171,9 +176,15 @@ typedef struct MemHeapTAG
 
 	IMG_VOID    *pvFreeListHead;
 
+	/* Blocks added when the pool overflowed, linked through their first pointer */
+	IMG_VOID    *pvOverflowBlocks;
+
 #if defined(DUMP_LOGFILES) || defined(DEBUG)
 	IMG_CHAR    *pszHeapCreationInfo;
 	IMG_UINT32   uHeapOverflows;
+	IMG_UINT32   uNumItemsAllocated;
+	IMG_UINT32   uNumItemsLive;
+	IMG_UINT32   uMaxItemsLive;
 #endif
 } MemHeap;
 
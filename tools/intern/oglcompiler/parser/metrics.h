@@ -53,6 +53,7 @@ typedef enum MetricsLogTAG
 	METRICS_USC_REGISTER_ALLOCATION                      = METRICS_USC_BASE + USC_METRICS_REGISTER_ALLOCATION,
 	METRICS_USC_C10_REGISTER_ALLOCATION                  = METRICS_USC_BASE + USC_METRICS_C10_REGISTER_ALLOCATION,
 	METRICS_USC_FINALISE_SHADER                          = METRICS_USC_BASE + USC_METRICS_FINALISE_SHADER,
+	METRICS_USC_REGISTER_LIVENESS                        = METRICS_USC_BASE + USC_METRICS_REGISTER_LIVENESS,
 
 	/* CUSTOM (CONFIGURABLE) UNIFLEX METRICS */
 	METRICS_USC_CUSTOM_TIMER_A                           = METRICS_USC_BASE + USC_METRICS_CUSTOM_TIMER_A,
@@ -71,8 +72,10 @@ typedef enum MetricsStatsLogTAG
 	METRICCOUNT_MAXNUMPARSETREEBRANCHES       = 3,
 	METRICCOUNT_NUMICINSTRUCTIONS             = 4,
 	METRICCOUNT_NUMCOMPILATIONS               = 5,
+	METRICCOUNT_NUMUSCALLOCATIONS             = 6,
+	METRICCOUNT_USCPEAKMEMORY                 = 7,
 
-	METRICCOUNT_LASTMETRIC                    = 6, /* Always needs to be last entry */
+	METRICCOUNT_LASTMETRIC                    = 8, /* Always needs to be last entry */
 } MetricsStatsLog; 
 
 
@@ -262,6 +262,9 @@ IMG_INTERNAL SymTable *CreateSymTable(SymbolTableContext *psSymbolTableContext,
 	psSymTable->uGetNextSymbolCounter        = 0;
 	psSymTable->uGetNextSymbolScopeLevel     = 0;
 	psSymTable->psSecondarySymbolTable       = psSecondarySymbolTable;
+	psSymTable->uHashMask                    = 0;
+	psSymTable->puHashBuckets                = IMG_NULL;
+	psSymTable->puHashNext                   = IMG_NULL;
 
 	if (!AttachSymbolTableToContext(psSymbolTableContext, psSymTable))
 	{
@@ -303,10 +306,151 @@ IMG_INTERNAL IMG_VOID DestroySymTable(SymTable *psSymTable)
 		}
 	}
 
+	if (psSymTable->puHashBuckets)
+	{
+		DebugMemFree(psSymTable->puHashBuckets);
+		DebugMemFree(psSymTable->puHashNext);
+	}
+
 	DebugMemFree (psSymTable->psEntries);
 	DebugMemFree (psSymTable);
 }
 
+/******************************************************************************
+ * Function Name: HashSymbolName
+ *
+ * Inputs       : pszSymbolName
+ * Outputs      : -
+ * Returns      : Hash of the name
+ * Globals Used : -
+ *
+ * Description  : FNV-1a hash used by the optional name index
+ *****************************************************************************/
+static IMG_UINT32 HashSymbolName(const IMG_CHAR *pszSymbolName)
+{
+	IMG_UINT32 uHash = 2166136261U;
+
+	while (*pszSymbolName)
+	{
+		uHash ^= (IMG_UINT8)*pszSymbolName++;
+		uHash *= 16777619U;
+	}
+
+	return uHash;
+}
+
+/******************************************************************************
+ * Function Name: DisableSymTableHashing
+ *
+ * Inputs       : psSymTable
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : -
+ *
+ * Description  : Drops the name index, lookups fall back to the linear scan
+ *****************************************************************************/
+static IMG_VOID DisableSymTableHashing(SymTable *psSymTable)
+{
+	if (psSymTable->puHashBuckets)
+	{
+		DebugMemFree(psSymTable->puHashBuckets);
+		DebugMemFree(psSymTable->puHashNext);
+
+		psSymTable->puHashBuckets = IMG_NULL;
+		psSymTable->puHashNext    = IMG_NULL;
+		psSymTable->uHashMask     = 0;
+	}
+}
+
+/******************************************************************************
+ * Function Name: GrowSymTableHash
+ *
+ * Inputs       : psSymTable
+ * Outputs      : -
+ * Returns      : -
+ * Globals Used : -
+ *
+ * Description  : Doubles the number of hash chains and relinks every entry,
+ *                oldest first so each chain stays newest first
+ *****************************************************************************/
+static IMG_VOID GrowSymTableHash(SymTable *psSymTable)
+{
+	IMG_UINT32 uNewMask = (psSymTable->uHashMask << 1) | 1;
+	IMG_UINT32 *puBuckets = DebugMemCalloc((uNewMask + 1) * sizeof(IMG_UINT32));
+	IMG_UINT32 i;
+
+	if (!puBuckets)
+	{
+		/* Keep the existing chains, they are just longer */
+		return;
+	}
+
+	for (i = 0; i < psSymTable->uNumEntries; i++)
+	{
+		IMG_UINT32 *puBucket = &puBuckets[HashSymbolName(psSymTable->psEntries[i].pszString) & uNewMask];
+
+		psSymTable->puHashNext[i] = *puBucket;
+		*puBucket = i + 1;
+	}
+
+	DebugMemFree(psSymTable->puHashBuckets);
+
+	psSymTable->puHashBuckets = puBuckets;
+	psSymTable->uHashMask     = uNewMask;
+}
+
+/******************************************************************************
+ * Function Name: EnableSymTableHashing
+ *
+ * Inputs       : psSymTable
+ *                uNumBuckets - Number of hash chains, rounded up to a power of two
+ * Outputs      : -
+ * Returns      : IMG_TRUE if the index was created
+ * Globals Used : -
+ *
+ * Description  : Adds a name index to an empty symbol table so FindSymbol no
+ *                longer scans every entry. Only valid for tables that stay at
+ *                scope level 0 (e.g. the preprocessor's macro table); the index
+ *                is dropped again if the scope level is ever changed.
+ *****************************************************************************/
+IMG_INTERNAL IMG_BOOL EnableSymTableHashing(SymTable *psSymTable, IMG_UINT32 uNumBuckets)
+{
+	IMG_UINT32 uSize = 1;
+
+	if (psSymTable->uNumEntries || psSymTable->uCurrentScopeLevel || psSymTable->puHashBuckets)
+	{
+		return IMG_FALSE;
+	}
+
+	while (uSize < uNumBuckets)
+	{
+		uSize <<= 1;
+	}
+
+	psSymTable->puHashBuckets = DebugMemCalloc(uSize * sizeof(IMG_UINT32));
+	psSymTable->puHashNext    = DebugMemAlloc(psSymTable->uMaxNumEntries * sizeof(IMG_UINT32));
+
+	if (!psSymTable->puHashBuckets || !psSymTable->puHashNext)
+	{
+		if (psSymTable->puHashBuckets)
+		{
+			DebugMemFree(psSymTable->puHashBuckets);
+			psSymTable->puHashBuckets = IMG_NULL;
+		}
+		if (psSymTable->puHashNext)
+		{
+			DebugMemFree(psSymTable->puHashNext);
+			psSymTable->puHashNext = IMG_NULL;
+		}
+
+		return IMG_FALSE;
+	}
+
+	psSymTable->uHashMask = uSize - 1;
+
+	return IMG_TRUE;
+}
+
 /******************************************************************************
  * Function Name: FindSymbolInTable
  *
@@ -331,11 +475,49 @@ static IMG_BOOL FindSymbolInTable(SymTable *psSymTable,
 
 	SymTable *psCurrentSymTable = psSymTable;
 
+	IMG_UINT32 uHash = 0;
+	IMG_BOOL   bHashed = IMG_FALSE;
+
 	while (psCurrentSymTable)
 	{
 		IMG_UINT32 uMinScopeLevel = psCurrentSymTable->uCurrentScopeLevel;
-		
-		for (i = (IMG_INT32)(psCurrentSymTable->uNumEntries - 1); i >= 0; i--)
+
+		if (psCurrentSymTable->puHashBuckets)
+		{
+			IMG_UINT32 uEntry;
+
+			if (!bHashed)
+			{
+				uHash   = HashSymbolName(pszSymbolName);
+				bHashed = IMG_TRUE;
+			}
+
+			/* Chains are kept newest first, matching the order of the scan below */
+			for (uEntry = psCurrentSymTable->puHashBuckets[uHash & psCurrentSymTable->uHashMask];
+				 uEntry;
+				 uEntry = psCurrentSymTable->puHashNext[uEntry - 1])
+			{
+				SymTableEntry *psEntry = &psCurrentSymTable->psEntries[uEntry - 1];
+
+				if (psEntry->uRefCount && strcmp(pszSymbolName, psEntry->pszString) == 0)
+				{
+					if (puSymbolID)
+					{
+						*puSymbolID = (uEntry - 1) | psCurrentSymTable->uUniqueSymbolTableID;
+					}
+
+					return IMG_TRUE;
+				}
+			}
+
+			i = -1;
+		}
+		else
+		{
+			i = (IMG_INT32)(psCurrentSymTable->uNumEntries - 1);
+		}
+
+		for (; i >= 0; i--)
 		{
 			/* Don't check symbols that have been removed or scope modifiers */
 			if (psCurrentSymTable->psEntries[i].uRefCount)
@@ -588,6 +770,21 @@ static IMG_BOOL CheckTableSize(SymTable *psSymTable)
 			return IMG_FALSE;
 		}
 
+		if (psSymTable->puHashNext)
+		{
+			IMG_UINT32 *puHashNext = DebugMemRealloc(psSymTable->puHashNext, uNewNumEntries * sizeof(IMG_UINT32));
+
+			if (puHashNext)
+			{
+				psSymTable->puHashNext = puHashNext;
+			}
+			else
+			{
+				/* Realloc failure leaves the old block allocated; free it and fall back to scanning */
+				DisableSymTableHashing(psSymTable);
+			}
+		}
+
 		psSymTable->uMaxNumEntries = uNewNumEntries;
 	}
 
@@ -674,6 +871,12 @@ static IMG_BOOL AddSymbolToTable(SymTable                  *psSymTable,
 
 	psSymTableEntry = &psSymTable->psEntries[psSymTable->uNumEntries];
 
+	/* The name index assumes a flat table */
+	if (bScopeModifier)
+	{
+		DisableSymTableHashing(psSymTable);
+	}
+
 	psSymTableEntry->pszString = DebugMemAlloc(sizeof(IMG_CHAR) * (strlen(pszSymbolName) + 1));
 
 	/* Check memory alloc for name succeeded */
@@ -724,6 +927,21 @@ static IMG_BOOL AddSymbolToTable(SymTable                  *psSymTable,
 				   psSymTableEntry->uSymbolID);
 #endif
 
+	if (psSymTable->puHashBuckets)
+	{
+		IMG_UINT32 *puBucket;
+
+		if (psSymTable->uNumEntries >= (psSymTable->uHashMask + 1) * 2)
+		{
+			GrowSymTableHash(psSymTable);
+		}
+
+		puBucket = &psSymTable->puHashBuckets[HashSymbolName(pszSymbolName) & psSymTable->uHashMask];
+
+		psSymTable->puHashNext[psSymTable->uNumEntries] = *puBucket;
+		*puBucket = psSymTable->uNumEntries + 1;
+	}
+
 	psSymTable->uNumEntries++;
 
 	return IMG_TRUE;
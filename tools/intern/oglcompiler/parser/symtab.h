@@ -81,6 +81,11 @@ typedef struct SymTable_TAG
 	IMG_UINT32           uGetNextSymbolScopeLevel;
 	struct SymTable_TAG *psSecondarySymbolTable;
 	SymTableEntry       *psEntries;
+
+	/* Optional name index, see EnableSymTableHashing. Chains hold entry index + 1, 0 terminates */
+	IMG_UINT32           uHashMask;
+	IMG_UINT32          *puHashBuckets;
+	IMG_UINT32          *puHashNext;
 } SymTable;
 
 typedef struct SymbolTableContextTAG
@@ -106,6 +111,8 @@ SymTable *CreateSymTable(SymbolTableContext *psSymbolTableContext,
 
 IMG_VOID DestroySymTable(SymTable *psSymTable);
 
+IMG_BOOL EnableSymTableHashing(SymTable *psSymTable, IMG_UINT32 uNumBuckets);
+
 IMG_BOOL FindSymbol(SymTable *psSymTable, 
 					IMG_CHAR *pszSymbolName, 
 					IMG_UINT32 *puSymbolID,
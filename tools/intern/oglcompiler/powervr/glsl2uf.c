@@ -26,9 +26,12 @@
 #include "glsl2uf.h"
 #include "icgen.h"
 #include "icodefns.h"
+#include "common.h"
 #include "debug.h"
 #include "metrics.h"
 #include "ic2uf.h"
+#include "parser.h"
+#include "prepro.h"
 
 
 /******************************************************************************
@@ -93,11 +96,612 @@ GLSL_EXPORT IMG_VOID IMG_CALLCONV GLSLFreeCompiledUniflexProgram(GLSLInitCompile
 
 		GLSLFreeInfoLog(&(psGLSLCompiledUniflexProgram->sInfoLog));
 
+		if (psGLSLCompiledUniflexProgram->psConstantVaryings)
+		{
+			IMG_UINT32 i;
+
+			for (i = 0; i < psGLSLCompiledUniflexProgram->uNumConstantVaryings; i++)
+			{
+				DebugMemFree(psGLSLCompiledUniflexProgram->psConstantVaryings[i].pszName);
+			}
+
+			DebugMemFree(psGLSLCompiledUniflexProgram->psConstantVaryings);
+		}
+
 		DebugMemFree(psGLSLCompiledUniflexProgram);
 	}
 }
 
 
+/******************************************************************************
+ * Function Name: GLSLApplySpecialisedConstants
+ *
+ * Inputs       : psCompileUniflexProgramContext, psUniFlexCode, psBindingSymbolList
+ * Outputs      : ppfConstantData
+ * Returns      : IMG_FALSE on allocation failure
+ * Globals Used : -
+ *
+ * Description  : Marks the constant components the caller asked to specialise on
+ *				  as static, so USC folds their values into the code, and returns a
+ *				  copy of the default constant data holding those values. The copy
+ *				  must be freed by the caller if it differs from the binding list's.
+ *****************************************************************************/
+static IMG_BOOL GLSLApplySpecialisedConstants(GLSLCompileUniflexProgramContext *psCompileUniflexProgramContext,
+											  GLSLUniFlexCode                  *psUniFlexCode,
+											  GLSLBindingSymbolList            *psBindingSymbolList,
+											  IMG_FLOAT                        **ppfConstantData)
+{
+	IMG_UINT32 uNumComps = psCompileUniflexProgramContext->uSpecialisedConstCount;
+	IMG_UINT32 uNumFlags, uNumWords, uOldNumWords, i;
+	IMG_UINT32 *puStaticFlags;
+	IMG_FLOAT *pfConstantData;
+
+	*ppfConstantData = psBindingSymbolList->pfConstantData;
+
+	/* Only components the program actually allocated can be specialised */
+	if (uNumComps > psBindingSymbolList->uNumCompsUsed)
+	{
+		uNumComps = psBindingSymbolList->uNumCompsUsed;
+	}
+
+	if (!uNumComps ||
+		!psCompileUniflexProgramContext->puSpecialisedConstFlags ||
+		!psCompileUniflexProgramContext->pfSpecialisedConstData)
+	{
+		return IMG_TRUE;
+	}
+
+	uNumFlags = psUniFlexCode->uConstStaticFlagCount;
+
+	if (uNumFlags < uNumComps)
+	{
+		uNumFlags = uNumComps;
+	}
+
+	uNumWords	 = (uNumFlags + 31) / 32;
+	uOldNumWords = (psUniFlexCode->uConstStaticFlagCount + 31) / 32;
+
+	puStaticFlags = DebugMemCalloc(uNumWords * sizeof(IMG_UINT32));
+	pfConstantData = DebugMemAlloc(psBindingSymbolList->uNumCompsUsed * sizeof(IMG_FLOAT));
+
+	if (!puStaticFlags || !pfConstantData)
+	{
+		if (puStaticFlags)
+		{
+			DebugMemFree(puStaticFlags);
+		}
+
+		if (pfConstantData)
+		{
+			DebugMemFree(pfConstantData);
+		}
+
+		return IMG_FALSE;
+	}
+
+	if (uOldNumWords)
+	{
+		memcpy(puStaticFlags, psUniFlexCode->puConstStaticFlags, uOldNumWords * sizeof(IMG_UINT32));
+	}
+
+	memcpy(pfConstantData, psBindingSymbolList->pfConstantData, psBindingSymbolList->uNumCompsUsed * sizeof(IMG_FLOAT));
+
+	for (i = 0; i < uNumComps; i++)
+	{
+		if (psCompileUniflexProgramContext->puSpecialisedConstFlags[i / 32] & (1U << (i % 32)))
+		{
+			puStaticFlags[i / 32] |= (1U << (i % 32));
+			pfConstantData[i] = psCompileUniflexProgramContext->pfSpecialisedConstData[i];
+		}
+	}
+
+	/* The flags are freed along with the rest of the uniflex input */
+	if (psUniFlexCode->puConstStaticFlags)
+	{
+		DebugMemFree(psUniFlexCode->puConstStaticFlags);
+	}
+
+	psUniFlexCode->uConstStaticFlagCount = uNumFlags;
+	psUniFlexCode->puConstStaticFlags	 = puStaticFlags;
+
+	*ppfConstantData = pfConstantData;
+
+	return IMG_TRUE;
+}
+
+/*
+	A user varying written by the vertex shader, as found by GLSLCollectVertexOutputs.
+*/
+typedef struct GLSLVertexOutputTAG
+{
+	IMG_UINT32			uSymbolID;
+
+	/* Is the varying read back by the vertex shader */
+	IMG_BOOL			bRead;
+
+	/* Are the writes to the varying to be removed */
+	IMG_BOOL			bRemove;
+
+	/* Is every write a copy of the same constant, held in sValue */
+	IMG_BOOL			bConstant;
+	GLSLLinkedVarying	sValue;
+
+} GLSLVertexOutput;
+
+/******************************************************************************
+ * Function Name: GLSLIsUserVarying
+ *
+ * Inputs       : psCPD, psICProgram, uSymbolID, eTypeQualifier
+ * Outputs      : puNumComponents, pePrecision
+ * Returns      : IMG_TRUE if the symbol is a user varying with the given qualifier
+ * Globals Used : -
+ *
+ * Description  : Checks whether an operand refers to a varying declared by the
+ *				  shader. The number of components is only returned for varyings
+ *				  which are a float or float vector, and is 0 for other types.
+ *****************************************************************************/
+static IMG_BOOL GLSLIsUserVarying(GLSLCompilerPrivateData *psCPD,
+								  GLSLICProgram           *psICProgram,
+								  IMG_UINT32              uSymbolID,
+								  GLSLTypeQualifier       eTypeQualifier,
+								  IMG_UINT32              *puNumComponents,
+								  GLSLPrecisionQualifier  *pePrecision)
+{
+	GLSLBuiltInVariableID eBuiltinID;
+	GLSLFullySpecifiedType *psFullType;
+	IMG_INT32 iArraySize;
+
+	if (!ICGetSymbolInformation(psCPD, psICProgram->psSymbolTable, uSymbolID,
+								&eBuiltinID, &psFullType, &iArraySize, IMG_NULL, IMG_NULL))
+	{
+		return IMG_FALSE;
+	}
+
+	if (eBuiltinID != GLSLBV_NOT_BTIN || psFullType->eTypeQualifier != eTypeQualifier)
+	{
+		return IMG_FALSE;
+	}
+
+	if (puNumComponents)
+	{
+		*puNumComponents = 0;
+
+		if (!iArraySize && GLSL_IS_FLOAT(psFullType->eTypeSpecifier))
+		{
+			*puNumComponents = GLSLTypeSpecifierNumElementsTable(psFullType->eTypeSpecifier);
+		}
+	}
+
+	if (pePrecision)
+	{
+		*pePrecision = psFullType->ePrecisionQualifier;
+	}
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ * Function Name: GLSLGetConstantWrite
+ *
+ * Inputs       : psCPD, psICProgram, psInstr, uNumComponents
+ * Outputs      : pfValue
+ * Returns      : IMG_TRUE if the instruction writes a constant to all of its destination
+ * Globals Used : -
+ *
+ * Description  : Recognises a plain move of a constant into the whole of a float
+ *				  vector varying and returns the value written, with the source
+ *				  swizzle applied.
+ *****************************************************************************/
+static IMG_BOOL GLSLGetConstantWrite(GLSLCompilerPrivateData *psCPD,
+									 GLSLICProgram           *psICProgram,
+									 GLSLICInstruction       *psInstr,
+									 IMG_UINT32              uNumComponents,
+									 IMG_FLOAT               *pfValue)
+{
+	GLSLICOperand *psDest = &psInstr->asOperand[DEST];
+	GLSLICOperand *psSrc = &psInstr->asOperand[SRCA];
+	GLSLFullySpecifiedType *psFullType;
+	IMG_INT32 iArraySize;
+	IMG_VOID *pvConstantData;
+	IMG_UINT32 uNumSrcComponents, i;
+	IMG_FLOAT afSrc[4];
+
+	if (psInstr->eOpCode != GLSLIC_OP_MOV ||
+		psDest->uNumOffsets || psDest->eInstModifier != GLSLIC_MODIFIER_NONE ||
+		psSrc->uNumOffsets || psSrc->eInstModifier != GLSLIC_MODIFIER_NONE)
+	{
+		return IMG_FALSE;
+	}
+
+	/* The whole varying must be written */
+	if (psDest->sSwizWMask.uNumComponents)
+	{
+		if (psDest->sSwizWMask.uNumComponents != uNumComponents)
+		{
+			return IMG_FALSE;
+		}
+
+		for (i = 0; i < uNumComponents; i++)
+		{
+			if (psDest->sSwizWMask.aeVecComponent[i] != (GLSLICVecComponent)i)
+			{
+				return IMG_FALSE;
+			}
+		}
+	}
+
+	if (!ICGetSymbolInformation(psCPD, psICProgram->psSymbolTable, psSrc->uSymbolID,
+								IMG_NULL, &psFullType, &iArraySize, IMG_NULL, &pvConstantData))
+	{
+		return IMG_FALSE;
+	}
+
+	if (psFullType->eTypeQualifier != GLSLTQ_CONST || !pvConstantData ||
+		iArraySize || !GLSL_IS_FLOAT(psFullType->eTypeSpecifier))
+	{
+		return IMG_FALSE;
+	}
+
+	/* Apply the source swizzle */
+	if (psSrc->sSwizWMask.uNumComponents)
+	{
+		uNumSrcComponents = psSrc->sSwizWMask.uNumComponents;
+
+		for (i = 0; i < uNumSrcComponents; i++)
+		{
+			afSrc[i] = ((IMG_FLOAT *)pvConstantData)[psSrc->sSwizWMask.aeVecComponent[i]];
+		}
+	}
+	else
+	{
+		uNumSrcComponents = GLSLTypeSpecifierNumElementsTable(psFullType->eTypeSpecifier);
+
+		memcpy(afSrc, pvConstantData, uNumSrcComponents * sizeof(IMG_FLOAT));
+	}
+
+	/* A scalar source is replicated across the destination */
+	for (i = 0; i < uNumComponents; i++)
+	{
+		if (uNumSrcComponents == 1)
+		{
+			pfValue[i] = afSrc[0];
+		}
+		else if (uNumSrcComponents == uNumComponents)
+		{
+			pfValue[i] = afSrc[i];
+		}
+		else
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ * Function Name: GLSLCollectVertexOutputs
+ *
+ * Inputs       : psCPD, psICProgram
+ * Outputs      : puNumOutputs, ppsOutputs
+ * Returns      : IMG_FALSE on allocation failure
+ * Globals Used : -
+ *
+ * Description  : Finds the user varyings referenced by a vertex shader, whether
+ *				  they are read back, and whether they are only ever written with
+ *				  one constant value. The list must be freed by the caller.
+ *****************************************************************************/
+static IMG_BOOL GLSLCollectVertexOutputs(GLSLCompilerPrivateData *psCPD,
+										 GLSLICProgram           *psICProgram,
+										 IMG_UINT32              *puNumOutputs,
+										 GLSLVertexOutput        **ppsOutputs)
+{
+	GLSLVertexOutput *psOutputs = IMG_NULL;
+	IMG_UINT32 uNumOutputs = 0, uMaxOutputs = 0;
+	GLSLICInstruction *psInstr;
+
+	for (psInstr = psICProgram->psInstrHead; psInstr; psInstr = psInstr->psNext)
+	{
+		IMG_UINT32 uNumSrcs = ICOP_NUM_SRCS(psInstr->eOpCode);
+		IMG_UINT32 i, j;
+
+		for (i = 0; i < uNumSrcs + 1; i++)
+		{
+			GLSLICOperand *psOperand = &psInstr->asOperand[i];
+			GLSLVertexOutput *psOutput;
+			IMG_UINT32 uNumComponents;
+			IMG_FLOAT afValue[4];
+
+			if (i == DEST && !ICOP_HAS_DEST(psInstr->eOpCode))
+			{
+				continue;
+			}
+
+			if (!GLSLIsUserVarying(psCPD, psICProgram, psOperand->uSymbolID, GLSLTQ_VERTEX_OUT, &uNumComponents, IMG_NULL))
+			{
+				continue;
+			}
+
+			for (j = 0; j < uNumOutputs; j++)
+			{
+				if (psOutputs[j].uSymbolID == psOperand->uSymbolID)
+				{
+					break;
+				}
+			}
+
+			if (j == uNumOutputs)
+			{
+				if (uNumOutputs == uMaxOutputs)
+				{
+					GLSLVertexOutput *psNewOutputs;
+
+					uMaxOutputs = uMaxOutputs ? (uMaxOutputs * 2) : 8;
+
+					psNewOutputs = DebugMemRealloc(psOutputs, uMaxOutputs * sizeof(GLSLVertexOutput));
+
+					if (!psNewOutputs)
+					{
+						if (psOutputs)
+						{
+							DebugMemFree(psOutputs);
+						}
+
+						return IMG_FALSE;
+					}
+
+					psOutputs = psNewOutputs;
+				}
+
+				psOutput = &psOutputs[uNumOutputs++];
+
+				psOutput->uSymbolID					= psOperand->uSymbolID;
+				psOutput->bRead						= IMG_FALSE;
+				psOutput->bRemove					= IMG_FALSE;
+				psOutput->bConstant					= (IMG_BOOL)(uNumComponents != 0);
+				psOutput->sValue.pszName			= GetSymbolName(psICProgram->psSymbolTable, psOperand->uSymbolID);
+				psOutput->sValue.uNumComponents		= 0;
+			}
+			else
+			{
+				psOutput = &psOutputs[j];
+			}
+
+			if (i != DEST)
+			{
+				psOutput->bRead		= IMG_TRUE;
+				psOutput->bConstant	= IMG_FALSE;
+			}
+			else if (psOutput->bConstant)
+			{
+				if (!GLSLGetConstantWrite(psCPD, psICProgram, psInstr, uNumComponents, afValue))
+				{
+					psOutput->bConstant = IMG_FALSE;
+				}
+				else if (!psOutput->sValue.uNumComponents)
+				{
+					psOutput->sValue.uNumComponents = uNumComponents;
+					memcpy(psOutput->sValue.afValue, afValue, uNumComponents * sizeof(IMG_FLOAT));
+				}
+				else if (memcmp(psOutput->sValue.afValue, afValue, uNumComponents * sizeof(IMG_FLOAT)))
+				{
+					psOutput->bConstant = IMG_FALSE;
+				}
+			}
+		}
+	}
+
+	*puNumOutputs = uNumOutputs;
+	*ppsOutputs   = psOutputs;
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ * Function Name: GLSLFindLinkedVarying
+ *
+ * Inputs       : psCompileUniflexProgramContext, pszName
+ * Outputs      : -
+ * Returns      : The linked varying with the given name, or IMG_NULL
+ * Globals Used : -
+ *
+ * Description  : 
+ *****************************************************************************/
+static const GLSLLinkedVarying *GLSLFindLinkedVarying(GLSLCompileUniflexProgramContext *psCompileUniflexProgramContext,
+													  const IMG_CHAR                   *pszName)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < psCompileUniflexProgramContext->uNumLinkedVaryings; i++)
+	{
+		if (!strcmp(psCompileUniflexProgramContext->psLinkedVaryings[i].pszName, pszName))
+		{
+			return &psCompileUniflexProgramContext->psLinkedVaryings[i];
+		}
+	}
+
+	return IMG_NULL;
+}
+
+/******************************************************************************
+ * Function Name: GLSLOptimiseVertexOutputs
+ *
+ * Inputs       : psCompileUniflexProgramContext, psICProgram
+ * Outputs      : psGLSLCompiledUniflexProgram
+ * Returns      : IMG_FALSE on allocation failure
+ * Globals Used : -
+ *
+ * Description  : Removes the writes to varyings the fragment shader doesn't read,
+ *				  so no output registers are allocated for them and the code which
+ *				  computed them becomes dead, then records the remaining varyings
+ *				  which are only ever written with a constant.
+ *****************************************************************************/
+static IMG_BOOL GLSLOptimiseVertexOutputs(GLSLCompileUniflexProgramContext *psCompileUniflexProgramContext,
+										  GLSLCompiledUniflexProgram       *psGLSLCompiledUniflexProgram,
+										  GLSLICProgram                    *psICProgram)
+{
+	GLSLCompilerPrivateData *psCPD = (GLSLCompilerPrivateData *)psCompileUniflexProgramContext->psCompileProgramContext->psInitCompilerContext->pvCompilerPrivateData;
+	GLSLVertexOutput *psOutputs;
+	IMG_UINT32 uNumOutputs, uNumConstants, i;
+	GLSLICInstruction *psInstr, *psNext;
+
+	if (!GLSLCollectVertexOutputs(psCPD, psICProgram, &uNumOutputs, &psOutputs))
+	{
+		return IMG_FALSE;
+	}
+
+	if (!uNumOutputs)
+	{
+		return IMG_TRUE;
+	}
+
+	for (i = 0; i < uNumOutputs; i++)
+	{
+		if (!psOutputs[i].bRead && GLSLFindLinkedVarying(psCompileUniflexProgramContext, psOutputs[i].sValue.pszName))
+		{
+			psOutputs[i].bRemove = IMG_TRUE;
+		}
+	}
+
+	for (psInstr = psICProgram->psInstrHead; psInstr; psInstr = psNext)
+	{
+		psNext = psInstr->psNext;
+
+		if (!ICOP_HAS_DEST(psInstr->eOpCode))
+		{
+			continue;
+		}
+
+		for (i = 0; i < uNumOutputs; i++)
+		{
+			if (psOutputs[i].bRemove && psOutputs[i].uSymbolID == psInstr->asOperand[DEST].uSymbolID)
+			{
+				ICRemoveInstruction(psICProgram, psInstr);
+				break;
+			}
+		}
+	}
+
+	/* Record the constant outputs left */
+	uNumConstants = 0;
+
+	for (i = 0; i < uNumOutputs; i++)
+	{
+		if (!psOutputs[i].bRemove && psOutputs[i].bConstant)
+		{
+			uNumConstants++;
+		}
+	}
+
+	if (uNumConstants)
+	{
+		psGLSLCompiledUniflexProgram->psConstantVaryings = DebugMemCalloc(uNumConstants * sizeof(GLSLLinkedVarying));
+
+		if (!psGLSLCompiledUniflexProgram->psConstantVaryings)
+		{
+			DebugMemFree(psOutputs);
+
+			return IMG_FALSE;
+		}
+
+		for (i = 0; i < uNumOutputs; i++)
+		{
+			GLSLLinkedVarying *psConstant;
+
+			if (psOutputs[i].bRemove || !psOutputs[i].bConstant)
+			{
+				continue;
+			}
+
+			psConstant = &psGLSLCompiledUniflexProgram->psConstantVaryings[psGLSLCompiledUniflexProgram->uNumConstantVaryings];
+
+			*psConstant = psOutputs[i].sValue;
+
+			psConstant->pszName = DebugMemAlloc(strlen(psOutputs[i].sValue.pszName) + 1);
+
+			if (!psConstant->pszName)
+			{
+				DebugMemFree(psOutputs);
+
+				return IMG_FALSE;
+			}
+
+			strcpy(psConstant->pszName, psOutputs[i].sValue.pszName);
+
+			psGLSLCompiledUniflexProgram->uNumConstantVaryings++;
+		}
+	}
+
+	DebugMemFree(psOutputs);
+
+	return IMG_TRUE;
+}
+
+/******************************************************************************
+ * Function Name: GLSLPropagateConstantVaryings
+ *
+ * Inputs       : psCompileUniflexProgramContext, psICProgram
+ * Outputs      : -
+ * Returns      : IMG_FALSE on failure
+ * Globals Used : -
+ *
+ * Description  : Replaces the fragment shader's reads of varyings the vertex
+ *				  shader always writes with one constant by that constant. A
+ *				  varying which is no longer read is given no iterator.
+ *****************************************************************************/
+static IMG_BOOL GLSLPropagateConstantVaryings(GLSLCompileUniflexProgramContext *psCompileUniflexProgramContext,
+											  GLSLICProgram                    *psICProgram)
+{
+	GLSLCompilerPrivateData *psCPD = (GLSLCompilerPrivateData *)psCompileUniflexProgramContext->psCompileProgramContext->psInitCompilerContext->pvCompilerPrivateData;
+	GLSLICInstruction *psInstr;
+
+	for (psInstr = psICProgram->psInstrHead; psInstr; psInstr = psInstr->psNext)
+	{
+		IMG_UINT32 uNumSrcs = ICOP_NUM_SRCS(psInstr->eOpCode);
+		IMG_UINT32 i;
+
+		for (i = SRCA; i < uNumSrcs + 1; i++)
+		{
+			GLSLICOperand *psOperand = &psInstr->asOperand[i];
+			const GLSLLinkedVarying *psLinkedVarying;
+			GLSLPrecisionQualifier ePrecision;
+			IMG_UINT32 uNumComponents;
+			IMG_FLOAT afValue[4];
+
+			/* Dynamically indexed reads are left alone */
+			if (psOperand->uNumOffsets ||
+				!GLSLIsUserVarying(psCPD, psICProgram, psOperand->uSymbolID, GLSLTQ_FRAGMENT_IN, &uNumComponents, &ePrecision))
+			{
+				continue;
+			}
+
+			psLinkedVarying = GLSLFindLinkedVarying(psCompileUniflexProgramContext,
+													GetSymbolName(psICProgram->psSymbolTable, psOperand->uSymbolID));
+
+			if (!psLinkedVarying || !uNumComponents || psLinkedVarying->uNumComponents != uNumComponents)
+			{
+				continue;
+			}
+
+			memcpy(afValue, psLinkedVarying->afValue, sizeof(afValue));
+
+			if (!AddFloatVecConstant(psCPD,
+									 psICProgram->psSymbolTable,
+									 "linkedVaryingConstant",
+									 afValue,
+									 uNumComponents,
+									 ePrecision,
+									 IMG_TRUE,
+									 &psOperand->uSymbolID))
+			{
+				return IMG_FALSE;
+			}
+		}
+	}
+
+	return IMG_TRUE;
+}
+
 /******************************************************************************
  * Function Name: GLSLGenerateUniflexProgram
  *
@@ -117,6 +721,10 @@ static IMG_BOOL GLSLGenerateUniflexProgram(GLSLCompileUniflexProgramContext *psC
 
 	GLSLCompilerPrivateData *psCPD = (GLSLCompilerPrivateData *)psInitCompilerContext->pvCompilerPrivateData;
 
+#ifdef GEN_HW_CODE
+	IMG_FLOAT *pfConstantData;
+#endif
+
 	psGLSLCompiledUniflexProgram->psCompileUniflexProgramContext = psCompileUniflexProgramContext;
 
 	if ((psGLSLCompiledUniflexProgram->eProgramFlags == GLSLPF_UNIFLEX_OUTPUT) ||
@@ -187,6 +795,20 @@ static IMG_BOOL GLSLGenerateUniflexProgram(GLSLCompileUniflexProgramContext *psC
 	}
 #ifdef GEN_HW_CODE
 
+	if (!GLSLApplySpecialisedConstants(psCompileUniflexProgramContext,
+									   psGLSLCompiledUniflexProgram->psUniFlexCode,
+									   psGLSLCompiledUniflexProgram->psBindingSymbolList,
+									   &pfConstantData))
+	{
+		LOG_INTERNAL_ERROR(("GLSLToUniflex: Failed to apply specialised constants\n"));
+		GLSLDestroyCompiledUniflexProgram(psInitCompilerContext,
+											psGLSLCompiledUniflexProgram,
+											IMG_TRUE,
+											IMG_TRUE,
+											IMG_TRUE);
+		return IMG_FALSE;
+	}
+
 	/* Start timing */
 	MetricStart((IMG_VOID*)psCPD, METRICS_UNIFLEXOUTPUTGEN);
 
@@ -195,30 +817,47 @@ static IMG_BOOL GLSLGenerateUniflexProgram(GLSLCompileUniflexProgramContext *psC
 	if (!GenerateUniPatchInput(psCPD,
 							   psGLSLCompiledUniflexProgram->psUniFlexCode,
 							   psCPD->pvUniFlexContext,
-							   psGLSLCompiledUniflexProgram->psBindingSymbolList->pfConstantData,
+							   pfConstantData,
 							   psGLSLCompiledUniflexProgram->eProgramType,
 							   &psGLSLCompiledUniflexProgram->eProgramFlags,
 							   psCompileUniflexProgramContext->bCompileMSAATrans,
 							   psUniFlexHWCodeInfo))
 	{
 		LOG_INTERNAL_ERROR(("GLSLToUniflex: Failed to generate unipatch input code\n"));
+
+		if (pfConstantData != psGLSLCompiledUniflexProgram->psBindingSymbolList->pfConstantData)
+		{
+			DebugMemFree(pfConstantData);
+		}
+
 		return IMG_FALSE;
 	}
 #else
 	/* Generate the output code */
 	if (!GenerateUniFlexOutput(psCPD, psGLSLCompiledUniflexProgram->psUniFlexCode,
 							   psCPD->pvUniFlexContext,
-							   psGLSLCompiledUniflexProgram->psBindingSymbolList->pfConstantData,
+							   pfConstantData,
 							   psGLSLCompiledUniflexProgram->eProgramType,
 							   psUniFlexHWCodeInfo))
 	{
 		LOG_INTERNAL_ERROR(("GLSLToUniflex: Failed to generate uniflex HW code\n"));
+
+		if (pfConstantData != psGLSLCompiledUniflexProgram->psBindingSymbolList->pfConstantData)
+		{
+			DebugMemFree(pfConstantData);
+		}
+
 		return IMG_FALSE;
 	}
 #endif
 
 	MetricFinish((IMG_VOID*)psCPD, METRICS_UNIFLEXOUTPUTGEN);
 
+	if (pfConstantData != psGLSLCompiledUniflexProgram->psBindingSymbolList->pfConstantData)
+	{
+		DebugMemFree(pfConstantData);
+	}
+
 	/* Free any of the input data as it's no longer required */
 	GLSLDestroyCompiledUniflexProgram(psInitCompilerContext,
 										psGLSLCompiledUniflexProgram,
@@ -291,6 +930,22 @@ GLSL_EXPORT GLSLCompiledUniflexProgram * IMG_CALLCONV GLSLCompileToUniflex(GLSLC
 		goto UniflexCleanUp;
 	}
 
+	/* Apply what is known about the other stage of a linked program */
+	if (psGLSLCompiledUniflexProgram->eProgramType == GLSLPT_VERTEX)
+	{
+		bSuccess = GLSLOptimiseVertexOutputs(psCompileUniflexProgramContext, psGLSLCompiledUniflexProgram, psICProgram);
+	}
+	else if (psCompileUniflexProgramContext->uNumLinkedVaryings)
+	{
+		bSuccess = GLSLPropagateConstantVaryings(psCompileUniflexProgramContext, psICProgram);
+	}
+
+	if (!bSuccess)
+	{
+		LOG_INTERNAL_ERROR(("GLSLCompileToUniflex: Failed to apply linked varyings\n"));
+		goto UniflexCleanUp;
+	}
+
 	/* Generate the uniflex code */
 	bSuccess = GLSLGenerateUniflexProgram(psCompileUniflexProgramContext,
 										  psGLSLCompiledUniflexProgram,
@@ -331,6 +986,139 @@ UniflexCleanUp:
 	return psGLSLCompiledUniflexProgram;
 }
 
+/******************************************************************************
+ * Function Name: GLSLPackTokens
+ *
+ * Inputs       : psParseContext, puStream
+ * Outputs      : puStream
+ * Returns      : Size of the packed token stream in dwords
+ * Globals Used : -
+ *
+ * Description  : Packs the name and data of each preprocessed token into
+ *				  puStream, followed by the extensions the program enabled. The
+ *				  language version and extension changes the preprocessor stored
+ *				  in pszStartOfLine are included; source positions are not. Only
+ *				  counts the dwords if puStream is NULL.
+ *****************************************************************************/
+static IMG_UINT32 GLSLPackTokens(ParseContext *psParseContext, IMG_UINT32 *puStream)
+{
+	GLSLPreProcessorData *psPreProcessorData = (GLSLPreProcessorData *)psParseContext->pvPreProcessorData;
+	IMG_UINT32 uSize = 0, uDataSizeInDWords, i;
+	IMG_BOOL bExtensionChange = IMG_FALSE;
+
+	for (i = 0; i < psParseContext->uNumTokens; i++)
+	{
+		Token *psToken = &psParseContext->psTokenList[i];
+
+		uDataSizeInDWords = psToken->pvData ? (psToken->uSizeOfDataInBytes + 3) >> 2 : 0;
+
+		if (puStream)
+		{
+			puStream[uSize]     = (IMG_UINT32)psToken->eTokenName;
+			puStream[uSize + 1] = psToken->pvData ? psToken->uSizeOfDataInBytes : 0;
+
+			if (uDataSizeInDWords)
+			{
+				puStream[uSize + 1 + uDataSizeInDWords] = 0;
+				memcpy(&puStream[uSize + 2], psToken->pvData, psToken->uSizeOfDataInBytes);
+			}
+		}
+		uSize += 2 + uDataSizeInDWords;
+
+		if (psToken->eTokenName == TOK_LANGUAGE_VERSION || bExtensionChange)
+		{
+			if (puStream)
+			{
+				puStream[uSize] = (IMG_UINT32)(IMG_UINTPTR_T)psToken->pszStartOfLine;
+			}
+			uSize++;
+		}
+
+		bExtensionChange = (psToken->eTokenName == TOK_EXTENSION_CHANGE) ? IMG_TRUE : IMG_FALSE;
+	}
+
+	if (puStream)
+	{
+		puStream[uSize] = psPreProcessorData ? (IMG_UINT32)psPreProcessorData->eEnabledExtensions : 0;
+	}
+	uSize++;
+
+	return uSize;
+}
+
+/******************************************************************************
+ * Function Name: GLSLGetPreprocessedTokens
+ *
+ * Inputs       : psCompileProgramContext, pfnMalloc
+ * Outputs      : ppuTokenStream, puTokenStreamSizeInDWords
+ * Returns      : IMG_TRUE if the source preprocessed without any messages
+ * Globals Used : -
+ *
+ * Description  : Runs the lexer and preprocessor over a program's source and
+ *				  returns the resulting tokens packed into dwords allocated with
+ *				  pfnMalloc. Sources which differ only in whitespace, comments or
+ *				  macros that are never expanded give the same stream, and with
+ *				  the same compile parameters compile to the same code.
+ *****************************************************************************/
+GLSL_EXPORT IMG_BOOL IMG_CALLCONV GLSLGetPreprocessedTokens(GLSLCompileProgramContext *psCompileProgramContext,
+															IMG_VOID *(*pfnMalloc)(IMG_UINT32),
+															IMG_UINT32 **ppuTokenStream,
+															IMG_UINT32 *puTokenStreamSizeInDWords)
+{
+	GLSLInitCompilerContext *psInitCompilerContext = psCompileProgramContext->psInitCompilerContext;
+	GLSLCompilerPrivateData *psCPD = (GLSLCompilerPrivateData *)psInitCompilerContext->pvCompilerPrivateData;
+	ParseContext *psParseContext;
+	ErrorLog sErrorLog;
+	IMG_UINT32 uSize;
+	IMG_BOOL bSuccess = IMG_FALSE;
+
+	*ppuTokenStream = IMG_NULL;
+	*puTokenStreamSizeInDWords = 0;
+
+	if (!psCPD || !psInitCompilerContext->bSuccessfulInit ||
+		!psCompileProgramContext->ppszSourceCodeStrings || !psCompileProgramContext->uNumSourceCodeStrings)
+	{
+		return IMG_FALSE;
+	}
+
+	SetErrorLog(&sErrorLog, IMG_FALSE);
+	psCPD->psErrorLog = &sErrorLog;
+
+	psParseContext = CreateParseContext((IMG_VOID*)psCPD,
+										psCompileProgramContext->ppszSourceCodeStrings,
+										psCompileProgramContext->uNumSourceCodeStrings);
+
+	if (psParseContext)
+	{
+		/* Anything the preprocessor reported would be lost from the info log of an identical shader */
+		if (!sErrorLog.uNumProgramErrorMessages && !sErrorLog.uNumProgramWarningMessages &&
+			!sErrorLog.uNumInternalErrorMessages)
+		{
+			uSize = GLSLPackTokens(psParseContext, IMG_NULL);
+
+			*ppuTokenStream = pfnMalloc(uSize * sizeof(IMG_UINT32));
+
+			if (*ppuTokenStream)
+			{
+				GLSLPackTokens(psParseContext, *ppuTokenStream);
+
+				*puTokenStreamSizeInDWords = uSize;
+
+				bSuccess = IMG_TRUE;
+			}
+		}
+
+		PPDestroyPreProcessorData(psParseContext->pvPreProcessorData);
+		DestroyParseContext(psParseContext);
+	}
+
+	FreeErrorLogMessages(&sErrorLog);
+
+	psCPD->psErrorLog = IMG_NULL;
+
+	return bSuccess;
+}
+
 /******************************************************************************
  * Function Name: GLSLDisplayMetrics
  *
@@ -360,6 +1148,8 @@ GLSL_EXPORT IMG_VOID IMG_CALLCONV GLSLDisplayMetrics(GLSLInitCompilerContext *ps
 	IMG_UINT32 uMaxNumParseTreeBranches     = MetricsGetCounter(psCPD, METRICCOUNT_MAXNUMPARSETREEBRANCHES);
 	IMG_UINT32 uNumICInstructions           = MetricsGetCounter(psCPD, METRICCOUNT_NUMICINSTRUCTIONS);
 	IMG_UINT32 uNumCompilations             = MetricsGetCounter(psCPD, METRICCOUNT_NUMCOMPILATIONS);
+	IMG_UINT32 uNumUSCAllocations           = MetricsGetCounter(psCPD, METRICCOUNT_NUMUSCALLOCATIONS);
+	IMG_UINT32 uUSCPeakMemory               = MetricsGetCounter(psCPD, METRICCOUNT_USCPEAKMEMORY);
 	IMG_FLOAT  fTotalTimeScale; 
 
 	fTotalTimeScale = (IMG_FLOAT)(
@@ -381,7 +1171,13 @@ GLSL_EXPORT IMG_VOID IMG_CALLCONV GLSLDisplayMetrics(GLSLInitCompilerContext *ps
 	DEBUG_MESSAGE(("Num Parse tree branches           = %8d (total = %d, max = %d)\n", uNumParseTreeBranches, uNumParseTreeBranchesCreated, uMaxNumParseTreeBranches));
 
 	DEBUG_MESSAGE(("-- Compiler Metrics --\n"));
-	DEBUG_MESSAGE(("Number of shaders compiled        = %7d\n\n", uNumCompilations));
+	DEBUG_MESSAGE(("Number of shaders compiled        = %7d\n", uNumCompilations));
+	if(uNumCompilations)
+	{
+		DEBUG_MESSAGE(("USC allocations per shader        = %7d\n",   uNumUSCAllocations / uNumCompilations));
+		DEBUG_MESSAGE(("USC peak bytes per shader         = %7d\n",   uUSCPeakMemory / uNumCompilations));
+	}
+	DEBUG_MESSAGE(("\n"));
 
 #define METRICS_MSG_ARGS(e) 1000*MetricsGetTime(psCPD,e)/uNumCompilations, 1000*MetricsGetTime(psCPD,e), 100*MetricsGetTime(psCPD,e) / fTotalTimeScale
 
@@ -407,6 +1203,7 @@ GLSL_EXPORT IMG_VOID IMG_CALLCONV GLSLDisplayMetrics(GLSLInitCompilerContext *ps
 		DEBUG_MESSAGE(("( Register allocation             |   %7.3f |  %7.3f |    %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_REGISTER_ALLOCATION)));
 		DEBUG_MESSAGE(("( C10 register allocation         |   %7.3f |  %7.3f |    %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_C10_REGISTER_ALLOCATION)));
 		DEBUG_MESSAGE(("( Finalise shader                 |   %7.3f |  %7.3f |    %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_FINALISE_SHADER)));
+		DEBUG_MESSAGE(("( Register liveness               |   %7.3f |  %7.3f |    %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_REGISTER_LIVENESS)));
 		DEBUG_MESSAGE(("( * Custom timer A                |   %7.3f |  %7.3f |  * %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_CUSTOM_TIMER_A)));
 		DEBUG_MESSAGE(("( * Custom timer B                |   %7.3f |  %7.3f |  * %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_CUSTOM_TIMER_B)));
 		DEBUG_MESSAGE(("( * Custom timer C                |   %7.3f |  %7.3f |  * %6.2f)\n",    METRICS_MSG_ARGS(METRICS_USC_CUSTOM_TIMER_C)));
@@ -124,8 +124,25 @@ typedef struct GLSLUniFlexCodeTAG
 
 #endif
 
+	/* Static performance estimates from USC (for the non-MSAA version of the code) */
+	UNIFLEX_PERF_REPORT	sPerfReport;
+
 } GLSLUniFlexCode;
 
+/*
+	A user varying named when a program is compiled against the other stage of a
+	linked pair, optionally with the constant value the vertex shader writes to it.
+*/
+typedef struct GLSLLinkedVaryingTAG
+{
+	IMG_CHAR					*pszName;
+
+	/* Number of components in afValue, or 0 if the varying has no constant value */
+	IMG_UINT32					uNumComponents;
+	IMG_FLOAT					afValue[4];
+
+} GLSLLinkedVarying;
+
 /*
 ** All information required to generate the uniflex program 
 */
@@ -144,6 +161,25 @@ typedef struct GLSLCompileUniflexProgramContextTAG
 	/* Information about the source program */
     GLSLCompileProgramContext *psCompileProgramContext;
 
+	/*
+		Optional values to fold into the program as compile time constants, e.g. uniforms
+		which the application hasn't changed. One flag bit per constant component, indexed
+		like GLSLBindingSymbolList::pfConstantData; components beyond uSpecialisedConstCount
+		are left alone. The binding symbols and constant layout are unaffected.
+	*/
+	IMG_UINT32					uSpecialisedConstCount;
+	const IMG_UINT32			*puSpecialisedConstFlags;
+	const IMG_FLOAT				*pfSpecialisedConstData;
+
+	/*
+		Optional information from the other stage of a linked program. For a vertex
+		shader the listed varyings are never read by the fragment shader, so writes to
+		them are removed and they are given no output registers. For a fragment shader
+		reads of the listed varyings which have a constant value are replaced by it.
+	*/
+	IMG_UINT32					uNumLinkedVaryings;
+	const GLSLLinkedVarying		*psLinkedVaryings;
+
 } GLSLCompileUniflexProgramContext;
 
 /* 
@@ -169,6 +205,10 @@ typedef struct GLSLCompiledUniflexProgramTAG
 	/* Context this program was created with */
 	GLSLCompileUniflexProgramContext *psCompileUniflexProgramContext;
 
+	/* Vertex shader user varyings only ever written with one constant value */
+	IMG_UINT32				 uNumConstantVaryings;
+	GLSLLinkedVarying		*psConstantVaryings;
+
 } GLSLCompiledUniflexProgram;
 
 
@@ -177,6 +217,11 @@ IMG_IMPORT GLSLCompiledUniflexProgram * IMG_CALLCONV GLSLCompileToUniflex(GLSLCo
 IMG_IMPORT IMG_VOID IMG_CALLCONV GLSLFreeCompiledUniflexProgram(GLSLInitCompilerContext *psInitCompilerContext,
 																GLSLCompiledUniflexProgram *psGLSLCompiledUniflexProgram);
 
+IMG_IMPORT IMG_BOOL IMG_CALLCONV GLSLGetPreprocessedTokens(GLSLCompileProgramContext *psCompileProgramContext,
+															IMG_VOID *(*pfnMalloc)(IMG_UINT32),
+															IMG_UINT32 **ppuTokenStream,
+															IMG_UINT32 *puTokenStreamSizeInDWords);
+
 IMG_IMPORT IMG_VOID IMG_CALLCONV GLSLDisplayMetrics(GLSLInitCompilerContext *psInitCompilerContext);
 
 
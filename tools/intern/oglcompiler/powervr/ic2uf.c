@@ -10165,6 +10165,29 @@ static char * const gauUniFlexErrorStrings[] =
 
 #if defined(OUTPUT_USPBIN)
 
+#ifdef METRICS
+/*****************************************************************************
+ FUNCTION	: AccumUniFlexAllocStats
+
+ PURPOSE	: Add the allocator statistics of the last USC compile to the
+			  compiler metrics
+
+ PARAMETERS	: psCPD				- Compiler private data
+			  pvUniFlexContext	- USC context the compile was run in
+
+ RETURNS	: Nothing
+*****************************************************************************/
+static IMG_VOID AccumUniFlexAllocStats(GLSLCompilerPrivateData *psCPD, IMG_PVOID pvUniFlexContext)
+{
+	UNIFLEX_ALLOC_STATS sAllocStats;
+
+	PVRUniFlexGetAllocStats(pvUniFlexContext, &sAllocStats);
+
+	MetricsAccumCounter((IMG_VOID*)psCPD, METRICCOUNT_NUMUSCALLOCATIONS, sAllocStats.uNumAllocs);
+	MetricsAccumCounter((IMG_VOID*)psCPD, METRICCOUNT_USCPEAKMEMORY,     sAllocStats.uPeakBytes);
+}
+#endif /* METRICS */
+
 /*****************************************************************************
  FUNCTION	: GenerateUniPatchInput
 
@@ -10225,7 +10248,8 @@ IMG_INTERNAL IMG_BOOL GenerateUniPatchInput(GLSLCompilerPrivateData *psCPD,
 		UNIFLEX_RANGES_LIST *psConstRange;		
 		IMG_UINT32 uFeedbackInstCount = 0;
 
-		psUFParams->uFlags = UF_GLSL;
+		/* Keep the caller's choice of a restricted (fast) optimisation tier */
+		psUFParams->uFlags = UF_GLSL | (psUFParams->uFlags & UF_RESTRICTOPTIMIZATIONS);
 		psUFParams->uFlags2 = 0;
 #if defined(GLSL_ES)
 
@@ -10376,6 +10400,13 @@ IMG_INTERNAL IMG_BOOL GenerateUniPatchInput(GLSLCompilerPrivateData *psCPD,
 			bSuccess = IMG_FALSE;
 			goto memfree_return;
 		}
+
+#ifdef METRICS
+		AccumUniFlexAllocStats(psCPD, pvUniFlexContext);
+#endif
+
+		/* Keep the performance report of the main compile */
+		PVRUniFlexGetPerfReport(pvUniFlexContext, &psUniFlexCode->sPerfReport);
 		
 		if(bCompileMSAATrans)
 		{
@@ -10411,6 +10442,10 @@ IMG_INTERNAL IMG_BOOL GenerateUniPatchInput(GLSLCompilerPrivateData *psCPD,
 				bSuccess = IMG_FALSE;
 				goto memfree_return;
 			}
+
+#ifdef METRICS
+			AccumUniFlexAllocStats(psCPD, pvUniFlexContext);
+#endif
 		}
 		else
 		{
@@ -10481,7 +10516,7 @@ IMG_INTERNAL IMG_BOOL GenerateUniFlexOutput(GLSLCompilerPrivateData *psCPD,
 		/* Constant hoisting is supported for the GLSL ES compiler */
 		UNIFLEX_HW					 *psUniflexHW;
 		(psUFParams->uFlags) = UF_GLSL | UF_EXTRACTCONSTANTCALCS
-			;
+			| (psUFParams->uFlags & UF_RESTRICTOPTIMIZATIONS);
 
 		psUniflexHW = DebugMemCalloc(sizeof(UNIFLEX_HW));
 		if(psUniflexHW == IMG_NULL)
@@ -10645,6 +10680,8 @@ IMG_INTERNAL IMG_BOOL GenerateUniFlexOutput(GLSLCompilerPrivateData *psCPD,
 			return IMG_FALSE;
 		}
 
+		PVRUniFlexGetPerfReport(pvUniFlexContext, &psUniFlexCode->sPerfReport);
+
 #ifdef DUMP_LOGFILES
 		DumpLogMessage(LOGFILE_COMPILER, 0, "Generate HW code successfully \n");
 		DumpLogMessage(LOGFILE_COMPILER, 0, "  Number of USE instructions     : %u\n", psUniflexHW->uInstructionCount);
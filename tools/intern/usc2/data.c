@@ -2492,6 +2492,1021 @@ IMG_VOID VectorIteratorNext(PVECTOR_ITERATOR psIterator)
 	VectorIteratorStep(psIterator);
 }
 
+IMG_INTERNAL
+IMG_VOID InitHVector(USC_PHVECTOR psVector)
+/*****************************************************************************
+ FUNCTION	: InitHVector
+
+ PURPOSE	: Initialise a hybrid bitvector as empty.
+
+ PARAMETERS	: psVector	- Vector to initialise.
+
+ RETURNS	: Nothing
+*****************************************************************************/
+{
+	if (psVector == NULL)
+		return;
+
+	psVector->bDense = IMG_FALSE;
+	psVector->uCount = 0;
+	psVector->uMaxCount = 0;
+	psVector->puWords = NULL;
+	psVector->puWordIdx = NULL;
+}
+
+IMG_INTERNAL
+IMG_VOID ClearHVector(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector)
+/*****************************************************************************
+ FUNCTION	: ClearHVector
+
+ PURPOSE	: Clear a hybrid bitvector, freeing its storage.
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to clear
+
+ RETURNS	: Nothing
+*****************************************************************************/
+{
+	if (psVector == NULL)
+		return;
+
+	if (psVector->puWords != NULL)
+	{
+		UscFree(psState, psVector->puWords);
+	}
+	if (psVector->puWordIdx != NULL)
+	{
+		UscFree(psState, psVector->puWordIdx);
+	}
+	InitHVector(psVector);
+}
+
+static
+IMG_VOID HVectorReserve(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector, IMG_UINT32 uCount)
+/*****************************************************************************
+ FUNCTION	: HVectorReserve
+
+ PURPOSE	: Make sure a hybrid bitvector has space for a number of entries.
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to grow
+			  uCount	- Minimum number of entries
+
+ RETURNS	: Nothing
+
+ NOTES		: New entries in puWords are zero.
+*****************************************************************************/
+{
+	IMG_UINT32	uNewMaxCount;
+
+	if (uCount <= psVector->uMaxCount)
+	{
+		return;
+	}
+
+	uNewMaxCount = max(uCount, psVector->uMaxCount * 2);
+	ResizeTypedArray(psState, psVector->puWords, psVector->uMaxCount, uNewMaxCount);
+	if (!psVector->bDense)
+	{
+		ResizeTypedArray(psState, psVector->puWordIdx, psVector->uMaxCount, uNewMaxCount);
+	}
+	psVector->uMaxCount = uNewMaxCount;
+}
+
+static
+IMG_VOID HVectorExtendDense(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector, IMG_UINT32 uCount)
+/*****************************************************************************
+ FUNCTION	: HVectorExtendDense
+
+ PURPOSE	: Increase the number of words stored in a dense hybrid bitvector.
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to extend
+			  uCount	- Minimum number of words to store.
+
+ RETURNS	: Nothing
+
+ NOTES		: The new words are zero.
+*****************************************************************************/
+{
+	ASSERT(psVector->bDense);
+
+	if (uCount <= psVector->uCount)
+	{
+		return;
+	}
+	HVectorReserve(psState, psVector, uCount);
+	memset(&psVector->puWords[psVector->uCount], 0, (uCount - psVector->uCount) * sizeof(IMG_UINT32));
+	psVector->uCount = uCount;
+}
+
+static
+IMG_BOOL HVectorFind(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector, IMG_UINT32 uWordIdx, IMG_PUINT32 puPos)
+/*****************************************************************************
+ FUNCTION	: HVectorFind
+
+ PURPOSE	: Look for a word in a sparse hybrid bitvector.
+
+ PARAMETERS	: psState	- Compiler state.
+			  psVector	- Vector to search.
+			  uWordIdx	- Word number to look for.
+			  puPos		- Returns the entry holding the word, or the entry
+						where it would be inserted.
+
+ RETURNS	: TRUE if the word is stored in the vector.
+*****************************************************************************/
+{
+	IMG_UINT32	uLow = 0;
+	IMG_UINT32	uHigh = psVector->uCount;
+
+	ASSERT(!psVector->bDense);
+
+	while (uLow < uHigh)
+	{
+		IMG_UINT32	uMid = (uLow + uHigh) / 2;
+
+		if (psVector->puWordIdx[uMid] < uWordIdx)
+		{
+			uLow = uMid + 1;
+		}
+		else
+		{
+			uHigh = uMid;
+		}
+	}
+	*puPos = uLow;
+	return (uLow < psVector->uCount && psVector->puWordIdx[uLow] == uWordIdx) ? IMG_TRUE : IMG_FALSE;
+}
+
+static
+IMG_VOID HVectorMakeDense(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector, IMG_UINT32 uMinCount)
+/*****************************************************************************
+ FUNCTION	: HVectorMakeDense
+
+ PURPOSE	: Convert a sparse hybrid bitvector to the dense form.
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to convert
+			  uMinCount	- Minimum number of words to store afterwards.
+
+ RETURNS	: Nothing
+*****************************************************************************/
+{
+	IMG_UINT32	uCount = uMinCount;
+	IMG_PUINT32	puWords;
+	IMG_UINT32	uEntry;
+
+	ASSERT(!psVector->bDense);
+
+	if (psVector->uCount > 0)
+	{
+		uCount = max(uCount, psVector->puWordIdx[psVector->uCount - 1] + 1);
+	}
+
+	puWords = UscAlloc(psState, max(uCount, 1) * sizeof(IMG_UINT32));
+	memset(puWords, 0, max(uCount, 1) * sizeof(IMG_UINT32));
+	for (uEntry = 0; uEntry < psVector->uCount; uEntry++)
+	{
+		puWords[psVector->puWordIdx[uEntry]] = psVector->puWords[uEntry];
+	}
+
+	ClearHVector(psState, psVector);
+	psVector->bDense = IMG_TRUE;
+	psVector->uCount = uCount;
+	psVector->uMaxCount = max(uCount, 1);
+	psVector->puWords = puWords;
+}
+
+static
+IMG_VOID HVectorCheckDensity(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector)
+/*****************************************************************************
+ FUNCTION	: HVectorCheckDensity
+
+ PURPOSE	: Switch a sparse hybrid bitvector to the dense form if that would
+			  take no more space.
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to check
+
+ RETURNS	: Nothing
+*****************************************************************************/
+{
+	if (!psVector->bDense && psVector->uCount > 0)
+	{
+		IMG_UINT32	uDenseCount = psVector->puWordIdx[psVector->uCount - 1] + 1;
+
+		if (psVector->uCount * USC_HVECTOR_DENSE_FACTOR >= uDenseCount)
+		{
+			HVectorMakeDense(psState, psVector, uDenseCount);
+		}
+	}
+}
+
+static
+IMG_UINT32 HVectorGetWord(PINTERMEDIATE_STATE psState, USC_PHVECTOR psVector, IMG_UINT32 uWordIdx)
+/*****************************************************************************
+ FUNCTION	: HVectorGetWord
+
+ PURPOSE	: Get a word from a hybrid bitvector.
+
+ PARAMETERS	: psState	- Compiler state.
+			  psVector	- Vector to read.
+			  uWordIdx	- Word number.
+
+ RETURNS	: The word.
+*****************************************************************************/
+{
+	IMG_UINT32	uPos;
+
+	if (psVector->bDense)
+	{
+		return (uWordIdx < psVector->uCount) ? psVector->puWords[uWordIdx] : 0;
+	}
+	if (HVectorFind(psState, psVector, uWordIdx, &uPos))
+	{
+		return psVector->puWords[uPos];
+	}
+	return 0;
+}
+
+static
+IMG_UINT32 HVectorNextWord(USC_PHVECTOR psVector, IMG_UINT32 uWordIdx, IMG_PUINT32 puCursor)
+/*****************************************************************************
+ FUNCTION	: HVectorNextWord
+
+ PURPOSE	: Get a word from a hybrid bitvector when reading words in
+			  increasing order.
+
+ PARAMETERS	: psVector	- Vector to read.
+			  uWordIdx	- Word number (no smaller than on the previous call).
+			  puCursor	- Position in the vector; zero before the first call.
+
+ RETURNS	: The word.
+*****************************************************************************/
+{
+	if (psVector->bDense)
+	{
+		return (uWordIdx < psVector->uCount) ? psVector->puWords[uWordIdx] : 0;
+	}
+	while (*puCursor < psVector->uCount && psVector->puWordIdx[*puCursor] < uWordIdx)
+	{
+		(*puCursor)++;
+	}
+	if (*puCursor < psVector->uCount && psVector->puWordIdx[*puCursor] == uWordIdx)
+	{
+		return psVector->puWords[*puCursor];
+	}
+	return 0;
+}
+
+static
+IMG_VOID HVectorUpdateWord(PINTERMEDIATE_STATE	psState,
+						   USC_PHVECTOR			psVector,
+						   IMG_UINT32			uWordIdx,
+						   IMG_UINT32			uClearMask,
+						   IMG_UINT32			uSetMask)
+/*****************************************************************************
+ FUNCTION	: HVectorUpdateWord
+
+ PURPOSE	: Clear and then set bits in a word of a hybrid bitvector.
+
+ PARAMETERS	: psState		- Compiler state
+			  psVector		- Vector to update.
+			  uWordIdx		- Word number.
+			  uClearMask	- Bits to clear.
+			  uSetMask		- Bits to set.
+
+ RETURNS	: Nothing
+*****************************************************************************/
+{
+	IMG_UINT32	uPos;
+
+	if (psVector->bDense)
+	{
+		if (uWordIdx >= psVector->uCount)
+		{
+			if (uSetMask == 0)
+			{
+				return;
+			}
+			HVectorExtendDense(psState, psVector, uWordIdx + 1);
+		}
+		psVector->puWords[uWordIdx] = (psVector->puWords[uWordIdx] & ~uClearMask) | uSetMask;
+		return;
+	}
+
+	if (HVectorFind(psState, psVector, uWordIdx, &uPos))
+	{
+		psVector->puWords[uPos] = (psVector->puWords[uPos] & ~uClearMask) | uSetMask;
+		return;
+	}
+
+	if (uSetMask == 0)
+	{
+		return;
+	}
+
+	/*
+		Insert a new pair keeping the list sorted.
+	*/
+	HVectorReserve(psState, psVector, psVector->uCount + 1);
+	memmove(&psVector->puWords[uPos + 1],
+			&psVector->puWords[uPos],
+			(psVector->uCount - uPos) * sizeof(IMG_UINT32));
+	memmove(&psVector->puWordIdx[uPos + 1],
+			&psVector->puWordIdx[uPos],
+			(psVector->uCount - uPos) * sizeof(IMG_UINT32));
+	psVector->puWords[uPos] = uSetMask;
+	psVector->puWordIdx[uPos] = uWordIdx;
+	psVector->uCount++;
+
+	HVectorCheckDensity(psState, psVector);
+}
+
+static
+IMG_VOID HVectorRangeOp(PINTERMEDIATE_STATE	psState,
+						USC_PHVECTOR		psVector,
+						IMG_UINT32			uEndIdx,
+						IMG_UINT32			uStartIdx,
+						IMG_UINT32			uClearMask,
+						IMG_UINT32			uSetMask)
+/*****************************************************************************
+ FUNCTION	: HVectorRangeOp
+
+ PURPOSE	: Clear and then set bits in a range of a hybrid bitvector.
+
+ PARAMETERS	: psState		- Compiler state
+			  psVector		- Vector to update.
+			  uEndIdx		- Index of the last bit in the range.
+			  uStartIdx		- Index of the first bit in the range.
+			  uClearMask	- Bits to clear, relative to the start of the range.
+			  uSetMask		- Bits to set, relative to the start of the range.
+
+ RETURNS	: Nothing
+
+ NOTES		: The range must be no larger than 32 bits.
+*****************************************************************************/
+{
+	IMG_UINT32	uWordIdx = uStartIdx / BITS_PER_UINT;
+	IMG_UINT32	uShift = uStartIdx % BITS_PER_UINT;
+	IMG_UINT32	uLength = uEndIdx - uStartIdx + 1;
+	IMG_UINT32	uRangeMask;
+
+	ASSERT(!(uEndIdx < uStartIdx));
+	ASSERT(uLength <= BITS_PER_UINT);
+
+	uRangeMask = (uLength == BITS_PER_UINT) ? UINT_MAX : ((1U << uLength) - 1);
+	uClearMask &= uRangeMask;
+	uSetMask &= uRangeMask;
+
+	HVectorUpdateWord(psState, psVector, uWordIdx, uClearMask << uShift, uSetMask << uShift);
+	if (uShift + uLength > BITS_PER_UINT)
+	{
+		HVectorUpdateWord(psState,
+						  psVector,
+						  uWordIdx + 1,
+						  uClearMask >> (BITS_PER_UINT - uShift),
+						  uSetMask >> (BITS_PER_UINT - uShift));
+	}
+}
+
+IMG_INTERNAL
+IMG_UINT32 HVectorGetRange(PINTERMEDIATE_STATE psState,
+						   USC_PHVECTOR psVector,
+						   IMG_UINT32 uEndIdx,
+						   IMG_UINT32 uStartIdx)
+/*****************************************************************************
+ FUNCTION	: HVectorGetRange
+
+ PURPOSE	: Get a range of bits in a hybrid bitvector
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to read
+			  uEndIdx	- Index of the last bit
+			  uStartIdx	- Index of the first bit
+
+ RETURNS	: The specified slice of the bitvector
+
+ NOTES		: The range must be no larger than 32 bits.
+*****************************************************************************/
+{
+	IMG_UINT32	uWordIdx = uStartIdx / BITS_PER_UINT;
+	IMG_UINT32	uShift = uStartIdx % BITS_PER_UINT;
+	IMG_UINT32	uLength = uEndIdx - uStartIdx + 1;
+	IMG_UINT32	uData;
+
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	ASSERT(!(uEndIdx < uStartIdx));
+	ASSERT(uLength <= BITS_PER_UINT);
+
+	uData = HVectorGetWord(psState, psVector, uWordIdx) >> uShift;
+	if (uShift + uLength > BITS_PER_UINT)
+	{
+		uData |= HVectorGetWord(psState, psVector, uWordIdx + 1) << (BITS_PER_UINT - uShift);
+	}
+	if (uLength < BITS_PER_UINT)
+	{
+		uData &= (1U << uLength) - 1;
+	}
+	return uData;
+}
+
+IMG_INTERNAL
+USC_PHVECTOR HVectorSetRange(PINTERMEDIATE_STATE psState,
+							 USC_PHVECTOR psVector,
+							 IMG_UINT32 uEndIdx,
+							 IMG_UINT32 uStartIdx,
+							 IMG_UINT32 uData)
+/*****************************************************************************
+ FUNCTION	: HVectorSetRange
+
+ PURPOSE	: Set a range of bits in a hybrid bitvector
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to update
+			  uEndIdx	- Index of the last bit
+			  uStartIdx	- Index of the first bit
+			  uData		- Bits to store in the range
+
+ RETURNS	: psVector
+
+ NOTES		: The range must be no larger than 32 bits.
+*****************************************************************************/
+{
+	HVectorRangeOp(psState, psVector, uEndIdx, uStartIdx, UINT_MAX, uData);
+	return psVector;
+}
+
+IMG_INTERNAL
+USC_PHVECTOR HVectorOrRange(PINTERMEDIATE_STATE psState,
+							USC_PHVECTOR psVector,
+							IMG_UINT32 uEndIdx,
+							IMG_UINT32 uStartIdx,
+							IMG_UINT32 uData)
+/*****************************************************************************
+ FUNCTION	: HVectorOrRange
+
+ PURPOSE	: Or data into a range of bits in a hybrid bitvector
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to update
+			  uEndIdx	- Index of the last bit
+			  uStartIdx	- Index of the first bit
+			  uData		- Bits to or into the range
+
+ RETURNS	: psVector
+
+ NOTES		: The range must be no larger than 32 bits.
+*****************************************************************************/
+{
+	HVectorRangeOp(psState, psVector, uEndIdx, uStartIdx, 0, uData);
+	return psVector;
+}
+
+IMG_INTERNAL
+USC_PHVECTOR HVectorAndRange(PINTERMEDIATE_STATE psState,
+							 USC_PHVECTOR psVector,
+							 IMG_UINT32 uEndIdx,
+							 IMG_UINT32 uStartIdx,
+							 IMG_UINT32 uData)
+/*****************************************************************************
+ FUNCTION	: HVectorAndRange
+
+ PURPOSE	: And data into a range of bits in a hybrid bitvector
+
+ PARAMETERS	: psState	- Compiler state
+			  psVector	- Vector to update
+			  uEndIdx	- Index of the last bit
+			  uStartIdx	- Index of the first bit
+			  uData		- Bits to and into the range
+
+ RETURNS	: psVector
+
+ NOTES		: The range must be no larger than 32 bits.
+*****************************************************************************/
+{
+	HVectorRangeOp(psState, psVector, uEndIdx, uStartIdx, ~uData, 0);
+	return psVector;
+}
+
+IMG_INTERNAL
+USC_PHVECTOR HVectorCopy(PINTERMEDIATE_STATE psState,
+						 USC_PHVECTOR psSrc,
+						 USC_PHVECTOR psDest)
+/*****************************************************************************
+ FUNCTION	: HVectorCopy
+
+ PURPOSE	: Copy a hybrid bitvector
+
+ PARAMETERS	: psState	- Compiler state
+			  psSrc		- Vector to copy
+			  psDest	- Destination
+
+ RETURNS	: psDest or NULL on error.
+*****************************************************************************/
+{
+	if (psDest == NULL || psSrc == NULL)
+		return NULL;
+	if (psDest == psSrc)
+		return psDest;
+
+	/*
+		Reuse the destination's storage if it is large enough.
+	*/
+	if (psDest->uMaxCount < psSrc->uCount || psDest->bDense != psSrc->bDense)
+	{
+		ClearHVector(psState, psDest);
+		psDest->bDense = psSrc->bDense;
+		HVectorReserve(psState, psDest, psSrc->uCount);
+	}
+
+	psDest->uCount = psSrc->uCount;
+	if (psSrc->uCount > 0)
+	{
+		memcpy(psDest->puWords, psSrc->puWords, psSrc->uCount * sizeof(IMG_UINT32));
+		if (!psSrc->bDense)
+		{
+			memcpy(psDest->puWordIdx, psSrc->puWordIdx, psSrc->uCount * sizeof(IMG_UINT32));
+		}
+	}
+	return psDest;
+}
+
+static
+IMG_UINT32 HVectorDenseOr(IMG_PUINT32 puDest, IMG_PUINT32 puSrc, IMG_UINT32 uCount)
+/*****************************************************************************
+ FUNCTION	: HVectorDenseOr
+
+ PURPOSE	: Or one array of words into another.
+
+ PARAMETERS	: puDest	- Destination words.
+			  puSrc		- Source words.
+			  uCount	- Number of words.
+
+ RETURNS	: Non-zero if any destination word changed.
+*****************************************************************************/
+{
+	IMG_UINT32	uChanged = 0;
+	IMG_UINT32	uIdx;
+
+	/*
+		Process four independent words per iteration so the compiler can keep
+		them in flight together (or use vector registers where available).
+	*/
+	for (uIdx = 0; (uIdx + 4) <= uCount; uIdx += 4)
+	{
+		IMG_UINT32	u0 = puDest[uIdx + 0] | puSrc[uIdx + 0];
+		IMG_UINT32	u1 = puDest[uIdx + 1] | puSrc[uIdx + 1];
+		IMG_UINT32	u2 = puDest[uIdx + 2] | puSrc[uIdx + 2];
+		IMG_UINT32	u3 = puDest[uIdx + 3] | puSrc[uIdx + 3];
+
+		uChanged |= (u0 ^ puDest[uIdx + 0]) | (u1 ^ puDest[uIdx + 1]) |
+					(u2 ^ puDest[uIdx + 2]) | (u3 ^ puDest[uIdx + 3]);
+
+		puDest[uIdx + 0] = u0;
+		puDest[uIdx + 1] = u1;
+		puDest[uIdx + 2] = u2;
+		puDest[uIdx + 3] = u3;
+	}
+	for (; uIdx < uCount; uIdx++)
+	{
+		IMG_UINT32	uNew = puDest[uIdx] | puSrc[uIdx];
+
+		uChanged |= uNew ^ puDest[uIdx];
+		puDest[uIdx] = uNew;
+	}
+	return uChanged;
+}
+
+IMG_INTERNAL
+IMG_BOOL HVectorUnion(PINTERMEDIATE_STATE psState,
+					  USC_PHVECTOR psDest,
+					  USC_PHVECTOR psSrc)
+/*****************************************************************************
+ FUNCTION	: HVectorUnion
+
+ PURPOSE	: Add all the bits set in one hybrid bitvector to another.
+
+ PARAMETERS	: psState	- Compiler state
+			  psDest	- Vector to update.
+			  psSrc		- Vector to add.
+
+ RETURNS	: TRUE if the destination changed.
+*****************************************************************************/
+{
+	IMG_UINT32	uChanged = 0;
+	IMG_UINT32	uEntry;
+
+	if (psSrc->uCount == 0 || psDest == psSrc)
+	{
+		return IMG_FALSE;
+	}
+
+	if (!psDest->bDense && !psSrc->bDense)
+	{
+		IMG_UINT32	uMaxCount = psDest->uCount + psSrc->uCount;
+		IMG_PUINT32	puWords = UscAlloc(psState, uMaxCount * sizeof(IMG_UINT32));
+		IMG_PUINT32	puWordIdx = UscAlloc(psState, uMaxCount * sizeof(IMG_UINT32));
+		IMG_UINT32	uDestPos = 0;
+		IMG_UINT32	uSrcPos = 0;
+		IMG_UINT32	uCount = 0;
+
+		/*
+			Merge the two sorted lists of pairs.
+		*/
+		while (uDestPos < psDest->uCount || uSrcPos < psSrc->uCount)
+		{
+			if (uSrcPos == psSrc->uCount ||
+				(uDestPos < psDest->uCount && psDest->puWordIdx[uDestPos] < psSrc->puWordIdx[uSrcPos]))
+			{
+				puWordIdx[uCount] = psDest->puWordIdx[uDestPos];
+				puWords[uCount] = psDest->puWords[uDestPos];
+				uDestPos++;
+			}
+			else if (uDestPos == psDest->uCount || psSrc->puWordIdx[uSrcPos] < psDest->puWordIdx[uDestPos])
+			{
+				puWordIdx[uCount] = psSrc->puWordIdx[uSrcPos];
+				puWords[uCount] = psSrc->puWords[uSrcPos];
+				uChanged |= puWords[uCount];
+				uSrcPos++;
+			}
+			else
+			{
+				puWordIdx[uCount] = psDest->puWordIdx[uDestPos];
+				puWords[uCount] = psDest->puWords[uDestPos] | psSrc->puWords[uSrcPos];
+				uChanged |= puWords[uCount] ^ psDest->puWords[uDestPos];
+				uDestPos++;
+				uSrcPos++;
+			}
+			uCount++;
+		}
+
+		ClearHVector(psState, psDest);
+		psDest->uCount = uCount;
+		psDest->uMaxCount = uMaxCount;
+		psDest->puWords = puWords;
+		psDest->puWordIdx = puWordIdx;
+
+		HVectorCheckDensity(psState, psDest);
+		return (uChanged != 0) ? IMG_TRUE : IMG_FALSE;
+	}
+
+	if (!psDest->bDense)
+	{
+		HVectorMakeDense(psState, psDest, psSrc->uCount);
+	}
+
+	if (psSrc->bDense)
+	{
+		HVectorExtendDense(psState, psDest, psSrc->uCount);
+		uChanged = HVectorDenseOr(psDest->puWords, psSrc->puWords, psSrc->uCount);
+	}
+	else
+	{
+		HVectorExtendDense(psState, psDest, psSrc->puWordIdx[psSrc->uCount - 1] + 1);
+		for (uEntry = 0; uEntry < psSrc->uCount; uEntry++)
+		{
+			IMG_PUINT32	puDestWord = &psDest->puWords[psSrc->puWordIdx[uEntry]];
+			IMG_UINT32	uNew = *puDestWord | psSrc->puWords[uEntry];
+
+			uChanged |= uNew ^ *puDestWord;
+			*puDestWord = uNew;
+		}
+	}
+	return (uChanged != 0) ? IMG_TRUE : IMG_FALSE;
+}
+
+static
+IMG_BOOL HVectorMask(USC_PHVECTOR psDest, USC_PHVECTOR psSrc, IMG_UINT32 uInvert)
+/*****************************************************************************
+ FUNCTION	: HVectorMask
+
+ PURPOSE	: And each word of a hybrid bitvector with the corresponding word
+			  of another, optionally inverted.
+
+ PARAMETERS	: psDest	- Vector to update.
+			  psSrc		- Vector to and with.
+			  uInvert	- UINT_MAX to and with the inverse of psSrc, 0 otherwise.
+
+ RETURNS	: TRUE if the destination changed.
+*****************************************************************************/
+{
+	IMG_UINT32	uChanged = 0;
+	IMG_UINT32	uEntry = 0;
+	IMG_UINT32	uCursor = 0;
+
+	if (psDest->bDense && psSrc->bDense)
+	{
+		IMG_UINT32	uCommon = min(psDest->uCount, psSrc->uCount);
+		IMG_PUINT32	puDest = psDest->puWords;
+		IMG_PUINT32	puSrc = psSrc->puWords;
+
+		for (; (uEntry + 4) <= uCommon; uEntry += 4)
+		{
+			IMG_UINT32	u0 = puDest[uEntry + 0] & (puSrc[uEntry + 0] ^ uInvert);
+			IMG_UINT32	u1 = puDest[uEntry + 1] & (puSrc[uEntry + 1] ^ uInvert);
+			IMG_UINT32	u2 = puDest[uEntry + 2] & (puSrc[uEntry + 2] ^ uInvert);
+			IMG_UINT32	u3 = puDest[uEntry + 3] & (puSrc[uEntry + 3] ^ uInvert);
+
+			uChanged |= (u0 ^ puDest[uEntry + 0]) | (u1 ^ puDest[uEntry + 1]) |
+						(u2 ^ puDest[uEntry + 2]) | (u3 ^ puDest[uEntry + 3]);
+
+			puDest[uEntry + 0] = u0;
+			puDest[uEntry + 1] = u1;
+			puDest[uEntry + 2] = u2;
+			puDest[uEntry + 3] = u3;
+		}
+	}
+
+	for (; uEntry < psDest->uCount; uEntry++)
+	{
+		IMG_UINT32	uWordIdx = psDest->bDense ? uEntry : psDest->puWordIdx[uEntry];
+		IMG_UINT32	uNew;
+
+		uNew = psDest->puWords[uEntry] & (HVectorNextWord(psSrc, uWordIdx, &uCursor) ^ uInvert);
+		uChanged |= uNew ^ psDest->puWords[uEntry];
+		psDest->puWords[uEntry] = uNew;
+	}
+	return (uChanged != 0) ? IMG_TRUE : IMG_FALSE;
+}
+
+IMG_INTERNAL
+IMG_BOOL HVectorIntersect(PINTERMEDIATE_STATE psState,
+						  USC_PHVECTOR psDest,
+						  USC_PHVECTOR psSrc)
+/*****************************************************************************
+ FUNCTION	: HVectorIntersect
+
+ PURPOSE	: Clear all the bits in one hybrid bitvector which aren't set in
+			  another.
+
+ PARAMETERS	: psState	- Compiler state
+			  psDest	- Vector to update.
+			  psSrc		- Vector to intersect with.
+
+ RETURNS	: TRUE if the destination changed.
+*****************************************************************************/
+{
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	if (psDest == psSrc)
+	{
+		return IMG_FALSE;
+	}
+	return HVectorMask(psDest, psSrc, 0);
+}
+
+IMG_INTERNAL
+IMG_BOOL HVectorSubtract(PINTERMEDIATE_STATE psState,
+						 USC_PHVECTOR psDest,
+						 USC_PHVECTOR psSrc)
+/*****************************************************************************
+ FUNCTION	: HVectorSubtract
+
+ PURPOSE	: Clear all the bits in one hybrid bitvector which are set in
+			  another.
+
+ PARAMETERS	: psState	- Compiler state
+			  psDest	- Vector to update.
+			  psSrc		- Vector to subtract.
+
+ RETURNS	: TRUE if the destination changed.
+*****************************************************************************/
+{
+	if (psDest == psSrc)
+	{
+		IMG_BOOL	bChanged = IMG_FALSE;
+		IMG_UINT32	uEntry;
+
+		for (uEntry = 0; uEntry < psDest->uCount; uEntry++)
+		{
+			if (psDest->puWords[uEntry] != 0)
+			{
+				bChanged = IMG_TRUE;
+				break;
+			}
+		}
+		ClearHVector(psState, psDest);
+		return bChanged;
+	}
+	return HVectorMask(psDest, psSrc, UINT_MAX);
+}
+
+static
+IMG_BOOL HVectorContains(USC_PHVECTOR psSrc1, USC_PHVECTOR psSrc2)
+/*****************************************************************************
+ FUNCTION	: HVectorContains
+
+ PURPOSE	: Check every word stored in one hybrid bitvector matches the
+			  corresponding word in another.
+
+ PARAMETERS	: psSrc1, psSrc2	- Vectors to compare.
+
+ RETURNS	: TRUE if the words match.
+*****************************************************************************/
+{
+	IMG_UINT32	uEntry = 0;
+	IMG_UINT32	uCursor = 0;
+
+	if (psSrc1->bDense && psSrc2->bDense)
+	{
+		IMG_UINT32	uCommon = min(psSrc1->uCount, psSrc2->uCount);
+		IMG_UINT32	uDiff = 0;
+
+		for (; (uEntry + 4) <= uCommon; uEntry += 4)
+		{
+			uDiff |= (psSrc1->puWords[uEntry + 0] ^ psSrc2->puWords[uEntry + 0]) |
+					 (psSrc1->puWords[uEntry + 1] ^ psSrc2->puWords[uEntry + 1]) |
+					 (psSrc1->puWords[uEntry + 2] ^ psSrc2->puWords[uEntry + 2]) |
+					 (psSrc1->puWords[uEntry + 3] ^ psSrc2->puWords[uEntry + 3]);
+		}
+		if (uDiff != 0)
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	for (; uEntry < psSrc1->uCount; uEntry++)
+	{
+		IMG_UINT32	uWordIdx = psSrc1->bDense ? uEntry : psSrc1->puWordIdx[uEntry];
+
+		if (psSrc1->puWords[uEntry] != HVectorNextWord(psSrc2, uWordIdx, &uCursor))
+		{
+			return IMG_FALSE;
+		}
+	}
+	return IMG_TRUE;
+}
+
+IMG_INTERNAL
+IMG_BOOL HVectorEqual(PINTERMEDIATE_STATE psState,
+					  USC_PHVECTOR psSrc1,
+					  USC_PHVECTOR psSrc2)
+/*****************************************************************************
+ FUNCTION	: HVectorEqual
+
+ PURPOSE	: Compare two hybrid bitvectors.
+
+ PARAMETERS	: psState			- Compiler state
+			  psSrc1, psSrc2	- Vectors to compare.
+
+ RETURNS	: TRUE if the same bits are set in both vectors.
+*****************************************************************************/
+{
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	/*
+		Either vector may store words which are zero, so check the words
+		stored in each against the other.
+	*/
+	if (!HVectorContains(psSrc1, psSrc2))
+	{
+		return IMG_FALSE;
+	}
+	if (psSrc1->bDense && psSrc2->bDense && psSrc2->uCount <= psSrc1->uCount)
+	{
+		return IMG_TRUE;
+	}
+	return HVectorContains(psSrc2, psSrc1);
+}
+
+static
+IMG_VOID HVectorIteratorStep(PHVECTOR_ITERATOR psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorStep
+
+ PURPOSE	: Move an iterator forward to the next range containing set bits
+			  at or after its current position.
+
+ PARAMETERS	: psIterator	- Iterator to move.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	USC_PHVECTOR	psVector = psIterator->psVector;
+
+	while (psIterator->uEntry < psVector->uCount)
+	{
+		if (psIterator->uCurrentBitPos < BITS_PER_UINT)
+		{
+			IMG_UINT32	uWord = psVector->puWords[psIterator->uEntry] >> psIterator->uCurrentBitPos;
+
+			if (uWord != 0)
+			{
+				IMG_UINT32	uBitPos = psIterator->uCurrentBitPos + FirstSetBit(uWord);
+
+				psIterator->uCurrentBitPos = uBitPos - (uBitPos % psIterator->uStep);
+				return;
+			}
+		}
+		psIterator->uEntry++;
+		psIterator->uCurrentBitPos = 0;
+	}
+}
+
+IMG_INTERNAL
+IMG_VOID HVectorIteratorInitialize(PINTERMEDIATE_STATE	psState,
+								   USC_PHVECTOR			psVector,
+								   IMG_UINT32			uStep,
+								   PHVECTOR_ITERATOR	psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorInitialize
+
+ PURPOSE	: Start iterating over the ranges containing set bits in a hybrid
+			  bitvector.
+
+ PARAMETERS	: psState		- Compiler state.
+			  psVector		- Vector to iterate over.
+			  uStep			- Size of each range.
+			  psIterator	- Iterator to initialize.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	PVR_UNREFERENCED_PARAMETER(psState);
+
+	ASSERT(uStep > 0 && (BITS_PER_UINT % uStep) == 0);
+
+	psIterator->psVector = psVector;
+	psIterator->uEntry = 0;
+	psIterator->uCurrentBitPos = 0;
+	psIterator->uStep = uStep;
+
+	HVectorIteratorStep(psIterator);
+}
+
+IMG_INTERNAL
+IMG_UINT32 HVectorIteratorCurrentPosition(PHVECTOR_ITERATOR psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorCurrentPosition
+
+ PURPOSE	: Get the index of the first bit in the current range.
+
+ PARAMETERS	: psIterator	- Iterator.
+
+ RETURNS	: The bit index.
+*****************************************************************************/
+{
+	USC_PHVECTOR	psVector = psIterator->psVector;
+	IMG_UINT32		uWordIdx;
+
+	uWordIdx = psVector->bDense ? psIterator->uEntry : psVector->puWordIdx[psIterator->uEntry];
+	return uWordIdx * BITS_PER_UINT + psIterator->uCurrentBitPos;
+}
+
+IMG_INTERNAL
+IMG_UINT32 HVectorIteratorCurrentMask(PHVECTOR_ITERATOR psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorCurrentMask
+
+ PURPOSE	: Get the bits in the current range.
+
+ PARAMETERS	: psIterator	- Iterator.
+
+ RETURNS	: The bits.
+*****************************************************************************/
+{
+	IMG_UINT32	uWord = psIterator->psVector->puWords[psIterator->uEntry] >> psIterator->uCurrentBitPos;
+
+	if (psIterator->uStep < BITS_PER_UINT)
+	{
+		uWord &= (1U << psIterator->uStep) - 1;
+	}
+	return uWord;
+}
+
+IMG_INTERNAL
+IMG_BOOL HVectorIteratorContinue(PHVECTOR_ITERATOR psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorContinue
+
+ PURPOSE	: Check if there are more ranges to iterate over.
+
+ PARAMETERS	: psIterator	- Iterator to check.
+
+ RETURNS	: TRUE or FALSE.
+*****************************************************************************/
+{
+	return (psIterator->uEntry < psIterator->psVector->uCount) ? IMG_TRUE : IMG_FALSE;
+}
+
+IMG_INTERNAL
+IMG_VOID HVectorIteratorNext(PHVECTOR_ITERATOR psIterator)
+/*****************************************************************************
+ FUNCTION	: HVectorIteratorNext
+
+ PURPOSE	: Move to the next range containing some set bits.
+
+ PARAMETERS	: psIterator	- Iterator to move.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	psIterator->uCurrentBitPos += psIterator->uStep;
+	HVectorIteratorStep(psIterator);
+}
+
 IMG_INTERNAL
 USC_PGRAPH NewGraph(PINTERMEDIATE_STATE psState,
 					IMG_UINT32 uChunk,
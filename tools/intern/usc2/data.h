@@ -319,6 +319,104 @@ IMG_UINT32 VectorIteratorCurrentMask(PVECTOR_ITERATOR psIterator);
 IMG_VOID VectorIteratorNext(PVECTOR_ITERATOR psIterator);
 IMG_BOOL VectorIteratorContinue(PVECTOR_ITERATOR psIterator);
 
+/**
+ * Hybrid bitvectors
+ *
+ * A bitvector with an implicit default of zero which is stored either sparsely,
+ * as a list of (word number, word) pairs sorted by word number, or densely, as
+ * an array of words indexed directly by word number. A vector starts off sparse
+ * and switches to the dense form once the pairs would take up as much space as
+ * the dense array. Whole-vector operations work a word at a time.
+ **/
+typedef struct _USC_HVECTOR_
+{
+	/* bDense: Words are stored directly, indexed by word number. */
+	IMG_BOOL bDense;
+	/* uCount: Dense - number of words stored; sparse - number of pairs stored. */
+	IMG_UINT32 uCount;
+	/* uMaxCount: Number of entries allocated in puWords (and puWordIdx). */
+	IMG_UINT32 uMaxCount;
+	/* puWords: Bit data. Words which aren't stored are zero. */
+	IMG_PUINT32 puWords;
+	/* puWordIdx: Sparse only - word number of each entry in puWords in increasing order. */
+	IMG_PUINT32 puWordIdx;
+} USC_HVECTOR, *USC_PHVECTOR;
+
+/*
+   USC_HVECTOR_DENSE_FACTOR: A sparse vector becomes dense once the number of pairs
+   multiplied by this is at least the number of words a dense vector would need.
+*/
+#define USC_HVECTOR_DENSE_FACTOR	(2)
+
+IMG_VOID InitHVector(USC_PHVECTOR psVector);
+IMG_VOID ClearHVector(USC_DATA_STATE_PTR psState, USC_PHVECTOR psVector);
+USC_PHVECTOR HVectorCopy(USC_DATA_STATE_PTR psState,
+						 USC_PHVECTOR psSrc,
+						 USC_PHVECTOR psDest);
+IMG_UINT32 HVectorGetRange(USC_DATA_STATE_PTR psState,
+						   USC_PHVECTOR psVector,
+						   IMG_UINT32 uEndIdx,
+						   IMG_UINT32 uStartIdx);
+USC_PHVECTOR HVectorSetRange(USC_DATA_STATE_PTR psState,
+							 USC_PHVECTOR psVector,
+							 IMG_UINT32 uEndIdx,
+							 IMG_UINT32 uStartIdx,
+							 IMG_UINT32 uData);
+USC_PHVECTOR HVectorOrRange(USC_DATA_STATE_PTR psState,
+							USC_PHVECTOR psVector,
+							IMG_UINT32 uEndIdx,
+							IMG_UINT32 uStartIdx,
+							IMG_UINT32 uData);
+USC_PHVECTOR HVectorAndRange(USC_DATA_STATE_PTR psState,
+							 USC_PHVECTOR psVector,
+							 IMG_UINT32 uEndIdx,
+							 IMG_UINT32 uStartIdx,
+							 IMG_UINT32 uData);
+IMG_BOOL HVectorUnion(USC_DATA_STATE_PTR psState,
+					  USC_PHVECTOR psDest,
+					  USC_PHVECTOR psSrc);
+IMG_BOOL HVectorIntersect(USC_DATA_STATE_PTR psState,
+						  USC_PHVECTOR psDest,
+						  USC_PHVECTOR psSrc);
+IMG_BOOL HVectorSubtract(USC_DATA_STATE_PTR psState,
+						 USC_PHVECTOR psDest,
+						 USC_PHVECTOR psSrc);
+IMG_BOOL HVectorEqual(USC_DATA_STATE_PTR psState,
+					  USC_PHVECTOR psSrc1,
+					  USC_PHVECTOR psSrc2);
+
+/*
+	Iterator for the set bits in a hybrid vector.
+*/
+typedef struct _HVECTOR_ITERATOR
+{
+	/*
+		Vector over which we are iterating.
+	*/
+	USC_PHVECTOR	psVector;
+	/*
+		Current entry in the vector's array of words.
+	*/
+	IMG_UINT32		uEntry;
+	/*
+		Bit within the current word.
+	*/
+	IMG_UINT32		uCurrentBitPos;
+	/*
+		Size of a range (must divide the number of bits in a word).
+	*/
+	IMG_UINT32		uStep;
+} HVECTOR_ITERATOR, *PHVECTOR_ITERATOR;
+
+IMG_VOID HVectorIteratorInitialize(USC_DATA_STATE_PTR	psState,
+								   USC_PHVECTOR			psVector,
+								   IMG_UINT32			uStep,
+								   PHVECTOR_ITERATOR	psIterator);
+IMG_UINT32 HVectorIteratorCurrentPosition(PHVECTOR_ITERATOR psIterator);
+IMG_UINT32 HVectorIteratorCurrentMask(PHVECTOR_ITERATOR psIterator);
+IMG_VOID HVectorIteratorNext(PHVECTOR_ITERATOR psIterator);
+IMG_BOOL HVectorIteratorContinue(PHVECTOR_ITERATOR psIterator);
+
 /**
  * Graphs
  **/
@@ -118,11 +118,11 @@ IMG_VOID ClearRegLiveSet(PINTERMEDIATE_STATE psState,
 
 	memset(psLiveSet->puIndexReg, 0, sizeof(psLiveSet->puIndexReg));
 
-	ClearVector(psState, &psLiveSet->sFpInternal);
+	ClearHVector(psState, &psLiveSet->sFpInternal);
 	ClearVector(psState, &psLiveSet->sPredicate);
-	ClearVector(psState, &psLiveSet->sPrimAttr);
-	ClearVector(psState, &psLiveSet->sTemp);
-	ClearVector(psState, &psLiveSet->sOutput);
+	ClearHVector(psState, &psLiveSet->sPrimAttr);
+	ClearHVector(psState, &psLiveSet->sTemp);
+	ClearHVector(psState, &psLiveSet->sOutput);
 }
 
 IMG_INTERNAL
@@ -145,11 +145,11 @@ IMG_VOID InitRegLiveSet(PREGISTER_LIVESET psLiveSet)
 	memset(psLiveSet->puIndexReg, 0, sizeof(psLiveSet->puIndexReg));
 	psLiveSet->bLinkReg = IMG_FALSE;
 
-	InitVector(&psLiveSet->sFpInternal, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+	InitHVector(&psLiveSet->sFpInternal);
 	InitVector(&psLiveSet->sPredicate, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
-	InitVector(&psLiveSet->sPrimAttr, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
-	InitVector(&psLiveSet->sTemp, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
-	InitVector(&psLiveSet->sOutput, USC_MIN_VECTOR_CHUNK, IMG_FALSE);
+	InitHVector(&psLiveSet->sPrimAttr);
+	InitHVector(&psLiveSet->sTemp);
+	InitHVector(&psLiveSet->sOutput);
 }
 
 IMG_INTERNAL
@@ -168,11 +168,11 @@ IMG_VOID FreeRegLiveSet(PINTERMEDIATE_STATE psState, PREGISTER_LIVESET psLiveSet
 	if(psLiveSet == NULL)
 		return;
 
-	ClearVector(psState, &psLiveSet->sFpInternal);
+	ClearHVector(psState, &psLiveSet->sFpInternal);
 	ClearVector(psState, &psLiveSet->sPredicate);
-	ClearVector(psState, &psLiveSet->sPrimAttr);
-	ClearVector(psState, &psLiveSet->sTemp);
-	ClearVector(psState, &psLiveSet->sOutput);
+	ClearHVector(psState, &psLiveSet->sPrimAttr);
+	ClearHVector(psState, &psLiveSet->sTemp);
+	ClearHVector(psState, &psLiveSet->sOutput);
 	UscFree(psState, psLiveSet);
 }
 
@@ -222,11 +222,11 @@ IMG_VOID CopyRegLiveSet(PINTERMEDIATE_STATE psState,
 
 	memcpy(psDst->puIndexReg, psSrc->puIndexReg, sizeof(psDst->puIndexReg));
 
-	VectorCopy(psState, &psSrc->sFpInternal, &psDst->sFpInternal);
+	HVectorCopy(psState, &psSrc->sFpInternal, &psDst->sFpInternal);
 	VectorCopy(psState, &psSrc->sPredicate, &psDst->sPredicate);
-	VectorCopy(psState, &psSrc->sPrimAttr, &psDst->sPrimAttr);
-	VectorCopy(psState, &psSrc->sTemp, &psDst->sTemp);
-	VectorCopy(psState, &psSrc->sOutput, &psDst->sOutput);
+	HVectorCopy(psState, &psSrc->sPrimAttr, &psDst->sPrimAttr);
+	HVectorCopy(psState, &psSrc->sTemp, &psDst->sTemp);
+	HVectorCopy(psState, &psSrc->sOutput, &psDst->sOutput);
 
 	psDst->bLinkReg = psSrc->bLinkReg;
 }
@@ -3529,20 +3529,10 @@ static IMG_VOID MergeLivesets(PINTERMEDIATE_STATE psState,
 	VectorOp(psState, USC_VEC_OR, 
 			 &psDest->sPredicate, 
 			 &psDest->sPredicate, &psSrc->sPredicate);
-	VectorOp(psState, USC_VEC_OR, 
-			 &psDest->sFpInternal, 
-			 &psDest->sFpInternal, &psSrc->sFpInternal);
-	VectorOp(psState, USC_VEC_OR, 
-			 &psDest->sPrimAttr, 
-			 &psDest->sPrimAttr, &psSrc->sPrimAttr);
-
-	VectorOp(psState, USC_VEC_OR, 
-			 &psDest->sTemp, 
-			 &psDest->sTemp, &psSrc->sTemp);
-
-	VectorOp(psState, USC_VEC_OR, 
-			 &psDest->sOutput, 
-			 &psDest->sOutput, &psSrc->sOutput);
+	HVectorUnion(psState, &psDest->sFpInternal, &psSrc->sFpInternal);
+	HVectorUnion(psState, &psDest->sPrimAttr, &psSrc->sPrimAttr);
+	HVectorUnion(psState, &psDest->sTemp, &psSrc->sTemp);
+	HVectorUnion(psState, &psDest->sOutput, &psSrc->sOutput);
 	for (i = 0; i < (sizeof(psDest->puIndexReg) / sizeof(psDest->puIndexReg[0])); i++)
 	{
 		psDest->puIndexReg[i] |= psSrc->puIndexReg[i];
@@ -3578,19 +3568,19 @@ static IMG_BOOL CompareLivesets(PINTERMEDIATE_STATE psState,
 	{	
 		return IMG_FALSE;
 	}
-	if (VectorOp(psState, USC_VEC_EQ, &sTemp, &psDest->sFpInternal, &psSrc->sFpInternal) == NULL)
+	if (!HVectorEqual(psState, &psDest->sFpInternal, &psSrc->sFpInternal))
 	{	
 		return IMG_FALSE;
 	}
-	if (VectorOp(psState, USC_VEC_EQ, &sTemp, &psDest->sPrimAttr, &psSrc->sPrimAttr) == NULL)
+	if (!HVectorEqual(psState, &psDest->sPrimAttr, &psSrc->sPrimAttr))
 	{	
 		return IMG_FALSE;
 	}
-	if (VectorOp(psState, USC_VEC_EQ, &sTemp, &psDest->sTemp, &psSrc->sTemp) == NULL)
+	if (!HVectorEqual(psState, &psDest->sTemp, &psSrc->sTemp))
 	{	
 		return IMG_FALSE;
 	}
-	if (VectorOp(psState, USC_VEC_EQ, &sTemp, &psDest->sOutput, &psSrc->sOutput) == NULL)
+	if (!HVectorEqual(psState, &psDest->sOutput, &psSrc->sOutput))
 	{	
 		return IMG_FALSE;
 	}
@@ -3715,7 +3705,7 @@ IMG_VOID TranslateArrayElement(PINTERMEDIATE_STATE	psState,
 							   PREGISTER_LIVESET	psLiveset,
 							   IMG_UINT32			uArrayNumber,
 							   IMG_UINT32			uArrayOffset,
-							   USC_PVECTOR*			ppsVector,
+							   USC_PHVECTOR*		ppsVector,
 							   IMG_PUINT32			puStart)
 /*********************************************************************************
  Function			: TranslateArrayElement
@@ -3788,31 +3778,31 @@ IMG_INTERNAL IMG_UINT32 GetRegisterLiveMask(PINTERMEDIATE_STATE psState,
 	{
 		case USEASM_REGTYPE_TEMP: 
 		{
-			return VectorGetRange(psState, 
-								  &psLiveset->sTemp, 
-								  uStart + CHANS_PER_REGISTER - 1, 
-								  uStart);
+			return HVectorGetRange(psState, 
+								   &psLiveset->sTemp, 
+								   uStart + CHANS_PER_REGISTER - 1, 
+								   uStart);
 		}
 		case USEASM_REGTYPE_FPINTERNAL:
 		{
-			return VectorGetRange(psState, 
-								  &psLiveset->sFpInternal, 
-								  uStart + CHANS_PER_REGISTER - 1, 
-								  uStart);
+			return HVectorGetRange(psState, 
+								   &psLiveset->sFpInternal, 
+								   uStart + CHANS_PER_REGISTER - 1, 
+								   uStart);
 		}
 		case USEASM_REGTYPE_PRIMATTR:
 		{
-			return VectorGetRange(psState, 
-								  &psLiveset->sPrimAttr, 
-								  uStart + CHANS_PER_REGISTER - 1, 
-								  uStart);
+			return HVectorGetRange(psState, 
+								   &psLiveset->sPrimAttr, 
+								   uStart + CHANS_PER_REGISTER - 1, 
+								   uStart);
 		}
 		case USEASM_REGTYPE_OUTPUT: 
 		{
-			return VectorGetRange(psState, 
-								  &psLiveset->sOutput, 
-								  uStart + CHANS_PER_REGISTER - 1, 
-								  uStart);
+			return HVectorGetRange(psState, 
+								   &psLiveset->sOutput, 
+								   uStart + CHANS_PER_REGISTER - 1, 
+								   uStart);
 		}
 		case USEASM_REGTYPE_INDEX: 
 		{
@@ -3836,13 +3826,13 @@ IMG_INTERNAL IMG_UINT32 GetRegisterLiveMask(PINTERMEDIATE_STATE psState,
 		}
 		case USC_REGTYPE_REGARRAY: 
 		{
-			USC_PVECTOR	psVector;
+			USC_PHVECTOR	psVector;
 			IMG_UINT32	uStart_RegArray;
 			TranslateArrayElement(psState, psLiveset, uNumber, uArrayOffset, &psVector, &uStart_RegArray);
-			return VectorGetRange(psState,
-								  psVector,
-								  uStart_RegArray + CHANS_PER_REGISTER - 1,
-								  uStart_RegArray);
+			return HVectorGetRange(psState,
+								   psVector,
+								   uStart_RegArray + CHANS_PER_REGISTER - 1,
+								   uStart_RegArray);
 		}
 		case USC_REGTYPE_UNUSEDDEST:
 		{
@@ -3893,26 +3883,26 @@ IMG_INTERNAL IMG_VOID SetRegisterLiveMask(PINTERMEDIATE_STATE psState,
 	{
 		case USEASM_REGTYPE_TEMP: 
 		{
-			VectorSetRange(psState, &psLiveset->sTemp, 
-						   uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
+			HVectorSetRange(psState, &psLiveset->sTemp, 
+						    uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
 			break;
 		}
 		case USEASM_REGTYPE_FPINTERNAL:
 		{
-			VectorSetRange(psState, &psLiveset->sFpInternal, 
-						   uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
+			HVectorSetRange(psState, &psLiveset->sFpInternal, 
+						    uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
 			break;
 		}
 		case USEASM_REGTYPE_PRIMATTR:
 		{
-			VectorSetRange(psState, &psLiveset->sPrimAttr,
-						   uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
+			HVectorSetRange(psState, &psLiveset->sPrimAttr,
+						    uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
 			break;
 		}
 		case USEASM_REGTYPE_OUTPUT:
 		{
-			VectorSetRange(psState, &psLiveset->sOutput,
-						   uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
+			HVectorSetRange(psState, &psLiveset->sOutput,
+						    uStart + CHANS_PER_REGISTER - 1, uStart, uMask);
 			break;
 		}
 		case USEASM_REGTYPE_PREDICATE:
@@ -3931,11 +3921,11 @@ IMG_INTERNAL IMG_VOID SetRegisterLiveMask(PINTERMEDIATE_STATE psState,
 		}
 		case USC_REGTYPE_REGARRAY: 
 		{
-			USC_PVECTOR		psVector;
+			USC_PHVECTOR		psVector;
 			IMG_UINT32		uStart_RegArray;
 
 			TranslateArrayElement(psState, psLiveset, uNumber, uArrayOffset, &psVector, &uStart_RegArray);
-			VectorSetRange(psState, psVector, uStart_RegArray + CHANS_PER_REGISTER - 1, uStart_RegArray, uMask);
+			HVectorSetRange(psState, psVector, uStart_RegArray + CHANS_PER_REGISTER - 1, uStart_RegArray, uMask);
 			break;
 		}
 		case USEASM_REGTYPE_INDEX: 
@@ -3987,7 +3977,7 @@ static IMG_VOID ChangeRegisterLiveMask(PINTERMEDIATE_STATE psState,
 	IMG_UINT32 uStart = uNumber * CHANS_PER_REGISTER;
 	IMG_UINT32 uOldMask, uNewMask;
 	IMG_PUINT32 puArray = NULL;
-	USC_PVECTOR psVector = NULL;
+	USC_PHVECTOR psVector = NULL;
 
 	switch (uType)
 	{
@@ -4058,11 +4048,11 @@ static IMG_VOID ChangeRegisterLiveMask(PINTERMEDIATE_STATE psState,
 	{
 		if (bSet)
 		{
-			VectorOrRange(psState, psVector, uStart + CHANS_PER_REGISTER - 1, uStart, uWrittenMask);
+			HVectorOrRange(psState, psVector, uStart + CHANS_PER_REGISTER - 1, uStart, uWrittenMask);
 		}
 		else
 		{
-			VectorAndRange(psState, psVector, uStart + CHANS_PER_REGISTER - 1, uStart, ~uWrittenMask);
+			HVectorAndRange(psState, psVector, uStart + CHANS_PER_REGISTER - 1, uStart, ~uWrittenMask);
 		}
 	}
 }
@@ -4203,7 +4193,7 @@ IMG_UINT32 GetIndexedRegisterLiveMask(PINTERMEDIATE_STATE	psState,
 									  PREGISTER_LIVESET		psLiveset,
 								      PARG					psDest)
 {
-	USC_PVECTOR	psVector;
+	USC_PHVECTOR	psVector;
 	IMG_UINT32	uBaseReg;
 	IMG_UINT32	uNumRegs;
 	IMG_UINT32	uIdx;
@@ -4232,10 +4222,10 @@ IMG_UINT32 GetIndexedRegisterLiveMask(PINTERMEDIATE_STATE	psState,
 		IMG_UINT32		uChanIdx;
 
 		uChanIdx = (uBaseReg + uIdx) * CHANS_PER_REGISTER;
-		uLiveChansInDest |= VectorGetRange(psState, 
-										   psVector, 
-										   uChanIdx + CHANS_PER_REGISTER - 1, 
-										   uChanIdx);
+		uLiveChansInDest |= HVectorGetRange(psState, 
+										    psVector, 
+										    uChanIdx + CHANS_PER_REGISTER - 1, 
+										    uChanIdx);
 		/*
 			Stop once we can't increase the mask anymore.
 		*/
@@ -5893,6 +5883,7 @@ IMG_INTERNAL IMG_VOID DeadCodeElimination(PINTERMEDIATE_STATE psState, IMG_BOOL
 		GetRegistersLiveAtEnd(psState, &asFuncEndRegistersLive[psState->psMainProg->uLabel]);
 
 		/* Scan everything, outermost first (so functions have info from union-of-callers ready). */
+		METRICS_START(psState, REGISTER_LIVENESS);
 		for (psFunc = psState->psFnOutermost; psFunc; psFunc = psFunc->psFnNestInner)
 		{
 			if (psFunc == psState->psSecAttrProg) continue;
@@ -5907,6 +5898,7 @@ IMG_INTERNAL IMG_VOID DeadCodeElimination(PINTERMEDIATE_STATE psState, IMG_BOOL
 			DoLiveness(psState, asFuncEndRegistersLive, psFunc, &asFuncEndRegistersLive[psFunc->uLabel]/*overwritten...*/);
 			CopyRegLiveSet(psState, &asFuncEndRegistersLive[psFunc->uLabel]/*...then read here...*/, &psFunc->sCallStartRegistersLive);
 		}
+		METRICS_FINISH(psState, REGISTER_LIVENESS);
 		/*
 			That just calculated sRegistersLiveOut everywhere. Use that to delete things,
 			innermost first - so any empty functions can remove their CALLs (in outer fns!).
@@ -1866,6 +1866,36 @@ IMG_VOID SerializeOrUnSerializeVectorChunks(PINTERMEDIATE_STATE psState, PTRANS_
 	}
 }
 
+static
+IMG_VOID SerializeOrUnSerializeHVector(PINTERMEDIATE_STATE psState, PTRANS_STATE psTransState, FILE *pFile, 
+									   USC_PHVECTOR psVector, IMG_BOOL bStore)
+/*****************************************************************************
+ FUNCTION	: SerializeOrUnSerializeHVector
+
+ PURPOSE	: Serialize or Unserialize the storage of a USC_HVECTOR structure
+
+ PARAMETERS	: psState	    - Shader compiler state.
+			  psTransState	- Trans state
+			  pFile         - File Handle
+
+ RETURNS	: None.
+*****************************************************************************/
+{
+	PSTRUCT_PACKET psPacket;
+	
+	if (psVector == NULL)
+		return;
+
+	if (psVector->puWords != NULL)
+	{
+		LOAD_STORE_STRUCT(psVector->puWords, psVector->uMaxCount * sizeof(IMG_UINT32));
+	}
+	if (psVector->puWordIdx != NULL)
+	{
+		LOAD_STORE_STRUCT(psVector->puWordIdx, psVector->uMaxCount * sizeof(IMG_UINT32));
+	}
+}
+
 static
 IMG_VOID SerializeOrUnSerializeArray(PINTERMEDIATE_STATE psState, PTRANS_STATE psTransState, FILE *pFile, 
 									 USC_PARRAY *ppsArray, IMG_BOOL bStore)
@@ -2269,13 +2299,13 @@ IMG_VOID LoadOrStoreBlockToFile(PINTERMEDIATE_STATE psState, PTRANS_STATE psTran
 		ICODE_COMMENT("psBlock->sRegistersLiveOut.sPredicate");
 		SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sPredicate, bStore);
 		ICODE_COMMENT("psBlock->sRegistersLiveOut.sPrimAttr");
-		SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sPrimAttr, bStore);
+		SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sPrimAttr, bStore);
 		ICODE_COMMENT("psBlock->sRegistersLiveOut.sTemp");
-		SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sTemp, bStore);
+		SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sTemp, bStore);
 		ICODE_COMMENT("psBlock->sRegistersLiveOut.sOutput");
-		SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sOutput, bStore);
+		SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sOutput, bStore);
 		ICODE_COMMENT("psBlock->sRegistersLiveOut.sFpInternal");
-		SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sFpInternal, bStore);
+		SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psBlock->sRegistersLiveOut.sFpInternal, bStore);
 	}
 	if(!bStore)
 	{
@@ -2362,13 +2392,13 @@ IMG_VOID LoadOrStoreFunction(PINTERMEDIATE_STATE psState, PTRANS_STATE psTransSt
 	ICODE_COMMENT("psFunc->sCallStartRegistersLive.sPredicate");
 	SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sPredicate, bStore);
 	ICODE_COMMENT("psFunc->sCallStartRegistersLive.sPrimAttr");
-	SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sPrimAttr, bStore); 
+	SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sPrimAttr, bStore); 
 	ICODE_COMMENT("psFunc->sCallStartRegistersLive.sTemp");
-	SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sTemp, bStore);
+	SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sTemp, bStore);
 	ICODE_COMMENT("psFunc->sCallStartRegistersLive.sOutput");
-	SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sOutput, bStore);
+	SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sOutput, bStore);
 	ICODE_COMMENT("psFunc->sCallStartRegistersLive.sFpInternal");
-	SerializeOrUnSerializeVectorChunks(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sFpInternal, bStore);
+	SerializeOrUnSerializeHVector(psState, psTransState, pFile, &psFunc->sCallStartRegistersLive.sFpInternal, bStore);
 	ICODE_COMMENT("FUNC_END");
 	
 	if(!bStore)
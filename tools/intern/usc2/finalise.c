@@ -6217,3 +6217,258 @@ IMG_INTERNAL IMG_UINT32 FinaliseShader(PINTERMEDIATE_STATE psState)
 
 	return UF_OK;
 }
+
+static IMG_UINT32 GetInstIssueCycles(PINST psInst, IMG_BOOL bMaxPath)
+/*****************************************************************************
+ FUNCTION	: GetInstIssueCycles
+    
+ PURPOSE	: Estimate the number of cycles taken to issue a finalised
+			  instruction.
+
+ PARAMETERS	: psInst		- Instruction to estimate.
+			  bMaxPath		- For a CALL, include the most expensive path through
+							  the callee rather than the cheapest.
+			  
+ RETURNS	: The estimate.
+*****************************************************************************/
+{
+	if (psInst->eOpcode == ICALL)
+	{
+		PFUNC	psTarget = psInst->u.psCall->psTarget;
+
+		return 1 + (bMaxPath ? psTarget->uMaxPathCycles : psTarget->uMinPathCycles);
+	}
+	if (psInst->uRepeat > 1)
+	{
+		return psInst->uRepeat;
+	}
+	if ((g_psInstDesc[psInst->eOpcode].uFlags & DESC_FLAGS_VECTORDEST) == 0 && psInst->uMask > 1)
+	{
+		/*
+			The repeat mask issues one iteration for each bit set.
+		*/
+		return g_auSetBitCount[psInst->uMask & 0xF];
+	}
+	return 1;
+}
+
+static IMG_VOID GetFunctionPathCycles(PINTERMEDIATE_STATE psState, PFUNC psFunc)
+/*****************************************************************************
+ FUNCTION	: GetFunctionPathCycles
+    
+ PURPOSE	: Estimate the cycles along the cheapest and most expensive paths
+			  through a function.
+
+ PARAMETERS	: psState	- Compiler state.
+			  psFunc	- Function to estimate. Any functions it calls must
+						  already have been estimated.
+			  
+ RETURNS	: Nothing.
+
+ NOTES		: Blocks are laid out in index order so an edge to a block with a
+			  lower or equal index is a loop back edge. Those are ignored,
+			  which counts each loop body once.
+*****************************************************************************/
+{
+	PCFG		psCfg = &psFunc->sCfg;
+	IMG_PUINT32	auMinCycles;
+	IMG_PUINT32	auMaxCycles;
+	IMG_UINT32	uBlockIdx;
+
+	auMinCycles = UscAlloc(psState, sizeof(auMinCycles[0]) * psCfg->uNumBlocks);
+	auMaxCycles = UscAlloc(psState, sizeof(auMaxCycles[0]) * psCfg->uNumBlocks);
+
+	for (uBlockIdx = psCfg->uNumBlocks; uBlockIdx-- > 0; )
+	{
+		PCODEBLOCK	psBlock = psCfg->apsAllBlocks[uBlockIdx];
+		PINST		psInst;
+		IMG_UINT32	uSuccIdx;
+		IMG_UINT32	uBlockMinCycles = 0;
+		IMG_UINT32	uBlockMaxCycles = 0;
+		IMG_UINT32	uSuccMinCycles = USC_UNDEF;
+		IMG_UINT32	uSuccMaxCycles = 0;
+
+		for (psInst = psBlock->psBody; psInst != NULL; psInst = psInst->psNext)
+		{
+			uBlockMinCycles += GetInstIssueCycles(psInst, IMG_FALSE);
+			uBlockMaxCycles += GetInstIssueCycles(psInst, IMG_TRUE);
+		}
+
+		for (uSuccIdx = 0; uSuccIdx < psBlock->uNumSuccs; uSuccIdx++)
+		{
+			PCODEBLOCK	psSucc = psBlock->asSuccs[uSuccIdx].psDest;
+			IMG_UINT32	uBranchCycles;
+
+			if (psSucc->uIdx <= uBlockIdx)
+			{
+				continue;
+			}
+
+			/*
+				A conditional block always issues a branch; an unconditional one
+				only when its successor isn't laid out next.
+			*/
+			uBranchCycles = (psBlock->uNumSuccs > 1 || psSucc->uIdx != uBlockIdx + 1) ? 1U : 0U;
+
+			uSuccMinCycles = min(uSuccMinCycles, uBranchCycles + auMinCycles[psSucc->uIdx]);
+			uSuccMaxCycles = max(uSuccMaxCycles, uBranchCycles + auMaxCycles[psSucc->uIdx]);
+		}
+		if (uSuccMinCycles == USC_UNDEF)
+		{
+			uSuccMinCycles = 0;
+		}
+
+		auMinCycles[uBlockIdx] = uBlockMinCycles + uSuccMinCycles;
+		auMaxCycles[uBlockIdx] = uBlockMaxCycles + uSuccMaxCycles;
+	}
+
+	psFunc->uMinPathCycles = auMinCycles[psCfg->psEntry->uIdx];
+	psFunc->uMaxPathCycles = auMaxCycles[psCfg->psEntry->uIdx];
+
+	UscFree(psState, auMinCycles);
+	UscFree(psState, auMaxCycles);
+}
+
+IMG_INTERNAL
+IMG_VOID CollectPerfReport(PINTERMEDIATE_STATE psState, PUNIFLEX_PERF_REPORT psReport)
+/*****************************************************************************
+ FUNCTION	: CollectPerfReport
+    
+ PURPOSE	: Record static performance estimates for the compiled program.
+
+ PARAMETERS	: psState	- Compiler state, after the program has been laid out.
+			  psReport	- Returns the estimates.
+			  
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	PFUNC		psFunc;
+	IMG_UINT32	uInstCount;
+
+	memset(psReport, 0, sizeof(*psReport));
+
+	uInstCount = 0;
+
+	/*
+		Callees come before their callers in nesting order.
+	*/
+	for (psFunc = psState->psFnInnermost; psFunc != NULL; psFunc = psFunc->psFnNestOuter)
+	{
+		IMG_UINT32	uBlockIdx;
+
+		if (psFunc == psState->psSecAttrProg)
+		{
+			continue;
+		}
+
+		GetFunctionPathCycles(psState, psFunc);
+
+		for (uBlockIdx = 0; uBlockIdx < psFunc->sCfg.uNumBlocks; uBlockIdx++)
+		{
+			PCODEBLOCK	psBlock = psFunc->sCfg.apsAllBlocks[uBlockIdx];
+			PINST		psInst;
+
+			/*
+				Count the branches layout will add.
+			*/
+			if (psBlock->uNumSuccs > 1)
+			{
+				uInstCount += psBlock->uNumSuccs - 1;
+			}
+			else if (psBlock->uNumSuccs == 1 && psBlock->asSuccs[0].psDest->uIdx != uBlockIdx + 1)
+			{
+				uInstCount++;
+			}
+
+			for (psInst = psBlock->psBody; psInst != NULL; psInst = psInst->psNext)
+			{
+				uInstCount++;
+
+				switch (psInst->eOpcode)
+				{
+					#if defined(SUPPORT_SGX545)
+					case IDUAL:
+					#endif /* defined(SUPPORT_SGX545) */
+					#if defined(SUPPORT_SGX543) || defined(SUPPORT_SGX544) || defined(SUPPORT_SGX554)
+					case IVDUAL:
+					#endif /* defined(SUPPORT_SGX543) || defined(SUPPORT_SGX544) || defined(SUPPORT_SGX554) */
+					{
+						psReport->uDualIssueCount++;
+						break;
+					}
+					case ISPILLREAD:
+					{
+						psReport->uSpillLoadCount++;
+						break;
+					}
+					case ISPILLWRITE:
+					{
+						psReport->uSpillStoreCount++;
+						break;
+					}
+					#if defined(OUTPUT_USPBIN)
+					case ISMP_USP_NDR:
+					{
+						/*
+							Placeholder for a sample done by the PDS; counted with
+							the pixel shader inputs below.
+						*/
+						break;
+					}
+					#endif /* defined(OUTPUT_USPBIN) */
+					default:
+					{
+						if (g_psInstDesc[psInst->eOpcode].uFlags & DESC_FLAGS_TEXTURESAMPLE)
+						{
+							psReport->uTextureSampleCount++;
+						}
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	psReport->uMinPathCycles = psState->psMainProg->uMinPathCycles;
+	psReport->uMaxPathCycles = psState->psMainProg->uMaxPathCycles;
+
+	if (psState->psSAOffsets->eShaderType == USC_SHADERTYPE_PIXEL)
+	{
+		PUSC_LIST_ENTRY		psInputListEntry;
+
+		for (psInputListEntry = psState->sShader.psPS->sPixelShaderInputs.psHead;
+			 psInputListEntry != NULL;
+			 psInputListEntry = psInputListEntry->psNext)
+		{
+			PPIXELSHADER_INPUT	psInput = IMG_CONTAINING_RECORD(psInputListEntry, PPIXELSHADER_INPUT, sListEntry);
+
+			if (psInput->sLoad.uTexture != UNIFLEX_TEXTURE_NONE)
+			{
+				psReport->uNonDependentTextureLoadCount++;
+			}
+		}
+	}
+
+	/*
+		Only a HW build lays out the program here; for a USP build use the count
+		of instructions before the USP expands them.
+	*/
+	psReport->uMainProgInstCount = (psState->uMainProgInstCount != 0) ? psState->uMainProgInstCount : uInstCount;
+	psReport->uSAProgInstCount = psState->uSAProgInstCount;
+	psReport->uSpillAreaSize = psState->uSpillAreaSize;
+	psReport->uPrimaryAttributeCount = psState->sHWRegs.uNumPrimaryAttributes;
+	psReport->uConstSecAttrCount = psState->sSAProg.uConstSecAttrCount;
+	psReport->uTemporaryRegisterCount = max(psState->uTemporaryRegisterCount, psState->uTemporaryRegisterCountPostSplit);
+	psReport->uSecTemporaryRegisterCount = psState->uSecTemporaryRegisterCount;
+
+	DBG_PRINTF((DBG_MESSAGE, "Perf: %u insts, %u-%u cycles, %u samples (%u non-dependent), %u dual-issued, %u/%u spill ld/st, %u temps",
+				psReport->uMainProgInstCount,
+				psReport->uMinPathCycles,
+				psReport->uMaxPathCycles,
+				psReport->uTextureSampleCount,
+				psReport->uNonDependentTextureLoadCount,
+				psReport->uDualIssueCount,
+				psReport->uSpillLoadCount,
+				psReport->uSpillStoreCount,
+				psReport->uTemporaryRegisterCount));
+}
@@ -5415,7 +5415,7 @@ static IMG_VOID SetFlagForLiveRegisters(PRAGCOL_STATE psRegState, PLIVE_SET psLi
 static IMG_VOID VectorToLiveset(PINTERMEDIATE_STATE	psState,
 								PRAGCOL_STATE		psRegState, 
 								PLIVE_SET			psDest, 
-								USC_PVECTOR			psSrc, 
+								USC_PHVECTOR		psSrc, 
 								IMG_UINT32			uSrcOffset)
 /*****************************************************************************
  FUNCTION	: VectorToLiveset
@@ -5432,23 +5432,23 @@ static IMG_VOID VectorToLiveset(PINTERMEDIATE_STATE	psState,
  RETURNS	: Nothing.
 *****************************************************************************/
 {
-	VECTOR_ITERATOR	sIter;
+	HVECTOR_ITERATOR	sIter;
 
-	for (VectorIteratorInitialize(psState, psSrc, VECTOR_LENGTH, &sIter); 
-		 VectorIteratorContinue(&sIter); 
-		 VectorIteratorNext(&sIter))
+	for (HVectorIteratorInitialize(psState, psSrc, VECTOR_LENGTH, &sIter); 
+		 HVectorIteratorContinue(&sIter); 
+		 HVectorIteratorNext(&sIter))
 	{
 		IMG_UINT32	uRegNum;
 		IMG_UINT32	uNode;
 
-		uRegNum = VectorIteratorCurrentPosition(&sIter) / VECTOR_LENGTH;
+		uRegNum = HVectorIteratorCurrentPosition(&sIter) / VECTOR_LENGTH;
 		uNode = uSrcOffset + uRegNum;
 		
 		if (!GetBit(psRegState->asNodes[uNode].auFlags, NODE_FLAG_ISSECATTR))
 		{
 			IMG_UINT32	uMask;
 
-			uMask = VectorIteratorCurrentMask(&sIter);
+			uMask = HVectorIteratorCurrentMask(&sIter);
 			LiveSetAdd(psDest, uNode, uMask);
 		}
 	}
@@ -365,12 +365,193 @@ IMG_INTERNAL void UscAbort(IMG_PVOID	pvState,
 	}
 }
 
+static
+PUSC_ARENA GetArena(PINTERMEDIATE_STATE psState)
+/*****************************************************************************
+ FUNCTION	: GetArena
+
+ PURPOSE	: Gets the region arena for the current compile, creating it if
+			  this is the first allocation made on the context.
+
+ PARAMETERS	: psState		- Compiler state.
+
+ RETURNS	: The arena.
+*****************************************************************************/
+{
+	PUSC_ARENA	psArena = psState->psArena;
+
+	if (psArena == NULL)
+	{
+		psArena = psState->pfnAlloc(sizeof(USC_ARENA));
+		if (psArena == NULL)
+		{
+			/* Doesn't return. */
+			longjmp(psState->sExceptionReturn, UF_ERR_NO_MEMORY);
+		}
+		memset(psArena, 0, sizeof(*psArena));
+		psState->psArena = psArena;
+	}
+	return psArena;
+}
+
+static
+IMG_PVOID ArenaAlloc(PINTERMEDIATE_STATE psState, PUSC_ARENA psArena, IMG_UINT32 uSizeClass)
+/*****************************************************************************
+ FUNCTION	: ArenaAlloc
+
+ PURPOSE	: Allocates a small block from the region arena.
+
+ PARAMETERS	: psState		- Compiler state.
+			  psArena		- Arena to allocate from.
+			  uSizeClass	- Size class of the block.
+
+ RETURNS	: The allocated block.
+*****************************************************************************/
+{
+	PUSC_ARENA_BLOCK_HEADER	psHeader;
+	IMG_UINT32				uBlockSize;
+
+	/*
+		Reuse a block freed earlier in the compile.
+	*/
+	if (psArena->apvFreeList[uSizeClass] != NULL)
+	{
+		IMG_PVOID	pvBlock = psArena->apvFreeList[uSizeClass];
+
+		psArena->apvFreeList[uSizeClass] = *(IMG_PVOID*)pvBlock;
+		return pvBlock;
+	}
+
+	uBlockSize = sizeof(USC_ARENA_BLOCK_HEADER) + (uSizeClass + 1) * USC_ARENA_GRANULARITY;
+
+	if ((IMG_UINT32)(psArena->pbBumpEnd - psArena->pbBumpPtr) < uBlockSize)
+	{
+		PUSC_ARENA_CHUNK	psChunk;
+
+		/*
+			Start a new chunk. Whatever was left of the old one is wasted but is
+			always smaller than the largest block.
+		*/
+		psChunk = psState->pfnAlloc(USC_ARENA_CHUNK_HEADER_SIZE + USC_ARENA_CHUNK_SIZE);
+		if (psChunk == NULL)
+		{
+			/* Doesn't return. */
+			longjmp(psState->sExceptionReturn, UF_ERR_NO_MEMORY);
+		}
+		psChunk->uSize = USC_ARENA_CHUNK_SIZE;
+		psChunk->psNext = psArena->psChunkList;
+		psArena->psChunkList = psChunk;
+
+		psArena->pbBumpPtr = (IMG_PBYTE)psChunk + USC_ARENA_CHUNK_HEADER_SIZE;
+		psArena->pbBumpEnd = psArena->pbBumpPtr + USC_ARENA_CHUNK_SIZE;
+
+		psArena->sStats.uArenaBytes += USC_ARENA_CHUNK_SIZE;
+	}
+
+	psHeader = (PUSC_ARENA_BLOCK_HEADER)psArena->pbBumpPtr;
+	psHeader->uSizeClass = uSizeClass;
+	psArena->pbBumpPtr += uBlockSize;
+
+	return (IMG_PVOID)(psHeader + 1);
+}
+
+static
+IMG_VOID ArenaRelease(PINTERMEDIATE_STATE psState, IMG_BOOL bDestroy)
+/*****************************************************************************
+ FUNCTION	: ArenaRelease
+
+ PURPOSE	: Releases every small block allocated by the current compile at
+			  once and records the compile's memory statistics.
+
+ PARAMETERS	: psState		- Compiler state.
+			  bDestroy		- If TRUE free the arena itself, otherwise keep
+							  its first chunk for the next compile.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	PUSC_ARENA			psArena = psState->psArena;
+	PUSC_ARENA_CHUNK	psChunk;
+	PUSC_ARENA_CHUNK	psKeptChunk;
+
+	if (psArena == NULL)
+	{
+		return;
+	}
+
+	psState->sLastAllocStats = psArena->sStats;
+
+	/*
+		Chunks are pushed at the head of the list so the oldest is at the tail.
+	*/
+	psKeptChunk = NULL;
+	psChunk = psArena->psChunkList;
+	while (psChunk != NULL)
+	{
+		PUSC_ARENA_CHUNK	psNext = psChunk->psNext;
+
+		if (psNext == NULL && !bDestroy)
+		{
+			psKeptChunk = psChunk;
+		}
+		else
+		{
+			psState->pfnFree(psChunk);
+		}
+		psChunk = psNext;
+	}
+
+	if (bDestroy)
+	{
+		psState->pfnFree(psArena);
+		psState->psArena = NULL;
+		return;
+	}
+
+	memset(psArena, 0, sizeof(*psArena));
+	if (psKeptChunk != NULL)
+	{
+		psKeptChunk->psNext = NULL;
+		psArena->psChunkList = psKeptChunk;
+		psArena->pbBumpPtr = (IMG_PBYTE)psKeptChunk + USC_ARENA_CHUNK_HEADER_SIZE;
+		psArena->pbBumpEnd = psArena->pbBumpPtr + psKeptChunk->uSize;
+		psArena->sStats.uArenaBytes = psKeptChunk->uSize;
+	}
+}
+
+static
+IMG_VOID FinishCompileAllocations(PINTERMEDIATE_STATE psState)
+/*****************************************************************************
+ FUNCTION	: FinishCompileAllocations
+
+ PURPOSE	: Releases the region arena at the end of a successful compile.
+
+ PARAMETERS	: psState		- Compiler state.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+{
+	#ifdef DEBUG
+	if (psState->psArena != NULL && psState->psArena->uLiveBytes != 0)
+	{
+		DBG_PRINTF((DBG_WARNING, "%u bytes of internal allocations were not freed", psState->psArena->uLiveBytes));
+	}
+	#endif /* DEBUG */
+
+	ArenaRelease(psState, IMG_FALSE);
+
+	DBG_PRINTF((DBG_MESSAGE, "Compile memory: %u allocations, peak %u bytes, %u arena bytes",
+				psState->sLastAllocStats.uNumAllocs,
+				psState->sLastAllocStats.uPeakBytes,
+				psState->sLastAllocStats.uArenaBytes));
+}
+
 /*****************************************************************************
  FUNCTION	: OldAllocfn
 
  PURPOSE	: Allocates an internal memory block.
 				It is the slow path for allocations, used only for large 
-				(> SMALL_CHUNK_SIZE) allocations, which are comparatively rare. 
+				(> USC_ARENA_MAX_BLOCK_SIZE) allocations, which are comparatively rare. 
 
  PARAMETERS	: psState		- Compiler state.
 			  uSize			- The size of the block to allocate.
@@ -394,8 +575,9 @@ IMG_PVOID OldAllocfn(PINTERMEDIATE_STATE psState, const IMG_UINT32 uSize)
 		longjmp(psState->sExceptionReturn, UF_ERR_NO_MEMORY);
 	}
 	psHeader = (PUSC_ALLOC_HEADER)pvBlock;
-	#ifdef DEBUG
 	psHeader->uSize = uSize;
+	psHeader->uSizeClass = USC_ARENA_LARGE_BLOCK;
+	#ifdef DEBUG
 	psHeader->uAllocNum = psState->uAllocCount++;
 	#endif /* DEBUG */
 
@@ -431,48 +613,41 @@ IMG_PVOID UscAllocfn(PINTERMEDIATE_STATE psState, IMG_UINT32 uSize)
  RETURNS	: The allocated block.
 *****************************************************************************/
 {
-	IMG_PVOID pvBlock;
+	IMG_PVOID	pvBlock;
+	PUSC_ARENA	psArena;
+	IMG_UINT32	uAllocSize;
 
 	if (uSize == 0)
 	{
 		return NULL;
 	}
 
-#if defined(FAST_CHUNK_ALLOC)
+	psArena = GetArena(psState);
 
-	if( uSize > SMALL_CHUNK_SIZE )
+	if (uSize <= USC_ARENA_MAX_BLOCK_SIZE)
 	{
-		#ifdef USC_COLLECT_ALLOC_INFO
-		pvBlock = OldAllocfn( psState,  uSize,   uLineNumber,  pszFileName);
-		#else
-		pvBlock = OldAllocfn( psState, uSize);
-		#endif /* USC_COLLECT_ALLOC_INFO */
+		IMG_UINT32	uSizeClass = (uSize - 1) / USC_ARENA_GRANULARITY;
+
+		pvBlock = ArenaAlloc(psState, psArena, uSizeClass);
+		uAllocSize = (uSizeClass + 1) * USC_ARENA_GRANULARITY;
 	}
 	else
 	{
-		pvBlock = FastAlloc(psState);
-		if (pvBlock == NULL)
-			{
-				
-				/* Doesn't return. */
-				longjmp(psState->sExceptionReturn, UF_ERR_NO_MEMORY);
-			}
+		#ifdef USC_COLLECT_ALLOC_INFO
+		pvBlock = OldAllocfn(psState, uSize, uLineNumber, pszFileName);
+		#else
+		pvBlock = OldAllocfn(psState, uSize);
+		#endif /* USC_COLLECT_ALLOC_INFO */
+		uAllocSize = uSize;
 	}
 
-#else
-
-	#ifdef USC_COLLECT_ALLOC_INFO
-	pvBlock = OldAllocfn( psState, uSize,   uLineNumber,  pszFileName);
-	#else
-	pvBlock = OldAllocfn( psState, uSize);
-	#endif /* USC_COLLECT_ALLOC_INFO */
-
-#endif /*FAST_CHUNK_ALLOC*/
-
+	psArena->sStats.uNumAllocs++;
+	psArena->uLiveBytes += uAllocSize;
+	psArena->sStats.uPeakBytes = max(psArena->sStats.uPeakBytes, psArena->uLiveBytes);
 
 #ifdef DEBUG
 
-	psState->uMemoryUsed += uSize;
+	psState->uMemoryUsed += uAllocSize;
 	psState->uMemoryUsedHWM = max(psState->uMemoryUsedHWM, psState->uMemoryUsed);
 
 #endif /* DEBUG */
@@ -527,6 +702,8 @@ IMG_VOID _OldFree(PINTERMEDIATE_STATE psState, IMG_PVOID *pvBlock)
 		psHeader->psNext->psPrev = psHeader->psPrev;
 	}
 	
+	ASSERT(psState->psArena->uLiveBytes >= psHeader->uSize);
+	psState->psArena->uLiveBytes -= psHeader->uSize;
 	#ifdef DEBUG
 	ASSERT(psState->uMemoryUsed >= psHeader->uSize);
 	psState->uMemoryUsed -= psHeader->uSize;
@@ -550,11 +727,39 @@ IMG_VOID _UscFree(PINTERMEDIATE_STATE psState, IMG_PVOID *pvBlock)
  RETURNS	: Nothing.
 *****************************************************************************/
 {
+	IMG_UINT32	uSizeClass;
 
-#if defined(FAST_CHUNK_ALLOC)
-	if(FastFree(psState, *pvBlock) == IMG_FALSE )
-#endif
+	if (*pvBlock == NULL)
+	{
+		return;
+	}
+
+	/*
+		Both kinds of block header end with the size class.
+	*/
+	uSizeClass = ((IMG_PUINT32)(*pvBlock))[-1];
+
+	if (uSizeClass < USC_ARENA_NUM_SIZE_CLASSES)
+	{
+		PUSC_ARENA	psArena = psState->psArena;
+		IMG_UINT32	uBlockSize = (uSizeClass + 1) * USC_ARENA_GRANULARITY;
+
+		/*
+			Recycle the block for later allocations of the same size class.
+		*/
+		*(IMG_PVOID*)(*pvBlock) = psArena->apvFreeList[uSizeClass];
+		psArena->apvFreeList[uSizeClass] = *pvBlock;
+
+		ASSERT(psArena->uLiveBytes >= uBlockSize);
+		psArena->uLiveBytes -= uBlockSize;
+		#ifdef DEBUG
+		ASSERT(psState->uMemoryUsed >= uBlockSize);
+		psState->uMemoryUsed -= uBlockSize;
+		#endif /* DEBUG */
+	}
+	else
 	{
+		ASSERT(uSizeClass == USC_ARENA_LARGE_BLOCK);
 		_OldFree(psState, pvBlock);
 	}
 
@@ -3221,6 +3426,98 @@ PCODEBLOCK RemoveBlockWorkListHead(PINTERMEDIATE_STATE psState, PBLOCK_WORK_LIST
 	return psRemovedBlock;
 }
 
+static IMG_VOID GetDataflowOrder(PINTERMEDIATE_STATE	psState,
+								 PCFG					psCfg,
+								 IMG_BOOL				bForwards,
+								 IMG_PUINT32			auOrder)
+/******************************************************************************
+ Function		: GetDataflowOrder
+ 
+ Description	: Get the order in which to visit the blocks of a CFG when
+				  solving a dataflow problem: reverse postorder for a forwards
+				  analysis (so a block is normally visited after all of its
+				  predecessors) and postorder for a backwards analysis (so a block
+				  is normally visited after all of its successors).
+
+ Parameters		: psCfg		- Flowgraph to order.
+				  bForwards	- Direction of the dataflow.
+				  auOrder	- Returns the index of each block in visiting order.
+
+ Returns		: None.
+******************************************************************************/
+{
+	IMG_UINT32	uNumBlocks = psCfg->uNumBlocks;
+	PCODEBLOCK*	apsStack;
+	IMG_PUINT32	auNextSucc;
+	IMG_PUINT32	auVisited;
+	IMG_UINT32	uStackDepth;
+	IMG_UINT32	uCount;
+	IMG_UINT32	uBlock;
+
+	apsStack = UscAlloc(psState, uNumBlocks * sizeof(apsStack[0]));
+	auNextSucc = UscAlloc(psState, uNumBlocks * sizeof(auNextSucc[0]));
+	auVisited = UscAlloc(psState, UINTS_TO_SPAN_BITS(uNumBlocks) * sizeof(IMG_UINT32));
+	memset(auVisited, 0, UINTS_TO_SPAN_BITS(uNumBlocks) * sizeof(IMG_UINT32));
+
+	/*
+		Depth first traversal from the entry, recording each block when all
+		its successors have been finished.
+	*/
+	uCount = 0;
+	uStackDepth = 0;
+	apsStack[uStackDepth++] = psCfg->psEntry;
+	auNextSucc[psCfg->psEntry->uIdx] = 0;
+	SetBit(auVisited, psCfg->psEntry->uIdx, 1);
+	while (uStackDepth > 0)
+	{
+		PCODEBLOCK	psBlock = apsStack[uStackDepth - 1];
+
+		if (auNextSucc[psBlock->uIdx] < psBlock->uNumSuccs)
+		{
+			PCODEBLOCK	psSucc = psBlock->asSuccs[auNextSucc[psBlock->uIdx]++].psDest;
+
+			if (!GetBit(auVisited, psSucc->uIdx))
+			{
+				SetBit(auVisited, psSucc->uIdx, 1);
+				auNextSucc[psSucc->uIdx] = 0;
+				apsStack[uStackDepth++] = psSucc;
+			}
+		}
+		else
+		{
+			auOrder[uCount++] = psBlock->uIdx;
+			uStackDepth--;
+		}
+	}
+
+	/*
+		Blocks unreachable from the entry still need a dataflow value.
+	*/
+	for (uBlock = 0; uBlock < uNumBlocks; uBlock++)
+	{
+		if (!GetBit(auVisited, uBlock))
+		{
+			auOrder[uCount++] = uBlock;
+		}
+	}
+	ASSERT(uCount == uNumBlocks);
+
+	if (bForwards)
+	{
+		for (uBlock = 0; uBlock < (uNumBlocks / 2); uBlock++)
+		{
+			IMG_UINT32	uTemp = auOrder[uBlock];
+
+			auOrder[uBlock] = auOrder[uNumBlocks - 1 - uBlock];
+			auOrder[uNumBlocks - 1 - uBlock] = uTemp;
+		}
+	}
+
+	UscFree(psState, apsStack);
+	UscFree(psState, auNextSucc);
+	UscFree(psState, auVisited);
+}
+
 IMG_INTERNAL IMG_VOID DoDataflow(PINTERMEDIATE_STATE psState, PFUNC psFunc,
 								IMG_BOOL bForwards,
 								IMG_UINT32 uSize, IMG_PVOID pvWorking,
@@ -3252,103 +3549,100 @@ IMG_INTERNAL IMG_VOID DoDataflow(PINTERMEDIATE_STATE psState, PFUNC psFunc,
 {
 	IMG_UINT32 i, uInputArraySize = 5;
 	IMG_PVOID *apvInputs = UscAlloc(psState, uInputArraySize * sizeof(IMG_PVOID));
-	PCODEBLOCK psWorkListHead = NULL, psWorkListTail = NULL;
+	IMG_UINT32 uNumBlocks = psFunc->sCfg.uNumBlocks;
+	IMG_PUINT32 auOrder, auPosition, auPending;
+	IMG_BOOL bRepeat;
 
 	/*
-		set up work list. Since the order in which we consider blocks does not
-		affect correctness, we just use *whatever order the blocks happen to be
-		sorted in*; however, since said ordering may affect performance, we
-		take the chance of reversing it for backwards analyses.
+		The order in which we consider blocks does not affect correctness, but
+		visiting each block after the blocks its value depends on (apart from
+		along backedges) means most blocks are only processed once or twice per
+		loop nesting level. So sweep the blocks in (reverse) postorder,
+		processing only those marked as needing an update, until a sweep
+		leaves nothing marked.
 	*/
-	for (i = 0; i < psFunc->sCfg.uNumBlocks; i++)
+	auOrder = UscAlloc(psState, uNumBlocks * sizeof(auOrder[0]));
+	auPosition = UscAlloc(psState, uNumBlocks * sizeof(auPosition[0]));
+	auPending = UscAlloc(psState, UINTS_TO_SPAN_BITS(uNumBlocks) * sizeof(IMG_UINT32));
+
+	GetDataflowOrder(psState, &psFunc->sCfg, bForwards, auOrder);
+	for (i = 0; i < uNumBlocks; i++)
 	{
-		IMG_UINT32 uIdx = (bForwards) ? i : (psFunc->sCfg.uNumBlocks - 1 - i);
-		PCODEBLOCK psAddToList = psFunc->sCfg.apsAllBlocks[ uIdx ];
-		if (psWorkListTail)
-		{
-			psWorkListTail->psWorkListNext = psAddToList;
-		}
-		else
-		{
-			psWorkListHead = psAddToList;
-		}
-		psWorkListTail = psAddToList;
-		psAddToList->psWorkListNext = NULL;
+		auPosition[auOrder[i]] = i;
 	}
-	
-	//ok - just keep going while there are blocks to process.
-	while (psWorkListHead)
+	memset(auPending, 0xFF, UINTS_TO_SPAN_BITS(uNumBlocks) * sizeof(IMG_UINT32));
+
+	do
 	{
-		PCODEBLOCK psProcess = psWorkListHead;
-		PCODEBLOCK_EDGE apsAdj = bForwards ? psProcess->asPreds : psProcess->asSuccs;
-		IMG_UINT32 uNumAdj = bForwards ? psProcess->uNumPreds : psProcess->uNumSuccs;
-		
-		/* Remove from WorkList */
-		psWorkListHead = psWorkListHead->psWorkListNext;
-		psProcess->psWorkListNext = NULL;
-		if (psWorkListHead == NULL)
+		IMG_UINT32 uPos;
+
+		bRepeat = IMG_FALSE;
+		for (uPos = 0; uPos < uNumBlocks; uPos++)
 		{
-			ASSERT (psWorkListTail == psProcess);
-			psWorkListTail = NULL;
-		}
+			PCODEBLOCK psProcess = psFunc->sCfg.apsAllBlocks[auOrder[uPos]];
+			PCODEBLOCK_EDGE apsAdj = bForwards ? psProcess->asPreds : psProcess->asSuccs;
+			IMG_UINT32 uNumAdj = bForwards ? psProcess->uNumPreds : psProcess->uNumSuccs;
+
+			if (!GetBit(auPending, psProcess->uIdx))
+			{
+				continue;
+			}
+			SetBit(auPending, psProcess->uIdx, 0);
 		
-		/* Set up array of pointers to data for predecessors/successors */
-		if (uNumAdj > uInputArraySize)
-		{
-			UscFree(psState, apvInputs);
-			uInputArraySize = uNumAdj;
-			apvInputs = UscAlloc(psState, uInputArraySize * sizeof(IMG_PVOID));
-		}
+			/* Set up array of pointers to data for predecessors/successors */
+			if (uNumAdj > uInputArraySize)
+			{
+				UscFree(psState, apvInputs);
+				uInputArraySize = uNumAdj;
+				apvInputs = UscAlloc(psState, uInputArraySize * sizeof(IMG_PVOID));
+			}
 		
-		while (uNumAdj-- > 0) //NOTE DECREMENT
-		{
-			//use pointer arithmetic within working array, based on uSize.
-			IMG_UINTPTR_T uAddr = ((IMG_UINTPTR_T)pvWorking) 
-				+ (apsAdj[uNumAdj].psDest->uIdx * uSize);
-			apvInputs[uNumAdj] = (IMG_PVOID)(uAddr);
-		}
+			while (uNumAdj-- > 0) //NOTE DECREMENT
+			{
+				//use pointer arithmetic within working array, based on uSize.
+				IMG_UINTPTR_T uAddr = ((IMG_UINTPTR_T)pvWorking) 
+					+ (apsAdj[uNumAdj].psDest->uIdx * uSize);
+				apvInputs[uNumAdj] = (IMG_PVOID)(uAddr);
+			}
 		
-		// Right - parameters setup. Invoke closure... 
-		if (pfClosure(psState,
-				  psProcess,
-				  (IMG_PVOID)( ((IMG_UINTPTR_T)pvWorking) + psProcess->uIdx*uSize),
-				  apvInputs,
-				  pvUserData))
-		{
-			/*
-				Closure says to continue (i.e. different value produced)
-				- so add all dependents to worklist
-			*/
-			i=(bForwards) ? psProcess->uNumSuccs : psProcess->uNumPreds;
-			while (i-- > 0) //NOTE DECREMENT
+			// Right - parameters setup. Invoke closure... 
+			if (pfClosure(psState,
+					  psProcess,
+					  (IMG_PVOID)( ((IMG_UINTPTR_T)pvWorking) + psProcess->uIdx*uSize),
+					  apvInputs,
+					  pvUserData))
 			{
-				PCODEBLOCK psAdd;
-
-				if (bForwards)
-				{
-					psAdd = psProcess->asSuccs[i].psDest;
-				}
-				else
-				{
-					psAdd = psProcess->asPreds[i].psDest;
-				}
-				if (psAdd->psWorkListNext || psAdd == psWorkListTail) continue; //already in worklist
-				if (psWorkListTail)
-				{
-					ASSERT (psWorkListTail->psWorkListNext == NULL);
-					psWorkListTail->psWorkListNext = psAdd;
-				}
-				else
+				/*
+					Closure says to continue (i.e. different value produced)
+					- so mark all dependents. Those later in the order are
+					picked up by this sweep; anything else needs another.
+				*/
+				i=(bForwards) ? psProcess->uNumSuccs : psProcess->uNumPreds;
+				while (i-- > 0) //NOTE DECREMENT
 				{
-					ASSERT (psWorkListHead == NULL);
-					psWorkListHead = psAdd;
+					PCODEBLOCK psAdd;
+
+					if (bForwards)
+					{
+						psAdd = psProcess->asSuccs[i].psDest;
+					}
+					else
+					{
+						psAdd = psProcess->asPreds[i].psDest;
+					}
+					SetBit(auPending, psAdd->uIdx, 1);
+					if (auPosition[psAdd->uIdx] <= uPos)
+					{
+						bRepeat = IMG_TRUE;
+					}
 				}
-				psWorkListTail = psAdd;
 			}
 		}
-	}
-	ASSERT (psWorkListTail == NULL);
+	} while (bRepeat);
 
+	UscFree(psState, auOrder);
+	UscFree(psState, auPosition);
+	UscFree(psState, auPending);
 	UscFree(psState, apvInputs);
 }
 
@@ -3875,6 +4169,8 @@ IMG_VOID IMG_CALLCONV PVRUniFlexDestroyContext(IMG_PVOID		pvContext)
 	}
 #endif
 
+	ArenaRelease(psState, IMG_TRUE);
+
 #if defined (FAST_CHUNK_ALLOC)
 	MemManagerClose(psState);
 #if defined (DEBUG)
@@ -3886,6 +4182,47 @@ IMG_VOID IMG_CALLCONV PVRUniFlexDestroyContext(IMG_PVOID		pvContext)
 	psState->pfnFree(psState);
 }
 
+USC_EXPORT
+IMG_VOID IMG_CALLCONV PVRUniFlexGetAllocStats(IMG_PVOID				pvContext,
+											  PUNIFLEX_ALLOC_STATS	psStats)
+/*****************************************************************************
+ FUNCTION	: PVRUniFlexGetAllocStats
+
+ PURPOSE	: Called by the driver to get the memory statistics for the last
+			  compile on a context.
+
+ PARAMETERS	: pvContext		- The compiler context.
+			  psStats		- Returns the statistics.
+
+ RETURNS	: None.
+*****************************************************************************/
+{
+	PINTERMEDIATE_STATE psState = (PINTERMEDIATE_STATE)pvContext;
+
+	*psStats = psState->sLastAllocStats;
+}
+
+USC_EXPORT
+IMG_VOID IMG_CALLCONV PVRUniFlexGetPerfReport(IMG_PVOID				pvContext,
+											  PUNIFLEX_PERF_REPORT	psReport)
+/*****************************************************************************
+ FUNCTION	: PVRUniFlexGetPerfReport
+
+ PURPOSE	: Called by the driver or offline tools to get the static
+			  performance estimates for the last compile on a context.
+
+ PARAMETERS	: pvContext		- The compiler context.
+			  psReport		- Returns the estimates. All zero if the last
+							  compile failed.
+
+ RETURNS	: None.
+*****************************************************************************/
+{
+	PINTERMEDIATE_STATE psState = (PINTERMEDIATE_STATE)pvContext;
+
+	*psReport = psState->sLastPerfReport;
+}
+
 IMG_INTERNAL 
 IMG_VOID InsertInstAfter(PINTERMEDIATE_STATE psState,
 						  PCODEBLOCK psBlock, 
@@ -8676,7 +9013,7 @@ IMG_INTERNAL IMG_VOID CompileIntermediate(PINTERMEDIATE_STATE psState)
 	}
 	
 #if defined(SUPPORT_SGX543) || defined(SUPPORT_SGX544) || defined(SUPPORT_SGX554)
-	if ((psState->psTargetFeatures->ui32Flags & SGX_FEATURE_FLAGS_USE_VEC34) != 0)
+	if ((psState->uOptimizationLevel > 0) && (psState->psTargetFeatures->ui32Flags & SGX_FEATURE_FLAGS_USE_VEC34) != 0)
 	{
 		TESTONLY(DBG_PRINTF((DBG_MESSAGE, "------- Vector dual issued instruction formation --------\n")));
 		GenerateVectorDualIssue(psState);
@@ -8961,6 +9298,9 @@ IMG_PVOID IMG_CALLCONV PVRUniFlexCreateContext(USC_ALLOCFN	pfnAlloc,
 	psState->pfnStart = pfnStart;
 	psState->pfnFinish = pfnFinish;
 	psState->psAllocationListHead = NULL;
+	psState->psArena = NULL;
+	memset(&psState->sLastAllocStats, 0, sizeof(psState->sLastAllocStats));
+	memset(&psState->sLastPerfReport, 0, sizeof(psState->sLastPerfReport));
 	#ifdef DEBUG
 	psState->uMemoryUsedHWM = 0;
 	psState->uMemoryUsed = 0;
@@ -9023,6 +9363,13 @@ IMG_VOID CleanUpOnError(PINTERMEDIATE_STATE psState)
 
 		psState->pfnFree(psBlock);
 	}
+
+	/*
+		Free all small blocks.
+	*/
+	ArenaRelease(psState, IMG_FALSE);
+
+	memset(&psState->sLastPerfReport, 0, sizeof(psState->sLastPerfReport));
 #ifdef DEBUG
 	psState->uMemoryUsed = 0;
 #endif /* DEBUG */
@@ -9487,6 +9834,11 @@ IMG_CALLCONV PVRUniFlexCompileToHw(IMG_PVOID					pvContext,
 	*/
 	uErr = CompileToHw(psState, psHw);
 
+	/*
+		Record performance estimates from the final instruction stream.
+	*/
+	CollectPerfReport(psState, &psState->sLastPerfReport);
+
 	#ifdef SRC_DEBUG
 	/* Dump instructions with source line and cycle counts */
 	if	((psProgramParameters->uFlags & UF_QUIET) == 0)
@@ -9512,6 +9864,9 @@ IMG_CALLCONV PVRUniFlexCompileToHw(IMG_PVOID					pvContext,
 	#endif /* defined(UF_TESTBENCH) && defined(DEBUG) */
 
 	ASSERT(psState->psAllocationListHead == NULL);
+
+	/* Release the small blocks all at once */
+	FinishCompileAllocations(psState);
 	
 	/* Disable the error handler */
 	SetErrorHandler(psState, IMG_FALSE);
@@ -9658,6 +10013,11 @@ IMG_CALLCONV PVRUniFlexCompileToUspBin(IMG_PVOID					pvContext,
 	*/
 	CreateUspBinOutput(psState, &psPCShader);
 
+	/*
+		Record performance estimates from the final instruction stream.
+	*/
+	CollectPerfReport(psState, &psState->sLastPerfReport);
+
 	#ifdef SRC_DEBUG
 	if(uErr == UF_OK)
 	{
@@ -9703,6 +10063,9 @@ IMG_CALLCONV PVRUniFlexCompileToUspBin(IMG_PVOID					pvContext,
 #endif
 	
 	ASSERT(psState->psAllocationListHead == NULL);
+
+	/* Release the small blocks all at once */
+	FinishCompileAllocations(psState);
 	
 	/* Disable the error handler */
 	SetErrorHandler(psState, IMG_FALSE);
@@ -1689,7 +1689,9 @@ typedef enum
 
 	USC_METRICS_CUSTOM_TIMER_C=13,
 
-	USC_METRICS_LAST =14 /* Must always be the latest one */
+	USC_METRICS_REGISTER_LIVENESS=14,
+
+	USC_METRICS_LAST =15 /* Must always be the latest one */
 
 } USC_METRICS;
 
@@ -1792,6 +1794,66 @@ IMG_VOID IMG_CALLCONV PVRUniFlexDestroyUspBin(IMG_PVOID				pvContext,
 USC_IMPORT
 IMG_VOID IMG_CALLCONV PVRUniFlexDestroyContext(IMG_PVOID pvContext);
 
+/*
+	Memory statistics for a single compile.
+*/
+typedef struct _UNIFLEX_ALLOC_STATS
+{
+	/* Number of internal allocations made. */
+	IMG_UINT32	uNumAllocs;
+	/* Largest number of bytes allocated at any one time. */
+	IMG_UINT32	uPeakBytes;
+	/* Bytes reserved by the region arena for small allocations. */
+	IMG_UINT32	uArenaBytes;
+} UNIFLEX_ALLOC_STATS, *PUNIFLEX_ALLOC_STATS;
+
+/*
+  PVRUniFlexGetAllocStats: Get the memory statistics for the last compile on a context.
+ */
+USC_IMPORT
+IMG_VOID IMG_CALLCONV PVRUniFlexGetAllocStats(IMG_PVOID pvContext, PUNIFLEX_ALLOC_STATS psStats);
+
+/*
+	Static performance estimates for a single compile, taken from the final
+	instruction stream. All counts are per program invocation.
+*/
+typedef struct _UNIFLEX_PERF_REPORT
+{
+	/* Instructions in the main and secondary update programs. */
+	IMG_UINT32	uMainProgInstCount;
+	IMG_UINT32	uSAProgInstCount;
+	/*
+		Estimated issue cycles along the cheapest and the most expensive paths
+		through the main program. Loop bodies are counted once.
+	*/
+	IMG_UINT32	uMinPathCycles;
+	IMG_UINT32	uMaxPathCycles;
+	/* Texture samples issued by the program itself. */
+	IMG_UINT32	uTextureSampleCount;
+	/* Texture samples issued by the PDS before the program starts. */
+	IMG_UINT32	uNonDependentTextureLoadCount;
+	/*
+		Instructions issuing two operations at once. The dual-issue ratio is
+		uDualIssueCount / uMainProgInstCount.
+	*/
+	IMG_UINT32	uDualIssueCount;
+	/* Register spill instructions and the spill area size in dwords per instance. */
+	IMG_UINT32	uSpillLoadCount;
+	IMG_UINT32	uSpillStoreCount;
+	IMG_UINT32	uSpillAreaSize;
+	/* Register use. */
+	IMG_UINT32	uPrimaryAttributeCount;
+	IMG_UINT32	uConstSecAttrCount;
+	IMG_UINT32	uTemporaryRegisterCount;
+	IMG_UINT32	uSecTemporaryRegisterCount;
+} UNIFLEX_PERF_REPORT, *PUNIFLEX_PERF_REPORT;
+
+/*
+  PVRUniFlexGetPerfReport: Get the performance report for the last compile on a context.
+ */
+USC_IMPORT
+IMG_VOID IMG_CALLCONV PVRUniFlexGetPerfReport(IMG_PVOID pvContext, PUNIFLEX_PERF_REPORT psReport);
+
 #if defined(DEBUG)
 /*
 	Decode an individual uniflex input instruction.
@@ -555,10 +555,11 @@ typedef enum _USC_REGTYPE_
 typedef struct
 {
 	USC_VECTOR 		sPredicate;
-	USC_VECTOR		sPrimAttr;
-	USC_VECTOR		sTemp;
-	USC_VECTOR		sOutput;
-	USC_VECTOR		sFpInternal;
+	/* Live channels in each register (CHANS_PER_REGISTER bits per register). */
+	USC_HVECTOR		sPrimAttr;
+	USC_HVECTOR		sTemp;
+	USC_HVECTOR		sOutput;
+	USC_HVECTOR		sFpInternal;
 	IMG_UINT32		puIndexReg[UINTS_TO_SPAN_BITS(CHANS_PER_REGISTER)];
 	IMG_BOOL        bLinkReg;
 } REGISTER_LIVESET, *PREGISTER_LIVESET;
@@ -1186,6 +1187,10 @@ typedef struct _FUNC_
 
 	REGISTER_LIVESET sCallStartRegistersLive;
 
+	/* Cheapest and most expensive path through the function in cycles (see CollectPerfReport). */
+	IMG_UINT32 uMinPathCycles;
+	IMG_UINT32 uMaxPathCycles;
+
 #if defined(TRACK_REDUNDANT_PCONVERSION)
 	/* Performance measures */
 	IMG_UINT32	uWorstPathCycleEstimate;
@@ -1501,11 +1506,6 @@ typedef struct _USC_VEC_ARRAY_REG_
 typedef struct _USC_ALLOC_HEADER
 {
 	#if defined(DEBUG)
-	/*
-		Size of the allocated block (excluding the header). Used to update the current
-		memory usage when freeing a block.
-	*/
-	IMG_UINT32					uSize;
 	/*
 		Unique ID for this allocation.
 	*/
@@ -1519,8 +1519,74 @@ typedef struct _USC_ALLOC_HEADER
 	*/
 	struct _USC_ALLOC_HEADER*	psPrev;
 	struct _USC_ALLOC_HEADER*	psNext;
+	/*
+		Size of the allocated block (excluding the header). Used to update the current
+		memory usage when freeing a block.
+	*/
+	IMG_UINT32					uSize;
+	/*
+		Always USC_ARENA_LARGE_BLOCK. Must be the last field so it lines up with
+		USC_ARENA_BLOCK_HEADER.uSizeClass.
+	*/
+	IMG_UINT32					uSizeClass;
 } USC_ALLOC_HEADER, *PUSC_ALLOC_HEADER;
 
+/*
+	Small allocations are carved from large chunks owned by a per-compile region
+	arena. Freed blocks are recycled through a free list for their size class and
+	all the chunks are released at once when the compile finishes.
+*/
+#define USC_ARENA_GRANULARITY			(16U)
+#define USC_ARENA_NUM_SIZE_CLASSES		(16U)
+#define USC_ARENA_MAX_BLOCK_SIZE		(USC_ARENA_GRANULARITY * USC_ARENA_NUM_SIZE_CLASSES)
+#define USC_ARENA_CHUNK_SIZE			(64U * 1024U)
+#define USC_ARENA_LARGE_BLOCK			(USC_ARENA_NUM_SIZE_CLASSES)
+
+typedef struct _USC_ARENA_BLOCK_HEADER
+{
+	/*
+		Pads the header to 8 bytes so blocks keep the alignment of the chunk.
+	*/
+	IMG_UINT32					uReserved;
+	/*
+		Index of the block's size class.
+	*/
+	IMG_UINT32					uSizeClass;
+} USC_ARENA_BLOCK_HEADER, *PUSC_ARENA_BLOCK_HEADER;
+
+typedef struct _USC_ARENA_CHUNK
+{
+	struct _USC_ARENA_CHUNK*	psNext;
+	IMG_UINT32					uSize;
+} USC_ARENA_CHUNK, *PUSC_ARENA_CHUNK;
+
+#define USC_ARENA_CHUNK_HEADER_SIZE		((sizeof(USC_ARENA_CHUNK) + 7U) & ~7U)
+
+typedef struct _USC_ARENA
+{
+	/*
+		Chunks owned by the arena. The first is kept between compiles.
+	*/
+	PUSC_ARENA_CHUNK			psChunkList;
+	/*
+		Unused space at the end of the newest chunk.
+	*/
+	IMG_PBYTE					pbBumpPtr;
+	IMG_PBYTE					pbBumpEnd;
+	/*
+		Freed blocks of each size class.
+	*/
+	IMG_PVOID					apvFreeList[USC_ARENA_NUM_SIZE_CLASSES];
+	/*
+		Bytes currently allocated, including large blocks.
+	*/
+	IMG_UINT32					uLiveBytes;
+	/*
+		Statistics for the current compile.
+	*/
+	UNIFLEX_ALLOC_STATS			sStats;
+} USC_ARENA, *PUSC_ARENA;
+
 typedef struct _INPUT_PROGRAM
 {
 	PUNIFLEX_INST		psHead;
@@ -2410,6 +2476,19 @@ typedef struct tagINTERMEDIATE_STATE
 	IMG_UINT32					uOptimizationHint;
 
 	PUSC_ALLOC_HEADER			psAllocationListHead;
+	/*
+		Region arena for small allocations. Shared by copies of the state made
+		during the compile.
+	*/
+	PUSC_ARENA					psArena;
+	/*
+		Memory statistics for the last completed compile.
+	*/
+	UNIFLEX_ALLOC_STATS			sLastAllocStats;
+	/*
+		Performance report for the last completed compile.
+	*/
+	UNIFLEX_PERF_REPORT			sLastPerfReport;
 #ifdef DEBUG
 	IMG_UINT32					uMemoryUsed;
 	IMG_UINT32					uMemoryUsedHWM;
@@ -3355,6 +3434,7 @@ IMG_BOOL CanStartFetch(PINTERMEDIATE_STATE psState, PINST psInst);
 IMG_VOID FinaliseMemoryLoads(PINTERMEDIATE_STATE psState);
 
 IMG_VOID FinaliseMemoryStoresBP(PINTERMEDIATE_STATE psState, PCODEBLOCK psBlock, IMG_PVOID pvNull);
+IMG_VOID CollectPerfReport(PINTERMEDIATE_STATE psState, PUNIFLEX_PERF_REPORT psReport);
 
 #if defined(OUTPUT_USPBIN)
 /* uspbin.c */
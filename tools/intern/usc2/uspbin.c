@@ -514,7 +514,7 @@ static IMG_UINT32 CalcConstTableSizeForMemMappedConsts(PINTERMEDIATE_STATE psSta
 			}
 			case UNIFLEX_CONST_FORMAT_C10:
 			{
-				IMG_UINT32	uSrcIdx = (IMG_UINT32)ArrayGet(psState, psConstBuf->psRemappedMap, i);
+				IMG_UINT32	uSrcIdx = (IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psConstBuf->psRemappedMap, i);
 				if ((uSrcIdx & 3) == 3)
 				{
 					uTableSize++;
@@ -1611,7 +1611,7 @@ static IMG_VOID BuildPCProgDescConstListForMemoryMappedConsts(PBUILD_PC_SHADER_S
 					Setup a constant-load entry for this constant...
 				*/
 				sConstLoad.uFormat				= USP_PC_CONST_FMT_F32;
-				sConstLoad.sSrc.sConst.uSrcIdx	= (IMG_UINT16)((IMG_UINT32)ArrayGet(psState, psMap, i));
+				sConstLoad.sSrc.sConst.uSrcIdx	= (IMG_UINT16)((IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psMap, i));
 				sConstLoad.uDestIdx				= (IMG_UINT16)uConstDestIdx;
 				sConstLoad.uDestShift			= 0;
 
@@ -1630,7 +1630,7 @@ static IMG_VOID BuildPCProgDescConstListForMemoryMappedConsts(PBUILD_PC_SHADER_S
 			case UNIFLEX_CONST_FORMAT_F16:
 			{
 				IMG_UINT32	uHalf;
-				IMG_UINT32	uSrcIdx = (IMG_UINT32)ArrayGet(psState, psMap, i);
+				IMG_UINT32	uSrcIdx = (IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psMap, i);
 
 				for (uHalf = 0; uHalf < 2; uHalf++)
 				{
@@ -1666,7 +1666,7 @@ static IMG_VOID BuildPCProgDescConstListForMemoryMappedConsts(PBUILD_PC_SHADER_S
 
 			case UNIFLEX_CONST_FORMAT_C10:
 			{
-				IMG_UINT32	uSrcIdx = (IMG_UINT32)ArrayGet(psState, psMap, i);
+				IMG_UINT32	uSrcIdx = (IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psMap, i);
 
 				if (uSrcIdx & REMAPPED_CONSTANT_UNPACKEDC10)
 				{
@@ -1682,7 +1682,7 @@ static IMG_VOID BuildPCProgDescConstListForMemoryMappedConsts(PBUILD_PC_SHADER_S
 
 			case UNIFLEX_CONST_FORMAT_U8:
 			{
-				IMG_UINT32	uSrcIdx = (IMG_UINT32)ArrayGet(psState, psMap, i);
+				IMG_UINT32	uSrcIdx = (IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psMap, i);
 
 				AddU8Constant(psBPCSState, uConstDestIdx, uSrcIdx);
 				uConstDestIdx++;
@@ -1695,7 +1695,7 @@ static IMG_VOID BuildPCProgDescConstListForMemoryMappedConsts(PBUILD_PC_SHADER_S
 					Setup a constant-load entry for this static constant...
 				*/
 				sConstLoad.uFormat			= USP_PC_CONST_FMT_STATIC;
-				sConstLoad.sSrc.uStaticVal	= ((IMG_UINT32)ArrayGet(psState, psMap, i));
+				sConstLoad.sSrc.uStaticVal	= ((IMG_UINT32)(IMG_UINTPTR_T)ArrayGet(psState, psMap, i));
 				sConstLoad.uDestIdx			= (IMG_UINT16)uConstDestIdx;
 				sConstLoad.uDestShift		= 0;
 
@@ -3677,7 +3677,7 @@ IMG_UINT32 CreateUspBinOutput(PINTERMEDIATE_STATE	psState,
 	/*
 		Allocate space for the pre-compiled shader 
 	*/
-	uShaderSize	= (IMG_UINT32)sBPCSState.pvData;
+	uShaderSize	= (IMG_UINT32)(IMG_UINTPTR_T)sBPCSState.pvData;
 
 	pvPCShader = psState->pfnAlloc(uShaderSize);
 	if	(!pvPCShader)
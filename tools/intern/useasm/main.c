@@ -29,8 +29,12 @@
 #include <fcntl.h>
 #if !defined(LINUX)
 #include <io.h>
+#include <process.h>
 #else
 #include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 #define max(a,b) a>b?a:b
 #define stricmp strcasecmp
 #endif
@@ -81,20 +85,21 @@ static IMG_CHAR const* g_pszOptions =
 "-enablescopes  Enables named register support.\n"
 "-r=START,END   Sets the range of hardware register numbers available for\n"
 "               named registers.\n"
-"-rf\n";
+"-rf\n"
+"-jobs=N        Assemble each of the input files into its own output file\n"
+"               (named after the input with a .bin extension) running up to\n"
+"               N assemblers at once. Can't be used with -label_header.\n";
 
 static IMG_VOID usage(IMG_VOID)
 {
-	puts("Usage: useasm [OPTION] ... <infile> <outfile>\n");
+	puts("Usage: useasm [OPTION] ... <infile> <outfile>\n"
+		 "       useasm -jobs=N [OPTION] ... <infile> ...\n");
 	puts(g_pszOptions);
 }
 
 /* Input file name. */
 IMG_PCHAR g_pszInFileName;
 
-/* Was an error encountered during assembly. */
-static IMG_BOOL g_bAssemblerError;
-
 /* Was an error encountered in the c parsing module. */
 IMG_BOOL g_bCCodeError = IMG_FALSE;
 
@@ -132,11 +137,58 @@ typedef struct
 	IMG_UINT32		uExportSourceLine;
 	const IMG_CHAR*	pszImportSourceFile;
 	IMG_UINT32		uImportSourceLine;
+	/* Next label in the same hash bucket or USE_UNDEF. */
+	IMG_UINT32		uNextInBucket;
 } BRANCH;
 
-/* Database of labels in the assembler program. */
-static IMG_UINT32 g_uLabelCount;
-static BRANCH* g_psLabels;
+/* Initial number of hash buckets for the label and string tables (a power of two). */
+#define USEASM_INITIAL_HASH_BUCKETS		(64)
+
+/*
+	Everything produced while assembling one source file. The assembler callbacks
+	reach this through USEASM_CONTEXT.pvContext so several modules can be assembled
+	by the same process.
+*/
+typedef struct
+{
+	/* Database of labels in the assembler program. */
+	BRANCH*			psLabels;
+	IMG_UINT32		uLabelCount;
+	IMG_UINT32		uLabelAllocCount;
+	/* Heads of the label hash chains. */
+	IMG_PUINT32		puLabelBuckets;
+	IMG_UINT32		uLabelBucketCount;
+
+	/* Address and size of the import data segment. */
+	IMG_PVOID		pvFixupDataSegment;
+	IMG_UINT32		uFixupDataSegmentSize;
+	/* Address and size of the string segment. */
+	IMG_PVOID		pvStringSegment;
+	IMG_UINT32		uStringSegmentSize;
+	/* Hash of the strings in the string segment: bucket heads are string numbers or USE_UNDEF. */
+	IMG_PUINT32		puStringBuckets;
+	IMG_UINT32		uStringBucketCount;
+	IMG_UINT32		uStringCount;
+	IMG_UINT32		uStringAllocCount;
+	/* Offset of each string and the next string in the same bucket, indexed by string number. */
+	IMG_PUINT32		puStringOffsets;
+	IMG_PUINT32		puStringNext;
+	/* Address and size of the export segment. */
+	IMG_PVOID		pvExportDataSegment;
+	IMG_UINT32		uLabelExportCount;
+	/* Address and size of the LADDR relocation segment. */
+	IMG_PVOID		pvLADDRRelocationSegment;
+	IMG_UINT32		uLADDRRelocationCount;
+
+	/* Was an error encountered during assembly. */
+	IMG_BOOL		bAssemblerError;
+} USEASM_MODULE, *PUSEASM_MODULE;
+
+/*
+	Module being parsed. The generated parser calls FindOrCreateLabel and
+	SetLabelExportImportState without a context so they use this.
+*/
+static PUSEASM_MODULE g_psParseModule;
 
 /* Count of the number of times we have entered a nosched region. */
 IMG_UINT32 g_uSchedOffCount;
@@ -158,19 +210,6 @@ IMG_UINT32 g_uRepeatStackTop;
 IMG_UINT32 g_uInstOffset;
 /* Is this the start of nosched region. */
 IMG_BOOL g_bStartedNoSchedRegion;
- 
-/* Address and size of the import data segment. */
-IMG_PVOID	g_pvFixupDataSegment = NULL;
-IMG_UINT32	g_uFixupDataSegmentSize = 0;
-/* Address and size of the string segment. */
-IMG_PVOID	g_pvStringSegment = NULL;
-IMG_UINT32	g_uStringSegmentSize = 0;
-/* Address and size of the export segment. */
-IMG_PVOID	g_pvExportDataSegment;
-IMG_UINT32	g_uLabelExportCount;
-/* Address and size of the LADDR relocation segment. */
-IMG_PVOID	g_pvLADDRRelocationSegment = NULL;
-IMG_UINT32	g_uLADDRRelocationCount = 0;
 
 /* TRUE if we are outputting an object file. */
 IMG_BOOL	g_bWriteObjectFile;
@@ -178,26 +217,151 @@ IMG_BOOL	g_bWriteObjectFile;
 /* Required alignment for the start of the module. */
 IMG_UINT32	g_uModuleAlignment = 2;
 
+/*****************************************************************************
+ FUNCTION	: HashString
+    
+ PURPOSE	: Hashes a label name or string segment entry (FNV-1a).
+
+ PARAMETERS	: pszString		- The string to hash.
+			  
+ RETURNS	: The hash value.
+*****************************************************************************/
+static IMG_UINT32 HashString(const IMG_CHAR* pszString)
+{
+	IMG_UINT32 uHash = 2166136261U;
+
+	while (*pszString != '\0')
+	{
+		uHash ^= (IMG_UINT8)*pszString++;
+		uHash *= 16777619U;
+	}
+	return uHash;
+}
+
+/*****************************************************************************
+ FUNCTION	: InitModule
+    
+ PURPOSE	: Initialises the state for assembling one module.
+
+ PARAMETERS	: psModule		- Module to initialise.
+			  
+ RETURNS	: Nothing.
+*****************************************************************************/
+static IMG_VOID InitModule(PUSEASM_MODULE psModule)
+{
+	memset(psModule, 0, sizeof(*psModule));
+}
+
+/*****************************************************************************
+ FUNCTION	: FreeModule
+    
+ PURPOSE	: Frees the state for assembling one module.
+
+ PARAMETERS	: psModule		- Module to free.
+			  
+ RETURNS	: Nothing.
+*****************************************************************************/
+static IMG_VOID FreeModule(PUSEASM_MODULE psModule)
+{
+	IMG_UINT32 uLabel;
+
+	for (uLabel = 0; uLabel < psModule->uLabelCount; uLabel++)
+	{
+		free(psModule->psLabels[uLabel].pszName);
+	}
+	free(psModule->psLabels);
+	free(psModule->puLabelBuckets);
+	free(psModule->pvFixupDataSegment);
+	free(psModule->pvStringSegment);
+	free(psModule->puStringBuckets);
+	free(psModule->puStringNext);
+	free(psModule->puStringOffsets);
+	free(psModule->pvExportDataSegment);
+	free(psModule->pvLADDRRelocationSegment);
+	memset(psModule, 0, sizeof(*psModule));
+}
+
+/*****************************************************************************
+ FUNCTION	: RehashLabels
+    
+ PURPOSE	: Grows the label hash table and reinserts every label.
+
+ PARAMETERS	: psModule			- Module whose labels to rehash.
+			  uBucketCount		- New number of buckets (a power of two).
+			  
+ RETURNS	: Nothing.
+*****************************************************************************/
+static IMG_VOID RehashLabels(PUSEASM_MODULE psModule, IMG_UINT32 uBucketCount)
+{
+	IMG_UINT32 uLabel;
+
+	psModule->puLabelBuckets = realloc(psModule->puLabelBuckets, uBucketCount * sizeof(IMG_UINT32));
+	psModule->uLabelBucketCount = uBucketCount;
+	for (uLabel = 0; uLabel < uBucketCount; uLabel++)
+	{
+		psModule->puLabelBuckets[uLabel] = USE_UNDEF;
+	}
+	for (uLabel = 0; uLabel < psModule->uLabelCount; uLabel++)
+	{
+		IMG_UINT32 uBucket = HashString(psModule->psLabels[uLabel].pszName) & (uBucketCount - 1);
+
+		psModule->psLabels[uLabel].uNextInBucket = psModule->puLabelBuckets[uBucket];
+		psModule->puLabelBuckets[uBucket] = uLabel;
+	}
+}
+
+/*****************************************************************************
+ FUNCTION	: LookupLabel
+    
+ PURPOSE	: Finds a label by name.
+
+ PARAMETERS	: psModule		- Module to search.
+			  pszName		- Name of the label.
+			  
+ RETURNS	: The number of the label or USE_UNDEF if it doesn't exist.
+*****************************************************************************/
+static IMG_UINT32 LookupLabel(PUSEASM_MODULE psModule, const IMG_CHAR* pszName)
+{
+	IMG_UINT32 uLabel;
+
+	if (psModule->uLabelBucketCount == 0)
+	{
+		return USE_UNDEF;
+	}
+	uLabel = psModule->puLabelBuckets[HashString(pszName) & (psModule->uLabelBucketCount - 1)];
+	while (uLabel != USE_UNDEF)
+	{
+		if (strcmp(psModule->psLabels[uLabel].pszName, pszName) == 0)
+		{
+			return uLabel;
+		}
+		uLabel = psModule->psLabels[uLabel].uNextInBucket;
+	}
+	return USE_UNDEF;
+}
+
 /*****************************************************************************
  FUNCTION	: UseAssemblerLADDRNotify
     
  PURPOSE	: Records a reference to a label in a LIMM instruction.
 
- PARAMETERS	: uAddress		- The address of the LIMM instruction.
+ PARAMETERS	: pvContext		- Module being assembled.
+			  uAddress		- The address of the LIMM instruction.
 			  
  RETURNS	: Nothing.
 *****************************************************************************/
-static IMG_VOID IMG_CALLCONV UseAssemblerLADDRNotify(IMG_UINT32 uAddress)
+static IMG_VOID IMG_CALLCONV UseAssemblerLADDRNotify(IMG_PVOID pvContext, IMG_UINT32 uAddress)
 {
+	PUSEASM_MODULE			psModule = (PUSEASM_MODULE)pvContext;
 	PUSEASM_LADDRRELOCATION	psReloc;
 
-	g_pvLADDRRelocationSegment = 
-		realloc(g_pvLADDRRelocationSegment, (g_uLADDRRelocationCount + 1) * sizeof(USEASM_LADDRRELOCATION));
+	psModule->pvLADDRRelocationSegment = 
+		realloc(psModule->pvLADDRRelocationSegment, (psModule->uLADDRRelocationCount + 1) * sizeof(USEASM_LADDRRELOCATION));
 
-	psReloc = (PUSEASM_LADDRRELOCATION)g_pvLADDRRelocationSegment + g_uLADDRRelocationCount;
+	psReloc = (PUSEASM_LADDRRELOCATION)psModule->pvLADDRRelocationSegment + psModule->uLADDRRelocationCount;
 	psReloc->uAddress = uAddress;
 
-	g_uLADDRRelocationCount++;
+	psModule->uLADDRRelocationCount++;
 }
 
 /*****************************************************************************
@@ -246,7 +410,7 @@ static IMG_PVOID IMG_CALLCONV UseasmAlloc(IMG_PVOID pvContext, IMG_UINT32 uSize)
 static IMG_VOID IMG_CALLCONV UseasmFree(IMG_PVOID pvContext, IMG_PVOID pvChunk)
 {
 	PVR_UNREFERENCED_PARAMETER(pvContext);
-	UseAsm_Free(pvChunk);
+	free(pvChunk);
 }
 #endif /* defined(ENABLE_USEOPT) */
 
@@ -256,37 +420,76 @@ static IMG_VOID IMG_CALLCONV UseasmFree(IMG_PVOID pvContext, IMG_PVOID pvChunk)
     
  PURPOSE	: Adds a string to the string segment.
 
- PARAMETERS	: pszString			- The string to add.
+ PARAMETERS	: psModule			- Module being assembled.
+			  pszString			- The string to add.
 			  
  RETURNS	: The offset in bytes of the string within the string segment.
 *****************************************************************************/
-static IMG_UINT32 AddStringToStringSegment(IMG_PCHAR	pszString)
+static IMG_UINT32 AddStringToStringSegment(PUSEASM_MODULE psModule, IMG_PCHAR pszString)
 {
+	IMG_UINT32	uHash = HashString(pszString);
+	IMG_UINT32	uString;
 	IMG_UINT32	uOffset;
 
 	/*
 		Check if the string is already in the segment.
 	*/
-	uOffset = 0;
-	while (uOffset < g_uStringSegmentSize)
+	if (psModule->uStringBucketCount > 0)
 	{
-		IMG_PCHAR	pszExistingString;
-
-		pszExistingString = (IMG_PCHAR)g_pvStringSegment + uOffset;
-		if (strcmp(pszExistingString, pszString) == 0)
+		uString = psModule->puStringBuckets[uHash & (psModule->uStringBucketCount - 1)];
+		while (uString != USE_UNDEF)
 		{
-			return uOffset;
+			uOffset = psModule->puStringOffsets[uString];
+			if (strcmp((IMG_PCHAR)psModule->pvStringSegment + uOffset, pszString) == 0)
+			{
+				return uOffset;
+			}
+			uString = psModule->puStringNext[uString];
 		}
-
-		uOffset += strlen(pszExistingString) + 1;
 	}
 
 	/*
 		Otherwise grow the string segment and add the string to the end.
 	*/
-	g_pvStringSegment = realloc(g_pvStringSegment, g_uStringSegmentSize + strlen(pszString) + 1);
-	strcpy((IMG_PCHAR)g_pvStringSegment + g_uStringSegmentSize, pszString);
-	g_uStringSegmentSize += strlen(pszString) + 1;
+	uOffset = psModule->uStringSegmentSize;
+	psModule->pvStringSegment = realloc(psModule->pvStringSegment, uOffset + strlen(pszString) + 1);
+	strcpy((IMG_PCHAR)psModule->pvStringSegment + uOffset, pszString);
+	psModule->uStringSegmentSize += strlen(pszString) + 1;
+
+	if (psModule->uStringCount == psModule->uStringAllocCount)
+	{
+		psModule->uStringAllocCount = max(psModule->uStringAllocCount * 2, USEASM_INITIAL_HASH_BUCKETS);
+		psModule->puStringOffsets = realloc(psModule->puStringOffsets, psModule->uStringAllocCount * sizeof(IMG_UINT32));
+		psModule->puStringNext = realloc(psModule->puStringNext, psModule->uStringAllocCount * sizeof(IMG_UINT32));
+	}
+	uString = psModule->uStringCount++;
+	psModule->puStringOffsets[uString] = uOffset;
+
+	/*
+		Keep the load factor at or below one.
+	*/
+	if (psModule->uStringCount > psModule->uStringBucketCount)
+	{
+		IMG_UINT32	uOther;
+
+		psModule->uStringBucketCount = max(psModule->uStringBucketCount * 2, USEASM_INITIAL_HASH_BUCKETS);
+		psModule->puStringBuckets = realloc(psModule->puStringBuckets, psModule->uStringBucketCount * sizeof(IMG_UINT32));
+		for (uOther = 0; uOther < psModule->uStringBucketCount; uOther++)
+		{
+			psModule->puStringBuckets[uOther] = USE_UNDEF;
+		}
+		for (uOther = 0; uOther < uString; uOther++)
+		{
+			IMG_UINT32	uBucket;
+
+			uBucket = HashString((IMG_PCHAR)psModule->pvStringSegment + psModule->puStringOffsets[uOther]) &
+					  (psModule->uStringBucketCount - 1);
+			psModule->puStringNext[uOther] = psModule->puStringBuckets[uBucket];
+			psModule->puStringBuckets[uBucket] = uOther;
+		}
+	}
+	psModule->puStringNext[uString] = psModule->puStringBuckets[uHash & (psModule->uStringBucketCount - 1)];
+	psModule->puStringBuckets[uHash & (psModule->uStringBucketCount - 1)] = uString;
 
 	return uOffset;
 }
@@ -296,46 +499,46 @@ static IMG_UINT32 AddStringToStringSegment(IMG_PCHAR	pszString)
     
  PURPOSE	: Create the export segment in memory.
 
- PARAMETERS	: None.
+ PARAMETERS	: psModule		- Module being assembled.
 			  
  RETURNS	: None.
 *****************************************************************************/
-static IMG_BOOL PrepareExportSegment(IMG_VOID)
+static IMG_BOOL PrepareExportSegment(PUSEASM_MODULE psModule)
 {
 	IMG_UINT32	uLabel;
 
-	g_uLabelExportCount = 0;
-	g_pvExportDataSegment = NULL;
-	for (uLabel = 0; uLabel < g_uLabelCount; uLabel++)
+	psModule->uLabelExportCount = 0;
+	psModule->pvExportDataSegment = NULL;
+	for (uLabel = 0; uLabel < psModule->uLabelCount; uLabel++)
 	{
-		if (g_psLabels[uLabel].bExported)
+		if (psModule->psLabels[uLabel].bExported)
 		{
 			PUSEASM_EXPORTDATA	psExport;
 
-			if (g_psLabels[uLabel].uAddress ==  USE_UNDEF)
+			if (psModule->psLabels[uLabel].uAddress ==  USE_UNDEF)
 			{
 #if defined(__psp2__)
 				sceClibPrintf("%s(%d): error: Label '%s' is exported but never defined.\n",
-						g_psLabels[uLabel].pszExportSourceFile,
-						g_psLabels[uLabel].uExportSourceLine,
-						g_psLabels[uLabel].pszName);
+						psModule->psLabels[uLabel].pszExportSourceFile,
+						psModule->psLabels[uLabel].uExportSourceLine,
+						psModule->psLabels[uLabel].pszName);
 #else
 				fprintf(stderr, "%s(%d): error: Label '%s' is exported but never defined.\n",
-						g_psLabels[uLabel].pszExportSourceFile, 
-						g_psLabels[uLabel].uExportSourceLine, 
-						g_psLabels[uLabel].pszName);
+						psModule->psLabels[uLabel].pszExportSourceFile, 
+						psModule->psLabels[uLabel].uExportSourceLine, 
+						psModule->psLabels[uLabel].pszName);
 #endif
 				return IMG_FALSE;
 			}
 
-			g_pvExportDataSegment = realloc(g_pvExportDataSegment, (g_uLabelExportCount + 1) * sizeof(USEASM_EXPORTDATA));
+			psModule->pvExportDataSegment = realloc(psModule->pvExportDataSegment, (psModule->uLabelExportCount + 1) * sizeof(USEASM_EXPORTDATA));
 
-			psExport = (PUSEASM_EXPORTDATA)g_pvExportDataSegment + g_uLabelExportCount;
+			psExport = (PUSEASM_EXPORTDATA)psModule->pvExportDataSegment + psModule->uLabelExportCount;
 
-			psExport->uNameOffset = AddStringToStringSegment(g_psLabels[uLabel].pszName);
-			psExport->uLabelAddress = g_psLabels[uLabel].uAddress;
+			psExport->uNameOffset = AddStringToStringSegment(psModule, psModule->psLabels[uLabel].pszName);
+			psExport->uLabelAddress = psModule->psLabels[uLabel].uAddress;
 
-			g_uLabelExportCount++;
+			psModule->uLabelExportCount++;
 		}
 	}
 	return IMG_TRUE;
@@ -346,13 +549,15 @@ static IMG_BOOL PrepareExportSegment(IMG_VOID)
     
  PURPOSE	: Creates a USEASM object file.
 
- PARAMETERS	: uInstCount		- Count of instructions in the module.
+ PARAMETERS	: psModule			- Module being assembled.
+			  uInstCount		- Count of instructions in the module.
 			  puInsts			- Pointer to the instructions for the module.
 			  fOutFile			- Handle to the output file.
 			  
  RETURNS	: TRUE if the file was written successfully.
 *****************************************************************************/
-static IMG_BOOL WriteObjectFile(IMG_UINT32				uInstCount,
+static IMG_BOOL WriteObjectFile(PUSEASM_MODULE			psModule,
+								IMG_UINT32				uInstCount,
 								IMG_PUINT32				puInsts,
 								FILE*					fOutFile)
 {
@@ -370,21 +575,21 @@ static IMG_BOOL WriteObjectFile(IMG_UINT32				uInstCount,
 	sHeader.uInstructionCount = uInstCount;
 	uOutputOffset += uInstCount * EURASIA_USE_INSTRUCTION_SIZE;
 
-	sHeader.uExportDataCount = g_uLabelExportCount;
+	sHeader.uExportDataCount = psModule->uLabelExportCount;
 	sHeader.uExportDataOffset = uOutputOffset;
-	uOutputOffset += g_uLabelExportCount * sizeof(USEASM_EXPORTDATA);
+	uOutputOffset += psModule->uLabelExportCount * sizeof(USEASM_EXPORTDATA);
 
 	sHeader.uImportDataOffset = uOutputOffset;
-	sHeader.uImportDataCount = g_uFixupDataSegmentSize / sizeof(USEASM_IMPORTDATA);
-	uOutputOffset += g_uFixupDataSegmentSize;
+	sHeader.uImportDataCount = psModule->uFixupDataSegmentSize / sizeof(USEASM_IMPORTDATA);
+	uOutputOffset += psModule->uFixupDataSegmentSize;
 
 	sHeader.uStringDataOffset = uOutputOffset;
-	sHeader.uStringDataSize = g_uStringSegmentSize;
-	uOutputOffset += g_uStringSegmentSize;
+	sHeader.uStringDataSize = psModule->uStringSegmentSize;
+	uOutputOffset += psModule->uStringSegmentSize;
 
-	sHeader.uLADDRRelocationCount = g_uLADDRRelocationCount;
+	sHeader.uLADDRRelocationCount = psModule->uLADDRRelocationCount;
 	sHeader.uLADDRRelocationOffset = uOutputOffset;
-	uOutputOffset +=  g_uLADDRRelocationCount * sizeof(USEASM_LADDRRELOCATION);
+	uOutputOffset +=  psModule->uLADDRRelocationCount * sizeof(USEASM_LADDRRELOCATION);
 
 #ifdef HW_REGS_ALLOC_ENABLED
 	sHeader.uHwRegsAllocRangeStart = GetHwRegsAllocRangeStartForBinary();
@@ -399,19 +604,19 @@ static IMG_BOOL WriteObjectFile(IMG_UINT32				uInstCount,
 	{
 		goto write_failed;
 	}
-	if (fwrite(g_pvExportDataSegment, sizeof(USEASM_EXPORTDATA), g_uLabelExportCount, fOutFile) != g_uLabelExportCount)
+	if (fwrite(psModule->pvExportDataSegment, sizeof(USEASM_EXPORTDATA), psModule->uLabelExportCount, fOutFile) != psModule->uLabelExportCount)
 	{
 		goto write_failed;
 	}
-	if (fwrite(g_pvFixupDataSegment, 1, g_uFixupDataSegmentSize, fOutFile) != g_uFixupDataSegmentSize)
+	if (fwrite(psModule->pvFixupDataSegment, 1, psModule->uFixupDataSegmentSize, fOutFile) != psModule->uFixupDataSegmentSize)
 	{
 		goto write_failed;
 	}
-	if (fwrite(g_pvStringSegment, 1, g_uStringSegmentSize, fOutFile) != g_uStringSegmentSize)
+	if (fwrite(psModule->pvStringSegment, 1, psModule->uStringSegmentSize, fOutFile) != psModule->uStringSegmentSize)
 	{
 		goto write_failed;
 	}
-	if (fwrite(g_pvLADDRRelocationSegment, sizeof(USEASM_LADDRRELOCATION), g_uLADDRRelocationCount, fOutFile) != g_uLADDRRelocationCount)
+	if (fwrite(psModule->pvLADDRRelocationSegment, sizeof(USEASM_LADDRRELOCATION), psModule->uLADDRRelocationCount, fOutFile) != psModule->uLADDRRelocationCount)
 	{
 		goto write_failed;
 	}
@@ -446,48 +651,50 @@ IMG_VOID SetLabelExportImportState(IMG_UINT32	uLabelId,
 								   IMG_BOOL		bImported,
 								   IMG_BOOL		bExported)
 {
-	assert(uLabelId < g_uLabelCount);
+	PUSEASM_MODULE	psModule = g_psParseModule;
+
+	assert(uLabelId < psModule->uLabelCount);
 	assert(!(bImported && bExported));
 	if (
-			(bExported && g_psLabels[uLabelId].bImported) ||
-			(bImported && g_psLabels[uLabelId].bExported)
+			(bExported && psModule->psLabels[uLabelId].bImported) ||
+			(bImported && psModule->psLabels[uLabelId].bExported)
 	   )
 	{
 #if defined(__psp2__)
 		sceClibPrintf("%s(%d): error: Label '%s' is both imported and exported.\n",
-			pszSourceFile, uSourceLine, g_psLabels[uLabelId].pszName);
+			pszSourceFile, uSourceLine, psModule->psLabels[uLabelId].pszName);
 #else
 		fprintf(stderr, "%s(%d): error: Label '%s' is both imported and exported.\n",
-			pszSourceFile, uSourceLine, g_psLabels[uLabelId].pszName);
+			pszSourceFile, uSourceLine, psModule->psLabels[uLabelId].pszName);
 #endif
-		g_bAssemblerError = TRUE;
+		psModule->bAssemblerError = TRUE;
 	}
 	if (bExported)
 	{
-		g_psLabels[uLabelId].bExported = TRUE;
-		g_psLabels[uLabelId].pszExportSourceFile = pszSourceFile;
-		g_psLabels[uLabelId].uExportSourceLine = uSourceLine;
+		psModule->psLabels[uLabelId].bExported = TRUE;
+		psModule->psLabels[uLabelId].pszExportSourceFile = pszSourceFile;
+		psModule->psLabels[uLabelId].uExportSourceLine = uSourceLine;
 	}
 	if (bImported)
 	{
-		if (g_psLabels[uLabelId].bDefined)
+		if (psModule->psLabels[uLabelId].bDefined)
 		{
 #if defined(__psp2__)
 			sceClibPrintf("%s(%d): error: Label '%s' is both imported and defined.\n",
-				pszSourceFile, uSourceLine, g_psLabels[uLabelId].pszName);
+				pszSourceFile, uSourceLine, psModule->psLabels[uLabelId].pszName);
 			sceClibPrintf("%s(%d): error: This is the location of the definition.\n",
-				g_psLabels[uLabelId].pszSourceFile, g_psLabels[uLabelId].uSourceLine);
+				psModule->psLabels[uLabelId].pszSourceFile, psModule->psLabels[uLabelId].uSourceLine);
 #else
 			fprintf(stderr, "%s(%d): error: Label '%s' is both imported and defined.\n",
-				pszSourceFile, uSourceLine, g_psLabels[uLabelId].pszName);
+				pszSourceFile, uSourceLine, psModule->psLabels[uLabelId].pszName);
 			fprintf(stderr, "%s(%d): error: This is the location of the definition.\n",
-				g_psLabels[uLabelId].pszSourceFile, g_psLabels[uLabelId].uSourceLine);
+				psModule->psLabels[uLabelId].pszSourceFile, psModule->psLabels[uLabelId].uSourceLine);
 #endif
-			g_bAssemblerError = TRUE;
+			psModule->bAssemblerError = TRUE;
 		}
-		g_psLabels[uLabelId].bImported = TRUE;
-		g_psLabels[uLabelId].pszImportSourceFile = pszSourceFile;
-		g_psLabels[uLabelId].uImportSourceLine = uSourceLine;
+		psModule->psLabels[uLabelId].bImported = TRUE;
+		psModule->psLabels[uLabelId].pszImportSourceFile = pszSourceFile;
+		psModule->psLabels[uLabelId].uImportSourceLine = uSourceLine;
 	}
 }
 
@@ -496,7 +703,8 @@ IMG_VOID SetLabelExportImportState(IMG_UINT32	uLabelId,
 
  PURPOSE	: Adds an imported label to the import segment.
 
- PARAMETERS	: uLabelId			- The ID of the label.
+ PARAMETERS	: psModule			- Module being assembled.
+			  uLabelId			- The ID of the label.
 			  uFixOp			- The type of reference to the label.
 			  uFixupAddress		- The address of the reference to the label.
 			  pszFixupSourceFileName	- The location in the input of the
@@ -504,7 +712,8 @@ IMG_VOID SetLabelExportImportState(IMG_UINT32	uLabelId,
 
  RETURNS	: TRUE if the label was flagged as imported.
 *****************************************************************************/
-static IMG_BOOL UseAssemblerAddImportedLabel(IMG_UINT32	uLabelId,
+static IMG_BOOL UseAssemblerAddImportedLabel(PUSEASM_MODULE	psModule,
+											  IMG_UINT32	uLabelId,
 											  IMG_UINT32	uFixupOp,
 											  IMG_UINT32	uFixupAddress,
 											  IMG_PCHAR		pszFixupSourceFileName,
@@ -513,7 +722,7 @@ static IMG_BOOL UseAssemblerAddImportedLabel(IMG_UINT32	uLabelId,
 {
 	PUSEASM_IMPORTDATA	psData;
 	
-	if (!g_psLabels[uLabelId].bImported)
+	if (!psModule->psLabels[uLabelId].bImported)
 	{
 		return IMG_FALSE;
 	}
@@ -528,21 +737,21 @@ static IMG_BOOL UseAssemblerAddImportedLabel(IMG_UINT32	uLabelId,
 				pszFixupSourceFileName,
 				uFixupSourceLineNumber);
 #endif
-		g_bAssemblerError = TRUE;
+		psModule->bAssemblerError = TRUE;
 	}
 
-	g_pvFixupDataSegment = 
-		realloc(g_pvFixupDataSegment, g_uFixupDataSegmentSize + sizeof(USEASM_IMPORTDATA));
-	psData = (PUSEASM_IMPORTDATA)((IMG_PBYTE)g_pvFixupDataSegment + g_uFixupDataSegmentSize);
-	psData->uNameOffset = AddStringToStringSegment(g_psLabels[uLabelId].pszName);
+	psModule->pvFixupDataSegment = 
+		realloc(psModule->pvFixupDataSegment, psModule->uFixupDataSegmentSize + sizeof(USEASM_IMPORTDATA));
+	psData = (PUSEASM_IMPORTDATA)((IMG_PBYTE)psModule->pvFixupDataSegment + psModule->uFixupDataSegmentSize);
+	psData->uNameOffset = AddStringToStringSegment(psModule, psModule->psLabels[uLabelId].pszName);
 	psData->uFixupOp = uFixupOp;
 	psData->uFixupAddress = uFixupAddress;
 	psData->bFixupSyncEnd = IMG_FALSE;
 	psData->uFixupOffset = 0;
-	psData->uFixupSourceFileNameOffset = AddStringToStringSegment(pszFixupSourceFileName);
+	psData->uFixupSourceFileNameOffset = AddStringToStringSegment(psModule, pszFixupSourceFileName);
 	psData->uFixupSourceLineNumber = uFixupSourceLineNumber;
 
-	g_uFixupDataSegmentSize += sizeof(USEASM_IMPORTDATA);
+	psModule->uFixupDataSegmentSize += sizeof(USEASM_IMPORTDATA);
 
 	return IMG_TRUE;
 }
@@ -570,7 +779,8 @@ static IMG_VOID ImportUndefinedLabels(PUSEASM_CONTEXT psContext, IMG_PUINT32 puB
 
 			uOffset = (psLabelContext->psLabelReferences[i].puOffset - puBaseInst) / 2;
 
-			if (!UseAssemblerAddImportedLabel(psLabelContext->psLabelReferences[i].uLabel,
+			if (!UseAssemblerAddImportedLabel((PUSEASM_MODULE)psContext->pvContext,
+											  psLabelContext->psLabelReferences[i].uLabel,
 											  psLabelContext->psLabelReferences[i].uOp,
 											  uOffset,
 											  psLabelContext->psLabelReferences[i].psInst->pszSourceFile,
@@ -601,75 +811,96 @@ IMG_UINT32 FindOrCreateLabel(const IMG_CHAR* pszNameIn, IMG_BOOL bCreateOnly, co
  RETURNS	: The number of the label.
 *****************************************************************************/
 {
+	PUSEASM_MODULE psModule = g_psParseModule;
 	IMG_UINT32 i;
+	IMG_UINT32 uBucket;
 	IMG_PCHAR pszColon;
 	IMG_PCHAR pszName = strdup(pszNameIn);
 	if ((pszColon = strrchr(pszName, ':')) != NULL)
 	{
 		*pszColon = 0;
 	}
-	for (i = 0; i < g_uLabelCount; i++)
+	i = LookupLabel(psModule, pszName);
+	if (i != USE_UNDEF)
 	{
-		if (strcmp(g_psLabels[i].pszName, pszName) == 0)
+		free(pszName);
+		if (bCreateOnly)
 		{
-			UseAsm_Free(pszName);
-			if (bCreateOnly)
+			if (psModule->psLabels[i].bImported)
 			{
-				if (g_psLabels[i].bImported)
-				{
 #if defined(__psp2__)
-					sceClibPrintf("%s(%d): error: Label '%s' is both imported and defined.\n",
-						g_psLabels[i].pszImportSourceFile, g_psLabels[i].uImportSourceLine, g_psLabels[i].pszName);
-					sceClibPrintf("%s(%d): error: This is the location of the definition.\n",
-						pszSourceFile, uSourceLine);
+				sceClibPrintf("%s(%d): error: Label '%s' is both imported and defined.\n",
+					psModule->psLabels[i].pszImportSourceFile, psModule->psLabels[i].uImportSourceLine, psModule->psLabels[i].pszName);
+				sceClibPrintf("%s(%d): error: This is the location of the definition.\n",
+					pszSourceFile, uSourceLine);
 #else
-					fprintf(stderr, "%s(%d): error: Label '%s' is both imported and defined.\n",
-						g_psLabels[i].pszImportSourceFile, g_psLabels[i].uImportSourceLine, g_psLabels[i].pszName);
-					fprintf(stderr, "%s(%d): error: This is the location of the definition.\n",
-						pszSourceFile, uSourceLine);
+				fprintf(stderr, "%s(%d): error: Label '%s' is both imported and defined.\n",
+					psModule->psLabels[i].pszImportSourceFile, psModule->psLabels[i].uImportSourceLine, psModule->psLabels[i].pszName);
+				fprintf(stderr, "%s(%d): error: This is the location of the definition.\n",
+					pszSourceFile, uSourceLine);
 #endif
-					g_bAssemblerError = TRUE;
-				}
-				if (g_psLabels[i].bDefined)
-				{
+				psModule->bAssemblerError = TRUE;
+			}
+			if (psModule->psLabels[i].bDefined)
+			{
 #if defined(__psp2__)
-					sceClibPrintf("%s(%d): error: Label '%s' already defined\n"
-							"%s(%d): error: this is the location of the previous definition\n", pszSourceFile, uSourceLine,
-							g_psLabels[i].pszName, g_psLabels[i].pszSourceFile, g_psLabels[i].uSourceLine);
+				sceClibPrintf("%s(%d): error: Label '%s' already defined\n"
+						"%s(%d): error: this is the location of the previous definition\n", pszSourceFile, uSourceLine,
+						psModule->psLabels[i].pszName, psModule->psLabels[i].pszSourceFile, psModule->psLabels[i].uSourceLine);
 #else
-					fprintf(stderr, "%s(%d): error: Label '%s' already defined\n"
-							"%s(%d): error: this is the location of the previous definition\n", pszSourceFile, uSourceLine,
-							g_psLabels[i].pszName, g_psLabels[i].pszSourceFile, g_psLabels[i].uSourceLine);
+				fprintf(stderr, "%s(%d): error: Label '%s' already defined\n"
+						"%s(%d): error: this is the location of the previous definition\n", pszSourceFile, uSourceLine,
+						psModule->psLabels[i].pszName, psModule->psLabels[i].pszSourceFile, psModule->psLabels[i].uSourceLine);
 #endif
-					g_bAssemblerError = TRUE;
-				}
-				else
-				{
-					g_psLabels[i].pszSourceFile = strdup(pszSourceFile);
-					g_psLabels[i].uSourceLine = uSourceLine;
-					g_psLabels[i].bDefined = TRUE;
-				}
+				psModule->bAssemblerError = TRUE;
+			}
+			else
+			{
+				psModule->psLabels[i].pszSourceFile = strdup(pszSourceFile);
+				psModule->psLabels[i].uSourceLine = uSourceLine;
+				psModule->psLabels[i].bDefined = TRUE;
 			}
-			return i;
 		}
+		return i;
+	}
+
+	/*
+		Grow the label array geometrically and keep the hash load factor at or below one.
+	*/
+	if (psModule->uLabelCount == psModule->uLabelAllocCount)
+	{
+		psModule->uLabelAllocCount = max(psModule->uLabelAllocCount * 2, USEASM_INITIAL_HASH_BUCKETS);
+		psModule->psLabels = realloc(psModule->psLabels, psModule->uLabelAllocCount * sizeof(psModule->psLabels[0]));
 	}
-	g_psLabels = realloc(g_psLabels, (g_uLabelCount + 1) * sizeof(g_psLabels[0]));
-	g_psLabels[g_uLabelCount].pszName = pszName;
-	g_psLabels[g_uLabelCount].uAddress =  USE_UNDEF;
+	i = psModule->uLabelCount++;
+	psModule->psLabels[i].pszName = pszName;
+	psModule->psLabels[i].uAddress =  USE_UNDEF;
 	if (bCreateOnly)
 	{
-		g_psLabels[g_uLabelCount].pszSourceFile = strdup(pszSourceFile);
-		g_psLabels[g_uLabelCount].uSourceLine = uSourceLine;
-		g_psLabels[g_uLabelCount].bDefined = TRUE;
+		psModule->psLabels[i].pszSourceFile = strdup(pszSourceFile);
+		psModule->psLabels[i].uSourceLine = uSourceLine;
+		psModule->psLabels[i].bDefined = TRUE;
 	}
 	else
 	{
-		g_psLabels[g_uLabelCount].bDefined = FALSE;
+		psModule->psLabels[i].pszSourceFile = NULL;
+		psModule->psLabels[i].uSourceLine = 0;
+		psModule->psLabels[i].bDefined = FALSE;
 	}
-	g_psLabels[g_uLabelCount].bImported = FALSE;
-	g_psLabels[g_uLabelCount].bExported = FALSE;
-	g_uLabelCount++;
-	return g_uLabelCount - 1;
+	psModule->psLabels[i].bImported = FALSE;
+	psModule->psLabels[i].bExported = FALSE;
+
+	if (psModule->uLabelCount > psModule->uLabelBucketCount)
+	{
+		RehashLabels(psModule, max(psModule->uLabelBucketCount * 2, USEASM_INITIAL_HASH_BUCKETS));
+	}
+	else
+	{
+		uBucket = HashString(pszName) & (psModule->uLabelBucketCount - 1);
+		psModule->psLabels[i].uNextInBucket = psModule->puLabelBuckets[uBucket];
+		psModule->puLabelBuckets[uBucket] = i;
+	}
+	return i;
 }
 
 static IMG_UINT32 IMG_CALLCONV UseAssemblerGetLabelAddress(IMG_PVOID pvContext, IMG_UINT32 uLabel)
@@ -684,8 +915,9 @@ static IMG_UINT32 IMG_CALLCONV UseAssemblerGetLabelAddress(IMG_PVOID pvContext,
  RETURNS	: Either the address of the label if it has been defined or zero.
 *****************************************************************************/
 {
-	PVR_UNREFERENCED_PARAMETER(pvContext);
-	return g_psLabels[uLabel].uAddress;
+	PUSEASM_MODULE psModule = (PUSEASM_MODULE)pvContext;
+
+	return psModule->psLabels[uLabel].uAddress;
 }
 
 static IMG_VOID IMG_CALLCONV UseAssemblerSetLabelAddress(IMG_PVOID pvContext, IMG_UINT32 uLabel, IMG_UINT32 uAddress)
@@ -701,8 +933,9 @@ static IMG_VOID IMG_CALLCONV UseAssemblerSetLabelAddress(IMG_PVOID pvContext, IM
  RETURNS	: Nothing.
 *****************************************************************************/
 {
-	PVR_UNREFERENCED_PARAMETER(pvContext);
-	g_psLabels[uLabel].uAddress = uAddress;
+	PUSEASM_MODULE psModule = (PUSEASM_MODULE)pvContext;
+
+	psModule->psLabels[uLabel].uAddress = uAddress;
 }
 
 static IMG_PCHAR IMG_CALLCONV UseAssemblerGetLabelName(IMG_PVOID pvContext, IMG_UINT32 uLabel)
@@ -717,8 +950,9 @@ static IMG_PCHAR IMG_CALLCONV UseAssemblerGetLabelName(IMG_PVOID pvContext, IMG_
  RETURNS	: The name of the label.
 *****************************************************************************/
 {
-	PVR_UNREFERENCED_PARAMETER(pvContext);
-	return g_psLabels[uLabel].pszName;
+	PUSEASM_MODULE psModule = (PUSEASM_MODULE)pvContext;
+
+	return psModule->psLabels[uLabel].pszName;
 }
 
 IMG_VOID AssemblerError(IMG_PVOID pvContext, PUSE_INST psInst, IMG_PCHAR pszFmt, ...)
@@ -727,7 +961,7 @@ IMG_VOID AssemblerError(IMG_PVOID pvContext, PUSE_INST psInst, IMG_PCHAR pszFmt,
     
  PURPOSE	: Report an error during assembly to the user.
 
- PARAMETERS	: pvContext		- Caller defined context pointer (unused here)
+ PARAMETERS	: pvContext		- Module being assembled, or NULL from the parser.
 			  psInst		- Instruction that caused the error.
 			  pszFmt, ...	- Printf format string and arguments.
 			  
@@ -735,8 +969,7 @@ IMG_VOID AssemblerError(IMG_PVOID pvContext, PUSE_INST psInst, IMG_PCHAR pszFmt,
 *****************************************************************************/
 {
 	va_list ap;
-
-	PVR_UNREFERENCED_PARAMETER(pvContext);
+	PUSEASM_MODULE psModule = (pvContext != NULL) ? (PUSEASM_MODULE)pvContext : g_psParseModule;
 
 #if defined(__psp2__)
 	sceClibPrintf("%s(%d): AssemblerError", psInst->pszSourceFile, psInst->uSourceLine);
@@ -748,7 +981,7 @@ IMG_VOID AssemblerError(IMG_PVOID pvContext, PUSE_INST psInst, IMG_PCHAR pszFmt,
 	va_end(ap);
 #endif
 
-	g_bAssemblerError = TRUE;
+	psModule->bAssemblerError = TRUE;
 }
 
 IMG_VOID AssemblerWarning(PUSE_INST psInst, IMG_PCHAR pszFmt, ...)
@@ -911,6 +1144,158 @@ static IMG_BOOL CanSetSkipinvFlag(PCSGX_CORE_DESC psTarget, PUSE_INST psInst)
 }
 
 #if !defined(__psp2__)
+#if defined(LINUX)
+typedef pid_t USEASM_JOB;
+#else
+typedef intptr_t USEASM_JOB;
+#endif
+
+/*****************************************************************************
+ FUNCTION	: StartAssemblerJob
+    
+ PURPOSE	: Starts another copy of the assembler on one input file.
+
+ PARAMETERS	: ppszArgs		- NULL terminated command line for the copy.
+			  psJob			- Returns the handle for the copy.
+			  
+ RETURNS	: TRUE if the copy was started.
+*****************************************************************************/
+static IMG_BOOL StartAssemblerJob(IMG_PCHAR* ppszArgs, USEASM_JOB* psJob)
+{
+#if defined(LINUX)
+	pid_t iPid;
+
+	fflush(stdout);
+	fflush(stderr);
+	iPid = fork();
+	if (iPid < 0)
+	{
+		return IMG_FALSE;
+	}
+	if (iPid == 0)
+	{
+		execvp(ppszArgs[0], ppszArgs);
+		fprintf(stderr, "%s: Couldn't start assembler: %s.\n", ppszArgs[0], strerror(errno));
+		_exit(127);
+	}
+	*psJob = iPid;
+#else
+	*psJob = _spawnvp(_P_NOWAIT, ppszArgs[0], (const char* const*)ppszArgs);
+	if (*psJob == -1)
+	{
+		return IMG_FALSE;
+	}
+#endif
+	return IMG_TRUE;
+}
+
+/*****************************************************************************
+ FUNCTION	: WaitForAssemblerJob
+    
+ PURPOSE	: Waits for a copy of the assembler started by StartAssemblerJob.
+
+ PARAMETERS	: sJob			- Handle for the copy.
+			  
+ RETURNS	: TRUE if the copy assembled its input without errors.
+*****************************************************************************/
+static IMG_BOOL WaitForAssemblerJob(USEASM_JOB sJob)
+{
+	int iStatus;
+
+#if defined(LINUX)
+	while (waitpid(sJob, &iStatus, 0) < 0)
+	{
+		if (errno != EINTR)
+		{
+			return IMG_FALSE;
+		}
+	}
+	return (WIFEXITED(iStatus) && WEXITSTATUS(iStatus) == 0) ? IMG_TRUE : IMG_FALSE;
+#else
+	if (_cwait(&iStatus, sJob, _WAIT_CHILD) == -1)
+	{
+		return IMG_FALSE;
+	}
+	return (iStatus == 0) ? IMG_TRUE : IMG_FALSE;
+#endif
+}
+
+/*****************************************************************************
+ FUNCTION	: AssembleInParallel
+    
+ PURPOSE	: Assembles several input files by running a copy of the assembler
+			  for each one, with a limit on how many run at once. Each module
+			  is independent until it is linked so nothing is shared between
+			  the copies.
+
+ PARAMETERS	: ppszOptions		- The assembler followed by the options to
+			  uOptionCount		  pass to each copy.
+			  ppszInputs		- Input files.
+			  uInputCount
+			  uMaxJobs			- Maximum number of copies to run at once.
+			  
+ RETURNS	: The exit code for the assembler.
+*****************************************************************************/
+static int AssembleInParallel(IMG_PCHAR*	ppszOptions,
+							  IMG_UINT32	uOptionCount,
+							  IMG_PCHAR*	ppszInputs,
+							  IMG_UINT32	uInputCount,
+							  IMG_UINT32	uMaxJobs)
+{
+	IMG_PCHAR*	ppszArgs;
+	USEASM_JOB*	psJobs;
+	IMG_UINT32	uNextInput;
+	IMG_UINT32	uFirstRunning;
+	IMG_UINT32	uRunningCount;
+	IMG_BOOL	bFailed = IMG_FALSE;
+
+	ppszArgs = UseAsm_Malloc((uOptionCount + 2) * sizeof(ppszArgs[0]));
+	psJobs = UseAsm_Malloc(uInputCount * sizeof(psJobs[0]));
+	UseAsm_MemCopy(ppszArgs, ppszOptions, uOptionCount * sizeof(ppszArgs[0]));
+	ppszArgs[uOptionCount + 1] = NULL;
+
+	uNextInput = 0;
+	uFirstRunning = 0;
+	uRunningCount = 0;
+	while (uFirstRunning < uInputCount)
+	{
+		/*
+			Start copies until the limit is reached then wait for the oldest.
+		*/
+		if (uNextInput < uInputCount && uRunningCount < uMaxJobs && !bFailed)
+		{
+			ppszArgs[uOptionCount] = ppszInputs[uNextInput];
+			if (!StartAssemblerJob(ppszArgs, &psJobs[uNextInput]))
+			{
+				fprintf(stderr, "%s: Couldn't start assembler for %s: %s.\n", ppszOptions[0], ppszInputs[uNextInput], strerror(errno));
+				bFailed = IMG_TRUE;
+				uInputCount = uNextInput;
+				continue;
+			}
+			uNextInput++;
+			uRunningCount++;
+		}
+		else
+		{
+			if (!WaitForAssemblerJob(psJobs[uFirstRunning]))
+			{
+				bFailed = IMG_TRUE;
+			}
+			uFirstRunning++;
+			uRunningCount--;
+			if (bFailed)
+			{
+				/* Don't start anything new but let the running copies finish. */
+				uInputCount = uNextInput;
+			}
+		}
+	}
+
+	free(psJobs);
+	free(ppszArgs);
+	return bFailed ? 1 : 0;
+}
+
 #if !defined(LINUX)
 int __cdecl main (int argc, char* argv[])
 #else
@@ -941,6 +1326,11 @@ int main(int argc, char* argv[])
 #endif /* defined(ENABLE_USEOPT) */
 	IMG_BOOL bTargetCoreSetOnCommandLine = IMG_FALSE;
 	IMG_BOOL bTargetRevisionSetOnCommandLine = IMG_FALSE;
+	IMG_UINT32 uMaxJobs = 0;
+	IMG_PCHAR* ppszJobOptions;
+	IMG_UINT32 uJobOptionCount;
+	USEASM_MODULE sModule;
+	PUSEASM_MODULE psModule = &sModule;
 
 	/*
 		Initialize the support for parsing C types.
@@ -958,8 +1348,29 @@ int main(int argc, char* argv[])
 	g_uCodeOffset = 0;
 	pszLabelHeaderFileName = NULL;
 	pszLabelPrefix = "";
+	ppszJobOptions = UseAsm_Malloc(argc * sizeof(ppszJobOptions[0]));
+	ppszJobOptions[0] = argv[0];
+	uJobOptionCount = 1;
 	while (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')
 	{
+		if (strncmp(argv[1], "-jobs=", strlen("-jobs=")) == 0)
+		{
+			uMaxJobs = strtoul(argv[1] + strlen("-jobs="), NULL, 0);
+			if (uMaxJobs == 0)
+			{
+				fprintf(stderr, "%s: Invalid number of jobs %s.\n", argv[0], argv[1] + strlen("-jobs="));
+				return 1;
+			}
+			memmove(&argv[1], &argv[2], (argc - 2) * sizeof(argv[1]));
+			argc--;
+			continue;
+		}
+
+		/*
+			Remember the option to pass on to the copies of the assembler in -jobs mode.
+		*/
+		ppszJobOptions[uJobOptionCount++] = argv[1];
+
 		if (strncmp(argv[1], "-offset=", strlen("-offset=")) == 0)
 		{
 			g_uCodeOffset = strtoul(argv[1] + strlen("-offset="), NULL, 0);
@@ -1089,7 +1500,7 @@ int main(int argc, char* argv[])
 					{
 						fprintf(stderr, "%s: Invalid first number syntax '%s' in range value.\n", 
 							argv[0], pszFirstNumber);
-						UseAsm_Free(pszInterArgument);
+						free(pszInterArgument);
 						return 1;
 					}
 					pszSecondNumber++;
@@ -1101,7 +1512,7 @@ int main(int argc, char* argv[])
 					{
 						fprintf(stderr, "%s: Invalid second number syntax '%s' in range value.\n", 
 							argv[0], pszSecondNumber);
-						UseAsm_Free(pszInterArgument);
+						free(pszInterArgument);
 						return 1;
 					}
 				}
@@ -1109,14 +1520,14 @@ int main(int argc, char* argv[])
 				{
 					fprintf(stderr, "%s: Invalid range value syntax '%s'.\n", 
 						argv[0], pszFirstNumber);
-					UseAsm_Free(pszInterArgument);
+					free(pszInterArgument);
 					return 1;
 				}
 				if(uRangeStart > uRangeEnd)
 				{
 					fprintf(stderr, "%s: Range start '%u' can not be larger than range end '%u'.\n", 
 						argv[0], uRangeStart, uRangeEnd);
-					UseAsm_Free(pszInterArgument);
+					free(pszInterArgument);
 					return 1;
 				}
 				SetHwRegsAllocRange(uRangeStart, uRangeEnd, IMG_FALSE);	
@@ -1150,7 +1561,7 @@ int main(int argc, char* argv[])
 					{
 						fprintf(stderr, "%s: Invalid first number syntax '%s' in range value.\n", 
 							argv[0], pszFirstNumber);
-						UseAsm_Free(pszInterArgument);
+						free(pszInterArgument);
 						return 1;
 					}
 					pszSecondNumber++;
@@ -1162,7 +1573,7 @@ int main(int argc, char* argv[])
 					{
 						fprintf(stderr, "%s: Invalid second number syntax '%s' in range value.\n", 
 							argv[0], pszSecondNumber);
-						UseAsm_Free(pszInterArgument);
+						free(pszInterArgument);
 						return 1;
 					}
 				}
@@ -1170,14 +1581,14 @@ int main(int argc, char* argv[])
 				{
 					fprintf(stderr, "%s: Invalid range value syntax '%s'.\n", argv[0], 
 						pszFirstNumber);
-					UseAsm_Free(pszInterArgument);
+					free(pszInterArgument);
 					return 1;
 				}
 				if(uRangeStart > uRangeEnd)
 				{
 					fprintf(stderr, "%s: Range start '%u' can not be larger than range end '%u'.\n", 
 						argv[0], uRangeStart, uRangeEnd);
-					UseAsm_Free(pszInterArgument);
+					free(pszInterArgument);
 					return 1;				
 				}
 				SetHwRegsAllocRange(uRangeStart, uRangeEnd, IMG_TRUE);
@@ -1204,6 +1615,27 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
+	if (uMaxJobs > 0)
+	{
+		int iInput;
+
+		if (pszLabelHeaderFileName != NULL)
+		{
+			fprintf(stderr, "%s: -label_header can't be used with -jobs.\n", argv[0]);
+			return 1;
+		}
+		for (iInput = 1; iInput < argc; iInput++)
+		{
+			if (argv[iInput][0] == '-')
+			{
+				fprintf(stderr, "%s: Options must come before the input files and stdin can't be used with -jobs.\n", argv[0]);
+				return 1;
+			}
+		}
+		return AssembleInParallel(ppszJobOptions, uJobOptionCount, &argv[1], argc - 1, uMaxJobs);
+	}
+	free(ppszJobOptions);
+
 	if (argv[1][0] == '-' && argv[1][1] == '\0')
 	{
 		g_pszInFileName = strdup("stdin");
@@ -1286,8 +1718,8 @@ int main(int argc, char* argv[])
 	g_psInstListHead = NULL;
 	g_uSourceLine = 1;
 
-	g_uLabelCount = 0;
-	g_psLabels = NULL;
+	InitModule(psModule);
+	g_psParseModule = psModule;
 
 	g_uSchedOffCount = 0;
 	g_psLastNoSchedInst = NULL;
@@ -1300,14 +1732,12 @@ int main(int argc, char* argv[])
 
 	g_uInstOffset = g_uCodeOffset;
 
-	g_bAssemblerError = FALSE;
-
 	yydebug = 0;
 	g_uParserError = 0;
 	if (yyparse() != 0)
 	{
 		fclose(fInFile);
-		UseAsm_Free(pszOutFileName);
+		free(pszOutFileName);
 		return 1;
 	}
 	VerifyThatAllScopesAreEnded();
@@ -1315,7 +1745,7 @@ int main(int argc, char* argv[])
 	{
 		fprintf(stderr, "No instructions defined.\n");
 		fclose(fInFile);
-		UseAsm_Free(pszOutFileName);
+		free(pszOutFileName);
 		return 1;
 	}
 #if defined(ENABLE_USEOPT)
@@ -1339,7 +1769,7 @@ int main(int argc, char* argv[])
 			}
 			else
 			{
-				UseAsm_Free(psCurr);
+				free(psCurr);
 			}
 		}
 		if (bOptimise)
@@ -1363,7 +1793,7 @@ int main(int argc, char* argv[])
 				sUseoptData.asOutRegs[uIdx].uNumber = psCurr->uNumber;
 
 				uIdx += 1;
-				UseAsm_Free(psCurr);
+				free(psCurr);
 			}
 		}
 		else
@@ -1443,7 +1873,7 @@ int main(int argc, char* argv[])
 	puOutput = UseAsm_Malloc(g_uInstCount * EURASIA_USE_INSTRUCTION_SIZE);
 	psSourceOffsets = UseAsm_Malloc(g_uInstCount * sizeof(*psSourceOffsets));
 	puInst = puOutput;
-	sContext.pvContext = NULL;
+	sContext.pvContext = psModule;
 	sContext.pvLabelState = NULL;
 	sContext.pfnRealloc = UseasmRealloc;
 	sContext.pfnGetLabelAddress = UseAssemblerGetLabelAddress;
@@ -1480,10 +1910,10 @@ int main(int argc, char* argv[])
         g_psInstListHead = sUseoptData.psProgram;
 
         /* Clean up optimiser data */
-        UseAsm_Free(sUseoptData.auKeepTempReg);
-        UseAsm_Free(sUseoptData.auKeepPAReg);
-        UseAsm_Free(sUseoptData.auKeepOutputReg);
-        UseAsm_Free(sUseoptData.asOutRegs);
+        free(sUseoptData.auKeepTempReg);
+        free(sUseoptData.auKeepPAReg);
+        free(sUseoptData.auKeepOutputReg);
+        free(sUseoptData.asOutRegs);
         sUseoptData.asOutRegs = NULL;
 	}
 #endif /* defined(ENABLE_USEOPT) */
@@ -1500,9 +1930,9 @@ int main(int argc, char* argv[])
 		if (uInstSpace == USE_UNDEF)
 		{
 			fprintf(stderr, "%s: Out of memory.\n", argv[0]);
-			UseAsm_Free(puOutput);
+			free(puOutput);
 			fclose(fInFile);
-			UseAsm_Free(pszOutFileName);
+			free(pszOutFileName);
 			return 1;
 		}
 		if (uInstSpace > 0)
@@ -1522,17 +1952,17 @@ int main(int argc, char* argv[])
 		CheckUndefinedLabels(&sContext);
 	}
 	uInstCount = (puInst - puOutput) / 2;
-	if (g_bAssemblerError || g_uParserError || g_bCCodeError)
+	if (psModule->bAssemblerError || g_uParserError || g_bCCodeError)
 	{
-		UseAsm_Free(puOutput);
+		free(puOutput);
 		fclose(fInFile);
-		UseAsm_Free(pszOutFileName);
+		free(pszOutFileName);
 		return 1;
 	}
 
 	if (g_bWriteObjectFile)
 	{
-		if (!PrepareExportSegment())
+		if (!PrepareExportSegment(psModule))
 		{
 			return 1;
 		}
@@ -1542,14 +1972,14 @@ int main(int argc, char* argv[])
 	if (fOutFile == NULL)
 	{
 		fprintf(stderr, "%s: Couldn't open output file %s: %s.\n", argv[0], pszOutFileName, strerror(errno));
-		UseAsm_Free(pszOutFileName);
+		free(pszOutFileName);
 		fclose(fInFile);
 		return 1;
 	}
 
 	if (g_bWriteObjectFile)
 	{
-		if (!WriteObjectFile(uInstCount, puOutput, fOutFile))
+		if (!WriteObjectFile(psModule, uInstCount, puOutput, fOutFile))
 		{
 			return 1;
 		}
@@ -1559,10 +1989,10 @@ int main(int argc, char* argv[])
 		if (fwrite(puOutput, EURASIA_USE_INSTRUCTION_SIZE, uInstCount, fOutFile) != uInstCount)
 		{
 			fprintf(stderr, "Couldn't write output: %s.\n", strerror(errno));
-			UseAsm_Free(puOutput);
+			free(puOutput);
 			fclose(fInFile);
 			fclose(fOutFile);
-			UseAsm_Free(pszOutFileName);
+			free(pszOutFileName);
 			return 1;
 		}
 		
@@ -1599,9 +2029,9 @@ int main(int argc, char* argv[])
 		}
 	}
 
-	UseAsm_Free(psSourceOffsets);
-	UseAsm_Free(puOutput);
-	UseAsm_Free(pszOutFileName);
+	free(psSourceOffsets);
+	free(puOutput);
+	free(pszOutFileName);
 
 	if (pszLabelHeaderFileName != NULL)
 	{	
@@ -1613,14 +2043,14 @@ int main(int argc, char* argv[])
 		if (fLabelHeaderFile == NULL)
 		{
 			fprintf(stderr, "%s: Couldn't open label header file %s: %s.\n", argv[0], pszLabelHeaderFileName, strerror(errno)); 
-			UseAsm_Free(pszLabelHeaderFileName);
+			free(pszLabelHeaderFileName);
 			return 1;
 		}
 
 		uMaxLabelNameLength = 0;
-		for (i = 0; i < g_uLabelCount; i++)
+		for (i = 0; i < psModule->uLabelCount; i++)
 		{
-			uMaxLabelNameLength = max(uMaxLabelNameLength, strlen(g_psLabels[i].pszName));
+			uMaxLabelNameLength = max(uMaxLabelNameLength, strlen(psModule->psLabels[i].pszName));
 		}
 		uMaxLabelNameLength += strlen(pszLabelPrefix);
 		uMaxLabelNameLength += strlen(pszLabelPostfix);
@@ -1629,19 +2059,19 @@ int main(int argc, char* argv[])
 		{
 			fprintf(stderr, "Couldn't write label header file: %s.\n", strerror(errno));
 			fclose(fLabelHeaderFile);
-			UseAsm_Free(pszLabelHeaderFileName);
+			free(pszLabelHeaderFileName);
 			return 1;
 		}
 
-		for (i = 0; i < g_uLabelCount; i++)
+		for (i = 0; i < psModule->uLabelCount; i++)
 		{
 			IMG_PCHAR	pszDefineName;
 			IMG_UINT32	j;
 
-			pszDefineName = UseAsm_Malloc(strlen(pszLabelPrefix) + strlen(g_psLabels[i].pszName) + strlen(pszLabelPostfix) + 1);
+			pszDefineName = UseAsm_Malloc(strlen(pszLabelPrefix) + strlen(psModule->psLabels[i].pszName) + strlen(pszLabelPostfix) + 1);
 
 			strcpy(pszDefineName, pszLabelPrefix);
-			strcat(pszDefineName, g_psLabels[i].pszName);
+			strcat(pszDefineName, psModule->psLabels[i].pszName);
 			strcat(pszDefineName, pszLabelPostfix);
 
 			for (j = 0; j < strlen(pszDefineName); j++)
@@ -1649,23 +2079,26 @@ int main(int argc, char* argv[])
 				pszDefineName[j] = (IMG_CHAR)toupper(pszDefineName[j]);
 			}
 
-			if (fprintf(fLabelHeaderFile, "#define %-*s\t0x%.8X\n\n", (int)uMaxLabelNameLength, pszDefineName, g_psLabels[i].uAddress << 3) < 0)
+			if (fprintf(fLabelHeaderFile, "#define %-*s\t0x%.8X\n\n", (int)uMaxLabelNameLength, pszDefineName, psModule->psLabels[i].uAddress << 3) < 0)
 			{
 				fprintf(stderr, "Couldn't write label header file: %s.\n", strerror(errno));
 				fclose(fLabelHeaderFile);
-				UseAsm_Free(pszLabelHeaderFileName);
-				UseAsm_Free(pszDefineName);
+				free(pszLabelHeaderFileName);
+				free(pszDefineName);
 				return 1;
 			}
 
-			UseAsm_Free(pszDefineName);
+			free(pszDefineName);
 		}
 
 		fclose(fLabelHeaderFile);
 
-		UseAsm_Free(pszLabelHeaderFileName);
+		free(pszLabelHeaderFileName);
 	}
 
+	FreeModule(psModule);
+	g_psParseModule = NULL;
+
 	return 0;
 }
 #endif
@@ -794,7 +794,7 @@ typedef IMG_UINT32 (IMG_CALLCONV *USEASM_GETLABELADDRFN)(IMG_PVOID pvContext, IM
 typedef IMG_VOID (IMG_CALLCONV *USEASM_SETLABELADDRFN)(IMG_PVOID pvContext, IMG_UINT32 uLabel, IMG_UINT32 uAddress);
 typedef IMG_PCHAR (IMG_CALLCONV *USEASM_GETLABELNAMEFN)(IMG_PVOID pvContext, IMG_UINT32 uLabel);
 typedef IMG_VOID (IMG_CALLCONV *USEASM_ASSEMBLERERRORFN)(IMG_PVOID pvContext, PUSE_INST psInst, IMG_CHAR *pszFmt, ...) IMG_FORMAT_PRINTF(3, 4);
-typedef IMG_VOID (IMG_CALLCONV *USEASM_LADDRNOTIFY)(IMG_UINT32 uAddress);
+typedef IMG_VOID (IMG_CALLCONV *USEASM_LADDRNOTIFY)(IMG_PVOID pvContext, IMG_UINT32 uAddress);
 
 typedef struct _USEASM_CONTEXT
 {
@@ -0,0 +1,527 @@
+/******************************************************************************
+ * Name         : useanalyse.c
+ * Title        : USSE program analysis
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means, electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Description  : Gathers instruction mix and scheduling statistics from
+ *                assembled USSE programs using the disassembler's decoder.
+ *                Nothing here keeps state between calls so programs can be
+ *                analysed on several threads at once.
+ *
+ * Modifications:-
+ * $Log: useanalyse.c $
+ *****************************************************************************/
+
+#include <string.h>
+
+#include "sgxsupport.h"
+
+#include "sgxdefs.h"
+
+#include "use.h"
+#include "useasm.h"
+#include "usedisasm.h"
+#include "useanalyse.h"
+
+/*
+	Sample or load whose result hasn't been read yet.
+*/
+typedef struct
+{
+	IMG_BOOL		bValid;
+	USEASM_REGTYPE	uType;
+	IMG_UINT32		uFirst;
+	IMG_UINT32		uLast;
+} USEANALYSE_PENDING_RESULT;
+
+/*****************************************************************************
+ FUNCTION	: UseAnalyseInitStats
+
+ PURPOSE	: Clears a set of statistics.
+
+ PARAMETERS	: psStats			- Statistics to clear.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+IMG_INTERNAL
+IMG_VOID IMG_CALLCONV UseAnalyseInitStats(PUSEANALYSE_STATS psStats)
+{
+	memset(psStats, 0, sizeof(*psStats));
+}
+
+/*****************************************************************************
+ FUNCTION	: GetIterationCount
+
+ PURPOSE	: Gets the number of times a decoded instruction is executed.
+
+ PARAMETERS	: psInst			- Decoded instruction.
+
+ RETURNS	: The iteration count.
+*****************************************************************************/
+static IMG_UINT32 GetIterationCount(PUSE_INST psInst)
+{
+	IMG_UINT32	uRepeat = (psInst->uFlags1 & ~USEASM_OPFLAGS1_REPEAT_CLRMSK) >> USEASM_OPFLAGS1_REPEAT_SHIFT;
+	IMG_UINT32	uMask = (psInst->uFlags1 & ~USEASM_OPFLAGS1_MASK_CLRMSK) >> USEASM_OPFLAGS1_MASK_SHIFT;
+	IMG_UINT32	uCount;
+
+	if (uRepeat > 0)
+	{
+		return uRepeat;
+	}
+	for (uCount = 0; uMask != 0; uMask &= uMask - 1)
+	{
+		uCount++;
+	}
+	return (uCount > 0) ? uCount : 1;
+}
+
+/*****************************************************************************
+ FUNCTION	: IsMemoryLoad
+
+ PURPOSE	: Checks for an instruction which loads from memory into a register.
+
+ PARAMETERS	: uOpcode			- Opcode to check.
+
+ RETURNS	: TRUE if the instruction is a load.
+*****************************************************************************/
+static IMG_BOOL IsMemoryLoad(IMG_UINT32 uOpcode)
+{
+	switch (uOpcode)
+	{
+		case USEASM_OP_LDAB:
+		case USEASM_OP_LDAW:
+		case USEASM_OP_LDAD:
+		case USEASM_OP_LDAQ:
+		case USEASM_OP_LDLB:
+		case USEASM_OP_LDLW:
+		case USEASM_OP_LDLD:
+		case USEASM_OP_LDLQ:
+		case USEASM_OP_LDTB:
+		case USEASM_OP_LDTW:
+		case USEASM_OP_LDTD:
+		case USEASM_OP_LDTQ:
+		case USEASM_OP_ELDD:
+		case USEASM_OP_ELDQ:
+		case USEASM_OP_LDR:
+		case USEASM_OP_LDATOMIC:
+		{
+			return IMG_TRUE;
+		}
+		default:
+		{
+			return IMG_FALSE;
+		}
+	}
+}
+
+/*****************************************************************************
+ FUNCTION	: IsTrackedRegister
+
+ PURPOSE	: Checks for a register bank whose reads are checked against
+			  pending sample and load results.
+
+ PARAMETERS	: psReg				- Register to check.
+
+ RETURNS	: TRUE if the register is tracked.
+*****************************************************************************/
+static IMG_BOOL IsTrackedRegister(PUSE_REGISTER psReg)
+{
+	return (psReg->uType == USEASM_REGTYPE_TEMP ||
+			psReg->uType == USEASM_REGTYPE_PRIMATTR ||
+			psReg->uType == USEASM_REGTYPE_OUTPUT ||
+			psReg->uType == USEASM_REGTYPE_FPINTERNAL) ? IMG_TRUE : IMG_FALSE;
+}
+
+/*****************************************************************************
+ FUNCTION	: ReadsPendingResult
+
+ PURPOSE	: Checks if an instruction reads the result of a recent sample or
+			  load and retires the results it reads.
+
+ PARAMETERS	: psInst			- Decoded instruction.
+			  uIterations		- Number of times the instruction is executed.
+			  asPending			- Results not yet read.
+
+ RETURNS	: TRUE if a pending result is read.
+*****************************************************************************/
+static IMG_BOOL ReadsPendingResult(PUSE_INST					psInst,
+								   IMG_UINT32					uIterations,
+								   USEANALYSE_PENDING_RESULT	asPending[USEANALYSE_LOAD_USE_DISTANCE])
+{
+	IMG_UINT32	uArgCount = OpcodeArgumentCount(psInst->uOpcode);
+	IMG_UINT32	uFirstSrc;
+	IMG_UINT32	uArg;
+	IMG_BOOL	bRead = IMG_FALSE;
+
+	/*
+		Stores use every argument as a source, everything else writes the first.
+	*/
+	uFirstSrc = (OpcodeDescFlags(psInst->uOpcode) & USE_DESCFLAG_DISASM_MEMORY_ST) ? 0 : 1;
+	if (uArgCount > USE_MAX_ARGUMENTS)
+	{
+		uArgCount = USE_MAX_ARGUMENTS;
+	}
+
+	for (uArg = uFirstSrc; uArg < uArgCount; uArg++)
+	{
+		PUSE_REGISTER	psSrc = &psInst->asArg[uArg];
+		IMG_UINT32		uSlot;
+
+		if (!IsTrackedRegister(psSrc))
+		{
+			continue;
+		}
+		for (uSlot = 0; uSlot < USEANALYSE_LOAD_USE_DISTANCE; uSlot++)
+		{
+			USEANALYSE_PENDING_RESULT*	psPending = &asPending[uSlot];
+
+			if (psPending->bValid &&
+				psPending->uType == psSrc->uType &&
+				(
+					/* Indexed reads could touch any register in the bank. */
+					psSrc->uIndex != USEREG_INDEX_NONE ||
+					(psSrc->uNumber <= psPending->uLast && psSrc->uNumber + uIterations > psPending->uFirst)
+				))
+			{
+				psPending->bValid = IMG_FALSE;
+				bRead = IMG_TRUE;
+			}
+		}
+	}
+	return bRead;
+}
+
+/*****************************************************************************
+ FUNCTION	: AddDualIssuePair
+
+ PURPOSE	: Counts a dual-issued pair of opcodes.
+
+ PARAMETERS	: psStats			- Statistics to update.
+			  uPrimaryOpcode	- Opcodes of the two halves of the instruction.
+			  uSecondaryOpcode
+			  uCount			- Number of times the pair was seen.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+static IMG_VOID AddDualIssuePair(PUSEANALYSE_STATS	psStats,
+								 IMG_UINT32			uPrimaryOpcode,
+								 IMG_UINT32			uSecondaryOpcode,
+								 IMG_UINT32			uCount)
+{
+	IMG_UINT32	uPair;
+
+	for (uPair = 0; uPair < psStats->uDualIssuePairCount; uPair++)
+	{
+		PUSEANALYSE_DUALISSUE_PAIR	psPair = &psStats->asDualIssuePairs[uPair];
+
+		if (psPair->uPrimaryOpcode == uPrimaryOpcode && psPair->uSecondaryOpcode == uSecondaryOpcode)
+		{
+			psPair->uCount += uCount;
+			return;
+		}
+	}
+	/*
+		Pairs beyond the end of the table are still counted in uDualIssueCount.
+	*/
+	if (psStats->uDualIssuePairCount < USEANALYSE_MAX_DUALISSUE_PAIRS)
+	{
+		PUSEANALYSE_DUALISSUE_PAIR	psPair = &psStats->asDualIssuePairs[psStats->uDualIssuePairCount++];
+
+		psPair->uPrimaryOpcode = uPrimaryOpcode;
+		psPair->uSecondaryOpcode = uSecondaryOpcode;
+		psPair->uCount = uCount;
+	}
+}
+
+/*****************************************************************************
+ FUNCTION	: UseAnalyseProgram
+
+ PURPOSE	: Decodes a USSE program and adds its statistics to a set of
+			  statistics. Decoding stops after the first instruction with the
+			  END flag so consecutive programs in a code heap dump can be
+			  analysed by calling this repeatedly.
+
+ PARAMETERS	: psTarget			- Target processor.
+			  uInstCount		- Maximum number of instructions to decode.
+			  puInstructions	- Instructions.
+			  psStats			- Statistics to update.
+
+ RETURNS	: The number of instructions decoded.
+*****************************************************************************/
+IMG_INTERNAL
+IMG_UINT32 IMG_CALLCONV UseAnalyseProgram(PCSGX_CORE_DESC		psTarget,
+										  IMG_UINT32			uInstCount,
+										  IMG_UINT32 const*		puInstructions,
+										  PUSEANALYSE_STATS		psStats)
+{
+	USEANALYSE_PENDING_RESULT	asPending[USEANALYSE_LOAD_USE_DISTANCE];
+	USEDIS_RUNTIME_STATE		sRuntimeState;
+	IMG_UINT32					uInst;
+
+	memset(asPending, 0, sizeof(asPending));
+
+	/*
+		Use the same format control assumptions as the disassembler.
+	*/
+	sRuntimeState.eColourFormatControl = USEDIS_FORMAT_CONTROL_STATE_ON;
+	sRuntimeState.eEFOFormatControl = USEDIS_FORMAT_CONTROL_STATE_OFF;
+
+	psStats->uProgramCount++;
+
+	for (uInst = 0; uInst < uInstCount; uInst++)
+	{
+		USE_INST					sInst;
+		USE_INST					sCoInst;
+		USEANALYSE_PENDING_RESULT*	psNewPending = &asPending[uInst % USEANALYSE_LOAD_USE_DISTANCE];
+		IMG_UINT32					uIterations;
+		IMG_UINT32					uDescFlags;
+		IMG_BOOL					bStall;
+
+		memset(&sInst, 0, sizeof(sInst));
+		memset(&sCoInst, 0, sizeof(sCoInst));
+		sInst.psNext = &sCoInst;
+
+		/*
+			The slot for this instruction held a result from USEANALYSE_LOAD_USE_DISTANCE
+			instructions ago which is now far enough away not to stall.
+		*/
+		psNewPending->bValid = IMG_FALSE;
+
+		if (UseDecodeInstruction(psTarget,
+								 puInstructions[uInst * 2 + 0],
+								 puInstructions[uInst * 2 + 1],
+								 &sRuntimeState,
+								 &sInst) != USEDISASM_OK ||
+			(IMG_UINT32)sInst.uOpcode >= USEASM_OP_MAXIMUM)
+		{
+			psStats->uInvalidInstCount++;
+			continue;
+		}
+
+		uIterations = GetIterationCount(&sInst);
+		uDescFlags = OpcodeDescFlags(sInst.uOpcode);
+		bStall = IMG_FALSE;
+
+		psStats->uInstCount++;
+		psStats->uIssueCount += uIterations;
+		psStats->auOpcodeCount[sInst.uOpcode]++;
+		psStats->auRepeatCount[(uIterations < USEANALYSE_MAX_REPEAT) ? uIterations : USEANALYSE_MAX_REPEAT]++;
+		if (uIterations > 1)
+		{
+			psStats->uRepeatedInstCount++;
+		}
+
+		if (ReadsPendingResult(&sInst, uIterations, asPending))
+		{
+			psStats->uDependentReadCount++;
+			bStall = IMG_TRUE;
+		}
+
+		if (sInst.uFlags1 & USEASM_OPFLAGS1_MAINISSUE)
+		{
+			psStats->uDualIssueCount++;
+			if ((IMG_UINT32)sCoInst.uOpcode < USEASM_OP_MAXIMUM)
+			{
+				psStats->auOpcodeCount[sCoInst.uOpcode]++;
+				AddDualIssuePair(psStats, sInst.uOpcode, sCoInst.uOpcode, 1);
+
+				if (ReadsPendingResult(&sCoInst, uIterations, asPending) && !bStall)
+				{
+					psStats->uDependentReadCount++;
+					bStall = IMG_TRUE;
+				}
+			}
+		}
+
+		if (sInst.uFlags2 & USEASM_OPFLAGS2_PERINSTMOE)
+		{
+			psStats->uPerInstMOECount++;
+		}
+		if (sInst.uFlags1 & USEASM_OPFLAGS1_NOSCHED)
+		{
+			psStats->uNoSchedCount++;
+		}
+		if (sInst.uFlags1 & USEASM_OPFLAGS1_SYNCSTART)
+		{
+			psStats->uSyncStartCount++;
+			bStall = IMG_TRUE;
+		}
+		if (sInst.uFlags1 & USEASM_OPFLAGS1_SYNCEND)
+		{
+			psStats->uSyncEndCount++;
+		}
+
+		switch (sInst.uOpcode)
+		{
+			case USEASM_OP_SMOA:
+			case USEASM_OP_SMR:
+			case USEASM_OP_SMLSI:
+			case USEASM_OP_SMBO:
+			case USEASM_OP_IMO:
+			case USEASM_OP_SETFC:
+			{
+				psStats->uMOEControlCount++;
+				break;
+			}
+			case USEASM_OP_BA:
+			case USEASM_OP_BR:
+			case USEASM_OP_LAPC:
+			{
+				psStats->uBranchCount++;
+				/*
+					Results from before the branch may or may not be read afterwards.
+				*/
+				memset(asPending, 0, sizeof(asPending));
+				break;
+			}
+			case USEASM_OP_IDF:
+			case USEASM_OP_WDF:
+			{
+				psStats->uFenceCount++;
+				memset(asPending, 0, sizeof(asPending));
+				bStall = IMG_TRUE;
+				break;
+			}
+			case USEASM_OP_LOCK:
+			{
+				psStats->uLockCount++;
+				bStall = IMG_TRUE;
+				break;
+			}
+			default:
+			{
+				break;
+			}
+		}
+
+		/*
+			Remember the destination of a sample or load so a read of it soon afterwards
+			can be counted.
+		*/
+		if ((uDescFlags & USC_DESCFLAG_TEXTURESAMPLE) || IsMemoryLoad(sInst.uOpcode))
+		{
+			PUSE_REGISTER	psDest = &sInst.asArg[0];
+			IMG_UINT32		uResultCount;
+
+			if (uDescFlags & USC_DESCFLAG_TEXTURESAMPLE)
+			{
+				psStats->uTextureSampleCount++;
+				uResultCount = USEANALYSE_SAMPLE_RESULT_REGISTERS;
+			}
+			else
+			{
+				psStats->uMemoryLoadCount++;
+				uResultCount = uIterations;
+			}
+
+			if (IsTrackedRegister(psDest) && psDest->uIndex == USEREG_INDEX_NONE)
+			{
+				psNewPending->bValid = IMG_TRUE;
+				psNewPending->uType = psDest->uType;
+				psNewPending->uFirst = psDest->uNumber;
+				psNewPending->uLast = psDest->uNumber + uResultCount - 1;
+			}
+		}
+		else if (uDescFlags & USE_DESCFLAG_DISASM_MEMORY_ST)
+		{
+			psStats->uMemoryStoreCount++;
+		}
+
+		if (bStall)
+		{
+			psStats->uStallSiteCount++;
+		}
+
+		if (sInst.uFlags1 & USEASM_OPFLAGS1_END)
+		{
+			return uInst + 1;
+		}
+	}
+	return uInstCount;
+}
+
+/*****************************************************************************
+ FUNCTION	: UseAnalyseMergeStats
+
+ PURPOSE	: Adds one set of statistics onto another.
+
+ PARAMETERS	: psDest			- Statistics to update.
+			  psSrc				- Statistics to add.
+
+ RETURNS	: Nothing.
+*****************************************************************************/
+IMG_INTERNAL
+IMG_VOID IMG_CALLCONV UseAnalyseMergeStats(PUSEANALYSE_STATS psDest, PCUSEANALYSE_STATS psSrc)
+{
+	IMG_UINT32	uIdx;
+
+	psDest->uProgramCount += psSrc->uProgramCount;
+	psDest->uInstCount += psSrc->uInstCount;
+	psDest->uInvalidInstCount += psSrc->uInvalidInstCount;
+	psDest->uIssueCount += psSrc->uIssueCount;
+	for (uIdx = 0; uIdx < USEASM_OP_MAXIMUM; uIdx++)
+	{
+		psDest->auOpcodeCount[uIdx] += psSrc->auOpcodeCount[uIdx];
+	}
+
+	psDest->uDualIssueCount += psSrc->uDualIssueCount;
+	for (uIdx = 0; uIdx < psSrc->uDualIssuePairCount; uIdx++)
+	{
+		AddDualIssuePair(psDest,
+						 psSrc->asDualIssuePairs[uIdx].uPrimaryOpcode,
+						 psSrc->asDualIssuePairs[uIdx].uSecondaryOpcode,
+						 psSrc->asDualIssuePairs[uIdx].uCount);
+	}
+
+	for (uIdx = 0; uIdx <= USEANALYSE_MAX_REPEAT; uIdx++)
+	{
+		psDest->auRepeatCount[uIdx] += psSrc->auRepeatCount[uIdx];
+	}
+	psDest->uRepeatedInstCount += psSrc->uRepeatedInstCount;
+	psDest->uMOEControlCount += psSrc->uMOEControlCount;
+	psDest->uPerInstMOECount += psSrc->uPerInstMOECount;
+
+	psDest->uTextureSampleCount += psSrc->uTextureSampleCount;
+	psDest->uMemoryLoadCount += psSrc->uMemoryLoadCount;
+	psDest->uMemoryStoreCount += psSrc->uMemoryStoreCount;
+	psDest->uBranchCount += psSrc->uBranchCount;
+
+	psDest->uNoSchedCount += psSrc->uNoSchedCount;
+	psDest->uSyncStartCount += psSrc->uSyncStartCount;
+	psDest->uSyncEndCount += psSrc->uSyncEndCount;
+	psDest->uFenceCount += psSrc->uFenceCount;
+	psDest->uLockCount += psSrc->uLockCount;
+
+	psDest->uDependentReadCount += psSrc->uDependentReadCount;
+	psDest->uStallSiteCount += psSrc->uStallSiteCount;
+}
+
+/*****************************************************************************
+ FUNCTION	: UseAnalyseEstimateCycles
+
+ PURPOSE	: Gives a static cost for a set of statistics for ranking programs
+			  against each other. This is not a prediction of the run time.
+
+ PARAMETERS	: psStats			- Statistics to cost.
+
+ RETURNS	: The estimated number of cycles.
+*****************************************************************************/
+IMG_INTERNAL
+IMG_UINT32 IMG_CALLCONV UseAnalyseEstimateCycles(PCUSEANALYSE_STATS psStats)
+{
+	return psStats->uIssueCount + psStats->uStallSiteCount * USEANALYSE_STALL_CYCLES;
+}
+
+/******************************************************************************
+ End of file (useanalyse.c)
+******************************************************************************/
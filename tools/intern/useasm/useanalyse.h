@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Name         : useanalyse.h
+ * Title        : USSE program analysis
+ *
+ * Copyright    : 2010 by Imagination Technologies Limited.
+ *              : All rights reserved. No part of this software, either
+ *              : material or conceptual may be copied or distributed,
+ *              : transmitted, transcribed, stored in a retrieval system or
+ *              : translated into any human or computer language in any form
+ *              : by any means,electronic, mechanical, manual or otherwise,
+ *              : or disclosed to third parties without the express written
+ *              : permission of Imagination Technologies Limited,
+ *              : Home Park Estate, Kings Langley, Hertfordshire,
+ *              : WD4 8LZ, U.K.
+ *
+ * Modifications:-
+ * $Log: useanalyse.h $
+ *****************************************************************************/
+
+#if !defined(__USEASM_USEANALYSE_H)
+#define __USEASM_USEANALYSE_H
+
+#include "img_defs.h"
+#include "img_types.h"
+
+/* Largest number of iterations of a repeated instruction that is counted separately. */
+#define USEANALYSE_MAX_REPEAT					(32)
+
+/* Number of distinct dual-issue opcode pairs recorded per set of statistics. */
+#define USEANALYSE_MAX_DUALISSUE_PAIRS			(64)
+
+/*
+	A read of the result of a texture sample or memory load fewer than this many
+	instructions after it was issued is counted as a likely stall site.
+*/
+#define USEANALYSE_LOAD_USE_DISTANCE			(4)
+
+/* Registers assumed to be written by a texture sample. */
+#define USEANALYSE_SAMPLE_RESULT_REGISTERS		(4)
+
+/* Cycles charged for each estimated stall site when ranking programs by cost. */
+#define USEANALYSE_STALL_CYCLES					(8)
+
+typedef struct _USEANALYSE_DUALISSUE_PAIR
+{
+	IMG_UINT32	uPrimaryOpcode;
+	IMG_UINT32	uSecondaryOpcode;
+	IMG_UINT32	uCount;
+} USEANALYSE_DUALISSUE_PAIR, *PUSEANALYSE_DUALISSUE_PAIR;
+
+typedef struct _USEANALYSE_STATS
+{
+	/* Number of programs analysed. */
+	IMG_UINT32					uProgramCount;
+	/* Number of instructions decoded and number which couldn't be decoded. */
+	IMG_UINT32					uInstCount;
+	IMG_UINT32					uInvalidInstCount;
+	/* Instructions weighted by the number of times each is repeated. */
+	IMG_UINT32					uIssueCount;
+	/* Instructions by opcode (dual-issued instructions count for both opcodes). */
+	IMG_UINT32					auOpcodeCount[USEASM_OP_MAXIMUM];
+
+	/* Dual-issued instructions and the most common opcode pairs. */
+	IMG_UINT32					uDualIssueCount;
+	IMG_UINT32					uDualIssuePairCount;
+	USEANALYSE_DUALISSUE_PAIR	asDualIssuePairs[USEANALYSE_MAX_DUALISSUE_PAIRS];
+
+	/* Instructions by iteration count (index 1 is unrepeated). */
+	IMG_UINT32					auRepeatCount[USEANALYSE_MAX_REPEAT + 1];
+	IMG_UINT32					uRepeatedInstCount;
+	/* MOE state changes and instructions using per-instruction MOE increments. */
+	IMG_UINT32					uMOEControlCount;
+	IMG_UINT32					uPerInstMOECount;
+
+	/* Texture samples, memory accesses and flow control. */
+	IMG_UINT32					uTextureSampleCount;
+	IMG_UINT32					uMemoryLoadCount;
+	IMG_UINT32					uMemoryStoreCount;
+	IMG_UINT32					uBranchCount;
+
+	/* Scheduling and synchronisation points. */
+	IMG_UINT32					uNoSchedCount;
+	IMG_UINT32					uSyncStartCount;
+	IMG_UINT32					uSyncEndCount;
+	IMG_UINT32					uFenceCount;
+	IMG_UINT32					uLockCount;
+
+	/*
+		Estimated stall sites: fences, locks and syncstarts plus reads of a sample or
+		load result within USEANALYSE_LOAD_USE_DISTANCE instructions of it.
+	*/
+	IMG_UINT32					uDependentReadCount;
+	IMG_UINT32					uStallSiteCount;
+} USEANALYSE_STATS, *PUSEANALYSE_STATS;
+
+typedef USEANALYSE_STATS const* PCUSEANALYSE_STATS;
+
+IMG_VOID IMG_CALLCONV UseAnalyseInitStats(PUSEANALYSE_STATS psStats);
+
+IMG_UINT32 IMG_CALLCONV UseAnalyseProgram(PCSGX_CORE_DESC		psTarget,
+										  IMG_UINT32			uInstCount,
+										  IMG_UINT32 const*		puInstructions,
+										  PUSEANALYSE_STATS		psStats);
+
+IMG_VOID IMG_CALLCONV UseAnalyseMergeStats(PUSEANALYSE_STATS psDest, PCUSEANALYSE_STATS psSrc);
+
+IMG_UINT32 IMG_CALLCONV UseAnalyseEstimateCycles(PCUSEANALYSE_STATS psStats);
+
+#endif /* __USEASM_USEANALYSE_H */
+
+/******************************************************************************
+ End of file (useanalyse.h)
+******************************************************************************/
@@ -293,7 +293,7 @@ static IMG_VOID SetLabelAddress(PCSGX_CORE_DESC psTarget,
 #if defined(USER)
 		if (psContext->pfnLADDRNotify != NULL)
 		{
-			psContext->pfnLADDRNotify((IMG_UINT32)((puCode - puBaseInst) / 2UL));
+			psContext->pfnLADDRNotify(psContext->pvContext, (IMG_UINT32)((puCode - puBaseInst) / 2UL));
 		}
 #endif /* defined(USER) */
 	}
@@ -5554,7 +5554,7 @@ IMG_INTERNAL PUSP_PC_SHADER PCShaderCreate(PUSP_CONTEXT	psContext,
 		else
 		{
 			/* Save the size calculated by last iteration */
-			uCalSize = (IMG_UINT32)pvPCShader;
+			uCalSize = (IMG_UINT32)(IMG_UINTPTR_T)pvPCShader;
 			
 			if(uCalSize == 0)
 			{
@@ -5632,7 +5632,7 @@ IMG_INTERNAL PUSP_PC_SHADER PCShaderCreate(PUSP_CONTEXT	psContext,
 		}
 	}
 
-	if(uCalSize !=   ((IMG_UINT32)pvPCShader - (IMG_UINT32)psPCShader))
+	if(uCalSize !=   ((IMG_UINT32)((IMG_UINTPTR_T)pvPCShader - (IMG_UINTPTR_T)psPCShader)))
 	{
 		USP_DBGPRINT(( "PCShaderCreate: Failed size mismatch in calculated an written data\n"));
 		goto PCShaderCreateFinish;